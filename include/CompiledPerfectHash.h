@@ -39,11 +39,13 @@ extern "C" {
 
 #define DEBUGBREAK __debugbreak
 #define CPHCALLTYPE __stdcall
+#define CPHCACHEALIGN __declspec(align(64))
 #ifndef FORCEINLINE
 #define FORCEINLINE __forceinline
 #endif
 #elif defined(__linux__) || defined(__APPLE__)
 #define CPHCALLTYPE
+#define CPHCACHEALIGN __attribute__((aligned(64)))
 #if defined(__clang__)
 #include <x86intrin.h>
 
@@ -115,9 +117,378 @@ _rotr(
 
 #endif
 
+//
+// The batch routines (IndexBatch() and LookupBatch()) process eight keys per
+// iteration with AVX2 when the compiler is targeting it (i.e. /arch:AVX2 or
+// -mavx2) and the table's hash function has a vector implementation (which
+// will define CPH_HAS_HASH_AVX2); the remaining keys are handled by a scalar
+// tail loop.  Define CPH_NO_AVX2 to force the scalar loop.
+//
+
+#if defined(__AVX2__) && !defined(CPH_NO_AVX2)
+#define CPH_AVX2 1
+#define CPH_AVX2_BATCH_SIZE 8
+
+//
+// AVX2 has no 32-bit lane rotate; emulate it with a pair of shifts.  Counts
+// are masked to 0-31 as per _rotl() and _rotr(); the left shift of a zero
+// count by 32 bits yields zero, so the result is the unrotated input.
+//
+
+FORCEINLINE
+__m256i
+CphRotl256(
+    _In_ __m256i Value,
+    _In_ unsigned int Count
+    )
+{
+    Count &= 31;
+    return _mm256_or_si256(
+        _mm256_sll_epi32(Value, _mm_cvtsi32_si128((int)Count)),
+        _mm256_srl_epi32(Value, _mm_cvtsi32_si128((int)(32 - Count)))
+    );
+}
+
+FORCEINLINE
+__m256i
+CphRotr256(
+    _In_ __m256i Value,
+    _In_ unsigned int Count
+    )
+{
+    Count &= 31;
+    return _mm256_or_si256(
+        _mm256_srl_epi32(Value, _mm_cvtsi32_si128((int)Count)),
+        _mm256_sll_epi32(Value, _mm_cvtsi32_si128((int)(32 - Count)))
+    );
+}
+
+//
+// Gather eight table data elements.  The table data array type is the
+// smallest type that can contain the number of edges, so elements may be 8,
+// 16 or 32 bits wide.  Narrower elements are gathered via the 32-bit word
+// containing them, then shifted and masked; the array size is always a power
+// of two elements (of at least four), so this never reads past the array.
+// ElementSize is a constant, so the unused branches are folded away.
+//
+
+FORCEINLINE
+__m256i
+CphGatherTableData256(
+    _In_ const void *TableData,
+    _In_ __m256i Vertices,
+    _In_ unsigned int ElementSize
+    )
+{
+    __m256i Shift;
+    __m256i Words;
+
+    if (ElementSize == sizeof(unsigned int)) {
+        return _mm256_i32gather_epi32((const int *)TableData, Vertices, 4);
+    }
+
+    if (ElementSize == sizeof(unsigned short)) {
+        Words = _mm256_i32gather_epi32((const int *)TableData,
+                                       _mm256_srli_epi32(Vertices, 1),
+                                       4);
+        Shift = _mm256_slli_epi32(
+            _mm256_and_si256(Vertices, _mm256_set1_epi32(1)),
+            4
+        );
+        return _mm256_and_si256(_mm256_srlv_epi32(Words, Shift),
+                                _mm256_set1_epi32(0xffff));
+    }
+
+    Words = _mm256_i32gather_epi32((const int *)TableData,
+                                   _mm256_srli_epi32(Vertices, 2),
+                                   4);
+    Shift = _mm256_slli_epi32(
+        _mm256_and_si256(Vertices, _mm256_set1_epi32(3)),
+        3
+    );
+    return _mm256_and_si256(_mm256_srlv_epi32(Words, Shift),
+                            _mm256_set1_epi32(0xff));
+}
+
+//
+// Gather eight packed table data elements (see CphUnpackTableData() below).
+// The bit offset of each element is calculated in 64-bit lanes (it can exceed
+// 32 bits), then the 64 bits starting at the byte containing the element's
+// first bit are gathered, shifted right by the remaining 0-7 bits, and the
+// low 32 bits of each lane are compressed into a single vector and masked.
+//
+
+FORCEINLINE
+__m256i
+CphGatherPackedTableData256(
+    _In_ const ULONGLONG *TableData,
+    _In_ __m256i Vertices,
+    _In_ unsigned int Bits
+    )
+{
+    __m256i Low;
+    __m256i High;
+    __m256i Seven;
+    __m256i Multiplier;
+    __m256i Compress;
+
+    Seven = _mm256_set1_epi64x(7);
+    Multiplier = _mm256_set1_epi64x((long long)Bits);
+    Compress = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+
+    Low = _mm256_mul_epu32(
+        _mm256_cvtepu32_epi64(_mm256_castsi256_si128(Vertices)),
+        Multiplier
+    );
+    High = _mm256_mul_epu32(
+        _mm256_cvtepu32_epi64(_mm256_extracti128_si256(Vertices, 1)),
+        Multiplier
+    );
+
+    Low = _mm256_srlv_epi64(
+        _mm256_i64gather_epi64((const long long *)TableData,
+                               _mm256_srli_epi64(Low, 3),
+                               1),
+        _mm256_and_si256(Low, Seven)
+    );
+    High = _mm256_srlv_epi64(
+        _mm256_i64gather_epi64((const long long *)TableData,
+                               _mm256_srli_epi64(High, 3),
+                               1),
+        _mm256_and_si256(High, Seven)
+    );
+
+    Low = _mm256_permutevar8x32_epi32(Low, Compress);
+    High = _mm256_permutevar8x32_epi32(High, Compress);
+
+    return _mm256_and_si256(
+        _mm256_permute2x128_si256(Low, High, 0x20),
+        _mm256_set1_epi32((int)(0xffffffffU >> (32 - Bits)))
+    );
+}
+
+#endif
+
+//
+// Packed table data support.  Tables created with --TableDataLayout=Packed
+// emit the table data as an array of ULONGLONGs holding a little-endian bit
+// stream of TABLE_DATA_BITS-wide elements (and define CPH_PACKED_TABLE_DATA).
+// An element is extracted via an unaligned 64-bit load at the byte containing
+// its first bit, followed by a shift and mask, which is a single BEXTR when
+// BMI is available.  The array is padded by a trailing ULONGLONG, so the load
+// never reads past the end.  This must match GetPackedTableDataElement() in
+// the library.
+//
+
+#if defined(__BMI__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define CPH_BEXTR 1
+#endif
+
+FORCEINLINE
+ULONG
+CphUnpackTableData(
+    _In_ const ULONGLONG *TableData,
+    _In_ ULONG Index,
+    _In_ ULONG Bits
+    )
+{
+    ULONGLONG Bit;
+    ULONGLONG Word;
+    const char *Byte;
+
+    Bit = (ULONGLONG)Index * Bits;
+    Byte = (const char *)TableData + (Bit >> 3);
+
+#ifdef _WIN32
+    Word = *((const ULONGLONG __unaligned *)Byte);
+#else
+    __builtin_memcpy(&Word, Byte, sizeof(Word));
+#endif
+
+#ifdef CPH_BEXTR
+    return (ULONG)_bextr_u64(Word, (unsigned int)(Bit & 7), Bits);
+#else
+    return (ULONG)((Word >> (Bit & 7)) & ((1ULL << Bits) - 1));
+#endif
+}
+
+//
+// Key fingerprint support.  Tables created with --FingerprintSizeInBytes emit
+// a fingerprint array alongside the table data (and define
+// CPH_HAS_FINGERPRINTS), which the Contains() and TryLookup() routines use to
+// reject keys that weren't in the original key set.  The mixing function and
+// constants must match PerfectHashTableFingerprintKey() in the library.
+//
+
+#define CPH_FINGERPRINT_MULTIPLIER1 0x7feb352d
+#define CPH_FINGERPRINT_MULTIPLIER2 0x846ca68b
+
+FORCEINLINE
+ULONG
+CphFingerprintKey(
+    _In_ ULONG Key
+    )
+{
+    ULONG Hash;
+
+    Hash = Key;
+    Hash ^= Hash >> 16;
+    Hash *= CPH_FINGERPRINT_MULTIPLIER1;
+    Hash ^= Hash >> 15;
+    Hash *= CPH_FINGERPRINT_MULTIPLIER2;
+    Hash ^= Hash >> 16;
+
+    return Hash;
+}
+
+//
+// String key support.  Tables created with --StringKeys reduce each string to
+// a unique 32-bit key (and define CPH_STRING_KEYS), and emit the strings so
+// the TryIndexString() routine can reject strings that weren't in the keys
+// file.  Each string is reduced by a CRC32-C over its 8-byte lanes, two lanes
+// at a time, after multiplying each lane by an odd, seed-derived constant.
+// The routine and constants must match HashStringKey() in the library (see
+// StringKeys.h and ReducedKeys.h).
+//
+
+#define CPH_REDUCED_KEY_LANE_MULTIPLIER 0x9e3779b97f4a7c15ULL
+
+FORCEINLINE
+ULONGLONG
+CphLoadStringKeyLane(
+    _In_reads_bytes_(8) const BYTE *Bytes
+    )
+{
+    ULONGLONG Lane;
+
+#ifdef _WIN32
+    Lane = *((const ULONGLONG __unaligned *)Bytes);
+#else
+    __builtin_memcpy(&Lane, Bytes, sizeof(Lane));
+#endif
+
+    return Lane;
+}
+
+FORCEINLINE
+ULONG
+CphHashStringKey(
+    _In_reads_bytes_(Length) const BYTE *Bytes,
+    _In_ ULONG Length,
+    _In_ ULONG Seed
+    )
+{
+    ULONG Hash1;
+    ULONG Hash2;
+    ULONG Index;
+    ULONG Remaining;
+    ULONGLONG Lane;
+    ULONGLONG Multiplier;
+
+    Hash1 = Seed;
+    Hash2 = Length;
+    Remaining = Length;
+    Multiplier = ((ULONGLONG)Seed * CPH_REDUCED_KEY_LANE_MULTIPLIER) | 1;
+
+    while (Remaining >= 16) {
+        Lane = CphLoadStringKeyLane(Bytes);
+        Hash1 = (ULONG)_mm_crc32_u64(Hash1, Lane * Multiplier);
+        Lane = CphLoadStringKeyLane(Bytes + 8);
+        Hash2 = (ULONG)_mm_crc32_u64(Hash2, Lane * Multiplier);
+        Bytes += 16;
+        Remaining -= 16;
+    }
+
+    if (Remaining >= 8) {
+        Lane = CphLoadStringKeyLane(Bytes);
+        Hash1 = (ULONG)_mm_crc32_u64(Hash1, Lane * Multiplier);
+        Bytes += 8;
+        Remaining -= 8;
+    }
+
+    if (Remaining > 0) {
+        Lane = 0;
+        for (Index = 0; Index < Remaining; Index++) {
+            Lane |= ((ULONGLONG)Bytes[Index] << (Index << 3));
+        }
+        Hash2 = (ULONG)_mm_crc32_u64(Hash2, Lane * Multiplier);
+    }
+
+    return _mm_crc32_u32(Hash1, Hash2);
+}
+
+//
+// 128-bit key support.  Tables created from 128-bit keys (e.g. UUIDs) reduce
+// each key to a unique 32-bit key (and define CPH_KEY128, in which case CPHKEY
+// is a structure of two ULONGLONGs).  A 128-bit key is reduced identically to
+// a 16-byte string key.  The routine must match HashKey128() in the library
+// (see Keys128.h).
+//
+
+FORCEINLINE
+ULONG
+CphHashKey128(
+    _In_ ULONGLONG Low,
+    _In_ ULONGLONG High,
+    _In_ ULONG Seed
+    )
+{
+    ULONG Hash1;
+    ULONG Hash2;
+    ULONGLONG Multiplier;
+
+    Multiplier = ((ULONGLONG)Seed * CPH_REDUCED_KEY_LANE_MULTIPLIER) | 1;
+
+    Hash1 = (ULONG)_mm_crc32_u64(Seed, Low * Multiplier);
+    Hash2 = (ULONG)_mm_crc32_u64(16, High * Multiplier);
+
+    return _mm_crc32_u32(Hash1, Hash2);
+}
+
+#ifdef CPH_KEY128
+
+//
+// The test and benchmark routines derive values from keys by rotating them;
+// 128-bit keys are rotated by rotating each half.
+//
+
+FORCEINLINE
+CPHKEY
+CphRotateKey128Left(
+    _In_ CPHKEY Key,
+    _In_ ULONG Count
+    )
+{
+    CPHKEY Rotated;
+
+    Rotated.Low = _rotl64(Key.Low, Count);
+    Rotated.High = _rotl64(Key.High, Count);
+
+    return Rotated;
+}
+
+FORCEINLINE
+CPHKEY
+CphRotateKey128Right(
+    _In_ CPHKEY Key,
+    _In_ ULONG Count
+    )
+{
+    CPHKEY Rotated;
+
+    Rotated.Low = _rotr64(Key.Low, Count);
+    Rotated.High = _rotr64(Key.High, Count);
+
+    return Rotated;
+}
+
+#endif
+
 //
 // Define the main functions exposed by a compiled perfect hash table: index,
-// lookup, insert and delete.
+// lookup, insert and delete, plus the batched variants of index and lookup,
+// the fingerprint-checked Contains() and TryLookup() routines, and the string
+// key IndexString() and TryIndexString() routines.
 //
 
 typedef
@@ -148,6 +519,147 @@ Return Value:
 --*/
 typedef COMPILED_PERFECT_HASH_TABLE_INDEX *PCOMPILED_PERFECT_HASH_TABLE_INDEX;
 
+typedef
+CPHAPI
+VOID
+(CPHCALLTYPE COMPILED_PERFECT_HASH_TABLE_INDEX_BATCH)(
+    _In_ ULONG NumberOfKeys,
+    _In_reads_(NumberOfKeys) const CPHKEY *Keys,
+    _Out_writes_(NumberOfKeys) CPHINDEX *Indices
+    );
+/*++
+
+Routine Description:
+
+    Looks up an array of keys in a compiled perfect hash table and returns
+    their indices.  This is equivalent to calling Index() for each key, but
+    processes eight keys at a time via AVX2 where supported (see CPH_AVX2).
+
+    N.B. If a given key did not appear in the original set the hash table was
+         created from, the behavior of this routine is undefined for that key.
+
+Arguments:
+
+    NumberOfKeys - Supplies the number of keys in the Keys array.
+
+    Keys - Supplies the base address of an array of keys to look up.
+
+    Indices - Receives the index associated with each key.
+
+Return Value:
+
+    None.
+
+--*/
+typedef COMPILED_PERFECT_HASH_TABLE_INDEX_BATCH
+      *PCOMPILED_PERFECT_HASH_TABLE_INDEX_BATCH;
+
+typedef
+CPHAPI
+BOOLEAN
+(CPHCALLTYPE COMPILED_PERFECT_HASH_TABLE_CONTAINS)(
+    _In_ CPHKEY Key
+    );
+/*++
+
+Routine Description:
+
+    Tests whether or not a key was present in the original set the hash table
+    was created from, by comparing the key's fingerprint against the one that
+    was captured for its index when the table was created.  Keys that were in
+    the original set always return TRUE; keys that weren't return FALSE unless
+    their fingerprint collides with the one stored at their index, which has a
+    probability of 1 in 2^(8 * sizeof(CPHFINGERPRINT)).
+
+    N.B. Only available if the table was created with fingerprints, as
+         indicated by CPH_HAS_FINGERPRINTS being defined.
+
+Arguments:
+
+    Key - Supplies the key to test.
+
+Return Value:
+
+    TRUE if the key is (probably) present, FALSE if it is definitely absent.
+
+--*/
+typedef COMPILED_PERFECT_HASH_TABLE_CONTAINS
+      *PCOMPILED_PERFECT_HASH_TABLE_CONTAINS;
+
+typedef
+CPHAPI
+CPHINDEX
+(CPHCALLTYPE COMPILED_PERFECT_HASH_TABLE_INDEX_STRING)(
+    _In_reads_bytes_(Length) const BYTE *String,
+    _In_ ULONG Length
+    );
+/*++
+
+Routine Description:
+
+    Reduces a string to its 32-bit key, then looks up the key in a compiled
+    perfect hash table and returns its index.  As string key tables are always
+    order preserving, the index of a string is the offset of its key in the
+    table's keys array (which is sorted by reduced key, not file order).
+
+    N.B. Only available if the table was created from string keys, as
+         indicated by CPH_STRING_KEYS being defined.
+
+    N.B. If the given string did not appear in the keys file the hash table
+         was created from, the behavior of this routine is undefined; use
+         TryIndexString() if this is possible.
+
+Arguments:
+
+    String - Supplies the base address of the string's bytes.
+
+    Length - Supplies the length of the string, in bytes.
+
+Return Value:
+
+    The index associated with the given string.
+
+--*/
+typedef COMPILED_PERFECT_HASH_TABLE_INDEX_STRING
+      *PCOMPILED_PERFECT_HASH_TABLE_INDEX_STRING;
+
+typedef
+CPHAPI
+BOOLEAN
+(CPHCALLTYPE COMPILED_PERFECT_HASH_TABLE_TRY_INDEX_STRING)(
+    _In_reads_bytes_(Length) const BYTE *String,
+    _In_ ULONG Length,
+    _Out_ CPHINDEX *Index
+    );
+/*++
+
+Routine Description:
+
+    Looks up a string in a compiled perfect hash table, then verifies it by
+    comparing it against the string stored for the resulting index.  Unlike
+    fingerprints, the comparison is exact; strings that weren't in the keys
+    file always return FALSE.
+
+    N.B. Only available if the table was created from string keys, as
+         indicated by CPH_STRING_KEYS being defined.
+
+Arguments:
+
+    String - Supplies the base address of the string's bytes.
+
+    Length - Supplies the length of the string, in bytes.
+
+    Index - Receives the index associated with the string if it is present,
+        0 otherwise.
+
+Return Value:
+
+    TRUE if the string is present, FALSE otherwise.
+
+--*/
+typedef COMPILED_PERFECT_HASH_TABLE_TRY_INDEX_STRING
+      *PCOMPILED_PERFECT_HASH_TABLE_TRY_INDEX_STRING;
+
 #ifndef CPH_INDEX_ONLY
 
 typedef
@@ -181,6 +693,42 @@ Return Value:
 --*/
 typedef COMPILED_PERFECT_HASH_TABLE_LOOKUP *PCOMPILED_PERFECT_HASH_TABLE_LOOKUP;
 
+typedef
+CPHAPI
+VOID
+(CPHCALLTYPE COMPILED_PERFECT_HASH_TABLE_LOOKUP_BATCH)(
+    _In_ ULONG NumberOfKeys,
+    _In_reads_(NumberOfKeys) const CPHKEY *Keys,
+    _Out_writes_(NumberOfKeys) CPHVALUE *Values
+    );
+/*++
+
+Routine Description:
+
+    Looks up an array of keys in a compiled perfect hash table and returns
+    the value present for each key.  This is equivalent to calling Lookup()
+    for each key, but processes eight keys at a time via AVX2 where supported
+    (see CPH_AVX2), gathering both the table data and the values.
+
+    N.B. If a given key did not appear in the original set the hash table was
+         created from, the behavior of this routine is undefined for that key.
+
+Arguments:
+
+    NumberOfKeys - Supplies the number of keys in the Keys array.
+
+    Keys - Supplies the base address of an array of keys to look up.
+
+    Values - Receives the value for each key.
+
+Return Value:
+
+    None.
+
+--*/
+typedef COMPILED_PERFECT_HASH_TABLE_LOOKUP_BATCH
+      *PCOMPILED_PERFECT_HASH_TABLE_LOOKUP_BATCH;
+
 
 typedef
 CPHAPI
@@ -252,6 +800,39 @@ Return Value:
 --*/
 typedef COMPILED_PERFECT_HASH_TABLE_DELETE *PCOMPILED_PERFECT_HASH_TABLE_DELETE;
 
+
+typedef
+CPHAPI
+BOOLEAN
+(CPHCALLTYPE COMPILED_PERFECT_HASH_TABLE_TRY_LOOKUP)(
+    _In_ CPHKEY Key,
+    _Out_ CPHVALUE *Value
+    );
+/*++
+
+Routine Description:
+
+    Looks up given key in a compiled perfect hash table, verifying its
+    fingerprint first.  This is equivalent to calling Contains() followed by
+    Lookup(), but only hashes the key once.
+
+    N.B. Only available if the table was created with fingerprints, as
+         indicated by CPH_HAS_FINGERPRINTS being defined.
+
+Arguments:
+
+    Key - Supplies the key to look up.
+
+    Value - Receives the value for the key if the key is present, 0 otherwise.
+
+Return Value:
+
+    TRUE if the key is (probably) present, FALSE if it is definitely absent.
+
+--*/
+typedef COMPILED_PERFECT_HASH_TABLE_TRY_LOOKUP
+      *PCOMPILED_PERFECT_HASH_TABLE_TRY_LOOKUP;
+
 //
 // Typedefs of methods for testing and benchmarking.
 //
@@ -70,9 +70,17 @@
 #define CPH_INDEX_MODULUS(U) U##_INDEX_MODULUS
 
 #define CPH_TABLE_DATA(T) T##_TableData
+#define CPH_TABLE_SHARDS(T) T##_TableShards
+#define CPH_NUMBER_OF_SHARDS(U) U##_NUMBER_OF_SHARDS
+#define CPH_TABLE_DATA_BITS(U) U##_TABLE_DATA_BITS
 #define CPH_TABLE_VALUES(T) T##_TableValues
+#define CPH_TABLE_FINGERPRINTS(T) T##_TableFingerprints
+#define CPH_TABLE_SLOTS(T) T##_TableSlots
 #define CPH_KEYS(T) T##_Keys
 #define CPH_NUMBER_OF_KEYS(U) U##_NUMBER_OF_KEYS
+#define CPH_STRING_KEY_OFFSETS(T) T##_StringKeyOffsets
+#define CPH_STRING_KEY_DATA(T) T##_StringKeyData
+#define CPH_STRING_KEY_SEED(U) U##_STRING_KEY_SEED
 
 #define CPH_DOWNSIZE_KEY(U) U##_DOWNSIZE_KEY
 #define CPH_ROTATE_KEY_LEFT(U) U##_ROTATE_KEY_LEFT
@@ -88,6 +96,26 @@
 #define CPH_INSERT_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_InsertInline
 #define CPH_DELETE_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_DeleteInline
 
+#define CPH_INDEX_BATCH_ROUTINE_NAME(T) CompiledPerfectHash_##T##_IndexBatch
+#define CPH_LOOKUP_BATCH_ROUTINE_NAME(T) CompiledPerfectHash_##T##_LookupBatch
+
+#define CPH_INDEX_BATCH_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_IndexBatchInline
+#define CPH_LOOKUP_BATCH_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_LookupBatchInline
+
+#define CPH_CONTAINS_ROUTINE_NAME(T) CompiledPerfectHash_##T##_Contains
+#define CPH_TRY_LOOKUP_ROUTINE_NAME(T) CompiledPerfectHash_##T##_TryLookup
+
+#define CPH_CONTAINS_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_ContainsInline
+#define CPH_TRY_LOOKUP_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_TryLookupInline
+
+#define CPH_INDEX_STRING_ROUTINE_NAME(T) CompiledPerfectHash_##T##_IndexString
+#define CPH_TRY_INDEX_STRING_ROUTINE_NAME(T) CompiledPerfectHash_##T##_TryIndexString
+
+#define CPH_INDEX_STRING_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_IndexStringInline
+#define CPH_TRY_INDEX_STRING_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_TryIndexStringInline
+
+#define CPH_HASH_AVX2_ROUTINE_NAME(T) CompiledPerfectHash_##T##_HashAvx2
+
 ////////////////////////////////////////////////////////////////////////////////
 // Index
 ////////////////////////////////////////////////////////////////////////////////
@@ -207,6 +235,216 @@ CompiledPerfectHash_##T##_DeleteInline(     \
     CPHKEY Key                              \
     )
 
+////////////////////////////////////////////////////////////////////////////////
+// IndexBatch
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Normal
+//
+
+#define CPH_INDEX_BATCH_ROUTINE_HEADER(T)      \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX_BATCH \
+    CompiledPerfectHash_##T##_IndexBatch;      \
+                                               \
+_Use_decl_annotations_                         \
+VOID                                           \
+CompiledPerfectHash_##T##_IndexBatch(          \
+    ULONG NumberOfKeys,                        \
+    const CPHKEY *Keys,                        \
+    CPHINDEX *Indices                          \
+    )
+
+//
+// Inline
+//
+
+#define CPH_INDEX_BATCH_INLINE_ROUTINE_HEADER(T) \
+FORCEINLINE                                      \
+VOID                                             \
+CompiledPerfectHash_##T##_IndexBatchInline(      \
+    ULONG NumberOfKeys,                          \
+    const CPHKEY *Keys,                          \
+    CPHINDEX *Indices                            \
+    )
+
+////////////////////////////////////////////////////////////////////////////////
+// LookupBatch
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Normal
+//
+
+#define CPH_LOOKUP_BATCH_ROUTINE_HEADER(T)      \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_LOOKUP_BATCH \
+    CompiledPerfectHash_##T##_LookupBatch;      \
+                                                \
+_Use_decl_annotations_                          \
+VOID                                            \
+CompiledPerfectHash_##T##_LookupBatch(          \
+    ULONG NumberOfKeys,                         \
+    const CPHKEY *Keys,                         \
+    CPHVALUE *Values                            \
+    )
+
+//
+// Inline
+//
+
+#define CPH_LOOKUP_BATCH_INLINE_ROUTINE_HEADER(T) \
+FORCEINLINE                                       \
+VOID                                              \
+CompiledPerfectHash_##T##_LookupBatchInline(      \
+    ULONG NumberOfKeys,                           \
+    const CPHKEY *Keys,                           \
+    CPHVALUE *Values                              \
+    )
+
+////////////////////////////////////////////////////////////////////////////////
+// Contains
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Normal
+//
+
+#define CPH_CONTAINS_ROUTINE_HEADER(T)      \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_CONTAINS \
+    CompiledPerfectHash_##T##_Contains;     \
+                                            \
+_Use_decl_annotations_                      \
+BOOLEAN                                     \
+CompiledPerfectHash_##T##_Contains(         \
+    CPHKEY Key                              \
+    )
+
+//
+// Inline
+//
+
+#define CPH_CONTAINS_INLINE_ROUTINE_HEADER(T) \
+FORCEINLINE                                   \
+BOOLEAN                                       \
+CompiledPerfectHash_##T##_ContainsInline(     \
+    CPHKEY Key                                \
+    )
+
+////////////////////////////////////////////////////////////////////////////////
+// TryLookup
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Normal
+//
+
+#define CPH_TRY_LOOKUP_ROUTINE_HEADER(T)      \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_TRY_LOOKUP \
+    CompiledPerfectHash_##T##_TryLookup;      \
+                                              \
+_Use_decl_annotations_                        \
+BOOLEAN                                       \
+CompiledPerfectHash_##T##_TryLookup(          \
+    CPHKEY Key,                               \
+    CPHVALUE *Value                           \
+    )
+
+//
+// Inline
+//
+
+#define CPH_TRY_LOOKUP_INLINE_ROUTINE_HEADER(T) \
+FORCEINLINE                                     \
+BOOLEAN                                         \
+CompiledPerfectHash_##T##_TryLookupInline(      \
+    CPHKEY Key,                                 \
+    CPHVALUE *Value                             \
+    )
+
+////////////////////////////////////////////////////////////////////////////////
+// IndexString
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Normal
+//
+
+#define CPH_INDEX_STRING_ROUTINE_HEADER(T)      \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX_STRING \
+    CompiledPerfectHash_##T##_IndexString;      \
+                                                \
+_Use_decl_annotations_                          \
+CPHINDEX                                        \
+CompiledPerfectHash_##T##_IndexString(          \
+    const BYTE *String,                         \
+    ULONG Length                                \
+    )
+
+//
+// Inline
+//
+
+#define CPH_INDEX_STRING_INLINE_ROUTINE_HEADER(T) \
+FORCEINLINE                                       \
+CPHINDEX                                          \
+CompiledPerfectHash_##T##_IndexStringInline(      \
+    const BYTE *String,                           \
+    ULONG Length                                  \
+    )
+
+////////////////////////////////////////////////////////////////////////////////
+// TryIndexString
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Normal
+//
+
+#define CPH_TRY_INDEX_STRING_ROUTINE_HEADER(T)      \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_TRY_INDEX_STRING \
+    CompiledPerfectHash_##T##_TryIndexString;       \
+                                                    \
+_Use_decl_annotations_                              \
+BOOLEAN                                             \
+CompiledPerfectHash_##T##_TryIndexString(           \
+    const BYTE *String,                             \
+    ULONG Length,                                   \
+    CPHINDEX *Index                                 \
+    )
+
+//
+// Inline
+//
+
+#define CPH_TRY_INDEX_STRING_INLINE_ROUTINE_HEADER(T) \
+FORCEINLINE                                           \
+BOOLEAN                                               \
+CompiledPerfectHash_##T##_TryIndexStringInline(       \
+    const BYTE *String,                               \
+    ULONG Length,                                     \
+    CPHINDEX *Index                                   \
+    )
+
+////////////////////////////////////////////////////////////////////////////////
+// HashAvx2
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Implemented by the Index() templates whose hash function can be expressed
+// with AVX2 32-bit lane operations.  Receives eight downsized keys and returns
+// their (unmasked) vertex pairs; always inline, regardless of whether or not
+// CPH_INLINE_ROUTINES is defined.
+//
+
+#define CPH_HASH_AVX2_ROUTINE_HEADER(T)    \
+FORCEINLINE                                \
+VOID                                       \
+CompiledPerfectHash_##T##_HashAvx2(        \
+    __m256i DownsizedKeys,                 \
+    __m256i *Vertex1Pointer,               \
+    __m256i *Vertex2Pointer                \
+    )
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // Test and Benchmarking
@@ -252,22 +490,55 @@ BenchmarkIndexCompiledPerfectHashTable_##T(     \
 ////////////////////////////////////////////////////////////////////////////////
 
 #ifdef CPH_INDEX_ONLY
-#define CPH_DEFINE_TABLE_ROUTINES(T)                                     \
-CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX CompiledPerfectHash_##T##_Index
+#ifdef CPH_HAS_FINGERPRINTS
+#define CPH_DEFINE_TABLE_ROUTINES(T)                                      \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX CompiledPerfectHash_##T##_Index; \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX_BATCH                            \
+    CompiledPerfectHash_##T##_IndexBatch;                                 \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_CONTAINS                               \
+    CompiledPerfectHash_##T##_Contains
+#else
+#define CPH_DEFINE_TABLE_ROUTINES(T)                                      \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX CompiledPerfectHash_##T##_Index; \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX_BATCH                            \
+    CompiledPerfectHash_##T##_IndexBatch
+#endif
 
 #define CPH_INDEX_ROUTINE(T) CPH_INDEX_ROUTINE_NAME(T)
 #define CPH_INDEX_INLINE_ROUTINE(T) CPH_INDEX_INLINE_ROUTINE_NAME(T)
+#define CPH_INDEX_BATCH_ROUTINE(T) CPH_INDEX_BATCH_ROUTINE_NAME(T)
+#define CPH_INDEX_BATCH_INLINE_ROUTINE(T) CPH_INDEX_BATCH_INLINE_ROUTINE_NAME(T)
 
 #define CPH_DEFINE_TEST_AND_BENCHMARKING_ROUTINES(T) \
 extern BENCHMARK_INDEX_COMPILED_PERFECT_HASH_TABLE   \
     BenchmarkIndexCompiledPerfectHashTable_##T
 
 #else
+#ifdef CPH_HAS_FINGERPRINTS
 #define CPH_DEFINE_TABLE_ROUTINES(T)                                        \
 CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX CompiledPerfectHash_##T##_Index;   \
 CPHAPI COMPILED_PERFECT_HASH_TABLE_LOOKUP CompiledPerfectHash_##T##_Lookup; \
 CPHAPI COMPILED_PERFECT_HASH_TABLE_INSERT CompiledPerfectHash_##T##_Insert; \
-CPHAPI COMPILED_PERFECT_HASH_TABLE_DELETE CompiledPerfectHash_##T##_Delete
+CPHAPI COMPILED_PERFECT_HASH_TABLE_DELETE CompiledPerfectHash_##T##_Delete; \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX_BATCH                              \
+    CompiledPerfectHash_##T##_IndexBatch;                                   \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_LOOKUP_BATCH                             \
+    CompiledPerfectHash_##T##_LookupBatch;                                  \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_CONTAINS                                 \
+    CompiledPerfectHash_##T##_Contains;                                     \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_TRY_LOOKUP                               \
+    CompiledPerfectHash_##T##_TryLookup
+#else
+#define CPH_DEFINE_TABLE_ROUTINES(T)                                        \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX CompiledPerfectHash_##T##_Index;   \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_LOOKUP CompiledPerfectHash_##T##_Lookup; \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_INSERT CompiledPerfectHash_##T##_Insert; \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_DELETE CompiledPerfectHash_##T##_Delete; \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX_BATCH                              \
+    CompiledPerfectHash_##T##_IndexBatch;                                   \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_LOOKUP_BATCH                             \
+    CompiledPerfectHash_##T##_LookupBatch
+#endif
 
 #define CPH_DEFINE_TEST_AND_BENCHMARKING_ROUTINES(T) \
 extern TEST_COMPILED_PERFECT_HASH_TABLE              \
@@ -288,8 +559,33 @@ extern BENCHMARK_INDEX_COMPILED_PERFECT_HASH_TABLE   \
 #define CPH_LOOKUP_INLINE_ROUTINE(T) CPH_LOOKUP_INLINE_ROUTINE_NAME(T)
 #define CPH_INSERT_INLINE_ROUTINE(T) CPH_INSERT_INLINE_ROUTINE_NAME(T)
 #define CPH_DELETE_INLINE_ROUTINE(T) CPH_DELETE_INLINE_ROUTINE_NAME(T)
+
+#define CPH_INDEX_BATCH_ROUTINE(T) CPH_INDEX_BATCH_ROUTINE_NAME(T)
+#define CPH_LOOKUP_BATCH_ROUTINE(T) CPH_LOOKUP_BATCH_ROUTINE_NAME(T)
+
+#define CPH_INDEX_BATCH_INLINE_ROUTINE(T) CPH_INDEX_BATCH_INLINE_ROUTINE_NAME(T)
+#define CPH_LOOKUP_BATCH_INLINE_ROUTINE(T) CPH_LOOKUP_BATCH_INLINE_ROUTINE_NAME(T)
+
+#define CPH_TRY_LOOKUP_ROUTINE(T) CPH_TRY_LOOKUP_ROUTINE_NAME(T)
+#define CPH_TRY_LOOKUP_INLINE_ROUTINE(T) CPH_TRY_LOOKUP_INLINE_ROUTINE_NAME(T)
 #endif
 
+#define CPH_CONTAINS_ROUTINE(T) CPH_CONTAINS_ROUTINE_NAME(T)
+#define CPH_CONTAINS_INLINE_ROUTINE(T) CPH_CONTAINS_INLINE_ROUTINE_NAME(T)
+
+#define CPH_INDEX_STRING_ROUTINE(T) CPH_INDEX_STRING_ROUTINE_NAME(T)
+#define CPH_TRY_INDEX_STRING_ROUTINE(T) CPH_TRY_INDEX_STRING_ROUTINE_NAME(T)
+#define CPH_INDEX_STRING_INLINE_ROUTINE(T) CPH_INDEX_STRING_INLINE_ROUTINE_NAME(T)
+#define CPH_TRY_INDEX_STRING_INLINE_ROUTINE(T) CPH_TRY_INDEX_STRING_INLINE_ROUTINE_NAME(T)
+
+#define CPH_DEFINE_STRING_TABLE_ROUTINES(T)         \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX_STRING     \
+    CompiledPerfectHash_##T##_IndexString;          \
+CPHAPI COMPILED_PERFECT_HASH_TABLE_TRY_INDEX_STRING \
+    CompiledPerfectHash_##T##_TryIndexString
+
+#define CPH_HASH_AVX2_ROUTINE(T) CPH_HASH_AVX2_ROUTINE_NAME(T)
+
 #define EXPAND_SEED1(U) CPH_SEED1(U)
 #define EXPAND_SEED2(U) CPH_SEED2(U)
 #define EXPAND_SEED3(U) CPH_SEED3(U)
@@ -360,9 +656,17 @@ extern BENCHMARK_INDEX_COMPILED_PERFECT_HASH_TABLE   \
 #define EXPAND_HASH_MODULUS(U) CPH_HASH_MODULUS(U)
 #define EXPAND_INDEX_MODULUS(U) CPH_INDEX_MODULUS(U)
 #define EXPAND_TABLE_DATA(T) CPH_TABLE_DATA(T)
+#define EXPAND_TABLE_SHARDS(T) CPH_TABLE_SHARDS(T)
+#define EXPAND_NUMBER_OF_SHARDS(U) CPH_NUMBER_OF_SHARDS(U)
+#define EXPAND_TABLE_DATA_BITS(U) CPH_TABLE_DATA_BITS(U)
 #define EXPAND_TABLE_VALUES(T) CPH_TABLE_VALUES(T)
+#define EXPAND_TABLE_FINGERPRINTS(T) CPH_TABLE_FINGERPRINTS(T)
+#define EXPAND_TABLE_SLOTS(T) CPH_TABLE_SLOTS(T)
 #define EXPAND_KEYS(T) CPH_KEYS(T)
 #define EXPAND_NUMBER_OF_KEYS(U) CPH_NUMBER_OF_KEYS(U)
+#define EXPAND_STRING_KEY_OFFSETS(T) CPH_STRING_KEY_OFFSETS(T)
+#define EXPAND_STRING_KEY_DATA(T) CPH_STRING_KEY_DATA(T)
+#define EXPAND_STRING_KEY_SEED(U) CPH_STRING_KEY_SEED(U)
 
 #define EXPAND_DOWNSIZE_KEY(U) CPH_DOWNSIZE_KEY(U)
 #define EXPAND_ROTATE_KEY_LEFT(U) CPH_ROTATE_KEY_LEFT(U)
@@ -388,6 +692,39 @@ extern BENCHMARK_INDEX_COMPILED_PERFECT_HASH_TABLE   \
 #define EXPAND_INSERT_INLINE_ROUTINE_HEADER(T) CPH_INSERT_INLINE_ROUTINE_HEADER(T)
 #define EXPAND_DELETE_INLINE_ROUTINE_HEADER(T) CPH_DELETE_INLINE_ROUTINE_HEADER(T)
 
+#define EXPAND_INDEX_BATCH_ROUTINE(T) CPH_INDEX_BATCH_ROUTINE(T)
+#define EXPAND_LOOKUP_BATCH_ROUTINE(T) CPH_LOOKUP_BATCH_ROUTINE(T)
+#define EXPAND_INDEX_BATCH_INLINE_ROUTINE(T) CPH_INDEX_BATCH_INLINE_ROUTINE(T)
+#define EXPAND_LOOKUP_BATCH_INLINE_ROUTINE(T) CPH_LOOKUP_BATCH_INLINE_ROUTINE(T)
+
+#define EXPAND_INDEX_BATCH_ROUTINE_HEADER(T) CPH_INDEX_BATCH_ROUTINE_HEADER(T)
+#define EXPAND_LOOKUP_BATCH_ROUTINE_HEADER(T) CPH_LOOKUP_BATCH_ROUTINE_HEADER(T)
+#define EXPAND_INDEX_BATCH_INLINE_ROUTINE_HEADER(T) CPH_INDEX_BATCH_INLINE_ROUTINE_HEADER(T)
+#define EXPAND_LOOKUP_BATCH_INLINE_ROUTINE_HEADER(T) CPH_LOOKUP_BATCH_INLINE_ROUTINE_HEADER(T)
+
+#define EXPAND_CONTAINS_ROUTINE(T) CPH_CONTAINS_ROUTINE(T)
+#define EXPAND_TRY_LOOKUP_ROUTINE(T) CPH_TRY_LOOKUP_ROUTINE(T)
+#define EXPAND_CONTAINS_INLINE_ROUTINE(T) CPH_CONTAINS_INLINE_ROUTINE(T)
+#define EXPAND_TRY_LOOKUP_INLINE_ROUTINE(T) CPH_TRY_LOOKUP_INLINE_ROUTINE(T)
+
+#define EXPAND_CONTAINS_ROUTINE_HEADER(T) CPH_CONTAINS_ROUTINE_HEADER(T)
+#define EXPAND_TRY_LOOKUP_ROUTINE_HEADER(T) CPH_TRY_LOOKUP_ROUTINE_HEADER(T)
+#define EXPAND_CONTAINS_INLINE_ROUTINE_HEADER(T) CPH_CONTAINS_INLINE_ROUTINE_HEADER(T)
+#define EXPAND_TRY_LOOKUP_INLINE_ROUTINE_HEADER(T) CPH_TRY_LOOKUP_INLINE_ROUTINE_HEADER(T)
+
+#define EXPAND_INDEX_STRING_ROUTINE(T) CPH_INDEX_STRING_ROUTINE(T)
+#define EXPAND_TRY_INDEX_STRING_ROUTINE(T) CPH_TRY_INDEX_STRING_ROUTINE(T)
+#define EXPAND_INDEX_STRING_INLINE_ROUTINE(T) CPH_INDEX_STRING_INLINE_ROUTINE(T)
+#define EXPAND_TRY_INDEX_STRING_INLINE_ROUTINE(T) CPH_TRY_INDEX_STRING_INLINE_ROUTINE(T)
+
+#define EXPAND_INDEX_STRING_ROUTINE_HEADER(T) CPH_INDEX_STRING_ROUTINE_HEADER(T)
+#define EXPAND_TRY_INDEX_STRING_ROUTINE_HEADER(T) CPH_TRY_INDEX_STRING_ROUTINE_HEADER(T)
+#define EXPAND_INDEX_STRING_INLINE_ROUTINE_HEADER(T) CPH_INDEX_STRING_INLINE_ROUTINE_HEADER(T)
+#define EXPAND_TRY_INDEX_STRING_INLINE_ROUTINE_HEADER(T) CPH_TRY_INDEX_STRING_INLINE_ROUTINE_HEADER(T)
+
+#define EXPAND_HASH_AVX2_ROUTINE(T) CPH_HASH_AVX2_ROUTINE(T)
+#define EXPAND_HASH_AVX2_ROUTINE_HEADER(T) CPH_HASH_AVX2_ROUTINE_HEADER(T)
+
 #define EXPAND_TEST_CPH_ROUTINE_HEADER(T) TEST_CPH_ROUTINE_HEADER(T)
 #define EXPAND_BENCHMARK_FULL_CPH_ROUTINE_HEADER(T) BENCHMARK_FULL_CPH_ROUTINE_HEADER(T)
 #define EXPAND_BENCHMARK_INDEX_CPH_ROUTINE_HEADER(T) BENCHMARK_INDEX_CPH_ROUTINE_HEADER(T)
@@ -397,6 +734,7 @@ extern BENCHMARK_INDEX_COMPILED_PERFECT_HASH_TABLE   \
 #define EXPAND_BENCHMARK_INDEX_CPH_ROUTINE_NAME(T) CPH_BENCHMARK_INDEX_CPH_ROUTINE_NAME(T)
 
 #define EXPAND_DEFINE_TABLE_ROUTINES(T) CPH_DEFINE_TABLE_ROUTINES(T)
+#define EXPAND_DEFINE_STRING_TABLE_ROUTINES(T) CPH_DEFINE_STRING_TABLE_ROUTINES(T)
 #define EXPAND_DEFINE_TEST_AND_BENCHMARKING_ROUTINES(T) CPH_DEFINE_TEST_AND_BENCHMARKING_ROUTINES(T)
 
 #define SEED1 EXPAND_SEED1(CPH_TABLENAME_UPPER)
@@ -469,12 +807,67 @@ extern BENCHMARK_INDEX_COMPILED_PERFECT_HASH_TABLE   \
 #define HASH_MODULUS EXPAND_HASH_MODULUS(CPH_TABLENAME_UPPER)
 #define INDEX_MODULUS EXPAND_INDEX_MODULUS(CPH_TABLENAME_UPPER)
 #define TABLE_DATA EXPAND_TABLE_DATA(CPH_TABLENAME)
+#define TABLE_SHARDS EXPAND_TABLE_SHARDS(CPH_TABLENAME)
+#define NUMBER_OF_SHARDS EXPAND_NUMBER_OF_SHARDS(CPH_TABLENAME_UPPER)
+#define TABLE_DATA_BITS EXPAND_TABLE_DATA_BITS(CPH_TABLENAME_UPPER)
 #define TABLE_VALUES EXPAND_TABLE_VALUES(CPH_TABLENAME)
+#define TABLE_FINGERPRINTS EXPAND_TABLE_FINGERPRINTS(CPH_TABLENAME)
+#define TABLE_SLOTS EXPAND_TABLE_SLOTS(CPH_TABLENAME)
 #define KEYS EXPAND_KEYS(CPH_TABLENAME)
 #define NUMBER_OF_KEYS EXPAND_NUMBER_OF_KEYS(CPH_TABLENAME_UPPER)
+#define STRING_KEY_OFFSETS EXPAND_STRING_KEY_OFFSETS(CPH_TABLENAME)
+#define STRING_KEY_DATA EXPAND_STRING_KEY_DATA(CPH_TABLENAME)
+#define STRING_KEY_SEED EXPAND_STRING_KEY_SEED(CPH_TABLENAME_UPPER)
+#define HASH_STRING_KEY(S, L) CphHashStringKey((S), (L), STRING_KEY_SEED)
 #define DOWNSIZE_KEY(K) EXPAND_DOWNSIZE_KEY(CPH_TABLENAME_UPPER)(K)
 #define ROTATE_KEY_LEFT EXPAND_ROTATE_KEY_LEFT(CPH_TABLENAME_UPPER)
 #define ROTATE_KEY_RIGHT EXPAND_ROTATE_KEY_RIGHT(CPH_TABLENAME_UPPER)
+#define FINGERPRINT_KEY(K) (                                          \
+    (CPHFINGERPRINT)(                                                 \
+        CphFingerprintKey((ULONG)DOWNSIZE_KEY(K)) >>                  \
+        (32 - (sizeof(CPHFINGERPRINT) << 3))                          \
+    )                                                                 \
+)
+
+//
+// 128-bit keys are structures, so the test and benchmark routines derive a
+// value from a key, and compare keys, via the following helper macros.
+//
+
+#ifdef CPH_KEY128
+#define KEY_TO_VALUE(K) ((CPHVALUE)((K).Low ^ (K).High))
+#define KEYS_EQUAL(A, B) ((A).Low == (B).Low && (A).High == (B).High)
+#else
+#define KEY_TO_VALUE(K) ((CPHVALUE)(K))
+#define KEYS_EQUAL(A, B) ((A) == (B))
+#endif
+
+//
+// If the table data is interleaved with the table values, each value resides
+// in the slot of the vertex it is indexed by.
+//
+
+#ifdef CPH_INTERLEAVED_TABLE_DATA
+#define TABLE_VALUE(I) (TABLE_SLOTS[(I)].Value)
+#else
+#define TABLE_VALUE(I) (TABLE_VALUES[(I)])
+#endif
+
+//
+// If the table data is packed, elements are extracted from the bit stream
+// rather than indexed directly.  The batch routines gather eight table data
+// elements at a time via GATHER_TABLE_DATA().
+//
+
+#ifdef CPH_PACKED_TABLE_DATA
+#define UNPACK_TABLE_DATA(I) \
+    CphUnpackTableData(TABLE_DATA, (I), TABLE_DATA_BITS)
+#define GATHER_TABLE_DATA(V) \
+    CphGatherPackedTableData256(TABLE_DATA, (V), TABLE_DATA_BITS)
+#else
+#define GATHER_TABLE_DATA(V) \
+    CphGatherTableData256(TABLE_DATA, (V), sizeof(TABLE_DATA[0]))
+#endif
 
 #define DECLARE_INDEX_ROUTINE_HEADER() EXPAND_INDEX_ROUTINE_HEADER(CPH_TABLENAME)
 #define DECLARE_LOOKUP_ROUTINE_HEADER() EXPAND_LOOKUP_ROUTINE_HEADER(CPH_TABLENAME)
@@ -491,6 +884,9 @@ extern BENCHMARK_INDEX_COMPILED_PERFECT_HASH_TABLE   \
 #define INSERT_INLINE_ROUTINE EXPAND_INSERT_INLINE_ROUTINE(CPH_TABLENAME)
 #define DELETE_INLINE_ROUTINE EXPAND_DELETE_INLINE_ROUTINE(CPH_TABLENAME)
 
+#define HASH_AVX2_ROUTINE EXPAND_HASH_AVX2_ROUTINE(CPH_TABLENAME)
+#define DECLARE_HASH_AVX2_ROUTINE() EXPAND_HASH_AVX2_ROUTINE_HEADER(CPH_TABLENAME)
+
 #define TEST_CPH_ROUTINE EXPAND_TEST_CPH_ROUTINE_NAME(CPH_TABLENAME)
 #define BENCHMARK_FULL_CPH_ROUTINE EXPAND_BENCHMARK_FULL_CPH_ROUTINE_NAME(CPH_TABLENAME)
 #define BENCHMARK_INDEX_CPH_ROUTINE EXPAND_BENCHMARK_INDEX_CPH_ROUTINE_NAME(CPH_TABLENAME)
@@ -500,5 +896,6 @@ extern BENCHMARK_INDEX_COMPILED_PERFECT_HASH_TABLE   \
 #define DECLARE_BENCHMARK_INDEX_CPH_ROUTINE() EXPAND_BENCHMARK_INDEX_CPH_ROUTINE_HEADER(CPH_TABLENAME)
 
 #define DEFINE_TABLE_ROUTINES() EXPAND_DEFINE_TABLE_ROUTINES(CPH_TABLENAME)
+#define DEFINE_STRING_TABLE_ROUTINES() EXPAND_DEFINE_STRING_TABLE_ROUTINES(CPH_TABLENAME)
 #define DEFINE_TEST_AND_BENCHMARKING_ROUTINES() EXPAND_DEFINE_TEST_AND_BENCHMARKING_ROUTINES(CPH_TABLENAME)
 
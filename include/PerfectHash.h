@@ -1709,7 +1709,13 @@ typedef union _PERFECT_HASH_KEYS_LOAD_FLAGS {
         // has beneficial size and performance implications, when detected, the
         // key load operation will implicitly heap-allocate another array and
         // convert all the 64-bit keys into their unique 32-bit equivalent.
-        // When set, this flag disables that behavior.
+        //
+        // Otherwise, if there are no more than 128K keys, a search is made for
+        // a multiply-shift projection of the keys to 32 bits that is injective
+        // over the key set (see ReducedKeys.h), and if one is found, the keys
+        // are projected into a heap-allocated array instead.
+        //
+        // When set, this flag disables both behaviors.
         //
 
         ULONG DisableImplicitKeyDownsizing:1;
@@ -1728,11 +1734,69 @@ typedef union _PERFECT_HASH_KEYS_LOAD_FLAGS {
 
         ULONG TryInferKeySizeFromKeysFilename:1;
 
+        //
+        // When set, indicates the keys file contains variable-length string
+        // keys rather than an array of ULONG or ULONGLONG keys.  Each key is a
+        // little-endian USHORT length followed by that many bytes of string
+        // data; the keys do not need to be sorted.  Each string is reduced to
+        // a unique 32-bit key as part of loading (see StringKeys.h), and the
+        // reduced keys are what the table is created from.  The key size is
+        // always 32-bit (4 bytes) when this flag is set; any key size that is
+        // provided or inferred from the file name is ignored.
+        //
+        // Compiled perfect hash tables created from string keys embed the
+        // string data, and provide IndexString() and TryIndexString()
+        // routines; the latter verifies the string matches the key stored at
+        // its index, rejecting strings that weren't in the original key set.
+        // The TryIndexString() and TryLookupString() table routines do the
+        // same for tables created (or loaded with their keys) via the library.
+        //
+        // As the reduction is random, at most 131,072 string keys are
+        // supported (see REDUCED_KEY_MAXIMUM_NUMBER_OF_KEYS); larger key sets
+        // are rejected with PH_E_TOO_MANY_STRING_KEYS.
+        //
+
+        ULONG StringKeys:1;
+
+        //
+        // When set, the keys file does not need to be sorted, and may contain
+        // duplicate keys.  The keys are sorted via a multi-threaded radix sort
+        // and duplicates are removed as part of loading, prior to the keys
+        // being verified and their stats being gathered.  If the keys data
+        // was loaded into large pages, it is sorted in place; otherwise, the
+        // sorted keys are written to a new array (large pages are tried for
+        // it if TryLargePagesForKeysData is set).  This flag has no effect on
+        // string and 128-bit keys, which are always sorted as part of their
+        // reduction to 32-bit keys.
+        //
+        // N.B. As the sorted key array no longer matches the keys file, this
+        //      flag can't be combined with the OrderPreserving table create
+        //      flag; table creation fails with
+        //      PH_E_ORDER_PRESERVING_NOT_SUPPORTED.
+        //
+
+        ULONG SortKeys:1;
+
+        //
+        // When set, indicates the keys file is a text file with one decimal or
+        // hexadecimal (0x-prefixed) key per line, rather than an array of
+        // ULONG or ULONGLONG keys.  Anything following a comma, space or tab
+        // after a key is ignored, such that the first column of a CSV file can
+        // be used directly.  The keys are parsed in parallel into an array of
+        // the key size (which may be provided or inferred from the file name
+        // as usual, but can't be 128-bit), which is then treated identically
+        // to a binary keys file's array; i.e. it must be sorted and unique
+        // unless SortKeys is also set.  See TextKeys.h for the exact format.
+        // This flag can't be combined with StringKeys.
+        //
+
+        ULONG TextKeys:1;
+
         //
         // Unused bits.
         //
 
-        ULONG Unused:28;
+        ULONG Unused:25;
     };
 
     LONG AsLong;
@@ -1798,11 +1862,53 @@ typedef union _PERFECT_HASH_KEYS_FLAGS {
 
         ULONG DownsizingOccurred:1;
 
+        //
+        // When set, indicates the keys were loaded from a string keys file and
+        // have been reduced to 32-bit keys.  See the StringKeys comment in the
+        // key load flags for more information.
+        //
+
+        ULONG StringKeys:1;
+
+        //
+        // When set, indicates the keys were loaded from a 128-bit keys file
+        // (i.e. a key size of 16 bytes, such as UUIDs or GUIDs), and have been
+        // reduced to 32-bit keys.  This is a capped reduced-key mode: at most
+        // 131,072 keys are supported (larger key sets are rejected with
+        // PH_E_TOO_MANY_KEYS128), and the table's library routines take the
+        // reduced 32-bit keys.
+        //
+
+        ULONG Keys128:1;
+
+        //
+        // When set, indicates that key downsizing has occurred via a
+        // multiply-shift projection rather than parallel bit extraction.  If
+        // this bit is set, DownsizingOccurred will also be set.
+        //
+
+        ULONG ProjectionOccurred:1;
+
+        //
+        // When set, indicates the keys were sorted and deduplicated as part of
+        // loading.  See the SortKeys comment in the key load flags for more
+        // information.
+        //
+
+        ULONG KeysSorted:1;
+
+        //
+        // When set, indicates the keys were decoded from a compressed keys file
+        // (see the CompressKeys create flag).
+        //
+
+        ULONG KeysCompressed:1;
+
         //
         // Unused bits.
         //
 
-        ULONG Unused:29;
+        ULONG Unused:24;
     };
 
     LONG AsLong;
@@ -1871,7 +1977,10 @@ typedef PERFECT_HASH_KEYS *PPERFECT_HASH_KEYS;
 //
 
 #define PERFECT_HASH_ALGORITHM_TABLE(FIRST_ENTRY, ENTRY, LAST_ENTRY) \
-    FIRST_ENTRY(Chm01, CHM01)
+    FIRST_ENTRY(Chm01, CHM01)                                        \
+    ENTRY(Bdz01, BDZ01)                                              \
+    ENTRY(Shard01, SHARD01)                                          \
+    LAST_ENTRY(Block01, BLOCK01)
 
 #define PERFECT_HASH_ALGORITHM_TABLE_ENTRY(ENTRY) \
     PERFECT_HASH_ALGORITHM_TABLE(ENTRY, ENTRY, ENTRY)
@@ -2154,12 +2263,20 @@ typedef const SEED_MASK_COUNTS *PCSEED_MASK_COUNTS;
 // tables, which will be larger, but the resulting mask function can be done
 // by logical AND instructions, which are fast.
 //
+// MultiplyHigh masking reduces each 32-bit hash into the number of vertices
+// via a multiply-high (i.e. ((ULONGLONG)Hash * Size) >> 32), and reduces the
+// final index into the number of keys via a conditional subtraction.  Neither
+// size needs to be a power of 2, so the table data and values arrays are
+// sized much closer to the number of keys, at the cost of a multiply per
+// vertex.  It is only supported by the Chm01 algorithm with graph impl 3.
+//
 // N.B. Modulus masking does not work.
 //
 
 #define PERFECT_HASH_MASK_FUNCTION_TABLE(FIRST_ENTRY, ENTRY, LAST_ENTRY) \
     FIRST_ENTRY(Modulus, MODULUS)                                        \
-    LAST_ENTRY(And, AND)
+    ENTRY(And, AND)                                                      \
+    LAST_ENTRY(MultiplyHigh, MULTIPLY_HIGH)
 
 #define PERFECT_HASH_MASK_FUNCTION_TABLE_ENTRY(ENTRY) \
     PERFECT_HASH_MASK_FUNCTION_TABLE(ENTRY, ENTRY, ENTRY)
@@ -2219,6 +2336,21 @@ IsModulusMasking(
     return MaskFunctionId == PerfectHashModulusMaskFunctionId;
 }
 
+//
+// Multiply-high masking is the only working masking type that supports table
+// sizes that aren't a power of 2.  Provide a helper routine for identifying
+// it.
+//
+
+FORCEINLINE
+BOOLEAN
+IsMultiplyHighMasking(
+    _In_ PERFECT_HASH_MASK_FUNCTION_ID MaskFunctionId
+    )
+{
+    return MaskFunctionId == PerfectHashMultiplyHighMaskFunctionId;
+}
+
 //
 // Define the PERFECT_HASH_CONTEXT interface.  This interface is responsible for
 // encapsulating threadpool resources and allows perfect hash table solutions to
@@ -2336,11 +2468,18 @@ typedef union _PERFECT_HASH_CONTEXT_BULK_CREATE_FLAGS {
 
         ULONG TryCuda:1;
 
+        //
+        // When set, a compressed copy of the keys is written to the output
+        // directory instead of creating a table.  See CompressedKeys.h.
+        //
+
+        ULONG CompressKeys:1;
+
         //
         // Unused bits.
         //
 
-        ULONG Unused:29;
+        ULONG Unused:28;
     };
 
     LONG AsLong;
@@ -2402,11 +2541,18 @@ typedef union _PERFECT_HASH_CONTEXT_TABLE_CREATE_FLAGS {
 
         ULONG TryCuda:1;
 
+        //
+        // When set, a compressed copy of the keys is written to the output
+        // directory instead of creating a table.  See CompressedKeys.h.
+        //
+
+        ULONG CompressKeys:1;
+
         //
         // Unused bits.
         //
 
-        ULONG Unused:29;
+        ULONG Unused:28;
     };
 
     LONG AsLong;
@@ -2724,10 +2870,68 @@ typedef union _PERFECT_HASH_TABLE_CREATE_FLAGS {
         ULONG RngUseRandomStartSeed:1;
 
         //
-        // Unused bits.
+        // When set, each pass over the keys hashes them against multiple,
+        // independent seed sets at once (one seed set per pair of SIMD lanes),
+        // producing a separate vertex pairs array for each seed set.  The
+        // subsequent solving attempts consume the pre-hashed vertex pairs
+        // instead of re-reading the keys.
         //
+        // N.B. Requires HashAllKeysFirst.  Incompatible with
+        //      EnableWriteCombineForVertexPairs.  Only applies to graph
+        //      implementation 3 and hash functions with a multi-seed routine
+        //      (see GetSeededHashExMultiSeedRoutine()); it is silently ignored
+        //      otherwise.
+        //
+
+        ULONG HashKeysWithMultipleSeedSets:1;
 
-        ULONG Unused:4;
+        //
+        // When set, graph implementation 3 hashes all keys first, then radix-
+        // buckets the resulting vertex updates by the high bits of each vertex
+        // into cache-sized partitions prior to applying them to the graph's
+        // vertices.  This trades one sequential scatter pass for the random
+        // read-modify-writes that would otherwise miss the cache for every
+        // vertex of every key once the graph's vertices exceed the cache size.
+        //
+        // N.B. Requires an additional 16 bytes per key for the partitioned
+        //      vertex updates.  Has no effect on small graphs (i.e. where the
+        //      vertices already fit in a single partition).
+        //
+
+        ULONG CachePartitionedAddKeys:1;
+
+        //
+        // When set, graph implementation 3 peels large graphs in parallel.
+        // Peeling proceeds in rounds, where each round removes the edges of
+        // all vertices of degree 1 (the frontier), using atomic updates of
+        // each vertex's degree and XOR'd edges.  Other solving threads join
+        // the peeling job between their own solving attempts, which helps
+        // when a single huge graph dominates the solving time.
+        //
+        // N.B. Has no effect on graphs below GRAPH_PARALLEL_PEEL_MIN_KEYS.
+        //
+
+        ULONG ParallelPeeling:1;
+
+        //
+        // When set, guarantees the index of each key is its position in the
+        // keys file, i.e. Index(Keys[i]) == i.  This allows the index to be
+        // used directly as a row number into existing arrays keyed by load
+        // order, without an intermediate remapping.  Graph verification will
+        // fail if any key resolves to a different index, the flag is recorded
+        // in the on-disk table info, and the compiled perfect hash table
+        // will define the C preprocessor macro CPH_ORDER_PRESERVING.
+        //
+        // N.B. Combine with --IndexOnly to omit the table values array from
+        //      the compiled perfect hash table entirely.
+        //
+        // N.B. Not supported by the Shard01 algorithm or the interleaved
+        //      table data layout, as neither assign indices by key position,
+        //      nor when the keys were loaded with the SortKeys flag, as the
+        //      key array no longer matches the keys file.
+        //
+
+        ULONG OrderPreserving:1;
     };
 
     LONG AsLong;
@@ -2748,10 +2952,6 @@ IsValidTableCreateFlags(
         return PH_E_INVALID_TABLE_CREATE_FLAGS;
     }
 
-    if (TableCreateFlags->Unused != 0) {
-        return PH_E_INVALID_TABLE_CREATE_FLAGS;
-    }
-
     if (TableCreateFlags->UseOriginalSeededHashRoutines &&
         TableCreateFlags->HashAllKeysFirst) {
         return PH_E_HASH_ALL_KEYS_FIRST_INCOMPAT_WITH_ORIG_SEEDED_HASH_ROUTINES;
@@ -2767,10 +2967,22 @@ IsValidTableCreateFlags(
 
         if (TableCreateFlags->TryLargePagesForVertexPairs ||
             TableCreateFlags->EnableWriteCombineForVertexPairs ||
-            TableCreateFlags->RemoveWriteCombineAfterSuccessfulHashKeys) {
+            TableCreateFlags->RemoveWriteCombineAfterSuccessfulHashKeys ||
+            TableCreateFlags->HashKeysWithMultipleSeedSets) {
             return PH_E_VERTEX_PAIR_FLAGS_REQUIRE_HASH_ALL_KEYS_FIRST;
         }
 
+    } else if (TableCreateFlags->HashKeysWithMultipleSeedSets &&
+               TableCreateFlags->EnableWriteCombineForVertexPairs) {
+
+        //
+        // The vertex pairs arrays for each seed set are packed back-to-back
+        // in a single allocation, so page protection can't be toggled on a
+        // per-array basis.
+        //
+
+        return PH_E_CANT_WRITE_COMBINE_VERTEX_PAIRS_WITH_MULTIPLE_SEED_SETS;
+
     } else if (TableCreateFlags->TryLargePagesForVertexPairs) {
 
         //
@@ -3111,6 +3323,8 @@ typedef RNG_VTBL *PRNG_VTBL;
     ENTRY(Seeds)                                                     \
     ENTRY(ValueSizeInBytes)                                          \
     ENTRY(KeySizeInBytes)                                            \
+    ENTRY(FingerprintSizeInBytes)                                    \
+    ENTRY(TableDataLayout)                                           \
     ENTRY(CuDeviceOrdinal)                                           \
     ENTRY(CuDeviceOrdinals)                                          \
     ENTRY(SolutionsFoundRatio)                                       \
@@ -3266,6 +3480,50 @@ DoesBestCoverageTypeRequireKeysSubset(
     );
 }
 
+//
+// Define an X-macro for the table data layouts.  The default Separate layout
+// stores the table data (assigned) array and the values array as distinct
+// arrays, such that a lookup touches the two table data elements indexed by
+// the vertices of the key, then the value element indexed by the result.  The
+// Interleaved layout stores each value beside the table data element of the
+// vertex it is indexed by, such that a lookup only touches the two table data
+// elements (and thus at most two cache lines).  The Packed layout stores each
+// table data element in the minimum number of bits required to represent the
+// number of edges, rather than the smallest containing C type, such that more
+// of the table data fits in the cache.
+//
+
+#define TABLE_DATA_LAYOUT_TABLE(FIRST_ENTRY, ENTRY, LAST_ENTRY) \
+    FIRST_ENTRY(Separate)                                       \
+    ENTRY(Interleaved)                                          \
+    LAST_ENTRY(Packed)
+
+#define TABLE_DATA_LAYOUT_TABLE_ENTRY(ENTRY) \
+    TABLE_DATA_LAYOUT_TABLE(ENTRY, ENTRY, ENTRY)
+
+#define EXPAND_AS_TABLE_DATA_LAYOUT_ENUM(Name) \
+    TableDataLayout##Name##Id,
+
+typedef enum _PERFECT_HASH_TABLE_DATA_LAYOUT_ID {
+    TableDataLayoutNullId = 0,
+
+    TABLE_DATA_LAYOUT_TABLE_ENTRY(EXPAND_AS_TABLE_DATA_LAYOUT_ENUM)
+
+    TableDataLayoutInvalidId,
+} PERFECT_HASH_TABLE_DATA_LAYOUT_ID;
+
+FORCEINLINE
+BOOLEAN
+IsValidPerfectHashTableDataLayoutId(
+    _In_ PERFECT_HASH_TABLE_DATA_LAYOUT_ID TableDataLayoutId
+    )
+{
+    return (
+        TableDataLayoutId > TableDataLayoutNullId &&
+        TableDataLayoutId < TableDataLayoutInvalidId
+    );
+}
+
 FORCEINLINE
 BOOLEAN
 IsSeedMaskCountParameter(
@@ -3333,6 +3591,7 @@ typedef struct _PERFECT_HASH_TABLE_CREATE_PARAMETER {
         TP_CALLBACK_PRIORITY AsTpCallbackPriority;
         PERFECT_HASH_RNG_ID AsRngId;
         PERFECT_HASH_TABLE_BEST_COVERAGE_TYPE_ID AsBestCoverageType;
+        PERFECT_HASH_TABLE_DATA_LAYOUT_ID AsTableDataLayoutId;
         VALUE_ARRAY AsValueArray;
         KEYS_SUBSET AsKeysSubset;
         SEED_MASK_COUNTS AsSeedMaskCounts;
@@ -3772,6 +4031,111 @@ HRESULT
     );
 typedef PERFECT_HASH_TABLE_INDEX *PPERFECT_HASH_TABLE_INDEX;
 
+//
+// Batch versions of the Index(), Lookup() and Insert() routines.  These take
+// an array of keys and use group prefetching to overlap the cache misses of
+// independent keys: a group of keys is hashed and the table data slots for
+// each key are prefetched, then the group's indices are resolved (and, for
+// lookup and insertion, the values slots prefetched prior to being accessed).
+// The routines return S_OK if every key resolved successfully, or E_FAIL if
+// one or more keys failed, in which case the failing keys are handled as per
+// their scalar counterparts.
+//
+
+typedef
+HRESULT
+(STDAPICALLTYPE PERFECT_HASH_TABLE_INDEX_BATCH)(
+    _In_ PPERFECT_HASH_TABLE Table,
+    _In_ ULONG NumberOfKeys,
+    _In_reads_(NumberOfKeys) PULONG Keys,
+    _Out_writes_(NumberOfKeys) PULONG Indices
+    );
+typedef PERFECT_HASH_TABLE_INDEX_BATCH *PPERFECT_HASH_TABLE_INDEX_BATCH;
+
+typedef
+HRESULT
+(STDAPICALLTYPE PERFECT_HASH_TABLE_LOOKUP_BATCH)(
+    _In_ PPERFECT_HASH_TABLE Table,
+    _In_ ULONG NumberOfKeys,
+    _In_reads_(NumberOfKeys) PULONG Keys,
+    _Out_writes_(NumberOfKeys) PULONG Values
+    );
+typedef PERFECT_HASH_TABLE_LOOKUP_BATCH *PPERFECT_HASH_TABLE_LOOKUP_BATCH;
+
+typedef
+HRESULT
+(STDAPICALLTYPE PERFECT_HASH_TABLE_INSERT_BATCH)(
+    _In_ PPERFECT_HASH_TABLE Table,
+    _In_ ULONG NumberOfKeys,
+    _In_reads_(NumberOfKeys) PULONG Keys,
+    _In_reads_(NumberOfKeys) PULONG Values,
+    _Out_writes_opt_(NumberOfKeys) PULONG PreviousValues
+    );
+typedef PERFECT_HASH_TABLE_INSERT_BATCH *PPERFECT_HASH_TABLE_INSERT_BATCH;
+
+//
+// Membership routines.  These are only available for tables created with the
+// --FingerprintSizeInBytes parameter, which stores a small fingerprint of each
+// key at the key's index.  Contains() and TryLookup() compare the fingerprint
+// of the given key against the one stored at its index, returning S_OK if they
+// match, or S_FALSE if they don't (in which case the key definitely did not
+// appear in the original key set).  A key that did not appear in the key set
+// will be reported as a false positive with a probability of 1/256 for 1-byte
+// fingerprints, or 1/65536 for 2-byte fingerprints.  If the table was created
+// without fingerprints, PH_E_TABLE_HAS_NO_FINGERPRINTS is returned.
+//
+
+typedef
+HRESULT
+(STDAPICALLTYPE PERFECT_HASH_TABLE_CONTAINS)(
+    _In_ PPERFECT_HASH_TABLE Table,
+    _In_ ULONG Key
+    );
+typedef PERFECT_HASH_TABLE_CONTAINS *PPERFECT_HASH_TABLE_CONTAINS;
+
+typedef
+HRESULT
+(STDAPICALLTYPE PERFECT_HASH_TABLE_TRY_LOOKUP)(
+    _In_ PPERFECT_HASH_TABLE Table,
+    _In_ ULONG Key,
+    _Out_ PULONG Value
+    );
+typedef PERFECT_HASH_TABLE_TRY_LOOKUP *PPERFECT_HASH_TABLE_TRY_LOOKUP;
+
+//
+// String key routines.  These are only available for tables created from
+// string keys (see the StringKeys keys load flag), or loaded with the string
+// keys they were created from.  The string is reduced to its 32-bit key, the
+// key's index is obtained, and the string is then compared against the string
+// stored at that index.  The comparison is exact: S_OK is returned if the
+// string was in the keys file, S_FALSE otherwise.  As string key tables are
+// order preserving, the index of a string is the offset of its reduced key in
+// the key array (which is sorted by reduced key, not file order).  If string
+// keys aren't available, PH_E_TABLE_HAS_NO_STRING_KEYS is returned.
+//
+
+typedef
+HRESULT
+(STDAPICALLTYPE PERFECT_HASH_TABLE_TRY_INDEX_STRING)(
+    _In_ PPERFECT_HASH_TABLE Table,
+    _In_reads_bytes_(Length) PBYTE String,
+    _In_ ULONG Length,
+    _Out_ PULONG Index
+    );
+typedef PERFECT_HASH_TABLE_TRY_INDEX_STRING
+      *PPERFECT_HASH_TABLE_TRY_INDEX_STRING;
+
+typedef
+HRESULT
+(STDAPICALLTYPE PERFECT_HASH_TABLE_TRY_LOOKUP_STRING)(
+    _In_ PPERFECT_HASH_TABLE Table,
+    _In_reads_bytes_(Length) PBYTE String,
+    _In_ ULONG Length,
+    _Out_ PULONG Value
+    );
+typedef PERFECT_HASH_TABLE_TRY_LOOKUP_STRING
+      *PPERFECT_HASH_TABLE_TRY_LOOKUP_STRING;
+
 typedef
 HRESULT
 (STDAPICALLTYPE PERFECT_HASH_TABLE_HASH)(
@@ -3889,6 +4253,13 @@ typedef struct _PERFECT_HASH_TABLE_VTBL {
     PPERFECT_HASH_TABLE_GET_FILE GetFile;
     PPERFECT_HASH_TABLE_HASH_EX HashEx;
     PPERFECT_HASH_TABLE_SEEDED_HASH_EX SeededHashEx;
+    PPERFECT_HASH_TABLE_INDEX_BATCH IndexBatch;
+    PPERFECT_HASH_TABLE_LOOKUP_BATCH LookupBatch;
+    PPERFECT_HASH_TABLE_INSERT_BATCH InsertBatch;
+    PPERFECT_HASH_TABLE_CONTAINS Contains;
+    PPERFECT_HASH_TABLE_TRY_LOOKUP TryLookup;
+    PPERFECT_HASH_TABLE_TRY_INDEX_STRING TryIndexString;
+    PPERFECT_HASH_TABLE_TRY_LOOKUP_STRING TryLookupString;
 } PERFECT_HASH_TABLE_VTBL;
 typedef PERFECT_HASH_TABLE_VTBL *PPERFECT_HASH_TABLE_VTBL;
 
@@ -153,6 +153,15 @@ Abstract:
 //
 #define PH_S_MAX_ATTEMPTS_REACHED        ((HRESULT)0x2004000AL)
 
+//
+// MessageId: PH_S_NO_KEY_PROJECTION_FOUND
+//
+// MessageText:
+//
+// No injective 32-bit projection of the 64-bit keys was found.
+//
+#define PH_S_NO_KEY_PROJECTION_FOUND     ((HRESULT)0x2004000BL)
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // PH_SEVERITY_INFORMATIONAL
@@ -244,6 +253,9 @@ Abstract:
 // 
 //    ID | Name
 //     1   Chm01
+//     2   Bdz01
+//     3   Shard01
+//     4   Block01
 // 
 // Hash Functions:
 // 
@@ -275,6 +287,7 @@ Abstract:
 //   ID | Name
 //    1   Modulus (does not work!)
 //    2   And
+//    3   MultiplyHigh
 // 
 //
 #define PH_MSG_PERFECT_HASH_ALGO_HASH_MASK_NAMES ((HRESULT)0x60040100L)
@@ -317,6 +330,16 @@ Abstract:
 //              to work.  (The current error message if this isn't the case is
 //              quite cryptic.)
 // 
+//     --CompressKeys
+// 
+//         Instead of creating a table, writes a compressed copy of the keys file
+//         to the output directory, under the same file name.  Sorted keys are
+//         delta-encoded and bit-packed in blocks, which typically shrinks large
+//         key sets several-fold.  Compressed keys files are detected when loaded,
+//         and their blocks are decoded in parallel, so they can be used in place
+//         of the original keys file.  The keys must be 32-bit or 64-bit; combine
+//         with --SortKeys and/or --TextKeys to convert unsorted or text keys.
+// 
 // Keys Load Flags:
 // 
 //     --TryLargePagesForKeysData
@@ -340,15 +363,56 @@ Abstract:
 //         bit extraction logic (i.e. _pext_u64()).  As this has beneficial size
 //         and performance implications, when detected, the key load operation will
 //         implicitly heap-allocate another array and convert all the 64-bit keys
-//         into their unique 32-bit equivalent.  Specifying this flag will disable
-//         this behavior.
+//         into their unique 32-bit equivalent.  Otherwise, if there are no more
+//         than 128K keys, a search is made for a multiply-shift projection of the
+//         keys to 32 bits that is injective over the key set, and if one is found,
+//         the keys are projected instead.  Specifying this flag will disable both
+//         behaviors.
 // 
 //     --TryInferKeySizeFromKeysFilename
 // 
 //         The default key size is 32-bit (4 bytes).  When this flag is present,
 //         if the keys file name ends with "64.keys" (e.g. "foo64.keys"), the key
-//         size will be interpreted as 64-bit (8 bytes).  This flag takes
-//         precedence over the table create parameter --KeySizeInBytes.
+//         size will be interpreted as 64-bit (8 bytes).  If it ends with
+//         "128.keys", the key size will be interpreted as 128-bit (16 bytes),
+//         e.g. for UUIDs.  128-bit keys are a capped reduced-key mode: each key
+//         is reduced to a unique 32-bit key, which the table is created from,
+//         and keys files with more than 131,072 keys are rejected (the same cap
+//         as --StringKeys).  This flag takes precedence over the table create
+//         parameter --KeySizeInBytes.
+// 
+//     --StringKeys
+// 
+//         Interprets the keys file as variable-length string keys: each key is a
+//         little-endian 16-bit length followed by that many bytes.  The strings
+//         are reduced to unique 32-bit keys, which the table is created from.
+//         Compiled tables embed the strings and provide IndexString() and
+//         TryIndexString() routines; the latter rejects strings that weren't in
+//         the keys file.  The library provides the equivalent TryIndexString()
+//         and TryLookupString() table routines; a loaded table requires its
+//         string keys to be passed to Load() for these to be available.
+//         Implies --OrderPreserving.  As each string is reduced to a random
+//         32-bit key, keys files with more than 131,072 strings are rejected.
+// 
+//     --SortKeys
+// 
+//         Accepts keys files that are not sorted and/or contain duplicate keys.
+//         The keys are sorted via a multi-threaded radix sort, and duplicates
+//         removed, as part of loading.  Has no effect on string or 128-bit keys.
+// 
+//         N.B. As the key array no longer matches the keys file, this can't be
+//              combined with --OrderPreserving (including when combined with
+//              --TextKeys).
+// 
+//     --TextKeys
+// 
+//         Interprets the keys file as text with one decimal or hexadecimal (0x
+//         prefixed) key per line, rather than an array of binary keys.  Anything
+//         following a comma, space or tab after a key is ignored, so the first
+//         column of a CSV file can be used directly.  Blank lines, lines starting
+//         with #, and a leading header line are skipped.  The keys are parsed in
+//         parallel into 32-bit or 64-bit keys per the key size.  Combine with
+//         --SortKeys if the keys are not sorted and unique.
 // 
 // Table Create Flags:
 // 
@@ -508,6 +572,53 @@ Abstract:
 //         N.B. Only applies when HashAllKeysFirst is set.  Incompatible with
 //              EnableWriteCombineForVertexPairs.
 // 
+//     --HashKeysWithMultipleSeedSets
+// 
+//         When set, each pass over the keys hashes them against multiple,
+//         independent seed sets at once (4 with AVX2, 8 with AVX-512), writing
+//         a separate vertex pairs array for each seed set.  Subsequent solving
+//         attempts consume the pre-hashed vertex pairs instead of re-reading
+//         the keys, which helps when the keys don't fit in cache.
+// 
+//         N.B. Only applies when --HashAllKeysFirst is set and graph impl 3 is
+//              active.  Incompatible with --EnableWriteCombineForVertexPairs.
+// 
+//     --CachePartitionedAddKeys
+// 
+//         When set, graph implementation 3 hashes all keys first, then radix-
+//         buckets the resulting vertex updates by the high bits of each vertex
+//         into cache-sized partitions prior to applying them to the graph.
+//         This avoids two cache misses per key when adding keys to very large
+//         graphs.  The partitioning time is reported separately via the
+//         PartitionHashedKeys counters.
+// 
+//         N.B. Requires an additional 16 bytes per key.  Has no effect on small
+//              graphs (i.e. where the vertices fit in a single partition).
+// 
+//     --ParallelPeeling
+// 
+//         When set, graph implementation 3 peels very large graphs in parallel
+//         rounds: each round removes the edges of all vertices of degree 1, and
+//         is split into chunks that are claimed by the owning thread as well as
+//         any other solving threads that join the peeling job.  The resulting
+//         deletion order is equivalent (but not identical) to that of serial
+//         peeling.
+// 
+//         N.B. Requires an additional 8 bytes per vertex.  Has no effect on
+//              graphs with fewer than 1,048,576 keys.
+// 
+//     --OrderPreserving
+// 
+//         When set, guarantees the index of each key is its position in the keys
+//         file, i.e. Index(Keys[i]) == i, such that the index can be used as a
+//         row number into existing arrays ordered by the keys file.  Graph
+//         verification fails if any key resolves to a different index.  Combine
+//         with --IndexOnly to omit the table values array entirely.
+// 
+//         N.B. Not supported by the Shard01 algorithm, when
+//              --TableDataLayout=Interleaved is specified, or when the keys are
+//              loaded with --SortKeys.
+// 
 //     --UsePreviousTableSize
 // 
 //         When set, uses any previously-recorded table sizes associated with
@@ -615,6 +726,35 @@ Abstract:
 //         Sets the size, in bytes, of the value element that will be stored in the
 //         compiled perfect hash table via Insert().  Defaults to 4 bytes (ULONG).
 // 
+//     --FingerprintSizeInBytes=1|2
+// 
+//         When set, a fingerprint of each key (1 or 2 bytes in size) is stored
+//         alongside the table data, allowing the Contains() and TryLookup()
+//         routines to detect keys that weren't in the original key set.  Keys
+//         not in the set will be reported as present with a probability of
+//         1/256 for 1-byte fingerprints, and 1/65536 for 2-byte fingerprints.
+//         Incompatible with --SkipGraphVerification.
+// 
+//     --TableDataLayout=Separate|Interleaved|Packed [default: Separate]
+// 
+//         When set to Interleaved, each value is stored alongside the table data
+//         element of the vertex it is indexed by, such that a lookup touches at
+//         most two cache lines instead of three.  Requires --GraphImpl=3, the
+//         Chm01 algorithm, the And mask function, and one of the Crc32RotateX,
+//         MultiplyShiftR, RotateMultiplyXorRotate or ShiftMultiplyXorShift hash
+//         functions.  Incompatible with --IndexOnly.  The average number of cache
+//         lines touched per lookup is captured in the CacheLinesPerLookup column
+//         of the .csv output.
+// 
+//         When set to Packed, each table data element is stored in the minimum
+//         number of bits required to represent the number of edges (e.g. 17 bits
+//         instead of 32 for 2^17 edges), rather than the smallest containing C
+//         type, such that more of the table data fits in the cache.  Elements
+//         are extracted with a shift and mask (BEXTR in compiled tables when BMI
+//         is available), and the compiled AVX2 batch lookup routines unpack
+//         eight elements at a time.  Requires the Chm01 algorithm, the And
+//         mask function, and one of the hash functions listed above.
+// 
 //     --MainWorkThreadpoolPriority=<High|Normal|Low> [default: Normal]
 //     --FileWorkThreadpoolPriority=<High|Normal|Low> [default: Normal]
 // 
@@ -635,10 +775,11 @@ Abstract:
 // 
 //         Initial number of table resizes to simulate before attempting graph
 //         solving.  Each table resize doubles the number of vertices used to
-//         solve the graph, which lowers the keys-to-vertices ratio, which will
-//         improve graph solving probability.
+//         solve the graph (or grows them by 1/8th for MultiplyHigh masking),
+//         which lowers the keys-to-vertices ratio, which will improve graph
+//         solving probability.
 // 
-//         N.B. This parameter is only valid for And masking, not Modulus masking.
+//         N.B. This parameter is not valid for Modulus masking.
 // 
 //     --BestCoverageAttempts=N
 // 
@@ -3924,3 +4065,192 @@ Abstract:
 //
 #define PH_E_TARGET_NUMBER_OF_SOLUTIONS_EXCEEDS_MIN_ATTEMPTS ((HRESULT)0xE00403D0L)
 
+//
+// MessageId: PH_E_CANT_WRITE_COMBINE_VERTEX_PAIRS_WITH_MULTIPLE_SEED_SETS
+//
+// MessageText:
+//
+// --EnableWriteCombineForVertexPairs conflicts with --HashKeysWithMultipleSeedSets.
+//
+#define PH_E_CANT_WRITE_COMBINE_VERTEX_PAIRS_WITH_MULTIPLE_SEED_SETS ((HRESULT)0xE00403D1L)
+
+//
+// MessageId: PH_E_INVALID_FINGERPRINT_SIZE_IN_BYTES_PARAMETER
+//
+// MessageText:
+//
+// Invalid --FingerprintSizeInBytes parameter value; must be 1 or 2.
+//
+#define PH_E_INVALID_FINGERPRINT_SIZE_IN_BYTES_PARAMETER ((HRESULT)0xE00403D2L)
+
+//
+// MessageId: PH_E_FINGERPRINTS_REQUIRE_GRAPH_VERIFICATION
+//
+// MessageText:
+//
+// --FingerprintSizeInBytes conflicts with --SkipGraphVerification.
+//
+#define PH_E_FINGERPRINTS_REQUIRE_GRAPH_VERIFICATION ((HRESULT)0xE00403D3L)
+
+//
+// MessageId: PH_E_TABLE_HAS_NO_FINGERPRINTS
+//
+// MessageText:
+//
+// Table was not created with --FingerprintSizeInBytes.
+//
+#define PH_E_TABLE_HAS_NO_FINGERPRINTS ((HRESULT)0xE00403D4L)
+
+//
+// MessageId: PH_E_INVALID_TABLE_DATA_LAYOUT
+//
+// MessageText:
+//
+// Invalid --TableDataLayout; must be Separate, Interleaved or Packed.
+//
+#define PH_E_INVALID_TABLE_DATA_LAYOUT ((HRESULT)0xE00403D5L)
+
+//
+// MessageId: PH_E_TABLE_DATA_LAYOUT_NOT_SUPPORTED
+//
+// MessageText:
+//
+// --TableDataLayout=Interleaved requires Chm01, And masking, --GraphImpl=3 and no --IndexOnly.
+//
+#define PH_E_TABLE_DATA_LAYOUT_NOT_SUPPORTED ((HRESULT)0xE00403D6L)
+
+//
+// MessageId: PH_E_ORDER_PRESERVING_NOT_SUPPORTED
+//
+// MessageText:
+//
+// --OrderPreserving is not supported by Shard01, --TableDataLayout=Interleaved or --SortKeys.
+//
+#define PH_E_ORDER_PRESERVING_NOT_SUPPORTED ((HRESULT)0xE00403D7L)
+
+//
+// MessageId: PH_E_INDEX_NOT_ORDER_PRESERVING_DURING_GRAPH_VERIFICATION
+//
+// MessageText:
+//
+// A key's index did not equal its position in the keys array during graph verification of an --OrderPreserving table.
+//
+#define PH_E_INDEX_NOT_ORDER_PRESERVING_DURING_GRAPH_VERIFICATION ((HRESULT)0xE00403D8L)
+
+//
+// MessageId: PH_E_PACKED_TABLE_DATA_LAYOUT_NOT_SUPPORTED
+//
+// MessageText:
+//
+// --TableDataLayout=Packed requires Chm01 and And masking.
+//
+#define PH_E_PACKED_TABLE_DATA_LAYOUT_NOT_SUPPORTED ((HRESULT)0xE00403D9L)
+
+//
+// MessageId: PH_E_INVALID_STRING_KEYS_FILE
+//
+// MessageText:
+//
+// Invalid string keys file.  A string key's length prefix extends beyond the end of the file, or the file contains no keys.
+//
+#define PH_E_INVALID_STRING_KEYS_FILE ((HRESULT)0xE00403DAL)
+
+//
+// MessageId: PH_E_STRING_KEYS_HASH_COLLISIONS
+//
+// MessageText:
+//
+// Unable to find a string key seed that reduces every string key to a unique 32-bit key.
+//
+#define PH_E_STRING_KEYS_HASH_COLLISIONS ((HRESULT)0xE00403DBL)
+
+//
+// MessageId: PH_E_KEYS128_HASH_COLLISIONS
+//
+// MessageText:
+//
+// Unable to find a key seed that reduces every 128-bit key to a unique 32-bit key.
+//
+#define PH_E_KEYS128_HASH_COLLISIONS ((HRESULT)0xE00403DCL)
+
+//
+// MessageId: PH_E_INVALID_TEXT_KEYS_FILE
+//
+// MessageText:
+//
+// Invalid text keys file.  A line does not begin with a valid decimal or hexadecimal key, a key is not followed by the end of the line or a field separator, or the file contains no keys.
+//
+#define PH_E_INVALID_TEXT_KEYS_FILE ((HRESULT)0xE00403DDL)
+
+//
+// MessageId: PH_E_TEXT_KEY_EXCEEDS_KEY_SIZE
+//
+// MessageText:
+//
+// A key in the text keys file is too large for the key size.
+//
+#define PH_E_TEXT_KEY_EXCEEDS_KEY_SIZE ((HRESULT)0xE00403DEL)
+
+//
+// MessageId: PH_E_INVALID_COMPRESSED_KEYS_FILE
+//
+// MessageText:
+//
+// Invalid compressed keys file.
+//
+#define PH_E_INVALID_COMPRESSED_KEYS_FILE ((HRESULT)0xE00403DFL)
+
+//
+// MessageId: PH_E_KEYS_NOT_COMPRESSIBLE
+//
+// MessageText:
+//
+// String keys and 128-bit keys cannot be compressed.
+//
+#define PH_E_KEYS_NOT_COMPRESSIBLE ((HRESULT)0xE00403E0L)
+
+//
+// MessageId: PH_E_COMPRESSED_KEYS_PATH_IS_KEYS_PATH
+//
+// MessageText:
+//
+// The compressed keys file would overwrite the keys file; specify a different output directory.
+//
+#define PH_E_COMPRESSED_KEYS_PATH_IS_KEYS_PATH ((HRESULT)0xE00403E1L)
+
+//
+// MessageId: PH_E_TOO_MANY_STRING_KEYS
+//
+// MessageText:
+//
+// Too many string keys; at most 131,072 string keys are supported.
+//
+#define PH_E_TOO_MANY_STRING_KEYS ((HRESULT)0xE00403E2L)
+
+//
+// MessageId: PH_E_TABLE_HAS_NO_STRING_KEYS
+//
+// MessageText:
+//
+// Table was not created from string keys, or was loaded without its string keys.
+//
+#define PH_E_TABLE_HAS_NO_STRING_KEYS ((HRESULT)0xE00403E3L)
+
+//
+// MessageId: PH_E_STRING_KEYS_MISMATCH_BETWEEN_HEADER_AND_KEYS
+//
+// MessageText:
+//
+// The keys provided to Load() are not the string keys the table was created from.
+//
+#define PH_E_STRING_KEYS_MISMATCH_BETWEEN_HEADER_AND_KEYS ((HRESULT)0xE00403E4L)
+
+//
+// MessageId: PH_E_TOO_MANY_KEYS128
+//
+// MessageText:
+//
+// Too many 128-bit keys; at most 131,072 128-bit keys are supported.
+//
+#define PH_E_TOO_MANY_KEYS128 ((HRESULT)0xE00403E5L)
+
@@ -76,9 +76,17 @@ KEYS_SLIM_1 = [
     'AddKeysElapsedCycles',
     'HashKeysElapsedCycles',
     'AddHashedKeysElapsedCycles',
+    'PartitionHashedKeysElapsedCycles',
+    'AssignElapsedCycles',
+    'AssignGatherElapsedCycles',
+    'AssignWalkElapsedCycles',
     'AddKeysElapsedMicroseconds',
     'HashKeysElapsedMicroseconds',
     'AddHashedKeysElapsedMicroseconds',
+    'PartitionHashedKeysElapsedMicroseconds',
+    'AssignElapsedMicroseconds',
+    'AssignGatherElapsedMicroseconds',
+    'AssignWalkElapsedMicroseconds',
     'RngId',
     'RngFlags',
     'RngStartSeed',
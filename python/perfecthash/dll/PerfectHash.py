@@ -24,6 +24,7 @@ from ..wintypes import (
     LONG,
     CLSID,
     ULONG,
+    PCHAR,
     PVOID,
     USHORT,
     PULONG,
@@ -66,7 +67,10 @@ PerfectHashInvalidInterfaceId          = 8
 PerfectHashNullAlgorithmId              = 0
 PerfectHashChm01AlgorithmId             = 1
 PerfectHashDefaultAlgorithmId           = 1
-PerfectHashInvalidAlgorithmId           = 2
+PerfectHashBdz01AlgorithmId             = 2
+PerfectHashShard01AlgorithmId           = 3
+PerfectHashBlock01AlgorithmId           = 4
+PerfectHashInvalidAlgorithmId           = 5
 
 # PERFECT_HASH_HASH_FUNCTION_ID
 PerfectHashNullHashFunctionId           = 0
@@ -82,8 +86,9 @@ PerfectHashInvalidHashFunctionId        = 6
 PerfectHashNullMaskFunctionId           = 0
 PerfectHashModulusMaskFunctionId        = 1
 PerfectHashAndMaskFunctionId            = 2
+PerfectHashMultiplyHighMaskFunctionId   = 3
 PerfectHashDefaultMaskFunctionId        = 2
-PerfectHashInvalidMaskFunctionId        = 3
+PerfectHashInvalidMaskFunctionId        = 4
 
 # PERFECT_HASH_BENCHMARK_FUNCTION_ID
 PerfectHashNullBenchmarkFunctionId      = 0
@@ -117,6 +122,10 @@ def new_keys():
     obj = DllGetClassObject(REFCLSID_PERFECT_HASH, REFIID_PERFECT_HASH_KEYS)
     return cast(obj, PPERFECT_HASH_KEYS)
 
+def new_table():
+    obj = DllGetClassObject(REFCLSID_PERFECT_HASH, REFIID_PERFECT_HASH_TABLE)
+    return cast(obj, PPERFECT_HASH_TABLE)
+
 
 #===============================================================================
 # Interfaces
@@ -362,4 +371,258 @@ class Keys:
         return bitmap.value
 
 
+# PERFECT_HASH_TABLE
+
+IID_PERFECT_HASH_TABLE = GUID(
+    0xc265816f,
+    0xc6a9,
+    0x4b44,
+    0xbc, 0xee, 0xec, 0x5a, 0x12, 0xab, 0xe1, 0xef
+)
+REFIID_PERFECT_HASH_TABLE = byref(IID_PERFECT_HASH_TABLE)
+
+class PERFECT_HASH_TABLE(Structure):
+    pass
+PPERFECT_HASH_TABLE = POINTER(PERFECT_HASH_TABLE)
+
+PERFECT_HASH_TABLE_LOAD = WINFUNCTYPE(
+    HRESULT,
+    PPERFECT_HASH_TABLE,
+    PULONG,
+    PUNICODE_STRING,
+    PPERFECT_HASH_KEYS,
+)
+PPERFECT_HASH_TABLE_LOAD = POINTER(PERFECT_HASH_TABLE_LOAD)
+
+PERFECT_HASH_TABLE_INSERT = WINFUNCTYPE(
+    HRESULT,
+    PPERFECT_HASH_TABLE,
+    ULONG,
+    ULONG,
+    PULONG,
+)
+PPERFECT_HASH_TABLE_INSERT = POINTER(PERFECT_HASH_TABLE_INSERT)
+
+PERFECT_HASH_TABLE_LOOKUP = WINFUNCTYPE(
+    HRESULT,
+    PPERFECT_HASH_TABLE,
+    ULONG,
+    PULONG,
+)
+PPERFECT_HASH_TABLE_LOOKUP = POINTER(PERFECT_HASH_TABLE_LOOKUP)
+
+PERFECT_HASH_TABLE_INDEX = WINFUNCTYPE(
+    HRESULT,
+    PPERFECT_HASH_TABLE,
+    ULONG,
+    PULONG,
+)
+PPERFECT_HASH_TABLE_INDEX = POINTER(PERFECT_HASH_TABLE_INDEX)
+
+PERFECT_HASH_TABLE_INDEX_BATCH = WINFUNCTYPE(
+    HRESULT,
+    PPERFECT_HASH_TABLE,
+    ULONG,
+    PULONG,
+    PULONG,
+)
+PPERFECT_HASH_TABLE_INDEX_BATCH = POINTER(PERFECT_HASH_TABLE_INDEX_BATCH)
+
+PERFECT_HASH_TABLE_LOOKUP_BATCH = WINFUNCTYPE(
+    HRESULT,
+    PPERFECT_HASH_TABLE,
+    ULONG,
+    PULONG,
+    PULONG,
+)
+PPERFECT_HASH_TABLE_LOOKUP_BATCH = POINTER(PERFECT_HASH_TABLE_LOOKUP_BATCH)
+
+PERFECT_HASH_TABLE_INSERT_BATCH = WINFUNCTYPE(
+    HRESULT,
+    PPERFECT_HASH_TABLE,
+    ULONG,
+    PULONG,
+    PULONG,
+    PULONG,
+)
+PPERFECT_HASH_TABLE_INSERT_BATCH = POINTER(PERFECT_HASH_TABLE_INSERT_BATCH)
+
+PERFECT_HASH_TABLE_CONTAINS = WINFUNCTYPE(
+    HRESULT,
+    PPERFECT_HASH_TABLE,
+    ULONG,
+)
+PPERFECT_HASH_TABLE_CONTAINS = POINTER(PERFECT_HASH_TABLE_CONTAINS)
+
+PERFECT_HASH_TABLE_TRY_LOOKUP = WINFUNCTYPE(
+    HRESULT,
+    PPERFECT_HASH_TABLE,
+    ULONG,
+    PULONG,
+)
+PPERFECT_HASH_TABLE_TRY_LOOKUP = POINTER(PERFECT_HASH_TABLE_TRY_LOOKUP)
+
+PERFECT_HASH_TABLE_TRY_INDEX_STRING = WINFUNCTYPE(
+    HRESULT,
+    PPERFECT_HASH_TABLE,
+    PCHAR,
+    ULONG,
+    PULONG,
+)
+PPERFECT_HASH_TABLE_TRY_INDEX_STRING = POINTER(
+    PERFECT_HASH_TABLE_TRY_INDEX_STRING
+)
+
+PERFECT_HASH_TABLE_TRY_LOOKUP_STRING = WINFUNCTYPE(
+    HRESULT,
+    PPERFECT_HASH_TABLE,
+    PCHAR,
+    ULONG,
+    PULONG,
+)
+PPERFECT_HASH_TABLE_TRY_LOOKUP_STRING = POINTER(
+    PERFECT_HASH_TABLE_TRY_LOOKUP_STRING
+)
+
+# N.B. Only the routines we call from Python are typed; the remaining vtbl
+#      entries are declared as PVOID such that the structure layout matches
+#      PERFECT_HASH_TABLE_VTBL in PerfectHash.h.
+
+class PERFECT_HASH_TABLE_VTBL(Structure):
+    _fields_ = [
+        ('QueryInterface', PVOID),
+        ('AddRef', PVOID),
+        ('Release', PVOID),
+        ('CreateInstance', PVOID),
+        ('LockServer', PVOID),
+        ('Create', PVOID),
+        ('Load', PERFECT_HASH_TABLE_LOAD),
+        ('GetFlags', PVOID),
+        ('Compile', PVOID),
+        ('Test', PVOID),
+        ('Insert', PERFECT_HASH_TABLE_INSERT),
+        ('Lookup', PERFECT_HASH_TABLE_LOOKUP),
+        ('Delete', PVOID),
+        ('Index', PERFECT_HASH_TABLE_INDEX),
+        ('Hash', PVOID),
+        ('MaskHash', PVOID),
+        ('MaskIndex', PVOID),
+        ('SeededHash', PVOID),
+        ('FastIndex', PVOID),
+        ('SlowIndex', PVOID),
+        ('GetAlgorithmName', PVOID),
+        ('GetHashFunctionName', PVOID),
+        ('GetMaskFunctionName', PVOID),
+        ('GetFile', PVOID),
+        ('HashEx', PVOID),
+        ('SeededHashEx', PVOID),
+        ('IndexBatch', PERFECT_HASH_TABLE_INDEX_BATCH),
+        ('LookupBatch', PERFECT_HASH_TABLE_LOOKUP_BATCH),
+        ('InsertBatch', PERFECT_HASH_TABLE_INSERT_BATCH),
+        ('Contains', PERFECT_HASH_TABLE_CONTAINS),
+        ('TryLookup', PERFECT_HASH_TABLE_TRY_LOOKUP),
+        ('TryIndexString', PERFECT_HASH_TABLE_TRY_INDEX_STRING),
+        ('TryLookupString', PERFECT_HASH_TABLE_TRY_LOOKUP_STRING),
+    ]
+PPERFECT_HASH_TABLE_VTBL = POINTER(PERFECT_HASH_TABLE_VTBL)
+
+PERFECT_HASH_TABLE._fields_ = [
+    ('Vtbl', PPERFECT_HASH_TABLE_VTBL),
+]
+
+class Table:
+    def __init__(self, path, keys=None):
+        self.path = create_unicode_string(path)
+        self.obj = new_table()
+        self.keys = keys
+        self.vtbl = self.obj.contents.Vtbl.contents
+
+        keys_obj = keys.obj if keys else None
+        self._check(self.vtbl.Load(self.obj, None, byref(self.path), keys_obj))
+
+    @staticmethod
+    def _check(result):
+        # HRESULTs are unsigned here; failure codes have the high bit set.
+        if result & 0x80000000:
+            raise OSError('HRESULT: 0x%08x' % result)
+
+    @staticmethod
+    def _array(values):
+        return (ULONG * len(values))(*values)
+
+    def index(self, key):
+        index = ULONG()
+        self._check(self.vtbl.Index(self.obj, key, byref(index)))
+        return index.value
+
+    def lookup(self, key):
+        value = ULONG()
+        self._check(self.vtbl.Lookup(self.obj, key, byref(value)))
+        return value.value
+
+    def insert(self, key, value):
+        previous = ULONG()
+        self._check(self.vtbl.Insert(self.obj, key, value, byref(previous)))
+        return previous.value
+
+    def index_batch(self, keys):
+        count = len(keys)
+        keys = self._array(keys)
+        indices = (ULONG * count)()
+        self._check(self.vtbl.IndexBatch(self.obj, count, keys, indices))
+        return list(indices)
+
+    def lookup_batch(self, keys):
+        count = len(keys)
+        keys = self._array(keys)
+        values = (ULONG * count)()
+        self._check(self.vtbl.LookupBatch(self.obj, count, keys, values))
+        return list(values)
+
+    def insert_batch(self, keys, values):
+        count = len(keys)
+        assert count == len(values)
+        keys = self._array(keys)
+        values = self._array(values)
+        previous = (ULONG * count)()
+        self._check(
+            self.vtbl.InsertBatch(self.obj, count, keys, values, previous)
+        )
+        return list(previous)
+
+    # N.B. Contains() and TryLookup() return S_FALSE (1) for a miss, and
+    #      require the table to have been created with fingerprints.
+
+    def contains(self, key):
+        result = self.vtbl.Contains(self.obj, key)
+        self._check(result)
+        return result == 0
+
+    def try_lookup(self, key):
+        value = ULONG()
+        result = self.vtbl.TryLookup(self.obj, key, byref(value))
+        self._check(result)
+        return value.value if result == 0 else None
+
+    # N.B. TryIndexString() and TryLookupString() compare the full string, and
+    #      require the table to have been created from string keys, and the
+    #      string keys to have been passed to the constructor.
+
+    def try_index_string(self, string):
+        index = ULONG()
+        result = self.vtbl.TryIndexString(
+            self.obj, string, len(string), byref(index)
+        )
+        self._check(result)
+        return index.value if result == 0 else None
+
+    def try_lookup_string(self, string):
+        value = ULONG()
+        result = self.vtbl.TryLookupString(
+            self.obj, string, len(string), byref(value)
+        )
+        self._check(result)
+        return value.value if result == 0 else None
+
+
 # vim:set ts=8 sw=4 sts=4 tw=80 et                                             :
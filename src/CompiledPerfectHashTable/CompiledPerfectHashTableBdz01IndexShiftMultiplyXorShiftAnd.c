@@ -0,0 +1,51 @@
+
+//
+// N.B. The multipliers and partition reduction must match Bdz01.h.
+//
+
+DECLARE_INDEX_ROUTINE()
+{
+    ULONG Hash1;
+    ULONG Hash2;
+    ULONG Hash3;
+    ULONGLONG Sum;
+    CPHDKEY Vertex1;
+    CPHDKEY Vertex2;
+    CPHDKEY Vertex3;
+    CPHDKEY DownsizedKey;
+
+    DownsizedKey = DOWNSIZE_KEY(Key);
+
+    Vertex1 = DownsizedKey >> SEED3_BYTE1;
+    Vertex1 *= SEED1;
+    Vertex1 ^= Vertex1 >> SEED3_BYTE2;
+
+    Vertex2 = DownsizedKey >> SEED3_BYTE3;
+    Vertex2 *= SEED2;
+    Vertex2 ^= Vertex2 >> SEED3_BYTE4;
+
+    Hash1 = (ULONG)Vertex1 * 0x9e3779b1;
+    Hash2 = (ULONG)Vertex2 * 0x85ebca77;
+    Hash3 = (ULONG)(Vertex1 ^ Vertex2) * 0xc2b2ae3d;
+
+    Vertex1 = (CPHDKEY)(((ULONGLONG)Hash1 * HASH_MODULUS) >> 32);
+    Vertex2 = (CPHDKEY)(((ULONGLONG)Hash2 * HASH_MODULUS) >> 32);
+    Vertex3 = (CPHDKEY)(((ULONGLONG)Hash3 * HASH_MODULUS) >> 32);
+
+    Sum = (
+        (ULONGLONG)TABLE_DATA[Vertex1] +
+        (ULONGLONG)TABLE_DATA[Vertex2 + HASH_MODULUS] +
+        (ULONGLONG)TABLE_DATA[Vertex3 + (HASH_MODULUS * 2)]
+    );
+
+    if (Sum >= INDEX_MODULUS) {
+        Sum -= INDEX_MODULUS;
+    }
+
+    if (Sum >= INDEX_MODULUS) {
+        Sum -= INDEX_MODULUS;
+    }
+
+    return (CPHINDEX)Sum;
+}
+
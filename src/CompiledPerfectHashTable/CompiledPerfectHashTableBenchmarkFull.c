@@ -31,7 +31,7 @@ DECLARE_BENCHMARK_FULL_CPH_ROUTINE()
                 FOR_EACH_KEY {
                     Key = *Source++;
                     Rotated = ROTATE_KEY_LEFT(Key, 15);
-                    Previous = INSERT_ROUTINE(Key, (CPHVALUE)Rotated);
+                    Previous = INSERT_ROUTINE(Key, KEY_TO_VALUE(Rotated));
                 }
 
                 //
@@ -80,7 +80,7 @@ DECLARE_BENCHMARK_FULL_CPH_ROUTINE()
                 FOR_EACH_KEY {
                     Key = *Source++;
                     Rotated = ROTATE_KEY_LEFT(Key, 15);
-                    Previous = INSERT_ROUTINE(Key, (CPHVALUE)Rotated);
+                    Previous = INSERT_ROUTINE(Key, KEY_TO_VALUE(Rotated));
                 }
 
                 //
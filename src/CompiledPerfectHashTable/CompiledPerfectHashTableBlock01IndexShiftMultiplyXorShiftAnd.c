@@ -0,0 +1,56 @@
+//
+// N.B. The multipliers, block reduction and slot derivation must match
+//      Block01.h.
+//
+
+DECLARE_INDEX_ROUTINE()
+{
+    ULONG Hash1;
+    ULONG Mixed;
+    ULONG Slot1;
+    ULONG Slot2;
+    ULONG BlockHash;
+    ULONGLONG Sum;
+    CPHDKEY Vertex1;
+    CPHDKEY Vertex2;
+    CPHDKEY DownsizedKey;
+    const ULONG *Block;
+
+    DownsizedKey = DOWNSIZE_KEY(Key);
+
+    Vertex1 = DownsizedKey >> SEED3_BYTE1;
+    Vertex1 *= SEED1;
+    Vertex1 ^= Vertex1 >> SEED3_BYTE2;
+
+    Vertex2 = DownsizedKey >> SEED3_BYTE3;
+    Vertex2 *= SEED2;
+    Vertex2 ^= Vertex2 >> SEED3_BYTE4;
+
+    Hash1 = (ULONG)Vertex1 * 0x9e3779b1;
+    BlockHash = (ULONG)Vertex2 ^ Hash1;
+
+    Block = &TABLE_DATA[(((ULONGLONG)Hash1 * HASH_MODULUS) >> 32) << 4];
+
+    Mixed = BlockHash ^ (ULONG)Block[15];
+    Mixed ^= Mixed >> 16;
+    Mixed *= 0x85ebca6b;
+    Mixed ^= Mixed >> 13;
+    Mixed *= 0xc2b2ae35;
+    Mixed ^= Mixed >> 16;
+
+    Slot1 = ((Mixed >> 16) * 15) >> 16;
+    Slot2 = Slot1 + ((((Mixed & 0xffff) * 14) >> 16) + 1);
+
+    if (Slot2 >= 15) {
+        Slot2 -= 15;
+    }
+
+    Sum = (ULONGLONG)Block[Slot1] + (ULONGLONG)Block[Slot2];
+
+    if (Sum >= INDEX_MODULUS) {
+        Sum -= INDEX_MODULUS;
+    }
+
+    return (CPHINDEX)Sum;
+}
+
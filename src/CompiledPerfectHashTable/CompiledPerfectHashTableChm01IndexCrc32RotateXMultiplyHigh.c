@@ -0,0 +1,33 @@
+//
+// N.B. The multiplier and range reduction must match PerfectHashTable.h.
+//
+
+DECLARE_INDEX_ROUTINE()
+{
+    ULONG Hash1;
+    ULONG Hash2;
+    ULONGLONG Sum;
+    CPHDKEY Vertex1;
+    CPHDKEY Vertex2;
+    CPHDKEY DownsizedKey;
+
+    DownsizedKey = DOWNSIZE_KEY(Key);
+
+    Vertex1 = _mm_crc32_u32(SEED1, DownsizedKey);
+    Vertex2 = _mm_crc32_u32(SEED2, _rotl(DownsizedKey, SEED3_BYTE1));
+
+    Hash1 = (ULONG)Vertex1 * 0x9e3779b1;
+    Hash2 = (ULONG)Vertex2 * 0x9e3779b1;
+
+    Vertex1 = (CPHDKEY)(((ULONGLONG)Hash1 * HASH_MODULUS) >> 32);
+    Vertex2 = (CPHDKEY)(((ULONGLONG)Hash2 * HASH_MODULUS) >> 32);
+
+    Sum = (ULONGLONG)TABLE_DATA[Vertex1] + (ULONGLONG)TABLE_DATA[Vertex2];
+
+    if (Sum >= INDEX_MODULUS) {
+        Sum -= INDEX_MODULUS;
+    }
+
+    return (CPHINDEX)Sum;
+}
+
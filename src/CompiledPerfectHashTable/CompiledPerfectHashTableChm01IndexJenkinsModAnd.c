@@ -18,7 +18,7 @@ DECLARE_INDEX_ROUTINE()
     CPHDKEY DownsizedKey;
 
     DownsizedKey = DOWNSIZE_KEY(Key);
-    Byte = (PBYTE)&Key;
+    Byte = (PBYTE)&DownsizedKey;
 
     A = B = 0x9e3779b9;
     C = SEED1;
@@ -25,3 +25,21 @@ DECLARE_INDEX_ROUTINE()
     return Index;
 }
 
+#if defined(CPH_AVX2) && !defined(CPH_HAS_HASH_AVX2)
+#define CPH_HAS_HASH_AVX2
+
+DECLARE_HASH_AVX2_ROUTINE()
+{
+    __m256i Vertex1;
+    __m256i Vertex2;
+
+    Vertex1 = _mm256_mullo_epi32(DownsizedKeys, _mm256_set1_epi32((int)SEED1));
+
+    Vertex2 = _mm256_mullo_epi32(DownsizedKeys, _mm256_set1_epi32((int)SEED2));
+
+    *Vertex1Pointer = Vertex1;
+    *Vertex2Pointer = Vertex2;
+}
+
+#endif
+
@@ -0,0 +1,53 @@
+
+DECLARE_INDEX_ROUTINE()
+{
+    CPHINDEX Index;
+    CPHDKEY Vertex1;
+    CPHDKEY Vertex2;
+    CPHDKEY MaskedLow;
+    CPHDKEY MaskedHigh;
+    CPHDKEY DownsizedKey;
+
+    DownsizedKey = DOWNSIZE_KEY(Key);
+
+    Vertex1 = _rotr(DownsizedKey, SEED3_BYTE1);
+    Vertex1 *= SEED1;
+    Vertex1 ^= _rotr(Vertex1, SEED3_BYTE2);
+
+    Vertex2 = _rotr(DownsizedKey, SEED3_BYTE3);
+    Vertex2 *= SEED2;
+    Vertex2 ^= _rotr(Vertex2, SEED3_BYTE4);
+
+    MaskedLow = Vertex1 & HASH_MASK;
+    MaskedHigh = Vertex2 & HASH_MASK;
+
+    Vertex1 = UNPACK_TABLE_DATA(MaskedLow);
+    Vertex2 = UNPACK_TABLE_DATA(MaskedHigh);
+
+    Index = (CPHINDEX)((Vertex1 + Vertex2) & INDEX_MASK);
+
+    return Index;
+}
+
+#if defined(CPH_AVX2) && !defined(CPH_HAS_HASH_AVX2)
+#define CPH_HAS_HASH_AVX2
+
+DECLARE_HASH_AVX2_ROUTINE()
+{
+    __m256i Vertex1;
+    __m256i Vertex2;
+
+    Vertex1 = CphRotr256(DownsizedKeys, SEED3_BYTE1);
+    Vertex1 = _mm256_mullo_epi32(Vertex1, _mm256_set1_epi32((int)SEED1));
+    Vertex1 = _mm256_xor_si256(Vertex1, CphRotr256(Vertex1, SEED3_BYTE2));
+
+    Vertex2 = CphRotr256(DownsizedKeys, SEED3_BYTE3);
+    Vertex2 = _mm256_mullo_epi32(Vertex2, _mm256_set1_epi32((int)SEED2));
+    Vertex2 = _mm256_xor_si256(Vertex2, CphRotr256(Vertex2, SEED3_BYTE4));
+
+    *Vertex1Pointer = Vertex1;
+    *Vertex2Pointer = Vertex2;
+}
+
+#endif
+
@@ -37,3 +37,41 @@ DECLARE_INDEX_ROUTINE()
     return Index;
 }
 
+#if defined(CPH_AVX2) && !defined(CPH_HAS_HASH_AVX2)
+#define CPH_HAS_HASH_AVX2
+
+DECLARE_HASH_AVX2_ROUTINE()
+{
+    __m256i Vertex1;
+    __m256i Vertex2;
+
+    Vertex1 = _mm256_srli_epi32(DownsizedKeys, SEED3_BYTE1);
+    Vertex1 = _mm256_mullo_epi32(Vertex1, _mm256_set1_epi32((int)SEED1));
+    Vertex1 = _mm256_xor_si256(
+        Vertex1,
+        _mm256_srli_epi32(Vertex1, SEED3_BYTE2)
+    );
+    Vertex1 = _mm256_mullo_epi32(Vertex1, _mm256_set1_epi32((int)SEED2));
+    Vertex1 = _mm256_xor_si256(
+        Vertex1,
+        _mm256_srli_epi32(Vertex1, SEED3_BYTE3)
+    );
+
+    Vertex2 = _mm256_srli_epi32(DownsizedKeys, SEED6_BYTE1);
+    Vertex2 = _mm256_mullo_epi32(Vertex2, _mm256_set1_epi32((int)SEED4));
+    Vertex2 = _mm256_xor_si256(
+        Vertex2,
+        _mm256_srli_epi32(Vertex2, SEED6_BYTE2)
+    );
+    Vertex2 = _mm256_mullo_epi32(Vertex2, _mm256_set1_epi32((int)SEED5));
+    Vertex2 = _mm256_xor_si256(
+        Vertex2,
+        _mm256_srli_epi32(Vertex2, SEED6_BYTE3)
+    );
+
+    *Vertex1Pointer = Vertex1;
+    *Vertex2Pointer = Vertex2;
+}
+
+#endif
+
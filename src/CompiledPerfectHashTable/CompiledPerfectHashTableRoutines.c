@@ -1,4 +1,125 @@
 
+DECLARE_INDEX_BATCH_ROUTINE()
+{
+    ULONG Offset;
+#ifdef CPH_HAS_HASH_AVX2
+    ULONG Lane;
+    __m256i Index;
+    __m256i Vertex1;
+    __m256i Vertex2;
+    __m256i HashMask;
+    __m256i IndexMask;
+    CPHDKEY DownsizedKeys[CPH_AVX2_BATCH_SIZE];
+#endif
+
+    Offset = 0;
+
+#ifdef CPH_HAS_HASH_AVX2
+
+    //
+    // Process eight keys per iteration: hash them with the table's vector
+    // hash routine, mask the vertices, gather both table data elements, then
+    // add and mask to obtain the indices.  This requires 32-bit (downsized)
+    // keys; the test is a constant and will be folded by the compiler.
+    //
+
+    if (sizeof(CPHDKEY) == sizeof(ULONG)) {
+
+        HashMask = _mm256_set1_epi32((int)HASH_MASK);
+        IndexMask = _mm256_set1_epi32((int)INDEX_MASK);
+
+        for (; Offset + CPH_AVX2_BATCH_SIZE <= NumberOfKeys;
+             Offset += CPH_AVX2_BATCH_SIZE) {
+
+            for (Lane = 0; Lane < CPH_AVX2_BATCH_SIZE; Lane++) {
+                DownsizedKeys[Lane] = DOWNSIZE_KEY(Keys[Offset + Lane]);
+            }
+
+            HASH_AVX2_ROUTINE(
+                _mm256_loadu_si256((const __m256i *)DownsizedKeys),
+                &Vertex1,
+                &Vertex2
+            );
+
+            Vertex1 = _mm256_and_si256(Vertex1, HashMask);
+            Vertex2 = _mm256_and_si256(Vertex2, HashMask);
+
+            Vertex1 = GATHER_TABLE_DATA(Vertex1);
+            Vertex2 = GATHER_TABLE_DATA(Vertex2);
+
+            Index = _mm256_and_si256(_mm256_add_epi32(Vertex1, Vertex2),
+                                     IndexMask);
+
+            _mm256_storeu_si256((__m256i *)&Indices[Offset], Index);
+        }
+    }
+
+#endif
+
+    //
+    // Scalar tail (or the entire batch, if there's no vector hash routine).
+    //
+
+    for (; Offset < NumberOfKeys; Offset++) {
+        Indices[Offset] = INDEX_ROUTINE(Keys[Offset]);
+    }
+}
+
+#ifdef CPH_HAS_FINGERPRINTS
+
+DECLARE_CONTAINS_ROUTINE()
+{
+    CPHINDEX Index;
+
+    Index = INDEX_ROUTINE(Key);
+    return (TABLE_FINGERPRINTS[Index] == FINGERPRINT_KEY(Key));
+}
+
+#endif
+
+#ifdef CPH_STRING_KEYS
+
+DECLARE_INDEX_STRING_ROUTINE()
+{
+    return INDEX_ROUTINE((CPHKEY)HASH_STRING_KEY(String, Length));
+}
+
+DECLARE_TRY_INDEX_STRING_ROUTINE()
+{
+    ULONG Offset;
+    ULONG Current;
+    CPHINDEX Result;
+    const BYTE *Expected;
+
+    Result = INDEX_ROUTINE((CPHKEY)HASH_STRING_KEY(String, Length));
+
+    if (Result >= NUMBER_OF_KEYS) {
+        goto NotFound;
+    }
+
+    Offset = STRING_KEY_OFFSETS[Result];
+    if (STRING_KEY_OFFSETS[Result + 1] - Offset != Length) {
+        goto NotFound;
+    }
+
+    Expected = &STRING_KEY_DATA[Offset];
+    for (Current = 0; Current < Length; Current++) {
+        if (String[Current] != Expected[Current]) {
+            goto NotFound;
+        }
+    }
+
+    *Index = Result;
+    return TRUE;
+
+NotFound:
+    *Index = 0;
+    return FALSE;
+}
+
+#endif
+
+
 #ifndef CPH_INDEX_ONLY
 
 DECLARE_LOOKUP_ROUTINE()
@@ -6,7 +127,7 @@ DECLARE_LOOKUP_ROUTINE()
     CPHINDEX Index;
 
     Index = INDEX_ROUTINE(Key);
-    return TABLE_VALUES[Index];
+    return TABLE_VALUE(Index);
 }
 
 DECLARE_INSERT_ROUTINE()
@@ -15,8 +136,8 @@ DECLARE_INSERT_ROUTINE()
     CPHVALUE Previous;
 
     Index = INDEX_ROUTINE(Key);
-    Previous = TABLE_VALUES[Index];
-    TABLE_VALUES[Index] = Value;
+    Previous = TABLE_VALUE(Index);
+    TABLE_VALUE(Index) = Value;
     return Previous;
 }
 
@@ -26,9 +147,108 @@ DECLARE_DELETE_ROUTINE()
     CPHVALUE Previous;
 
     Index = INDEX_ROUTINE(Key);
-    Previous = TABLE_VALUES[Index];
-    TABLE_VALUES[Index] = 0;
+    Previous = TABLE_VALUE(Index);
+    TABLE_VALUE(Index) = 0;
     return Previous;
 }
 
+DECLARE_LOOKUP_BATCH_ROUTINE()
+{
+    ULONG Offset;
+#ifdef CPH_HAS_HASH_AVX2
+    ULONG Lane;
+    __m256i Index;
+    __m256i Vertex1;
+    __m256i Vertex2;
+    __m256i HashMask;
+    __m256i IndexMask;
+    CPHDKEY DownsizedKeys[CPH_AVX2_BATCH_SIZE];
+#endif
+
+    Offset = 0;
+
+#ifdef CPH_HAS_HASH_AVX2
+
+    //
+    // As per IndexBatch(), followed by a gather of the values.  Values may be
+    // 32-bit or 64-bit; the latter requires two 4-lane gathers.
+    //
+
+    if (sizeof(CPHDKEY) == sizeof(ULONG)) {
+
+        HashMask = _mm256_set1_epi32((int)HASH_MASK);
+        IndexMask = _mm256_set1_epi32((int)INDEX_MASK);
+
+        for (; Offset + CPH_AVX2_BATCH_SIZE <= NumberOfKeys;
+             Offset += CPH_AVX2_BATCH_SIZE) {
+
+            for (Lane = 0; Lane < CPH_AVX2_BATCH_SIZE; Lane++) {
+                DownsizedKeys[Lane] = DOWNSIZE_KEY(Keys[Offset + Lane]);
+            }
+
+            HASH_AVX2_ROUTINE(
+                _mm256_loadu_si256((const __m256i *)DownsizedKeys),
+                &Vertex1,
+                &Vertex2
+            );
+
+            Vertex1 = _mm256_and_si256(Vertex1, HashMask);
+            Vertex2 = _mm256_and_si256(Vertex2, HashMask);
+
+            Vertex1 = GATHER_TABLE_DATA(Vertex1);
+            Vertex2 = GATHER_TABLE_DATA(Vertex2);
+
+            Index = _mm256_and_si256(_mm256_add_epi32(Vertex1, Vertex2),
+                                     IndexMask);
+
+            if (sizeof(CPHVALUE) == sizeof(ULONG)) {
+                _mm256_storeu_si256(
+                    (__m256i *)&Values[Offset],
+                    _mm256_i32gather_epi32((const int *)TABLE_VALUES,
+                                           Index,
+                                           sizeof(CPHVALUE))
+                );
+            } else {
+                _mm256_storeu_si256(
+                    (__m256i *)&Values[Offset],
+                    _mm256_i32gather_epi64((const long long *)TABLE_VALUES,
+                                           _mm256_castsi256_si128(Index),
+                                           sizeof(CPHVALUE))
+                );
+                _mm256_storeu_si256(
+                    (__m256i *)&Values[Offset + (CPH_AVX2_BATCH_SIZE / 2)],
+                    _mm256_i32gather_epi64((const long long *)TABLE_VALUES,
+                                           _mm256_extracti128_si256(Index, 1),
+                                           sizeof(CPHVALUE))
+                );
+            }
+        }
+    }
+
+#endif
+
+    for (; Offset < NumberOfKeys; Offset++) {
+        Values[Offset] = LOOKUP_ROUTINE(Keys[Offset]);
+    }
+}
+
+#ifdef CPH_HAS_FINGERPRINTS
+
+DECLARE_TRY_LOOKUP_ROUTINE()
+{
+    CPHINDEX Index;
+
+    Index = INDEX_ROUTINE(Key);
+
+    if (TABLE_FINGERPRINTS[Index] != FINGERPRINT_KEY(Key)) {
+        *Value = 0;
+        return FALSE;
+    }
+
+    *Value = TABLE_VALUE(Index);
+    return TRUE;
+}
+
+#endif
+
 #endif
@@ -5,6 +5,14 @@
 
 #undef INDEX_ROUTINE
 #undef DECLARE_INDEX_ROUTINE
+#undef INDEX_BATCH_ROUTINE
+#undef DECLARE_INDEX_BATCH_ROUTINE
+#undef CONTAINS_ROUTINE
+#undef DECLARE_CONTAINS_ROUTINE
+#undef INDEX_STRING_ROUTINE
+#undef DECLARE_INDEX_STRING_ROUTINE
+#undef TRY_INDEX_STRING_ROUTINE
+#undef DECLARE_TRY_INDEX_STRING_ROUTINE
 
 #ifndef CPH_INDEX_ONLY
 #undef LOOKUP_ROUTINE
@@ -14,11 +22,27 @@
 #undef DECLARE_LOOKUP_ROUTINE
 #undef DECLARE_INSERT_ROUTINE
 #undef DECLARE_DELETE_ROUTINE
+#undef LOOKUP_BATCH_ROUTINE
+#undef DECLARE_LOOKUP_BATCH_ROUTINE
+#undef TRY_LOOKUP_ROUTINE
+#undef DECLARE_TRY_LOOKUP_ROUTINE
 #endif
 
 #define INDEX_ROUTINE EXPAND_INDEX_ROUTINE(CPH_TABLENAME)
 #define DECLARE_INDEX_ROUTINE() EXPAND_INDEX_ROUTINE_HEADER(CPH_TABLENAME)
 
+#define INDEX_BATCH_ROUTINE EXPAND_INDEX_BATCH_ROUTINE(CPH_TABLENAME)
+#define DECLARE_INDEX_BATCH_ROUTINE() EXPAND_INDEX_BATCH_ROUTINE_HEADER(CPH_TABLENAME)
+
+#define CONTAINS_ROUTINE EXPAND_CONTAINS_ROUTINE(CPH_TABLENAME)
+#define DECLARE_CONTAINS_ROUTINE() EXPAND_CONTAINS_ROUTINE_HEADER(CPH_TABLENAME)
+
+#define INDEX_STRING_ROUTINE EXPAND_INDEX_STRING_ROUTINE(CPH_TABLENAME)
+#define DECLARE_INDEX_STRING_ROUTINE() EXPAND_INDEX_STRING_ROUTINE_HEADER(CPH_TABLENAME)
+
+#define TRY_INDEX_STRING_ROUTINE EXPAND_TRY_INDEX_STRING_ROUTINE(CPH_TABLENAME)
+#define DECLARE_TRY_INDEX_STRING_ROUTINE() EXPAND_TRY_INDEX_STRING_ROUTINE_HEADER(CPH_TABLENAME)
+
 #ifndef CPH_INDEX_ONLY
 #define LOOKUP_ROUTINE EXPAND_LOOKUP_ROUTINE(CPH_TABLENAME)
 #define INSERT_ROUTINE EXPAND_INSERT_ROUTINE(CPH_TABLENAME)
@@ -27,6 +51,12 @@
 #define DECLARE_LOOKUP_ROUTINE() EXPAND_LOOKUP_ROUTINE_HEADER(CPH_TABLENAME)
 #define DECLARE_INSERT_ROUTINE() EXPAND_INSERT_ROUTINE_HEADER(CPH_TABLENAME)
 #define DECLARE_DELETE_ROUTINE() EXPAND_DELETE_ROUTINE_HEADER(CPH_TABLENAME)
+
+#define LOOKUP_BATCH_ROUTINE EXPAND_LOOKUP_BATCH_ROUTINE(CPH_TABLENAME)
+#define DECLARE_LOOKUP_BATCH_ROUTINE() EXPAND_LOOKUP_BATCH_ROUTINE_HEADER(CPH_TABLENAME)
+
+#define TRY_LOOKUP_ROUTINE EXPAND_TRY_LOOKUP_ROUTINE(CPH_TABLENAME)
+#define DECLARE_TRY_LOOKUP_ROUTINE() EXPAND_TRY_LOOKUP_ROUTINE_HEADER(CPH_TABLENAME)
 #endif
 
 #endif
@@ -4,6 +4,18 @@
 #define INDEX_ROUTINE EXPAND_INDEX_INLINE_ROUTINE(CPH_TABLENAME)
 #define DECLARE_INDEX_ROUTINE() EXPAND_INDEX_INLINE_ROUTINE_HEADER(CPH_TABLENAME)
 
+#define INDEX_BATCH_ROUTINE EXPAND_INDEX_BATCH_INLINE_ROUTINE(CPH_TABLENAME)
+#define DECLARE_INDEX_BATCH_ROUTINE() EXPAND_INDEX_BATCH_INLINE_ROUTINE_HEADER(CPH_TABLENAME)
+
+#define CONTAINS_ROUTINE EXPAND_CONTAINS_INLINE_ROUTINE(CPH_TABLENAME)
+#define DECLARE_CONTAINS_ROUTINE() EXPAND_CONTAINS_INLINE_ROUTINE_HEADER(CPH_TABLENAME)
+
+#define INDEX_STRING_ROUTINE EXPAND_INDEX_STRING_INLINE_ROUTINE(CPH_TABLENAME)
+#define DECLARE_INDEX_STRING_ROUTINE() EXPAND_INDEX_STRING_INLINE_ROUTINE_HEADER(CPH_TABLENAME)
+
+#define TRY_INDEX_STRING_ROUTINE EXPAND_TRY_INDEX_STRING_INLINE_ROUTINE(CPH_TABLENAME)
+#define DECLARE_TRY_INDEX_STRING_ROUTINE() EXPAND_TRY_INDEX_STRING_INLINE_ROUTINE_HEADER(CPH_TABLENAME)
+
 #ifndef CPH_INDEX_ONLY
 #define LOOKUP_ROUTINE EXPAND_LOOKUP_INLINE_ROUTINE(CPH_TABLENAME)
 #define INSERT_ROUTINE EXPAND_INSERT_INLINE_ROUTINE(CPH_TABLENAME)
@@ -12,6 +24,12 @@
 #define DECLARE_LOOKUP_ROUTINE() EXPAND_LOOKUP_INLINE_ROUTINE_HEADER(CPH_TABLENAME)
 #define DECLARE_INSERT_ROUTINE() EXPAND_INSERT_INLINE_ROUTINE_HEADER(CPH_TABLENAME)
 #define DECLARE_DELETE_ROUTINE() EXPAND_DELETE_INLINE_ROUTINE_HEADER(CPH_TABLENAME)
+
+#define LOOKUP_BATCH_ROUTINE EXPAND_LOOKUP_BATCH_INLINE_ROUTINE(CPH_TABLENAME)
+#define DECLARE_LOOKUP_BATCH_ROUTINE() EXPAND_LOOKUP_BATCH_INLINE_ROUTINE_HEADER(CPH_TABLENAME)
+
+#define TRY_LOOKUP_ROUTINE EXPAND_TRY_LOOKUP_INLINE_ROUTINE(CPH_TABLENAME)
+#define DECLARE_TRY_LOOKUP_ROUTINE() EXPAND_TRY_LOOKUP_INLINE_ROUTINE_HEADER(CPH_TABLENAME)
 #endif
 
 #else
@@ -19,6 +37,18 @@
 #define INDEX_ROUTINE EXPAND_INDEX_ROUTINE(CPH_TABLENAME)
 #define DECLARE_INDEX_ROUTINE() EXPAND_INDEX_ROUTINE_HEADER(CPH_TABLENAME)
 
+#define INDEX_BATCH_ROUTINE EXPAND_INDEX_BATCH_ROUTINE(CPH_TABLENAME)
+#define DECLARE_INDEX_BATCH_ROUTINE() EXPAND_INDEX_BATCH_ROUTINE_HEADER(CPH_TABLENAME)
+
+#define CONTAINS_ROUTINE EXPAND_CONTAINS_ROUTINE(CPH_TABLENAME)
+#define DECLARE_CONTAINS_ROUTINE() EXPAND_CONTAINS_ROUTINE_HEADER(CPH_TABLENAME)
+
+#define INDEX_STRING_ROUTINE EXPAND_INDEX_STRING_ROUTINE(CPH_TABLENAME)
+#define DECLARE_INDEX_STRING_ROUTINE() EXPAND_INDEX_STRING_ROUTINE_HEADER(CPH_TABLENAME)
+
+#define TRY_INDEX_STRING_ROUTINE EXPAND_TRY_INDEX_STRING_ROUTINE(CPH_TABLENAME)
+#define DECLARE_TRY_INDEX_STRING_ROUTINE() EXPAND_TRY_INDEX_STRING_ROUTINE_HEADER(CPH_TABLENAME)
+
 #ifndef CPH_INDEX_ONLY
 #define LOOKUP_ROUTINE EXPAND_LOOKUP_ROUTINE(CPH_TABLENAME)
 #define INSERT_ROUTINE EXPAND_INSERT_ROUTINE(CPH_TABLENAME)
@@ -27,6 +57,12 @@
 #define DECLARE_LOOKUP_ROUTINE() EXPAND_LOOKUP_ROUTINE_HEADER(CPH_TABLENAME)
 #define DECLARE_INSERT_ROUTINE() EXPAND_INSERT_ROUTINE_HEADER(CPH_TABLENAME)
 #define DECLARE_DELETE_ROUTINE() EXPAND_DELETE_ROUTINE_HEADER(CPH_TABLENAME)
+
+#define LOOKUP_BATCH_ROUTINE EXPAND_LOOKUP_BATCH_ROUTINE(CPH_TABLENAME)
+#define DECLARE_LOOKUP_BATCH_ROUTINE() EXPAND_LOOKUP_BATCH_ROUTINE_HEADER(CPH_TABLENAME)
+
+#define TRY_LOOKUP_ROUTINE EXPAND_TRY_LOOKUP_ROUTINE(CPH_TABLENAME)
+#define DECLARE_TRY_LOOKUP_ROUTINE() EXPAND_TRY_LOOKUP_ROUTINE_HEADER(CPH_TABLENAME)
 #endif
 
 #endif
@@ -0,0 +1,55 @@
+
+//
+// N.B. The shard selection must match Shard01GetShard() in Shard01.h, and the
+//      layout of TABLE_SHARDS must match SHARD01_DIRECTORY_ENTRY (i.e. key
+//      offset, number of keys, then seeds; 8 elements per shard).
+//
+
+DECLARE_INDEX_ROUTINE()
+{
+    ULONG Shard;
+    ULONG Offset;
+    CPHINDEX Index;
+    CPHSEED Seed1;
+    CPHSEED Seed2;
+    CPHSEED Seed3;
+    CPHDKEY Vertex1;
+    CPHDKEY Vertex2;
+    CPHDKEY MaskedLow;
+    CPHDKEY MaskedHigh;
+    CPHDKEY DownsizedKey;
+    const CPHSEED *Entry;
+
+    DownsizedKey = DOWNSIZE_KEY(Key);
+
+    Shard = DownsizedKey;
+    Shard ^= Shard >> 16;
+    Shard *= 0x85ebca6b;
+    Shard ^= Shard >> 13;
+    Shard *= 0xc2b2ae35;
+    Shard ^= Shard >> 16;
+    Shard = (ULONG)(((ULONGLONG)Shard * NUMBER_OF_SHARDS) >> 32);
+
+    Entry = &TABLE_SHARDS[Shard << 3];
+    Seed1 = Entry[2];
+    Seed2 = Entry[3];
+    Seed3 = Entry[4];
+
+    Vertex1 = DownsizedKey * Seed1;
+    Vertex1 = Vertex1 >> (Seed3 & 0xff);
+
+    Vertex2 = DownsizedKey * Seed2;
+    Vertex2 = Vertex2 >> ((Seed3 >> 8) & 0xff);
+
+    MaskedLow = Vertex1 & HASH_MASK;
+    MaskedHigh = Vertex2 & HASH_MASK;
+
+    Offset = Shard * (HASH_MASK + 1);
+
+    Vertex1 = TABLE_DATA[Offset + MaskedLow];
+    Vertex2 = TABLE_DATA[Offset + MaskedHigh];
+
+    Index = (CPHINDEX)(Entry[0] + ((Vertex1 + Vertex2) & INDEX_MASK));
+
+    return Index;
+}
@@ -25,6 +25,14 @@
         NumberOfErrors++;          \
     }
 
+//
+// Number of keys passed to each IndexBatch() and LookupBatch() call.  This is
+// deliberately not a multiple of eight, such that the scalar tail loop of the
+// vectorized batch routines is exercised as well.
+//
+
+#define CPH_TEST_BATCH_SIZE 63
+
 DECLARE_TEST_CPH_ROUTINE()
 /*++
 
@@ -43,6 +51,9 @@ Return Value:
 
 --*/
 {
+    ULONG Lane;
+    ULONG Count;
+    ULONG Offset;
     CPHINDEX Index;
     CPHKEY Key;
     CPHKEY Rotated;
@@ -50,6 +61,8 @@ Return Value:
     CPHVALUE Previous;
     ULONG NumberOfErrors = 0;
     const CPHKEY *Source;
+    CPHINDEX Indices[CPH_TEST_BATCH_SIZE];
+    CPHVALUE Values[CPH_TEST_BATCH_SIZE];
 
     Key = *KEYS;
 
@@ -59,7 +72,7 @@ Return Value:
     //
 
     Rotated = ROTATE_KEY_LEFT(Key, 15);
-    ASSERT(Key == ROTATE_KEY_RIGHT(Rotated, 15));
+    ASSERT(KEYS_EQUAL(Key, ROTATE_KEY_RIGHT(Rotated, 15)));
 
     //
     // Verify looking up a key that hasn't been inserted returns 0 as the value.
@@ -72,7 +85,7 @@ Return Value:
     // Verify insertion.
     //
 
-    Previous = INSERT_ROUTINE(Key, (CPHVALUE)Rotated);
+    Previous = INSERT_ROUTINE(Key, KEY_TO_VALUE(Rotated));
     ASSERT(Previous == 0);
 
     //
@@ -80,14 +93,14 @@ Return Value:
     //
 
     Value = LOOKUP_ROUTINE(Key);
-    ASSERT(Value == (CPHVALUE)Rotated);
+    ASSERT(Value == KEY_TO_VALUE(Rotated));
 
     //
     // Delete the inserted key.  Returned value should be Rotated.
     //
 
     Value = DELETE_ROUTINE(Key);
-    ASSERT(Value == (CPHVALUE)Rotated);
+    ASSERT(Value == KEY_TO_VALUE(Rotated));
 
     //
     // Verify a subsequent lookup returns 0.
@@ -105,7 +118,7 @@ Return Value:
         Key = *Source++;
         Rotated = ROTATE_KEY_LEFT(Key, 15);
 
-        Previous = INSERT_ROUTINE(Key, (CPHVALUE)Rotated);
+        Previous = INSERT_ROUTINE(Key, KEY_TO_VALUE(Rotated));
         ASSERT(Previous == 0);
 
     }
@@ -121,10 +134,88 @@ Return Value:
         Rotated = ROTATE_KEY_LEFT(Key, 15);
 
         Value = LOOKUP_ROUTINE(Key);
-        ASSERT(Value == (CPHVALUE)Rotated);
+        ASSERT(Value == KEY_TO_VALUE(Rotated));
 
     }
 
+    //
+    // Verify the batch routines agree with their scalar counterparts.
+    //
+
+    for (Offset = 0; Offset < NUMBER_OF_KEYS; Offset += Count) {
+
+        Count = NUMBER_OF_KEYS - Offset;
+        if (Count > CPH_TEST_BATCH_SIZE) {
+            Count = CPH_TEST_BATCH_SIZE;
+        }
+
+        INDEX_BATCH_ROUTINE(Count, &KEYS[Offset], Indices);
+        LOOKUP_BATCH_ROUTINE(Count, &KEYS[Offset], Values);
+
+        for (Lane = 0; Lane < Count; Lane++) {
+            Key = KEYS[Offset + Lane];
+            Rotated = ROTATE_KEY_LEFT(Key, 15);
+
+            ASSERT(Indices[Lane] == INDEX_ROUTINE(Key));
+            ASSERT(Values[Lane] == KEY_TO_VALUE(Rotated));
+        }
+    }
+
+#ifdef CPH_ORDER_PRESERVING
+
+    //
+    // Verify each key's index is its offset in the keys array.
+    //
+
+    for (Offset = 0; Offset < NUMBER_OF_KEYS; Offset++) {
+        Index = INDEX_ROUTINE(KEYS[Offset]);
+        ASSERT(Index == (CPHINDEX)Offset);
+    }
+
+#endif
+
+#ifdef CPH_STRING_KEYS
+
+    //
+    // Verify each string reduces to its key, and that both string routines
+    // return the string's offset in the keys array.
+    //
+
+    for (Offset = 0; Offset < NUMBER_OF_KEYS; Offset++) {
+        const BYTE *String;
+        ULONG Length;
+
+        String = &STRING_KEY_DATA[STRING_KEY_OFFSETS[Offset]];
+        Length = STRING_KEY_OFFSETS[Offset + 1] - STRING_KEY_OFFSETS[Offset];
+
+        ASSERT((CPHKEY)HASH_STRING_KEY(String, Length) == KEYS[Offset]);
+        ASSERT(INDEX_STRING_ROUTINE(String, Length) == (CPHINDEX)Offset);
+        ASSERT(TRY_INDEX_STRING_ROUTINE(String, Length, &Index));
+        ASSERT(Index == (CPHINDEX)Offset);
+    }
+
+#endif
+
+#ifdef CPH_HAS_FINGERPRINTS
+
+    //
+    // Verify every key is reported as present, and that TryLookup() agrees
+    // with Lookup().
+    //
+
+    FOR_EACH_KEY {
+
+        Key = *Source++;
+        Rotated = ROTATE_KEY_LEFT(Key, 15);
+
+        ASSERT(CONTAINS_ROUTINE(Key));
+        ASSERT(TRY_LOOKUP_ROUTINE(Key, &Value));
+        ASSERT(Value == KEY_TO_VALUE(Rotated));
+
+    }
+
+#endif
+
     //
     // Loop through again and delete everything.
     //
@@ -135,7 +226,7 @@ Return Value:
         Rotated = ROTATE_KEY_LEFT(Key, 15);
 
         Previous = DELETE_ROUTINE(Key);
-        ASSERT(Previous == (CPHVALUE)Rotated);
+        ASSERT(Previous == KEY_TO_VALUE(Rotated));
 
     }
 
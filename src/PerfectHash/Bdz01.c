@@ -0,0 +1,152 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    Bdz01.c
+
+Abstract:
+
+    This module implements the BDZ perfect hash table algorithm, which uses a
+    3-part random hypergraph.  See Bdz01.h for an overview.
+
+    The solving machinery (graph allocation, threadpool dispatch, table resize
+    events, file work and verification) is shared with the CHM algorithm; see
+    CreatePerfectHashTableImplChm01().  The Bdz01-specific logic lives in the
+    graph sizing (PrepareGraphInfoChm01()), the graph implementation routines
+    (GraphImplBdz01.c) and the Index() routine (Bdz01Index.c).
+
+--*/
+
+#include "stdafx.h"
+
+_Use_decl_annotations_
+HRESULT
+CreatePerfectHashTableImplBdz01(
+    PPERFECT_HASH_TABLE Table
+    )
+/*++
+
+Routine Description:
+
+    Attempts to create a perfect hash table using the BDZ algorithm and a
+    3-part random hypergraph.
+
+Arguments:
+
+    Table - Supplies a pointer to a partially-initialized PERFECT_HASH_TABLE
+        structure.
+
+Return Value:
+
+    S_OK - Table created successfully.
+
+    PH_E_INVALID_GRAPH_IMPL - The graph implementation requested is not
+        supported by the Bdz01 algorithm (only version 3 is supported).
+
+    PH_E_NOT_IMPLEMENTED - Modulus masking, or a best coverage type that
+        requires a keys subset, was requested.  Neither are supported by
+        the Bdz01 algorithm.
+
+    Otherwise, any of the return codes documented by
+    CreatePerfectHashTableImplChm01().
+
+--*/
+{
+    PPERFECT_HASH_CONTEXT Context;
+
+    if (!ARGUMENT_PRESENT(Table)) {
+        return E_POINTER;
+    }
+
+    Context = Table->Context;
+
+    //
+    // The hypergraph routines are built on top of the version 3 graph arrays
+    // (i.e. Vertices3 and the vertex pairs array, reused for vertex triples).
+    //
+
+    if (Table->GraphImpl != 3) {
+        return PH_E_INVALID_GRAPH_IMPL;
+    }
+
+    //
+    // Modulus and multiply-high masking don't apply to Bdz01; vertices are
+    // always derived via its own range reduction of the full 32-bit hash
+    // values.  Likewise, the keys subset memory coverage routines assume two
+    // vertices per key.
+    //
+
+    if (IsModulusMasking(Table->MaskFunctionId) ||
+        IsMultiplyHighMasking(Table->MaskFunctionId)) {
+        return PH_E_NOT_IMPLEMENTED;
+    }
+
+    if (BestMemoryCoverageForKeysSubset(Context)) {
+        return PH_E_NOT_IMPLEMENTED;
+    }
+
+    return CreatePerfectHashTableImplChm01(Table);
+}
+
+
+_Use_decl_annotations_
+HRESULT
+LoadPerfectHashTableImplBdz01(
+    PPERFECT_HASH_TABLE Table
+    )
+/*++
+
+Routine Description:
+
+    Loads a previously created Bdz01 perfect hash table.
+
+Arguments:
+
+    Table - Supplies a pointer to a partially-initialized PERFECT_HASH_TABLE
+        structure.
+
+Return Value:
+
+    S_OK - Table was loaded successfully.
+
+    PH_E_INVARIANT_CHECK_FAILED - The on-disk table info is inconsistent with
+        a Bdz01 table.
+
+--*/
+{
+    PTABLE_INFO_ON_DISK OnDisk;
+
+    OnDisk = Table->TableInfoOnDisk;
+
+    //
+    // The hash modulus is the partition size; the number of table elements
+    // must be exactly three times that, and the index modulus (number of keys)
+    // must be non-zero.
+    //
+
+    if (OnDisk->HashModulus == 0 || OnDisk->IndexModulus == 0) {
+        return PH_E_INVARIANT_CHECK_FAILED;
+    }
+
+    if (OnDisk->NumberOfTableElements.QuadPart !=
+        ((ULONGLONG)OnDisk->HashModulus * BDZ01_NUMBER_OF_PARTITIONS)) {
+        return PH_E_INVARIANT_CHECK_FAILED;
+    }
+
+    Table->HashSize = OnDisk->HashSize;
+    Table->IndexSize = OnDisk->IndexSize;
+    Table->HashShift = OnDisk->HashShift;
+    Table->IndexShift = OnDisk->IndexShift;
+    Table->HashMask = OnDisk->HashMask;
+    Table->IndexMask = OnDisk->IndexMask;
+    Table->HashFold = OnDisk->HashFold;
+    Table->IndexFold = OnDisk->IndexFold;
+    Table->HashModulus = OnDisk->HashModulus;
+    Table->IndexModulus = OnDisk->IndexModulus;
+
+    return S_OK;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
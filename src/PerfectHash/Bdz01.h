@@ -0,0 +1,211 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    Bdz01.h
+
+Abstract:
+
+    This is the header file for the Bdz01.c module, which implements a BDZ-style
+    perfect hash table algorithm based on a 3-uniform random hypergraph.
+
+    Each key is hashed into three vertices; one in each of three equally-sized
+    partitions of the vertex space.  The hypergraph is solved by peeling (i.e.
+    repeatedly removing edges incident to a vertex of degree 1), which succeeds
+    with high probability once the number of vertices exceeds ~1.23 times the
+    number of keys.  This is considerably less than the 2-part graph used by
+    the CHM algorithm, which requires at least twice as many vertices as edges,
+    rounded up to a power of 2.
+
+    Assignment is performed CHM-style: each vertex receives a value such that
+    the sum of a key's three assigned values, modulo the number of keys, yields
+    the key's original index.  Thus, Index() is minimal: the resulting index
+    will always lie between 0 and NumberOfKeys-1.
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Helper macro for determining if a table is using the Bdz01 algorithm.
+//
+
+#define IsBdz01(Table) ((Table)->AlgorithmId == PerfectHashBdz01AlgorithmId)
+
+//
+// The three partitions are addressed via a multiply-high range reduction of a
+// 32-bit hash value, which requires the full 32 bits of each hash to be in
+// play.  Thus, the "mask" supplied to the seeded hash routines is all ones.
+//
+
+#define BDZ01_HASH_MASK 0xffffffff
+
+//
+// Define the multipliers used to derive three independent 32-bit hash values
+// from the two values produced by the seeded hash routines.  These are the
+// odd constants used by the xxHash32 and murmur3 finalizers.  Multiplying by
+// an odd constant is a bijection, and ensures the high bits of the result
+// (which drive the range reduction) depend upon all the input bits, which is
+// important for hash functions like MultiplyShiftR whose output is confined
+// to the low bits.
+//
+// N.B. These values are duplicated in the compiled perfect hash table Index()
+//      implementations in ../CompiledPerfectHashTable/*Bdz01*.c; if you change
+//      them here, change them there too.
+//
+
+#define BDZ01_HASH1_MULTIPLIER 0x9e3779b1
+#define BDZ01_HASH2_MULTIPLIER 0x85ebca77
+#define BDZ01_HASH3_MULTIPLIER 0xc2b2ae3d
+
+//
+// The default number of vertices is NumberOfKeys * (1 + 15/64), or ~1.234,
+// which is just above the ~1.222 peeling threshold for 3-uniform hypergraphs.
+// Each table resize event grows the number of vertices by 1/8th (versus the
+// doubling employed by CHM).
+//
+
+#define BDZ01_VERTICES_MULTIPLIER_NUMERATOR 15
+#define BDZ01_VERTICES_MULTIPLIER_SHIFT 6
+#define BDZ01_RESIZE_SHIFT 3
+
+//
+// Each partition will have at least this many vertices.  Peeling is unlikely
+// to succeed for tiny hypergraphs at the ~1.23 ratio, so this effectively
+// boosts the ratio for small key sets.
+//
+
+#define BDZ01_MINIMUM_PARTITION_SIZE 8
+
+#define BDZ01_NUMBER_OF_PARTITIONS 3
+
+FORCEINLINE
+ULONGLONG
+Bdz01GetDefaultNumberOfVertices(
+    _In_ ULONGLONG NumberOfKeys
+    )
+{
+    ULONGLONG NumberOfVertices;
+
+    NumberOfVertices = NumberOfKeys + (
+        ((NumberOfKeys * BDZ01_VERTICES_MULTIPLIER_NUMERATOR) +
+         ((1ULL << BDZ01_VERTICES_MULTIPLIER_SHIFT) - 1)) >>
+        BDZ01_VERTICES_MULTIPLIER_SHIFT
+    );
+
+    return NumberOfVertices;
+}
+
+FORCEINLINE
+ULONGLONG
+Bdz01GrowNumberOfVertices(
+    _In_ ULONGLONG NumberOfVertices
+    )
+{
+    return NumberOfVertices + (NumberOfVertices >> BDZ01_RESIZE_SHIFT);
+}
+
+FORCEINLINE
+VOID
+Bdz01HashToVertexTriple(
+    _In_ ULARGE_INTEGER Hash,
+    _In_ ULONG PartitionSize,
+    _Out_ PVERTEX_TRIPLE Triple
+    )
+/*++
+
+Routine Description:
+
+    Derives three vertices from the 64-bit output of a seeded hash routine.
+    The first vertex will lie in [0, PartitionSize), the second in
+    [PartitionSize, PartitionSize*2), and the third in
+    [PartitionSize*2, PartitionSize*3).
+
+Arguments:
+
+    Hash - Supplies the two 32-bit hash values (unmasked) for a key.
+
+    PartitionSize - Supplies the number of vertices in each partition.
+
+    Triple - Receives the three vertices.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ULONG Hash1;
+    ULONG Hash2;
+    ULONG Hash3;
+
+    Hash1 = Hash.LowPart * BDZ01_HASH1_MULTIPLIER;
+    Hash2 = Hash.HighPart * BDZ01_HASH2_MULTIPLIER;
+    Hash3 = (Hash.LowPart ^ Hash.HighPart) * BDZ01_HASH3_MULTIPLIER;
+
+    Triple->Vertex1 = (VERTEX)(
+        ((ULONGLONG)Hash1 * (ULONGLONG)PartitionSize) >> 32
+    );
+
+    Triple->Vertex2 = (VERTEX)(
+        (((ULONGLONG)Hash2 * (ULONGLONG)PartitionSize) >> 32) +
+        PartitionSize
+    );
+
+    Triple->Vertex3 = (VERTEX)(
+        (((ULONGLONG)Hash3 * (ULONGLONG)PartitionSize) >> 32) +
+        ((ULONGLONG)PartitionSize << 1)
+    );
+}
+
+FORCEINLINE
+ULONG
+Bdz01ReduceIndex(
+    _In_ ULONGLONG Combined,
+    _In_ ULONG NumberOfKeys
+    )
+/*++
+
+Routine Description:
+
+    Reduces the sum of three assigned values into a final index.  Each assigned
+    value is less than NumberOfKeys, so the sum is less than three times that;
+    two conditional subtractions are sufficient, and avoid a division.
+
+Arguments:
+
+    Combined - Supplies the sum of the three assigned values.
+
+    NumberOfKeys - Supplies the number of keys (the index modulus).
+
+Return Value:
+
+    The index, between 0 and NumberOfKeys-1.
+
+--*/
+{
+    if (Combined >= NumberOfKeys) {
+        Combined -= NumberOfKeys;
+    }
+
+    if (Combined >= NumberOfKeys) {
+        Combined -= NumberOfKeys;
+    }
+
+    return (ULONG)Combined;
+}
+
+//
+// Declare the Bdz01 graph implementation routines (GraphImplBdz01.c).
+//
+
+#ifndef __INTELLISENSE__
+extern GRAPH_ADD_KEYS GraphAddKeysBdz01;
+extern GRAPH_IS_ACYCLIC GraphIsAcyclicBdz01;
+extern GRAPH_ASSIGN GraphAssignBdz01;
+extern GRAPH_VERIFY GraphVerifyBdz01;
+#endif
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
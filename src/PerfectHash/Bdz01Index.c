@@ -0,0 +1,191 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    Bdz01Index.c
+
+Abstract:
+
+    This module implements the Index() and IndexBatch() routines for the BDZ v1
+    algorithm.
+
+--*/
+
+#include "stdafx.h"
+
+PERFECT_HASH_TABLE_INDEX PerfectHashTableIndexImplBdz01;
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableIndexImplBdz01(
+    PPERFECT_HASH_TABLE Table,
+    ULONG Key,
+    PULONG Index
+    )
+/*++
+
+Routine Description:
+
+    Looks up given key in a perfect hash table and returns its index.
+
+    N.B. If Key did not appear in the original set the hash table was created
+         from, the behavior of this routine is undefined.  (In practice, the
+         key will hash to some other key's index.)
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the key lookup is to be
+        performed.
+
+    Key - Supplies the key to look up.
+
+    Index - Receives the index associated with this key.  The index will be
+        between 0 and Table->IndexModulus-1 (i.e. the number of keys), and can
+        be safely used to offset directly into an appropriately sized array
+        (e.g. Table->Values[]).
+
+Return Value:
+
+    S_OK.
+
+--*/
+{
+    PULONG Seeds;
+    PULONG Assigned;
+    ULONGLONG Combined;
+    ULARGE_INTEGER Hash;
+    VERTEX_TRIPLE Triple;
+
+    //
+    // Hash the incoming key into the 64-bit representation, which is two
+    // 32-bit ULONGs in disguise, each one driven by a separate seed value.
+    //
+
+    Seeds = &Table->TableInfoOnDisk->FirstSeed;
+    Hash.QuadPart = Table->Vtbl->SeededHashEx(Key, Seeds, Table->HashMask);
+
+    //
+    // Derive the three vertices; one from each partition.
+    //
+
+    Bdz01HashToVertexTriple(Hash, Table->HashModulus, &Triple);
+
+    //
+    // Sum the assigned values for each vertex, then reduce the result modulo
+    // the number of keys.
+    //
+
+    Assigned = Table->Assigned;
+
+    Combined = (
+        (ULONGLONG)Assigned[Triple.Vertex1] +
+        (ULONGLONG)Assigned[Triple.Vertex2] +
+        (ULONGLONG)Assigned[Triple.Vertex3]
+    );
+
+    *Index = Bdz01ReduceIndex(Combined, Table->IndexModulus);
+
+    return S_OK;
+}
+
+PERFECT_HASH_TABLE_INDEX_BATCH PerfectHashTableIndexBatchImplBdz01;
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableIndexBatchImplBdz01(
+    PPERFECT_HASH_TABLE Table,
+    ULONG NumberOfKeys,
+    PULONG Keys,
+    PULONG Indices
+    )
+/*++
+
+Routine Description:
+
+    Looks up an array of keys in a perfect hash table and returns their
+    indices.  Keys are processed in groups of
+    PERFECT_HASH_TABLE_BATCH_GROUP_SIZE; each key in a group is hashed into
+    its vertex triple and all three assigned array slots are prefetched, then
+    the group's indices are resolved.
+
+    N.B. If a key did not appear in the original set the hash table was created
+         from, the behavior of this routine is undefined for that key.
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the key lookups are to
+        be performed.
+
+    NumberOfKeys - Supplies the number of keys in the Keys array.
+
+    Keys - Supplies the base address of an array of keys to look up.
+
+    Indices - Receives the index associated with each key.
+
+Return Value:
+
+    S_OK.
+
+--*/
+{
+    ULONG Base;
+    ULONG Count;
+    ULONG Offset;
+    PULONG Seeds;
+    PULONG Assigned;
+    ULONGLONG Combined;
+    ULARGE_INTEGER Hash;
+    PVERTEX_TRIPLE Triple;
+    VERTEX_TRIPLE Triples[PERFECT_HASH_TABLE_BATCH_GROUP_SIZE];
+
+    //
+    // Initialize aliases.
+    //
+
+    Seeds = &Table->TableInfoOnDisk->FirstSeed;
+    Assigned = Table->Assigned;
+
+    for (Base = 0; Base < NumberOfKeys; Base += Count) {
+
+        Count = min(PERFECT_HASH_TABLE_BATCH_GROUP_SIZE, NumberOfKeys - Base);
+
+        //
+        // Derive the vertex triple of each key in the group and prefetch the
+        // corresponding assigned slots.
+        //
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            Triple = &Triples[Offset];
+            Hash.QuadPart = Table->Vtbl->SeededHashEx(Keys[Base + Offset],
+                                                      Seeds,
+                                                      Table->HashMask);
+            Bdz01HashToVertexTriple(Hash, Table->HashModulus, Triple);
+            PreFetchCacheLine(PF_TEMPORAL_LEVEL_1, &Assigned[Triple->Vertex1]);
+            PreFetchCacheLine(PF_TEMPORAL_LEVEL_1, &Assigned[Triple->Vertex2]);
+            PreFetchCacheLine(PF_TEMPORAL_LEVEL_1, &Assigned[Triple->Vertex3]);
+        }
+
+        //
+        // Resolve the indices of the group.
+        //
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            Triple = &Triples[Offset];
+
+            Combined = (
+                (ULONGLONG)Assigned[Triple->Vertex1] +
+                (ULONGLONG)Assigned[Triple->Vertex2] +
+                (ULONGLONG)Assigned[Triple->Vertex3]
+            );
+
+            Indices[Base + Offset] = Bdz01ReduceIndex(Combined,
+                                                      Table->IndexModulus);
+        }
+    }
+
+    return S_OK;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
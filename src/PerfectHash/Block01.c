@@ -0,0 +1,247 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    Block01.c
+
+Abstract:
+
+    This module implements the Block01 perfect hash table algorithm, in which
+    both of a key's vertices reside in the same cache line.  See Block01.h for
+    an overview.
+
+    As with Bdz01, the solving machinery (graph allocation, threadpool
+    dispatch, table resize events, file work and verification) is shared with
+    the CHM algorithm; see CreatePerfectHashTableImplChm01().  The Block01
+    specific logic lives in the graph sizing (see PrepareGraphInfoChm01() and
+    Block01GetDefaultNumberOfVertices()), the graph implementation routines
+    (GraphImplBlock01.c) and the Index() routine (Block01Index.c).
+
+--*/
+
+#include "stdafx.h"
+
+//
+// The sizing routine below needs to evaluate the upper tail of a Poisson
+// distribution up to this many terms beyond the maximum number of keys per
+// block; subsequent terms are negligible.
+//
+
+#define BLOCK01_POISSON_TAIL_TERMS 32
+
+_Use_decl_annotations_
+ULONGLONG
+NTAPI
+Block01GetDefaultNumberOfVertices(
+    ULONGLONG NumberOfKeys
+    )
+/*++
+
+Routine Description:
+
+    Returns the default number of vertices (table data elements) for a given
+    number of keys.  The number of blocks initially targets
+    BLOCK01_TARGET_KEYS_PER_BLOCK keys per block, and is then grown (by 1/8th
+    at a time) until the expected number of blocks receiving more keys than
+    an acyclic block graph can accommodate falls below
+    BLOCK01_MAXIMUM_EXPECTED_OVERFLOWING_BLOCKS.  The number of keys per block
+    is approximately Poisson distributed, so the expectation is the number of
+    blocks multiplied by the Poisson upper tail probability.
+
+    N.B. Without the overflow constraint, a fixed load factor would yield a
+         solve rate that decays exponentially with the number of keys (as
+         there are more blocks in which an overflow can occur).
+
+Arguments:
+
+    NumberOfKeys - Supplies the number of keys.
+
+Return Value:
+
+    The number of vertices, which will always be a multiple of
+    BLOCK01_ELEMENTS_PER_BLOCK.
+
+--*/
+{
+    ULONG Index;
+    DOUBLE Term;
+    DOUBLE Tail;
+    DOUBLE Lambda;
+    ULONGLONG NumberOfBlocks;
+
+    NumberOfBlocks = (
+        (NumberOfKeys + (BLOCK01_TARGET_KEYS_PER_BLOCK - 1)) /
+        BLOCK01_TARGET_KEYS_PER_BLOCK
+    );
+
+    if (NumberOfBlocks == 0) {
+        NumberOfBlocks = 1;
+    }
+
+    while (TRUE) {
+
+        //
+        // Calculate P(X > BLOCK01_MAXIMUM_KEYS_PER_BLOCK) for X ~ Poisson with
+        // mean Lambda, i.e. the mean number of keys per block.
+        //
+
+        Lambda = (DOUBLE)NumberOfKeys / (DOUBLE)NumberOfBlocks;
+        Term = exp(-Lambda);
+
+        for (Index = 1; Index <= BLOCK01_MAXIMUM_KEYS_PER_BLOCK + 1; Index++) {
+            Term *= Lambda / (DOUBLE)Index;
+        }
+
+        Tail = 0.0;
+
+        for (Index = BLOCK01_MAXIMUM_KEYS_PER_BLOCK + 1;
+             Index <= BLOCK01_MAXIMUM_KEYS_PER_BLOCK +
+                      BLOCK01_POISSON_TAIL_TERMS;
+             Index++) {
+
+            Tail += Term;
+            Term *= Lambda / (DOUBLE)(Index + 1);
+        }
+
+        if (((DOUBLE)NumberOfBlocks * Tail) <=
+            BLOCK01_MAXIMUM_EXPECTED_OVERFLOWING_BLOCKS) {
+            break;
+        }
+
+        NumberOfBlocks += (NumberOfBlocks >> BLOCK01_RESIZE_SHIFT) + 1;
+    }
+
+    return NumberOfBlocks << BLOCK01_BLOCK_SHIFT;
+}
+
+
+_Use_decl_annotations_
+HRESULT
+CreatePerfectHashTableImplBlock01(
+    PPERFECT_HASH_TABLE Table
+    )
+/*++
+
+Routine Description:
+
+    Attempts to create a perfect hash table using the Block01 algorithm.
+
+Arguments:
+
+    Table - Supplies a pointer to a partially-initialized PERFECT_HASH_TABLE
+        structure.
+
+Return Value:
+
+    S_OK - Table created successfully.
+
+    PH_E_INVALID_GRAPH_IMPL - The graph implementation requested is not
+        supported by the Block01 algorithm (only version 3 is supported).
+
+    PH_E_NOT_IMPLEMENTED - Modulus or multiply-high masking, or a best
+        coverage type that requires a keys subset, was requested.  None of
+        these are supported by the Block01 algorithm.
+
+    Otherwise, any of the return codes documented by
+    CreatePerfectHashTableImplChm01().
+
+--*/
+{
+    PPERFECT_HASH_CONTEXT Context;
+
+    if (!ARGUMENT_PRESENT(Table)) {
+        return E_POINTER;
+    }
+
+    Context = Table->Context;
+
+    //
+    // The block graph routines are built on top of the version 3 graph arrays
+    // (i.e. Vertices3, Order and the vertex pairs array).
+    //
+
+    if (Table->GraphImpl != 3) {
+        return PH_E_INVALID_GRAPH_IMPL;
+    }
+
+    //
+    // As with Bdz01, modulus and multiply-high masking don't apply; blocks and
+    // slots are derived via Block01's own range reductions of the full 32-bit
+    // hash values.  Likewise, the keys subset memory coverage routines assume
+    // vertices are independent of one another.
+    //
+
+    if (IsModulusMasking(Table->MaskFunctionId) ||
+        IsMultiplyHighMasking(Table->MaskFunctionId)) {
+        return PH_E_NOT_IMPLEMENTED;
+    }
+
+    if (BestMemoryCoverageForKeysSubset(Context)) {
+        return PH_E_NOT_IMPLEMENTED;
+    }
+
+    return CreatePerfectHashTableImplChm01(Table);
+}
+
+
+_Use_decl_annotations_
+HRESULT
+LoadPerfectHashTableImplBlock01(
+    PPERFECT_HASH_TABLE Table
+    )
+/*++
+
+Routine Description:
+
+    Loads a previously created Block01 perfect hash table.
+
+Arguments:
+
+    Table - Supplies a pointer to a partially-initialized PERFECT_HASH_TABLE
+        structure.
+
+Return Value:
+
+    S_OK - Table was loaded successfully.
+
+    PH_E_INVARIANT_CHECK_FAILED - The on-disk table info is inconsistent with
+        a Block01 table.
+
+--*/
+{
+    PTABLE_INFO_ON_DISK OnDisk;
+
+    OnDisk = Table->TableInfoOnDisk;
+
+    //
+    // The hash modulus is the number of blocks; the number of table elements
+    // must be exactly that many blocks' worth, and the index modulus (number
+    // of keys) must be non-zero.
+    //
+
+    if (OnDisk->HashModulus == 0 || OnDisk->IndexModulus == 0) {
+        return PH_E_INVARIANT_CHECK_FAILED;
+    }
+
+    if (OnDisk->NumberOfTableElements.QuadPart !=
+        ((ULONGLONG)OnDisk->HashModulus << BLOCK01_BLOCK_SHIFT)) {
+        return PH_E_INVARIANT_CHECK_FAILED;
+    }
+
+    Table->HashSize = OnDisk->HashSize;
+    Table->IndexSize = OnDisk->IndexSize;
+    Table->HashShift = OnDisk->HashShift;
+    Table->IndexShift = OnDisk->IndexShift;
+    Table->HashMask = OnDisk->HashMask;
+    Table->IndexMask = OnDisk->IndexMask;
+    Table->HashFold = OnDisk->HashFold;
+    Table->IndexFold = OnDisk->IndexFold;
+    Table->HashModulus = OnDisk->HashModulus;
+    Table->IndexModulus = OnDisk->IndexModulus;
+
+    return S_OK;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -0,0 +1,356 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    Block01.h
+
+Abstract:
+
+    This is the header file for the Block01.c module, which implements a
+    cache-line-local perfect hash table algorithm.  Every lookup touches
+    exactly one table data cache line, versus two for the CHM algorithm (whose
+    vertices are independent, and thus, almost always live in different cache
+    lines once the table exceeds a few KB).
+
+    The table data is an array of 64-byte blocks, each comprising sixteen
+    ULONGs: fifteen assigned values (slots), followed by the block's seed:
+
+        [ULONG Slots[15]][ULONG BlockSeed]  (Block 0)
+        [ULONG Slots[15]][ULONG BlockSeed]  (Block 1)
+        ...
+
+    Each key is hashed with the table's seeded hash function.  The first hash
+    value selects a block (via a multiply-high range reduction); the second is
+    combined with the block's seed to derive the first vertex within the block,
+    and the second vertex is derived from the first, such that both of a key's
+    vertices always reside in the same block.
+
+    As the vertices are block-local, the graph decomposes into one small graph
+    (fifteen vertices) per block.  A single set of table seeds is very unlikely
+    to yield every one of these graphs acyclic, so each block is solved on its
+    own by trying block seeds until the block's graph is acyclic.  Solving
+    only fails (and the table seeds are discarded) when a block receives more
+    keys than an acyclic graph with fifteen vertices can accommodate, so the
+    number of blocks is chosen such that this is unlikely.
+
+    Assignment is CHM-style: each vertex receives a value such that the sum of
+    a key's two assigned values, modulo the number of keys, yields the key's
+    original index.  Thus, Index() is minimal: the resulting index will always
+    lie between 0 and NumberOfKeys-1.
+
+    The trade-off versus CHM is size: blocks hold ~2-4 keys each on average
+    (fewer for larger key sets, see Block01GetDefaultNumberOfVertices()), so
+    table data is typically two to three times larger, in exchange for halving
+    the number of cache misses incurred by lookups against tables larger than
+    the LLC.
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Helper macro for determining if a table is using the Block01 algorithm.
+//
+
+#define IsBlock01(Table) ((Table)->AlgorithmId == PerfectHashBlock01AlgorithmId)
+
+//
+// The block is derived from a multiply-high range reduction of a 32-bit hash
+// value, which requires the full 32 bits of each hash to be in play.  Thus,
+// the "mask" supplied to the seeded hash routines is all ones.
+//
+
+#define BLOCK01_HASH_MASK 0xffffffff
+
+//
+// Define the block geometry.  A block is a single cache line of ULONG table
+// data elements; the last element captures the block seed, the remainder are
+// vertices (slots).
+//
+
+#define BLOCK01_BLOCK_SIZE_IN_BYTES 64
+#define BLOCK01_ELEMENTS_PER_BLOCK 16
+#define BLOCK01_BLOCK_SHIFT 4
+#define BLOCK01_SLOTS_PER_BLOCK 15
+#define BLOCK01_BLOCK_SEED_SLOT 15
+
+C_ASSERT(BLOCK01_ELEMENTS_PER_BLOCK == (1 << BLOCK01_BLOCK_SHIFT));
+C_ASSERT(BLOCK01_ELEMENTS_PER_BLOCK * sizeof(ULONG) ==
+         BLOCK01_BLOCK_SIZE_IN_BYTES);
+
+//
+// An acyclic graph with 15 vertices has at most 14 edges.  A block receiving
+// more keys than this can't be solved with any block seed.
+//
+
+#define BLOCK01_MAXIMUM_KEYS_PER_BLOCK (BLOCK01_SLOTS_PER_BLOCK - 1)
+
+//
+// Define the number of block seeds to try before giving up on a block (and
+// thus, the current table seeds).  Even a block with the maximum number of
+// keys is solved within a few hundred seeds on average.
+//
+
+#define BLOCK01_MAXIMUM_BLOCK_SEED_ATTEMPTS 4096
+
+//
+// Define the multiplier used to mix the first hash value prior to the block
+// range reduction (see Bdz01.h for the rationale), and the murmur3 32-bit
+// finalizer constants used to mix the block hash with the block seed.
+//
+// N.B. These values are duplicated in the compiled perfect hash table Index()
+//      implementations in ../CompiledPerfectHashTable/*Block01*.c; if you
+//      change them here, change them there too.
+//
+
+#define BLOCK01_HASH1_MULTIPLIER 0x9e3779b1
+#define BLOCK01_FMIX32_MULTIPLIER1 0x85ebca6b
+#define BLOCK01_FMIX32_MULTIPLIER2 0xc2b2ae35
+
+//
+// The default number of blocks targets this many keys per block on average,
+// subject to the expected number of blocks with more than the maximum number
+// of keys not exceeding the threshold below (see Block01.c).  Each table
+// resize event grows the number of blocks by 1/8th.
+//
+
+#define BLOCK01_TARGET_KEYS_PER_BLOCK 4
+#define BLOCK01_MAXIMUM_EXPECTED_OVERFLOWING_BLOCKS 0.25
+#define BLOCK01_RESIZE_SHIFT 3
+
+FORCEINLINE
+ULONGLONG
+Block01GrowNumberOfVertices(
+    _In_ ULONGLONG NumberOfVertices
+    )
+{
+    ULONGLONG NumberOfBlocks;
+
+    NumberOfBlocks = NumberOfVertices >> BLOCK01_BLOCK_SHIFT;
+    NumberOfBlocks += (NumberOfBlocks >> BLOCK01_RESIZE_SHIFT) + 1;
+
+    return NumberOfBlocks << BLOCK01_BLOCK_SHIFT;
+}
+
+FORCEINLINE
+ULONGLONG
+Block01RoundUpNumberOfVertices(
+    _In_ ULONGLONG NumberOfVertices
+    )
+{
+    return ALIGN_UP(NumberOfVertices, BLOCK01_ELEMENTS_PER_BLOCK);
+}
+
+FORCEINLINE
+VOID
+Block01HashToBlock(
+    _In_ ULARGE_INTEGER Hash,
+    _In_ ULONG NumberOfBlocks,
+    _Out_ PVERTEX_PAIR Pair
+    )
+/*++
+
+Routine Description:
+
+    Derives a key's block and block hash from the 64-bit output of a seeded
+    hash routine.
+
+Arguments:
+
+    Hash - Supplies the two 32-bit hash values (unmasked) for a key.
+
+    NumberOfBlocks - Supplies the number of blocks.
+
+    Pair - Receives the block (between 0 and NumberOfBlocks-1) in Vertex1, and
+        the block hash in Vertex2.  The latter folds in the first hash value
+        such that keys whose second hash values collide can still be told
+        apart within a block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ULONG Hash1;
+
+    Hash1 = Hash.LowPart * BLOCK01_HASH1_MULTIPLIER;
+
+    Pair->Vertex1 = (VERTEX)(
+        ((ULONGLONG)Hash1 * (ULONGLONG)NumberOfBlocks) >> 32
+    );
+
+    Pair->Vertex2 = (VERTEX)(Hash.HighPart ^ Hash1);
+}
+
+FORCEINLINE
+VOID
+Block01GetSlots(
+    _In_ ULONG BlockHash,
+    _In_ ULONG BlockSeed,
+    _Out_ PULONG Slot1,
+    _Out_ PULONG Slot2
+    )
+/*++
+
+Routine Description:
+
+    Derives the two slots (vertices within a block) for a given block hash and
+    block seed.  The first slot lies in [0, 15); the second slot is the first
+    slot plus a non-zero offset, modulo 15, which guarantees the two slots are
+    distinct (i.e. there are no vertex collisions).
+
+Arguments:
+
+    BlockHash - Supplies the block hash (see Block01HashToBlock()).
+
+    BlockSeed - Supplies the block seed.
+
+    Slot1 - Receives the first slot.
+
+    Slot2 - Receives the second slot.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ULONG Mixed;
+    ULONG First;
+    ULONG Second;
+
+    Mixed = BlockHash ^ BlockSeed;
+    Mixed ^= Mixed >> 16;
+    Mixed *= BLOCK01_FMIX32_MULTIPLIER1;
+    Mixed ^= Mixed >> 13;
+    Mixed *= BLOCK01_FMIX32_MULTIPLIER2;
+    Mixed ^= Mixed >> 16;
+
+    First = ((Mixed >> 16) * BLOCK01_SLOTS_PER_BLOCK) >> 16;
+    Second = First + (
+        (((Mixed & 0xffff) * (BLOCK01_SLOTS_PER_BLOCK - 1)) >> 16) + 1
+    );
+
+    if (Second >= BLOCK01_SLOTS_PER_BLOCK) {
+        Second -= BLOCK01_SLOTS_PER_BLOCK;
+    }
+
+    *Slot1 = First;
+    *Slot2 = Second;
+}
+
+FORCEINLINE
+ULONG
+Block01ReduceIndex(
+    _In_ ULONGLONG Combined,
+    _In_ ULONG NumberOfKeys
+    )
+/*++
+
+Routine Description:
+
+    Reduces the sum of two assigned values into a final index.  Each assigned
+    value is less than NumberOfKeys, so a single conditional subtraction is
+    sufficient.
+
+Arguments:
+
+    Combined - Supplies the sum of the two assigned values.
+
+    NumberOfKeys - Supplies the number of keys (the index modulus).
+
+Return Value:
+
+    The index, between 0 and NumberOfKeys-1.
+
+--*/
+{
+    if (Combined >= NumberOfKeys) {
+        Combined -= NumberOfKeys;
+    }
+
+    return (ULONG)Combined;
+}
+
+FORCEINLINE
+ULONG
+Block01IndexHash(
+    _In_ ULARGE_INTEGER Hash,
+    _In_ PULONG Assigned,
+    _In_ ULONG NumberOfBlocks,
+    _In_ ULONG NumberOfKeys
+    )
+/*++
+
+Routine Description:
+
+    Resolves a key's index given its hash and the table data.  This is shared
+    by the Index() routine (which operates on the table data) and graph
+    verification (which operates on the graph's assigned array).
+
+Arguments:
+
+    Hash - Supplies the two 32-bit hash values (unmasked) for the key.
+
+    Assigned - Supplies the base address of the table data.
+
+    NumberOfBlocks - Supplies the number of blocks.
+
+    NumberOfKeys - Supplies the number of keys (the index modulus).
+
+Return Value:
+
+    The key's index.
+
+--*/
+{
+    ULONG Slot1;
+    ULONG Slot2;
+    PULONG Block;
+    VERTEX_PAIR Pair;
+
+    Block01HashToBlock(Hash, NumberOfBlocks, &Pair);
+
+    Block = Assigned + ((ULONGLONG)Pair.Vertex1 << BLOCK01_BLOCK_SHIFT);
+
+    Block01GetSlots(Pair.Vertex2,
+                    Block[BLOCK01_BLOCK_SEED_SLOT],
+                    &Slot1,
+                    &Slot2);
+
+    return Block01ReduceIndex((ULONGLONG)Block[Slot1] + (ULONGLONG)Block[Slot2],
+                              NumberOfKeys);
+}
+
+//
+// Block01 routines used by the Chm01 creation pipeline (Block01.c).
+//
+
+typedef
+ULONGLONG
+(NTAPI BLOCK01_GET_DEFAULT_NUMBER_OF_VERTICES)(
+    _In_ ULONGLONG NumberOfKeys
+    );
+typedef BLOCK01_GET_DEFAULT_NUMBER_OF_VERTICES
+      *PBLOCK01_GET_DEFAULT_NUMBER_OF_VERTICES;
+
+#ifndef __INTELLISENSE__
+extern BLOCK01_GET_DEFAULT_NUMBER_OF_VERTICES
+    Block01GetDefaultNumberOfVertices;
+#endif
+
+//
+// Declare the Block01 graph implementation routines (GraphImplBlock01.c).
+//
+
+#ifndef __INTELLISENSE__
+extern GRAPH_ADD_KEYS GraphAddKeysBlock01;
+extern GRAPH_IS_ACYCLIC GraphIsAcyclicBlock01;
+extern GRAPH_ASSIGN GraphAssignBlock01;
+extern GRAPH_VERIFY GraphVerifyBlock01;
+#endif
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -0,0 +1,182 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    Block01Index.c
+
+Abstract:
+
+    This module implements the Index() and IndexBatch() routines for the
+    Block01 algorithm.
+
+--*/
+
+#include "stdafx.h"
+
+PERFECT_HASH_TABLE_INDEX PerfectHashTableIndexImplBlock01;
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableIndexImplBlock01(
+    PPERFECT_HASH_TABLE Table,
+    ULONG Key,
+    PULONG Index
+    )
+/*++
+
+Routine Description:
+
+    Looks up given key in a perfect hash table and returns its index.
+
+    N.B. If Key did not appear in the original set the hash table was created
+         from, the behavior of this routine is undefined.  (In practice, the
+         key will hash to some other key's index.)
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the key lookup is to be
+        performed.
+
+    Key - Supplies the key to look up.
+
+    Index - Receives the index associated with this key.  The index will be
+        between 0 and Table->IndexModulus-1 (i.e. the number of keys), and can
+        be safely used to offset directly into an appropriately sized array
+        (e.g. Table->Values[]).
+
+Return Value:
+
+    S_OK.
+
+--*/
+{
+    PULONG Seeds;
+    ULARGE_INTEGER Hash;
+
+    //
+    // Hash the incoming key into the 64-bit representation, which is two
+    // 32-bit ULONGs in disguise, each one driven by a separate seed value.
+    //
+
+    Seeds = &Table->TableInfoOnDisk->FirstSeed;
+    Hash.QuadPart = Table->Vtbl->SeededHashEx(Key, Seeds, Table->HashMask);
+
+    //
+    // Resolve the index from the key's block.
+    //
+
+    *Index = Block01IndexHash(Hash,
+                              Table->Assigned,
+                              Table->HashModulus,
+                              Table->IndexModulus);
+
+    return S_OK;
+}
+
+PERFECT_HASH_TABLE_INDEX_BATCH PerfectHashTableIndexBatchImplBlock01;
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableIndexBatchImplBlock01(
+    PPERFECT_HASH_TABLE Table,
+    ULONG NumberOfKeys,
+    PULONG Keys,
+    PULONG Indices
+    )
+/*++
+
+Routine Description:
+
+    Looks up an array of keys in a perfect hash table and returns their
+    indices.  Keys are processed in groups of
+    PERFECT_HASH_TABLE_BATCH_GROUP_SIZE; each key in a group is hashed into
+    its block, and the block's cache line (the only table data line a lookup
+    touches) is prefetched, then the group's indices are resolved.
+
+    N.B. If a key did not appear in the original set the hash table was created
+         from, the behavior of this routine is undefined for that key.
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the key lookups are to
+        be performed.
+
+    NumberOfKeys - Supplies the number of keys in the Keys array.
+
+    Keys - Supplies the base address of an array of keys to look up.
+
+    Indices - Receives the index associated with each key.
+
+Return Value:
+
+    S_OK.
+
+--*/
+{
+    ULONG Base;
+    ULONG Count;
+    ULONG Offset;
+    ULONG Slot1;
+    ULONG Slot2;
+    PULONG Seeds;
+    PULONG Block;
+    PULONG Assigned;
+    ULARGE_INTEGER Hash;
+    PVERTEX_PAIR Pair;
+    VERTEX_PAIR Pairs[PERFECT_HASH_TABLE_BATCH_GROUP_SIZE];
+
+    //
+    // Initialize aliases.
+    //
+
+    Seeds = &Table->TableInfoOnDisk->FirstSeed;
+    Assigned = Table->Assigned;
+
+    for (Base = 0; Base < NumberOfKeys; Base += Count) {
+
+        Count = min(PERFECT_HASH_TABLE_BATCH_GROUP_SIZE, NumberOfKeys - Base);
+
+        //
+        // Derive the block of each key in the group and prefetch it.
+        //
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            Pair = &Pairs[Offset];
+            Hash.QuadPart = Table->Vtbl->SeededHashEx(Keys[Base + Offset],
+                                                      Seeds,
+                                                      Table->HashMask);
+            Block01HashToBlock(Hash, Table->HashModulus, Pair);
+            PreFetchCacheLine(
+                PF_TEMPORAL_LEVEL_1,
+                &Assigned[(ULONGLONG)Pair->Vertex1 << BLOCK01_BLOCK_SHIFT]
+            );
+        }
+
+        //
+        // Resolve the indices of the group.
+        //
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            Pair = &Pairs[Offset];
+            Block = (
+                Assigned + ((ULONGLONG)Pair->Vertex1 << BLOCK01_BLOCK_SHIFT)
+            );
+
+            Block01GetSlots(Pair->Vertex2,
+                            Block[BLOCK01_BLOCK_SEED_SLOT],
+                            &Slot1,
+                            &Slot2);
+
+            Indices[Base + Offset] = Block01ReduceIndex(
+                (ULONGLONG)Block[Slot1] + (ULONGLONG)Block[Slot2],
+                Table->IndexModulus
+            );
+        }
+    }
+
+    return S_OK;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -280,6 +280,22 @@ Abstract:
           Table->AddHashedKeysElapsedCycles.QuadPart,                                        \
           OUTPUT_INT)                                                                        \
                                                                                              \
+    ENTRY(PartitionHashedKeysElapsedCycles,                                                  \
+          Table->PartitionHashedKeysElapsedCycles.QuadPart,                                  \
+          OUTPUT_INT)                                                                        \
+                                                                                             \
+    ENTRY(AssignElapsedCycles,                                                               \
+          Table->AssignElapsedCycles.QuadPart,                                               \
+          OUTPUT_INT)                                                                        \
+                                                                                             \
+    ENTRY(AssignGatherElapsedCycles,                                                         \
+          Table->AssignGatherElapsedCycles.QuadPart,                                         \
+          OUTPUT_INT)                                                                        \
+                                                                                             \
+    ENTRY(AssignWalkElapsedCycles,                                                           \
+          Table->AssignWalkElapsedCycles.QuadPart,                                           \
+          OUTPUT_INT)                                                                        \
+                                                                                             \
     ENTRY(AddKeysElapsedMicroseconds,                                                        \
           Table->AddKeysElapsedMicroseconds.QuadPart,                                        \
           OUTPUT_INT)                                                                        \
@@ -292,6 +308,22 @@ Abstract:
           Table->AddHashedKeysElapsedMicroseconds.QuadPart,                                  \
           OUTPUT_INT)                                                                        \
                                                                                              \
+    ENTRY(PartitionHashedKeysElapsedMicroseconds,                                            \
+          Table->PartitionHashedKeysElapsedMicroseconds.QuadPart,                            \
+          OUTPUT_INT)                                                                        \
+                                                                                             \
+    ENTRY(AssignElapsedMicroseconds,                                                         \
+          Table->AssignElapsedMicroseconds.QuadPart,                                         \
+          OUTPUT_INT)                                                                        \
+                                                                                             \
+    ENTRY(AssignGatherElapsedMicroseconds,                                                   \
+          Table->AssignGatherElapsedMicroseconds.QuadPart,                                   \
+          OUTPUT_INT)                                                                        \
+                                                                                             \
+    ENTRY(AssignWalkElapsedMicroseconds,                                                     \
+          Table->AssignWalkElapsedMicroseconds.QuadPart,                                     \
+          OUTPUT_INT)                                                                        \
+                                                                                             \
     ENTRY(SolveMicroseconds,                                                                 \
           Context->SolveElapsedMicroseconds.QuadPart,                                        \
           OUTPUT_INT)                                                                        \
@@ -6466,6 +6498,18 @@ Abstract:
           Context->BestGraphInfo[31].Seeds[7],                                               \
           OUTPUT_INT)                                                                        \
                                                                                              \
+    ENTRY(InterleavedTableData,                                                              \
+          (IsInterleavedTableDataLayout(Table) ? 'Y' : 'N'),                                 \
+          OUTPUT_CHR)                                                                        \
+                                                                                             \
+    ENTRY(TableDataBitsPerElement,                                                           \
+          Table->TableDataBitsPerElement,                                                    \
+          OUTPUT_INT)                                                                        \
+                                                                                             \
+    ENTRY(CacheLinesPerLookup,                                                               \
+          Table->CacheLinesPerLookup,                                                        \
+          OUTPUT_DOUBLE)                                                                     \
+                                                                                             \
     ENTRY(KeysMinValue,                                                                      \
           Keys->Stats.MinValue,                                                              \
           OUTPUT_INT)                                                                        \
@@ -81,6 +81,13 @@ Routine Description:
     Attempts to create a perfect hash table using the CHM algorithm and a
     2-part random hypergraph.
 
+    N.B. This routine is also used by the Bdz01 and Block01 algorithms (via
+         CreatePerfectHashTableImplBdz01() and
+         CreatePerfectHashTableImplBlock01()); the solving, file work and
+         verification machinery is identical, only the graph sizing
+         (PrepareGraphInfoChm01()) and graph implementation routines
+         (GraphLoadInfo()) differ.
+
 Arguments:
 
     Table - Supplies a pointer to a partially-initialized PERFECT_HASH_TABLE
@@ -328,6 +335,15 @@ Return Value:
         return PH_E_INVALID_NUMBER_OF_SEEDS;
     }
 
+    //
+    // Multiply-high masking relies on the version 3 graph assignment routine
+    // keeping each assigned value below the number of edges.
+    //
+
+    if (IsMultiplyHighMasking(MaskFunctionId) && Table->GraphImpl != 3) {
+        return PH_E_INVALID_GRAPH_IMPL;
+    }
+
     if (Context->InitialResizes > 0) {
         ULONG InitialResizes;
         ULARGE_INTEGER NumberOfEdges;
@@ -354,40 +370,91 @@ Return Value:
         NumberOfEdges.QuadPart = Table->Keys->NumberOfElements.QuadPart;
         ASSERT(NumberOfEdges.HighPart == 0);
 
-        NumberOfEdges.QuadPart = (
-            Rtl->RoundUpPowerOfTwo32(
-                NumberOfEdges.LowPart
-            )
-        );
-
-        if (NumberOfEdges.QuadPart < 8) {
-            NumberOfEdges.QuadPart = 8;
-        }
-
         //
-        // Make sure we haven't overflowed.
+        // Shard01 graphs are sized according to the largest shard.
         //
 
-        if (NumberOfEdges.HighPart) {
-            Result = PH_E_TOO_MANY_EDGES;
-            goto Error;
+        if (IsShard01(Table)) {
+            NumberOfEdges.QuadPart = Table->MaximumNumberOfKeysPerShard;
         }
 
-        //
-        // For the number of vertices, round the number of edges up to the
-        // next power of 2.
-        //
+        if (IsBdz01(Table)) {
 
-        NumberOfVertices.QuadPart = (
-            Rtl->RoundUpNextPowerOfTwo32(NumberOfEdges.LowPart)
-        );
+            //
+            // The 3-part hypergraph used by Bdz01 doesn't use power of 2
+            // sizes; the number of vertices is derived directly from the
+            // number of keys.
+            //
+
+            NumberOfVertices.QuadPart = (
+                Bdz01GetDefaultNumberOfVertices(NumberOfEdges.QuadPart)
+            );
+
+        } else if (IsBlock01(Table)) {
+
+            //
+            // Block01 sizes the table in whole blocks, based on the expected
+            // number of keys per block.
+            //
+
+            NumberOfVertices.QuadPart = (
+                Block01GetDefaultNumberOfVertices(NumberOfEdges.QuadPart)
+            );
+
+        } else if (IsMultiplyHighMasking(MaskFunctionId)) {
+
+            //
+            // Likewise for multiply-high masking.
+            //
+
+            if (NumberOfEdges.QuadPart < 8) {
+                NumberOfEdges.QuadPart = 8;
+            }
+
+            NumberOfVertices.QuadPart = (
+                Chm01MultiplyHighGetDefaultNumberOfVertices(
+                    NumberOfEdges.QuadPart
+                )
+            );
+
+        } else {
+
+            NumberOfEdges.QuadPart = (
+                Rtl->RoundUpPowerOfTwo32(
+                    NumberOfEdges.LowPart
+                )
+            );
+
+            if (NumberOfEdges.QuadPart < 8) {
+                NumberOfEdges.QuadPart = 8;
+            }
+
+            //
+            // Make sure we haven't overflowed.
+            //
+
+            if (NumberOfEdges.HighPart) {
+                Result = PH_E_TOO_MANY_EDGES;
+                goto Error;
+            }
+
+            //
+            // For the number of vertices, round the number of edges up to the
+            // next power of 2.
+            //
+
+            NumberOfVertices.QuadPart = (
+                Rtl->RoundUpNextPowerOfTwo32(NumberOfEdges.LowPart)
+            );
+        }
 
         Table->RequestedNumberOfTableElements.QuadPart = (
             NumberOfVertices.QuadPart
         );
 
         //
-        // Keep doubling the number of vertices for each requested resize,
+        // Keep doubling the number of vertices for each requested resize (or
+        // growing them by 1/8th for Bdz01, Block01 and multiply-high masking),
         // or until we exceed MAX_ULONG, whatever comes first.
         //
 
@@ -395,7 +462,27 @@ Return Value:
              InitialResizes > 0;
              InitialResizes--) {
 
-            Table->RequestedNumberOfTableElements.QuadPart <<= 1ULL;
+            if (IsBdz01(Table)) {
+                Table->RequestedNumberOfTableElements.QuadPart = (
+                    Bdz01GrowNumberOfVertices(
+                        Table->RequestedNumberOfTableElements.QuadPart
+                    )
+                );
+            } else if (IsBlock01(Table)) {
+                Table->RequestedNumberOfTableElements.QuadPart = (
+                    Block01GrowNumberOfVertices(
+                        Table->RequestedNumberOfTableElements.QuadPart
+                    )
+                );
+            } else if (IsMultiplyHighMasking(MaskFunctionId)) {
+                Table->RequestedNumberOfTableElements.QuadPart = (
+                    Chm01MultiplyHighGrowNumberOfVertices(
+                        Table->RequestedNumberOfTableElements.QuadPart
+                    )
+                );
+            } else {
+                Table->RequestedNumberOfTableElements.QuadPart <<= 1ULL;
+            }
 
             if (Table->RequestedNumberOfTableElements.HighPart) {
                 Result = PH_I_REQUESTED_NUMBER_OF_TABLE_ELEMENTS_TOO_LARGE;
@@ -917,14 +1004,35 @@ RetryWithLargerTableSize:
         Context->HighestDeletedEdgesCount = 0;
 
         //
-        // Double the vertex count.  If we have overflowed max ULONG, abort.
+        // Double the vertex count (or grow it by 1/8th for Bdz01, Block01 and
+        // multiply-high masking).  If we have overflowed max ULONG, abort.
         //
 
         Table->RequestedNumberOfTableElements.QuadPart = (
             Info.Dimensions.NumberOfVertices
         );
 
-        Table->RequestedNumberOfTableElements.QuadPart <<= 1ULL;
+        if (IsBdz01(Table)) {
+            Table->RequestedNumberOfTableElements.QuadPart = (
+                Bdz01GrowNumberOfVertices(
+                    Table->RequestedNumberOfTableElements.QuadPart
+                )
+            );
+        } else if (IsBlock01(Table)) {
+            Table->RequestedNumberOfTableElements.QuadPart = (
+                Block01GrowNumberOfVertices(
+                    Table->RequestedNumberOfTableElements.QuadPart
+                )
+            );
+        } else if (IsMultiplyHighMasking(MaskFunctionId)) {
+            Table->RequestedNumberOfTableElements.QuadPart = (
+                Chm01MultiplyHighGrowNumberOfVertices(
+                    Table->RequestedNumberOfTableElements.QuadPart
+                )
+            );
+        } else {
+            Table->RequestedNumberOfTableElements.QuadPart <<= 1ULL;
+        }
 
         if (Table->RequestedNumberOfTableElements.HighPart) {
             Result = PH_I_REQUESTED_NUMBER_OF_TABLE_ELEMENTS_TOO_LARGE;
@@ -1136,6 +1244,36 @@ FinishedSolution:
         goto Error;
     }
 
+    //
+    // If the table has fingerprints, allocate the fingerprints array.  It is
+    // populated by the graph verification step below; the table file's save
+    // file work waits for verification to complete before writing it out.
+    //
+
+    if (HasFingerprints(Table)) {
+
+        if (Table->Fingerprints) {
+            Result = PH_E_INVARIANT_CHECK_FAILED;
+            PH_ERROR(CreatePerfectHashTableImplChm01_Fingerprints, Result);
+            goto Error;
+        }
+
+        Table->Fingerprints = (
+            Allocator->Vtbl->Calloc(
+                Allocator,
+                (SIZE_T)TableInfoOnDisk->NumberOfTableElements.QuadPart,
+                Table->FingerprintSizeInBytes
+            )
+        );
+
+        if (!Table->Fingerprints) {
+            Result = E_OUTOFMEMORY;
+            goto Error;
+        }
+
+        Table->State.FingerprintsWereHeapAllocated = TRUE;
+    }
+
     //
     // Note this graph as the one solved to the context.  This is used by the
     // save file work callback we dispatch below.
@@ -1247,10 +1385,7 @@ FinishedSolution:
                 Table->TableCreateFlags.TryLargePagesForTableData == TRUE
             );
 
-            SizeInBytes = (
-                TableInfoOnDisk->NumberOfTableElements.QuadPart *
-                TableInfoOnDisk->KeySizeInBytes
-            );
+            SizeInBytes = GetTableDataSizeInBytes(TableInfoOnDisk);
 
             TryLargePageVirtualAlloc = Rtl->Vtbl->TryLargePageVirtualAlloc;
             BaseAddress = TryLargePageVirtualAlloc(Rtl,
@@ -1283,9 +1418,21 @@ FinishedSolution:
             // Copy the table data over to the newly allocated buffer.
             //
 
-            CopyMemory(Table->TableDataBaseAddress,
-                       Graph->Assigned,
-                       SizeInBytes);
+            if (IsShard01(Table)) {
+                CopyShardTableDataShard01(Table,
+                                          Table->TableDataBaseAddress,
+                                          SizeInBytes);
+            } else if (IsPackedTableDataLayout(Table)) {
+                PackTableData(Graph->Assigned,
+                              TableInfoOnDisk->NumberOfTableElements.QuadPart,
+                              Table->TableDataBitsPerElement,
+                              (PULONGLONG)Table->TableDataBaseAddress,
+                              SizeInBytes);
+            } else {
+                CopyMemory(Table->TableDataBaseAddress,
+                           Graph->Assigned,
+                           SizeInBytes);
+            }
 
         }
 
@@ -1590,6 +1737,7 @@ Return Value:
     ULARGE_INTEGER AllocSize;
     ULARGE_INTEGER NumberOfEdges;
     ULARGE_INTEGER NumberOfVertices;
+    ULARGE_INTEGER PartitionSize;
     ULARGE_INTEGER TotalNumberOfEdges;
     ULARGE_INTEGER DeletedEdgesBitmapBufferSizeInBytes;
     ULARGE_INTEGER VisitedVerticesBitmapBufferSizeInBytes;
@@ -1632,6 +1780,7 @@ Return Value:
     RoundUpPowerOfTwo32 = Rtl->RoundUpPowerOfTwo32;
     RoundUpNextPowerOfTwo32 = Rtl->RoundUpNextPowerOfTwo32;
     TableCreateFlags.AsULong = Table->TableCreateFlags.AsULong;
+    PartitionSize.QuadPart = 0;
 
     //
     // If a previous Info struct pointer has been passed, copy the current
@@ -1660,6 +1809,15 @@ Return Value:
 
     NumberOfKeys = Table->Keys->NumberOfElements.LowPart;
 
+    //
+    // Each Shard01 graph only ever holds a single shard's keys, so size the
+    // graph for the largest shard.
+    //
+
+    if (IsShard01(Table)) {
+        NumberOfKeys = Table->MaximumNumberOfKeysPerShard;
+    }
+
     //
     // The number of edges in our graph is equal to the number of keys in the
     // input data set if modulus masking is in use.  It will be rounded up to
@@ -1685,7 +1843,85 @@ Return Value:
     // precedence.  Otherwise, determine the vertices heuristically.
     //
 
-    if (Table->RequestedNumberOfTableElements.QuadPart) {
+    if (IsBdz01(Table)) {
+
+        //
+        // The Bdz01 algorithm uses a 3-part hypergraph where the number of
+        // edges is exactly the number of keys (the index is reduced modulo
+        // the number of keys, not masked), and the vertices are split into
+        // three equally-sized partitions, the total of which is ~1.23 times
+        // the number of keys.  Neither value is rounded up to a power of 2.
+        //
+
+        NumberOfEdges.QuadPart = NumberOfKeys;
+
+        if (Table->RequestedNumberOfTableElements.QuadPart) {
+            NumberOfVertices.QuadPart = (
+                Table->RequestedNumberOfTableElements.QuadPart
+            );
+        } else {
+            NumberOfVertices.QuadPart = (
+                Bdz01GetDefaultNumberOfVertices(NumberOfKeys)
+            );
+        }
+
+        PartitionSize.QuadPart = (
+            (NumberOfVertices.QuadPart + (BDZ01_NUMBER_OF_PARTITIONS - 1)) /
+            BDZ01_NUMBER_OF_PARTITIONS
+        );
+
+        if (PartitionSize.QuadPart < BDZ01_MINIMUM_PARTITION_SIZE) {
+            PartitionSize.QuadPart = BDZ01_MINIMUM_PARTITION_SIZE;
+        }
+
+        NumberOfVertices.QuadPart = (
+            PartitionSize.QuadPart * BDZ01_NUMBER_OF_PARTITIONS
+        );
+
+    } else if (IsBlock01(Table)) {
+
+        //
+        // As with Bdz01, the number of edges is exactly the number of keys.
+        // The number of vertices is always a whole number of blocks (sixteen
+        // table data elements per block, fifteen of which are vertices).
+        //
+
+        NumberOfEdges.QuadPart = NumberOfKeys;
+
+        if (Table->RequestedNumberOfTableElements.QuadPart) {
+            NumberOfVertices.QuadPart = (
+                Block01RoundUpNumberOfVertices(
+                    Table->RequestedNumberOfTableElements.QuadPart
+                )
+            );
+        } else {
+            NumberOfVertices.QuadPart = (
+                Block01GetDefaultNumberOfVertices(NumberOfKeys)
+            );
+        }
+
+    } else if (IsMultiplyHighMasking(MaskFunctionId)) {
+
+        //
+        // Multiply-high masking range-reduces vertices and indices directly,
+        // so neither the number of edges nor vertices are rounded up to a
+        // power of 2.  The number of edges stays at the number of keys (or
+        // 8, per above), which yields the minimal index range.
+        //
+
+        if (Table->RequestedNumberOfTableElements.QuadPart) {
+            NumberOfVertices.QuadPart = (
+                Table->RequestedNumberOfTableElements.QuadPart
+            );
+        } else {
+            NumberOfVertices.QuadPart = (
+                Chm01MultiplyHighGetDefaultNumberOfVertices(
+                    NumberOfEdges.QuadPart
+                )
+            );
+        }
+
+    } else if (Table->RequestedNumberOfTableElements.QuadPart) {
 
         NumberOfVertices.QuadPart = (
             Table->RequestedNumberOfTableElements.QuadPart
@@ -1822,10 +2058,16 @@ Return Value:
     // The r-graph (r = 2) nature of this implementation results in various
     // arrays having twice the number of elements indicated by the edge count.
     // Capture this number now, as we need it in various size calculations.
+    // (For Bdz01, r = 3.)
     //
 
     TotalNumberOfEdges.QuadPart = NumberOfEdges.QuadPart;
-    TotalNumberOfEdges.QuadPart <<= 1ULL;
+
+    if (IsBdz01(Table)) {
+        TotalNumberOfEdges.QuadPart *= BDZ01_NUMBER_OF_PARTITIONS;
+    } else {
+        TotalNumberOfEdges.QuadPart <<= 1ULL;
+    }
 
     //
     // Another overflow sanity check.
@@ -1850,6 +2092,9 @@ Return Value:
     //
 
     if ((!IsModulusMasking(MaskFunctionId)) &&
+        (!IsMultiplyHighMasking(MaskFunctionId)) &&
+        (!IsBdz01(Table)) &&
+        (!IsBlock01(Table)) &&
         (Table->TableCreateFlags.ClampNumberOfEdges == FALSE)) {
 
         if ((NumberOfVertices.QuadPart >> 1) != NumberOfEdges.QuadPart) {
@@ -1939,15 +2184,31 @@ Return Value:
         NextSizeInBytes = 0;
         FirstSizeInBytes = 0;
 
-        VertexPairsSizeInBytes = ALIGN_UP_YMMWORD(
-            RTL_ELEMENT_SIZE(GRAPH, Edges3) * NumberOfEdges.QuadPart
-        );
+        if (IsBdz01(Table)) {
+            VertexPairsSizeInBytes = ALIGN_UP_YMMWORD(
+                RTL_ELEMENT_SIZE(GRAPH, VertexTriples) *
+                NumberOfEdges.QuadPart
+            );
+        } else {
+            VertexPairsSizeInBytes = ALIGN_UP_YMMWORD(
+                RTL_ELEMENT_SIZE(GRAPH, Edges3) * NumberOfEdges.QuadPart
+            );
+        }
 
         Vertices3SizeInBytes = ALIGN_UP_YMMWORD(
             RTL_ELEMENT_SIZE(GRAPH, Vertices3) * NumberOfVertices.QuadPart
         );
 
-        DeletedEdgesBitmapBufferSizeInBytes.QuadPart = 0;
+        //
+        // Graph impl 3 doesn't use the deleted edges bitmap, unless edges are
+        // being peeled in parallel, in which case it's used to claim edges.
+        //
+
+        if (TableCreateFlags.ParallelPeeling == FALSE ||
+            IsBdz01(Table) ||
+            IsBlock01(Table)) {
+            DeletedEdgesBitmapBufferSizeInBytes.QuadPart = 0;
+        }
     }
 
     OrderSizeInBytes = ALIGN_UP_YMMWORD(
@@ -2143,7 +2404,80 @@ Return Value:
     // and underlying table data type.
     //
 
-    if (!IsModulusMasking(MaskFunctionId)) {
+    if (IsBdz01(Table)) {
+
+        ULONG_PTR EdgeValue;
+
+        //
+        // Bdz01 doesn't use masking for either vertices or the final index.
+        // The assigned values will always be less than the number of keys,
+        // so the containing type is derived from that (rounded up to a power
+        // of 2, as required by GetContainingType()).
+        //
+
+        Info->EdgeMask = RoundUpPowerOfTwo32(NumberOfKeys) - 1;
+        Info->VertexMask = BDZ01_HASH_MASK;
+
+        EdgeValue = (ULONG_PTR)RoundUpPowerOfTwo32(NumberOfKeys);
+        Result = GetContainingType(Rtl, EdgeValue, &Table->TableDataArrayType);
+        if (FAILED(Result)) {
+            PH_ERROR(PrepareGraphInfoBdz01_GetContainingType, Result);
+            goto Error;
+        }
+
+        Table->TableDataArrayTypeName = &TypeNames[Table->TableDataArrayType];
+
+        Table->ValueType = LongType;
+        Table->TableValuesArrayTypeName = &TypeNames[LongType];
+        Table->KeysArrayTypeName = &TypeNames[LongType];
+
+    } else if (IsBlock01(Table)) {
+
+        //
+        // As with Bdz01, there are no masks per se.  The table data type is
+        // always ULONG, though, as each block's seed is stored alongside its
+        // assigned values.
+        //
+
+        Info->EdgeMask = RoundUpPowerOfTwo32(NumberOfKeys) - 1;
+        Info->VertexMask = BLOCK01_HASH_MASK;
+
+        Table->TableDataArrayType = LongType;
+        Table->TableDataArrayTypeName = &TypeNames[LongType];
+
+        Table->ValueType = LongType;
+        Table->TableValuesArrayTypeName = &TypeNames[LongType];
+        Table->KeysArrayTypeName = &TypeNames[LongType];
+
+    } else if (IsMultiplyHighMasking(MaskFunctionId)) {
+
+        ULONG_PTR EdgeValue;
+
+        //
+        // As with Bdz01, there are no masks per se.  The assigned values will
+        // always be less than the number of edges, so the containing type is
+        // derived from that (rounded up to a power of 2, as required by
+        // GetContainingType()).
+        //
+
+        Info->EdgeMask = MULTIPLY_HIGH_MASK;
+        Info->VertexMask = MULTIPLY_HIGH_MASK;
+
+        EdgeValue = (ULONG_PTR)RoundUpPowerOfTwo32(NumberOfEdges.LowPart);
+        Result = GetContainingType(Rtl, EdgeValue, &Table->TableDataArrayType);
+        if (FAILED(Result)) {
+            PH_ERROR(PrepareGraphInfoChm01_MultiplyHighGetContainingType,
+                     Result);
+            goto Error;
+        }
+
+        Table->TableDataArrayTypeName = &TypeNames[Table->TableDataArrayType];
+
+        Table->ValueType = LongType;
+        Table->TableValuesArrayTypeName = &TypeNames[LongType];
+        Table->KeysArrayTypeName = &TypeNames[LongType];
+
+    } else if (!IsModulusMasking(MaskFunctionId)) {
 
         ULONG_PTR EdgeValue;
 
@@ -2182,8 +2516,15 @@ Return Value:
         // common enough (based on the typical number of keys we're targeting)
         // to warrant this logic.
         //
+        // N.B. With the interleaved table data layout, assigned values are
+        //      vertices rather than edges, so the vertex mask bits are used.
+        //
 
-        EdgeValue = (ULONG_PTR)1 << NumberOfEdgeMaskBits;
+        if (IsInterleavedTableDataLayout(Table)) {
+            EdgeValue = (ULONG_PTR)1 << NumberOfVertexMaskBits;
+        } else {
+            EdgeValue = (ULONG_PTR)1 << NumberOfEdgeMaskBits;
+        }
         Result = GetContainingType(Rtl, EdgeValue, &Table->TableDataArrayType);
         if (FAILED(Result)) {
             PH_ERROR(PrepareGraphInfoChm01_GetContainingType, Result);
@@ -2192,6 +2533,18 @@ Return Value:
 
         Table->TableDataArrayTypeName = &TypeNames[Table->TableDataArrayType];
 
+        //
+        // With the packed table data layout, each table data element is
+        // stored in exactly as many bits as there are in the edge mask.
+        //
+
+        if (IsPackedTableDataLayout(Table)) {
+            Table->TableDataBitsPerElement = max(
+                NumberOfEdgeMaskBits,
+                PACKED_TABLE_DATA_MINIMUM_BITS_PER_ELEMENT
+            );
+        }
+
         //
         // Default the table values type name to ULONG for now until we add
         // more comprehensive support for varying the type name (i.e. wire up
@@ -2221,6 +2574,12 @@ Return Value:
     Table->OriginalKeySizeTypeName =
         &TypeNames[Table->Keys->OriginalKeySizeType];
 
+    if (HasFingerprints(Table)) {
+        Table->FingerprintTypeName = &TypeNames[
+            Table->FingerprintSizeInBytes == sizeof(BYTE) ? ByteType : ShortType
+        ];
+    }
+
     //
     // Set the Modulus, Size, Shift, Mask and Fold fields of the table, such
     // that the Hash and Mask vtbl functions operate correctly.
@@ -2231,16 +2590,95 @@ Return Value:
     //      in LoadPerfectHashTableImplChm01() too.
     //
 
-    Table->HashModulus = NumberOfVertices.LowPart;
-    Table->IndexModulus = NumberOfEdges.LowPart;
-    Table->HashSize = NumberOfVertices.LowPart;
-    Table->IndexSize = NumberOfEdges.LowPart;
-    Table->HashShift = Rtl->TrailingZeros32(Table->HashSize);
-    Table->IndexShift = Rtl->TrailingZeros32(Table->IndexSize);
-    Table->HashMask = (Table->HashSize - 1);
-    Table->IndexMask = (Table->IndexSize - 1);
-    Table->HashFold = Table->HashShift >> 3;
-    Table->IndexFold = Table->IndexShift >> 3;
+    if (IsBdz01(Table)) {
+
+        //
+        // For Bdz01, the hash modulus captures the partition size (used to
+        // range-reduce each of the three hash values into its partition), and
+        // the index modulus captures the number of keys.  The hash mask is
+        // all ones (the seeded hash routines' output is used in full), and
+        // the index mask is informational only.
+        //
+
+        Table->HashModulus = PartitionSize.LowPart;
+        Table->IndexModulus = NumberOfKeys;
+        Table->HashSize = NumberOfVertices.LowPart;
+        Table->IndexSize = NumberOfKeys;
+        Table->HashShift = 0;
+        Table->IndexShift = 0;
+        Table->HashMask = BDZ01_HASH_MASK;
+        Table->IndexMask = Info->EdgeMask;
+        Table->HashFold = 0;
+        Table->IndexFold = 0;
+
+    } else if (IsBlock01(Table)) {
+
+        //
+        // For Block01, the hash modulus captures the number of blocks (used
+        // to range-reduce the first hash value into a block), and the index
+        // modulus captures the number of keys.  As with Bdz01, the hash mask
+        // is all ones, and the index mask is informational only.
+        //
+
+        Table->HashModulus = (ULONG)(
+            NumberOfVertices.QuadPart >> BLOCK01_BLOCK_SHIFT
+        );
+        Table->IndexModulus = NumberOfKeys;
+        Table->HashSize = NumberOfVertices.LowPart;
+        Table->IndexSize = NumberOfKeys;
+        Table->HashShift = 0;
+        Table->IndexShift = 0;
+        Table->HashMask = BLOCK01_HASH_MASK;
+        Table->IndexMask = Info->EdgeMask;
+        Table->HashFold = 0;
+        Table->IndexFold = 0;
+
+    } else if (IsMultiplyHighMasking(MaskFunctionId)) {
+
+        //
+        // The hash and index modulus capture the ranges the vertices and the
+        // final index are reduced into, respectively.  Shift, mask and fold
+        // don't apply.
+        //
+
+        Table->HashModulus = NumberOfVertices.LowPart;
+        Table->IndexModulus = NumberOfEdges.LowPart;
+        Table->HashSize = NumberOfVertices.LowPart;
+        Table->IndexSize = NumberOfEdges.LowPart;
+        Table->HashShift = 0;
+        Table->IndexShift = 0;
+        Table->HashMask = MULTIPLY_HIGH_MASK;
+        Table->IndexMask = MULTIPLY_HIGH_MASK;
+        Table->HashFold = 0;
+        Table->IndexFold = 0;
+
+    } else {
+
+        Table->HashModulus = NumberOfVertices.LowPart;
+        Table->IndexModulus = NumberOfEdges.LowPart;
+        Table->HashSize = NumberOfVertices.LowPart;
+        Table->IndexSize = NumberOfEdges.LowPart;
+        Table->HashShift = Rtl->TrailingZeros32(Table->HashSize);
+        Table->IndexShift = Rtl->TrailingZeros32(Table->IndexSize);
+        Table->HashMask = (Table->HashSize - 1);
+        Table->IndexMask = (Table->IndexSize - 1);
+        Table->HashFold = Table->HashShift >> 3;
+        Table->IndexFold = Table->IndexShift >> 3;
+
+        //
+        // With the interleaved table data layout, the index is the vertex the
+        // key's value was assigned to, so it is masked by the hash mask.  The
+        // index size is left as the number of edges, as it is reported as such
+        // in the CSV output.
+        //
+
+        if (IsInterleavedTableDataLayout(Table)) {
+            Table->IndexShift = Table->HashShift;
+            Table->IndexMask = Table->HashMask;
+            Table->IndexFold = Table->HashFold;
+            Table->IndexModulus = Table->HashModulus;
+        }
+    }
 
     //
     // Fill out the in-memory representation of the on-disk table/graph info.
@@ -2279,6 +2717,32 @@ Return Value:
     TableInfoOnDisk->NumberOfSeeds = (
         HashRoutineNumberOfSeeds[Table->HashFunctionId]
     );
+    TableInfoOnDisk->FingerprintSizeInBytes = Table->FingerprintSizeInBytes;
+    TableInfoOnDisk->Flags.InterleavedTableData = (
+        IsInterleavedTableDataLayout(Table) != FALSE
+    );
+    TableInfoOnDisk->Flags.OrderPreserving = (
+        IsOrderPreserving(Table) != FALSE
+    );
+    TableInfoOnDisk->Flags.PackedTableData = (
+        IsPackedTableDataLayout(Table) != FALSE
+    );
+    TableInfoOnDisk->TableDataBitsPerElement = Table->TableDataBitsPerElement;
+    if (KeysAreStrings(Table->Keys)) {
+        TableInfoOnDisk->Flags.StringKeys = TRUE;
+        TableInfoOnDisk->ReducedKeySeed = Table->Keys->ReducedKeySeed;
+        TableInfoOnDisk->StringKeyDataSizeInBytes = (
+            Table->Keys->StringKeyDataSizeInBytes
+        );
+    } else if (KeysAre128Bit(Table->Keys)) {
+        TableInfoOnDisk->Flags.Keys128 = TRUE;
+        TableInfoOnDisk->ReducedKeySeed = Table->Keys->ReducedKeySeed;
+    } else if (KeysWereProjected(Table->Keys)) {
+        TableInfoOnDisk->Flags.KeysProjected = TRUE;
+        TableInfoOnDisk->KeyProjectionMultiplier = (
+            Table->Keys->ProjectionMultiplier
+        );
+    }
 
     //
     // This will change based on masking type and whether or not the caller
@@ -2292,6 +2756,27 @@ Return Value:
 
     CopyInline(&GraphInfoOnDisk->Dimensions, Dim, sizeof(*Dim));
 
+    //
+    // Shard01 table data is composed of the shard directory followed by each
+    // shard's assigned array; adjust the number of table elements to reflect
+    // this, then prepare the shard state for solving.
+    //
+
+    if (IsShard01(Table)) {
+
+        TableInfoOnDisk->NumberOfShards = Table->NumberOfShards;
+        TableInfoOnDisk->NumberOfTableElements.QuadPart = (
+            Shard01GetNumberOfTableElements(Table->NumberOfShards,
+                                            NumberOfVertices.LowPart)
+        );
+
+        Result = PrepareShardsShard01(Table, NumberOfVertices.LowPart);
+        if (FAILED(Result)) {
+            PH_ERROR(PrepareGraphInfoChm01_PrepareShards, Result);
+            goto Error;
+        }
+    }
+
     //
     // We're done, finish up.
     //
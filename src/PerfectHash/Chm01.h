@@ -66,6 +66,45 @@ extern PREPARE_FILE PrepareFileChm01;
 extern UNMAP_FILE UnmapFileChm01;
 extern CLOSE_FILE CloseFileChm01;
 
+//
+// Multiply-high masking doesn't require power of 2 sizes.  The number of edges
+// is the number of keys, and the default number of vertices is the number of
+// edges * (2 + 1/8), which is just above the c > 2 ratio required for random
+// 2-graphs to be acyclic with a reasonable probability (the CHM paper uses
+// 2.09).  Each table resize event grows the number of vertices by 1/8th,
+// versus the doubling employed by AND masking.
+//
+
+#define CHM01_MULTIPLY_HIGH_VERTICES_SHIFT 3
+#define CHM01_MULTIPLY_HIGH_RESIZE_SHIFT 3
+
+FORCEINLINE
+ULONGLONG
+Chm01MultiplyHighGetDefaultNumberOfVertices(
+    _In_ ULONGLONG NumberOfEdges
+    )
+{
+    ULONGLONG NumberOfVertices;
+
+    NumberOfVertices = (NumberOfEdges << 1) + (
+        (NumberOfEdges + ((1ULL << CHM01_MULTIPLY_HIGH_VERTICES_SHIFT) - 1)) >>
+        CHM01_MULTIPLY_HIGH_VERTICES_SHIFT
+    );
+
+    return NumberOfVertices;
+}
+
+FORCEINLINE
+ULONGLONG
+Chm01MultiplyHighGrowNumberOfVertices(
+    _In_ ULONGLONG NumberOfVertices
+    )
+{
+    return NumberOfVertices + (
+        NumberOfVertices >> CHM01_MULTIPLY_HIGH_RESIZE_SHIFT
+    );
+}
+
 //
 // Helper macro for adding a 4-space indent to the output stream.
 //
@@ -324,6 +324,25 @@ Return Value:
 
             case EofInitTypeAssignedSize:
                 EndOfFile.QuadPart = Info->AssignedSizeInBytes;
+
+                //
+                // Shard01 table data spans the shard directory and every
+                // shard's assigned array, not just a single graph's.  Packed
+                // table data is smaller than the assigned array.
+                //
+
+                if (IsShard01(Table) || IsPackedTableDataLayout(Table)) {
+                    EndOfFile.QuadPart = GetTableDataSizeInBytes(TableInfo);
+                }
+
+                //
+                // If the table has fingerprints, they follow the table data.
+                //
+
+                EndOfFile.QuadPart += (
+                    NumberOfTableElements.QuadPart *
+                    TableInfo->FingerprintSizeInBytes
+                );
                 break;
 
             case EofInitTypeFixed:
@@ -335,6 +354,29 @@ Return Value:
                     (LONGLONG)Keys->NumberOfElements.QuadPart *
                     Eof->Multiplier
                 );
+
+                //
+                // String keys also emit the string offsets and data arrays.
+                //
+
+                if (KeysAreStrings(Keys)) {
+                    EndOfFile.QuadPart += (
+                        ((LONGLONG)Keys->NumberOfElements.QuadPart + 1 +
+                         Keys->StringKeyDataSizeInBytes) *
+                        Eof->Multiplier
+                    );
+                }
+
+                //
+                // 128-bit keys are emitted as two 64-bit hex values each.
+                //
+
+                if (KeysAre128Bit(Keys)) {
+                    EndOfFile.QuadPart += (
+                        (LONGLONG)Keys->NumberOfElements.QuadPart *
+                        Eof->Multiplier
+                    );
+                }
                 break;
 
             case EofInitTypeNumberOfTableElementsMultiplier:
@@ -342,6 +384,30 @@ Return Value:
                     NumberOfTableElements.QuadPart *
                     Eof->Multiplier
                 );
+
+                //
+                // If the table has fingerprints, the C source table data file
+                // also includes a fingerprints array of the same dimensions.
+                //
+
+                if (TableInfo->FingerprintSizeInBytes) {
+                    EndOfFile.QuadPart += (
+                        NumberOfTableElements.QuadPart *
+                        Eof->Multiplier
+                    );
+                }
+
+                //
+                // Interleaved table data slots include a value initializer
+                // alongside each element, so reserve space for that, too.
+                //
+
+                if (TableInfo->Flags.InterleavedTableData != FALSE) {
+                    EndOfFile.QuadPart += (
+                        NumberOfTableElements.QuadPart *
+                        Eof->Multiplier
+                    );
+                }
                 break;
 
             case EofInitTypeNumberOfPages:
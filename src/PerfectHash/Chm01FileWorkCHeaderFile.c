@@ -29,7 +29,11 @@ Abstract:
             - T##_IndexMask
             - T##_TableData
             - T##_TableValues
+            - T##_TableFingerprints (if applicable)
             - T##_NumberOfKeys
+            - T##_StringKeyOffsets (if applicable)
+            - T##_StringKeyData (if applicable)
+            - U##_STRING_KEY_SEED (if applicable)
 
         - #include <CompiledPerfectHashMacroGlue.h>
 
@@ -50,6 +54,7 @@ Abstract:
         - Contents of ../CompiledPerfectHashTableRoutinesPost.c
 
         - DEFINE_TABLE_ROUTINES();
+          DEFINE_STRING_TABLE_ROUTINES(); (if applicable)
           DEFINE_TEST_AND_BENCHMARK_ROUTINES();
 
 --*/
@@ -80,6 +85,9 @@ PrepareCHeaderFileChm01(
     PPERFECT_HASH_FILE File;
     PPERFECT_HASH_TABLE Table;
     PTABLE_INFO_ON_DISK TableInfoOnDisk;
+    BOOLEAN UsePextFallback;
+    PKEY_DOWNSIZE_RUN Run;
+    KEY_DOWNSIZE_RUNS DownsizeRuns;
 
     //
     // Initialize aliases.
@@ -142,13 +150,37 @@ PrepareCHeaderFileChm01(
     OUTPUT_STRING(Name);
     OUTPUT_RAW("_HashMask;\nextern const CPHDKEY ");
     OUTPUT_STRING(Name);
-    OUTPUT_RAW("_IndexMask;\n\nextern const ");
-    OUTPUT_STRING(Table->TableDataArrayTypeName);
-    OUTPUT_RAW(" ");
-    OUTPUT_STRING(Name);
-    OUTPUT_RAW("_TableData[];\nextern CPHVALUE ");
-    OUTPUT_STRING(Name);
-    OUTPUT_RAW("_TableValues[];\n\n");
+    OUTPUT_RAW("_IndexMask;\n\n");
+
+    if (IsInterleavedTableDataLayout(Table)) {
+        OUTPUT_RAW("extern CPHSLOT ");
+        OUTPUT_STRING(Name);
+        OUTPUT_RAW("_TableSlots[];\n\n");
+    } else {
+        OUTPUT_RAW("extern const ");
+        if (IsPackedTableDataLayout(Table)) {
+            OUTPUT_RAW("ULONGLONG");
+        } else {
+            OUTPUT_STRING(Table->TableDataArrayTypeName);
+        }
+        OUTPUT_RAW(" ");
+        OUTPUT_STRING(Name);
+        OUTPUT_RAW("_TableData[];\nextern CPHVALUE ");
+        OUTPUT_STRING(Name);
+        OUTPUT_RAW("_TableValues[];\n\n");
+    }
+
+    if (IsShard01(Table)) {
+        OUTPUT_RAW("extern const CPHSEED ");
+        OUTPUT_STRING(Name);
+        OUTPUT_RAW("_TableShards[];\n\n");
+    }
+
+    if (HasFingerprints(Table)) {
+        OUTPUT_RAW("extern const CPHFINGERPRINT ");
+        OUTPUT_STRING(Name);
+        OUTPUT_RAW("_TableFingerprints[];\n\n");
+    }
 
     OUTPUT_RAW("extern const CPHKEY ");
     OUTPUT_STRING(Name);
@@ -161,20 +193,116 @@ PrepareCHeaderFileChm01(
     OUTPUT_RAW("_NumberOfKeys;\n\n");
 
     //
-    // If key downsizing has occurred, output the bitmap that was used.
+    // If the keys are strings, output the string key arrays and the seed used
+    // to reduce each string to a key.
     //
 
-    if (KeysWereDownsized(Keys)) {
+    if (KeysAreStrings(Keys)) {
+        OUTPUT_RAW("extern const ULONG ");
+        OUTPUT_STRING(Name);
+        OUTPUT_RAW("_StringKeyOffsets[];\nextern const BYTE ");
+        OUTPUT_STRING(Name);
+        OUTPUT_RAW("_StringKeyData[];\n\n#define ");
+        OUTPUT_STRING(Upper);
+        OUTPUT_RAW("_STRING_KEY_SEED 0x");
+        OUTPUT_HEX_RAW(Keys->ReducedKeySeed);
+        OUTPUT_RAW("\n\n");
+    }
+
+    //
+    // If key downsizing has occurred via projection, output the multiplier
+    // that was used.  Otherwise, if key downsizing has occurred, output the
+    // bitmap that was used.
+    //
+
+    if (KeysWereProjected(Keys)) {
+
+        OUTPUT_RAW("#define ");
+        OUTPUT_STRING(Upper);
+        OUTPUT_RAW("_KEY_PROJECTION_MULTIPLIER 0x");
+        OUTPUT_HEX64_RAW(Keys->ProjectionMultiplier);
+        OUTPUT_RAW("ULL\n#define ");
+        OUTPUT_STRING(Upper);
+        OUTPUT_RAW("_DOWNSIZE_KEY(Key) \\\n    "
+                   "((CPHDKEY)(((ULONGLONG)(Key) * 0x");
+        OUTPUT_HEX64_RAW(Keys->ProjectionMultiplier);
+        OUTPUT_RAW("ULL) >> 32))\n");
+
+        //
+        // Write the left and right key rotation macros.
+        //
+
+        OUTPUT_RAW("#define ");
+        OUTPUT_STRING(Upper);
+        OUTPUT_RAW("_ROTATE_KEY_LEFT _rotl64\n");
+
+        OUTPUT_RAW("#define ");
+        OUTPUT_STRING(Upper);
+        OUTPUT_RAW("_ROTATE_KEY_RIGHT _rotr64\n\n");
+
+    } else if (KeysWereDownsized(Keys)) {
 
         OUTPUT_RAW("#define ");
         OUTPUT_STRING(Upper);
         OUTPUT_RAW("_KEY_DOWNSIZE_BITMAP 0x");
         OUTPUT_HEX64_RAW(Keys->DownsizeBitmap);
-        OUTPUT_RAW("\n#define ");
+        OUTPUT_RAW("\n");
+
+        //
+        // Write the key downsize macro as the equivalent shift-and-mask
+        // sequence for each run of set bits in the bitmap (see
+        // KeyDownsizing.h).  If there are more runs than we're willing to
+        // inline, and _pext_u64() was fast on the CPU the table was created
+        // on, prefer _pext_u64(), and only use the sequence as a fallback
+        // when _pext_u64() isn't available or CPH_AVOID_PEXT is defined.  If
+        // _pext_u64() wasn't fast (e.g. an AMD part prior to Zen 3, where it
+        // is microcoded), the sequence is used unconditionally.
+        //
+
+        GetKeyDownsizeRuns(Rtl, Keys->DownsizeBitmap, &DownsizeRuns);
+
+        UsePextFallback = (
+            DownsizeRuns.NumberOfRuns > KEY_DOWNSIZE_MAXIMUM_INLINE_RUNS &&
+            Rtl->CpuFeatures.Derived.FastPext != FALSE
+        );
+
+        if (UsePextFallback) {
+            OUTPUT_RAW("#if defined(CPH_AVOID_PEXT) || "
+                       "!(defined(_M_X64) || defined(__x86_64__))\n");
+        }
+
+        OUTPUT_RAW("#define ");
         OUTPUT_STRING(Upper);
-        OUTPUT_RAW("_DOWNSIZE_KEY(Key) ((CPHDKEY)_pext_u64(Key, 0x");
-        OUTPUT_HEX64_RAW(Keys->DownsizeBitmap);
-        OUTPUT_RAW("))\n");
+        OUTPUT_RAW("_DOWNSIZE_KEY(Key) ((CPHDKEY)( \\\n");
+
+        for (Index = 0, Run = DownsizeRuns.Runs;
+             Index < DownsizeRuns.NumberOfRuns;
+             Index++, Run++) {
+
+            if (Run->Shift == 0) {
+                OUTPUT_RAW("    ((Key) & 0x");
+            } else {
+                OUTPUT_RAW("    (((Key) >> ");
+                OUTPUT_INT(Run->Shift);
+                OUTPUT_RAW(") & 0x");
+            }
+
+            OUTPUT_HEX64_RAW(Run->Mask);
+
+            if (Index + 1 < DownsizeRuns.NumberOfRuns) {
+                OUTPUT_RAW(") | \\\n");
+            } else {
+                OUTPUT_RAW(") \\\n))\n");
+            }
+        }
+
+        if (UsePextFallback) {
+            OUTPUT_RAW("#else\n#define ");
+            OUTPUT_STRING(Upper);
+            OUTPUT_RAW("_DOWNSIZE_KEY(Key) ((CPHDKEY)_pext_u64(Key, 0x");
+            OUTPUT_HEX64_RAW(Keys->DownsizeBitmap);
+            OUTPUT_RAW("))\n#endif\n");
+        }
 
         //
         // Write the left and right key rotation macros.
@@ -188,6 +316,36 @@ PrepareCHeaderFileChm01(
         OUTPUT_STRING(Upper);
         OUTPUT_RAW("_ROTATE_KEY_RIGHT _rotr64\n\n");
 
+    } else if (KeysAre128Bit(Keys)) {
+
+        //
+        // The keys are 128-bit; output the seed used to reduce each key to a
+        // 32-bit key, and a key downsize macro that performs the reduction.
+        //
+
+        OUTPUT_RAW("#define ");
+        OUTPUT_STRING(Upper);
+        OUTPUT_RAW("_KEY128_SEED 0x");
+        OUTPUT_HEX_RAW(Keys->ReducedKeySeed);
+        OUTPUT_RAW("\n#define ");
+        OUTPUT_STRING(Upper);
+        OUTPUT_RAW("_DOWNSIZE_KEY(Key) \\\n    "
+                   "((CPHDKEY)CphHashKey128((Key).Low, (Key).High, ");
+        OUTPUT_STRING(Upper);
+        OUTPUT_RAW("_KEY128_SEED))\n");
+
+        //
+        // Write the left and right key rotation macros.
+        //
+
+        OUTPUT_RAW("#define ");
+        OUTPUT_STRING(Upper);
+        OUTPUT_RAW("_ROTATE_KEY_LEFT CphRotateKey128Left\n");
+
+        OUTPUT_RAW("#define ");
+        OUTPUT_STRING(Upper);
+        OUTPUT_RAW("_ROTATE_KEY_RIGHT CphRotateKey128Right\n\n");
+
     } else {
 
         //
@@ -356,7 +514,8 @@ SaveCHeaderFileChm01(
     }
 
     //
-    // Write masks.
+    // Write masks and moduli.  (The latter are used by the modulus masking,
+    // Bdz01 and Block01 Index() implementations.)
     //
 
     OUTPUT_RAW("\n#define ");
@@ -367,8 +526,32 @@ SaveCHeaderFileChm01(
     OUTPUT_STRING(Upper);
     OUTPUT_RAW("_INDEX_MASK 0x");
     OUTPUT_HEX_RAW(TableInfo->IndexMask);
+    OUTPUT_RAW("\n#define ");
+    OUTPUT_STRING(Upper);
+    OUTPUT_RAW("_HASH_MODULUS 0x");
+    OUTPUT_HEX_RAW(TableInfo->HashModulus);
+    OUTPUT_RAW("\n#define ");
+    OUTPUT_STRING(Upper);
+    OUTPUT_RAW("_INDEX_MODULUS 0x");
+    OUTPUT_HEX_RAW(TableInfo->IndexModulus);
     OUTPUT_RAW("\n\n");
 
+    if (IsShard01(Table)) {
+        OUTPUT_RAW("#define ");
+        OUTPUT_STRING(Upper);
+        OUTPUT_RAW("_NUMBER_OF_SHARDS 0x");
+        OUTPUT_HEX_RAW(TableInfo->NumberOfShards);
+        OUTPUT_RAW("\n\n");
+    }
+
+    if (IsPackedTableDataLayout(Table)) {
+        OUTPUT_RAW("#define ");
+        OUTPUT_STRING(Upper);
+        OUTPUT_RAW("_TABLE_DATA_BITS ");
+        OUTPUT_INT(TableInfo->TableDataBitsPerElement);
+        OUTPUT_RAW("\n\n");
+    }
+
     //
     // Write inline routines.
     //
@@ -387,8 +570,13 @@ SaveCHeaderFileChm01(
 
     OUTPUT_STRING(&CompiledPerfectHashTableRoutinesPostCSourceRawCString);
 
-    OUTPUT_RAW("\nDEFINE_TABLE_ROUTINES();\n"
-               "\nDEFINE_TEST_AND_BENCHMARKING_ROUTINES();\n\n");
+    OUTPUT_RAW("\nDEFINE_TABLE_ROUTINES();\n");
+
+    if (KeysAreStrings(Table->Keys)) {
+        OUTPUT_RAW("\nDEFINE_STRING_TABLE_ROUTINES();\n");
+    }
+
+    OUTPUT_RAW("\nDEFINE_TEST_AND_BENCHMARKING_ROUTINES();\n\n");
 
     //
     // Close the extern C scope opened up during the prepare phase, then close
@@ -61,6 +61,30 @@ PrepareCHeaderTypesFileChm01(
         OUTPUT_RAW("#define CPH_INDEX_ONLY 1\n\n");
     }
 
+    if (HasFingerprints(Table)) {
+        OUTPUT_RAW("#define CPH_HAS_FINGERPRINTS 1\n\n");
+    }
+
+    if (IsInterleavedTableDataLayout(Table)) {
+        OUTPUT_RAW("#define CPH_INTERLEAVED_TABLE_DATA 1\n\n");
+    }
+
+    if (IsOrderPreserving(Table)) {
+        OUTPUT_RAW("#define CPH_ORDER_PRESERVING 1\n\n");
+    }
+
+    if (IsPackedTableDataLayout(Table)) {
+        OUTPUT_RAW("#define CPH_PACKED_TABLE_DATA 1\n\n");
+    }
+
+    if (KeysAreStrings(Table->Keys)) {
+        OUTPUT_RAW("#define CPH_STRING_KEYS 1\n\n");
+    }
+
+    if (KeysAre128Bit(Table->Keys)) {
+        OUTPUT_RAW("#define CPH_KEY128 1\n\n");
+    }
+
     //
     // Write the pre glue.
     //
@@ -68,12 +92,18 @@ PrepareCHeaderTypesFileChm01(
     OUTPUT_STRING(&CompiledPerfectHashTableTypesPreCHeaderRawCString);
 
     //
-    // Write the CPHKEY, CPHDKEY, CPHVALUE, and CPHINDEX types.
+    // Write the CPHKEY, CPHDKEY, CPHVALUE, CPHSEED and CPHINDEX types, and the
+    // CPHFINGERPRINT and CPHSLOT types if applicable.
     //
 
-    OUTPUT_RAW("typedef ");
-    OUTPUT_STRING(Table->OriginalKeySizeTypeName);
-    OUTPUT_RAW(" CPHKEY;\n");
+    if (KeysAre128Bit(Table->Keys)) {
+        OUTPUT_RAW("typedef struct _CPHKEY {\n    ULONGLONG Low;\n    "
+                   "ULONGLONG High;\n} CPHKEY;\n");
+    } else {
+        OUTPUT_RAW("typedef ");
+        OUTPUT_STRING(Table->OriginalKeySizeTypeName);
+        OUTPUT_RAW(" CPHKEY;\n");
+    }
 
     OUTPUT_RAW("typedef ");
     OUTPUT_STRING(Table->KeySizeTypeName);
@@ -89,7 +119,21 @@ PrepareCHeaderTypesFileChm01(
 
     OUTPUT_RAW("typedef ");
     OUTPUT_STRING(Table->IndexTypeName);
-    OUTPUT_RAW(" CPHINDEX;\n\n");
+    OUTPUT_RAW(" CPHINDEX;\n");
+
+    if (HasFingerprints(Table)) {
+        OUTPUT_RAW("typedef ");
+        OUTPUT_STRING(Table->FingerprintTypeName);
+        OUTPUT_RAW(" CPHFINGERPRINT;\n");
+    }
+
+    if (IsInterleavedTableDataLayout(Table)) {
+        OUTPUT_RAW("\ntypedef struct _CPHSLOT {\n    ");
+        OUTPUT_STRING(Table->TableDataArrayTypeName);
+        OUTPUT_RAW(" Assigned;\n    CPHVALUE Value;\n} CPHSLOT;\n");
+    }
+
+    OUTPUT_RAW("\n");
 
     //
     // Write the post glue.
@@ -118,7 +118,7 @@ PrepareCSourceKeysFileChm01(
         ULONGLONG Key;
         PULONGLONG SourceKeys;
 
-        SourceKeys = (PULONGLONG)Keys->File->BaseAddress;
+        SourceKeys = (PULONGLONG)GetOriginalKeyArray(Keys);
 
         for (Index = 0, Count = 0; Index < NumberOfKeys; Index++) {
 
@@ -140,6 +140,26 @@ PrepareCSourceKeysFileChm01(
             }
         }
 
+    } else if (Keys->OriginalKeySizeType == XmmType) {
+
+        PKEY128 SourceKeys;
+
+        //
+        // Write the original 128-bit keys (in reduced key order), one per
+        // line, as CPHKEY { Low, High } initializers.
+        //
+
+        SourceKeys = Keys->Key128Array;
+
+        for (Index = 0; Index < NumberOfKeys; Index++, SourceKeys++) {
+            INDENT();
+            OUTPUT_RAW("{ ");
+            OUTPUT_HEX64(SourceKeys->Low);
+            OUTPUT_RAW(", ");
+            OUTPUT_HEX64(SourceKeys->High);
+            OUTPUT_RAW(" },\n");
+        }
+
     } else {
 
         Result = PH_E_UNREACHABLE_CODE;
@@ -157,7 +177,99 @@ PrepareCSourceKeysFileChm01(
         *(Output - 1) = '\n';
     }
 
-    OUTPUT_RAW("};\n#ifdef _WIN32\n#pragma const_seg()\n#endif\n");
+    OUTPUT_RAW("};\n");
+
+    //
+    // If the keys are strings, write the string offsets and data, too.  The
+    // offset of string N (i.e. the string that reduced to key N) is the Nth
+    // offset, and its length is the difference between offsets N + 1 and N.
+    //
+
+    if (KeysAreStrings(Keys)) {
+
+        BYTE Byte;
+        PBYTE StringData;
+        PULONG Offsets;
+
+        Offsets = Keys->StringKeyOffsets;
+
+        OUTPUT_RAW("\nconst ULONG ");
+        OUTPUT_STRING(Name);
+        OUTPUT_RAW("_StringKeyOffsets[");
+        OUTPUT_INT(NumberOfKeys + 1);
+        OUTPUT_RAW("] = {\n");
+
+        for (Index = 0, Count = 0; Index <= NumberOfKeys; Index++) {
+
+            if (Count == 0) {
+                INDENT();
+            }
+
+            OUTPUT_HEX(*Offsets++);
+
+            *Output++ = ',';
+
+            if (++Count == 4) {
+                Count = 0;
+                *Output++ = '\n';
+            } else {
+                *Output++ = ' ';
+            }
+        }
+
+        if (*(Output - 1) == ' ') {
+            *(Output - 1) = '\n';
+        }
+
+        OUTPUT_RAW("};\n\nconst BYTE ");
+        OUTPUT_STRING(Name);
+        OUTPUT_RAW("_StringKeyData[");
+        OUTPUT_INT(max(Keys->StringKeyDataSizeInBytes, 1));
+        OUTPUT_RAW("] = {\n");
+
+        StringData = Keys->StringKeyData;
+
+        for (Index = 0, Count = 0;
+             Index < Keys->StringKeyDataSizeInBytes;
+             Index++) {
+
+            if (Count == 0) {
+                INDENT();
+            }
+
+            Byte = *StringData++;
+
+            OUTPUT_RAW("0x");
+            OUTPUT_HEX_RAW(Byte);
+
+            *Output++ = ',';
+
+            if (++Count == 16) {
+                Count = 0;
+                *Output++ = '\n';
+            } else {
+                *Output++ = ' ';
+            }
+        }
+
+        //
+        // A zero-length array isn't valid C, so emit a single 0 if every
+        // string key was empty.
+        //
+
+        if (Keys->StringKeyDataSizeInBytes == 0) {
+            INDENT();
+            OUTPUT_RAW("0x0,\n");
+        }
+
+        if (*(Output - 1) == ' ') {
+            *(Output - 1) = '\n';
+        }
+
+        OUTPUT_RAW("};\n");
+    }
+
+    OUTPUT_RAW("#ifdef _WIN32\n#pragma const_seg()\n#endif\n");
 
     File->NumberOfBytesWritten.QuadPart = RtlPointerToOffset(Base, Output);
 
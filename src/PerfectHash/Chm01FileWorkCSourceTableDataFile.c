@@ -14,7 +14,12 @@ Abstract:
 
     The C source table data file (extension _TableData.c) is simply a C array of
     the "assigned" array that is obtained during the graph solving step (i.e. it
-    is identical in nature to the .pht1 table data file).
+    is identical in nature to the .pht1 table data file).  If the table has
+    fingerprints, they're written as a second C array.  If the table uses the
+    interleaved table data layout, the array is instead written as writable
+    slots, each pairing an assigned value with its (initially zero) value.  If
+    the table uses the packed table data layout, the array is written as the
+    ULONGLONG words of the bit-packed table data (see PackedTableData.h).
 
     This file has no preparation step (unlike, say, the C header file), as there
     is no work that can be done until the graph has been solved and table data
@@ -36,6 +41,10 @@ SaveCSourceTableDataFileChm01(
     PCHAR Output;
     ULONG Value;
     ULONG Count;
+    ULONG WaitResult;
+    ULONG ElementsPerLine;
+    BOOLEAN Packed;
+    BOOLEAN Interleaved;
     PULONG Long;
     PULONG Seed;
     PGRAPH Graph;
@@ -44,6 +53,7 @@ SaveCSourceTableDataFileChm01(
     PCSTRING Name;
     PCSTRING Upper;
     ULONGLONG Index;
+    ULONGLONG Word;
     HRESULT Result = S_OK;
     PPERFECT_HASH_FILE File;
     PPERFECT_HASH_PATH Path;
@@ -66,9 +76,27 @@ SaveCSourceTableDataFileChm01(
     TableInfo = Table->TableInfoOnDisk;
     TotalNumberOfElements = TableInfo->NumberOfTableElements.QuadPart;
     NumberOfElements = TotalNumberOfElements >> 1;
+    if (IsBdz01(Table)) {
+        NumberOfElements = TableInfo->HashModulus;
+    }
     Graph = (PGRAPH)Context->SolvedContext;
     NumberOfSeeds = Graph->NumberOfSeeds;
     Source = Graph->Assigned;
+    Interleaved = IsInterleavedTableDataLayout(Table);
+    Packed = IsPackedTableDataLayout(Table);
+    ElementsPerLine = (Interleaved ? 2 : 4);
+
+    //
+    // Shard01 table data is written as two arrays: the shard directory, and
+    // the concatenation of each shard's assigned array.  (NumberOfElements
+    // captures the number of elements per shard.)
+    //
+
+    if (IsShard01(Table)) {
+        NumberOfElements = TableInfo->HashSize;
+        TotalNumberOfElements = NumberOfElements * Table->NumberOfShards;
+        Source = Table->ShardAssigned;
+    }
     Output = Base = (PCHAR)File->BaseAddress;
 
     //
@@ -146,18 +174,110 @@ SaveCSourceTableDataFileChm01(
     OUTPUT_RAW(";\n#ifdef _WIN32\n#pragma const_seg()\n#endif\n\n");
 
     //
-    // Write the table data.
+    // Write the shard directory if applicable.  Each entry is written in full
+    // (i.e. key offset, number of keys, then seeds), such that the compiled
+    // Index() routine can address a shard's seeds via Shard * 8.
     //
 
-    OUTPUT_RAW("#ifdef _WIN32\n#pragma const_seg(\".cphdata\")\n#endif\n");
+    if (IsShard01(Table)) {
+
+        OUTPUT_RAW("#ifdef _WIN32\n#pragma const_seg(\".cphsm\")\n#endif\n");
+        OUTPUT_RAW("const CPHSEED ");
+        OUTPUT_STRING(Name);
+        OUTPUT_RAW("_TableShards[");
+        OUTPUT_INT(Table->NumberOfShards *
+                   SHARD01_DIRECTORY_ENTRY_SIZE_IN_ULONGS);
+        OUTPUT_RAW("] = {\n");
+
+        Long = (PULONG)Table->Shards;
+
+        for (Index = 0, Count = 0;
+             Index < (ULONGLONG)Table->NumberOfShards *
+                     SHARD01_DIRECTORY_ENTRY_SIZE_IN_ULONGS;
+             Index++) {
+
+            if (Count == 0) {
+                INDENT();
+            }
+
+            OUTPUT_HEX(*Long++);
+
+            *Output++ = ',';
+
+            if (++Count == 4) {
+                Count = 0;
+                *Output++ = '\n';
+            } else {
+                *Output++ = ' ';
+            }
+        }
+
+        OUTPUT_RAW("};\n#ifdef _WIN32\n#pragma const_seg()\n#endif\n\n");
+    }
+
+    //
+    // Write the table data.  If the table data is interleaved with the table
+    // values, it's written as an array of slots, which must be writable, and
+    // thus, reside in the section normally used for the table values.
+    //
+
+    if (Interleaved) {
+
+        OUTPUT_RAW("#ifdef _WIN32\n#pragma data_seg(\".cphval\")\n#endif\n");
+
+        OUTPUT_RAW("CPHSLOT ");
+        OUTPUT_STRING(Name);
+        OUTPUT_RAW("_TableSlots[");
+
+    } else {
+
+        OUTPUT_RAW("#ifdef _WIN32\n#pragma const_seg(\".cphdata\")\n#endif\n");
+
+        //
+        // Block01 table data must be cache line aligned, such that each block
+        // occupies exactly one cache line.
+        //
+
+        if (IsBlock01(Table)) {
+            OUTPUT_RAW("CPHCACHEALIGN ");
+        }
+
+        OUTPUT_RAW("const ");
+        if (Packed) {
+            OUTPUT_RAW("ULONGLONG");
+        } else {
+            OUTPUT_STRING(Table->TableDataArrayTypeName);
+        }
+        OUTPUT_RAW(" ");
+        OUTPUT_STRING(Name);
+        OUTPUT_RAW("_TableData[");
+    }
+
+    //
+    // Packed table data is written a word at a time; each word is produced
+    // directly from the assigned array.
+    //
+
+    if (Packed) {
+        TotalNumberOfElements = GetTableDataSizeInBytes(TableInfo) >> 3;
+    }
 
-    OUTPUT_RAW("const ");
-    OUTPUT_STRING(Table->TableDataArrayTypeName);
-    OUTPUT_RAW(" ");
-    OUTPUT_STRING(Name);
-    OUTPUT_RAW("_TableData[");
     OUTPUT_INT(TotalNumberOfElements);
-    OUTPUT_RAW("] = {\n\n    //\n    // 1st half.\n    //\n\n");
+
+    if (Packed) {
+        OUTPUT_RAW("] = {\n\n    //\n    // Packed table data, ");
+        OUTPUT_INT(TableInfo->TableDataBitsPerElement);
+        OUTPUT_RAW(" bits per element.\n    //\n\n");
+    } else if (IsShard01(Table)) {
+        OUTPUT_RAW("] = {\n\n    //\n    // Shard 0.\n    //\n\n");
+    } else if (IsBdz01(Table)) {
+        OUTPUT_RAW("] = {\n\n    //\n    // 1st third.\n    //\n\n");
+    } else if (IsBlock01(Table)) {
+        OUTPUT_RAW("] = {\n\n    //\n    // Blocks of 15 assigned values "
+                   "followed by the block seed.\n    //\n\n");
+    } else {
+        OUTPUT_RAW("] = {\n\n    //\n    // 1st half.\n    //\n\n");
+    }
 
     for (Index = 0, Count = 0; Index < TotalNumberOfElements; Index++) {
 
@@ -165,21 +285,53 @@ SaveCSourceTableDataFileChm01(
             INDENT();
         }
 
-        Value = *Source++;
-
-        OUTPUT_HEX(Value);
+        if (Packed) {
+            Word = GetPackedTableDataWord(
+                Source,
+                TableInfo->NumberOfTableElements.QuadPart,
+                TableInfo->TableDataBitsPerElement,
+                Index
+            );
+            OUTPUT_HEX64(Word);
+        } else if (Interleaved) {
+            Value = *Source++;
+            OUTPUT_RAW("{ ");
+            OUTPUT_HEX(Value);
+            OUTPUT_RAW(", 0 }");
+        } else {
+            Value = *Source++;
+            OUTPUT_HEX(Value);
+        }
 
         *Output++ = ',';
 
-        if (++Count == 4) {
+        if (++Count == ElementsPerLine) {
             Count = 0;
             *Output++ = '\n';
         } else {
             *Output++ = ' ';
         }
 
-        if (Index == NumberOfElements-1) {
-            OUTPUT_RAW("\n    //\n    // 2nd half.\n    //\n\n");
+        if (IsShard01(Table)) {
+            if (((Index + 1) % NumberOfElements) == 0 &&
+                (Index + 1) < TotalNumberOfElements) {
+                OUTPUT_RAW("\n    //\n    // Shard ");
+                OUTPUT_INT((Index + 1) / NumberOfElements);
+                OUTPUT_RAW(".\n    //\n\n");
+            }
+        } else if (IsBlock01(Table)) {
+            if (((Index + 1) & (BLOCK01_ELEMENTS_PER_BLOCK - 1)) == 0 &&
+                (Index + 1) < TotalNumberOfElements) {
+                *Output++ = '\n';
+            }
+        } else if (!Packed && Index == NumberOfElements-1) {
+            if (IsBdz01(Table)) {
+                OUTPUT_RAW("\n    //\n    // 2nd third.\n    //\n\n");
+            } else {
+                OUTPUT_RAW("\n    //\n    // 2nd half.\n    //\n\n");
+            }
+        } else if (IsBdz01(Table) && Index == (NumberOfElements << 1)-1) {
+            OUTPUT_RAW("\n    //\n    // 3rd third.\n    //\n\n");
         }
     }
 
@@ -194,12 +346,79 @@ SaveCSourceTableDataFileChm01(
 
     OUTPUT_RAW("};\n");
 
+    if (Interleaved) {
+        OUTPUT_RAW("#ifdef _WIN32\n"
+                   "#pragma data_seg()\n"
+                   "#pragma comment(linker, "
+                   "\"/section:.cphval,rw");
+        if (UseRwsSectionForTableValues(Table)) {
+            *Output++ = 's';
+        }
+        OUTPUT_RAW("\")\n#endif\n");
+    }
+
+    //
+    // Write the fingerprints if applicable.  They're populated by the graph
+    // verification step, which happens in parallel with this file work, so
+    // wait for verification to complete first.
+    //
+
+    if (HasFingerprints(Table)) {
+
+        WaitResult = WaitForSingleObject(Context->VerifiedTableEvent, INFINITE);
+        if (WaitResult != WAIT_OBJECT_0) {
+            SYS_ERROR(WaitForSingleObject);
+            Result = PH_E_SYSTEM_CALL_FAILED;
+            goto End;
+        }
+
+        OUTPUT_RAW("\nconst CPHFINGERPRINT ");
+        OUTPUT_STRING(Name);
+        OUTPUT_RAW("_TableFingerprints[");
+        OUTPUT_INT(TableInfo->NumberOfTableElements.QuadPart);
+        OUTPUT_RAW("] = {\n");
+
+        for (Index = 0, Count = 0;
+             Index < TableInfo->NumberOfTableElements.QuadPart;
+             Index++) {
+
+            if (Count == 0) {
+                INDENT();
+            }
+
+            if (Table->FingerprintSizeInBytes == sizeof(BYTE)) {
+                Value = Table->Fingerprints8[Index];
+            } else {
+                Value = Table->Fingerprints16[Index];
+            }
+
+            OUTPUT_HEX(Value);
+
+            *Output++ = ',';
+
+            if (++Count == 4) {
+                Count = 0;
+                *Output++ = '\n';
+            } else {
+                *Output++ = ' ';
+            }
+        }
+
+        if (*(Output - 1) == ' ') {
+            *(Output - 1) = '\n';
+        }
+
+        OUTPUT_RAW("};\n");
+    }
+
     //
     // Update the number of bytes written.
     //
 
     File->NumberOfBytesWritten.QuadPart = RtlPointerToOffset(Base, Output);
 
+End:
+
     return Result;
 }
 
@@ -50,6 +50,15 @@ PrepareCSourceTableValuesFileChm01(
     TableInfo = Table->TableInfoOnDisk;
     TotalNumberOfElements = TableInfo->NumberOfTableElements.QuadPart;
     NumberOfElements = TotalNumberOfElements >> 1;
+
+    //
+    // Multiply-high tables don't size the vertices as a multiple of the edges;
+    // the index will always be less than the index size, so use that.
+    //
+
+    if (IsMultiplyHighMasking(Table->MaskFunctionId)) {
+        NumberOfElements = TableInfo->IndexSize;
+    }
     Output = Base = (PCHAR)File->BaseAddress;
 
     //
@@ -61,6 +70,17 @@ PrepareCSourceTableValuesFileChm01(
 
     OUTPUT_INCLUDE_STDAFX_H();
 
+    //
+    // If the table values are interleaved with the table data, they're written
+    // as part of the table data file's slots array instead.
+    //
+
+    if (IsInterleavedTableDataLayout(Table)) {
+        OUTPUT_RAW("//\n// N.B. Table values are interleaved with the table "
+                   "data; see _TableSlots[].\n//\n");
+        goto End;
+    }
+
     //
     // Write the table values array.
     //
@@ -83,6 +103,8 @@ PrepareCSourceTableValuesFileChm01(
     }
     OUTPUT_RAW("\")\n#endif\n#endif");
 
+End:
+
     //
     // Update the number of bytes written.
     //
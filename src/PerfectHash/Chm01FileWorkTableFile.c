@@ -18,6 +18,12 @@ Abstract:
     no work that can be done until the graph has been solved and the table data
     is available to save to disk.
 
+    If the table was created with the --FingerprintSizeInBytes parameter, the
+    key fingerprints array is written immediately after the table data.
+
+    If the table uses the packed table data layout, the assigned array is
+    bit-packed as it is written; see PackedTableData.h.
+
 --*/
 
 #include "stdafx.h"
@@ -34,8 +40,10 @@ SaveTableFileChm01(
     PGRAPH Graph;
     PULONG Source;
     PVOID BaseAddress;
+    ULONG WaitResult;
     HRESULT Result = S_OK;
     LONGLONG SizeInBytes;
+    LONGLONG FingerprintsSizeInBytes;
     LARGE_INTEGER EndOfFile;
     PPERFECT_HASH_TABLE Table;
     PPERFECT_HASH_FILE File;
@@ -54,23 +62,62 @@ SaveTableFileChm01(
     Source = Graph->Assigned;
     TableInfoOnDisk = Table->TableInfoOnDisk;
 
-    SizeInBytes = (
+    SizeInBytes = GetTableDataSizeInBytes(TableInfoOnDisk);
+
+    FingerprintsSizeInBytes = (
         TableInfoOnDisk->NumberOfTableElements.QuadPart *
-        TableInfoOnDisk->KeySizeInBytes
+        TableInfoOnDisk->FingerprintSizeInBytes
     );
 
-    if (SizeInBytes != File->FileInfo.EndOfFile.QuadPart) {
+    if (SizeInBytes + FingerprintsSizeInBytes !=
+        File->FileInfo.EndOfFile.QuadPart) {
         PH_RAISE(PH_E_INVARIANT_CHECK_FAILED);
     }
 
     //
     // The graph has been solved.  Copy the array of assigned values to the
-    // backing memory map.
+    // backing memory map.  For Shard01, the table data is assembled from the
+    // shard directory and each shard's assigned array, and the memory map
+    // becomes the source for the in-memory copy below.  Likewise for the
+    // packed table data layout, where the assigned array is packed directly
+    // into the memory map.
+    //
+
+    if (IsShard01(Table)) {
+        CopyShardTableDataShard01(Table, Dest, SizeInBytes);
+        Source = Dest;
+    } else if (IsPackedTableDataLayout(Table)) {
+        PackTableData(Source,
+                      TableInfoOnDisk->NumberOfTableElements.QuadPart,
+                      TableInfoOnDisk->TableDataBitsPerElement,
+                      (PULONGLONG)Dest,
+                      SizeInBytes);
+        Source = Dest;
+    } else {
+        CopyMemory(Dest, Source, SizeInBytes);
+    }
+
     //
+    // If the table has fingerprints, they're populated by the graph
+    // verification step, which happens in parallel with this file work.  Wait
+    // for verification to complete, then write them out after the table data.
+    //
+
+    if (FingerprintsSizeInBytes) {
 
-    CopyMemory(Dest, Source, SizeInBytes);
+        WaitResult = WaitForSingleObject(Context->VerifiedTableEvent, INFINITE);
+        if (WaitResult != WAIT_OBJECT_0) {
+            SYS_ERROR(WaitForSingleObject);
+            Result = PH_E_SYSTEM_CALL_FAILED;
+            goto Error;
+        }
+
+        CopyMemory(RtlOffsetToPointer(Dest, SizeInBytes),
+                   Table->Fingerprints,
+                   FingerprintsSizeInBytes);
+    }
 
-    EndOfFile.QuadPart = (LONGLONG)SizeInBytes;
+    EndOfFile.QuadPart = (LONGLONG)(SizeInBytes + FingerprintsSizeInBytes);
 
     //
     // Update the number of bytes written.
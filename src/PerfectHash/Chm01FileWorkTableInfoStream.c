@@ -108,6 +108,8 @@ SaveTableInfoStreamChm01(
     TableInfoOnDisk->ClosestWeCameToSolvingGraphWithSmallerTableSizes =
         Context->ClosestWeCameToSolvingGraphWithSmallerTableSizes;
 
+    TableInfoOnDisk->CacheLinesPerLookup = Table->CacheLinesPerLookup;
+
     //
     // Copy timer values.
     //
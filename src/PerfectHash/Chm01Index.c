@@ -8,9 +8,10 @@ Module Name:
 
 Abstract:
 
-    This module implements the Index() routine for the CHM v1 algorithm, as well
-    as custom FastIndex() routines for certain combinations of hash function and
-    masking type.
+    This module implements the Index() and IndexBatch() routines for the CHM v1
+    algorithm, as well as custom FastIndex() routines for certain combinations
+    of hash function and masking type, and the Index() and IndexBatch()
+    routines for tables using the packed table data layout.
 
 --*/
 
@@ -1054,4 +1055,349 @@ Error:
     return E_FAIL;
 }
 
+PERFECT_HASH_TABLE_INDEX_BATCH PerfectHashTableIndexBatchImplChm01;
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableIndexBatchImplChm01(
+    PPERFECT_HASH_TABLE Table,
+    ULONG NumberOfKeys,
+    PULONG Keys,
+    PULONG Indices
+    )
+/*++
+
+Routine Description:
+
+    Looks up an array of keys in a perfect hash table and returns their
+    indices.  Keys are processed in groups of
+    PERFECT_HASH_TABLE_BATCH_GROUP_SIZE; each key in a group is hashed and
+    both of its assigned array slots are prefetched, then the group's indices
+    are resolved.  This overlaps the two
+    assigned array cache misses of each key with those of the rest of the
+    group, instead of paying the full memory latency for each key in turn.
+
+    N.B. If a key did not appear in the original set the hash table was created
+         from, the behavior of this routine is undefined for that key.
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the key lookups are to
+        be performed.
+
+    NumberOfKeys - Supplies the number of keys in the Keys array.
+
+    Keys - Supplies the base address of an array of keys to look up.
+
+    Indices - Receives the index associated with each key.
+
+Return Value:
+
+    S_OK if all keys were resolved successfully, E_FAIL if the two vertices of
+    one or more keys were identical.  The index for such keys will be set to
+    zero (as per the scalar Index() routine).
+
+--*/
+{
+    ULONG Mask;
+    ULONG Base;
+    ULONG Count;
+    ULONG Offset;
+    ULONG Failures;
+    ULONG IndexMask;
+    ULONG IndexModulus;
+    PULONG Seeds;
+    PULONG Assigned;
+    BOOLEAN MultiplyHigh;
+    ULONGLONG Combined;
+    ULARGE_INTEGER Hash;
+    ULARGE_INTEGER VertexPairs[PERFECT_HASH_TABLE_BATCH_GROUP_SIZE];
+    PPERFECT_HASH_TABLE_SEEDED_HASH_EX SeededHashEx;
+
+    //
+    // Modulus masking doesn't have a seeded hash "Ex" equivalent; fall back to
+    // the scalar routine.
+    //
+
+    if (IsModulusMasking(Table->MaskFunctionId)) {
+        Failures = 0;
+        for (Offset = 0; Offset < NumberOfKeys; Offset++) {
+            if (FAILED(Table->Vtbl->Index(Table,
+                                          Keys[Offset],
+                                          &Indices[Offset]))) {
+                Failures++;
+            }
+        }
+        return (Failures == 0 ? S_OK : E_FAIL);
+    }
+
+    //
+    // Initialize aliases.
+    //
+
+    Seeds = &Table->TableInfoOnDisk->FirstSeed;
+    Assigned = Table->Assigned;
+    SeededHashEx = Table->Vtbl->SeededHashEx;
+    Mask = GetSeededHashExMask(Table);
+    IndexMask = Table->IndexMask;
+    IndexModulus = Table->IndexModulus;
+    MultiplyHigh = IsMultiplyHighMasking(Table->MaskFunctionId);
+    Failures = 0;
+
+    for (Base = 0; Base < NumberOfKeys; Base += Count) {
+
+        Count = min(PERFECT_HASH_TABLE_BATCH_GROUP_SIZE, NumberOfKeys - Base);
+
+        //
+        // Hash each key in the group and prefetch both assigned slots.
+        //
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            Hash.QuadPart = SeededHashEx(Keys[Base + Offset], Seeds, Mask);
+            VertexPairs[Offset].QuadPart = Hash.QuadPart;
+            PreFetchCacheLine(PF_TEMPORAL_LEVEL_1, &Assigned[Hash.LowPart]);
+            PreFetchCacheLine(PF_TEMPORAL_LEVEL_1, &Assigned[Hash.HighPart]);
+        }
+
+        //
+        // Resolve the indices of the group.
+        //
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            Hash.QuadPart = VertexPairs[Offset].QuadPart;
+
+            if (Hash.LowPart == Hash.HighPart) {
+                Indices[Base + Offset] = 0;
+                Failures++;
+                continue;
+            }
+
+            Combined = (
+                (ULONGLONG)Assigned[Hash.LowPart] +
+                (ULONGLONG)Assigned[Hash.HighPart]
+            );
+
+            if (MultiplyHigh) {
+                Indices[Base + Offset] = MultiplyHighReduceIndex(Combined,
+                                                                 IndexModulus);
+            } else {
+                Indices[Base + Offset] = (ULONG)(Combined & IndexMask);
+            }
+        }
+    }
+
+    return (Failures == 0 ? S_OK : E_FAIL);
+}
+
+PERFECT_HASH_TABLE_INDEX PerfectHashTableIndexImplChm01Packed;
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableIndexImplChm01Packed(
+    PPERFECT_HASH_TABLE Table,
+    ULONG Key,
+    PULONG Index
+    )
+/*++
+
+Routine Description:
+
+    Looks up given key in a perfect hash table using the packed table data
+    layout and returns its index.  This is identical to the normal Chm01
+    Index() routine, except that the two assigned values are extracted from
+    the bit-packed table data (see PackedTableData.h).
+
+    N.B. If Key did not appear in the original set the hash table was created
+         from, the behavior of this routine is undefined.
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the key lookup is to be
+        performed.
+
+    Key - Supplies the key to look up.
+
+    Index - Receives the index associated with this key.
+
+Return Value:
+
+    S_OK on success, E_FAIL if the two hash values for the key were identical.
+    The Index parameter will be cleared in the case of E_FAIL.
+
+--*/
+{
+    ULONG Bits;
+    ULONG Masked;
+    ULONG Vertex1;
+    ULONG Vertex2;
+    ULONG MaskedLow;
+    ULONG MaskedHigh;
+    PVOID TableData;
+    ULONGLONG Combined;
+    ULARGE_INTEGER Hash;
+
+    if (FAILED(Table->Vtbl->Hash(Table, Key, &Hash.QuadPart))) {
+        goto Error;
+    }
+
+    if (FAILED(Table->Vtbl->MaskHash(Table, Hash.LowPart, &MaskedLow))) {
+        goto Error;
+    }
+
+    if (FAILED(Table->Vtbl->MaskHash(Table, Hash.HighPart, &MaskedHigh))) {
+        goto Error;
+    }
+
+    //
+    // Extract the two assigned values from the packed table data.
+    //
+
+    Bits = Table->TableDataBitsPerElement;
+    TableData = Table->TableDataBaseAddress;
+
+    Vertex1 = GetPackedTableDataElement(TableData, MaskedLow, Bits);
+    Vertex2 = GetPackedTableDataElement(TableData, MaskedHigh, Bits);
+
+    Combined = (ULONGLONG)Vertex1 + (ULONGLONG)Vertex2;
+
+    if (FAILED(Table->Vtbl->MaskIndex(Table, Combined, &Masked))) {
+        goto Error;
+    }
+
+    *Index = Masked;
+    return S_OK;
+
+Error:
+
+    *Index = 0;
+    return E_FAIL;
+}
+
+PERFECT_HASH_TABLE_INDEX_BATCH PerfectHashTableIndexBatchImplChm01Packed;
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableIndexBatchImplChm01Packed(
+    PPERFECT_HASH_TABLE Table,
+    ULONG NumberOfKeys,
+    PULONG Keys,
+    PULONG Indices
+    )
+/*++
+
+Routine Description:
+
+    Looks up an array of keys in a perfect hash table using the packed table
+    data layout and returns their indices.  This follows the same hash, then
+    prefetch, then resolve pattern as PerfectHashTableIndexBatchImplChm01(),
+    prefetching the byte of the packed table data at which each vertex's
+    element begins.
+
+    N.B. If a key did not appear in the original set the hash table was created
+         from, the behavior of this routine is undefined for that key.
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the key lookups are to
+        be performed.
+
+    NumberOfKeys - Supplies the number of keys in the Keys array.
+
+    Keys - Supplies the base address of an array of keys to look up.
+
+    Indices - Receives the index associated with each key.
+
+Return Value:
+
+    S_OK if all keys were resolved successfully, E_FAIL if the two vertices of
+    one or more keys were identical.  The index for such keys will be set to
+    zero (as per the scalar Index() routine).
+
+--*/
+{
+    ULONG Bits;
+    ULONG Mask;
+    ULONG Base;
+    ULONG Count;
+    ULONG Offset;
+    ULONG Failures;
+    ULONG IndexMask;
+    PULONG Seeds;
+    PVOID TableData;
+    ULONGLONG Combined;
+    ULARGE_INTEGER Hash;
+    ULARGE_INTEGER VertexPairs[PERFECT_HASH_TABLE_BATCH_GROUP_SIZE];
+    PPERFECT_HASH_TABLE_SEEDED_HASH_EX SeededHashEx;
+
+    //
+    // The packed table data layout is only supported with And masking, so
+    // the seeded hash "Ex" routines always apply.
+    //
+
+    ASSERT(Table->MaskFunctionId == PerfectHashAndMaskFunctionId);
+
+    //
+    // Initialize aliases.
+    //
+
+    Seeds = &Table->TableInfoOnDisk->FirstSeed;
+    Bits = Table->TableDataBitsPerElement;
+    TableData = Table->TableDataBaseAddress;
+    SeededHashEx = Table->Vtbl->SeededHashEx;
+    Mask = GetSeededHashExMask(Table);
+    IndexMask = Table->IndexMask;
+    Failures = 0;
+
+    for (Base = 0; Base < NumberOfKeys; Base += Count) {
+
+        Count = min(PERFECT_HASH_TABLE_BATCH_GROUP_SIZE, NumberOfKeys - Base);
+
+        //
+        // Hash each key in the group and prefetch both packed elements.
+        //
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            Hash.QuadPart = SeededHashEx(Keys[Base + Offset], Seeds, Mask);
+            VertexPairs[Offset].QuadPart = Hash.QuadPart;
+            PreFetchCacheLine(
+                PF_TEMPORAL_LEVEL_1,
+                RtlOffsetToPointer(TableData,
+                                   ((ULONGLONG)Hash.LowPart * Bits) >> 3)
+            );
+            PreFetchCacheLine(
+                PF_TEMPORAL_LEVEL_1,
+                RtlOffsetToPointer(TableData,
+                                   ((ULONGLONG)Hash.HighPart * Bits) >> 3)
+            );
+        }
+
+        //
+        // Resolve the indices of the group.
+        //
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            Hash.QuadPart = VertexPairs[Offset].QuadPart;
+
+            if (Hash.LowPart == Hash.HighPart) {
+                Indices[Base + Offset] = 0;
+                Failures++;
+                continue;
+            }
+
+            Combined = (
+                (ULONGLONG)GetPackedTableDataElement(TableData,
+                                                     Hash.LowPart,
+                                                     Bits) +
+                (ULONGLONG)GetPackedTableDataElement(TableData,
+                                                     Hash.HighPart,
+                                                     Bits)
+            );
+
+            Indices[Base + Offset] = (ULONG)(Combined & IndexMask);
+        }
+    }
+
+    return (Failures == 0 ? S_OK : E_FAIL);
+}
+
 // vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
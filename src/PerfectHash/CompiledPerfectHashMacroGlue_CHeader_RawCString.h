@@ -81,9 +81,17 @@ const CHAR CompiledPerfectHashMacroGlueCHeaderRawCStr[] =
     "#define CPH_INDEX_MODULUS(U) U##_INDEX_MODULUS\n"
     "\n"
     "#define CPH_TABLE_DATA(T) T##_TableData\n"
+    "#define CPH_TABLE_SHARDS(T) T##_TableShards\n"
+    "#define CPH_NUMBER_OF_SHARDS(U) U##_NUMBER_OF_SHARDS\n"
+    "#define CPH_TABLE_DATA_BITS(U) U##_TABLE_DATA_BITS\n"
     "#define CPH_TABLE_VALUES(T) T##_TableValues\n"
+    "#define CPH_TABLE_FINGERPRINTS(T) T##_TableFingerprints\n"
+    "#define CPH_TABLE_SLOTS(T) T##_TableSlots\n"
     "#define CPH_KEYS(T) T##_Keys\n"
     "#define CPH_NUMBER_OF_KEYS(U) U##_NUMBER_OF_KEYS\n"
+    "#define CPH_STRING_KEY_OFFSETS(T) T##_StringKeyOffsets\n"
+    "#define CPH_STRING_KEY_DATA(T) T##_StringKeyData\n"
+    "#define CPH_STRING_KEY_SEED(U) U##_STRING_KEY_SEED\n"
     "\n"
     "#define CPH_DOWNSIZE_KEY(U) U##_DOWNSIZE_KEY\n"
     "#define CPH_ROTATE_KEY_LEFT(U) U##_ROTATE_KEY_LEFT\n"
@@ -99,6 +107,26 @@ const CHAR CompiledPerfectHashMacroGlueCHeaderRawCStr[] =
     "#define CPH_INSERT_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_InsertInline\n"
     "#define CPH_DELETE_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_DeleteInline\n"
     "\n"
+    "#define CPH_INDEX_BATCH_ROUTINE_NAME(T) CompiledPerfectHash_##T##_IndexBatch\n"
+    "#define CPH_LOOKUP_BATCH_ROUTINE_NAME(T) CompiledPerfectHash_##T##_LookupBatch\n"
+    "\n"
+    "#define CPH_INDEX_BATCH_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_IndexBatchInline\n"
+    "#define CPH_LOOKUP_BATCH_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_LookupBatchInline\n"
+    "\n"
+    "#define CPH_CONTAINS_ROUTINE_NAME(T) CompiledPerfectHash_##T##_Contains\n"
+    "#define CPH_TRY_LOOKUP_ROUTINE_NAME(T) CompiledPerfectHash_##T##_TryLookup\n"
+    "\n"
+    "#define CPH_CONTAINS_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_ContainsInline\n"
+    "#define CPH_TRY_LOOKUP_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_TryLookupInline\n"
+    "\n"
+    "#define CPH_INDEX_STRING_ROUTINE_NAME(T) CompiledPerfectHash_##T##_IndexString\n"
+    "#define CPH_TRY_INDEX_STRING_ROUTINE_NAME(T) CompiledPerfectHash_##T##_TryIndexString\n"
+    "\n"
+    "#define CPH_INDEX_STRING_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_IndexStringInline\n"
+    "#define CPH_TRY_INDEX_STRING_INLINE_ROUTINE_NAME(T) CompiledPerfectHash_##T##_TryIndexStringInline\n"
+    "\n"
+    "#define CPH_HASH_AVX2_ROUTINE_NAME(T) CompiledPerfectHash_##T##_HashAvx2\n"
+    "\n"
     "////////////////////////////////////////////////////////////////////////////////\n"
     "// Index\n"
     "////////////////////////////////////////////////////////////////////////////////\n"
@@ -218,6 +246,216 @@ const CHAR CompiledPerfectHashMacroGlueCHeaderRawCStr[] =
     "    CPHKEY Key                              \\\n"
     "    )\n"
     "\n"
+    "////////////////////////////////////////////////////////////////////////////////\n"
+    "// IndexBatch\n"
+    "////////////////////////////////////////////////////////////////////////////////\n"
+    "\n"
+    "//\n"
+    "// Normal\n"
+    "//\n"
+    "\n"
+    "#define CPH_INDEX_BATCH_ROUTINE_HEADER(T)      \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX_BATCH \\\n"
+    "    CompiledPerfectHash_##T##_IndexBatch;      \\\n"
+    "                                               \\\n"
+    "_Use_decl_annotations_                         \\\n"
+    "VOID                                           \\\n"
+    "CompiledPerfectHash_##T##_IndexBatch(          \\\n"
+    "    ULONG NumberOfKeys,                        \\\n"
+    "    const CPHKEY *Keys,                        \\\n"
+    "    CPHINDEX *Indices                          \\\n"
+    "    )\n"
+    "\n"
+    "//\n"
+    "// Inline\n"
+    "//\n"
+    "\n"
+    "#define CPH_INDEX_BATCH_INLINE_ROUTINE_HEADER(T) \\\n"
+    "FORCEINLINE                                      \\\n"
+    "VOID                                             \\\n"
+    "CompiledPerfectHash_##T##_IndexBatchInline(      \\\n"
+    "    ULONG NumberOfKeys,                          \\\n"
+    "    const CPHKEY *Keys,                          \\\n"
+    "    CPHINDEX *Indices                            \\\n"
+    "    )\n"
+    "\n"
+    "////////////////////////////////////////////////////////////////////////////////\n"
+    "// LookupBatch\n"
+    "////////////////////////////////////////////////////////////////////////////////\n"
+    "\n"
+    "//\n"
+    "// Normal\n"
+    "//\n"
+    "\n"
+    "#define CPH_LOOKUP_BATCH_ROUTINE_HEADER(T)      \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_LOOKUP_BATCH \\\n"
+    "    CompiledPerfectHash_##T##_LookupBatch;      \\\n"
+    "                                                \\\n"
+    "_Use_decl_annotations_                          \\\n"
+    "VOID                                            \\\n"
+    "CompiledPerfectHash_##T##_LookupBatch(          \\\n"
+    "    ULONG NumberOfKeys,                         \\\n"
+    "    const CPHKEY *Keys,                         \\\n"
+    "    CPHVALUE *Values                            \\\n"
+    "    )\n"
+    "\n"
+    "//\n"
+    "// Inline\n"
+    "//\n"
+    "\n"
+    "#define CPH_LOOKUP_BATCH_INLINE_ROUTINE_HEADER(T) \\\n"
+    "FORCEINLINE                                       \\\n"
+    "VOID                                              \\\n"
+    "CompiledPerfectHash_##T##_LookupBatchInline(      \\\n"
+    "    ULONG NumberOfKeys,                           \\\n"
+    "    const CPHKEY *Keys,                           \\\n"
+    "    CPHVALUE *Values                              \\\n"
+    "    )\n"
+    "\n"
+    "////////////////////////////////////////////////////////////////////////////////\n"
+    "// Contains\n"
+    "////////////////////////////////////////////////////////////////////////////////\n"
+    "\n"
+    "//\n"
+    "// Normal\n"
+    "//\n"
+    "\n"
+    "#define CPH_CONTAINS_ROUTINE_HEADER(T)      \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_CONTAINS \\\n"
+    "    CompiledPerfectHash_##T##_Contains;     \\\n"
+    "                                            \\\n"
+    "_Use_decl_annotations_                      \\\n"
+    "BOOLEAN                                     \\\n"
+    "CompiledPerfectHash_##T##_Contains(         \\\n"
+    "    CPHKEY Key                              \\\n"
+    "    )\n"
+    "\n"
+    "//\n"
+    "// Inline\n"
+    "//\n"
+    "\n"
+    "#define CPH_CONTAINS_INLINE_ROUTINE_HEADER(T) \\\n"
+    "FORCEINLINE                                   \\\n"
+    "BOOLEAN                                       \\\n"
+    "CompiledPerfectHash_##T##_ContainsInline(     \\\n"
+    "    CPHKEY Key                                \\\n"
+    "    )\n"
+    "\n"
+    "////////////////////////////////////////////////////////////////////////////////\n"
+    "// TryLookup\n"
+    "////////////////////////////////////////////////////////////////////////////////\n"
+    "\n"
+    "//\n"
+    "// Normal\n"
+    "//\n"
+    "\n"
+    "#define CPH_TRY_LOOKUP_ROUTINE_HEADER(T)      \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_TRY_LOOKUP \\\n"
+    "    CompiledPerfectHash_##T##_TryLookup;      \\\n"
+    "                                              \\\n"
+    "_Use_decl_annotations_                        \\\n"
+    "BOOLEAN                                       \\\n"
+    "CompiledPerfectHash_##T##_TryLookup(          \\\n"
+    "    CPHKEY Key,                               \\\n"
+    "    CPHVALUE *Value                           \\\n"
+    "    )\n"
+    "\n"
+    "//\n"
+    "// Inline\n"
+    "//\n"
+    "\n"
+    "#define CPH_TRY_LOOKUP_INLINE_ROUTINE_HEADER(T) \\\n"
+    "FORCEINLINE                                     \\\n"
+    "BOOLEAN                                         \\\n"
+    "CompiledPerfectHash_##T##_TryLookupInline(      \\\n"
+    "    CPHKEY Key,                                 \\\n"
+    "    CPHVALUE *Value                             \\\n"
+    "    )\n"
+    "\n"
+    "////////////////////////////////////////////////////////////////////////////////\n"
+    "// IndexString\n"
+    "////////////////////////////////////////////////////////////////////////////////\n"
+    "\n"
+    "//\n"
+    "// Normal\n"
+    "//\n"
+    "\n"
+    "#define CPH_INDEX_STRING_ROUTINE_HEADER(T)      \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX_STRING \\\n"
+    "    CompiledPerfectHash_##T##_IndexString;      \\\n"
+    "                                                \\\n"
+    "_Use_decl_annotations_                          \\\n"
+    "CPHINDEX                                        \\\n"
+    "CompiledPerfectHash_##T##_IndexString(          \\\n"
+    "    const BYTE *String,                         \\\n"
+    "    ULONG Length                                \\\n"
+    "    )\n"
+    "\n"
+    "//\n"
+    "// Inline\n"
+    "//\n"
+    "\n"
+    "#define CPH_INDEX_STRING_INLINE_ROUTINE_HEADER(T) \\\n"
+    "FORCEINLINE                                       \\\n"
+    "CPHINDEX                                          \\\n"
+    "CompiledPerfectHash_##T##_IndexStringInline(      \\\n"
+    "    const BYTE *String,                           \\\n"
+    "    ULONG Length                                  \\\n"
+    "    )\n"
+    "\n"
+    "////////////////////////////////////////////////////////////////////////////////\n"
+    "// TryIndexString\n"
+    "////////////////////////////////////////////////////////////////////////////////\n"
+    "\n"
+    "//\n"
+    "// Normal\n"
+    "//\n"
+    "\n"
+    "#define CPH_TRY_INDEX_STRING_ROUTINE_HEADER(T)      \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_TRY_INDEX_STRING \\\n"
+    "    CompiledPerfectHash_##T##_TryIndexString;       \\\n"
+    "                                                    \\\n"
+    "_Use_decl_annotations_                              \\\n"
+    "BOOLEAN                                             \\\n"
+    "CompiledPerfectHash_##T##_TryIndexString(           \\\n"
+    "    const BYTE *String,                             \\\n"
+    "    ULONG Length,                                   \\\n"
+    "    CPHINDEX *Index                                 \\\n"
+    "    )\n"
+    "\n"
+    "//\n"
+    "// Inline\n"
+    "//\n"
+    "\n"
+    "#define CPH_TRY_INDEX_STRING_INLINE_ROUTINE_HEADER(T) \\\n"
+    "FORCEINLINE                                           \\\n"
+    "BOOLEAN                                               \\\n"
+    "CompiledPerfectHash_##T##_TryIndexStringInline(       \\\n"
+    "    const BYTE *String,                               \\\n"
+    "    ULONG Length,                                     \\\n"
+    "    CPHINDEX *Index                                   \\\n"
+    "    )\n"
+    "\n"
+    "////////////////////////////////////////////////////////////////////////////////\n"
+    "// HashAvx2\n"
+    "////////////////////////////////////////////////////////////////////////////////\n"
+    "\n"
+    "//\n"
+    "// Implemented by the Index() templates whose hash function can be expressed\n"
+    "// with AVX2 32-bit lane operations.  Receives eight downsized keys and returns\n"
+    "// their (unmasked) vertex pairs; always inline, regardless of whether or not\n"
+    "// CPH_INLINE_ROUTINES is defined.\n"
+    "//\n"
+    "\n"
+    "#define CPH_HASH_AVX2_ROUTINE_HEADER(T)    \\\n"
+    "FORCEINLINE                                \\\n"
+    "VOID                                       \\\n"
+    "CompiledPerfectHash_##T##_HashAvx2(        \\\n"
+    "    __m256i DownsizedKeys,                 \\\n"
+    "    __m256i *Vertex1Pointer,               \\\n"
+    "    __m256i *Vertex2Pointer                \\\n"
+    "    )\n"
+    "\n"
     "\n"
     "////////////////////////////////////////////////////////////////////////////////\n"
     "// Test and Benchmarking\n"
@@ -263,22 +501,55 @@ const CHAR CompiledPerfectHashMacroGlueCHeaderRawCStr[] =
     "////////////////////////////////////////////////////////////////////////////////\n"
     "\n"
     "#ifdef CPH_INDEX_ONLY\n"
-    "#define CPH_DEFINE_TABLE_ROUTINES(T)                                     \\\n"
-    "CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX CompiledPerfectHash_##T##_Index\n"
+    "#ifdef CPH_HAS_FINGERPRINTS\n"
+    "#define CPH_DEFINE_TABLE_ROUTINES(T)                                      \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX CompiledPerfectHash_##T##_Index; \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX_BATCH                            \\\n"
+    "    CompiledPerfectHash_##T##_IndexBatch;                                 \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_CONTAINS                               \\\n"
+    "    CompiledPerfectHash_##T##_Contains\n"
+    "#else\n"
+    "#define CPH_DEFINE_TABLE_ROUTINES(T)                                      \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX CompiledPerfectHash_##T##_Index; \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX_BATCH                            \\\n"
+    "    CompiledPerfectHash_##T##_IndexBatch\n"
+    "#endif\n"
     "\n"
     "#define CPH_INDEX_ROUTINE(T) CPH_INDEX_ROUTINE_NAME(T)\n"
     "#define CPH_INDEX_INLINE_ROUTINE(T) CPH_INDEX_INLINE_ROUTINE_NAME(T)\n"
+    "#define CPH_INDEX_BATCH_ROUTINE(T) CPH_INDEX_BATCH_ROUTINE_NAME(T)\n"
+    "#define CPH_INDEX_BATCH_INLINE_ROUTINE(T) CPH_INDEX_BATCH_INLINE_ROUTINE_NAME(T)\n"
     "\n"
     "#define CPH_DEFINE_TEST_AND_BENCHMARKING_ROUTINES(T) \\\n"
     "extern BENCHMARK_INDEX_COMPILED_PERFECT_HASH_TABLE   \\\n"
     "    BenchmarkIndexCompiledPerfectHashTable_##T\n"
     "\n"
     "#else\n"
+    "#ifdef CPH_HAS_FINGERPRINTS\n"
     "#define CPH_DEFINE_TABLE_ROUTINES(T)                                        \\\n"
     "CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX CompiledPerfectHash_##T##_Index;   \\\n"
     "CPHAPI COMPILED_PERFECT_HASH_TABLE_LOOKUP CompiledPerfectHash_##T##_Lookup; \\\n"
     "CPHAPI COMPILED_PERFECT_HASH_TABLE_INSERT CompiledPerfectHash_##T##_Insert; \\\n"
-    "CPHAPI COMPILED_PERFECT_HASH_TABLE_DELETE CompiledPerfectHash_##T##_Delete\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_DELETE CompiledPerfectHash_##T##_Delete; \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX_BATCH                              \\\n"
+    "    CompiledPerfectHash_##T##_IndexBatch;                                   \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_LOOKUP_BATCH                             \\\n"
+    "    CompiledPerfectHash_##T##_LookupBatch;                                  \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_CONTAINS                                 \\\n"
+    "    CompiledPerfectHash_##T##_Contains;                                     \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_TRY_LOOKUP                               \\\n"
+    "    CompiledPerfectHash_##T##_TryLookup\n"
+    "#else\n"
+    "#define CPH_DEFINE_TABLE_ROUTINES(T)                                        \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX CompiledPerfectHash_##T##_Index;   \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_LOOKUP CompiledPerfectHash_##T##_Lookup; \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_INSERT CompiledPerfectHash_##T##_Insert; \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_DELETE CompiledPerfectHash_##T##_Delete; \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX_BATCH                              \\\n"
+    "    CompiledPerfectHash_##T##_IndexBatch;                                   \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_LOOKUP_BATCH                             \\\n"
+    "    CompiledPerfectHash_##T##_LookupBatch\n"
+    "#endif\n"
     "\n"
     "#define CPH_DEFINE_TEST_AND_BENCHMARKING_ROUTINES(T) \\\n"
     "extern TEST_COMPILED_PERFECT_HASH_TABLE              \\\n"
@@ -299,8 +570,33 @@ const CHAR CompiledPerfectHashMacroGlueCHeaderRawCStr[] =
     "#define CPH_LOOKUP_INLINE_ROUTINE(T) CPH_LOOKUP_INLINE_ROUTINE_NAME(T)\n"
     "#define CPH_INSERT_INLINE_ROUTINE(T) CPH_INSERT_INLINE_ROUTINE_NAME(T)\n"
     "#define CPH_DELETE_INLINE_ROUTINE(T) CPH_DELETE_INLINE_ROUTINE_NAME(T)\n"
+    "\n"
+    "#define CPH_INDEX_BATCH_ROUTINE(T) CPH_INDEX_BATCH_ROUTINE_NAME(T)\n"
+    "#define CPH_LOOKUP_BATCH_ROUTINE(T) CPH_LOOKUP_BATCH_ROUTINE_NAME(T)\n"
+    "\n"
+    "#define CPH_INDEX_BATCH_INLINE_ROUTINE(T) CPH_INDEX_BATCH_INLINE_ROUTINE_NAME(T)\n"
+    "#define CPH_LOOKUP_BATCH_INLINE_ROUTINE(T) CPH_LOOKUP_BATCH_INLINE_ROUTINE_NAME(T)\n"
+    "\n"
+    "#define CPH_TRY_LOOKUP_ROUTINE(T) CPH_TRY_LOOKUP_ROUTINE_NAME(T)\n"
+    "#define CPH_TRY_LOOKUP_INLINE_ROUTINE(T) CPH_TRY_LOOKUP_INLINE_ROUTINE_NAME(T)\n"
     "#endif\n"
     "\n"
+    "#define CPH_CONTAINS_ROUTINE(T) CPH_CONTAINS_ROUTINE_NAME(T)\n"
+    "#define CPH_CONTAINS_INLINE_ROUTINE(T) CPH_CONTAINS_INLINE_ROUTINE_NAME(T)\n"
+    "\n"
+    "#define CPH_INDEX_STRING_ROUTINE(T) CPH_INDEX_STRING_ROUTINE_NAME(T)\n"
+    "#define CPH_TRY_INDEX_STRING_ROUTINE(T) CPH_TRY_INDEX_STRING_ROUTINE_NAME(T)\n"
+    "#define CPH_INDEX_STRING_INLINE_ROUTINE(T) CPH_INDEX_STRING_INLINE_ROUTINE_NAME(T)\n"
+    "#define CPH_TRY_INDEX_STRING_INLINE_ROUTINE(T) CPH_TRY_INDEX_STRING_INLINE_ROUTINE_NAME(T)\n"
+    "\n"
+    "#define CPH_DEFINE_STRING_TABLE_ROUTINES(T)         \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_INDEX_STRING     \\\n"
+    "    CompiledPerfectHash_##T##_IndexString;          \\\n"
+    "CPHAPI COMPILED_PERFECT_HASH_TABLE_TRY_INDEX_STRING \\\n"
+    "    CompiledPerfectHash_##T##_TryIndexString\n"
+    "\n"
+    "#define CPH_HASH_AVX2_ROUTINE(T) CPH_HASH_AVX2_ROUTINE_NAME(T)\n"
+    "\n"
     "#define EXPAND_SEED1(U) CPH_SEED1(U)\n"
     "#define EXPAND_SEED2(U) CPH_SEED2(U)\n"
     "#define EXPAND_SEED3(U) CPH_SEED3(U)\n"
@@ -371,9 +667,17 @@ const CHAR CompiledPerfectHashMacroGlueCHeaderRawCStr[] =
     "#define EXPAND_HASH_MODULUS(U) CPH_HASH_MODULUS(U)\n"
     "#define EXPAND_INDEX_MODULUS(U) CPH_INDEX_MODULUS(U)\n"
     "#define EXPAND_TABLE_DATA(T) CPH_TABLE_DATA(T)\n"
+    "#define EXPAND_TABLE_SHARDS(T) CPH_TABLE_SHARDS(T)\n"
+    "#define EXPAND_NUMBER_OF_SHARDS(U) CPH_NUMBER_OF_SHARDS(U)\n"
+    "#define EXPAND_TABLE_DATA_BITS(U) CPH_TABLE_DATA_BITS(U)\n"
     "#define EXPAND_TABLE_VALUES(T) CPH_TABLE_VALUES(T)\n"
+    "#define EXPAND_TABLE_FINGERPRINTS(T) CPH_TABLE_FINGERPRINTS(T)\n"
+    "#define EXPAND_TABLE_SLOTS(T) CPH_TABLE_SLOTS(T)\n"
     "#define EXPAND_KEYS(T) CPH_KEYS(T)\n"
     "#define EXPAND_NUMBER_OF_KEYS(U) CPH_NUMBER_OF_KEYS(U)\n"
+    "#define EXPAND_STRING_KEY_OFFSETS(T) CPH_STRING_KEY_OFFSETS(T)\n"
+    "#define EXPAND_STRING_KEY_DATA(T) CPH_STRING_KEY_DATA(T)\n"
+    "#define EXPAND_STRING_KEY_SEED(U) CPH_STRING_KEY_SEED(U)\n"
     "\n"
     "#define EXPAND_DOWNSIZE_KEY(U) CPH_DOWNSIZE_KEY(U)\n"
     "#define EXPAND_ROTATE_KEY_LEFT(U) CPH_ROTATE_KEY_LEFT(U)\n"
@@ -399,6 +703,39 @@ const CHAR CompiledPerfectHashMacroGlueCHeaderRawCStr[] =
     "#define EXPAND_INSERT_INLINE_ROUTINE_HEADER(T) CPH_INSERT_INLINE_ROUTINE_HEADER(T)\n"
     "#define EXPAND_DELETE_INLINE_ROUTINE_HEADER(T) CPH_DELETE_INLINE_ROUTINE_HEADER(T)\n"
     "\n"
+    "#define EXPAND_INDEX_BATCH_ROUTINE(T) CPH_INDEX_BATCH_ROUTINE(T)\n"
+    "#define EXPAND_LOOKUP_BATCH_ROUTINE(T) CPH_LOOKUP_BATCH_ROUTINE(T)\n"
+    "#define EXPAND_INDEX_BATCH_INLINE_ROUTINE(T) CPH_INDEX_BATCH_INLINE_ROUTINE(T)\n"
+    "#define EXPAND_LOOKUP_BATCH_INLINE_ROUTINE(T) CPH_LOOKUP_BATCH_INLINE_ROUTINE(T)\n"
+    "\n"
+    "#define EXPAND_INDEX_BATCH_ROUTINE_HEADER(T) CPH_INDEX_BATCH_ROUTINE_HEADER(T)\n"
+    "#define EXPAND_LOOKUP_BATCH_ROUTINE_HEADER(T) CPH_LOOKUP_BATCH_ROUTINE_HEADER(T)\n"
+    "#define EXPAND_INDEX_BATCH_INLINE_ROUTINE_HEADER(T) CPH_INDEX_BATCH_INLINE_ROUTINE_HEADER(T)\n"
+    "#define EXPAND_LOOKUP_BATCH_INLINE_ROUTINE_HEADER(T) CPH_LOOKUP_BATCH_INLINE_ROUTINE_HEADER(T)\n"
+    "\n"
+    "#define EXPAND_CONTAINS_ROUTINE(T) CPH_CONTAINS_ROUTINE(T)\n"
+    "#define EXPAND_TRY_LOOKUP_ROUTINE(T) CPH_TRY_LOOKUP_ROUTINE(T)\n"
+    "#define EXPAND_CONTAINS_INLINE_ROUTINE(T) CPH_CONTAINS_INLINE_ROUTINE(T)\n"
+    "#define EXPAND_TRY_LOOKUP_INLINE_ROUTINE(T) CPH_TRY_LOOKUP_INLINE_ROUTINE(T)\n"
+    "\n"
+    "#define EXPAND_CONTAINS_ROUTINE_HEADER(T) CPH_CONTAINS_ROUTINE_HEADER(T)\n"
+    "#define EXPAND_TRY_LOOKUP_ROUTINE_HEADER(T) CPH_TRY_LOOKUP_ROUTINE_HEADER(T)\n"
+    "#define EXPAND_CONTAINS_INLINE_ROUTINE_HEADER(T) CPH_CONTAINS_INLINE_ROUTINE_HEADER(T)\n"
+    "#define EXPAND_TRY_LOOKUP_INLINE_ROUTINE_HEADER(T) CPH_TRY_LOOKUP_INLINE_ROUTINE_HEADER(T)\n"
+    "\n"
+    "#define EXPAND_INDEX_STRING_ROUTINE(T) CPH_INDEX_STRING_ROUTINE(T)\n"
+    "#define EXPAND_TRY_INDEX_STRING_ROUTINE(T) CPH_TRY_INDEX_STRING_ROUTINE(T)\n"
+    "#define EXPAND_INDEX_STRING_INLINE_ROUTINE(T) CPH_INDEX_STRING_INLINE_ROUTINE(T)\n"
+    "#define EXPAND_TRY_INDEX_STRING_INLINE_ROUTINE(T) CPH_TRY_INDEX_STRING_INLINE_ROUTINE(T)\n"
+    "\n"
+    "#define EXPAND_INDEX_STRING_ROUTINE_HEADER(T) CPH_INDEX_STRING_ROUTINE_HEADER(T)\n"
+    "#define EXPAND_TRY_INDEX_STRING_ROUTINE_HEADER(T) CPH_TRY_INDEX_STRING_ROUTINE_HEADER(T)\n"
+    "#define EXPAND_INDEX_STRING_INLINE_ROUTINE_HEADER(T) CPH_INDEX_STRING_INLINE_ROUTINE_HEADER(T)\n"
+    "#define EXPAND_TRY_INDEX_STRING_INLINE_ROUTINE_HEADER(T) CPH_TRY_INDEX_STRING_INLINE_ROUTINE_HEADER(T)\n"
+    "\n"
+    "#define EXPAND_HASH_AVX2_ROUTINE(T) CPH_HASH_AVX2_ROUTINE(T)\n"
+    "#define EXPAND_HASH_AVX2_ROUTINE_HEADER(T) CPH_HASH_AVX2_ROUTINE_HEADER(T)\n"
+    "\n"
     "#define EXPAND_TEST_CPH_ROUTINE_HEADER(T) TEST_CPH_ROUTINE_HEADER(T)\n"
     "#define EXPAND_BENCHMARK_FULL_CPH_ROUTINE_HEADER(T) BENCHMARK_FULL_CPH_ROUTINE_HEADER(T)\n"
     "#define EXPAND_BENCHMARK_INDEX_CPH_ROUTINE_HEADER(T) BENCHMARK_INDEX_CPH_ROUTINE_HEADER(T)\n"
@@ -408,6 +745,7 @@ const CHAR CompiledPerfectHashMacroGlueCHeaderRawCStr[] =
     "#define EXPAND_BENCHMARK_INDEX_CPH_ROUTINE_NAME(T) CPH_BENCHMARK_INDEX_CPH_ROUTINE_NAME(T)\n"
     "\n"
     "#define EXPAND_DEFINE_TABLE_ROUTINES(T) CPH_DEFINE_TABLE_ROUTINES(T)\n"
+    "#define EXPAND_DEFINE_STRING_TABLE_ROUTINES(T) CPH_DEFINE_STRING_TABLE_ROUTINES(T)\n"
     "#define EXPAND_DEFINE_TEST_AND_BENCHMARKING_ROUTINES(T) CPH_DEFINE_TEST_AND_BENCHMARKING_ROUTINES(T)\n"
     "\n"
     "#define SEED1 EXPAND_SEED1(CPH_TABLENAME_UPPER)\n"
@@ -480,12 +818,67 @@ const CHAR CompiledPerfectHashMacroGlueCHeaderRawCStr[] =
     "#define HASH_MODULUS EXPAND_HASH_MODULUS(CPH_TABLENAME_UPPER)\n"
     "#define INDEX_MODULUS EXPAND_INDEX_MODULUS(CPH_TABLENAME_UPPER)\n"
     "#define TABLE_DATA EXPAND_TABLE_DATA(CPH_TABLENAME)\n"
+    "#define TABLE_SHARDS EXPAND_TABLE_SHARDS(CPH_TABLENAME)\n"
+    "#define NUMBER_OF_SHARDS EXPAND_NUMBER_OF_SHARDS(CPH_TABLENAME_UPPER)\n"
+    "#define TABLE_DATA_BITS EXPAND_TABLE_DATA_BITS(CPH_TABLENAME_UPPER)\n"
     "#define TABLE_VALUES EXPAND_TABLE_VALUES(CPH_TABLENAME)\n"
+    "#define TABLE_FINGERPRINTS EXPAND_TABLE_FINGERPRINTS(CPH_TABLENAME)\n"
+    "#define TABLE_SLOTS EXPAND_TABLE_SLOTS(CPH_TABLENAME)\n"
     "#define KEYS EXPAND_KEYS(CPH_TABLENAME)\n"
     "#define NUMBER_OF_KEYS EXPAND_NUMBER_OF_KEYS(CPH_TABLENAME_UPPER)\n"
+    "#define STRING_KEY_OFFSETS EXPAND_STRING_KEY_OFFSETS(CPH_TABLENAME)\n"
+    "#define STRING_KEY_DATA EXPAND_STRING_KEY_DATA(CPH_TABLENAME)\n"
+    "#define STRING_KEY_SEED EXPAND_STRING_KEY_SEED(CPH_TABLENAME_UPPER)\n"
+    "#define HASH_STRING_KEY(S, L) CphHashStringKey((S), (L), STRING_KEY_SEED)\n"
     "#define DOWNSIZE_KEY(K) EXPAND_DOWNSIZE_KEY(CPH_TABLENAME_UPPER)(K)\n"
     "#define ROTATE_KEY_LEFT EXPAND_ROTATE_KEY_LEFT(CPH_TABLENAME_UPPER)\n"
     "#define ROTATE_KEY_RIGHT EXPAND_ROTATE_KEY_RIGHT(CPH_TABLENAME_UPPER)\n"
+    "#define FINGERPRINT_KEY(K) (                                          \\\n"
+    "    (CPHFINGERPRINT)(                                                 \\\n"
+    "        CphFingerprintKey((ULONG)DOWNSIZE_KEY(K)) >>                  \\\n"
+    "        (32 - (sizeof(CPHFINGERPRINT) << 3))                          \\\n"
+    "    )                                                                 \\\n"
+    ")\n"
+    "\n"
+    "//\n"
+    "// 128-bit keys are structures, so the test and benchmark routines derive a\n"
+    "// value from a key, and compare keys, via the following helper macros.\n"
+    "//\n"
+    "\n"
+    "#ifdef CPH_KEY128\n"
+    "#define KEY_TO_VALUE(K) ((CPHVALUE)((K).Low ^ (K).High))\n"
+    "#define KEYS_EQUAL(A, B) ((A).Low == (B).Low && (A).High == (B).High)\n"
+    "#else\n"
+    "#define KEY_TO_VALUE(K) ((CPHVALUE)(K))\n"
+    "#define KEYS_EQUAL(A, B) ((A) == (B))\n"
+    "#endif\n"
+    "\n"
+    "//\n"
+    "// If the table data is interleaved with the table values, each value resides\n"
+    "// in the slot of the vertex it is indexed by.\n"
+    "//\n"
+    "\n"
+    "#ifdef CPH_INTERLEAVED_TABLE_DATA\n"
+    "#define TABLE_VALUE(I) (TABLE_SLOTS[(I)].Value)\n"
+    "#else\n"
+    "#define TABLE_VALUE(I) (TABLE_VALUES[(I)])\n"
+    "#endif\n"
+    "\n"
+    "//\n"
+    "// If the table data is packed, elements are extracted from the bit stream\n"
+    "// rather than indexed directly.  The batch routines gather eight table data\n"
+    "// elements at a time via GATHER_TABLE_DATA().\n"
+    "//\n"
+    "\n"
+    "#ifdef CPH_PACKED_TABLE_DATA\n"
+    "#define UNPACK_TABLE_DATA(I) \\\n"
+    "    CphUnpackTableData(TABLE_DATA, (I), TABLE_DATA_BITS)\n"
+    "#define GATHER_TABLE_DATA(V) \\\n"
+    "    CphGatherPackedTableData256(TABLE_DATA, (V), TABLE_DATA_BITS)\n"
+    "#else\n"
+    "#define GATHER_TABLE_DATA(V) \\\n"
+    "    CphGatherTableData256(TABLE_DATA, (V), sizeof(TABLE_DATA[0]))\n"
+    "#endif\n"
     "\n"
     "#define DECLARE_INDEX_ROUTINE_HEADER() EXPAND_INDEX_ROUTINE_HEADER(CPH_TABLENAME)\n"
     "#define DECLARE_LOOKUP_ROUTINE_HEADER() EXPAND_LOOKUP_ROUTINE_HEADER(CPH_TABLENAME)\n"
@@ -502,6 +895,9 @@ const CHAR CompiledPerfectHashMacroGlueCHeaderRawCStr[] =
     "#define INSERT_INLINE_ROUTINE EXPAND_INSERT_INLINE_ROUTINE(CPH_TABLENAME)\n"
     "#define DELETE_INLINE_ROUTINE EXPAND_DELETE_INLINE_ROUTINE(CPH_TABLENAME)\n"
     "\n"
+    "#define HASH_AVX2_ROUTINE EXPAND_HASH_AVX2_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_HASH_AVX2_ROUTINE() EXPAND_HASH_AVX2_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
     "#define TEST_CPH_ROUTINE EXPAND_TEST_CPH_ROUTINE_NAME(CPH_TABLENAME)\n"
     "#define BENCHMARK_FULL_CPH_ROUTINE EXPAND_BENCHMARK_FULL_CPH_ROUTINE_NAME(CPH_TABLENAME)\n"
     "#define BENCHMARK_INDEX_CPH_ROUTINE EXPAND_BENCHMARK_INDEX_CPH_ROUTINE_NAME(CPH_TABLENAME)\n"
@@ -511,6 +907,7 @@ const CHAR CompiledPerfectHashMacroGlueCHeaderRawCStr[] =
     "#define DECLARE_BENCHMARK_INDEX_CPH_ROUTINE() EXPAND_BENCHMARK_INDEX_CPH_ROUTINE_HEADER(CPH_TABLENAME)\n"
     "\n"
     "#define DEFINE_TABLE_ROUTINES() EXPAND_DEFINE_TABLE_ROUTINES(CPH_TABLENAME)\n"
+    "#define DEFINE_STRING_TABLE_ROUTINES() EXPAND_DEFINE_STRING_TABLE_ROUTINES(CPH_TABLENAME)\n"
     "#define DEFINE_TEST_AND_BENCHMARKING_ROUTINES() EXPAND_DEFINE_TEST_AND_BENCHMARKING_ROUTINES(CPH_TABLENAME)\n"
     "\n"
     "\n"
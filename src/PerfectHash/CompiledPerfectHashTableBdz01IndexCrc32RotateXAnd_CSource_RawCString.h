@@ -0,0 +1,76 @@
+//
+// Auto-generated.
+//
+
+DECLSPEC_ALIGN(16)
+const CHAR CompiledPerfectHashTableBdz01IndexCrc32RotateXAndCSourceRawCStr[] =
+    "\n"
+    "//\n"
+    "// Begin CompiledPerfectHashTableBdz01IndexCrc32RotateXAnd.c.\n"
+    "//\n"
+    "\n"
+    "\n"
+    "//\n"
+    "// N.B. The multipliers and partition reduction must match Bdz01.h.\n"
+    "//\n"
+    "\n"
+    "DECLARE_INDEX_ROUTINE()\n"
+    "{\n"
+    "    ULONG Hash1;\n"
+    "    ULONG Hash2;\n"
+    "    ULONG Hash3;\n"
+    "    ULONGLONG Sum;\n"
+    "    CPHDKEY Vertex1;\n"
+    "    CPHDKEY Vertex2;\n"
+    "    CPHDKEY Vertex3;\n"
+    "    CPHDKEY DownsizedKey;\n"
+    "\n"
+    "    DownsizedKey = DOWNSIZE_KEY(Key);\n"
+    "\n"
+    "    Vertex1 = _mm_crc32_u32(SEED1, DownsizedKey);\n"
+    "    Vertex2 = _mm_crc32_u32(SEED2, _rotl(DownsizedKey, SEED3_BYTE1));\n"
+    "\n"
+    "    Hash1 = (ULONG)Vertex1 * 0x9e3779b1;\n"
+    "    Hash2 = (ULONG)Vertex2 * 0x85ebca77;\n"
+    "    Hash3 = (ULONG)(Vertex1 ^ Vertex2) * 0xc2b2ae3d;\n"
+    "\n"
+    "    Vertex1 = (CPHDKEY)(((ULONGLONG)Hash1 * HASH_MODULUS) >> 32);\n"
+    "    Vertex2 = (CPHDKEY)(((ULONGLONG)Hash2 * HASH_MODULUS) >> 32);\n"
+    "    Vertex3 = (CPHDKEY)(((ULONGLONG)Hash3 * HASH_MODULUS) >> 32);\n"
+    "\n"
+    "    Sum = (\n"
+    "        (ULONGLONG)TABLE_DATA[Vertex1] +\n"
+    "        (ULONGLONG)TABLE_DATA[Vertex2 + HASH_MODULUS] +\n"
+    "        (ULONGLONG)TABLE_DATA[Vertex3 + (HASH_MODULUS * 2)]\n"
+    "    );\n"
+    "\n"
+    "    if (Sum >= INDEX_MODULUS) {\n"
+    "        Sum -= INDEX_MODULUS;\n"
+    "    }\n"
+    "\n"
+    "    if (Sum >= INDEX_MODULUS) {\n"
+    "        Sum -= INDEX_MODULUS;\n"
+    "    }\n"
+    "\n"
+    "    return (CPHINDEX)Sum;\n"
+    "}\n"
+    "\n"
+    "\n"
+    "//\n"
+    "// End CompiledPerfectHashTableBdz01IndexCrc32RotateXAnd.c.\n"
+    "//\n"
+    "\n"
+;
+
+const STRING CompiledPerfectHashTableBdz01IndexCrc32RotateXAndCSourceRawCString = {
+    sizeof(CompiledPerfectHashTableBdz01IndexCrc32RotateXAndCSourceRawCStr) - sizeof(CHAR),
+    sizeof(CompiledPerfectHashTableBdz01IndexCrc32RotateXAndCSourceRawCStr),
+#ifdef _WIN64
+    0,
+#endif
+    (PCHAR)&CompiledPerfectHashTableBdz01IndexCrc32RotateXAndCSourceRawCStr,
+};
+
+#ifndef RawCString
+#define RawCString (&CompiledPerfectHashTableBdz01IndexCrc32RotateXAndCSourceRawCString)
+#endif
@@ -42,7 +42,7 @@ const CHAR CompiledPerfectHashTableBenchmarkFullCSourceRawCStr[] =
     "                FOR_EACH_KEY {\n"
     "                    Key = *Source++;\n"
     "                    Rotated = ROTATE_KEY_LEFT(Key, 15);\n"
-    "                    Previous = INSERT_ROUTINE(Key, (CPHVALUE)Rotated);\n"
+    "                    Previous = INSERT_ROUTINE(Key, KEY_TO_VALUE(Rotated));\n"
     "                }\n"
     "\n"
     "                //\n"
@@ -91,7 +91,7 @@ const CHAR CompiledPerfectHashTableBenchmarkFullCSourceRawCStr[] =
     "                FOR_EACH_KEY {\n"
     "                    Key = *Source++;\n"
     "                    Rotated = ROTATE_KEY_LEFT(Key, 15);\n"
-    "                    Previous = INSERT_ROUTINE(Key, (CPHVALUE)Rotated);\n"
+    "                    Previous = INSERT_ROUTINE(Key, KEY_TO_VALUE(Rotated));\n"
     "                }\n"
     "\n"
     "                //\n"
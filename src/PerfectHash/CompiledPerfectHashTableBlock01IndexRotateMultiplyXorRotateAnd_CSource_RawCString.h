@@ -0,0 +1,86 @@
+//
+// Auto-generated.
+//
+
+DECLSPEC_ALIGN(16)
+const CHAR CompiledPerfectHashTableBlock01IndexRotateMultiplyXorRotateAndCSourceRawCStr[] =
+    "\n"
+    "//\n"
+    "// Begin CompiledPerfectHashTableBlock01IndexRotateMultiplyXorRotateAnd.c.\n"
+    "//\n"
+    "\n"
+    "//\n"
+    "// N.B. The multipliers, block reduction and slot derivation must match\n"
+    "//      Block01.h.\n"
+    "//\n"
+    "\n"
+    "DECLARE_INDEX_ROUTINE()\n"
+    "{\n"
+    "    ULONG Hash1;\n"
+    "    ULONG Mixed;\n"
+    "    ULONG Slot1;\n"
+    "    ULONG Slot2;\n"
+    "    ULONG BlockHash;\n"
+    "    ULONGLONG Sum;\n"
+    "    CPHDKEY Vertex1;\n"
+    "    CPHDKEY Vertex2;\n"
+    "    CPHDKEY DownsizedKey;\n"
+    "    const ULONG *Block;\n"
+    "\n"
+    "    DownsizedKey = DOWNSIZE_KEY(Key);\n"
+    "\n"
+    "    Vertex1 = _rotr(DownsizedKey, SEED3_BYTE1);\n"
+    "    Vertex1 *= SEED1;\n"
+    "    Vertex1 ^= _rotr(Vertex1, SEED3_BYTE2);\n"
+    "\n"
+    "    Vertex2 = _rotr(DownsizedKey, SEED3_BYTE3);\n"
+    "    Vertex2 *= SEED2;\n"
+    "    Vertex2 ^= _rotr(Vertex2, SEED3_BYTE4);\n"
+    "\n"
+    "    Hash1 = (ULONG)Vertex1 * 0x9e3779b1;\n"
+    "    BlockHash = (ULONG)Vertex2 ^ Hash1;\n"
+    "\n"
+    "    Block = &TABLE_DATA[(((ULONGLONG)Hash1 * HASH_MODULUS) >> 32) << 4];\n"
+    "\n"
+    "    Mixed = BlockHash ^ (ULONG)Block[15];\n"
+    "    Mixed ^= Mixed >> 16;\n"
+    "    Mixed *= 0x85ebca6b;\n"
+    "    Mixed ^= Mixed >> 13;\n"
+    "    Mixed *= 0xc2b2ae35;\n"
+    "    Mixed ^= Mixed >> 16;\n"
+    "\n"
+    "    Slot1 = ((Mixed >> 16) * 15) >> 16;\n"
+    "    Slot2 = Slot1 + ((((Mixed & 0xffff) * 14) >> 16) + 1);\n"
+    "\n"
+    "    if (Slot2 >= 15) {\n"
+    "        Slot2 -= 15;\n"
+    "    }\n"
+    "\n"
+    "    Sum = (ULONGLONG)Block[Slot1] + (ULONGLONG)Block[Slot2];\n"
+    "\n"
+    "    if (Sum >= INDEX_MODULUS) {\n"
+    "        Sum -= INDEX_MODULUS;\n"
+    "    }\n"
+    "\n"
+    "    return (CPHINDEX)Sum;\n"
+    "}\n"
+    "\n"
+    "\n"
+    "//\n"
+    "// End CompiledPerfectHashTableBlock01IndexRotateMultiplyXorRotateAnd.c.\n"
+    "//\n"
+    "\n"
+;
+
+const STRING CompiledPerfectHashTableBlock01IndexRotateMultiplyXorRotateAndCSourceRawCString = {
+    sizeof(CompiledPerfectHashTableBlock01IndexRotateMultiplyXorRotateAndCSourceRawCStr) - sizeof(CHAR),
+    sizeof(CompiledPerfectHashTableBlock01IndexRotateMultiplyXorRotateAndCSourceRawCStr),
+#ifdef _WIN64
+    0,
+#endif
+    (PCHAR)&CompiledPerfectHashTableBlock01IndexRotateMultiplyXorRotateAndCSourceRawCStr,
+};
+
+#ifndef RawCString
+#define RawCString (&CompiledPerfectHashTableBlock01IndexRotateMultiplyXorRotateAndCSourceRawCString)
+#endif
@@ -0,0 +1,63 @@
+//
+// Auto-generated.
+//
+
+DECLSPEC_ALIGN(16)
+const CHAR CompiledPerfectHashTableChm01IndexCrc32RotateXMultiplyHighCSourceRawCStr[] =
+    "\n"
+    "//\n"
+    "// Begin CompiledPerfectHashTableChm01IndexCrc32RotateXMultiplyHigh.c.\n"
+    "//\n"
+    "\n"
+    "//\n"
+    "// N.B. The multiplier and range reduction must match PerfectHashTable.h.\n"
+    "//\n"
+    "\n"
+    "DECLARE_INDEX_ROUTINE()\n"
+    "{\n"
+    "    ULONG Hash1;\n"
+    "    ULONG Hash2;\n"
+    "    ULONGLONG Sum;\n"
+    "    CPHDKEY Vertex1;\n"
+    "    CPHDKEY Vertex2;\n"
+    "    CPHDKEY DownsizedKey;\n"
+    "\n"
+    "    DownsizedKey = DOWNSIZE_KEY(Key);\n"
+    "\n"
+    "    Vertex1 = _mm_crc32_u32(SEED1, DownsizedKey);\n"
+    "    Vertex2 = _mm_crc32_u32(SEED2, _rotl(DownsizedKey, SEED3_BYTE1));\n"
+    "\n"
+    "    Hash1 = (ULONG)Vertex1 * 0x9e3779b1;\n"
+    "    Hash2 = (ULONG)Vertex2 * 0x9e3779b1;\n"
+    "\n"
+    "    Vertex1 = (CPHDKEY)(((ULONGLONG)Hash1 * HASH_MODULUS) >> 32);\n"
+    "    Vertex2 = (CPHDKEY)(((ULONGLONG)Hash2 * HASH_MODULUS) >> 32);\n"
+    "\n"
+    "    Sum = (ULONGLONG)TABLE_DATA[Vertex1] + (ULONGLONG)TABLE_DATA[Vertex2];\n"
+    "\n"
+    "    if (Sum >= INDEX_MODULUS) {\n"
+    "        Sum -= INDEX_MODULUS;\n"
+    "    }\n"
+    "\n"
+    "    return (CPHINDEX)Sum;\n"
+    "}\n"
+    "\n"
+    "\n"
+    "//\n"
+    "// End CompiledPerfectHashTableChm01IndexCrc32RotateXMultiplyHigh.c.\n"
+    "//\n"
+    "\n"
+;
+
+const STRING CompiledPerfectHashTableChm01IndexCrc32RotateXMultiplyHighCSourceRawCString = {
+    sizeof(CompiledPerfectHashTableChm01IndexCrc32RotateXMultiplyHighCSourceRawCStr) - sizeof(CHAR),
+    sizeof(CompiledPerfectHashTableChm01IndexCrc32RotateXMultiplyHighCSourceRawCStr),
+#ifdef _WIN64
+    0,
+#endif
+    (PCHAR)&CompiledPerfectHashTableChm01IndexCrc32RotateXMultiplyHighCSourceRawCStr,
+};
+
+#ifndef RawCString
+#define RawCString (&CompiledPerfectHashTableChm01IndexCrc32RotateXMultiplyHighCSourceRawCString)
+#endif
@@ -29,7 +29,7 @@ const CHAR CompiledPerfectHashTableChm01IndexJenkinsModAndCSourceRawCStr[] =
     "    CPHDKEY DownsizedKey;\n"
     "\n"
     "    DownsizedKey = DOWNSIZE_KEY(Key);\n"
-    "    Byte = (PBYTE)&Key;\n"
+    "    Byte = (PBYTE)&DownsizedKey;\n"
     "\n"
     "    A = B = 0x9e3779b9;\n"
     "    C = SEED1;\n"
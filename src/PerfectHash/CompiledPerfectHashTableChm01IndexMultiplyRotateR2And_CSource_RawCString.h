@@ -42,6 +42,30 @@ const CHAR CompiledPerfectHashTableChm01IndexMultiplyRotateR2AndCSourceRawCStr[]
     "    return Index;\n"
     "}\n"
     "\n"
+    "#if defined(CPH_AVX2) && !defined(CPH_HAS_HASH_AVX2)\n"
+    "#define CPH_HAS_HASH_AVX2\n"
+    "\n"
+    "DECLARE_HASH_AVX2_ROUTINE()\n"
+    "{\n"
+    "    __m256i Vertex1;\n"
+    "    __m256i Vertex2;\n"
+    "\n"
+    "    Vertex1 = _mm256_mullo_epi32(DownsizedKeys, _mm256_set1_epi32((int)SEED1));\n"
+    "    Vertex1 = CphRotr256(Vertex1, SEED3_BYTE1);\n"
+    "    Vertex1 = _mm256_mullo_epi32(Vertex1, _mm256_set1_epi32((int)SEED2));\n"
+    "    Vertex1 = CphRotr256(Vertex1, SEED3_BYTE2);\n"
+    "\n"
+    "    Vertex2 = _mm256_mullo_epi32(DownsizedKeys, _mm256_set1_epi32((int)SEED4));\n"
+    "    Vertex2 = CphRotr256(Vertex2, SEED3_BYTE3);\n"
+    "    Vertex2 = _mm256_mullo_epi32(Vertex2, _mm256_set1_epi32((int)SEED5));\n"
+    "    Vertex2 = CphRotr256(Vertex2, SEED3_BYTE4);\n"
+    "\n"
+    "    *Vertex1Pointer = Vertex1;\n"
+    "    *Vertex2Pointer = Vertex2;\n"
+    "}\n"
+    "\n"
+    "#endif\n"
+    "\n"
     "\n"
     "//\n"
     "// End CompiledPerfectHashTableChm01IndexMultiplyRotateR2And.c.\n"
@@ -0,0 +1,59 @@
+//
+// Auto-generated.
+//
+
+DECLSPEC_ALIGN(16)
+const CHAR CompiledPerfectHashTableChm01IndexMultiplyShiftRAndInterleavedCSourceRawCStr[] =
+    "\n"
+    "//\n"
+    "// Begin CompiledPerfectHashTableChm01IndexMultiplyShiftRAndInterleaved.c.\n"
+    "//\n"
+    "\n"
+    "\n"
+    "DECLARE_INDEX_ROUTINE()\n"
+    "{\n"
+    "    CPHINDEX Index;\n"
+    "    CPHDKEY Vertex1;\n"
+    "    CPHDKEY Vertex2;\n"
+    "    CPHDKEY MaskedLow;\n"
+    "    CPHDKEY MaskedHigh;\n"
+    "    CPHDKEY DownsizedKey;\n"
+    "\n"
+    "    DownsizedKey = DOWNSIZE_KEY(Key);\n"
+    "\n"
+    "    Vertex1 = DownsizedKey * SEED1;\n"
+    "    Vertex1 = Vertex1 >> SEED3_BYTE1;\n"
+    "\n"
+    "    Vertex2 = DownsizedKey * SEED2;\n"
+    "    Vertex2 = Vertex2 >> SEED3_BYTE2;\n"
+    "\n"
+    "    MaskedLow = Vertex1 & HASH_MASK;\n"
+    "    MaskedHigh = Vertex2 & HASH_MASK;\n"
+    "\n"
+    "    Vertex1 = TABLE_SLOTS[MaskedLow].Assigned;\n"
+    "    Vertex2 = TABLE_SLOTS[MaskedHigh].Assigned;\n"
+    "\n"
+    "    Index = (CPHINDEX)((Vertex1 + Vertex2) & INDEX_MASK);\n"
+    "\n"
+    "    return Index;\n"
+    "}\n"
+    "\n"
+    "\n"
+    "//\n"
+    "// End CompiledPerfectHashTableChm01IndexMultiplyShiftRAndInterleaved.c.\n"
+    "//\n"
+    "\n"
+;
+
+const STRING CompiledPerfectHashTableChm01IndexMultiplyShiftRAndInterleavedCSourceRawCString = {
+    sizeof(CompiledPerfectHashTableChm01IndexMultiplyShiftRAndInterleavedCSourceRawCStr) - sizeof(CHAR),
+    sizeof(CompiledPerfectHashTableChm01IndexMultiplyShiftRAndInterleavedCSourceRawCStr),
+#ifdef _WIN64
+    0,
+#endif
+    (PCHAR)&CompiledPerfectHashTableChm01IndexMultiplyShiftRAndInterleavedCSourceRawCStr,
+};
+
+#ifndef RawCString
+#define RawCString (&CompiledPerfectHashTableChm01IndexMultiplyShiftRAndInterleavedCSourceRawCString)
+#endif
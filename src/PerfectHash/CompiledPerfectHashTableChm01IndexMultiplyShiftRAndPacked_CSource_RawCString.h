@@ -0,0 +1,79 @@
+//
+// Auto-generated.
+//
+
+DECLSPEC_ALIGN(16)
+const CHAR CompiledPerfectHashTableChm01IndexMultiplyShiftRAndPackedCSourceRawCStr[] =
+    "\n"
+    "//\n"
+    "// Begin CompiledPerfectHashTableChm01IndexMultiplyShiftRAndPacked.c.\n"
+    "//\n"
+    "\n"
+    "\n"
+    "DECLARE_INDEX_ROUTINE()\n"
+    "{\n"
+    "    CPHINDEX Index;\n"
+    "    CPHDKEY Vertex1;\n"
+    "    CPHDKEY Vertex2;\n"
+    "    CPHDKEY MaskedLow;\n"
+    "    CPHDKEY MaskedHigh;\n"
+    "    CPHDKEY DownsizedKey;\n"
+    "\n"
+    "    DownsizedKey = DOWNSIZE_KEY(Key);\n"
+    "\n"
+    "    Vertex1 = DownsizedKey * SEED1;\n"
+    "    Vertex1 = Vertex1 >> SEED3_BYTE1;\n"
+    "\n"
+    "    Vertex2 = DownsizedKey * SEED2;\n"
+    "    Vertex2 = Vertex2 >> SEED3_BYTE2;\n"
+    "\n"
+    "    MaskedLow = Vertex1 & HASH_MASK;\n"
+    "    MaskedHigh = Vertex2 & HASH_MASK;\n"
+    "\n"
+    "    Vertex1 = UNPACK_TABLE_DATA(MaskedLow);\n"
+    "    Vertex2 = UNPACK_TABLE_DATA(MaskedHigh);\n"
+    "\n"
+    "    Index = (CPHINDEX)((Vertex1 + Vertex2) & INDEX_MASK);\n"
+    "\n"
+    "    return Index;\n"
+    "}\n"
+    "\n"
+    "#if defined(CPH_AVX2) && !defined(CPH_HAS_HASH_AVX2)\n"
+    "#define CPH_HAS_HASH_AVX2\n"
+    "\n"
+    "DECLARE_HASH_AVX2_ROUTINE()\n"
+    "{\n"
+    "    __m256i Vertex1;\n"
+    "    __m256i Vertex2;\n"
+    "\n"
+    "    Vertex1 = _mm256_mullo_epi32(DownsizedKeys, _mm256_set1_epi32((int)SEED1));\n"
+    "    Vertex1 = _mm256_srli_epi32(Vertex1, SEED3_BYTE1);\n"
+    "\n"
+    "    Vertex2 = _mm256_mullo_epi32(DownsizedKeys, _mm256_set1_epi32((int)SEED2));\n"
+    "    Vertex2 = _mm256_srli_epi32(Vertex2, SEED3_BYTE2);\n"
+    "\n"
+    "    *Vertex1Pointer = Vertex1;\n"
+    "    *Vertex2Pointer = Vertex2;\n"
+    "}\n"
+    "\n"
+    "#endif\n"
+    "\n"
+    "\n"
+    "//\n"
+    "// End CompiledPerfectHashTableChm01IndexMultiplyShiftRAndPacked.c.\n"
+    "//\n"
+    "\n"
+;
+
+const STRING CompiledPerfectHashTableChm01IndexMultiplyShiftRAndPackedCSourceRawCString = {
+    sizeof(CompiledPerfectHashTableChm01IndexMultiplyShiftRAndPackedCSourceRawCStr) - sizeof(CHAR),
+    sizeof(CompiledPerfectHashTableChm01IndexMultiplyShiftRAndPackedCSourceRawCStr),
+#ifdef _WIN64
+    0,
+#endif
+    (PCHAR)&CompiledPerfectHashTableChm01IndexMultiplyShiftRAndPackedCSourceRawCStr,
+};
+
+#ifndef RawCString
+#define RawCString (&CompiledPerfectHashTableChm01IndexMultiplyShiftRAndPackedCSourceRawCString)
+#endif
@@ -0,0 +1,68 @@
+//
+// Auto-generated.
+//
+
+DECLSPEC_ALIGN(16)
+const CHAR CompiledPerfectHashTableChm01IndexRotateMultiplyXorRotateMultiplyHighCSourceRawCStr[] =
+    "\n"
+    "//\n"
+    "// Begin CompiledPerfectHashTableChm01IndexRotateMultiplyXorRotateMultiplyHigh.c.\n"
+    "//\n"
+    "\n"
+    "//\n"
+    "// N.B. The multiplier and range reduction must match PerfectHashTable.h.\n"
+    "//\n"
+    "\n"
+    "DECLARE_INDEX_ROUTINE()\n"
+    "{\n"
+    "    ULONG Hash1;\n"
+    "    ULONG Hash2;\n"
+    "    ULONGLONG Sum;\n"
+    "    CPHDKEY Vertex1;\n"
+    "    CPHDKEY Vertex2;\n"
+    "    CPHDKEY DownsizedKey;\n"
+    "\n"
+    "    DownsizedKey = DOWNSIZE_KEY(Key);\n"
+    "\n"
+    "    Vertex1 = _rotr(DownsizedKey, SEED3_BYTE1);\n"
+    "    Vertex1 *= SEED1;\n"
+    "    Vertex1 ^= _rotr(Vertex1, SEED3_BYTE2);\n"
+    "\n"
+    "    Vertex2 = _rotr(DownsizedKey, SEED3_BYTE3);\n"
+    "    Vertex2 *= SEED2;\n"
+    "    Vertex2 ^= _rotr(Vertex2, SEED3_BYTE4);\n"
+    "\n"
+    "    Hash1 = (ULONG)Vertex1 * 0x9e3779b1;\n"
+    "    Hash2 = (ULONG)Vertex2 * 0x9e3779b1;\n"
+    "\n"
+    "    Vertex1 = (CPHDKEY)(((ULONGLONG)Hash1 * HASH_MODULUS) >> 32);\n"
+    "    Vertex2 = (CPHDKEY)(((ULONGLONG)Hash2 * HASH_MODULUS) >> 32);\n"
+    "\n"
+    "    Sum = (ULONGLONG)TABLE_DATA[Vertex1] + (ULONGLONG)TABLE_DATA[Vertex2];\n"
+    "\n"
+    "    if (Sum >= INDEX_MODULUS) {\n"
+    "        Sum -= INDEX_MODULUS;\n"
+    "    }\n"
+    "\n"
+    "    return (CPHINDEX)Sum;\n"
+    "}\n"
+    "\n"
+    "\n"
+    "//\n"
+    "// End CompiledPerfectHashTableChm01IndexRotateMultiplyXorRotateMultiplyHigh.c.\n"
+    "//\n"
+    "\n"
+;
+
+const STRING CompiledPerfectHashTableChm01IndexRotateMultiplyXorRotateMultiplyHighCSourceRawCString = {
+    sizeof(CompiledPerfectHashTableChm01IndexRotateMultiplyXorRotateMultiplyHighCSourceRawCStr) - sizeof(CHAR),
+    sizeof(CompiledPerfectHashTableChm01IndexRotateMultiplyXorRotateMultiplyHighCSourceRawCStr),
+#ifdef _WIN64
+    0,
+#endif
+    (PCHAR)&CompiledPerfectHashTableChm01IndexRotateMultiplyXorRotateMultiplyHighCSourceRawCStr,
+};
+
+#ifndef RawCString
+#define RawCString (&CompiledPerfectHashTableChm01IndexRotateMultiplyXorRotateMultiplyHighCSourceRawCString)
+#endif
@@ -31,6 +31,30 @@
 #include "CompiledPerfectHashTableChm01IndexMultiplyShiftR2And_CSource_RawCString.h"
 #include "CompiledPerfectHashTableChm01IndexRotateRMultiplyAnd_CSource_RawCString.h"
 #include "CompiledPerfectHashTableChm01IndexRotateRMultiplyRotateRAnd_CSource_RawCString.h"
+#include "CompiledPerfectHashTableBdz01IndexCrc32RotateXAnd_CSource_RawCString.h"
+#include "CompiledPerfectHashTableBdz01IndexMultiplyShiftRAnd_CSource_RawCString.h"
+#include "CompiledPerfectHashTableBdz01IndexRotateMultiplyXorRotateAnd_CSource_RawCString.h"
+#include "CompiledPerfectHashTableBdz01IndexShiftMultiplyXorShiftAnd_CSource_RawCString.h"
+#include "CompiledPerfectHashTableShard01IndexCrc32RotateXAnd_CSource_RawCString.h"
+#include "CompiledPerfectHashTableShard01IndexMultiplyShiftRAnd_CSource_RawCString.h"
+#include "CompiledPerfectHashTableShard01IndexRotateMultiplyXorRotateAnd_CSource_RawCString.h"
+#include "CompiledPerfectHashTableShard01IndexShiftMultiplyXorShiftAnd_CSource_RawCString.h"
+#include "CompiledPerfectHashTableBlock01IndexCrc32RotateXAnd_CSource_RawCString.h"
+#include "CompiledPerfectHashTableBlock01IndexMultiplyShiftRAnd_CSource_RawCString.h"
+#include "CompiledPerfectHashTableBlock01IndexRotateMultiplyXorRotateAnd_CSource_RawCString.h"
+#include "CompiledPerfectHashTableBlock01IndexShiftMultiplyXorShiftAnd_CSource_RawCString.h"
+#include "CompiledPerfectHashTableChm01IndexCrc32RotateXMultiplyHigh_CSource_RawCString.h"
+#include "CompiledPerfectHashTableChm01IndexMultiplyShiftRMultiplyHigh_CSource_RawCString.h"
+#include "CompiledPerfectHashTableChm01IndexRotateMultiplyXorRotateMultiplyHigh_CSource_RawCString.h"
+#include "CompiledPerfectHashTableChm01IndexShiftMultiplyXorShiftMultiplyHigh_CSource_RawCString.h"
+#include "CompiledPerfectHashTableChm01IndexCrc32RotateXAndInterleaved_CSource_RawCString.h"
+#include "CompiledPerfectHashTableChm01IndexMultiplyShiftRAndInterleaved_CSource_RawCString.h"
+#include "CompiledPerfectHashTableChm01IndexRotateMultiplyXorRotateAndInterleaved_CSource_RawCString.h"
+#include "CompiledPerfectHashTableChm01IndexShiftMultiplyXorShiftAndInterleaved_CSource_RawCString.h"
+#include "CompiledPerfectHashTableChm01IndexCrc32RotateXAndPacked_CSource_RawCString.h"
+#include "CompiledPerfectHashTableChm01IndexMultiplyShiftRAndPacked_CSource_RawCString.h"
+#include "CompiledPerfectHashTableChm01IndexRotateMultiplyXorRotateAndPacked_CSource_RawCString.h"
+#include "CompiledPerfectHashTableChm01IndexShiftMultiplyXorShiftAndPacked_CSource_RawCString.h"
 
 //
 // Keep this last.
@@ -16,6 +16,14 @@ const CHAR CompiledPerfectHashTableRoutinesPostCSourceRawCStr[] =
     "\n"
     "#undef INDEX_ROUTINE\n"
     "#undef DECLARE_INDEX_ROUTINE\n"
+    "#undef INDEX_BATCH_ROUTINE\n"
+    "#undef DECLARE_INDEX_BATCH_ROUTINE\n"
+    "#undef CONTAINS_ROUTINE\n"
+    "#undef DECLARE_CONTAINS_ROUTINE\n"
+    "#undef INDEX_STRING_ROUTINE\n"
+    "#undef DECLARE_INDEX_STRING_ROUTINE\n"
+    "#undef TRY_INDEX_STRING_ROUTINE\n"
+    "#undef DECLARE_TRY_INDEX_STRING_ROUTINE\n"
     "\n"
     "#ifndef CPH_INDEX_ONLY\n"
     "#undef LOOKUP_ROUTINE\n"
@@ -25,11 +33,27 @@ const CHAR CompiledPerfectHashTableRoutinesPostCSourceRawCStr[] =
     "#undef DECLARE_LOOKUP_ROUTINE\n"
     "#undef DECLARE_INSERT_ROUTINE\n"
     "#undef DECLARE_DELETE_ROUTINE\n"
+    "#undef LOOKUP_BATCH_ROUTINE\n"
+    "#undef DECLARE_LOOKUP_BATCH_ROUTINE\n"
+    "#undef TRY_LOOKUP_ROUTINE\n"
+    "#undef DECLARE_TRY_LOOKUP_ROUTINE\n"
     "#endif\n"
     "\n"
     "#define INDEX_ROUTINE EXPAND_INDEX_ROUTINE(CPH_TABLENAME)\n"
     "#define DECLARE_INDEX_ROUTINE() EXPAND_INDEX_ROUTINE_HEADER(CPH_TABLENAME)\n"
     "\n"
+    "#define INDEX_BATCH_ROUTINE EXPAND_INDEX_BATCH_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_INDEX_BATCH_ROUTINE() EXPAND_INDEX_BATCH_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
+    "#define CONTAINS_ROUTINE EXPAND_CONTAINS_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_CONTAINS_ROUTINE() EXPAND_CONTAINS_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
+    "#define INDEX_STRING_ROUTINE EXPAND_INDEX_STRING_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_INDEX_STRING_ROUTINE() EXPAND_INDEX_STRING_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
+    "#define TRY_INDEX_STRING_ROUTINE EXPAND_TRY_INDEX_STRING_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_TRY_INDEX_STRING_ROUTINE() EXPAND_TRY_INDEX_STRING_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
     "#ifndef CPH_INDEX_ONLY\n"
     "#define LOOKUP_ROUTINE EXPAND_LOOKUP_ROUTINE(CPH_TABLENAME)\n"
     "#define INSERT_ROUTINE EXPAND_INSERT_ROUTINE(CPH_TABLENAME)\n"
@@ -38,6 +62,12 @@ const CHAR CompiledPerfectHashTableRoutinesPostCSourceRawCStr[] =
     "#define DECLARE_LOOKUP_ROUTINE() EXPAND_LOOKUP_ROUTINE_HEADER(CPH_TABLENAME)\n"
     "#define DECLARE_INSERT_ROUTINE() EXPAND_INSERT_ROUTINE_HEADER(CPH_TABLENAME)\n"
     "#define DECLARE_DELETE_ROUTINE() EXPAND_DELETE_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
+    "#define LOOKUP_BATCH_ROUTINE EXPAND_LOOKUP_BATCH_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_LOOKUP_BATCH_ROUTINE() EXPAND_LOOKUP_BATCH_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
+    "#define TRY_LOOKUP_ROUTINE EXPAND_TRY_LOOKUP_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_TRY_LOOKUP_ROUTINE() EXPAND_TRY_LOOKUP_ROUTINE_HEADER(CPH_TABLENAME)\n"
     "#endif\n"
     "\n"
     "#endif\n"
@@ -15,6 +15,18 @@ const CHAR CompiledPerfectHashTableRoutinesPreCSourceRawCStr[] =
     "#define INDEX_ROUTINE EXPAND_INDEX_INLINE_ROUTINE(CPH_TABLENAME)\n"
     "#define DECLARE_INDEX_ROUTINE() EXPAND_INDEX_INLINE_ROUTINE_HEADER(CPH_TABLENAME)\n"
     "\n"
+    "#define INDEX_BATCH_ROUTINE EXPAND_INDEX_BATCH_INLINE_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_INDEX_BATCH_ROUTINE() EXPAND_INDEX_BATCH_INLINE_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
+    "#define CONTAINS_ROUTINE EXPAND_CONTAINS_INLINE_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_CONTAINS_ROUTINE() EXPAND_CONTAINS_INLINE_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
+    "#define INDEX_STRING_ROUTINE EXPAND_INDEX_STRING_INLINE_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_INDEX_STRING_ROUTINE() EXPAND_INDEX_STRING_INLINE_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
+    "#define TRY_INDEX_STRING_ROUTINE EXPAND_TRY_INDEX_STRING_INLINE_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_TRY_INDEX_STRING_ROUTINE() EXPAND_TRY_INDEX_STRING_INLINE_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
     "#ifndef CPH_INDEX_ONLY\n"
     "#define LOOKUP_ROUTINE EXPAND_LOOKUP_INLINE_ROUTINE(CPH_TABLENAME)\n"
     "#define INSERT_ROUTINE EXPAND_INSERT_INLINE_ROUTINE(CPH_TABLENAME)\n"
@@ -23,6 +35,12 @@ const CHAR CompiledPerfectHashTableRoutinesPreCSourceRawCStr[] =
     "#define DECLARE_LOOKUP_ROUTINE() EXPAND_LOOKUP_INLINE_ROUTINE_HEADER(CPH_TABLENAME)\n"
     "#define DECLARE_INSERT_ROUTINE() EXPAND_INSERT_INLINE_ROUTINE_HEADER(CPH_TABLENAME)\n"
     "#define DECLARE_DELETE_ROUTINE() EXPAND_DELETE_INLINE_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
+    "#define LOOKUP_BATCH_ROUTINE EXPAND_LOOKUP_BATCH_INLINE_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_LOOKUP_BATCH_ROUTINE() EXPAND_LOOKUP_BATCH_INLINE_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
+    "#define TRY_LOOKUP_ROUTINE EXPAND_TRY_LOOKUP_INLINE_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_TRY_LOOKUP_ROUTINE() EXPAND_TRY_LOOKUP_INLINE_ROUTINE_HEADER(CPH_TABLENAME)\n"
     "#endif\n"
     "\n"
     "#else\n"
@@ -30,6 +48,18 @@ const CHAR CompiledPerfectHashTableRoutinesPreCSourceRawCStr[] =
     "#define INDEX_ROUTINE EXPAND_INDEX_ROUTINE(CPH_TABLENAME)\n"
     "#define DECLARE_INDEX_ROUTINE() EXPAND_INDEX_ROUTINE_HEADER(CPH_TABLENAME)\n"
     "\n"
+    "#define INDEX_BATCH_ROUTINE EXPAND_INDEX_BATCH_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_INDEX_BATCH_ROUTINE() EXPAND_INDEX_BATCH_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
+    "#define CONTAINS_ROUTINE EXPAND_CONTAINS_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_CONTAINS_ROUTINE() EXPAND_CONTAINS_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
+    "#define INDEX_STRING_ROUTINE EXPAND_INDEX_STRING_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_INDEX_STRING_ROUTINE() EXPAND_INDEX_STRING_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
+    "#define TRY_INDEX_STRING_ROUTINE EXPAND_TRY_INDEX_STRING_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_TRY_INDEX_STRING_ROUTINE() EXPAND_TRY_INDEX_STRING_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
     "#ifndef CPH_INDEX_ONLY\n"
     "#define LOOKUP_ROUTINE EXPAND_LOOKUP_ROUTINE(CPH_TABLENAME)\n"
     "#define INSERT_ROUTINE EXPAND_INSERT_ROUTINE(CPH_TABLENAME)\n"
@@ -38,6 +68,12 @@ const CHAR CompiledPerfectHashTableRoutinesPreCSourceRawCStr[] =
     "#define DECLARE_LOOKUP_ROUTINE() EXPAND_LOOKUP_ROUTINE_HEADER(CPH_TABLENAME)\n"
     "#define DECLARE_INSERT_ROUTINE() EXPAND_INSERT_ROUTINE_HEADER(CPH_TABLENAME)\n"
     "#define DECLARE_DELETE_ROUTINE() EXPAND_DELETE_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
+    "#define LOOKUP_BATCH_ROUTINE EXPAND_LOOKUP_BATCH_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_LOOKUP_BATCH_ROUTINE() EXPAND_LOOKUP_BATCH_ROUTINE_HEADER(CPH_TABLENAME)\n"
+    "\n"
+    "#define TRY_LOOKUP_ROUTINE EXPAND_TRY_LOOKUP_ROUTINE(CPH_TABLENAME)\n"
+    "#define DECLARE_TRY_LOOKUP_ROUTINE() EXPAND_TRY_LOOKUP_ROUTINE_HEADER(CPH_TABLENAME)\n"
     "#endif\n"
     "\n"
     "#endif\n"
@@ -10,6 +10,127 @@ const CHAR CompiledPerfectHashTableRoutinesCSourceRawCStr[] =
     "//\n"
     "\n"
     "\n"
+    "DECLARE_INDEX_BATCH_ROUTINE()\n"
+    "{\n"
+    "    ULONG Offset;\n"
+    "#ifdef CPH_HAS_HASH_AVX2\n"
+    "    ULONG Lane;\n"
+    "    __m256i Index;\n"
+    "    __m256i Vertex1;\n"
+    "    __m256i Vertex2;\n"
+    "    __m256i HashMask;\n"
+    "    __m256i IndexMask;\n"
+    "    CPHDKEY DownsizedKeys[CPH_AVX2_BATCH_SIZE];\n"
+    "#endif\n"
+    "\n"
+    "    Offset = 0;\n"
+    "\n"
+    "#ifdef CPH_HAS_HASH_AVX2\n"
+    "\n"
+    "    //\n"
+    "    // Process eight keys per iteration: hash them with the table's vector\n"
+    "    // hash routine, mask the vertices, gather both table data elements, then\n"
+    "    // add and mask to obtain the indices.  This requires 32-bit (downsized)\n"
+    "    // keys; the test is a constant and will be folded by the compiler.\n"
+    "    //\n"
+    "\n"
+    "    if (sizeof(CPHDKEY) == sizeof(ULONG)) {\n"
+    "\n"
+    "        HashMask = _mm256_set1_epi32((int)HASH_MASK);\n"
+    "        IndexMask = _mm256_set1_epi32((int)INDEX_MASK);\n"
+    "\n"
+    "        for (; Offset + CPH_AVX2_BATCH_SIZE <= NumberOfKeys;\n"
+    "             Offset += CPH_AVX2_BATCH_SIZE) {\n"
+    "\n"
+    "            for (Lane = 0; Lane < CPH_AVX2_BATCH_SIZE; Lane++) {\n"
+    "                DownsizedKeys[Lane] = DOWNSIZE_KEY(Keys[Offset + Lane]);\n"
+    "            }\n"
+    "\n"
+    "            HASH_AVX2_ROUTINE(\n"
+    "                _mm256_loadu_si256((const __m256i *)DownsizedKeys),\n"
+    "                &Vertex1,\n"
+    "                &Vertex2\n"
+    "            );\n"
+    "\n"
+    "            Vertex1 = _mm256_and_si256(Vertex1, HashMask);\n"
+    "            Vertex2 = _mm256_and_si256(Vertex2, HashMask);\n"
+    "\n"
+    "            Vertex1 = GATHER_TABLE_DATA(Vertex1);\n"
+    "            Vertex2 = GATHER_TABLE_DATA(Vertex2);\n"
+    "\n"
+    "            Index = _mm256_and_si256(_mm256_add_epi32(Vertex1, Vertex2),\n"
+    "                                     IndexMask);\n"
+    "\n"
+    "            _mm256_storeu_si256((__m256i *)&Indices[Offset], Index);\n"
+    "        }\n"
+    "    }\n"
+    "\n"
+    "#endif\n"
+    "\n"
+    "    //\n"
+    "    // Scalar tail (or the entire batch, if there's no vector hash routine).\n"
+    "    //\n"
+    "\n"
+    "    for (; Offset < NumberOfKeys; Offset++) {\n"
+    "        Indices[Offset] = INDEX_ROUTINE(Keys[Offset]);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "#ifdef CPH_HAS_FINGERPRINTS\n"
+    "\n"
+    "DECLARE_CONTAINS_ROUTINE()\n"
+    "{\n"
+    "    CPHINDEX Index;\n"
+    "\n"
+    "    Index = INDEX_ROUTINE(Key);\n"
+    "    return (TABLE_FINGERPRINTS[Index] == FINGERPRINT_KEY(Key));\n"
+    "}\n"
+    "\n"
+    "#endif\n"
+    "\n"
+    "#ifdef CPH_STRING_KEYS\n"
+    "\n"
+    "DECLARE_INDEX_STRING_ROUTINE()\n"
+    "{\n"
+    "    return INDEX_ROUTINE((CPHKEY)HASH_STRING_KEY(String, Length));\n"
+    "}\n"
+    "\n"
+    "DECLARE_TRY_INDEX_STRING_ROUTINE()\n"
+    "{\n"
+    "    ULONG Offset;\n"
+    "    ULONG Current;\n"
+    "    CPHINDEX Result;\n"
+    "    const BYTE *Expected;\n"
+    "\n"
+    "    Result = INDEX_ROUTINE((CPHKEY)HASH_STRING_KEY(String, Length));\n"
+    "\n"
+    "    if (Result >= NUMBER_OF_KEYS) {\n"
+    "        goto NotFound;\n"
+    "    }\n"
+    "\n"
+    "    Offset = STRING_KEY_OFFSETS[Result];\n"
+    "    if (STRING_KEY_OFFSETS[Result + 1] - Offset != Length) {\n"
+    "        goto NotFound;\n"
+    "    }\n"
+    "\n"
+    "    Expected = &STRING_KEY_DATA[Offset];\n"
+    "    for (Current = 0; Current < Length; Current++) {\n"
+    "        if (String[Current] != Expected[Current]) {\n"
+    "            goto NotFound;\n"
+    "        }\n"
+    "    }\n"
+    "\n"
+    "    *Index = Result;\n"
+    "    return TRUE;\n"
+    "\n"
+    "NotFound:\n"
+    "    *Index = 0;\n"
+    "    return FALSE;\n"
+    "}\n"
+    "\n"
+    "#endif\n"
+    "\n"
+    "\n"
     "#ifndef CPH_INDEX_ONLY\n"
     "\n"
     "DECLARE_LOOKUP_ROUTINE()\n"
@@ -17,7 +138,7 @@ const CHAR CompiledPerfectHashTableRoutinesCSourceRawCStr[] =
     "    CPHINDEX Index;\n"
     "\n"
     "    Index = INDEX_ROUTINE(Key);\n"
-    "    return TABLE_VALUES[Index];\n"
+    "    return TABLE_VALUE(Index);\n"
     "}\n"
     "\n"
     "DECLARE_INSERT_ROUTINE()\n"
@@ -26,8 +147,8 @@ const CHAR CompiledPerfectHashTableRoutinesCSourceRawCStr[] =
     "    CPHVALUE Previous;\n"
     "\n"
     "    Index = INDEX_ROUTINE(Key);\n"
-    "    Previous = TABLE_VALUES[Index];\n"
-    "    TABLE_VALUES[Index] = Value;\n"
+    "    Previous = TABLE_VALUE(Index);\n"
+    "    TABLE_VALUE(Index) = Value;\n"
     "    return Previous;\n"
     "}\n"
     "\n"
@@ -37,11 +158,110 @@ const CHAR CompiledPerfectHashTableRoutinesCSourceRawCStr[] =
     "    CPHVALUE Previous;\n"
     "\n"
     "    Index = INDEX_ROUTINE(Key);\n"
-    "    Previous = TABLE_VALUES[Index];\n"
-    "    TABLE_VALUES[Index] = 0;\n"
+    "    Previous = TABLE_VALUE(Index);\n"
+    "    TABLE_VALUE(Index) = 0;\n"
     "    return Previous;\n"
     "}\n"
     "\n"
+    "DECLARE_LOOKUP_BATCH_ROUTINE()\n"
+    "{\n"
+    "    ULONG Offset;\n"
+    "#ifdef CPH_HAS_HASH_AVX2\n"
+    "    ULONG Lane;\n"
+    "    __m256i Index;\n"
+    "    __m256i Vertex1;\n"
+    "    __m256i Vertex2;\n"
+    "    __m256i HashMask;\n"
+    "    __m256i IndexMask;\n"
+    "    CPHDKEY DownsizedKeys[CPH_AVX2_BATCH_SIZE];\n"
+    "#endif\n"
+    "\n"
+    "    Offset = 0;\n"
+    "\n"
+    "#ifdef CPH_HAS_HASH_AVX2\n"
+    "\n"
+    "    //\n"
+    "    // As per IndexBatch(), followed by a gather of the values.  Values may be\n"
+    "    // 32-bit or 64-bit; the latter requires two 4-lane gathers.\n"
+    "    //\n"
+    "\n"
+    "    if (sizeof(CPHDKEY) == sizeof(ULONG)) {\n"
+    "\n"
+    "        HashMask = _mm256_set1_epi32((int)HASH_MASK);\n"
+    "        IndexMask = _mm256_set1_epi32((int)INDEX_MASK);\n"
+    "\n"
+    "        for (; Offset + CPH_AVX2_BATCH_SIZE <= NumberOfKeys;\n"
+    "             Offset += CPH_AVX2_BATCH_SIZE) {\n"
+    "\n"
+    "            for (Lane = 0; Lane < CPH_AVX2_BATCH_SIZE; Lane++) {\n"
+    "                DownsizedKeys[Lane] = DOWNSIZE_KEY(Keys[Offset + Lane]);\n"
+    "            }\n"
+    "\n"
+    "            HASH_AVX2_ROUTINE(\n"
+    "                _mm256_loadu_si256((const __m256i *)DownsizedKeys),\n"
+    "                &Vertex1,\n"
+    "                &Vertex2\n"
+    "            );\n"
+    "\n"
+    "            Vertex1 = _mm256_and_si256(Vertex1, HashMask);\n"
+    "            Vertex2 = _mm256_and_si256(Vertex2, HashMask);\n"
+    "\n"
+    "            Vertex1 = GATHER_TABLE_DATA(Vertex1);\n"
+    "            Vertex2 = GATHER_TABLE_DATA(Vertex2);\n"
+    "\n"
+    "            Index = _mm256_and_si256(_mm256_add_epi32(Vertex1, Vertex2),\n"
+    "                                     IndexMask);\n"
+    "\n"
+    "            if (sizeof(CPHVALUE) == sizeof(ULONG)) {\n"
+    "                _mm256_storeu_si256(\n"
+    "                    (__m256i *)&Values[Offset],\n"
+    "                    _mm256_i32gather_epi32((const int *)TABLE_VALUES,\n"
+    "                                           Index,\n"
+    "                                           sizeof(CPHVALUE))\n"
+    "                );\n"
+    "            } else {\n"
+    "                _mm256_storeu_si256(\n"
+    "                    (__m256i *)&Values[Offset],\n"
+    "                    _mm256_i32gather_epi64((const long long *)TABLE_VALUES,\n"
+    "                                           _mm256_castsi256_si128(Index),\n"
+    "                                           sizeof(CPHVALUE))\n"
+    "                );\n"
+    "                _mm256_storeu_si256(\n"
+    "                    (__m256i *)&Values[Offset + (CPH_AVX2_BATCH_SIZE / 2)],\n"
+    "                    _mm256_i32gather_epi64((const long long *)TABLE_VALUES,\n"
+    "                                           _mm256_extracti128_si256(Index, 1),\n"
+    "                                           sizeof(CPHVALUE))\n"
+    "                );\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "\n"
+    "#endif\n"
+    "\n"
+    "    for (; Offset < NumberOfKeys; Offset++) {\n"
+    "        Values[Offset] = LOOKUP_ROUTINE(Keys[Offset]);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "#ifdef CPH_HAS_FINGERPRINTS\n"
+    "\n"
+    "DECLARE_TRY_LOOKUP_ROUTINE()\n"
+    "{\n"
+    "    CPHINDEX Index;\n"
+    "\n"
+    "    Index = INDEX_ROUTINE(Key);\n"
+    "\n"
+    "    if (TABLE_FINGERPRINTS[Index] != FINGERPRINT_KEY(Key)) {\n"
+    "        *Value = 0;\n"
+    "        return FALSE;\n"
+    "    }\n"
+    "\n"
+    "    *Value = TABLE_VALUE(Index);\n"
+    "    return TRUE;\n"
+    "}\n"
+    "\n"
+    "#endif\n"
+    "\n"
     "#endif\n"
     "\n"
     "//\n"
@@ -0,0 +1,82 @@
+//
+// Auto-generated.
+//
+
+DECLSPEC_ALIGN(16)
+const CHAR CompiledPerfectHashTableShard01IndexCrc32RotateXAndCSourceRawCStr[] =
+    "\n"
+    "//\n"
+    "// Begin CompiledPerfectHashTableShard01IndexCrc32RotateXAnd.c.\n"
+    "//\n"
+    "\n"
+    "\n"
+    "//\n"
+    "// N.B. The shard selection must match Shard01GetShard() in Shard01.h, and the\n"
+    "//      layout of TABLE_SHARDS must match SHARD01_DIRECTORY_ENTRY (i.e. key\n"
+    "//      offset, number of keys, then seeds; 8 elements per shard).\n"
+    "//\n"
+    "\n"
+    "DECLARE_INDEX_ROUTINE()\n"
+    "{\n"
+    "    ULONG Shard;\n"
+    "    ULONG Offset;\n"
+    "    CPHINDEX Index;\n"
+    "    CPHSEED Seed1;\n"
+    "    CPHSEED Seed2;\n"
+    "    CPHSEED Seed3;\n"
+    "    CPHDKEY Vertex1;\n"
+    "    CPHDKEY Vertex2;\n"
+    "    CPHDKEY MaskedLow;\n"
+    "    CPHDKEY MaskedHigh;\n"
+    "    CPHDKEY DownsizedKey;\n"
+    "    const CPHSEED *Entry;\n"
+    "\n"
+    "    DownsizedKey = DOWNSIZE_KEY(Key);\n"
+    "\n"
+    "    Shard = DownsizedKey;\n"
+    "    Shard ^= Shard >> 16;\n"
+    "    Shard *= 0x85ebca6b;\n"
+    "    Shard ^= Shard >> 13;\n"
+    "    Shard *= 0xc2b2ae35;\n"
+    "    Shard ^= Shard >> 16;\n"
+    "    Shard = (ULONG)(((ULONGLONG)Shard * NUMBER_OF_SHARDS) >> 32);\n"
+    "\n"
+    "    Entry = &TABLE_SHARDS[Shard << 3];\n"
+    "    Seed1 = Entry[2];\n"
+    "    Seed2 = Entry[3];\n"
+    "    Seed3 = Entry[4];\n"
+    "\n"
+    "    Vertex1 = _mm_crc32_u32(Seed1, DownsizedKey);\n"
+    "    Vertex2 = _mm_crc32_u32(Seed2, _rotl(DownsizedKey, Seed3 & 0xff));\n"
+    "\n"
+    "    MaskedLow = Vertex1 & HASH_MASK;\n"
+    "    MaskedHigh = Vertex2 & HASH_MASK;\n"
+    "\n"
+    "    Offset = Shard * (HASH_MASK + 1);\n"
+    "\n"
+    "    Vertex1 = TABLE_DATA[Offset + MaskedLow];\n"
+    "    Vertex2 = TABLE_DATA[Offset + MaskedHigh];\n"
+    "\n"
+    "    Index = (CPHINDEX)(Entry[0] + ((Vertex1 + Vertex2) & INDEX_MASK));\n"
+    "\n"
+    "    return Index;\n"
+    "}\n"
+    "\n"
+    "//\n"
+    "// End CompiledPerfectHashTableShard01IndexCrc32RotateXAnd.c.\n"
+    "//\n"
+    "\n"
+;
+
+const STRING CompiledPerfectHashTableShard01IndexCrc32RotateXAndCSourceRawCString = {
+    sizeof(CompiledPerfectHashTableShard01IndexCrc32RotateXAndCSourceRawCStr) - sizeof(CHAR),
+    sizeof(CompiledPerfectHashTableShard01IndexCrc32RotateXAndCSourceRawCStr),
+#ifdef _WIN64
+    0,
+#endif
+    (PCHAR)&CompiledPerfectHashTableShard01IndexCrc32RotateXAndCSourceRawCStr,
+};
+
+#ifndef RawCString
+#define RawCString (&CompiledPerfectHashTableShard01IndexCrc32RotateXAndCSourceRawCString)
+#endif
@@ -0,0 +1,85 @@
+//
+// Auto-generated.
+//
+
+DECLSPEC_ALIGN(16)
+const CHAR CompiledPerfectHashTableShard01IndexMultiplyShiftRAndCSourceRawCStr[] =
+    "\n"
+    "//\n"
+    "// Begin CompiledPerfectHashTableShard01IndexMultiplyShiftRAnd.c.\n"
+    "//\n"
+    "\n"
+    "\n"
+    "//\n"
+    "// N.B. The shard selection must match Shard01GetShard() in Shard01.h, and the\n"
+    "//      layout of TABLE_SHARDS must match SHARD01_DIRECTORY_ENTRY (i.e. key\n"
+    "//      offset, number of keys, then seeds; 8 elements per shard).\n"
+    "//\n"
+    "\n"
+    "DECLARE_INDEX_ROUTINE()\n"
+    "{\n"
+    "    ULONG Shard;\n"
+    "    ULONG Offset;\n"
+    "    CPHINDEX Index;\n"
+    "    CPHSEED Seed1;\n"
+    "    CPHSEED Seed2;\n"
+    "    CPHSEED Seed3;\n"
+    "    CPHDKEY Vertex1;\n"
+    "    CPHDKEY Vertex2;\n"
+    "    CPHDKEY MaskedLow;\n"
+    "    CPHDKEY MaskedHigh;\n"
+    "    CPHDKEY DownsizedKey;\n"
+    "    const CPHSEED *Entry;\n"
+    "\n"
+    "    DownsizedKey = DOWNSIZE_KEY(Key);\n"
+    "\n"
+    "    Shard = DownsizedKey;\n"
+    "    Shard ^= Shard >> 16;\n"
+    "    Shard *= 0x85ebca6b;\n"
+    "    Shard ^= Shard >> 13;\n"
+    "    Shard *= 0xc2b2ae35;\n"
+    "    Shard ^= Shard >> 16;\n"
+    "    Shard = (ULONG)(((ULONGLONG)Shard * NUMBER_OF_SHARDS) >> 32);\n"
+    "\n"
+    "    Entry = &TABLE_SHARDS[Shard << 3];\n"
+    "    Seed1 = Entry[2];\n"
+    "    Seed2 = Entry[3];\n"
+    "    Seed3 = Entry[4];\n"
+    "\n"
+    "    Vertex1 = DownsizedKey * Seed1;\n"
+    "    Vertex1 = Vertex1 >> (Seed3 & 0xff);\n"
+    "\n"
+    "    Vertex2 = DownsizedKey * Seed2;\n"
+    "    Vertex2 = Vertex2 >> ((Seed3 >> 8) & 0xff);\n"
+    "\n"
+    "    MaskedLow = Vertex1 & HASH_MASK;\n"
+    "    MaskedHigh = Vertex2 & HASH_MASK;\n"
+    "\n"
+    "    Offset = Shard * (HASH_MASK + 1);\n"
+    "\n"
+    "    Vertex1 = TABLE_DATA[Offset + MaskedLow];\n"
+    "    Vertex2 = TABLE_DATA[Offset + MaskedHigh];\n"
+    "\n"
+    "    Index = (CPHINDEX)(Entry[0] + ((Vertex1 + Vertex2) & INDEX_MASK));\n"
+    "\n"
+    "    return Index;\n"
+    "}\n"
+    "\n"
+    "//\n"
+    "// End CompiledPerfectHashTableShard01IndexMultiplyShiftRAnd.c.\n"
+    "//\n"
+    "\n"
+;
+
+const STRING CompiledPerfectHashTableShard01IndexMultiplyShiftRAndCSourceRawCString = {
+    sizeof(CompiledPerfectHashTableShard01IndexMultiplyShiftRAndCSourceRawCStr) - sizeof(CHAR),
+    sizeof(CompiledPerfectHashTableShard01IndexMultiplyShiftRAndCSourceRawCStr),
+#ifdef _WIN64
+    0,
+#endif
+    (PCHAR)&CompiledPerfectHashTableShard01IndexMultiplyShiftRAndCSourceRawCStr,
+};
+
+#ifndef RawCString
+#define RawCString (&CompiledPerfectHashTableShard01IndexMultiplyShiftRAndCSourceRawCString)
+#endif
@@ -36,6 +36,14 @@ const CHAR CompiledPerfectHashTableTestCSourceRawCStr[] =
     "        NumberOfErrors++;          \\\n"
     "    }\n"
     "\n"
+    "//\n"
+    "// Number of keys passed to each IndexBatch() and LookupBatch() call.  This is\n"
+    "// deliberately not a multiple of eight, such that the scalar tail loop of the\n"
+    "// vectorized batch routines is exercised as well.\n"
+    "//\n"
+    "\n"
+    "#define CPH_TEST_BATCH_SIZE 63\n"
+    "\n"
     "DECLARE_TEST_CPH_ROUTINE()\n"
     "/*++\n"
     "\n"
@@ -54,6 +62,9 @@ const CHAR CompiledPerfectHashTableTestCSourceRawCStr[] =
     "\n"
     "--*/\n"
     "{\n"
+    "    ULONG Lane;\n"
+    "    ULONG Count;\n"
+    "    ULONG Offset;\n"
     "    CPHINDEX Index;\n"
     "    CPHKEY Key;\n"
     "    CPHKEY Rotated;\n"
@@ -61,6 +72,8 @@ const CHAR CompiledPerfectHashTableTestCSourceRawCStr[] =
     "    CPHVALUE Previous;\n"
     "    ULONG NumberOfErrors = 0;\n"
     "    const CPHKEY *Source;\n"
+    "    CPHINDEX Indices[CPH_TEST_BATCH_SIZE];\n"
+    "    CPHVALUE Values[CPH_TEST_BATCH_SIZE];\n"
     "\n"
     "    Key = *KEYS;\n"
     "\n"
@@ -70,7 +83,7 @@ const CHAR CompiledPerfectHashTableTestCSourceRawCStr[] =
     "    //\n"
     "\n"
     "    Rotated = ROTATE_KEY_LEFT(Key, 15);\n"
-    "    ASSERT(Key == ROTATE_KEY_RIGHT(Rotated, 15));\n"
+    "    ASSERT(KEYS_EQUAL(Key, ROTATE_KEY_RIGHT(Rotated, 15)));\n"
     "\n"
     "    //\n"
     "    // Verify looking up a key that hasn't been inserted returns 0 as the value.\n"
@@ -83,7 +96,7 @@ const CHAR CompiledPerfectHashTableTestCSourceRawCStr[] =
     "    // Verify insertion.\n"
     "    //\n"
     "\n"
-    "    Previous = INSERT_ROUTINE(Key, (CPHVALUE)Rotated);\n"
+    "    Previous = INSERT_ROUTINE(Key, KEY_TO_VALUE(Rotated));\n"
     "    ASSERT(Previous == 0);\n"
     "\n"
     "    //\n"
@@ -91,14 +104,14 @@ const CHAR CompiledPerfectHashTableTestCSourceRawCStr[] =
     "    //\n"
     "\n"
     "    Value = LOOKUP_ROUTINE(Key);\n"
-    "    ASSERT(Value == (CPHVALUE)Rotated);\n"
+    "    ASSERT(Value == KEY_TO_VALUE(Rotated));\n"
     "\n"
     "    //\n"
     "    // Delete the inserted key.  Returned value should be Rotated.\n"
     "    //\n"
     "\n"
     "    Value = DELETE_ROUTINE(Key);\n"
-    "    ASSERT(Value == (CPHVALUE)Rotated);\n"
+    "    ASSERT(Value == KEY_TO_VALUE(Rotated));\n"
     "\n"
     "    //\n"
     "    // Verify a subsequent lookup returns 0.\n"
@@ -116,7 +129,7 @@ const CHAR CompiledPerfectHashTableTestCSourceRawCStr[] =
     "        Key = *Source++;\n"
     "        Rotated = ROTATE_KEY_LEFT(Key, 15);\n"
     "\n"
-    "        Previous = INSERT_ROUTINE(Key, (CPHVALUE)Rotated);\n"
+    "        Previous = INSERT_ROUTINE(Key, KEY_TO_VALUE(Rotated));\n"
     "        ASSERT(Previous == 0);\n"
     "\n"
     "    }\n"
@@ -132,11 +145,89 @@ const CHAR CompiledPerfectHashTableTestCSourceRawCStr[] =
     "        Rotated = ROTATE_KEY_LEFT(Key, 15);\n"
     "\n"
     "        Value = LOOKUP_ROUTINE(Key);\n"
-    "        ASSERT(Value == (CPHVALUE)Rotated);\n"
+    "        ASSERT(Value == KEY_TO_VALUE(Rotated));\n"
     "\n"
     "    }\n"
     "\n"
     "    //\n"
+    "    // Verify the batch routines agree with their scalar counterparts.\n"
+    "    //\n"
+    "\n"
+    "    for (Offset = 0; Offset < NUMBER_OF_KEYS; Offset += Count) {\n"
+    "\n"
+    "        Count = NUMBER_OF_KEYS - Offset;\n"
+    "        if (Count > CPH_TEST_BATCH_SIZE) {\n"
+    "            Count = CPH_TEST_BATCH_SIZE;\n"
+    "        }\n"
+    "\n"
+    "        INDEX_BATCH_ROUTINE(Count, &KEYS[Offset], Indices);\n"
+    "        LOOKUP_BATCH_ROUTINE(Count, &KEYS[Offset], Values);\n"
+    "\n"
+    "        for (Lane = 0; Lane < Count; Lane++) {\n"
+    "            Key = KEYS[Offset + Lane];\n"
+    "            Rotated = ROTATE_KEY_LEFT(Key, 15);\n"
+    "\n"
+    "            ASSERT(Indices[Lane] == INDEX_ROUTINE(Key));\n"
+    "            ASSERT(Values[Lane] == KEY_TO_VALUE(Rotated));\n"
+    "        }\n"
+    "    }\n"
+    "\n"
+    "#ifdef CPH_ORDER_PRESERVING\n"
+    "\n"
+    "    //\n"
+    "    // Verify each key's index is its offset in the keys array.\n"
+    "    //\n"
+    "\n"
+    "    for (Offset = 0; Offset < NUMBER_OF_KEYS; Offset++) {\n"
+    "        Index = INDEX_ROUTINE(KEYS[Offset]);\n"
+    "        ASSERT(Index == (CPHINDEX)Offset);\n"
+    "    }\n"
+    "\n"
+    "#endif\n"
+    "\n"
+    "#ifdef CPH_STRING_KEYS\n"
+    "\n"
+    "    //\n"
+    "    // Verify each string reduces to its key, and that both string routines\n"
+    "    // return the string's offset in the keys array.\n"
+    "    //\n"
+    "\n"
+    "    for (Offset = 0; Offset < NUMBER_OF_KEYS; Offset++) {\n"
+    "        const BYTE *String;\n"
+    "        ULONG Length;\n"
+    "\n"
+    "        String = &STRING_KEY_DATA[STRING_KEY_OFFSETS[Offset]];\n"
+    "        Length = STRING_KEY_OFFSETS[Offset + 1] - STRING_KEY_OFFSETS[Offset];\n"
+    "\n"
+    "        ASSERT((CPHKEY)HASH_STRING_KEY(String, Length) == KEYS[Offset]);\n"
+    "        ASSERT(INDEX_STRING_ROUTINE(String, Length) == (CPHINDEX)Offset);\n"
+    "        ASSERT(TRY_INDEX_STRING_ROUTINE(String, Length, &Index));\n"
+    "        ASSERT(Index == (CPHINDEX)Offset);\n"
+    "    }\n"
+    "\n"
+    "#endif\n"
+    "\n"
+    "#ifdef CPH_HAS_FINGERPRINTS\n"
+    "\n"
+    "    //\n"
+    "    // Verify every key is reported as present, and that TryLookup() agrees\n"
+    "    // with Lookup().\n"
+    "    //\n"
+    "\n"
+    "    FOR_EACH_KEY {\n"
+    "\n"
+    "        Key = *Source++;\n"
+    "        Rotated = ROTATE_KEY_LEFT(Key, 15);\n"
+    "\n"
+    "        ASSERT(CONTAINS_ROUTINE(Key));\n"
+    "        ASSERT(TRY_LOOKUP_ROUTINE(Key, &Value));\n"
+    "        ASSERT(Value == KEY_TO_VALUE(Rotated));\n"
+    "\n"
+    "    }\n"
+    "\n"
+    "#endif\n"
+    "\n"
+    "    //\n"
     "    // Loop through again and delete everything.\n"
     "    //\n"
     "\n"
@@ -146,7 +237,7 @@ const CHAR CompiledPerfectHashTableTestCSourceRawCStr[] =
     "        Rotated = ROTATE_KEY_LEFT(Key, 15);\n"
     "\n"
     "        Previous = DELETE_ROUTINE(Key);\n"
-    "        ASSERT(Previous == (CPHVALUE)Rotated);\n"
+    "        ASSERT(Previous == KEY_TO_VALUE(Rotated));\n"
     "\n"
     "    }\n"
     "\n"
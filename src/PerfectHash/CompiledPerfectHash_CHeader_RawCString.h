@@ -50,11 +50,13 @@ const CHAR CompiledPerfectHashCHeaderRawCStr[] =
     "\n"
     "#define DEBUGBREAK __debugbreak\n"
     "#define CPHCALLTYPE __stdcall\n"
+    "#define CPHCACHEALIGN __declspec(align(64))\n"
     "#ifndef FORCEINLINE\n"
     "#define FORCEINLINE __forceinline\n"
     "#endif\n"
     "#elif defined(__linux__) || defined(__APPLE__)\n"
     "#define CPHCALLTYPE\n"
+    "#define CPHCACHEALIGN __attribute__((aligned(64)))\n"
     "#if defined(__clang__)\n"
     "#include <x86intrin.h>\n"
     "\n"
@@ -127,8 +129,377 @@ const CHAR CompiledPerfectHashCHeaderRawCStr[] =
     "#endif\n"
     "\n"
     "//\n"
+    "// The batch routines (IndexBatch() and LookupBatch()) process eight keys per\n"
+    "// iteration with AVX2 when the compiler is targeting it (i.e. /arch:AVX2 or\n"
+    "// -mavx2) and the table's hash function has a vector implementation (which\n"
+    "// will define CPH_HAS_HASH_AVX2); the remaining keys are handled by a scalar\n"
+    "// tail loop.  Define CPH_NO_AVX2 to force the scalar loop.\n"
+    "//\n"
+    "\n"
+    "#if defined(__AVX2__) && !defined(CPH_NO_AVX2)\n"
+    "#define CPH_AVX2 1\n"
+    "#define CPH_AVX2_BATCH_SIZE 8\n"
+    "\n"
+    "//\n"
+    "// AVX2 has no 32-bit lane rotate; emulate it with a pair of shifts.  Counts\n"
+    "// are masked to 0-31 as per _rotl() and _rotr(); the left shift of a zero\n"
+    "// count by 32 bits yields zero, so the result is the unrotated input.\n"
+    "//\n"
+    "\n"
+    "FORCEINLINE\n"
+    "__m256i\n"
+    "CphRotl256(\n"
+    "    _In_ __m256i Value,\n"
+    "    _In_ unsigned int Count\n"
+    "    )\n"
+    "{\n"
+    "    Count &= 31;\n"
+    "    return _mm256_or_si256(\n"
+    "        _mm256_sll_epi32(Value, _mm_cvtsi32_si128((int)Count)),\n"
+    "        _mm256_srl_epi32(Value, _mm_cvtsi32_si128((int)(32 - Count)))\n"
+    "    );\n"
+    "}\n"
+    "\n"
+    "FORCEINLINE\n"
+    "__m256i\n"
+    "CphRotr256(\n"
+    "    _In_ __m256i Value,\n"
+    "    _In_ unsigned int Count\n"
+    "    )\n"
+    "{\n"
+    "    Count &= 31;\n"
+    "    return _mm256_or_si256(\n"
+    "        _mm256_srl_epi32(Value, _mm_cvtsi32_si128((int)Count)),\n"
+    "        _mm256_sll_epi32(Value, _mm_cvtsi32_si128((int)(32 - Count)))\n"
+    "    );\n"
+    "}\n"
+    "\n"
+    "//\n"
+    "// Gather eight table data elements.  The table data array type is the\n"
+    "// smallest type that can contain the number of edges, so elements may be 8,\n"
+    "// 16 or 32 bits wide.  Narrower elements are gathered via the 32-bit word\n"
+    "// containing them, then shifted and masked; the array size is always a power\n"
+    "// of two elements (of at least four), so this never reads past the array.\n"
+    "// ElementSize is a constant, so the unused branches are folded away.\n"
+    "//\n"
+    "\n"
+    "FORCEINLINE\n"
+    "__m256i\n"
+    "CphGatherTableData256(\n"
+    "    _In_ const void *TableData,\n"
+    "    _In_ __m256i Vertices,\n"
+    "    _In_ unsigned int ElementSize\n"
+    "    )\n"
+    "{\n"
+    "    __m256i Shift;\n"
+    "    __m256i Words;\n"
+    "\n"
+    "    if (ElementSize == sizeof(unsigned int)) {\n"
+    "        return _mm256_i32gather_epi32((const int *)TableData, Vertices, 4);\n"
+    "    }\n"
+    "\n"
+    "    if (ElementSize == sizeof(unsigned short)) {\n"
+    "        Words = _mm256_i32gather_epi32((const int *)TableData,\n"
+    "                                       _mm256_srli_epi32(Vertices, 1),\n"
+    "                                       4);\n"
+    "        Shift = _mm256_slli_epi32(\n"
+    "            _mm256_and_si256(Vertices, _mm256_set1_epi32(1)),\n"
+    "            4\n"
+    "        );\n"
+    "        return _mm256_and_si256(_mm256_srlv_epi32(Words, Shift),\n"
+    "                                _mm256_set1_epi32(0xffff));\n"
+    "    }\n"
+    "\n"
+    "    Words = _mm256_i32gather_epi32((const int *)TableData,\n"
+    "                                   _mm256_srli_epi32(Vertices, 2),\n"
+    "                                   4);\n"
+    "    Shift = _mm256_slli_epi32(\n"
+    "        _mm256_and_si256(Vertices, _mm256_set1_epi32(3)),\n"
+    "        3\n"
+    "    );\n"
+    "    return _mm256_and_si256(_mm256_srlv_epi32(Words, Shift),\n"
+    "                            _mm256_set1_epi32(0xff));\n"
+    "}\n"
+    "\n"
+    "//\n"
+    "// Gather eight packed table data elements (see CphUnpackTableData() below).\n"
+    "// The bit offset of each element is calculated in 64-bit lanes (it can exceed\n"
+    "// 32 bits), then the 64 bits starting at the byte containing the element's\n"
+    "// first bit are gathered, shifted right by the remaining 0-7 bits, and the\n"
+    "// low 32 bits of each lane are compressed into a single vector and masked.\n"
+    "//\n"
+    "\n"
+    "FORCEINLINE\n"
+    "__m256i\n"
+    "CphGatherPackedTableData256(\n"
+    "    _In_ const ULONGLONG *TableData,\n"
+    "    _In_ __m256i Vertices,\n"
+    "    _In_ unsigned int Bits\n"
+    "    )\n"
+    "{\n"
+    "    __m256i Low;\n"
+    "    __m256i High;\n"
+    "    __m256i Seven;\n"
+    "    __m256i Multiplier;\n"
+    "    __m256i Compress;\n"
+    "\n"
+    "    Seven = _mm256_set1_epi64x(7);\n"
+    "    Multiplier = _mm256_set1_epi64x((long long)Bits);\n"
+    "    Compress = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);\n"
+    "\n"
+    "    Low = _mm256_mul_epu32(\n"
+    "        _mm256_cvtepu32_epi64(_mm256_castsi256_si128(Vertices)),\n"
+    "        Multiplier\n"
+    "    );\n"
+    "    High = _mm256_mul_epu32(\n"
+    "        _mm256_cvtepu32_epi64(_mm256_extracti128_si256(Vertices, 1)),\n"
+    "        Multiplier\n"
+    "    );\n"
+    "\n"
+    "    Low = _mm256_srlv_epi64(\n"
+    "        _mm256_i64gather_epi64((const long long *)TableData,\n"
+    "                               _mm256_srli_epi64(Low, 3),\n"
+    "                               1),\n"
+    "        _mm256_and_si256(Low, Seven)\n"
+    "    );\n"
+    "    High = _mm256_srlv_epi64(\n"
+    "        _mm256_i64gather_epi64((const long long *)TableData,\n"
+    "                               _mm256_srli_epi64(High, 3),\n"
+    "                               1),\n"
+    "        _mm256_and_si256(High, Seven)\n"
+    "    );\n"
+    "\n"
+    "    Low = _mm256_permutevar8x32_epi32(Low, Compress);\n"
+    "    High = _mm256_permutevar8x32_epi32(High, Compress);\n"
+    "\n"
+    "    return _mm256_and_si256(\n"
+    "        _mm256_permute2x128_si256(Low, High, 0x20),\n"
+    "        _mm256_set1_epi32((int)(0xffffffffU >> (32 - Bits)))\n"
+    "    );\n"
+    "}\n"
+    "\n"
+    "#endif\n"
+    "\n"
+    "//\n"
+    "// Packed table data support.  Tables created with --TableDataLayout=Packed\n"
+    "// emit the table data as an array of ULONGLONGs holding a little-endian bit\n"
+    "// stream of TABLE_DATA_BITS-wide elements (and define CPH_PACKED_TABLE_DATA).\n"
+    "// An element is extracted via an unaligned 64-bit load at the byte containing\n"
+    "// its first bit, followed by a shift and mask, which is a single BEXTR when\n"
+    "// BMI is available.  The array is padded by a trailing ULONGLONG, so the load\n"
+    "// never reads past the end.  This must match GetPackedTableDataElement() in\n"
+    "// the library.\n"
+    "//\n"
+    "\n"
+    "#if defined(__BMI__) || (defined(_MSC_VER) && defined(__AVX2__))\n"
+    "#define CPH_BEXTR 1\n"
+    "#endif\n"
+    "\n"
+    "FORCEINLINE\n"
+    "ULONG\n"
+    "CphUnpackTableData(\n"
+    "    _In_ const ULONGLONG *TableData,\n"
+    "    _In_ ULONG Index,\n"
+    "    _In_ ULONG Bits\n"
+    "    )\n"
+    "{\n"
+    "    ULONGLONG Bit;\n"
+    "    ULONGLONG Word;\n"
+    "    const char *Byte;\n"
+    "\n"
+    "    Bit = (ULONGLONG)Index * Bits;\n"
+    "    Byte = (const char *)TableData + (Bit >> 3);\n"
+    "\n"
+    "#ifdef _WIN32\n"
+    "    Word = *((const ULONGLONG __unaligned *)Byte);\n"
+    "#else\n"
+    "    __builtin_memcpy(&Word, Byte, sizeof(Word));\n"
+    "#endif\n"
+    "\n"
+    "#ifdef CPH_BEXTR\n"
+    "    return (ULONG)_bextr_u64(Word, (unsigned int)(Bit & 7), Bits);\n"
+    "#else\n"
+    "    return (ULONG)((Word >> (Bit & 7)) & ((1ULL << Bits) - 1));\n"
+    "#endif\n"
+    "}\n"
+    "\n"
+    "//\n"
+    "// Key fingerprint support.  Tables created with --FingerprintSizeInBytes emit\n"
+    "// a fingerprint array alongside the table data (and define\n"
+    "// CPH_HAS_FINGERPRINTS), which the Contains() and TryLookup() routines use to\n"
+    "// reject keys that weren't in the original key set.  The mixing function and\n"
+    "// constants must match PerfectHashTableFingerprintKey() in the library.\n"
+    "//\n"
+    "\n"
+    "#define CPH_FINGERPRINT_MULTIPLIER1 0x7feb352d\n"
+    "#define CPH_FINGERPRINT_MULTIPLIER2 0x846ca68b\n"
+    "\n"
+    "FORCEINLINE\n"
+    "ULONG\n"
+    "CphFingerprintKey(\n"
+    "    _In_ ULONG Key\n"
+    "    )\n"
+    "{\n"
+    "    ULONG Hash;\n"
+    "\n"
+    "    Hash = Key;\n"
+    "    Hash ^= Hash >> 16;\n"
+    "    Hash *= CPH_FINGERPRINT_MULTIPLIER1;\n"
+    "    Hash ^= Hash >> 15;\n"
+    "    Hash *= CPH_FINGERPRINT_MULTIPLIER2;\n"
+    "    Hash ^= Hash >> 16;\n"
+    "\n"
+    "    return Hash;\n"
+    "}\n"
+    "\n"
+    "//\n"
+    "// String key support.  Tables created with --StringKeys reduce each string to\n"
+    "// a unique 32-bit key (and define CPH_STRING_KEYS), and emit the strings so\n"
+    "// the TryIndexString() routine can reject strings that weren't in the keys\n"
+    "// file.  Each string is reduced by a CRC32-C over its 8-byte lanes, two lanes\n"
+    "// at a time, after multiplying each lane by an odd, seed-derived constant.\n"
+    "// The routine and constants must match HashStringKey() in the library (see\n"
+    "// StringKeys.h and ReducedKeys.h).\n"
+    "//\n"
+    "\n"
+    "#define CPH_REDUCED_KEY_LANE_MULTIPLIER 0x9e3779b97f4a7c15ULL\n"
+    "\n"
+    "FORCEINLINE\n"
+    "ULONGLONG\n"
+    "CphLoadStringKeyLane(\n"
+    "    _In_reads_bytes_(8) const BYTE *Bytes\n"
+    "    )\n"
+    "{\n"
+    "    ULONGLONG Lane;\n"
+    "\n"
+    "#ifdef _WIN32\n"
+    "    Lane = *((const ULONGLONG __unaligned *)Bytes);\n"
+    "#else\n"
+    "    __builtin_memcpy(&Lane, Bytes, sizeof(Lane));\n"
+    "#endif\n"
+    "\n"
+    "    return Lane;\n"
+    "}\n"
+    "\n"
+    "FORCEINLINE\n"
+    "ULONG\n"
+    "CphHashStringKey(\n"
+    "    _In_reads_bytes_(Length) const BYTE *Bytes,\n"
+    "    _In_ ULONG Length,\n"
+    "    _In_ ULONG Seed\n"
+    "    )\n"
+    "{\n"
+    "    ULONG Hash1;\n"
+    "    ULONG Hash2;\n"
+    "    ULONG Index;\n"
+    "    ULONG Remaining;\n"
+    "    ULONGLONG Lane;\n"
+    "    ULONGLONG Multiplier;\n"
+    "\n"
+    "    Hash1 = Seed;\n"
+    "    Hash2 = Length;\n"
+    "    Remaining = Length;\n"
+    "    Multiplier = ((ULONGLONG)Seed * CPH_REDUCED_KEY_LANE_MULTIPLIER) | 1;\n"
+    "\n"
+    "    while (Remaining >= 16) {\n"
+    "        Lane = CphLoadStringKeyLane(Bytes);\n"
+    "        Hash1 = (ULONG)_mm_crc32_u64(Hash1, Lane * Multiplier);\n"
+    "        Lane = CphLoadStringKeyLane(Bytes + 8);\n"
+    "        Hash2 = (ULONG)_mm_crc32_u64(Hash2, Lane * Multiplier);\n"
+    "        Bytes += 16;\n"
+    "        Remaining -= 16;\n"
+    "    }\n"
+    "\n"
+    "    if (Remaining >= 8) {\n"
+    "        Lane = CphLoadStringKeyLane(Bytes);\n"
+    "        Hash1 = (ULONG)_mm_crc32_u64(Hash1, Lane * Multiplier);\n"
+    "        Bytes += 8;\n"
+    "        Remaining -= 8;\n"
+    "    }\n"
+    "\n"
+    "    if (Remaining > 0) {\n"
+    "        Lane = 0;\n"
+    "        for (Index = 0; Index < Remaining; Index++) {\n"
+    "            Lane |= ((ULONGLONG)Bytes[Index] << (Index << 3));\n"
+    "        }\n"
+    "        Hash2 = (ULONG)_mm_crc32_u64(Hash2, Lane * Multiplier);\n"
+    "    }\n"
+    "\n"
+    "    return _mm_crc32_u32(Hash1, Hash2);\n"
+    "}\n"
+    "\n"
+    "//\n"
+    "// 128-bit key support.  Tables created from 128-bit keys (e.g. UUIDs) reduce\n"
+    "// each key to a unique 32-bit key (and define CPH_KEY128, in which case CPHKEY\n"
+    "// is a structure of two ULONGLONGs).  A 128-bit key is reduced identically to\n"
+    "// a 16-byte string key.  The routine must match HashKey128() in the library\n"
+    "// (see Keys128.h).\n"
+    "//\n"
+    "\n"
+    "FORCEINLINE\n"
+    "ULONG\n"
+    "CphHashKey128(\n"
+    "    _In_ ULONGLONG Low,\n"
+    "    _In_ ULONGLONG High,\n"
+    "    _In_ ULONG Seed\n"
+    "    )\n"
+    "{\n"
+    "    ULONG Hash1;\n"
+    "    ULONG Hash2;\n"
+    "    ULONGLONG Multiplier;\n"
+    "\n"
+    "    Multiplier = ((ULONGLONG)Seed * CPH_REDUCED_KEY_LANE_MULTIPLIER) | 1;\n"
+    "\n"
+    "    Hash1 = (ULONG)_mm_crc32_u64(Seed, Low * Multiplier);\n"
+    "    Hash2 = (ULONG)_mm_crc32_u64(16, High * Multiplier);\n"
+    "\n"
+    "    return _mm_crc32_u32(Hash1, Hash2);\n"
+    "}\n"
+    "\n"
+    "#ifdef CPH_KEY128\n"
+    "\n"
+    "//\n"
+    "// The test and benchmark routines derive values from keys by rotating them;\n"
+    "// 128-bit keys are rotated by rotating each half.\n"
+    "//\n"
+    "\n"
+    "FORCEINLINE\n"
+    "CPHKEY\n"
+    "CphRotateKey128Left(\n"
+    "    _In_ CPHKEY Key,\n"
+    "    _In_ ULONG Count\n"
+    "    )\n"
+    "{\n"
+    "    CPHKEY Rotated;\n"
+    "\n"
+    "    Rotated.Low = _rotl64(Key.Low, Count);\n"
+    "    Rotated.High = _rotl64(Key.High, Count);\n"
+    "\n"
+    "    return Rotated;\n"
+    "}\n"
+    "\n"
+    "FORCEINLINE\n"
+    "CPHKEY\n"
+    "CphRotateKey128Right(\n"
+    "    _In_ CPHKEY Key,\n"
+    "    _In_ ULONG Count\n"
+    "    )\n"
+    "{\n"
+    "    CPHKEY Rotated;\n"
+    "\n"
+    "    Rotated.Low = _rotr64(Key.Low, Count);\n"
+    "    Rotated.High = _rotr64(Key.High, Count);\n"
+    "\n"
+    "    return Rotated;\n"
+    "}\n"
+    "\n"
+    "#endif\n"
+    "\n"
+    "//\n"
     "// Define the main functions exposed by a compiled perfect hash table: index,\n"
-    "// lookup, insert and delete.\n"
+    "// lookup, insert and delete, plus the batched variants of index and lookup,\n"
+    "// the fingerprint-checked Contains() and TryLookup() routines, and the string\n"
+    "// key IndexString() and TryIndexString() routines.\n"
     "//\n"
     "\n"
     "typedef\n"
@@ -159,6 +530,147 @@ const CHAR CompiledPerfectHashCHeaderRawCStr[] =
     "--*/\n"
     "typedef COMPILED_PERFECT_HASH_TABLE_INDEX *PCOMPILED_PERFECT_HASH_TABLE_INDEX;\n"
     "\n"
+    "typedef\n"
+    "CPHAPI\n"
+    "VOID\n"
+    "(CPHCALLTYPE COMPILED_PERFECT_HASH_TABLE_INDEX_BATCH)(\n"
+    "    _In_ ULONG NumberOfKeys,\n"
+    "    _In_reads_(NumberOfKeys) const CPHKEY *Keys,\n"
+    "    _Out_writes_(NumberOfKeys) CPHINDEX *Indices\n"
+    "    );\n"
+    "/*++\n"
+    "\n"
+    "Routine Description:\n"
+    "\n"
+    "    Looks up an array of keys in a compiled perfect hash table and returns\n"
+    "    their indices.  This is equivalent to calling Index() for each key, but\n"
+    "    processes eight keys at a time via AVX2 where supported (see CPH_AVX2).\n"
+    "\n"
+    "    N.B. If a given key did not appear in the original set the hash table was\n"
+    "         created from, the behavior of this routine is undefined for that key.\n"
+    "\n"
+    "Arguments:\n"
+    "\n"
+    "    NumberOfKeys - Supplies the number of keys in the Keys array.\n"
+    "\n"
+    "    Keys - Supplies the base address of an array of keys to look up.\n"
+    "\n"
+    "    Indices - Receives the index associated with each key.\n"
+    "\n"
+    "Return Value:\n"
+    "\n"
+    "    None.\n"
+    "\n"
+    "--*/\n"
+    "typedef COMPILED_PERFECT_HASH_TABLE_INDEX_BATCH\n"
+    "      *PCOMPILED_PERFECT_HASH_TABLE_INDEX_BATCH;\n"
+    "\n"
+    "typedef\n"
+    "CPHAPI\n"
+    "BOOLEAN\n"
+    "(CPHCALLTYPE COMPILED_PERFECT_HASH_TABLE_CONTAINS)(\n"
+    "    _In_ CPHKEY Key\n"
+    "    );\n"
+    "/*++\n"
+    "\n"
+    "Routine Description:\n"
+    "\n"
+    "    Tests whether or not a key was present in the original set the hash table\n"
+    "    was created from, by comparing the key's fingerprint against the one that\n"
+    "    was captured for its index when the table was created.  Keys that were in\n"
+    "    the original set always return TRUE; keys that weren't return FALSE unless\n"
+    "    their fingerprint collides with the one stored at their index, which has a\n"
+    "    probability of 1 in 2^(8 * sizeof(CPHFINGERPRINT)).\n"
+    "\n"
+    "    N.B. Only available if the table was created with fingerprints, as\n"
+    "         indicated by CPH_HAS_FINGERPRINTS being defined.\n"
+    "\n"
+    "Arguments:\n"
+    "\n"
+    "    Key - Supplies the key to test.\n"
+    "\n"
+    "Return Value:\n"
+    "\n"
+    "    TRUE if the key is (probably) present, FALSE if it is definitely absent.\n"
+    "\n"
+    "--*/\n"
+    "typedef COMPILED_PERFECT_HASH_TABLE_CONTAINS\n"
+    "      *PCOMPILED_PERFECT_HASH_TABLE_CONTAINS;\n"
+    "\n"
+    "typedef\n"
+    "CPHAPI\n"
+    "CPHINDEX\n"
+    "(CPHCALLTYPE COMPILED_PERFECT_HASH_TABLE_INDEX_STRING)(\n"
+    "    _In_reads_bytes_(Length) const BYTE *String,\n"
+    "    _In_ ULONG Length\n"
+    "    );\n"
+    "/*++\n"
+    "\n"
+    "Routine Description:\n"
+    "\n"
+    "    Reduces a string to its 32-bit key, then looks up the key in a compiled\n"
+    "    perfect hash table and returns its index.  As string key tables are always\n"
+    "    order preserving, the index of a string is the offset of its key in the\n"
+    "    table's keys array (which is sorted by reduced key, not file order).\n"
+    "\n"
+    "    N.B. Only available if the table was created from string keys, as\n"
+    "         indicated by CPH_STRING_KEYS being defined.\n"
+    "\n"
+    "    N.B. If the given string did not appear in the keys file the hash table\n"
+    "         was created from, the behavior of this routine is undefined; use\n"
+    "         TryIndexString() if this is possible.\n"
+    "\n"
+    "Arguments:\n"
+    "\n"
+    "    String - Supplies the base address of the string's bytes.\n"
+    "\n"
+    "    Length - Supplies the length of the string, in bytes.\n"
+    "\n"
+    "Return Value:\n"
+    "\n"
+    "    The index associated with the given string.\n"
+    "\n"
+    "--*/\n"
+    "typedef COMPILED_PERFECT_HASH_TABLE_INDEX_STRING\n"
+    "      *PCOMPILED_PERFECT_HASH_TABLE_INDEX_STRING;\n"
+    "\n"
+    "typedef\n"
+    "CPHAPI\n"
+    "BOOLEAN\n"
+    "(CPHCALLTYPE COMPILED_PERFECT_HASH_TABLE_TRY_INDEX_STRING)(\n"
+    "    _In_reads_bytes_(Length) const BYTE *String,\n"
+    "    _In_ ULONG Length,\n"
+    "    _Out_ CPHINDEX *Index\n"
+    "    );\n"
+    "/*++\n"
+    "\n"
+    "Routine Description:\n"
+    "\n"
+    "    Looks up a string in a compiled perfect hash table, then verifies it by\n"
+    "    comparing it against the string stored for the resulting index.  Unlike\n"
+    "    fingerprints, the comparison is exact; strings that weren't in the keys\n"
+    "    file always return FALSE.\n"
+    "\n"
+    "    N.B. Only available if the table was created from string keys, as\n"
+    "         indicated by CPH_STRING_KEYS being defined.\n"
+    "\n"
+    "Arguments:\n"
+    "\n"
+    "    String - Supplies the base address of the string's bytes.\n"
+    "\n"
+    "    Length - Supplies the length of the string, in bytes.\n"
+    "\n"
+    "    Index - Receives the index associated with the string if it is present,\n"
+    "        0 otherwise.\n"
+    "\n"
+    "Return Value:\n"
+    "\n"
+    "    TRUE if the string is present, FALSE otherwise.\n"
+    "\n"
+    "--*/\n"
+    "typedef COMPILED_PERFECT_HASH_TABLE_TRY_INDEX_STRING\n"
+    "      *PCOMPILED_PERFECT_HASH_TABLE_TRY_INDEX_STRING;\n"
+    "\n"
     "#ifndef CPH_INDEX_ONLY\n"
     "\n"
     "typedef\n"
@@ -192,6 +704,42 @@ const CHAR CompiledPerfectHashCHeaderRawCStr[] =
     "--*/\n"
     "typedef COMPILED_PERFECT_HASH_TABLE_LOOKUP *PCOMPILED_PERFECT_HASH_TABLE_LOOKUP;\n"
     "\n"
+    "typedef\n"
+    "CPHAPI\n"
+    "VOID\n"
+    "(CPHCALLTYPE COMPILED_PERFECT_HASH_TABLE_LOOKUP_BATCH)(\n"
+    "    _In_ ULONG NumberOfKeys,\n"
+    "    _In_reads_(NumberOfKeys) const CPHKEY *Keys,\n"
+    "    _Out_writes_(NumberOfKeys) CPHVALUE *Values\n"
+    "    );\n"
+    "/*++\n"
+    "\n"
+    "Routine Description:\n"
+    "\n"
+    "    Looks up an array of keys in a compiled perfect hash table and returns\n"
+    "    the value present for each key.  This is equivalent to calling Lookup()\n"
+    "    for each key, but processes eight keys at a time via AVX2 where supported\n"
+    "    (see CPH_AVX2), gathering both the table data and the values.\n"
+    "\n"
+    "    N.B. If a given key did not appear in the original set the hash table was\n"
+    "         created from, the behavior of this routine is undefined for that key.\n"
+    "\n"
+    "Arguments:\n"
+    "\n"
+    "    NumberOfKeys - Supplies the number of keys in the Keys array.\n"
+    "\n"
+    "    Keys - Supplies the base address of an array of keys to look up.\n"
+    "\n"
+    "    Values - Receives the value for each key.\n"
+    "\n"
+    "Return Value:\n"
+    "\n"
+    "    None.\n"
+    "\n"
+    "--*/\n"
+    "typedef COMPILED_PERFECT_HASH_TABLE_LOOKUP_BATCH\n"
+    "      *PCOMPILED_PERFECT_HASH_TABLE_LOOKUP_BATCH;\n"
+    "\n"
     "\n"
     "typedef\n"
     "CPHAPI\n"
@@ -263,6 +811,39 @@ const CHAR CompiledPerfectHashCHeaderRawCStr[] =
     "--*/\n"
     "typedef COMPILED_PERFECT_HASH_TABLE_DELETE *PCOMPILED_PERFECT_HASH_TABLE_DELETE;\n"
     "\n"
+    "\n"
+    "typedef\n"
+    "CPHAPI\n"
+    "BOOLEAN\n"
+    "(CPHCALLTYPE COMPILED_PERFECT_HASH_TABLE_TRY_LOOKUP)(\n"
+    "    _In_ CPHKEY Key,\n"
+    "    _Out_ CPHVALUE *Value\n"
+    "    );\n"
+    "/*++\n"
+    "\n"
+    "Routine Description:\n"
+    "\n"
+    "    Looks up given key in a compiled perfect hash table, verifying its\n"
+    "    fingerprint first.  This is equivalent to calling Contains() followed by\n"
+    "    Lookup(), but only hashes the key once.\n"
+    "\n"
+    "    N.B. Only available if the table was created with fingerprints, as\n"
+    "         indicated by CPH_HAS_FINGERPRINTS being defined.\n"
+    "\n"
+    "Arguments:\n"
+    "\n"
+    "    Key - Supplies the key to look up.\n"
+    "\n"
+    "    Value - Receives the value for the key if the key is present, 0 otherwise.\n"
+    "\n"
+    "Return Value:\n"
+    "\n"
+    "    TRUE if the key is (probably) present, FALSE if it is definitely absent.\n"
+    "\n"
+    "--*/\n"
+    "typedef COMPILED_PERFECT_HASH_TABLE_TRY_LOOKUP\n"
+    "      *PCOMPILED_PERFECT_HASH_TABLE_TRY_LOOKUP;\n"
+    "\n"
     "//\n"
     "// Typedefs of methods for testing and benchmarking.\n"
     "//\n"
@@ -0,0 +1,435 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    CompressedKeys.h
+
+Abstract:
+
+    This module defines the compressed keys file format, and implements the
+    helper routines used to encode and decode it.  Compressed keys files are
+    written by the --CompressKeys create flag, and are detected and decoded
+    automatically by the keys Load() routine.
+
+    A compressed keys file holds a sorted array of unique 32-bit or 64-bit
+    keys.  The keys are split into blocks of KeysPerBlock keys (the last
+    block may be shorter).  The first key of each block is stored verbatim in
+    the block index; each subsequent key is stored as the difference from its
+    predecessor, minus one (keys are unique, so differences are at least
+    one).  The differences of each block are bit-packed, least significant
+    bit first, into 64-bit words, using the minimum number of bits required
+    by the block's largest difference.  A block of consecutive keys requires
+    zero bits per difference, and thus no words at all.
+
+    The file layout is as follows:
+
+        COMPRESSED_KEYS_HEADER
+        COMPRESSED_KEYS_BLOCK[NumberOfBlocks]
+        ULONGLONG[NumberOfWords]
+
+    Each block index entry records the offset of the block's first word, so
+    blocks can be decoded independently (and thus in parallel).
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Define the compressed keys file constants.  The magic number is the string
+// "PHCKEYS1" as a little-endian ULONGLONG.
+//
+
+#define COMPRESSED_KEYS_MAGIC 0x315359454B434850ULL
+#define COMPRESSED_KEYS_VERSION 1
+#define COMPRESSED_KEYS_KEYS_PER_BLOCK 4096
+#define COMPRESSED_KEYS_MAXIMUM_KEYS_PER_BLOCK (1 << 20)
+#define COMPRESSED_KEYS_BITS_PER_WORD 64
+
+//
+// Define the compressed keys file header.
+//
+
+typedef struct _COMPRESSED_KEYS_HEADER {
+
+    //
+    // COMPRESSED_KEYS_MAGIC.
+    //
+
+    ULONGLONG Magic;
+
+    //
+    // Size of this structure, in bytes, and the format version.
+    //
+
+    _Field_range_(==, sizeof(struct _COMPRESSED_KEYS_HEADER))
+    ULONG SizeOfStruct;
+
+    ULONG Version;
+
+    //
+    // Size of each key, in bytes.  Either 4 or 8.
+    //
+
+    ULONG KeySizeInBytes;
+
+    //
+    // Number of keys in each block, except for the last.
+    //
+
+    ULONG KeysPerBlock;
+
+    //
+    // Total number of keys, blocks, and 64-bit words of packed differences.
+    //
+
+    ULONGLONG NumberOfKeys;
+    ULONGLONG NumberOfBlocks;
+    ULONGLONG NumberOfWords;
+
+} COMPRESSED_KEYS_HEADER;
+typedef COMPRESSED_KEYS_HEADER *PCOMPRESSED_KEYS_HEADER;
+C_ASSERT(sizeof(COMPRESSED_KEYS_HEADER) % sizeof(ULONGLONG) == 0);
+
+//
+// Define a block index entry.
+//
+
+typedef struct _COMPRESSED_KEYS_BLOCK {
+
+    //
+    // First key of the block.
+    //
+
+    ULONGLONG FirstKey;
+
+    //
+    // Index of the block's first word of packed differences.
+    //
+
+    ULONGLONG WordOffset;
+
+    //
+    // Number of bits per packed difference, between 0 and the key size in
+    // bits, inclusive.
+    //
+
+    ULONG BitsPerDelta;
+
+    //
+    // Pad out to an 8-byte boundary.
+    //
+
+    ULONG Padding;
+
+} COMPRESSED_KEYS_BLOCK;
+typedef COMPRESSED_KEYS_BLOCK *PCOMPRESSED_KEYS_BLOCK;
+C_ASSERT(sizeof(COMPRESSED_KEYS_BLOCK) % sizeof(ULONGLONG) == 0);
+
+//
+// Helper macros.
+//
+
+#define IsCompressedKeysFile(Base, SizeInBytes)                      \
+    ((ULONGLONG)(SizeInBytes) >= sizeof(COMPRESSED_KEYS_HEADER) &&   \
+     ((PCOMPRESSED_KEYS_HEADER)(Base))->Magic == COMPRESSED_KEYS_MAGIC)
+
+#define GetCompressedKeysBlocks(Header) \
+    ((PCOMPRESSED_KEYS_BLOCK)((PCOMPRESSED_KEYS_HEADER)(Header) + 1))
+
+#define GetCompressedKeysWords(Header)                     \
+    ((PULONGLONG)(GetCompressedKeysBlocks(Header) +        \
+                  ((PCOMPRESSED_KEYS_HEADER)(Header))->NumberOfBlocks))
+
+#define GetCompressedKeysNumberOfBlockKeys(Header, BlockIndex)          \
+    (min((ULONGLONG)(Header)->KeysPerBlock,                             \
+         (Header)->NumberOfKeys -                                       \
+         ((ULONGLONG)(BlockIndex) * (Header)->KeysPerBlock)))
+
+FORCEINLINE
+ULONGLONG
+GetCompressedKeysBlockNumberOfWords(
+    _In_ ULONGLONG NumberOfBlockKeys,
+    _In_ ULONG BitsPerDelta
+    )
+/*++
+
+Routine Description:
+
+    Returns the number of 64-bit words required to hold the packed
+    differences of a block.
+
+Arguments:
+
+    NumberOfBlockKeys - Supplies the number of keys in the block.
+
+    BitsPerDelta - Supplies the number of bits per packed difference.
+
+Return Value:
+
+    The number of words.
+
+--*/
+{
+    ULONGLONG NumberOfBits;
+
+    if (NumberOfBlockKeys <= 1) {
+        return 0;
+    }
+
+    NumberOfBits = (NumberOfBlockKeys - 1) * BitsPerDelta;
+
+    return (
+        (NumberOfBits + COMPRESSED_KEYS_BITS_PER_WORD - 1) /
+        COMPRESSED_KEYS_BITS_PER_WORD
+    );
+}
+
+FORCEINLINE
+ULONG
+GetCompressedKeysBitsPerDelta(
+    _In_ ULONGLONG MaximumDelta
+    )
+/*++
+
+Routine Description:
+
+    Returns the number of bits required to pack a block's differences.
+
+Arguments:
+
+    MaximumDelta - Supplies the largest packed difference (i.e. difference
+        minus one) of the block.
+
+Return Value:
+
+    The number of bits, between 0 and 64, inclusive.
+
+--*/
+{
+    ULONG Bit;
+
+    if (!_BitScanReverse64(&Bit, MaximumDelta)) {
+        return 0;
+    }
+
+    return Bit + 1;
+}
+
+FORCEINLINE
+PULONGLONG
+EncodeCompressedKeysBlock(
+    _In_reads_(NumberOfBlockKeys) PVOID BlockKeys,
+    _In_ ULONG KeySizeInBytes,
+    _In_ ULONGLONG NumberOfBlockKeys,
+    _In_ ULONG BitsPerDelta,
+    _Out_ PULONGLONG Dest
+    )
+/*++
+
+Routine Description:
+
+    Packs the differences of a block of sorted, unique keys.
+
+Arguments:
+
+    BlockKeys - Supplies the keys of the block.
+
+    KeySizeInBytes - Supplies the size of each key, in bytes.
+
+    NumberOfBlockKeys - Supplies the number of keys in the block.
+
+    BitsPerDelta - Supplies the number of bits per packed difference, as
+        returned by GetCompressedKeysBitsPerDelta() for the block.
+
+    Dest - Supplies the address of the block's first word.  Exactly the
+        number of words returned by GetCompressedKeysBlockNumberOfWords() are
+        written.
+
+Return Value:
+
+    The address following the last word written.
+
+--*/
+{
+    ULONG Used;
+    ULONGLONG Key;
+    ULONGLONG Prev;
+    ULONGLONG Delta;
+    ULONGLONG Index;
+    ULONGLONG Accumulator;
+
+    if (BitsPerDelta == 0) {
+        return Dest;
+    }
+
+    Used = 0;
+    Accumulator = 0;
+
+    if (KeySizeInBytes == sizeof(ULONG)) {
+        Prev = ((PULONG)BlockKeys)[0];
+    } else {
+        Prev = ((PULONGLONG)BlockKeys)[0];
+    }
+
+    for (Index = 1; Index < NumberOfBlockKeys; Index++) {
+
+        if (KeySizeInBytes == sizeof(ULONG)) {
+            Key = ((PULONG)BlockKeys)[Index];
+        } else {
+            Key = ((PULONGLONG)BlockKeys)[Index];
+        }
+
+        Delta = Key - Prev - 1;
+        Prev = Key;
+
+        Accumulator |= Delta << Used;
+        Used += BitsPerDelta;
+
+        if (Used >= COMPRESSED_KEYS_BITS_PER_WORD) {
+
+            //
+            // The word is full; store it, and carry any bits of the delta
+            // that didn't fit over to the next word.
+            //
+
+            *Dest++ = Accumulator;
+            Used -= COMPRESSED_KEYS_BITS_PER_WORD;
+            Accumulator = (Used > 0 ? Delta >> (BitsPerDelta - Used) : 0);
+        }
+    }
+
+    if (Used > 0) {
+        *Dest++ = Accumulator;
+    }
+
+    return Dest;
+}
+
+FORCEINLINE
+_Success_(return != 0)
+BOOLEAN
+DecodeCompressedKeysBlock(
+    _In_ PCOMPRESSED_KEYS_BLOCK Block,
+    _In_reads_(NumberOfWords) PULONGLONG Words,
+    _In_ ULONGLONG NumberOfWords,
+    _In_ ULONG KeySizeInBytes,
+    _In_ ULONGLONG NumberOfBlockKeys,
+    _Out_writes_(NumberOfBlockKeys) PVOID BlockKeys
+    )
+/*++
+
+Routine Description:
+
+    Decodes a block of a compressed keys file into an array of keys.
+
+Arguments:
+
+    Block - Supplies a pointer to the block index entry.
+
+    Words - Supplies the base address of the file's packed differences.
+
+    NumberOfWords - Supplies the total number of words in the file.
+
+    KeySizeInBytes - Supplies the size of each key, in bytes.
+
+    NumberOfBlockKeys - Supplies the number of keys in the block.
+
+    BlockKeys - Supplies the address the block's keys are written to.
+
+Return Value:
+
+    TRUE if the block was decoded, FALSE if the block was invalid (i.e. its
+    words lie outside the file, or a key overflowed the key size).
+
+--*/
+{
+    ULONG Shift;
+    ULONG BitsPerDelta;
+    ULONGLONG Key;
+    ULONGLONG Mask;
+    ULONGLONG Delta;
+    ULONGLONG Index;
+    ULONGLONG BitIndex;
+    ULONGLONG Maximum;
+    ULONGLONG BlockNumberOfWords;
+    PULONGLONG Word;
+
+    BitsPerDelta = Block->BitsPerDelta;
+
+    if (BitsPerDelta > (KeySizeInBytes << 3)) {
+        return FALSE;
+    }
+
+    BlockNumberOfWords = GetCompressedKeysBlockNumberOfWords(NumberOfBlockKeys,
+                                                             BitsPerDelta);
+
+    if (Block->WordOffset > NumberOfWords ||
+        BlockNumberOfWords > NumberOfWords - Block->WordOffset) {
+        return FALSE;
+    }
+
+    if (KeySizeInBytes == sizeof(ULONG)) {
+        Maximum = (ULONG)-1;
+    } else {
+        Maximum = (ULONGLONG)-1;
+    }
+
+    Key = Block->FirstKey;
+
+    if (Key > Maximum) {
+        return FALSE;
+    }
+
+    Words += Block->WordOffset;
+    Mask = (BitsPerDelta == COMPRESSED_KEYS_BITS_PER_WORD ?
+            (ULONGLONG)-1 : (1ULL << BitsPerDelta) - 1);
+    BitIndex = 0;
+    Delta = 0;
+
+    for (Index = 0; Index < NumberOfBlockKeys; Index++) {
+
+        if (Index > 0) {
+
+            if (BitsPerDelta > 0) {
+
+                //
+                // Extract the next delta, which may straddle two words.
+                //
+
+                Word = Words + (BitIndex / COMPRESSED_KEYS_BITS_PER_WORD);
+                Shift = (ULONG)(BitIndex % COMPRESSED_KEYS_BITS_PER_WORD);
+                Delta = Word[0] >> Shift;
+
+                if (Shift + BitsPerDelta > COMPRESSED_KEYS_BITS_PER_WORD) {
+                    Delta |= Word[1] << (COMPRESSED_KEYS_BITS_PER_WORD - Shift);
+                }
+
+                Delta &= Mask;
+                BitIndex += BitsPerDelta;
+            }
+
+            //
+            // Keys are strictly increasing; a key that doesn't exceed its
+            // predecessor has wrapped around.
+            //
+
+            if (Delta >= Maximum - Key) {
+                return FALSE;
+            }
+
+            Key += Delta + 1;
+        }
+
+        if (KeySizeInBytes == sizeof(ULONG)) {
+            ((PULONG)BlockKeys)[Index] = (ULONG)Key;
+        } else {
+            ((PULONGLONG)BlockKeys)[Index] = Key;
+        }
+    }
+
+    return TRUE;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -66,12 +66,14 @@ TryExtractArgContextBulkCreateFlags(
     DECL_ARG(SkipTestAfterCreate);
     DECL_ARG(Compile);
     DECL_ARG(TryCuda);
+    DECL_ARG(CompressKeys);
 
     UNREFERENCED_PARAMETER(Allocator);
 
     SET_FLAG_AND_RETURN_IF_EQUAL(SkipTestAfterCreate);
     SET_FLAG_AND_RETURN_IF_EQUAL(Compile);
     SET_FLAG_AND_RETURN_IF_EQUAL(TryCuda);
+    SET_FLAG_AND_RETURN_IF_EQUAL(CompressKeys);
 
     return S_FALSE;
 }
@@ -92,12 +94,14 @@ TryExtractArgContextTableCreateFlags(
     DECL_ARG(SkipTestAfterCreate);
     DECL_ARG(Compile);
     DECL_ARG(TryCuda);
+    DECL_ARG(CompressKeys);
 
     UNREFERENCED_PARAMETER(Allocator);
 
     SET_FLAG_AND_RETURN_IF_EQUAL(SkipTestAfterCreate);
     SET_FLAG_AND_RETURN_IF_EQUAL(Compile);
     SET_FLAG_AND_RETURN_IF_EQUAL(TryCuda);
+    SET_FLAG_AND_RETURN_IF_EQUAL(CompressKeys);
 
     return S_FALSE;
 }
@@ -119,6 +123,9 @@ TryExtractArgKeysLoadFlags(
     DECL_ARG(SkipKeysVerification);
     DECL_ARG(DisableImplicitKeyDownsizing);
     DECL_ARG(TryInferKeySizeFromKeysFilename);
+    DECL_ARG(StringKeys);
+    DECL_ARG(SortKeys);
+    DECL_ARG(TextKeys);
 
     UNREFERENCED_PARAMETER(Allocator);
 
@@ -126,6 +133,9 @@ TryExtractArgKeysLoadFlags(
     SET_FLAG_AND_RETURN_IF_EQUAL(SkipKeysVerification);
     SET_FLAG_AND_RETURN_IF_EQUAL(DisableImplicitKeyDownsizing);
     SET_FLAG_AND_RETURN_IF_EQUAL(TryInferKeySizeFromKeysFilename);
+    SET_FLAG_AND_RETURN_IF_EQUAL(StringKeys);
+    SET_FLAG_AND_RETURN_IF_EQUAL(SortKeys);
+    SET_FLAG_AND_RETURN_IF_EQUAL(TextKeys);
 
     return S_FALSE;
 }
@@ -172,6 +182,10 @@ TryExtractArgTableCreateFlags(
     DECL_ARG(TryLargePagesForVertexPairs);
     DECL_ARG(TryUsePredictedAttemptsToLimitMaxConcurrency);
     DECL_ARG(RngUseRandomStartSeed);
+    DECL_ARG(HashKeysWithMultipleSeedSets);
+    DECL_ARG(CachePartitionedAddKeys);
+    DECL_ARG(ParallelPeeling);
+    DECL_ARG(OrderPreserving);
 
     UNREFERENCED_PARAMETER(Allocator);
 
@@ -217,6 +231,10 @@ TryExtractArgTableCreateFlags(
     SET_FLAG_AND_RETURN_IF_EQUAL(TryLargePagesForVertexPairs);
     SET_FLAG_AND_RETURN_IF_EQUAL(TryUsePredictedAttemptsToLimitMaxConcurrency);
     SET_FLAG_AND_RETURN_IF_EQUAL(RngUseRandomStartSeed);
+    SET_FLAG_AND_RETURN_IF_EQUAL(HashKeysWithMultipleSeedSets);
+    SET_FLAG_AND_RETURN_IF_EQUAL(CachePartitionedAddKeys);
+    SET_FLAG_AND_RETURN_IF_EQUAL(ParallelPeeling);
+    SET_FLAG_AND_RETURN_IF_EQUAL(OrderPreserving);
 
     return S_FALSE;
 }
@@ -766,6 +784,15 @@ Return Value:
     DECL_ARG(Normal);
     DECL_ARG(Low);
 
+    //
+    // Declare local variables for the table data layouts.
+    //
+
+#define EXPAND_AS_TABLE_DATA_LAYOUT_DECL_ARG(Name) \
+    DECL_ARG(Name);
+
+    TABLE_DATA_LAYOUT_TABLE_ENTRY(EXPAND_AS_TABLE_DATA_LAYOUT_DECL_ARG)
+
     //
     // Invariant check: if number of table create parameters is 0, the array
     // pointer should be null, and vice versa.
@@ -947,6 +974,8 @@ Return Value:
 
     ADD_PARAM_IF_EQUAL_AND_VALUE_IS_INTEGER(ValueSizeInBytes);
 
+    ADD_PARAM_IF_EQUAL_AND_VALUE_IS_INTEGER(FingerprintSizeInBytes);
+
     ADD_PARAM_IF_EQUAL_AND_VALUE_IS_INTEGER(GraphImpl);
 
     ADD_PARAM_IF_EQUAL_AND_VALUE_IS_INTEGER(MinNumberOfKeysForFindBestGraph);
@@ -967,6 +996,16 @@ Return Value:
 
     BEST_COVERAGE_TYPE_TABLE_ENTRY(EXPAND_AS_ADD_PARAM);
 
+#define EXPAND_AS_ADD_TABLE_DATA_LAYOUT_PARAM(Name) \
+    ADD_PARAM_IF_EQUAL_AND_VALUE_EQUAL(TableDataLayout, Name);
+
+    TABLE_DATA_LAYOUT_TABLE_ENTRY(EXPAND_AS_ADD_TABLE_DATA_LAYOUT_PARAM);
+
+    if (IS_EQUAL(TableDataLayout)) {
+        Result = PH_E_INVALID_TABLE_DATA_LAYOUT;
+        goto Error;
+    }
+
 #define ADD_PARAM_IF_EQUAL_AND_VALUE_IS_CSV_OF_ASCENDING_INTEGERS(Name,  \
                                                                   Upper) \
     if (IS_EQUAL(Name)) {                                                \
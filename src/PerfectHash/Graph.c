@@ -22,6 +22,7 @@ Abstract:
 GRAPH_ADD_KEYS GraphHashKeysThenAdd;
 GRAPH_ADD_KEYS GraphAddKeys3;
 GRAPH_ADD_KEYS GraphHashKeysThenAdd3;
+GRAPH_ADD_KEYS GraphHashKeysThenAddPartitioned3;
 GRAPH_ADD_KEYS GraphAddKeysOriginalSeededHashRoutines;
 GRAPH_VERIFY GraphVerifyOriginalSeededHashRoutines;
 GRAPH_CALCULATE_ASSIGNED_MEMORY_COVERAGE
@@ -29,6 +30,7 @@ GRAPH_CALCULATE_ASSIGNED_MEMORY_COVERAGE
 GRAPH_ASSIGN GraphAssign;
 GRAPH_ASSIGN GraphAssign2;
 GRAPH_ASSIGN GraphAssign3;
+GRAPH_ASSIGN GraphAssignBlocked3;
 GRAPH_IS_ACYCLIC GraphIsAcyclic;
 GRAPH_IS_ACYCLIC GraphIsAcyclic3;
 
@@ -222,15 +224,41 @@ Return Value:
     RELEASE(Graph->Keys);
 
     //
-    // Free the vertex pairs array if applicable.
+    // Free the vertex pairs array if applicable.  If multi-seed hashing is
+    // active, VertexPairs will point somewhere within the seed set vertex
+    // pairs allocation, which is what needs to be freed.
     //
 
-    if (Graph->VertexPairs != NULL) {
+    if (Graph->SeedSetVertexPairs != NULL) {
+        if (!VirtualFree(Graph->SeedSetVertexPairs, 0, MEM_RELEASE)) {
+            SYS_ERROR(VirtualFree);
+        }
+    } else if (Graph->VertexPairs != NULL) {
         if (!VirtualFree(Graph->VertexPairs, 0, MEM_RELEASE)) {
             SYS_ERROR(VirtualFree);
         }
     }
 
+    //
+    // Free the partitioned edges array if applicable.
+    //
+
+    if (Graph->PartitionedEdges != NULL) {
+        if (!VirtualFree(Graph->PartitionedEdges, 0, MEM_RELEASE)) {
+            SYS_ERROR(VirtualFree);
+        }
+    }
+
+    //
+    // Free the parallel peeling frontiers if applicable.
+    //
+
+    if (Graph->PeelFrontiers != NULL) {
+        if (!VirtualFree(Graph->PeelFrontiers, 0, MEM_RELEASE)) {
+            SYS_ERROR(VirtualFree);
+        }
+    }
+
     return;
 }
 
@@ -520,8 +548,9 @@ Return Value:
     //
 
     Table = Graph->Context->Table;
-    Mask = Table->HashMask;
-    SeededHashEx = SeededHashExRoutines[Table->HashFunctionId];
+    Mask = GetSeededHashExMask(Table);
+    SeededHashEx = GetSeededHashExRoutine(Table->HashFunctionId,
+                                          Table->MaskFunctionId);
     Edges = (PEDGE)Keys;
 
     //
@@ -573,6 +602,14 @@ Routine Description:
     This routine hashes all keys into vertices without adding the resulting
     vertices to the graph.  It is used by GraphHashKeysThenAdd().
 
+    If the hash function has a batch implementation available for this CPU
+    (see GetSeededHashExBatchRoutine()), it is used to hash all keys in a
+    single call (8 or 16 keys at a time for the AVX2 and AVX-512 versions),
+    otherwise, the seeded hash routine is called for each key.
+
+    If multi-seed hashing is active, GraphHashKeysMultiSeed() is called
+    instead.
+
 Arguments:
 
     Graph - Supplies a pointer to the graph for which the hash values will be
@@ -600,20 +637,39 @@ Return Value:
     VERTEX_PAIR Hash;
     GRAPH_FLAGS Flags;
     ULONG OldProtection;
+    ULONG CollisionIndex;
     PULONGLONG VertexPairs;
     PPERFECT_HASH_TABLE Table;
     PPERFECT_HASH_TABLE_SEEDED_HASH_EX SeededHashEx;
+    PPERFECT_HASH_TABLE_SEEDED_HASH_EX_BATCH SeededHashExBatch;
 
     DECL_GRAPH_COUNTER_LOCAL_VARS();
 
+    if (IsMultiSeedGraph(Graph)) {
+        return GraphHashKeysMultiSeed(Graph, NumberOfKeys, Keys);
+    }
+
     //
     // Initialize aliases.
     //
 
     Result = S_OK;
     Table = Graph->Context->Table;
-    Mask = Table->HashMask;
-    SeededHashEx = SeededHashExRoutines[Table->HashFunctionId];
+    Mask = GetSeededHashExMask(Table);
+    SeededHashEx = GetSeededHashExRoutine(Table->HashFunctionId,
+                                          Table->MaskFunctionId);
+
+    //
+    // The batch routines are AND masking only; multiply-high masking always
+    // uses the scalar routine.
+    //
+
+    if (IsMultiplyHighMasking(Table->MaskFunctionId)) {
+        SeededHashExBatch = NULL;
+    } else {
+        SeededHashExBatch = GetSeededHashExBatchRoutine(Graph->Rtl,
+                                                        Table->HashFunctionId);
+    }
     Edges = (PEDGE)Keys;
 
     //
@@ -630,17 +686,43 @@ Return Value:
 
     START_GRAPH_COUNTER();
 
-    for (Edge = 0; Edge < NumberOfKeys; Edge++) {
-        Key = *Edges++;
+    if (SeededHashExBatch != NULL) {
 
-        Hash.AsULongLong = SeededHashEx(Key, &Graph->FirstSeed, Mask);
+        //
+        // N.B. Edge and Key are only used by the event below; set them to
+        //      the colliding edge and key if applicable, otherwise, mirror
+        //      the state they'd be in after the scalar loop completes.
+        //
 
-        if (Hash.Vertex1 == Hash.Vertex2) {
-            Result = PH_E_GRAPH_VERTEX_COLLISION_FAILURE;
-            break;
+        Result = SeededHashExBatch(Keys,
+                                   NumberOfKeys,
+                                   &Graph->FirstSeed,
+                                   Mask,
+                                   VertexPairs,
+                                   &CollisionIndex);
+
+        if (SUCCEEDED(Result)) {
+            Edge = NumberOfKeys;
+            Key = (NumberOfKeys > 0 ? Keys[NumberOfKeys - 1] : 0);
+        } else {
+            Edge = CollisionIndex;
+            Key = Keys[CollisionIndex];
         }
 
-        *VertexPairs++ = Hash.AsULongLong;
+    } else {
+
+        for (Edge = 0; Edge < NumberOfKeys; Edge++) {
+            Key = *Edges++;
+
+            Hash.AsULongLong = SeededHashEx(Key, &Graph->FirstSeed, Mask);
+
+            if (Hash.Vertex1 == Hash.Vertex2) {
+                Result = PH_E_GRAPH_VERTEX_COLLISION_FAILURE;
+                break;
+            }
+
+            *VertexPairs++ = Hash.AsULongLong;
+        }
     }
 
     STOP_GRAPH_COUNTER(HashKeys);
@@ -690,6 +772,111 @@ Return Value:
     return Result;
 }
 
+GRAPH_HASH_KEYS GraphHashKeysMultiSeed;
+
+_Use_decl_annotations_
+HRESULT
+GraphHashKeysMultiSeed(
+    PGRAPH Graph,
+    ULONG NumberOfKeys,
+    PKEY Keys
+    )
+/*++
+
+Routine Description:
+
+    This routine is the multi-seed counterpart to GraphHashKeys().  If the
+    graph's current batch of seed sets hasn't been hashed yet, all keys are
+    hashed against every seed set in a single pass (via the multi-seed hash
+    routine), filling out each seed set's vertex pairs array.  Otherwise, the
+    vertex pairs for the current seed set are already available, and no keys
+    need to be read at all.
+
+    N.B. The HashKeys counter will reflect the cost of hashing the entire
+         batch for the first seed set of each batch, and will be negligible
+         for the remaining seed sets.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph for which the hash values will be
+        created.
+
+    NumberOfKeys - Supplies the number of keys.
+
+    Keys - Supplies the base address of the keys array.
+
+Return Value:
+
+    S_OK - Success.
+
+    PH_E_GRAPH_VERTEX_COLLISION_FAILURE - The current seed set yielded two
+        vertices that, when masked, were identical.
+
+--*/
+{
+    KEY Key = 0;
+    EDGE Edge = 0;
+    ULONG Mask;
+    HRESULT Result;
+    PPERFECT_HASH_TABLE Table;
+
+    DECL_GRAPH_COUNTER_LOCAL_VARS();
+
+    //
+    // Initialize aliases.
+    //
+
+    Result = S_OK;
+    Table = Graph->Context->Table;
+    Mask = Table->HashMask;
+
+    START_GRAPH_COUNTER();
+
+    //
+    // Hash all seed sets if we haven't already done so.  If the hash mask has
+    // changed since the seed sets were hashed (i.e. a table resize occurred),
+    // the vertex pairs are stale and need to be regenerated.
+    //
+
+    if (!Graph->Flags.SeedSetsHashed || Graph->SeedSetsHashMask != Mask) {
+
+        Result = Graph->SeededHashExMultiSeed(
+            Keys,
+            NumberOfKeys,
+            &Graph->SeedSets[0][0],
+            Mask,
+            (PULONGLONG)Graph->SeedSetVertexPairs,
+            Graph->SeedSetVertexPairsStride,
+            Graph->SeedSetCollisionIndexes
+        );
+
+        if (SUCCEEDED(Result)) {
+            Graph->Flags.SeedSetsHashed = TRUE;
+            Graph->SeedSetsHashMask = Mask;
+        }
+    }
+
+    //
+    // Determine if the current seed set encountered a vertex collision.
+    //
+
+    if (SUCCEEDED(Result)) {
+        Edge = Graph->SeedSetCollisionIndexes[Graph->SeedSetIndex];
+        if (Edge < NumberOfKeys) {
+            Key = Keys[Edge];
+            Result = PH_E_GRAPH_VERTEX_COLLISION_FAILURE;
+        } else if (NumberOfKeys > 0) {
+            Key = Keys[NumberOfKeys - 1];
+        }
+    }
+
+    STOP_GRAPH_COUNTER(HashKeys);
+
+    EVENT_WRITE_GRAPH(HashKeys);
+
+    return Result;
+}
+
 GRAPH_ADD_KEYS GraphHashKeysThenAdd;
 
 _Use_decl_annotations_
@@ -919,6 +1106,10 @@ Return Value:
         The number of value assignments did not equal the number of keys
         during graph validation.
 
+    PH_E_INDEX_NOT_ORDER_PRESERVING_DURING_GRAPH_VERIFICATION - The table is
+        order preserving, and a key's index did not equal its offset in the
+        keys array.
+
 --*/
 {
     PRTL Rtl;
@@ -929,6 +1120,7 @@ Return Value:
     PEDGE Edges;
     ULONG Bit;
     ULONG Index;
+    BOOLEAN OrderPreserving;
     ULONG PrevIndex;
     PULONG Values = NULL;
     VERTEX Vertex1;
@@ -973,6 +1165,7 @@ Return Value:
     Context = Info->Context;
     Rtl = Context->Rtl;
     Table = Context->Table;
+    OrderPreserving = IsOrderPreserving(Table);
     Allocator = Graph->Allocator;
     NumberOfKeys = Graph->NumberOfKeys;
     Edges = Keys = (PKEY)Table->Keys->KeyArrayBaseAddress;
@@ -1044,6 +1237,16 @@ Return Value:
 
         MASK_INDEX(Combined, &Index);
 
+        //
+        // If the table is order preserving, the key's index must be its
+        // offset in the keys array (i.e. the edge).
+        //
+
+        if (OrderPreserving && Index != Edge) {
+            Result = PH_E_INDEX_NOT_ORDER_PRESERVING_DURING_GRAPH_VERIFICATION;
+            goto Error;
+        }
+
         Bit = Index;
 
         //
@@ -1076,11 +1279,13 @@ Return Value:
         }
 
         //
-        // Set the bit and store this key in the underlying values array.
+        // Set the bit, store this key in the underlying values array, and
+        // capture its fingerprint if applicable.
         //
 
         SetGraphBit(AssignedBitmap, Bit);
         Values[Index] = Key;
+        PerfectHashTableStoreFingerprint(Table, Index, Key);
 
     }
 
@@ -1156,6 +1361,10 @@ Return Value:
         The number of value assignments did not equal the number of keys
         during graph validation.
 
+    PH_E_INDEX_NOT_ORDER_PRESERVING_DURING_GRAPH_VERIFICATION - The table is
+        order preserving, and a key's index did not equal its offset in the
+        keys array.
+
 --*/
 {
     PRTL Rtl;
@@ -1169,6 +1378,14 @@ Return Value:
     ULONG PrevIndex;
     ULONG HashMask;
     ULONG IndexMask;
+    ULONG IndexModulus;
+    ULONG ElementSizeInBits;
+    ULONG CacheLine1;
+    ULONG CacheLine2;
+    ULONGLONG CacheLines;
+    BOOLEAN Interleaved;
+    BOOLEAN MultiplyHigh;
+    BOOLEAN OrderPreserving;
     PULONG Values = NULL;
     VERTEX Vertex1;
     VERTEX Vertex2;
@@ -1207,13 +1424,17 @@ Return Value:
     Context = Info->Context;
     Rtl = Context->Rtl;
     Table = Context->Table;
-    HashMask = Table->HashMask;
+    OrderPreserving = IsOrderPreserving(Table);
+    HashMask = GetSeededHashExMask(Table);
     IndexMask = Table->IndexMask;
+    IndexModulus = Table->IndexModulus;
+    MultiplyHigh = IsMultiplyHighMasking(Table->MaskFunctionId);
     Allocator = Graph->Allocator;
     NumberOfKeys = Graph->NumberOfKeys;
     Edges = Keys = (PKEY)Table->Keys->KeyArrayBaseAddress;
     Assigned = Graph->Assigned;
-    SeededHashEx = SeededHashExRoutines[Table->HashFunctionId];
+    SeededHashEx = GetSeededHashExRoutine(Table->HashFunctionId,
+                                          Table->MaskFunctionId);
 
     //
     // Sanity check our assigned bitmap is clear.
@@ -1242,6 +1463,34 @@ Return Value:
         return E_OUTOFMEMORY;
     }
 
+    //
+    // Determine the size of the table data elements touched by each lookup,
+    // such that the number of distinct cache lines touched can be tallied.
+    // With the interleaved layout, each element is a slot composed of the
+    // assigned value followed by the value, padded to the larger of the two.
+    // With the packed layout, elements are TableDataBitsPerElement bits wide;
+    // an element is attributed to the cache line containing its first bit.
+    //
+    // N.B. The table data (or slots) array is assumed to be cache line aligned.
+    //
+
+    Interleaved = IsInterleavedTableDataLayout(Table);
+    CacheLines = 0;
+
+    if (IsModulusMasking(Table->MaskFunctionId)) {
+        ElementSizeInBits = sizeof(ULONG) << 3;
+    } else if (IsPackedTableDataLayout(Table)) {
+        ElementSizeInBits = Table->TableDataBitsPerElement;
+    } else {
+        ElementSizeInBits = (1 << Table->TableDataArrayType) << 3;
+    }
+
+    if (Interleaved) {
+        ElementSizeInBits = (
+            max(ElementSizeInBits, (1UL << Table->ValueType) << 3) << 1
+        );
+    }
+
     //
     // Enumerate all keys in the input set and verify they can be resolved
     // correctly from the assigned vertex array.
@@ -1259,6 +1508,27 @@ Return Value:
         ASSERT(Hash.QuadPart);
         ASSERT(Hash.HighPart != Hash.LowPart);
 
+        //
+        // Tally the cache lines touched by a lookup of this key: one or two
+        // for the table data elements, plus one for the value, unless it is
+        // interleaved with the table data (in which case it always resides
+        // in the slot of one of the two vertices).
+        //
+
+        CacheLine1 = (ULONG)(
+            ((ULONGLONG)Hash.LowPart * ElementSizeInBits) >>
+            (CACHE_LINE_SHIFT + 3)
+        );
+        CacheLine2 = (ULONG)(
+            ((ULONGLONG)Hash.HighPart * ElementSizeInBits) >>
+            (CACHE_LINE_SHIFT + 3)
+        );
+
+        CacheLines += (CacheLine1 == CacheLine2 ? 1 : 2);
+        if (!Interleaved) {
+            CacheLines++;
+        }
+
         //
         // Extract the individual vertices.
         //
@@ -1270,7 +1540,24 @@ Return Value:
         // Calculate the index by adding the assigned values together.
         //
 
-        Index = (ULONG)((Vertex1 + Vertex2) & IndexMask);
+        if (MultiplyHigh) {
+            Index = MultiplyHighReduceIndex(
+                (ULONGLONG)Vertex1 + (ULONGLONG)Vertex2,
+                IndexModulus
+            );
+        } else {
+            Index = (ULONG)((Vertex1 + Vertex2) & IndexMask);
+        }
+
+        //
+        // If the table is order preserving, the key's index must be its
+        // offset in the keys array (i.e. the edge).
+        //
+
+        if (OrderPreserving && Index != Edge) {
+            Result = PH_E_INDEX_NOT_ORDER_PRESERVING_DURING_GRAPH_VERIFICATION;
+            goto Error;
+        }
 
         Bit = Index;
 
@@ -1292,18 +1579,27 @@ Return Value:
             PrevVertex1 = Assigned[PrevHash.LowPart];
             PrevVertex2 = Assigned[PrevHash.HighPart];
 
-            PrevIndex = (ULONG)((PrevVertex1 + PrevVertex2) & IndexMask);
+            if (MultiplyHigh) {
+                PrevIndex = MultiplyHighReduceIndex(
+                    (ULONGLONG)PrevVertex1 + (ULONGLONG)PrevVertex2,
+                    IndexModulus
+                );
+            } else {
+                PrevIndex = (ULONG)((PrevVertex1 + PrevVertex2) & IndexMask);
+            }
 
             Collisions++;
 
         }
 
         //
-        // Set the bit and store this key in the underlying values array.
+        // Set the bit, store this key in the underlying values array, and
+        // capture its fingerprint if applicable.
         //
 
         SetGraphBit(AssignedBitmap, Bit);
         Values[Index] = Key;
+        PerfectHashTableStoreFingerprint(Table, Index, Key);
 
     }
 
@@ -1320,6 +1616,8 @@ Return Value:
         goto Error;
     }
 
+    Table->CacheLinesPerLookup = (DOUBLE)CacheLines / (DOUBLE)NumberOfKeys;
+
     //
     // We're done, finish up.
     //
@@ -3030,12 +3328,31 @@ Return Value:
         goto End;
     }
 
+    //
+    // Shard01 tables solve many small graphs (one per shard) rather than one
+    // large one; dispatch to the shard solving loop.
+    //
+
+    if (IsShard01(Graph->Context->Table)) {
+        Result = GraphSolveShardsShard01(Graph);
+        goto End;
+    }
+
     //
     // Begin the solving loop.
     //
 
     while (Graph->Vtbl->ShouldWeContinueTryingToSolve(Graph)) {
 
+        //
+        // If another graph is peeling in parallel (--ParallelPeeling), help
+        // it finish prior to starting our next attempt.
+        //
+
+        if (Graph->Context->PeelJob != NULL) {
+            GraphHelpPeel3(Graph->Context);
+        }
+
         Result = Graph->Vtbl->LoadNewSeeds(Graph);
         if (FAILED(Result)) {
 
@@ -3178,12 +3495,17 @@ Return Value:
     PCWSTR KeysFileName;
     PGRAPH_INFO PrevInfo;
     PALLOCATOR Allocator;
+    LONG PartitionBits;
     ULONG ProtectionFlags;
     PPERFECT_HASH_KEYS Keys;
     PPERFECT_HASH_TABLE Table;
     SIZE_T VertexPairsSizeInBytes;
     PPERFECT_HASH_CONTEXT Context;
     BOOLEAN LargePagesForVertexPairs;
+    SIZE_T PartitionedEdgesSizeInBytes;
+    BOOLEAN LargePagesForPartitionedEdges;
+    SIZE_T PeelFrontiersSizeInBytes;
+    BOOLEAN LargePagesForPeelFrontiers;
     PASSIGNED_MEMORY_COVERAGE Coverage;
     PTABLE_INFO_ON_DISK TableInfoOnDisk;
     PRTL_TRY_LARGE_PAGE_VIRTUAL_ALLOC Alloc;
@@ -3231,6 +3553,15 @@ Return Value:
     Graph->NumberOfSeeds = Table->TableInfoOnDisk->NumberOfSeeds;
     Graph->NumberOfKeys = Table->Keys->NumberOfElements.LowPart;
 
+    //
+    // Shard01 graphs are sized to accommodate the largest shard.  (The number
+    // of keys is updated for each shard by GraphSolveShardsShard01().)
+    //
+
+    if (IsShard01(Table)) {
+        Graph->NumberOfKeys = Table->MaximumNumberOfKeysPerShard;
+    }
+
     Graph->ThreadId = GetCurrentThreadId();
     Graph->ThreadAttempt = 0;
 
@@ -3314,12 +3645,53 @@ Return Value:
             break;
 
         case 3:
+            if (IsBdz01(Table)) {
+
+                //
+                // The Bdz01 algorithm uses its own 3-uniform hypergraph
+                // routines, which build on the version 3 graph arrays.
+                //
+
+                Graph->Vtbl->IsAcyclic = GraphIsAcyclicBdz01;
+                Graph->Vtbl->Assign = GraphAssignBdz01;
+                Graph->Vtbl->AddKeys = GraphAddKeysBdz01;
+                Graph->Vtbl->Verify = GraphVerifyBdz01;
+                break;
+            } else if (IsBlock01(Table)) {
+
+                //
+                // Likewise for Block01, which solves each block's graph
+                // independently.
+                //
+
+                Graph->Vtbl->IsAcyclic = GraphIsAcyclicBlock01;
+                Graph->Vtbl->Assign = GraphAssignBlock01;
+                Graph->Vtbl->AddKeys = GraphAddKeysBlock01;
+                Graph->Vtbl->Verify = GraphVerifyBlock01;
+                break;
+            }
             Graph->Vtbl->IsAcyclic = GraphIsAcyclic3;
-            Graph->Vtbl->Assign = GraphAssign3;
-            Graph->Vtbl->AddKeys = (
-                (TableCreateFlags.HashAllKeysFirst != FALSE) ?
-                    GraphHashKeysThenAdd3 : GraphAddKeys3
+            Graph->Vtbl->Assign = (
+                (Graph->NumberOfKeys >= GRAPH_BLOCKED_ASSIGN_MIN_KEYS) ?
+                    GraphAssignBlocked3 : GraphAssign3
             );
+            if (TableCreateFlags.CachePartitionedAddKeys != FALSE) {
+                Graph->Vtbl->AddKeys = GraphHashKeysThenAddPartitioned3;
+            } else {
+                Graph->Vtbl->AddKeys = (
+                    (TableCreateFlags.HashAllKeysFirst != FALSE) ?
+                        GraphHashKeysThenAdd3 : GraphAddKeys3
+                );
+            }
+
+            //
+            // Shard01 solves each shard with the version 3 routines above, but
+            // needs to verify the table as a whole.
+            //
+
+            if (IsShard01(Table)) {
+                Graph->Vtbl->Verify = GraphVerifyShard01;
+            }
             break;
 
         default:
@@ -3397,6 +3769,38 @@ SkipGraphVtblHackery:
 
         if (Graph->VertexPairs == NULL) {
 
+            //
+            // If multi-seed hashing has been requested, and a multi-seed
+            // routine is available for this hash function and CPU, allocate
+            // one vertex pairs array per seed set, back-to-back.
+            //
+
+            Graph->NumberOfSeedSets = 0;
+            Graph->SeededHashExMultiSeed = NULL;
+
+            if (TableCreateFlags.HashKeysWithMultipleSeedSets != FALSE &&
+                Graph->Impl == 3 &&
+                !IsBdz01(Table) &&
+                !IsBlock01(Table) &&
+                !IsMultiplyHighMasking(Table->MaskFunctionId)) {
+
+                Graph->SeededHashExMultiSeed = (
+                    GetSeededHashExMultiSeedRoutine(Rtl,
+                                                    Table->HashFunctionId,
+                                                    &Graph->NumberOfSeedSets)
+                );
+
+                ASSERT(Graph->NumberOfSeedSets <=
+                       GRAPH_MAX_NUMBER_OF_SEED_SETS);
+            }
+
+            if (IsMultiSeedGraph(Graph)) {
+                Graph->SeedSetVertexPairsStride = (ULONG)(
+                    VertexPairsSizeInBytes / sizeof(VERTEX_PAIR)
+                );
+                VertexPairsSizeInBytes *= Graph->NumberOfSeedSets;
+            }
+
             LargePagesForVertexPairs = (BOOLEAN)(
                 TableCreateFlags.TryLargePagesForVertexPairs != FALSE
             );
@@ -3444,9 +3848,143 @@ SkipGraphVtblHackery:
             Graph->Flags.VertexPairsArrayIsWriteCombined =
                 Graph->Flags.WantsWriteCombiningForVertexPairsArray;
 
+            if (IsMultiSeedGraph(Graph)) {
+                Graph->SeedSetVertexPairs = Graph->VertexPairs;
+            }
+        }
+
+        //
+        // Any seed sets hashed prior to this point were hashed against the
+        // previous table size; force a new batch to be generated by the next
+        // call to LoadNewSeeds().
+        //
+
+        if (IsMultiSeedGraph(Graph)) {
+            Graph->Flags.SeedSetsHashed = FALSE;
+            Graph->SeedSetIndex = Graph->NumberOfSeedSets;
         }
     }
 
+    //
+    // If cache-partitioned edge insertion has been requested, determine the
+    // number of partitions required to keep each partition's slice of the
+    // Vertices3 array within GRAPH_PARTITION_SIZE_IN_BYTES.  This is redone
+    // on every call, as the number of vertices doubles upon each resize event.
+    // The partitioned edges array, like the vertex pairs array, is sized off
+    // the number of keys, so it only needs to be allocated once.
+    //
+
+    Graph->NumberOfPartitions = 0;
+    Graph->PartitionShift = 0;
+
+    if (TableCreateFlags.CachePartitionedAddKeys != FALSE &&
+        Graph->Impl == 3 &&
+        !IsBdz01(Table) &&
+        !IsBlock01(Table)) {
+
+        PartitionBits = (
+            (LONG)Graph->NumberOfVerticesPowerOf2Exponent -
+            GRAPH_PARTITION_VERTICES_SHIFT
+        );
+
+        if (PartitionBits < 0) {
+            PartitionBits = 0;
+        } else if (PartitionBits > GRAPH_MAX_PARTITION_BITS) {
+            PartitionBits = GRAPH_MAX_PARTITION_BITS;
+        }
+
+        Graph->NumberOfPartitions = 1 << PartitionBits;
+        Graph->PartitionShift = (
+            (ULONG)Graph->NumberOfVerticesPowerOf2Exponent -
+            (ULONG)PartitionBits
+        );
+
+        if (Graph->NumberOfPartitions > 1 && !Graph->PartitionedEdges) {
+
+            PartitionedEdgesSizeInBytes = (
+                (SIZE_T)Graph->NumberOfKeys * 2 * sizeof(VERTEX_EDGE)
+            );
+
+            LargePagesForPartitionedEdges = (BOOLEAN)(
+                TableCreateFlags.TryLargePagesForVertexPairs != FALSE
+            );
+
+            Alloc = Rtl->Vtbl->TryLargePageVirtualAlloc;
+            Graph->PartitionedEdges = Alloc(Rtl,
+                                            NULL,
+                                            PartitionedEdgesSizeInBytes,
+                                            MEM_RESERVE | MEM_COMMIT,
+                                            PAGE_READWRITE,
+                                            &LargePagesForPartitionedEdges);
+
+            if (Graph->PartitionedEdges == NULL) {
+                Result = E_OUTOFMEMORY;
+                goto Error;
+            }
+        }
+    }
+
+    //
+    // If parallel peeling has been requested and the graph is large enough to
+    // warrant it, make sure the frontier arrays are large enough for the
+    // current number of vertices.  Unlike the partitioned edges array, these
+    // are sized off the number of vertices, so they need to be reallocated
+    // upon each resize event.
+    //
+
+    if (TableCreateFlags.ParallelPeeling != FALSE &&
+        Graph->Impl == 3 &&
+        !IsBdz01(Table) &&
+        !IsBlock01(Table) &&
+        Graph->NumberOfKeys >= GRAPH_PARALLEL_PEEL_MIN_KEYS) {
+
+        PeelFrontiersSizeInBytes = (
+            (SIZE_T)Graph->NumberOfVertices * 2 * sizeof(VERTEX)
+        );
+
+        if (Graph->PeelFrontiersSizeInBytes < PeelFrontiersSizeInBytes) {
+
+            if (Graph->PeelFrontiers != NULL) {
+                if (!VirtualFree(Graph->PeelFrontiers, 0, MEM_RELEASE)) {
+                    SYS_ERROR(VirtualFree);
+                    Result = PH_E_SYSTEM_CALL_FAILED;
+                    goto Error;
+                }
+                Graph->PeelFrontiers = NULL;
+                Graph->PeelFrontiersSizeInBytes = 0;
+            }
+
+            LargePagesForPeelFrontiers = (BOOLEAN)(
+                TableCreateFlags.TryLargePagesForGraphEdgeAndVertexArrays
+            );
+
+            Alloc = Rtl->Vtbl->TryLargePageVirtualAlloc;
+            Graph->PeelFrontiers = Alloc(Rtl,
+                                         NULL,
+                                         PeelFrontiersSizeInBytes,
+                                         MEM_RESERVE | MEM_COMMIT,
+                                         PAGE_READWRITE,
+                                         &LargePagesForPeelFrontiers);
+
+            if (Graph->PeelFrontiers == NULL) {
+                Result = E_OUTOFMEMORY;
+                goto Error;
+            }
+
+            Graph->PeelFrontiersSizeInBytes = PeelFrontiersSizeInBytes;
+        }
+
+        Graph->PeelJob.SizeOfStruct = sizeof(Graph->PeelJob);
+        Graph->PeelJob.Graph = Graph;
+    }
+
+    //
+    // The graph's arrays may have been (re)allocated above, so the next reset
+    // can't be done lazily.
+    //
+
+    Graph->Flags.LazyResetEligible = FALSE;
+
     //
     // Set the bitmap sizes and then allocate (or reallocate) the bitmap
     // buffers.
@@ -3637,6 +4175,69 @@ End:
 }
 
 
+FORCEINLINE
+VOID
+GraphFillArray(
+    _In_ PRTL Rtl,
+    _Out_writes_bytes_all_(SizeInBytes) PVOID Array,
+    _In_ ULONGLONG SizeInBytes,
+    _In_ BYTE Byte
+    )
+/*++
+
+Routine Description:
+
+    Fills a graph array with the given byte.  Arrays of at least
+    GRAPH_NON_TEMPORAL_CLEAR_MIN_SIZE_IN_BYTES are filled a page at a time
+    with non-temporal stores where AVX2 is available, such that clearing a
+    large graph doesn't evict the rest of the working set from the cache.
+
+    N.B. Graph arrays are YMM-aligned, which satisfies the alignment
+         requirement of the non-temporal fill routine.
+
+Arguments:
+
+    Rtl - Supplies a pointer to an Rtl instance.
+
+    Array - Supplies the base address of the array to fill.
+
+    SizeInBytes - Supplies the size of the array, in bytes.
+
+    Byte - Supplies the byte to fill the array with.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(_M_AMD64) || defined(_M_X64)
+    ULONGLONG NumberOfPages;
+    ULONGLONG PagesSizeInBytes;
+
+    if (SizeInBytes >= GRAPH_NON_TEMPORAL_CLEAR_MIN_SIZE_IN_BYTES &&
+        Rtl->CpuFeatures.AVX2 != FALSE) {
+
+        ASSERT(IsAligned32(Array));
+
+        NumberOfPages = SizeInBytes >> PAGE_SHIFT;
+        PagesSizeInBytes = NumberOfPages << PAGE_SHIFT;
+
+        RtlFillPagesNonTemporal_AVX2(Rtl,
+                                     (PCHAR)Array,
+                                     Byte,
+                                     (ULONG)NumberOfPages);
+
+        Array = RtlOffsetToPointer(Array, PagesSizeInBytes);
+        SizeInBytes -= PagesSizeInBytes;
+    }
+#endif
+
+    if (SizeInBytes > 0) {
+        Rtl->RtlFillMemory(Array, (SIZE_T)SizeInBytes, Byte);
+    }
+}
+
 GRAPH_RESET GraphReset;
 
 _Use_decl_annotations_
@@ -3680,6 +4281,8 @@ Return Value:
     ULONG TotalNumberOfPages;
     ULONG TotalNumberOfLargePages;
     ULONG TotalNumberOfCacheLines;
+    BOOLEAN LazyReset;
+    LONGLONG ResizeAttempt;
     PPERFECT_HASH_CONTEXT Context;
     SIZE_T VertexPairsSizeInBytes;
     PERFECT_HASH_TABLE_CREATE_FLAGS TableCreateFlags;
@@ -3710,8 +4313,20 @@ Return Value:
 
     Graph->Attempt = InterlockedIncrement64(&Context->Attempts);
 
+    //
+    // Shard01 tables solve many independent graphs, so the resize threshold
+    // applies to the number of attempts made at solving the current shard,
+    // not the total number of attempts.
+    //
+
+    if (IsShard01(Context->Table)) {
+        ResizeAttempt = ++Graph->ShardAttempt;
+    } else {
+        ResizeAttempt = Graph->Attempt;
+    }
+
     if ((Context->FinishedCount == 0) &&
-        Graph->Attempt - 1 == Context->ResizeTableThreshold) {
+        ResizeAttempt - 1 == Context->ResizeTableThreshold) {
 
         if (!SetEvent(Context->TryLargerTableSizeEvent)) {
             SYS_ERROR(SetEvent);
@@ -3759,9 +4374,10 @@ Return Value:
     if (Info->##Name##SizeInBytes > 0) {                 \
         ASSERT(0 == Info->##Name##SizeInBytes -          \
                ((Info->##Name##SizeInBytes >> 3) << 3)); \
-        Rtl->RtlFillMemory((PDWORD64)Graph->##Name,      \
-                           Info->##Name##SizeInBytes,    \
-                           (BYTE)~0);                    \
+        GraphFillArray(Rtl,                              \
+                       Graph->##Name,                    \
+                       Info->##Name##SizeInBytes,        \
+                       (BYTE)~0);                        \
     }
 
     EMPTY_ARRAY(Next);
@@ -3769,20 +4385,39 @@ Return Value:
     EMPTY_ARRAY(Edges);
 
     //
-    // The Order and Assigned arrays get zeroed.
+    // The Order and Assigned arrays get zeroed.  For graph impl 3, this (and
+    // the emptying of the vertex pairs array below) is done lazily if the
+    // graph is eligible; i.e. only the elements written by the edges added
+    // during the previous attempt are cleared.  If the previous attempt added
+    // all of its edges (i.e. it made it as far as peeling), and the graph is
+    // large, touching each edge's vertices would incur two cache misses per
+    // key, so a full (non-temporal) clear is done instead.
     //
 
 #define ZERO_ARRAY(Name)                                 \
     if (Info->##Name##SizeInBytes > 0) {                 \
         ASSERT(0 == Info->##Name##SizeInBytes -          \
                ((Info->##Name##SizeInBytes >> 3) << 3)); \
-        Rtl->RtlZeroMemory((PDWORD64)Graph->##Name##,    \
-                           Info->##Name##SizeInBytes);   \
+        GraphFillArray(Rtl,                              \
+                       Graph->##Name,                    \
+                       Info->##Name##SizeInBytes,        \
+                       0);                               \
     }
 
-    ZERO_ARRAY(Order);
-    ZERO_ARRAY(Assigned);
-    ZERO_ARRAY(Vertices3);
+    LazyReset = (
+        Graph->Flags.LazyResetEligible != FALSE &&
+        (Graph->Flags.Shrinking == FALSE ||
+         Info->Vertices3SizeInBytes <=
+            GRAPH_LAZY_RESET_MAX_VERTICES3_SIZE_IN_BYTES)
+    );
+
+    if (LazyReset) {
+        GraphResetTouchedArrays3(Graph);
+    } else {
+        ZERO_ARRAY(Order);
+        ZERO_ARRAY(Assigned);
+        ZERO_ARRAY(Vertices3);
+    }
 
     Graph->OrderIndex = (LONG)Graph->NumberOfKeys;
     ASSERT(Graph->OrderIndex > 0);
@@ -3845,12 +4480,35 @@ Return Value:
         // For graph impl 3, the vertex pairs have state, and need to be set to
         // -1.
         //
+        // N.B. This doesn't apply to multi-seed graphs: the vertex pairs array
+        //      may already hold the pre-hashed pairs for this attempt's seed
+        //      set, and the multi-seed routine writes every element of every
+        //      seed set's array before any of them are read.
+        //
 
-        if (Graph->Impl == 3) {
+        if (Graph->Impl == 3 && !IsMultiSeedGraph(Graph) && !LazyReset) {
             EMPTY_ARRAY(VertexPairs);
         }
     }
 
+    //
+    // The graph impl 3 arrays are now clear; capture the number of keys for
+    // this attempt and determine if the next reset can be done lazily.
+    //
+    // N.B. Multi-seed graphs don't empty the vertex pairs array, and reading
+    //      back a write-combined vertex pairs array would be prohibitively
+    //      slow, so neither are eligible.
+    //
+
+    Graph->LazyResetNumberOfKeys = Graph->NumberOfKeys;
+    Graph->Flags.LazyResetEligible = (
+        Graph->Impl == 3 &&
+        !IsBdz01(Context->Table) &&
+        !IsBlock01(Context->Table) &&
+        !IsMultiSeedGraph(Graph) &&
+        !Graph->Flags.WantsWriteCombiningForVertexPairsArray
+    );
+
     //
     // Clear any remaining values.
     //
@@ -3953,6 +4611,11 @@ Routine Description:
     Loads new seed data for a graph instance.  This is called prior to each
     solving attempt.
 
+    If multi-seed hashing is active, seed data is generated for a batch of
+    seed sets at a time (see GraphGenerateSeeds()); subsequent calls load the
+    next seed set from the batch (and point the vertex pairs array at that
+    seed set's array) until it has been exhausted.
+
 Arguments:
 
     Graph - Supplies a pointer to the graph instance for which the new seed
@@ -3971,11 +4634,8 @@ Return Value:
 
 --*/
 {
-    PRNG Rng;
+    ULONG Index;
     HRESULT Result;
-    ULONG SizeInBytes;
-    PPERFECT_HASH_CONTEXT Context;
-    PPERFECT_HASH_TABLE_CREATE_PARAMETERS Params;
 
     //
     // Validate arguments.
@@ -3989,10 +4649,84 @@ Return Value:
         return PH_E_SPARE_GRAPH;
     }
 
+    if (!IsMultiSeedGraph(Graph)) {
+        return GraphGenerateSeeds(Graph);
+    }
+
+    //
+    // Multi-seed hashing is active.  If the current batch of seed sets hasn't
+    // been exhausted, advance to the next seed set.  Otherwise, generate a
+    // new batch, starting from the first seed set.
+    //
+
+    if (++Graph->SeedSetIndex >= Graph->NumberOfSeedSets) {
+
+        for (Index = 0; Index < Graph->NumberOfSeedSets; Index++) {
+            Result = GraphGenerateSeeds(Graph);
+            if (FAILED(Result)) {
+                return Result;
+            }
+            CopyInline(&Graph->SeedSets[Index],
+                       &Graph->Seeds,
+                       sizeof(Graph->Seeds));
+        }
+
+        Graph->SeedSetIndex = 0;
+        Graph->Flags.SeedSetsHashed = FALSE;
+    }
+
+    Index = Graph->SeedSetIndex;
+
+    CopyInline(&Graph->Seeds,
+               &Graph->SeedSets[Index],
+               sizeof(Graph->Seeds));
+
+    Graph->VertexPairs = (
+        Graph->SeedSetVertexPairs +
+        ((SIZE_T)Index * (SIZE_T)Graph->SeedSetVertexPairsStride)
+    );
+
+    return S_OK;
+}
+
+
+GRAPH_GENERATE_SEEDS GraphGenerateSeeds;
+
+_Use_decl_annotations_
+HRESULT
+GraphGenerateSeeds(
+    PGRAPH Graph
+    )
+/*++
+
+Routine Description:
+
+    Generates new random seed data for a graph instance, then applies any
+    seed mask counts, user seeds and seed masks.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph instance for which the new seed
+        data will be generated.
+
+Return Value:
+
+    S_OK - Success.
+
+    Otherwise, an appropriate error code.
+
+--*/
+{
+    PRNG Rng;
+    HRESULT Result;
+    ULONG SizeInBytes;
+    PPERFECT_HASH_CONTEXT Context;
+    PPERFECT_HASH_TABLE_CREATE_PARAMETERS Params;
+
     //
-    // Arguments valid, continue.  Calculate the size in bytes required for the
-    // random data (based on the number of seeds used by the graph), then call
-    // out to the RNG component to obtain the random bytes.
+    // Calculate the size in bytes required for the random data (based on the
+    // number of seeds used by the graph), then call out to the RNG component
+    // to obtain the random bytes.
     //
 
     SizeInBytes = Graph->NumberOfSeeds * sizeof(Graph->FirstSeed);
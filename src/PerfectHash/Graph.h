@@ -55,6 +55,18 @@ typedef union _VERTEX_PAIR {
     ULARGE_INTEGER AsULargeInteger;
 } VERTEX_PAIR, *PVERTEX_PAIR;
 
+//
+// The BDZ algorithm (Bdz01) uses a 3-uniform hypergraph, where each edge (key)
+// connects three vertices; one in each of three equally-sized partitions of
+// the vertex space.
+//
+
+typedef struct _VERTEX_TRIPLE {
+    VERTEX Vertex1;
+    VERTEX Vertex2;
+    VERTEX Vertex3;
+} VERTEX_TRIPLE, *PVERTEX_TRIPLE;
+
 //
 // Our third graph implementation uses the following structures.  The 3 suffix
 // on the EDGE3 and VERTEX3 type names solely represents the version 3 of the
@@ -70,22 +82,185 @@ typedef union _EDGE3 {
     ULONGLONG AsULongLong;
 } EDGE3, *PEDGE3;
 
-typedef struct _VERTEX3 {
+typedef union _VERTEX3 {
+
+    struct {
+
+        //
+        // The degree of connections for this vertex.
+        //
+
+        DEGREE Degree;
+
+        //
+        // All edges for this vertex; an incidence list constructed via XOR'ing
+        // all edges together (aka "the XOR-trick").
+        //
+
+        EDGE Edges;
+    };
 
     //
-    // The degree of connections for this vertex.
+    // The degree and edges as a single 64-bit value; used by parallel peeling
+    // to atomically snapshot and update a vertex.
     //
 
-    DEGREE Degree;
+    LONGLONG AsLongLong;
+
+} VERTEX3, *PVERTEX3;
+C_ASSERT(sizeof(VERTEX3) == sizeof(LONGLONG));
+
+//
+// Cache-partitioned edge insertion (--CachePartitionedAddKeys) buckets each
+// (vertex, edge) update by the high bits of the vertex prior to applying it
+// to the graph's Vertices3 array.
+//
+
+typedef union _VERTEX_EDGE {
+    struct {
+        VERTEX Vertex;
+        EDGE Edge;
+    };
+    ULONGLONG AsULongLong;
+} VERTEX_EDGE, *PVERTEX_EDGE;
+
+//
+// Each partition covers 2^15 vertices, which, at 8 bytes per VERTEX3, keeps
+// each partition's slice of the Vertices3 array at 256KB (i.e. L2-resident).
+// The number of partitions (i.e. concurrent write streams during the scatter
+// pass) is capped at 2^10.
+//
+
+#define GRAPH_PARTITION_VERTICES_SHIFT 15
+#define GRAPH_MAX_PARTITION_BITS 10
+#define GRAPH_MAX_NUMBER_OF_PARTITIONS (1 << GRAPH_MAX_PARTITION_BITS)
+
+//
+// Graphs with at least GRAPH_BLOCKED_ASSIGN_MIN_KEYS keys are assigned via
+// GraphAssignBlocked3(), which processes the deletion order in batches of
+// GRAPH_ASSIGN_BATCH_SIZE edges, prefetching each batch's assigned array and
+// visited bitmap lines prior to walking it.  The threshold corresponds to an
+// assigned array (2^19 vertices) of 2MB; i.e. larger than a typical L2.
+//
+
+#define GRAPH_BLOCKED_ASSIGN_MIN_KEYS (1 << 18)
+#define GRAPH_ASSIGN_BATCH_SIZE 256
+
+//
+// GraphReset() clears the graph impl 3 arrays lazily, i.e. only the elements
+// touched by the edges added during the previous attempt, unless that attempt
+// added all of its edges (i.e. got as far as peeling) and the Vertices3 array
+// is larger than GRAPH_LAZY_RESET_MAX_VERTICES3_SIZE_IN_BYTES.  Full clears
+// of arrays at least GRAPH_NON_TEMPORAL_CLEAR_MIN_SIZE_IN_BYTES in size use
+// non-temporal stores (where supported), such that clearing a large graph
+// doesn't evict everything else from the cache.
+//
+
+#define GRAPH_LAZY_RESET_MAX_VERTICES3_SIZE_IN_BYTES (1 << 20)
+#define GRAPH_NON_TEMPORAL_CLEAR_MIN_SIZE_IN_BYTES (1 << 22)
+
+//
+// Parallel peeling (--ParallelPeeling) splits the peeling phase of a single
+// graph into rounds, where each round removes the edges of all vertices in
+// the current frontier (i.e. vertices of degree 1), and the vertices whose
+// degree drops to 1 as a result form the next frontier.  Each round is split
+// into chunks of GRAPH_PEEL_CHUNK_SIZE vertices, which are claimed by the
+// owning graph's thread and any other solving threads that join the job.
+// Graphs with fewer than GRAPH_PARALLEL_PEEL_MIN_KEYS keys are always peeled
+// serially.
+//
+
+#define GRAPH_PEEL_CHUNK_SIZE 1024
+#define GRAPH_PARALLEL_PEEL_MIN_KEYS (1 << 20)
+
+//
+// The job cursor packs the round number into the high 32 bits and the next
+// chunk to be claimed into the low 32 bits.  The following chunk values have
+// special meaning: the round's parameters are being prepared (closed), or the
+// job has finished (done).
+//
+
+#define GRAPH_PEEL_CURSOR_CLOSED 0xffffffff
+#define GRAPH_PEEL_CURSOR_DONE   0xfffffffe
+
+#define GRAPH_PEEL_CURSOR(Round, Chunk) \
+    ((LONGLONG)(((ULONGLONG)(Round) << 32) | (ULONGLONG)(ULONG)(Chunk)))
+
+#define GRAPH_PEEL_CURSOR_ROUND(Cursor) ((ULONG)((ULONGLONG)(Cursor) >> 32))
+#define GRAPH_PEEL_CURSOR_CHUNK(Cursor) ((ULONG)(Cursor))
+
+typedef enum _GRAPH_PEEL_PHASE {
 
     //
-    // All edges for this vertex; an incidence list constructed via XOR'ing all
-    // edges together (aka "the XOR-trick").
+    // Scan all vertices and collect those of degree 1 into the next frontier.
     //
 
-    EDGE Edges;
+    GraphPeelScanPhase = 0,
 
-} VERTEX3, *PVERTEX3;
+    //
+    // Remove the edges of all vertices in the current frontier, collecting
+    // vertices whose degree drops to 1 into the next frontier.
+    //
+
+    GraphPeelFrontierPhase,
+
+} GRAPH_PEEL_PHASE;
+
+typedef struct _Struct_size_bytes_(SizeOfStruct) _GRAPH_PEEL_JOB {
+
+    //
+    // Size of the structure, in bytes.
+    //
+
+    _Field_range_(==, sizeof(struct _GRAPH_PEEL_JOB)) ULONG SizeOfStruct;
+
+    //
+    // Number of threads (other than the owner) currently participating in
+    // the job.  The owner waits for this to drop to zero before returning.
+    //
+
+    volatile LONG NumberOfHelpers;
+
+    //
+    // Round and chunk cursor; see GRAPH_PEEL_CURSOR().  The round number is
+    // never reset, which ensures a stale cursor value from a prior job can't
+    // be mistaken for a cursor value of the current job.
+    //
+
+    volatile LONGLONG Cursor;
+
+    //
+    // Number of chunks completed in the current round.
+    //
+
+    volatile LONG ChunksCompleted;
+
+    //
+    // Round parameters; only written by the owner whilst the cursor is closed.
+    //
+
+    GRAPH_PEEL_PHASE Phase;
+    ULONG NumberOfItems;
+    ULONG NumberOfChunks;
+
+    _Readable_elements_(NumberOfItems)
+    PVERTEX Frontier;
+
+    _Writable_elements_(NumberOfVertices)
+    PVERTEX NextFrontier;
+
+    volatile LONG NextFrontierCount;
+
+    ULONG Padding1;
+
+    //
+    // Pointer to the owning graph.
+    //
+
+    struct _GRAPH *Graph;
+
+} GRAPH_PEEL_JOB;
+typedef GRAPH_PEEL_JOB *PGRAPH_PEEL_JOB;
 
 //
 // A core concept of the 2-part hypergraph algorithm for generating a perfect
@@ -466,11 +641,30 @@ typedef union _GRAPH_FLAGS {
 
         ULONG RemoveWriteCombineAfterSuccessfulHashKeys:1;
 
+        //
+        // When set, indicates the vertex pairs arrays for all of the graph's
+        // seed sets have been populated by the multi-seed hash routine (see
+        // GraphHashKeysMultiSeed()).  Cleared whenever a new batch of seed
+        // sets is generated.
+        //
+
+        ULONG SeedSetsHashed:1;
+
+        //
+        // When set, indicates the graph impl 3 arrays (Vertices3, Edges3,
+        // Order and Assigned) only contain state written on behalf of the
+        // edges captured in the Edges3 array since they were last cleared,
+        // and thus, can be reset lazily by GraphReset() (see
+        // GraphResetTouchedArrays3()).  Cleared by GraphLoadInfo().
+        //
+
+        ULONG LazyResetEligible:1;
+
         //
         // Unused bits.
         //
 
-        ULONG Unused:19;
+        ULONG Unused:17;
     };
     LONG AsLong;
     ULONG AsULong;
@@ -500,6 +694,15 @@ DEFINE_UNUSED_STATE(GRAPH);
 
 #define DEFAULT_GRAPH_IMPL_VERSION 3
 
+//
+// Maximum number of seed sets hashed per pass over the keys when multi-seed
+// hashing is active (i.e. the number of 64-bit lanes in a ZMM register).
+//
+
+#define GRAPH_MAX_NUMBER_OF_SEED_SETS 8
+
+#define IsMultiSeedGraph(Graph) ((Graph)->NumberOfSeedSets > 0)
+
 //
 // Define the primary dimensions governing the graph size.
 //
@@ -1103,6 +1306,11 @@ typedef struct _Struct_size_bytes_(SizeOfStruct) _GRAPH {
     //
     // Array of VERTEX3 elements for the graph impl 3.
     //
+    // N.B. The Block01 algorithm only uses the first NumberOfBlocks elements
+    //      of this array: Degree captures the number of keys in the block,
+    //      and Edges captures the offset of the block's first edge in the
+    //      Order array (which is grouped by block).
+    //
 
     _Writable_elements_(NumberOfVertices)
     PVERTEX3 Vertices3;
@@ -1112,6 +1320,11 @@ typedef struct _Struct_size_bytes_(SizeOfStruct) _GRAPH {
     // indexed by number of keys.  For implementation 3, this will always
     // contain the array of vertex pairs, indexed by edge.
     //
+    // N.B. The Bdz01 algorithm reuses this array to store the vertex triples
+    //      for each edge (in which case it's sized accordingly).  The Block01
+    //      algorithm stores each edge's block in Vertex1, and its block hash
+    //      in Vertex2.
+    //
 
     _When_(GraphImpl == 1 || GraphImpl == 2,
            _Writable_elements_(NumberOfKeys))
@@ -1120,6 +1333,7 @@ typedef struct _Struct_size_bytes_(SizeOfStruct) _GRAPH {
     union {
         PVERTEX_PAIR VertexPairs;
         PEDGE3 Edges3;
+        PVERTEX_TRIPLE VertexTriples;
     };
 
     //
@@ -1240,6 +1454,90 @@ typedef struct _Struct_size_bytes_(SizeOfStruct) _GRAPH {
         };
     };
 
+    //
+    // Multi-seed hashing state (--HashKeysWithMultipleSeedSets).  When
+    // NumberOfSeedSets is non-zero, the graph generates NumberOfSeedSets seed
+    // sets at a time, and a single pass over the keys hashes all of them into
+    // back-to-back vertex pairs arrays in the SeedSetVertexPairs allocation.
+    // Each subsequent solving attempt loads the next seed set into the Seeds
+    // array above and points VertexPairs at the corresponding array.
+    //
+
+    ULONG NumberOfSeedSets;
+    ULONG SeedSetIndex;
+
+    //
+    // The hash mask in effect when the seed sets were hashed, and the number
+    // of elements between each seed set's vertex pairs array.
+    //
+
+    ULONG SeedSetsHashMask;
+    ULONG SeedSetVertexPairsStride;
+
+    _When_(NumberOfSeedSets > 0,
+           _Writable_elements_(NumberOfSeedSets * SeedSetVertexPairsStride))
+    PVERTEX_PAIR SeedSetVertexPairs;
+
+    PPERFECT_HASH_TABLE_SEEDED_HASH_EX_MULTI_SEED SeededHashExMultiSeed;
+
+    //
+    // Index of the first colliding key for each seed set, or NumberOfKeys if
+    // the seed set's keys hashed without collision.
+    //
+
+    ULONG SeedSetCollisionIndexes[GRAPH_MAX_NUMBER_OF_SEED_SETS];
+
+    ULONG SeedSets[GRAPH_MAX_NUMBER_OF_SEED_SETS][MAX_NUMBER_OF_SEEDS];
+
+    //
+    // Cache-partitioned edge insertion state (--CachePartitionedAddKeys).
+    // Each vertex V is assigned to partition (V >> PartitionShift).  When
+    // NumberOfPartitions is greater than 1, the (vertex, edge) updates for
+    // each key are scattered into PartitionedEdges (two per key), grouped
+    // by partition, such that PartitionOffsets[N] is the index of the first
+    // update for partition N.
+    //
+
+    ULONG NumberOfPartitions;
+    ULONG PartitionShift;
+
+    _Writable_elements_(NumberOfKeys * 2)
+    PVERTEX_EDGE PartitionedEdges;
+
+    ULONG PartitionOffsets[GRAPH_MAX_NUMBER_OF_PARTITIONS];
+
+    //
+    // Shard01 solving state.  ShardIndex captures the shard currently being
+    // solved by this graph, and ShardAttempt the number of attempts made at
+    // solving it.  The latter drives table resize events for Shard01 (see
+    // GraphReset()).
+    //
+
+    ULONG ShardIndex;
+    ULONG ShardAttempt;
+
+    //
+    // Parallel peeling state (--ParallelPeeling).  PeelFrontiers points to
+    // two back-to-back arrays of NumberOfVertices elements, which are used as
+    // the current and next frontier of each peeling round.
+    //
+
+    SIZE_T PeelFrontiersSizeInBytes;
+
+    _Writable_elements_(NumberOfVertices * 2)
+    PVERTEX PeelFrontiers;
+
+    GRAPH_PEEL_JOB PeelJob;
+
+    //
+    // Number of keys in effect when the graph was last reset.  This bounds
+    // the lazy reset of the graph impl 3 arrays, as the number of keys can
+    // change between attempts (e.g. Shard01).
+    //
+
+    ULONG LazyResetNumberOfKeys;
+    ULONG Padding1;
+
 } GRAPH;
 typedef GRAPH *PGRAPH;
 
@@ -1318,6 +1616,28 @@ HRESULT
     );
 typedef GRAPH_APPLY_WEIGHTED_SEED_MASKS *PGRAPH_APPLY_WEIGHTED_SEED_MASKS;
 
+typedef
+_Success_(return >= 0)
+HRESULT
+(NTAPI GRAPH_GENERATE_SEEDS)(
+    _In_ PGRAPH Graph
+    );
+typedef GRAPH_GENERATE_SEEDS *PGRAPH_GENERATE_SEEDS;
+
+typedef
+VOID
+(NTAPI GRAPH_HELP_PEEL)(
+    _In_ PPERFECT_HASH_CONTEXT Context
+    );
+typedef GRAPH_HELP_PEEL *PGRAPH_HELP_PEEL;
+
+typedef
+VOID
+(NTAPI GRAPH_RESET_TOUCHED_ARRAYS)(
+    _In_ PGRAPH Graph
+    );
+typedef GRAPH_RESET_TOUCHED_ARRAYS *PGRAPH_RESET_TOUCHED_ARRAYS;
+
 
 #ifndef __INTELLISENSE__
 extern GRAPH_INITIALIZE GraphInitialize;
@@ -1325,6 +1645,9 @@ extern GRAPH_RUNDOWN GraphRundown;
 extern GRAPH_APPLY_USER_SEEDS GraphApplyUserSeeds;
 extern GRAPH_APPLY_SEED_MASKS GraphApplySeedMasks;
 extern GRAPH_APPLY_WEIGHTED_SEED_MASKS GraphApplyWeightedSeedMasks;
+extern GRAPH_GENERATE_SEEDS GraphGenerateSeeds;
+extern GRAPH_HELP_PEEL GraphHelpPeel3;
+extern GRAPH_RESET_TOUCHED_ARRAYS GraphResetTouchedArrays3;
 
 //
 // Private vtbl methods.
@@ -1354,6 +1677,7 @@ extern GRAPH_SHOULD_WE_CONTINUE_TRYING_TO_SOLVE
     GraphShouldWeContinueTryingToSolve;
 extern GRAPH_ADD_KEYS GraphAddKeys;
 extern GRAPH_HASH_KEYS GraphHashKeys;
+extern GRAPH_HASH_KEYS GraphHashKeysMultiSeed;
 extern GRAPH_ADD_HASHED_KEYS GraphAddHashedKeys;
 #endif
 
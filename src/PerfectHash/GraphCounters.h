@@ -46,6 +46,17 @@ Abstract:
     Microseconds = (Cycles * 1000000) / Graph->Context->Frequency.QuadPart; \
     Graph->##Name##ElapsedMicroseconds.QuadPart = Microseconds
 
+//
+// Sets a counter from an elapsed cycle count accumulated by the caller; used
+// when a counter's elapsed time is the sum of multiple disjoint intervals.
+//
+
+#define SET_GRAPH_COUNTER(Name, Value)                                   \
+    Graph->##Name##ElapsedCycles.QuadPart = (Value);                     \
+    Graph->##Name##ElapsedMicroseconds.QuadPart = (                      \
+        ((Value) * 1000000) / Graph->Context->Frequency.QuadPart         \
+    )
+
 #define RESET_GRAPH_COUNTER(Name)                   \
     Graph->##Name##ElapsedCycles.QuadPart = 0;      \
     Graph->##Name##ElapsedMicroseconds.QuadPart = 0
@@ -56,25 +67,34 @@ Abstract:
     Table->##Name##ElapsedMicroseconds.QuadPart = \
         Graph->##Name##ElapsedCycles.QuadPart
 
-#define DECL_GRAPH_COUNTERS_WITHIN_STRUCT()          \
-    DECL_GRAPH_COUNTER_STRUCT_FIELDS(AddKeys);       \
-    DECL_GRAPH_COUNTER_STRUCT_FIELDS(HashKeys);      \
-    DECL_GRAPH_COUNTER_STRUCT_FIELDS(AddHashedKeys); \
-    DECL_GRAPH_COUNTER_STRUCT_FIELDS(Assign);        \
+#define DECL_GRAPH_COUNTERS_WITHIN_STRUCT()                \
+    DECL_GRAPH_COUNTER_STRUCT_FIELDS(AddKeys);             \
+    DECL_GRAPH_COUNTER_STRUCT_FIELDS(HashKeys);            \
+    DECL_GRAPH_COUNTER_STRUCT_FIELDS(AddHashedKeys);       \
+    DECL_GRAPH_COUNTER_STRUCT_FIELDS(PartitionHashedKeys); \
+    DECL_GRAPH_COUNTER_STRUCT_FIELDS(Assign);              \
+    DECL_GRAPH_COUNTER_STRUCT_FIELDS(AssignGather);        \
+    DECL_GRAPH_COUNTER_STRUCT_FIELDS(AssignWalk);          \
     DECL_GRAPH_COUNTER_STRUCT_FIELDS(IsAcyclic)
 
-#define RESET_GRAPH_COUNTERS()          \
-    RESET_GRAPH_COUNTER(AddKeys);       \
-    RESET_GRAPH_COUNTER(HashKeys);      \
-    RESET_GRAPH_COUNTER(AddHashedKeys); \
-    RESET_GRAPH_COUNTER(Assign);        \
+#define RESET_GRAPH_COUNTERS()                \
+    RESET_GRAPH_COUNTER(AddKeys);             \
+    RESET_GRAPH_COUNTER(HashKeys);            \
+    RESET_GRAPH_COUNTER(AddHashedKeys);       \
+    RESET_GRAPH_COUNTER(PartitionHashedKeys); \
+    RESET_GRAPH_COUNTER(Assign);              \
+    RESET_GRAPH_COUNTER(AssignGather);        \
+    RESET_GRAPH_COUNTER(AssignWalk);          \
     RESET_GRAPH_COUNTER(IsAcyclic)
 
 #define COPY_GRAPH_COUNTERS_FROM_GRAPH_TO_TABLE() \
     COPY_GRAPH_COUNTER(AddKeys);                  \
     COPY_GRAPH_COUNTER(HashKeys);                 \
     COPY_GRAPH_COUNTER(AddHashedKeys);            \
+    COPY_GRAPH_COUNTER(PartitionHashedKeys);      \
     COPY_GRAPH_COUNTER(Assign);                   \
+    COPY_GRAPH_COUNTER(AssignGather);             \
+    COPY_GRAPH_COUNTER(AssignWalk);               \
     COPY_GRAPH_COUNTER(IsAcyclic)
 
 // vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
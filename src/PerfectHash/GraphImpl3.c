@@ -190,8 +190,9 @@ Return Value:
     //
 
     Table = Graph->Context->Table;
-    Mask = Table->HashMask;
-    SeededHashEx = SeededHashExRoutines[Table->HashFunctionId];
+    Mask = GetSeededHashExMask(Table);
+    SeededHashEx = GetSeededHashExRoutine(Table->HashFunctionId,
+                                          Table->MaskFunctionId);
     Edges = (PEDGE)Keys;
 
     //
@@ -317,6 +318,182 @@ Return Value:
     return S_OK;
 }
 
+GRAPH_ADD_KEYS GraphHashKeysThenAddPartitioned3;
+
+_Use_decl_annotations_
+HRESULT
+GraphHashKeysThenAddPartitioned3(
+    PGRAPH Graph,
+    ULONG NumberOfKeys,
+    PKEY Keys
+    )
+/*++
+
+Routine Description:
+
+    This routine is a drop-in replacement for Graph->Vtbl->AddKeys when the
+    table create flag --CachePartitionedAddKeys is set.  Like the routine
+    GraphHashKeysThenAdd3(), all keys are hashed into vertex pairs first.
+    However, instead of adding each edge directly to the graph (which incurs
+    two random read-modify-writes against the Vertices3 array per key, both
+    of which will miss the cache once the array is larger than the cache),
+    the (vertex, edge) updates are first radix-bucketed by the high bits of
+    each vertex into partitions, such that each partition's slice of the
+    Vertices3 array fits in the L2 cache.  The updates are then applied one
+    partition at a time.
+
+    As the updates to each vertex (XOR'ing the edge into the incidence list
+    and incrementing the degree) are commutative, the resulting graph is
+    identical to the one produced by GraphHashKeysThenAdd3().
+
+    The time taken to partition the updates is captured by the counter
+    PartitionHashedKeys; the time taken to apply them is captured by the
+    counter AddHashedKeys.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph for which the keys will be added.
+
+    NumberOfKeys - Supplies the number of keys.
+
+    Keys - Supplies the base address of the keys array.
+
+Return Value:
+
+    S_OK - Success.
+
+    PH_E_GRAPH_VERTEX_COLLISION_FAILURE - The graph encountered two vertices
+        that, when masked, were identical.  None of the vertices will have
+        been added to the graph.
+
+--*/
+{
+    PRTL Rtl;
+    EDGE Edge;
+    ULONG Index;
+    ULONG Count;
+    ULONG Offset;
+    ULONG Shift;
+    HRESULT Result;
+    PVERTEX3 Vertex;
+    PVERTEX3 Vertices3;
+    PULONG Offsets;
+    VERTEX_EDGE Update;
+    VERTEX_PAIR VertexPair;
+    PVERTEX_PAIR VertexPairs;
+    PVERTEX_EDGE PartitionedEdges;
+    ULONG NumberOfPartitions;
+    ULONG NumberOfUpdates;
+
+    DECL_GRAPH_COUNTER_LOCAL_VARS();
+
+    //
+    // If the graph's vertices fit within a single partition, there's nothing
+    // to be gained from partitioning; defer to the normal routine.
+    //
+
+    NumberOfPartitions = Graph->NumberOfPartitions;
+
+    if (NumberOfPartitions <= 1) {
+        return GraphHashKeysThenAdd3(Graph, NumberOfKeys, Keys);
+    }
+
+    ASSERT(NumberOfPartitions <= GRAPH_MAX_NUMBER_OF_PARTITIONS);
+    ASSERT(Graph->PartitionedEdges != NULL);
+
+    //
+    // Attempt to hash the keys first.
+    //
+
+    Result = GraphHashKeys(Graph, NumberOfKeys, Keys);
+    if (FAILED(Result)) {
+        return Result;
+    }
+
+    Rtl = Graph->Rtl;
+    VertexPairs = Graph->VertexPairs;
+    PartitionedEdges = Graph->PartitionedEdges;
+    Offsets = Graph->PartitionOffsets;
+    Shift = Graph->PartitionShift;
+    NumberOfUpdates = NumberOfKeys * 2;
+
+    START_GRAPH_COUNTER();
+
+    //
+    // Construct a histogram of the number of updates per partition.
+    //
+
+    ZeroMemory(Offsets, sizeof(*Offsets) * NumberOfPartitions);
+
+    for (Edge = 0; Edge < NumberOfKeys; Edge++) {
+        VertexPair = VertexPairs[Edge];
+        ++Offsets[VertexPair.Vertex1 >> Shift];
+        ++Offsets[VertexPair.Vertex2 >> Shift];
+    }
+
+    //
+    // Convert the histogram into starting offsets via an exclusive prefix sum.
+    //
+
+    Offset = 0;
+    for (Index = 0; Index < NumberOfPartitions; Index++) {
+        Count = Offsets[Index];
+        Offsets[Index] = Offset;
+        Offset += Count;
+    }
+
+    ASSERT(Offset == NumberOfUpdates);
+
+    //
+    // Scatter the (vertex, edge) updates for both vertices of each edge into
+    // their respective partitions.  Each partition's offset is advanced as
+    // updates are written, such that, upon completion, Offsets[N] refers to
+    // the end of partition N (i.e. the start of partition N+1).
+    //
+
+    for (Edge = 0; Edge < NumberOfKeys; Edge++) {
+        VertexPair = VertexPairs[Edge];
+
+        Update.Vertex = VertexPair.Vertex1;
+        Update.Edge = Edge;
+        PartitionedEdges[Offsets[Update.Vertex >> Shift]++] = Update;
+
+        Update.Vertex = VertexPair.Vertex2;
+        PartitionedEdges[Offsets[Update.Vertex >> Shift]++] = Update;
+    }
+
+    STOP_GRAPH_COUNTER(PartitionHashedKeys);
+
+    //
+    // The updates are now grouped by partition, in ascending partition order,
+    // so a single linear pass applies them one cache-sized slice of the
+    // Vertices3 array at a time.
+    //
+
+    Vertices3 = Graph->Vertices3;
+
+    START_GRAPH_COUNTER();
+
+    for (Index = 0; Index < NumberOfUpdates; Index++) {
+        Update = PartitionedEdges[Index];
+
+#ifdef _DEBUG
+        ASSERT(Update.Vertex < Graph->NumberOfVertices);
+        ASSERT(Update.Edge < Graph->NumberOfEdges);
+#endif
+
+        Vertex = &Vertices3[Update.Vertex];
+        Vertex->Edges ^= Update.Edge;
+        ++Vertex->Degree;
+    }
+
+    STOP_GRAPH_COUNTER(AddHashedKeys);
+
+    EVENT_WRITE_GRAPH_ADD_HASHED_KEYS();
+
+    return S_OK;
+}
+
 VOID
 GraphRemoveVertex3(
     _In_ PGRAPH Graph,
@@ -367,6 +544,454 @@ GraphRemoveVertex3(
     Graph->Order[OrderIndex] = Edge;
 }
 
+//
+// Parallel peeling routines (--ParallelPeeling).
+//
+
+FORCEINLINE
+DEGREE
+GraphDecrementVertex3(
+    _In_ PGRAPH Graph,
+    _In_ VERTEX VertexIndex,
+    _In_ EDGE Edge
+    )
+/*++
+
+Routine Description:
+
+    Atomically removes an edge from a vertex's incidence list and decrements
+    its degree.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph.
+
+    VertexIndex - Supplies the vertex from which the edge is to be removed.
+
+    Edge - Supplies the edge to remove.
+
+Return Value:
+
+    The new degree of the vertex.
+
+--*/
+{
+    PVERTEX3 Vertex;
+    VERTEX3 Previous;
+    VERTEX3 Next;
+
+    Vertex = &Graph->Vertices3[VertexIndex];
+
+    do {
+        Previous.AsLongLong = *((volatile LONGLONG *)&Vertex->AsLongLong);
+        ASSERT(Previous.Degree > 0);
+        Next.Degree = Previous.Degree - 1;
+        Next.Edges = Previous.Edges ^ Edge;
+    } while (InterlockedCompareExchange64(&Vertex->AsLongLong,
+                                          Next.AsLongLong,
+                                          Previous.AsLongLong) !=
+             Previous.AsLongLong);
+
+    return Next.Degree;
+}
+
+VOID
+GraphProcessPeelChunk3(
+    _In_ PGRAPH_PEEL_JOB Job,
+    _In_ ULONG Chunk
+    )
+/*++
+
+Routine Description:
+
+    Processes a single chunk of the current peeling round.  For the scan
+    phase, the chunk is a range of vertices, and any vertices of degree 1 are
+    appended to the next frontier.  For the frontier phase, the chunk is a
+    range of the current frontier; the remaining edge of each vertex still of
+    degree 1 is claimed via the deleted edges bitmap and removed from both of
+    its vertices, and any vertex whose degree drops to 1 as a result is
+    appended to the next frontier.
+
+    Appended vertices and peeled edges are accumulated locally, then copied
+    to the next frontier and the deletion order in one go, such that each
+    chunk only performs a single interlocked reservation for each.
+
+Arguments:
+
+    Job - Supplies a pointer to the peeling job.
+
+    Chunk - Supplies the chunk to process; this must have been claimed via
+        the job's cursor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    PRTL Rtl;
+    LONG Base;
+    EDGE Edge;
+    ULONG Index;
+    ULONG First;
+    ULONG Last;
+    PGRAPH Graph;
+    PEDGE3 Edge3;
+    VERTEX Vertex;
+    VERTEX3 Snapshot;
+    ULONG NumberOfPeeled;
+    ULONG NumberOfAppended;
+    LONG Peeled[GRAPH_PEEL_CHUNK_SIZE];
+    VERTEX Appended[GRAPH_PEEL_CHUNK_SIZE];
+
+    Graph = Job->Graph;
+    Rtl = Graph->Rtl;
+    First = Chunk * GRAPH_PEEL_CHUNK_SIZE;
+    Last = min(First + GRAPH_PEEL_CHUNK_SIZE, Job->NumberOfItems);
+
+    NumberOfPeeled = 0;
+    NumberOfAppended = 0;
+
+    if (Job->Phase == GraphPeelScanPhase) {
+
+        for (Vertex = First; Vertex < Last; Vertex++) {
+            if (Graph->Vertices3[Vertex].Degree == 1) {
+                Appended[NumberOfAppended++] = Vertex;
+            }
+        }
+
+    } else {
+
+        for (Index = First; Index < Last; Index++) {
+
+            Vertex = Job->Frontier[Index];
+            Snapshot.AsLongLong = *(
+                (volatile LONGLONG *)&Graph->Vertices3[Vertex].AsLongLong
+            );
+
+            //
+            // If the vertex's edge has already been removed via its other
+            // vertex (i.e. both vertices were in the frontier), its degree
+            // will now be 0.
+            //
+
+            if (Snapshot.Degree != 1) {
+                continue;
+            }
+
+            Edge = Snapshot.Edges;
+            Edge3 = &Graph->Edges3[Edge];
+
+            if (IsEmpty(Edge3->Vertex1) || IsEmpty(Edge3->Vertex2)) {
+                continue;
+            }
+
+            //
+            // Claim the edge.  If both of its vertices are in the frontier,
+            // only one thread wins.
+            //
+
+            if (InterlockedBitTestAndSet64(
+                    (LONG64 *)Graph->DeletedEdgesBitmap.Buffer,
+                    (LONG64)Edge)) {
+                continue;
+            }
+
+            Peeled[NumberOfPeeled++] = (LONG)Edge;
+
+            //
+            // Remove the edge from both vertices.  The vertex we came from
+            // drops to degree 0; the other vertex joins the next frontier if
+            // its degree drops to 1.  Thus, each frontier vertex contributes
+            // at most one appended vertex.
+            //
+
+            if (GraphDecrementVertex3(Graph, Edge3->Vertex1, Edge) == 1) {
+                Appended[NumberOfAppended++] = Edge3->Vertex1;
+            }
+
+            if (GraphDecrementVertex3(Graph, Edge3->Vertex2, Edge) == 1) {
+                Appended[NumberOfAppended++] = Edge3->Vertex2;
+            }
+        }
+    }
+
+    ASSERT(NumberOfAppended <= GRAPH_PEEL_CHUNK_SIZE);
+
+    if (NumberOfAppended > 0) {
+        Base = InterlockedExchangeAdd(&Job->NextFrontierCount,
+                                      (LONG)NumberOfAppended);
+        CopyMemory(&Job->NextFrontier[Base],
+                   Appended,
+                   NumberOfAppended * sizeof(*Appended));
+    }
+
+    if (NumberOfPeeled > 0) {
+        Base = InterlockedExchangeAdd(&Graph->OrderIndex,
+                                      -((LONG)NumberOfPeeled));
+        Base -= (LONG)NumberOfPeeled;
+        ASSERT(Base >= 0);
+        CopyMemory(&Graph->Order[Base],
+                   Peeled,
+                   NumberOfPeeled * sizeof(*Peeled));
+    }
+}
+
+FORCEINLINE
+BOOLEAN
+GraphClaimPeelChunk3(
+    _In_ PGRAPH_PEEL_JOB Job,
+    _Out_ PULONG ChunkPointer,
+    _Out_ PBOOLEAN Done
+    )
+/*++
+
+Routine Description:
+
+    Attempts to claim the next chunk of the current peeling round.
+
+Arguments:
+
+    Job - Supplies a pointer to the peeling job.
+
+    ChunkPointer - Receives the claimed chunk if this routine returns TRUE.
+
+    Done - Receives TRUE if the job has finished, FALSE otherwise.
+
+Return Value:
+
+    TRUE if a chunk was claimed, FALSE if there are no chunks available to
+    claim at this time (i.e. the round is exhausted or being prepared, or the
+    job has finished).
+
+--*/
+{
+    ULONG Chunk;
+    LONGLONG Cursor;
+
+    *Done = FALSE;
+
+    while (TRUE) {
+
+        Cursor = Job->Cursor;
+        Chunk = GRAPH_PEEL_CURSOR_CHUNK(Cursor);
+
+        if (Chunk == GRAPH_PEEL_CURSOR_DONE) {
+            *Done = TRUE;
+            return FALSE;
+        }
+
+        //
+        // N.B. The round's parameters are only valid if the cursor hasn't
+        //      changed by the time we claim the chunk below, which the
+        //      compare-exchange guarantees.
+        //
+
+        if (Chunk == GRAPH_PEEL_CURSOR_CLOSED ||
+            Chunk >= Job->NumberOfChunks) {
+            return FALSE;
+        }
+
+        if (InterlockedCompareExchange64(&Job->Cursor,
+                                         Cursor + 1,
+                                         Cursor) == Cursor) {
+            *ChunkPointer = Chunk;
+            return TRUE;
+        }
+    }
+}
+
+GRAPH_HELP_PEEL GraphHelpPeel3;
+
+_Use_decl_annotations_
+VOID
+GraphHelpPeel3(
+    PPERFECT_HASH_CONTEXT Context
+    )
+/*++
+
+Routine Description:
+
+    Joins the context's active parallel peeling job, if any, and processes
+    chunks until the job finishes or solving is stopped.  This is called by
+    solving threads between solving attempts, as well as by graphs that were
+    unable to publish their own peeling job.
+
+Arguments:
+
+    Context - Supplies a pointer to the context.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ULONG Chunk;
+    BOOLEAN Done;
+    PGRAPH_PEEL_JOB Job;
+
+    Job = Context->PeelJob;
+    if (Job == NULL) {
+        return;
+    }
+
+    //
+    // N.B. The job may have finished (and even been restarted) between
+    //      reading the pointer and registering as a helper; this is benign,
+    //      as the job structure remains valid for the lifetime of the owning
+    //      graph, and we'll either see the done cursor or help the new job.
+    //
+
+    InterlockedIncrement(&Job->NumberOfHelpers);
+
+    while (TRUE) {
+
+        if (GraphClaimPeelChunk3(Job, &Chunk, &Done)) {
+            GraphProcessPeelChunk3(Job, Chunk);
+            InterlockedIncrement(&Job->ChunksCompleted);
+            continue;
+        }
+
+        if (Done || StopSolving(Context)) {
+            break;
+        }
+
+        YieldProcessor();
+    }
+
+    InterlockedDecrement(&Job->NumberOfHelpers);
+}
+
+BOOLEAN
+GraphTryPeelParallel3(
+    _In_ PGRAPH Graph
+    )
+/*++
+
+Routine Description:
+
+    Attempts to peel the graph in parallel.  The graph's peeling job is
+    published to the context, then the scan round and each subsequent
+    frontier round are opened in turn; each round is processed by this
+    thread and any threads that have joined via GraphHelpPeel3().
+
+    As rounds are separated by a barrier, and each round's peeled edges are
+    reserved from the end of the deletion order, the resulting Order array
+    lists edges in reverse round order.  The edges peeled in a given round
+    are independent of one another, so their relative order doesn't matter;
+    this maintains the invariant relied upon by GraphAssign3(): the vertex
+    from which an edge was peeled is unvisited by the time that edge is
+    assigned.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph.
+
+Return Value:
+
+    TRUE if the graph was peeled, FALSE if another graph's peeling job is
+    already active (in which case the caller should peel serially).
+
+--*/
+{
+    ULONG Chunk;
+    ULONG Round;
+    BOOLEAN Done;
+    ULONG NumberOfItems;
+    PVERTEX Frontiers;
+    PGRAPH_PEEL_JOB Job;
+    PPERFECT_HASH_CONTEXT Context;
+
+    Job = &Graph->PeelJob;
+    Context = Graph->Context;
+    Frontiers = Graph->PeelFrontiers;
+
+    ASSERT(Job->Graph == Graph);
+    ASSERT(Frontiers != NULL);
+
+    if (InterlockedCompareExchangePointer((PVOID volatile *)&Context->PeelJob,
+                                          Job,
+                                          NULL) != NULL) {
+        return FALSE;
+    }
+
+    Round = GRAPH_PEEL_CURSOR_ROUND(Job->Cursor);
+    NumberOfItems = Graph->NumberOfVertices;
+
+    Job->Phase = GraphPeelScanPhase;
+    Job->Frontier = NULL;
+    Job->NextFrontier = Frontiers;
+
+    while (NumberOfItems > 0) {
+
+        //
+        // Close the cursor whilst we prepare the round's parameters, then
+        // open it.
+        //
+
+        Round++;
+        InterlockedExchange64(&Job->Cursor,
+                              GRAPH_PEEL_CURSOR(Round,
+                                                GRAPH_PEEL_CURSOR_CLOSED));
+
+        Job->NumberOfItems = NumberOfItems;
+        Job->NumberOfChunks = (
+            (NumberOfItems + (GRAPH_PEEL_CHUNK_SIZE - 1)) /
+            GRAPH_PEEL_CHUNK_SIZE
+        );
+        Job->NextFrontierCount = 0;
+        Job->ChunksCompleted = 0;
+
+        InterlockedExchange64(&Job->Cursor, GRAPH_PEEL_CURSOR(Round, 0));
+
+        while (GraphClaimPeelChunk3(Job, &Chunk, &Done)) {
+            GraphProcessPeelChunk3(Job, Chunk);
+            InterlockedIncrement(&Job->ChunksCompleted);
+        }
+
+        //
+        // Wait for any chunks claimed by helpers to complete.
+        //
+
+        while ((ULONG)Job->ChunksCompleted != Job->NumberOfChunks) {
+            YieldProcessor();
+        }
+
+        //
+        // The next frontier becomes the current frontier.
+        //
+
+        NumberOfItems = (ULONG)Job->NextFrontierCount;
+        Job->Phase = GraphPeelFrontierPhase;
+        Job->Frontier = Job->NextFrontier;
+        Job->NextFrontier = (
+            (Job->Frontier == Frontiers) ?
+                Frontiers + Graph->NumberOfVertices : Frontiers
+        );
+    }
+
+    //
+    // Mark the job as done, unpublish it, then wait for any helpers to leave.
+    //
+
+    InterlockedExchange64(&Job->Cursor,
+                          GRAPH_PEEL_CURSOR(Round + 1,
+                                            GRAPH_PEEL_CURSOR_DONE));
+
+    InterlockedExchangePointer((PVOID volatile *)&Context->PeelJob, NULL);
+
+    while (Job->NumberOfHelpers != 0) {
+        YieldProcessor();
+    }
+
+    Graph->DeletedEdgeCount = (ULONG)(
+        (LONG)Graph->NumberOfKeys - Graph->OrderIndex
+    );
+
+    return TRUE;
+}
+
 GRAPH_IS_ACYCLIC GraphIsAcyclic3;
 
 _Use_decl_annotations_
@@ -397,6 +1022,7 @@ Return Value:
     VERTEX Vertex;
     PEDGE3 OtherEdge;
     BOOLEAN IsAcyclic;
+    BOOLEAN PeeledInParallel;
     ULONG NumberOfKeys;
     ULONG NumberOfEdges;
     ULONG NumberOfVertices;
@@ -435,18 +1061,40 @@ Return Value:
 
     START_GRAPH_COUNTER();
 
-    for (Vertex = 0; Vertex < NumberOfVertices; Vertex++) {
-        GraphRemoveVertex3(Graph, Vertex);
+    //
+    // If parallel peeling is active for this graph, attempt to peel the graph
+    // cooperatively with the other solving threads.  Only one graph can peel
+    // in parallel at a time; if another graph beat us to it, help it finish,
+    // then fall back to peeling our graph serially.
+    //
+
+    PeeledInParallel = FALSE;
+
+    if (Graph->PeelFrontiers != NULL &&
+        NumberOfKeys >= GRAPH_PARALLEL_PEEL_MIN_KEYS) {
+
+        PeeledInParallel = GraphTryPeelParallel3(Graph);
+
+        if (!PeeledInParallel) {
+            GraphHelpPeel3(Graph->Context);
+        }
     }
 
-    for (Index = (LONG)NumberOfKeys;
-         Graph->OrderIndex > 0 && Index > Graph->OrderIndex;
-         NOTHING)
-    {
-        EdgeIndex = Graph->Order[--Index];
-        OtherEdge = &Graph->Edges3[EdgeIndex];
-        GraphRemoveVertex3(Graph, OtherEdge->Vertex1);
-        GraphRemoveVertex3(Graph, OtherEdge->Vertex2);
+    if (!PeeledInParallel) {
+
+        for (Vertex = 0; Vertex < NumberOfVertices; Vertex++) {
+            GraphRemoveVertex3(Graph, Vertex);
+        }
+
+        for (Index = (LONG)NumberOfKeys;
+             Graph->OrderIndex > 0 && Index > Graph->OrderIndex;
+             NOTHING)
+        {
+            EdgeIndex = Graph->Order[--Index];
+            OtherEdge = &Graph->Edges3[EdgeIndex];
+            GraphRemoveVertex3(Graph, OtherEdge->Vertex1);
+            GraphRemoveVertex3(Graph, OtherEdge->Vertex2);
+        }
     }
 
     ASSERT(Graph->OrderIndex >= 0);
@@ -541,10 +1189,13 @@ Return Value:
     PEDGE3 Edge3;
     ULONG Index;
     LONG Order;
+    ULONG Target;
+    ULONG Modulus;
     ULONG Assigned;
     ULONG IndexMask;
     VERTEX Vertex1;
     VERTEX Vertex2;
+    BOOLEAN Interleaved;
     ULONG NumberOfKeys;
     ULONG NumberOfEdges;
     PPERFECT_HASH_TABLE Table;
@@ -560,6 +1211,15 @@ Return Value:
     NumberOfKeys = Graph->NumberOfKeys;
     NumberOfEdges = Graph->NumberOfEdges;
 
+    //
+    // With the interleaved table data layout, each key's index is the vertex
+    // being assigned (rather than the edge's position in the deletion order),
+    // and thus, assigned values are reduced by the number of vertices.
+    //
+
+    Interleaved = IsInterleavedTableDataLayout(Table);
+    Modulus = (Interleaved ? Graph->NumberOfVertices : NumberOfEdges);
+
     //
     // Invariant check: we should only be called on graphs that have already
     // been determined to be invariant.
@@ -593,9 +1253,10 @@ Return Value:
             Vertex2 = Edge3->Vertex1;
         }
 
-        Assigned = Order - Graph->Assigned[Vertex2];
-        if (Assigned >= NumberOfEdges) {
-            Assigned += NumberOfEdges;
+        Target = (Interleaved ? Vertex1 : (ULONG)Order);
+        Assigned = Target - Graph->Assigned[Vertex2];
+        if (Assigned >= Modulus) {
+            Assigned += Modulus;
         }
 
         ASSERT(Graph->Assigned[Vertex1] == INITIAL_ASSIGNMENT_VALUE);
@@ -618,4 +1279,276 @@ Return Value:
     return S_OK;
 }
 
+GRAPH_ASSIGN GraphAssignBlocked3;
+
+_Use_decl_annotations_
+HRESULT
+GraphAssignBlocked3(
+    PGRAPH Graph
+    )
+/*++
+
+Routine Description:
+
+    This routine is a cache-blocked variant of GraphAssign3(), used for large
+    graphs.  The deletion order is processed in batches of
+    GRAPH_ASSIGN_BATCH_SIZE edges.  Each batch is first gathered: the edge's
+    vertices are read from the Edges3 array into a local buffer, and the
+    assigned and visited bitmap lines of both vertices are prefetched, as are
+    the Edges3 lines of the next batch.  The batch is then walked in order,
+    exactly as per GraphAssign3().  Thus, the dependency order established
+    during peeling is preserved, and the resulting assigned array is identical
+    to the one produced by GraphAssign3(); the prefetches simply allow the
+    cache misses of an entire batch to be overlapped.
+
+    The time spent in each of the two passes is captured by the AssignGather
+    and AssignWalk graph counters, respectively.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph to operate on.
+
+Return Value:
+
+    S_OK.
+
+--*/
+{
+    PEDGE3 Edge3;
+    PEDGE3 Edges3;
+    ULONG Base;
+    ULONG Index;
+    ULONG Count;
+    LONG Order;
+    PLONG OrderArray;
+    ULONG Target;
+    ULONG Modulus;
+    ULONG Assigned;
+    VERTEX Vertex1;
+    VERTEX Vertex2;
+    PULONG Visited;
+    BOOLEAN Interleaved;
+    PASSIGNED AssignedArray;
+    ULONG NumberOfKeys;
+    ULONG NumberOfEdges;
+    LONGLONG GatherCycles;
+    LONGLONG WalkCycles;
+    LARGE_INTEGER Middle;
+    EDGE3 Batch[GRAPH_ASSIGN_BATCH_SIZE];
+
+    DECL_GRAPH_COUNTER_LOCAL_VARS();
+
+    //
+    // Initialize aliases.
+    //
+
+    NumberOfKeys = Graph->NumberOfKeys;
+    NumberOfEdges = Graph->NumberOfEdges;
+    Edges3 = Graph->Edges3;
+    OrderArray = Graph->Order;
+    AssignedArray = Graph->Assigned;
+    Visited = Graph->VisitedVerticesBitmap.Buffer;
+
+    //
+    // See GraphAssign3() for details regarding the interleaved layout.
+    //
+
+    Interleaved = IsInterleavedTableDataLayout(Graph->Context->Table);
+    Modulus = (Interleaved ? Graph->NumberOfVertices : NumberOfEdges);
+
+    //
+    // Invariant check: we should only be called on graphs that have already
+    // been determined to be invariant.
+    //
+
+    ASSERT(Graph->Flags.IsAcyclic);
+
+    EVENT_WRITE_GRAPH_ASSIGN_START();
+
+    GatherCycles = 0;
+    WalkCycles = 0;
+
+    //
+    // Prefetch the edges of the first batch.
+    //
+
+    Count = min(GRAPH_ASSIGN_BATCH_SIZE, NumberOfKeys);
+    for (Index = 0; Index < Count; Index++) {
+        PreFetchCacheLine(PF_TEMPORAL_LEVEL_1, &Edges3[OrderArray[Index]]);
+    }
+
+    for (Base = 0; Base < NumberOfKeys; Base += Count) {
+
+        Count = min(GRAPH_ASSIGN_BATCH_SIZE, NumberOfKeys - Base);
+
+        //
+        // Gather the batch's edges, and prefetch everything the walk below
+        // will touch, plus the edges of the next batch.
+        //
+
+        QueryPerformanceCounter(&Start);
+
+        for (Index = 0; Index < Count; Index++) {
+
+            Edge3 = &Batch[Index];
+            Edge3->AsULongLong = Edges3[OrderArray[Base + Index]].AsULongLong;
+
+            PreFetchCacheLine(PF_TEMPORAL_LEVEL_1,
+                              &AssignedArray[Edge3->Vertex1]);
+            PreFetchCacheLine(PF_TEMPORAL_LEVEL_1,
+                              &AssignedArray[Edge3->Vertex2]);
+            PreFetchCacheLine(PF_TEMPORAL_LEVEL_1,
+                              &Visited[Edge3->Vertex1 >> 5]);
+            PreFetchCacheLine(PF_TEMPORAL_LEVEL_1,
+                              &Visited[Edge3->Vertex2 >> 5]);
+
+            if (Base + Count + Index < NumberOfKeys) {
+                PreFetchCacheLine(
+                    PF_TEMPORAL_LEVEL_1,
+                    &Edges3[OrderArray[Base + Count + Index]]
+                );
+            }
+        }
+
+        QueryPerformanceCounter(&Middle);
+
+        //
+        // Walk the batch in deletion order and assign values.
+        //
+
+        for (Index = 0; Index < Count; Index++) {
+
+            Order = OrderArray[Base + Index];
+            Edge3 = &Batch[Index];
+
+            if (!IsVisitedVertex3(Graph, Edge3->Vertex1)) {
+                Vertex1 = Edge3->Vertex1;
+                Vertex2 = Edge3->Vertex2;
+            } else {
+                Vertex1 = Edge3->Vertex2;
+                Vertex2 = Edge3->Vertex1;
+            }
+
+            Target = (Interleaved ? Vertex1 : (ULONG)Order);
+            Assigned = Target - AssignedArray[Vertex2];
+            if (Assigned >= Modulus) {
+                Assigned += Modulus;
+            }
+
+            ASSERT(AssignedArray[Vertex1] == INITIAL_ASSIGNMENT_VALUE);
+            AssignedArray[Vertex1] = Assigned;
+
+            RegisterVertexVisit3(Graph, Vertex1);
+            RegisterVertexVisit3(Graph, Vertex2);
+        }
+
+        QueryPerformanceCounter(&End);
+
+        GatherCycles += Middle.QuadPart - Start.QuadPart;
+        WalkCycles += End.QuadPart - Middle.QuadPart;
+    }
+
+    SET_GRAPH_COUNTER(AssignGather, GatherCycles);
+    SET_GRAPH_COUNTER(AssignWalk, WalkCycles);
+
+    //
+    // The overall Assign counter covers both passes.
+    //
+
+    Cycles = GatherCycles + WalkCycles;
+    SET_GRAPH_COUNTER(Assign, Cycles);
+    Microseconds = Graph->AssignElapsedMicroseconds.QuadPart;
+
+    EVENT_WRITE_GRAPH_ASSIGN_STOP();
+
+    EVENT_WRITE_GRAPH_ASSIGN_RESULT();
+
+    return S_OK;
+}
+
+GRAPH_RESET_TOUCHED_ARRAYS GraphResetTouchedArrays3;
+
+_Use_decl_annotations_
+VOID
+GraphResetTouchedArrays3(
+    PGRAPH Graph
+    )
+/*++
+
+Routine Description:
+
+    Lazily resets the graph impl 3 arrays after a solving attempt, touching
+    only the elements written during that attempt, rather than clearing each
+    array in its entirety.  This relies on the following invariants:
+
+        - Edges are always added to the Edges3 array in order, starting from
+          edge 0; thus, the edges added during an attempt form a prefix of the
+          array, terminated by the first empty edge (or the number of keys).
+
+        - The only Vertices3 (and, if the graph was acyclic, Assigned)
+          elements written during an attempt are those of the vertices
+          connected by the added edges.
+
+        - The only Order elements written during an attempt are those from
+          the final order index up to the number of keys.
+
+    Each array is left in the same state a full clear would have left it in.
+
+    N.B. This routine is only called by GraphReset() when the graph's
+         LazyResetEligible flag is set (i.e. the arrays were last cleared by
+         GraphReset()), and the previous attempt's keys are captured in the
+         LazyResetNumberOfKeys field.  Multi-seed graphs and write-combined
+         vertex pairs arrays are never eligible.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph to reset.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    PRTL Rtl;
+    EDGE Edge;
+    PEDGE3 Edge3;
+    LONG OrderIndex;
+    BOOLEAN WasAcyclic;
+    ULONG NumberOfKeys;
+    PASSIGNED Assigned;
+    PVERTEX3 Vertices3;
+
+    Rtl = Graph->Rtl;
+    NumberOfKeys = Graph->LazyResetNumberOfKeys;
+    WasAcyclic = (BOOLEAN)(Graph->Flags.IsAcyclic != FALSE);
+    Assigned = Graph->Assigned;
+    Vertices3 = Graph->Vertices3;
+
+    for (Edge = 0; Edge < NumberOfKeys; Edge++) {
+
+        Edge3 = &Graph->Edges3[Edge];
+
+        if (IsEmpty(Edge3->Vertex1)) {
+            break;
+        }
+
+        Vertices3[Edge3->Vertex1].AsLongLong = 0;
+        Vertices3[Edge3->Vertex2].AsLongLong = 0;
+
+        if (WasAcyclic) {
+            Assigned[Edge3->Vertex1] = 0;
+            Assigned[Edge3->Vertex2] = 0;
+        }
+
+        Edge3->AsULongLong = (ULONGLONG)-1;
+    }
+
+    OrderIndex = Graph->OrderIndex;
+    if (OrderIndex >= 0 && (ULONG)OrderIndex < NumberOfKeys) {
+        ZeroMemory(&Graph->Order[OrderIndex],
+                   (NumberOfKeys - (ULONG)OrderIndex) * sizeof(*Graph->Order));
+    }
+}
+
 // vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -0,0 +1,710 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    GraphImplBdz01.c
+
+Abstract:
+
+    This module implements the 3-uniform hypergraph routines used by the Bdz01
+    algorithm.  It builds on the version 3 graph implementation (GraphImpl3.c):
+    the VERTEX3 array captures the degree and XOR'd incident edges of each
+    vertex, the Order array captures the edge deletion (peeling) order, and the
+    visited vertices bitmap is used during assignment.  The only differences
+    are that each edge connects three vertices instead of two, and the assigned
+    values are summed modulo the number of keys rather than masked.
+
+--*/
+
+#include "stdafx.h"
+#include "GraphImpl3.h"
+#include "PerfectHashEventsPrivate.h"
+
+//
+// When a solution has been found and the assignment step begins, the initial
+// value assigned to a vertex is govered by the following macro.
+//
+
+#define INITIAL_ASSIGNMENT_VALUE 0
+
+FORCEINLINE
+VOID
+GraphAddEdgeBdz01(
+    _In_ PGRAPH Graph,
+    _In_ EDGE Edge,
+    _In_ PVERTEX_TRIPLE Triple
+    )
+/*++
+
+Routine Description:
+
+    This routine adds an edge to the hypergraph for three vertices.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph for which the edge is to be added.
+
+    Edge - Supplies the edge to add to the graph.
+
+    Triple - Supplies the three vertices connected by the edge.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    PVERTEX3 Vertex;
+
+#ifdef _DEBUG
+    ASSERT(Triple->Vertex1 < Graph->NumberOfVertices);
+    ASSERT(Triple->Vertex2 < Graph->NumberOfVertices);
+    ASSERT(Triple->Vertex3 < Graph->NumberOfVertices);
+    ASSERT(Edge < Graph->NumberOfEdges);
+    ASSERT(!Graph->Flags.Shrinking);
+#endif
+
+    Vertex = &Graph->Vertices3[Triple->Vertex1];
+    Vertex->Edges ^= Edge;
+    ++Vertex->Degree;
+
+    Vertex = &Graph->Vertices3[Triple->Vertex2];
+    Vertex->Edges ^= Edge;
+    ++Vertex->Degree;
+
+    Vertex = &Graph->Vertices3[Triple->Vertex3];
+    Vertex->Edges ^= Edge;
+    ++Vertex->Degree;
+}
+
+
+GRAPH_ADD_KEYS GraphAddKeysBdz01;
+
+_Use_decl_annotations_
+HRESULT
+GraphAddKeysBdz01(
+    PGRAPH Graph,
+    ULONG NumberOfKeys,
+    PKEY Keys
+    )
+/*++
+
+Routine Description:
+
+    Add all keys to the hypergraph using the unique seeds to hash each key into
+    three vertex values (one per partition), connected by a "hyper-edge".
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph for which the keys will be added.
+
+    NumberOfKeys - Supplies the number of keys.
+
+    Keys - Supplies the base address of the keys array.
+
+Return Value:
+
+    S_OK - Success.
+
+    N.B. Unlike the 2-part graph implementations, vertex collisions cannot
+         occur here, as each of a key's three vertices lives in a different
+         partition.
+
+--*/
+{
+    KEY Key = 0;
+    EDGE Edge;
+    PEDGE Edges;
+    ULONG Mask;
+    ULONG PartitionSize;
+    HRESULT Result;
+    ULARGE_INTEGER Hash;
+    PVERTEX_TRIPLE Triple;
+    PPERFECT_HASH_TABLE Table;
+    PPERFECT_HASH_TABLE_SEEDED_HASH_EX SeededHashEx;
+
+    DECL_GRAPH_COUNTER_LOCAL_VARS();
+
+    //
+    // Initialize aliases.
+    //
+
+    Table = Graph->Context->Table;
+    Mask = Table->HashMask;
+    PartitionSize = Table->HashModulus;
+    SeededHashEx = SeededHashExRoutines[Table->HashFunctionId];
+    Edges = (PEDGE)Keys;
+
+    ASSERT(Mask == BDZ01_HASH_MASK);
+    ASSERT(PartitionSize * BDZ01_NUMBER_OF_PARTITIONS ==
+           Graph->NumberOfVertices);
+
+    //
+    // Enumerate all keys in the input set, hash them into three vertices, save
+    // the triple (for use by the peeling and assignment steps), then add the
+    // edge to the hypergraph.
+    //
+
+    Result = S_OK;
+    Triple = Graph->VertexTriples;
+
+    START_GRAPH_COUNTER();
+
+    for (Edge = 0; Edge < NumberOfKeys; Edge++) {
+        Key = *Edges++;
+
+        Hash.QuadPart = SeededHashEx(Key, &Graph->FirstSeed, Mask);
+
+        Bdz01HashToVertexTriple(Hash, PartitionSize, Triple);
+
+        GraphAddEdgeBdz01(Graph, Edge, Triple);
+
+        Triple++;
+    }
+
+    STOP_GRAPH_COUNTER(AddKeys);
+
+    EVENT_WRITE_GRAPH(AddKeys);
+
+    return Result;
+}
+
+
+FORCEINLINE
+VOID
+GraphRemoveVertexBdz01(
+    _In_ PGRAPH Graph,
+    _In_ VERTEX VertexIndex
+    )
+/*++
+
+Routine Description:
+
+    If the given vertex has degree 1, removes its sole remaining edge from all
+    three of the edge's vertices, and registers the edge in the deletion order.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph.
+
+    VertexIndex - Supplies the vertex to attempt removal of.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    EDGE Edge;
+    LONG OrderIndex;
+    PVERTEX3 Vertex;
+    PVERTEX_TRIPLE Triple;
+
+    Vertex = &Graph->Vertices3[VertexIndex];
+    if (Vertex->Degree != 1) {
+        return;
+    }
+
+    //
+    // As the vertex has a degree of 1, the XOR'd edges field will contain the
+    // only remaining edge incident to it.
+    //
+
+    Edge = Vertex->Edges;
+    Triple = &Graph->VertexTriples[Edge];
+
+    Vertex = &Graph->Vertices3[Triple->Vertex1];
+    ASSERT(Vertex->Degree >= 1);
+    Vertex->Edges ^= Edge;
+    --Vertex->Degree;
+
+    Vertex = &Graph->Vertices3[Triple->Vertex2];
+    ASSERT(Vertex->Degree >= 1);
+    Vertex->Edges ^= Edge;
+    --Vertex->Degree;
+
+    Vertex = &Graph->Vertices3[Triple->Vertex3];
+    ASSERT(Vertex->Degree >= 1);
+    Vertex->Edges ^= Edge;
+    --Vertex->Degree;
+
+    Graph->DeletedEdgeCount++;
+    ASSERT(Graph->DeletedEdgeCount <= Graph->NumberOfEdges);
+    OrderIndex = --Graph->OrderIndex;
+    ASSERT(OrderIndex >= 0);
+    Graph->Order[OrderIndex] = Edge;
+}
+
+
+GRAPH_IS_ACYCLIC GraphIsAcyclicBdz01;
+
+_Use_decl_annotations_
+HRESULT
+GraphIsAcyclicBdz01(
+    PGRAPH Graph
+    )
+/*++
+
+Routine Description:
+
+    This routine determines whether or not the hypergraph is peelable; that is,
+    whether repeatedly deleting edges incident to vertices of degree 1 results
+    in no edges remaining.  (This is the 3-uniform hypergraph equivalent of the
+    acyclic check performed by the CHM algorithm.)
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph to operate on.
+
+Return Value:
+
+    S_OK - The graph is peelable.
+
+    PH_E_GRAPH_CYCLIC_FAILURE - The graph could not be fully peeled.
+
+--*/
+{
+    LONG Index;
+    ULONG EdgeIndex;
+    VERTEX Vertex;
+    BOOLEAN IsAcyclic;
+    ULONG NumberOfKeys;
+    ULONG NumberOfVertices;
+    ULONG NumberOfEdgesDeleted;
+    PVERTEX_TRIPLE Triple;
+
+    DECL_GRAPH_COUNTER_LOCAL_VARS();
+
+    //
+    // Resolve aliases.
+    //
+
+    NumberOfKeys = Graph->NumberOfKeys;
+    NumberOfVertices = Graph->NumberOfVertices;
+
+    //
+    // Invariant check: we should not be shrinking prior to this point, and our
+    // deleted edge count should be 0.
+    //
+
+    ASSERT(!Graph->Flags.Shrinking);
+    ASSERT(Graph->DeletedEdgeCount == 0);
+
+    Graph->OrderIndex = (LONG)NumberOfKeys;
+
+    //
+    // Toggle the shrinking bit to indicate we've started edge deletion.
+    //
+
+    Graph->Flags.Shrinking = TRUE;
+
+    START_GRAPH_COUNTER();
+
+    //
+    // Enumerate through all vertices in the graph and delete the edges of any
+    // that have degree 1.
+    //
+
+    for (Vertex = 0; Vertex < NumberOfVertices; Vertex++) {
+        GraphRemoveVertexBdz01(Graph, Vertex);
+    }
+
+    //
+    // The Order array is filled from the back; treat the region between the
+    // current order index and the number of keys as a queue of deleted edges
+    // whose vertices need to be revisited (as their degrees will have dropped).
+    //
+
+    for (Index = (LONG)NumberOfKeys;
+         Graph->OrderIndex > 0 && Index > Graph->OrderIndex;
+         NOTHING)
+    {
+        EdgeIndex = Graph->Order[--Index];
+        Triple = &Graph->VertexTriples[EdgeIndex];
+        GraphRemoveVertexBdz01(Graph, Triple->Vertex1);
+        GraphRemoveVertexBdz01(Graph, Triple->Vertex2);
+        GraphRemoveVertexBdz01(Graph, Triple->Vertex3);
+    }
+
+    ASSERT(Graph->OrderIndex >= 0);
+
+    NumberOfEdgesDeleted = Graph->DeletedEdgeCount;
+    IsAcyclic = (NumberOfKeys == NumberOfEdgesDeleted);
+
+    if (IsAcyclic) {
+
+        ASSERT(Graph->OrderIndex == 0);
+        Graph->Flags.IsAcyclic = TRUE;
+
+    } else {
+
+        ULONG HighestDeletedEdges;
+        PPERFECT_HASH_CONTEXT Context;
+
+        ASSERT(Graph->OrderIndex > 0);
+
+        Context = Graph->Info->Context;
+
+        if (NumberOfEdgesDeleted > Context->HighestDeletedEdgesCount) {
+
+            //
+            // Register as the highest deleted edges count if applicable.
+            //
+
+            while (TRUE) {
+
+                HighestDeletedEdges = Context->HighestDeletedEdgesCount;
+
+                if (NumberOfEdgesDeleted <= HighestDeletedEdges) {
+                    break;
+                }
+
+                InterlockedCompareExchange(
+                    (PLONG)&Context->HighestDeletedEdgesCount,
+                    NumberOfEdgesDeleted,
+                    HighestDeletedEdges
+                );
+
+            }
+        }
+    }
+
+    STOP_GRAPH_COUNTER(IsAcyclic);
+
+    EVENT_WRITE_GRAPH_IS_ACYCLIC();
+
+    return (IsAcyclic ? S_OK : PH_E_GRAPH_CYCLIC_FAILURE);
+}
+
+
+GRAPH_ASSIGN GraphAssignBdz01;
+
+_Use_decl_annotations_
+HRESULT
+GraphAssignBdz01(
+    PGRAPH Graph
+    )
+/*++
+
+Routine Description:
+
+    This routine is called after a hypergraph has been successfully peeled.
+    It walks the edges in the reverse order of deletion, and for each edge,
+    assigns a value to the first unvisited vertex such that the sum of the
+    edge's three assigned values, modulo the number of keys, equals the edge.
+
+    N.B. Walking the edges in reverse deletion order guarantees each edge has
+         at least one unvisited vertex: the vertex that had degree 1 when the
+         edge was deleted cannot belong to any edge deleted after it.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph to operate on.
+
+Return Value:
+
+    S_OK.
+
+--*/
+{
+    LONG Order;
+    ULONG Index;
+    VERTEX Free;
+    ULONG NumberOfKeys;
+    ULONGLONG Combined;
+    PASSIGNED Assigned;
+    PVERTEX_TRIPLE Triple;
+
+    DECL_GRAPH_COUNTER_LOCAL_VARS();
+
+    //
+    // Initialize aliases.
+    //
+
+    Assigned = Graph->Assigned;
+    NumberOfKeys = Graph->NumberOfKeys;
+
+    //
+    // Invariant check: we should only be called on graphs that have already
+    // been determined to be acyclic (peelable).
+    //
+
+    ASSERT(Graph->Flags.IsAcyclic);
+
+    EVENT_WRITE_GRAPH_ASSIGN_START();
+
+    START_GRAPH_COUNTER();
+
+    //
+    // The Order array was filled from the back during peeling, so walking it
+    // forward yields the reverse deletion order.
+    //
+
+    for (Index = 0; Index < NumberOfKeys; Index++) {
+
+        Order = Graph->Order[Index];
+        Triple = &Graph->VertexTriples[Order];
+
+        if (!IsVisitedVertex3(Graph, Triple->Vertex1)) {
+            Free = Triple->Vertex1;
+        } else if (!IsVisitedVertex3(Graph, Triple->Vertex2)) {
+            Free = Triple->Vertex2;
+        } else {
+            Free = Triple->Vertex3;
+            ASSERT(!IsVisitedVertex3(Graph, Free));
+        }
+
+        ASSERT(Assigned[Free] == INITIAL_ASSIGNMENT_VALUE);
+
+        //
+        // The free vertex's value is currently zero, so summing all three is
+        // equivalent to summing the other two.  Each value is less than the
+        // number of keys, so adding twice the number of keys to the edge prior
+        // to subtracting ensures we never underflow.
+        //
+
+        Combined = (
+            (ULONGLONG)Assigned[Triple->Vertex1] +
+            (ULONGLONG)Assigned[Triple->Vertex2] +
+            (ULONGLONG)Assigned[Triple->Vertex3]
+        );
+
+        Combined = (
+            (ULONGLONG)Order +
+            ((ULONGLONG)NumberOfKeys << 1) -
+            Combined
+        );
+
+        Assigned[Free] = Bdz01ReduceIndex(Combined, NumberOfKeys);
+
+        //
+        // Set all three vertices as visited.
+        //
+
+        RegisterVertexVisit3(Graph, Triple->Vertex1);
+        RegisterVertexVisit3(Graph, Triple->Vertex2);
+        RegisterVertexVisit3(Graph, Triple->Vertex3);
+    }
+
+    STOP_GRAPH_COUNTER(Assign);
+
+    EVENT_WRITE_GRAPH_ASSIGN_STOP();
+
+    EVENT_WRITE_GRAPH_ASSIGN_RESULT();
+
+    return S_OK;
+}
+
+
+GRAPH_VERIFY GraphVerifyBdz01;
+
+_Use_decl_annotations_
+HRESULT
+GraphVerifyBdz01(
+    PGRAPH Graph
+    )
+/*++
+
+Routine Description:
+
+    Verify a solved Bdz01 hypergraph is working correctly.  This walks through
+    the entire original key set, performs the same index calculation as the
+    Bdz01 Index() routine, and ensures each key maps to a unique index.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph to be verified.
+
+Return Value:
+
+    S_OK - Graph was solved successfully.
+
+    PH_S_GRAPH_VERIFICATION_SKIPPED - The verification step was skipped.
+
+    E_POINTER - Graph was NULL.
+
+    E_OUTOFMEMORY - Out of memory.
+
+    E_UNEXPECTED - Internal error.
+
+    PH_E_COLLISIONS_ENCOUNTERED_DURING_GRAPH_VERIFICATION - Collisions were
+        detected during graph validation.
+
+    PH_E_NUM_ASSIGNMENTS_NOT_EQUAL_TO_NUM_KEYS_DURING_GRAPH_VERIFICATION -
+        The number of value assignments did not equal the number of keys
+        during graph validation.
+
+    PH_E_INDEX_NOT_ORDER_PRESERVING_DURING_GRAPH_VERIFICATION - The table is
+        order preserving, and a key's index did not equal its offset in the
+        keys array.
+
+--*/
+{
+    PRTL Rtl;
+    KEY Key;
+    PKEY Keys;
+    EDGE Edge;
+    ULONG Bit;
+    ULONG Index;
+    BOOLEAN OrderPreserving;
+    ULONG HashMask;
+    ULONG PartitionSize;
+    PULONG Values = NULL;
+    PASSIGNED Assigned;
+    PGRAPH_INFO Info;
+    ULONG NumberOfKeys;
+    ULONG NumberOfAssignments;
+    ULONG Collisions = 0;
+    ULONGLONG Combined;
+    ULARGE_INTEGER Hash;
+    VERTEX_TRIPLE Triple;
+    HRESULT Result = S_OK;
+    PALLOCATOR Allocator;
+    PPERFECT_HASH_TABLE Table;
+    PPERFECT_HASH_CONTEXT Context;
+    PPERFECT_HASH_TABLE_SEEDED_HASH_EX SeededHashEx;
+
+    //
+    // Validate arguments.
+    //
+
+    if (!ARGUMENT_PRESENT(Graph)) {
+        return E_POINTER;
+    }
+
+    if (SkipGraphVerification(Graph)) {
+        return PH_S_GRAPH_VERIFICATION_SKIPPED;
+    }
+
+    //
+    // Initialize aliases.
+    //
+
+    Info = Graph->Info;
+    Context = Info->Context;
+    Rtl = Context->Rtl;
+    Table = Context->Table;
+    OrderPreserving = IsOrderPreserving(Table);
+    HashMask = Table->HashMask;
+    PartitionSize = Table->HashModulus;
+    Allocator = Graph->Allocator;
+    NumberOfKeys = Graph->NumberOfKeys;
+    Keys = (PKEY)Table->Keys->KeyArrayBaseAddress;
+    Assigned = Graph->Assigned;
+    SeededHashEx = SeededHashExRoutines[Table->HashFunctionId];
+
+    //
+    // Sanity check our assigned bitmap is clear.
+    //
+
+    NumberOfAssignments = Rtl->RtlNumberOfSetBits(&Graph->AssignedBitmap);
+    ASSERT(NumberOfAssignments == 0);
+
+    //
+    // Allocate a values array if one is not present.
+    //
+
+    Values = Graph->Values;
+
+    if (!Values) {
+        Values = Graph->Values = (PULONG)(
+            Allocator->Vtbl->Calloc(
+                Allocator,
+                Info->ValuesSizeInBytes,
+                sizeof(*Graph->Values)
+            )
+        );
+    }
+
+    if (!Values) {
+        return E_OUTOFMEMORY;
+    }
+
+    //
+    // Enumerate all keys in the input set and verify they can be resolved
+    // correctly from the assigned vertex array.
+    //
+
+    for (Edge = 0; Edge < NumberOfKeys; Edge++) {
+        Key = Keys[Edge];
+
+        Hash.QuadPart = SeededHashEx(Key, &Graph->FirstSeed, HashMask);
+        Bdz01HashToVertexTriple(Hash, PartitionSize, &Triple);
+
+        Combined = (
+            (ULONGLONG)Assigned[Triple.Vertex1] +
+            (ULONGLONG)Assigned[Triple.Vertex2] +
+            (ULONGLONG)Assigned[Triple.Vertex3]
+        );
+
+        Index = Bdz01ReduceIndex(Combined, NumberOfKeys);
+
+        //
+        // The index should always match the edge (i.e. the key's offset in
+        // the original key set), as that's what the assignment step targets.
+        //
+
+        ASSERT(Index == Edge);
+
+        if (OrderPreserving && Index != Edge) {
+            Result = PH_E_INDEX_NOT_ORDER_PRESERVING_DURING_GRAPH_VERIFICATION;
+            goto Error;
+        }
+
+        Bit = Index;
+
+        if (TestGraphBit(AssignedBitmap, Bit)) {
+            Collisions++;
+        }
+
+        //
+        // Set the bit, store this key in the underlying values array, and
+        // capture its fingerprint if applicable.
+        //
+
+        SetGraphBit(AssignedBitmap, Bit);
+        Values[Index] = Key;
+        PerfectHashTableStoreFingerprint(Table, Index, Key);
+    }
+
+    if (Collisions) {
+        Result = PH_E_COLLISIONS_ENCOUNTERED_DURING_GRAPH_VERIFICATION;
+        goto Error;
+    }
+
+    NumberOfAssignments = Rtl->RtlNumberOfSetBits(&Graph->AssignedBitmap);
+
+    if (NumberOfAssignments != NumberOfKeys) {
+        Result =
+           PH_E_NUM_ASSIGNMENTS_NOT_EQUAL_TO_NUM_KEYS_DURING_GRAPH_VERIFICATION;
+        goto Error;
+    }
+
+    //
+    // We're done, finish up.
+    //
+
+    goto End;
+
+Error:
+
+    if (Result == S_OK) {
+        Result = E_UNEXPECTED;
+    }
+
+    //
+    // Intentional follow-on to End.
+    //
+
+End:
+
+    if (Graph->Values) {
+        Allocator->Vtbl->FreePointer(Allocator, &Graph->Values);
+    }
+
+    return Result;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -0,0 +1,747 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    GraphImplBlock01.c
+
+Abstract:
+
+    This module implements the graph routines used by the Block01 algorithm.
+    It builds on the version 3 graph arrays: the vertex pairs array captures
+    the block and block hash of each edge, the first NumberOfBlocks elements
+    of the VERTEX3 array capture the number of edges in each block and the
+    offset of the block's edges in the Order array, and the Order array
+    captures the edges grouped by block.
+
+    As both of an edge's vertices reside in the same block, the graph is the
+    union of one small graph (fifteen vertices) per block, each of which is
+    solved independently by searching for a block seed that yields an acyclic
+    block graph.  Assignment then proceeds as per the CHM algorithm, except
+    that values are reduced modulo the number of keys rather than masked.
+
+--*/
+
+#include "stdafx.h"
+#include "PerfectHashEventsPrivate.h"
+
+//
+// When a solution has been found and the assignment step begins, the initial
+// value assigned to a vertex is govered by the following macro.
+//
+
+#define INITIAL_ASSIGNMENT_VALUE 0
+
+//
+// Helper macro for obtaining the base of a block within an assigned array.
+//
+
+#define BLOCK01_BLOCK(Assigned, Block) \
+    ((Assigned) + ((ULONGLONG)(Block) << BLOCK01_BLOCK_SHIFT))
+
+
+GRAPH_ADD_KEYS GraphAddKeysBlock01;
+
+_Use_decl_annotations_
+HRESULT
+GraphAddKeysBlock01(
+    PGRAPH Graph,
+    ULONG NumberOfKeys,
+    PKEY Keys
+    )
+/*++
+
+Routine Description:
+
+    Add all keys to the graph.  Each key is hashed using the unique seeds, and
+    the resulting hash is reduced to a block and block hash, which are saved
+    in the vertex pairs array.  The number of keys in each block is tallied
+    in the block's VERTEX3 Degree field.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph for which the keys will be added.
+
+    NumberOfKeys - Supplies the number of keys.
+
+    Keys - Supplies the base address of the keys array.
+
+Return Value:
+
+    S_OK - Success.
+
+    PH_E_GRAPH_VERTEX_COLLISION_FAILURE - A block received more keys than an
+        acyclic block graph can accommodate.  As with a vertex collision, no
+        assignment is possible with the current seeds, regardless of block
+        seeds, so the caller should try again with new seeds.
+
+--*/
+{
+    KEY Key = 0;
+    EDGE Edge;
+    PEDGE Edges;
+    ULONG Mask;
+    ULONG NumberOfBlocks;
+    HRESULT Result;
+    PVERTEX3 Block;
+    ULARGE_INTEGER Hash;
+    PVERTEX_PAIR Pair;
+    PPERFECT_HASH_TABLE Table;
+    PPERFECT_HASH_TABLE_SEEDED_HASH_EX SeededHashEx;
+
+    DECL_GRAPH_COUNTER_LOCAL_VARS();
+
+    //
+    // Initialize aliases.
+    //
+
+    Table = Graph->Context->Table;
+    Mask = Table->HashMask;
+    NumberOfBlocks = Table->HashModulus;
+    SeededHashEx = SeededHashExRoutines[Table->HashFunctionId];
+    Edges = (PEDGE)Keys;
+
+    ASSERT(Mask == BLOCK01_HASH_MASK);
+    ASSERT(((ULONGLONG)NumberOfBlocks << BLOCK01_BLOCK_SHIFT) ==
+           Graph->NumberOfVertices);
+
+    //
+    // Enumerate all keys in the input set, hash them into a block and block
+    // hash, save the pair (for use by the solving and assignment steps), then
+    // increment the block's key count.
+    //
+
+    Result = S_OK;
+    Pair = Graph->VertexPairs;
+
+    START_GRAPH_COUNTER();
+
+    for (Edge = 0; Edge < NumberOfKeys; Edge++) {
+        Key = *Edges++;
+
+        Hash.QuadPart = SeededHashEx(Key, &Graph->FirstSeed, Mask);
+
+        Block01HashToBlock(Hash, NumberOfBlocks, Pair);
+
+        Block = &Graph->Vertices3[Pair->Vertex1];
+        if (++Block->Degree > BLOCK01_MAXIMUM_KEYS_PER_BLOCK) {
+            Result = PH_E_GRAPH_VERTEX_COLLISION_FAILURE;
+            break;
+        }
+
+        Pair++;
+    }
+
+    STOP_GRAPH_COUNTER(AddKeys);
+
+    EVENT_WRITE_GRAPH(AddKeys);
+
+    return Result;
+}
+
+
+FORCEINLINE
+BYTE
+Block01FindRoot(
+    _Inout_updates_(BLOCK01_SLOTS_PER_BLOCK) PBYTE Parent,
+    _In_ BYTE Slot
+    )
+/*++
+
+Routine Description:
+
+    Finds the root of the set containing the given slot in a block's
+    disjoint-set forest, halving the path as it goes.
+
+Arguments:
+
+    Parent - Supplies the parent array of the disjoint-set forest.
+
+    Slot - Supplies the slot for which the root is to be found.
+
+Return Value:
+
+    The root slot.
+
+--*/
+{
+    while (Parent[Slot] != Slot) {
+        Parent[Slot] = Parent[Parent[Slot]];
+        Slot = Parent[Slot];
+    }
+
+    return Slot;
+}
+
+
+FORCEINLINE
+BOOLEAN
+Block01IsAcyclic(
+    _In_ PGRAPH Graph,
+    _In_reads_(NumberOfEdges) PLONG Order,
+    _In_ ULONG NumberOfEdges,
+    _In_ ULONG BlockSeed
+    )
+/*++
+
+Routine Description:
+
+    Determines if a block's graph is acyclic for the given block seed.  Each
+    edge is added to a disjoint-set forest of the block's slots; an edge whose
+    slots already share a root would close a cycle.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph.
+
+    Order - Supplies the base address of the block's edges.
+
+    NumberOfEdges - Supplies the number of edges in the block.
+
+    BlockSeed - Supplies the block seed to test.
+
+Return Value:
+
+    TRUE if the block's graph is acyclic, FALSE otherwise.
+
+--*/
+{
+    BYTE Root1;
+    BYTE Root2;
+    ULONG Index;
+    ULONG Slot1;
+    ULONG Slot2;
+    PVERTEX_PAIR Pair;
+    BYTE Parent[BLOCK01_SLOTS_PER_BLOCK];
+
+    for (Index = 0; Index < BLOCK01_SLOTS_PER_BLOCK; Index++) {
+        Parent[Index] = (BYTE)Index;
+    }
+
+    for (Index = 0; Index < NumberOfEdges; Index++) {
+        Pair = &Graph->VertexPairs[Order[Index]];
+        Block01GetSlots(Pair->Vertex2, BlockSeed, &Slot1, &Slot2);
+
+        Root1 = Block01FindRoot(Parent, (BYTE)Slot1);
+        Root2 = Block01FindRoot(Parent, (BYTE)Slot2);
+
+        if (Root1 == Root2) {
+            return FALSE;
+        }
+
+        Parent[Root1] = Root2;
+    }
+
+    return TRUE;
+}
+
+
+GRAPH_IS_ACYCLIC GraphIsAcyclicBlock01;
+
+_Use_decl_annotations_
+HRESULT
+GraphIsAcyclicBlock01(
+    PGRAPH Graph
+    )
+/*++
+
+Routine Description:
+
+    This routine groups the graph's edges by block (via a counting sort into
+    the Order array), then searches for a block seed that renders each block's
+    graph acyclic.  The block seed is written to the final element of the
+    block in the assigned array.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph to operate on.
+
+Return Value:
+
+    S_OK - Every block's graph is acyclic.
+
+    PH_E_GRAPH_CYCLIC_FAILURE - No acyclic block seed could be found for at
+        least one block within BLOCK01_MAXIMUM_BLOCK_SEED_ATTEMPTS attempts.
+
+--*/
+{
+    EDGE Edge;
+    ULONG Block;
+    ULONG Offset;
+    ULONG BlockSeed;
+    BOOLEAN IsAcyclic;
+    ULONG NumberOfKeys;
+    ULONG NumberOfBlocks;
+    PVERTEX3 Vertex;
+    PVERTEX_PAIR Pair;
+    PASSIGNED Assigned;
+
+    DECL_GRAPH_COUNTER_LOCAL_VARS();
+
+    //
+    // Resolve aliases.
+    //
+
+    NumberOfKeys = Graph->NumberOfKeys;
+    NumberOfBlocks = Graph->NumberOfVertices >> BLOCK01_BLOCK_SHIFT;
+    Assigned = Graph->Assigned;
+
+    START_GRAPH_COUNTER();
+
+    //
+    // Convert each block's key count into the offset of its first edge in the
+    // Order array, then scatter the edges.  The Degree field is reset and used
+    // as the insertion cursor, which restores it to the key count.
+    //
+
+    for (Block = 0, Offset = 0; Block < NumberOfBlocks; Block++) {
+        Vertex = &Graph->Vertices3[Block];
+        Vertex->Edges = Offset;
+        Offset += Vertex->Degree;
+        Vertex->Degree = 0;
+    }
+
+    ASSERT(Offset == NumberOfKeys);
+
+    for (Edge = 0, Pair = Graph->VertexPairs; Edge < NumberOfKeys; Edge++) {
+        Vertex = &Graph->Vertices3[Pair->Vertex1];
+        Graph->Order[Vertex->Edges + Vertex->Degree++] = (LONG)Edge;
+        Pair++;
+    }
+
+    //
+    // Solve each block.  Empty blocks retain a block seed of zero.
+    //
+
+    IsAcyclic = TRUE;
+
+    for (Block = 0; Block < NumberOfBlocks; Block++) {
+        Vertex = &Graph->Vertices3[Block];
+
+        if (Vertex->Degree == 0) {
+            continue;
+        }
+
+        for (BlockSeed = 0;
+             BlockSeed < BLOCK01_MAXIMUM_BLOCK_SEED_ATTEMPTS;
+             BlockSeed++) {
+
+            if (Block01IsAcyclic(Graph,
+                                 &Graph->Order[Vertex->Edges],
+                                 Vertex->Degree,
+                                 BlockSeed)) {
+                break;
+            }
+        }
+
+        if (BlockSeed == BLOCK01_MAXIMUM_BLOCK_SEED_ATTEMPTS) {
+            IsAcyclic = FALSE;
+            break;
+        }
+
+        BLOCK01_BLOCK(Assigned, Block)[BLOCK01_BLOCK_SEED_SLOT] = BlockSeed;
+    }
+
+    if (IsAcyclic) {
+        Graph->Flags.IsAcyclic = TRUE;
+    }
+
+    STOP_GRAPH_COUNTER(IsAcyclic);
+
+    EVENT_WRITE_GRAPH_IS_ACYCLIC();
+
+    return (IsAcyclic ? S_OK : PH_E_GRAPH_CYCLIC_FAILURE);
+}
+
+
+GRAPH_ASSIGN GraphAssignBlock01;
+
+_Use_decl_annotations_
+HRESULT
+GraphAssignBlock01(
+    PGRAPH Graph
+    )
+/*++
+
+Routine Description:
+
+    This routine is called after every block's graph has been determined to be
+    acyclic.  For each block, it repeatedly walks the block's edges, assigning
+    a value to the unvisited slot of any edge with exactly one visited slot,
+    such that the sum of the edge's two assigned values, modulo the number of
+    keys, equals the edge.  When no such edge remains, the first slot of an
+    unprocessed edge is visited (with an initial value of zero), rooting the
+    next tree.  As each block has at most fourteen edges, the quadratic walk
+    is cheaper than constructing adjacency lists.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph to operate on.
+
+Return Value:
+
+    S_OK.
+
+--*/
+{
+    EDGE Edge;
+    ULONG Block;
+    ULONG Index;
+    ULONG Slot1;
+    ULONG Slot2;
+    ULONG From;
+    ULONG To;
+    ULONG Visited;
+    ULONG Processed;
+    ULONG Remaining;
+    ULONG BlockSeed;
+    ULONG NumberOfKeys;
+    ULONG NumberOfBlocks;
+    PLONG Order;
+    PULONG Slots;
+    PVERTEX3 Vertex;
+    PVERTEX_PAIR Pair;
+    PASSIGNED Assigned;
+    BOOLEAN Progress;
+    BYTE Slots1[BLOCK01_MAXIMUM_KEYS_PER_BLOCK];
+    BYTE Slots2[BLOCK01_MAXIMUM_KEYS_PER_BLOCK];
+
+    DECL_GRAPH_COUNTER_LOCAL_VARS();
+
+    //
+    // Initialize aliases.
+    //
+
+    Assigned = Graph->Assigned;
+    NumberOfKeys = Graph->NumberOfKeys;
+    NumberOfBlocks = Graph->NumberOfVertices >> BLOCK01_BLOCK_SHIFT;
+
+    //
+    // Invariant check: we should only be called on graphs that have already
+    // been determined to be acyclic.
+    //
+
+    ASSERT(Graph->Flags.IsAcyclic);
+
+    EVENT_WRITE_GRAPH_ASSIGN_START();
+
+    START_GRAPH_COUNTER();
+
+    for (Block = 0; Block < NumberOfBlocks; Block++) {
+        Vertex = &Graph->Vertices3[Block];
+        Remaining = Vertex->Degree;
+
+        if (Remaining == 0) {
+            continue;
+        }
+
+        ASSERT(Remaining <= BLOCK01_MAXIMUM_KEYS_PER_BLOCK);
+
+        Slots = BLOCK01_BLOCK(Assigned, Block);
+        BlockSeed = Slots[BLOCK01_BLOCK_SEED_SLOT];
+        Order = &Graph->Order[Vertex->Edges];
+
+        //
+        // Capture the slots of each of the block's edges.
+        //
+
+        for (Index = 0; Index < Remaining; Index++) {
+            Pair = &Graph->VertexPairs[Order[Index]];
+            Block01GetSlots(Pair->Vertex2, BlockSeed, &Slot1, &Slot2);
+            Slots1[Index] = (BYTE)Slot1;
+            Slots2[Index] = (BYTE)Slot2;
+        }
+
+        //
+        // Visited and Processed are bitmaps of slots and edges, respectively.
+        //
+
+        Visited = 0;
+        Processed = 0;
+
+        while (Remaining > 0) {
+
+            Progress = FALSE;
+
+            for (Index = 0; Index < Vertex->Degree; Index++) {
+
+                if (Processed & (1 << Index)) {
+                    continue;
+                }
+
+                Slot1 = Slots1[Index];
+                Slot2 = Slots2[Index];
+
+                if (Visited & (1 << Slot1)) {
+                    From = Slot1;
+                    To = Slot2;
+                } else if (Visited & (1 << Slot2)) {
+                    From = Slot2;
+                    To = Slot1;
+                } else {
+                    continue;
+                }
+
+                //
+                // The block graph is acyclic, so the other slot can't have
+                // been visited yet.
+                //
+
+                ASSERT(!(Visited & (1 << To)));
+                ASSERT(Slots[To] == INITIAL_ASSIGNMENT_VALUE);
+
+                Edge = (EDGE)Order[Index];
+
+                Slots[To] = Block01ReduceIndex(
+                    (ULONGLONG)Edge + (ULONGLONG)NumberOfKeys -
+                    (ULONGLONG)Slots[From],
+                    NumberOfKeys
+                );
+
+                Visited |= (1 << To);
+                Processed |= (1 << Index);
+                Remaining--;
+                Progress = TRUE;
+            }
+
+            if (!Progress) {
+
+                //
+                // Every remaining edge belongs to a tree that hasn't been
+                // visited yet; root the next one at the first slot of the
+                // first unprocessed edge.
+                //
+
+                for (Index = 0; Processed & (1 << Index); Index++) {
+                    NOTHING;
+                }
+
+                Visited |= (1 << Slots1[Index]);
+            }
+        }
+    }
+
+    STOP_GRAPH_COUNTER(Assign);
+
+    EVENT_WRITE_GRAPH_ASSIGN_STOP();
+
+    EVENT_WRITE_GRAPH_ASSIGN_RESULT();
+
+    return S_OK;
+}
+
+
+GRAPH_VERIFY GraphVerifyBlock01;
+
+_Use_decl_annotations_
+HRESULT
+GraphVerifyBlock01(
+    PGRAPH Graph
+    )
+/*++
+
+Routine Description:
+
+    Verify a solved Block01 graph is working correctly.  This walks through
+    the entire original key set, performs the same index calculation as the
+    Block01 Index() routine, and ensures each key maps to a unique index.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph to be verified.
+
+Return Value:
+
+    S_OK - Graph was solved successfully.
+
+    PH_S_GRAPH_VERIFICATION_SKIPPED - The verification step was skipped.
+
+    E_POINTER - Graph was NULL.
+
+    E_OUTOFMEMORY - Out of memory.
+
+    E_UNEXPECTED - Internal error.
+
+    PH_E_COLLISIONS_ENCOUNTERED_DURING_GRAPH_VERIFICATION - Collisions were
+        detected during graph validation.
+
+    PH_E_NUM_ASSIGNMENTS_NOT_EQUAL_TO_NUM_KEYS_DURING_GRAPH_VERIFICATION -
+        The number of value assignments did not equal the number of keys
+        during graph validation.
+
+    PH_E_INDEX_NOT_ORDER_PRESERVING_DURING_GRAPH_VERIFICATION - The table is
+        order preserving, and a key's index did not equal its offset in the
+        keys array.
+
+--*/
+{
+    PRTL Rtl;
+    KEY Key;
+    PKEY Keys;
+    EDGE Edge;
+    ULONG Bit;
+    ULONG Index;
+    BOOLEAN OrderPreserving;
+    ULONG HashMask;
+    ULONG NumberOfBlocks;
+    PULONG Values = NULL;
+    PASSIGNED Assigned;
+    PGRAPH_INFO Info;
+    ULONG NumberOfKeys;
+    ULONG NumberOfAssignments;
+    ULONG Collisions = 0;
+    ULONGLONG CacheLines;
+    ULARGE_INTEGER Hash;
+    HRESULT Result = S_OK;
+    PALLOCATOR Allocator;
+    PPERFECT_HASH_TABLE Table;
+    PPERFECT_HASH_CONTEXT Context;
+    PPERFECT_HASH_TABLE_SEEDED_HASH_EX SeededHashEx;
+
+    //
+    // Validate arguments.
+    //
+
+    if (!ARGUMENT_PRESENT(Graph)) {
+        return E_POINTER;
+    }
+
+    if (SkipGraphVerification(Graph)) {
+        return PH_S_GRAPH_VERIFICATION_SKIPPED;
+    }
+
+    //
+    // Initialize aliases.
+    //
+
+    Info = Graph->Info;
+    Context = Info->Context;
+    Rtl = Context->Rtl;
+    Table = Context->Table;
+    OrderPreserving = IsOrderPreserving(Table);
+    HashMask = Table->HashMask;
+    NumberOfBlocks = Table->HashModulus;
+    Allocator = Graph->Allocator;
+    NumberOfKeys = Graph->NumberOfKeys;
+    Keys = (PKEY)Table->Keys->KeyArrayBaseAddress;
+    Assigned = Graph->Assigned;
+    SeededHashEx = SeededHashExRoutines[Table->HashFunctionId];
+
+    //
+    // Sanity check our assigned bitmap is clear.
+    //
+
+    NumberOfAssignments = Rtl->RtlNumberOfSetBits(&Graph->AssignedBitmap);
+    ASSERT(NumberOfAssignments == 0);
+
+    //
+    // Allocate a values array if one is not present.
+    //
+
+    Values = Graph->Values;
+
+    if (!Values) {
+        Values = Graph->Values = (PULONG)(
+            Allocator->Vtbl->Calloc(
+                Allocator,
+                Info->ValuesSizeInBytes,
+                sizeof(*Graph->Values)
+            )
+        );
+    }
+
+    if (!Values) {
+        return E_OUTOFMEMORY;
+    }
+
+    //
+    // Enumerate all keys in the input set and verify they can be resolved
+    // correctly from the assigned vertex array.
+    //
+
+    CacheLines = 0;
+
+    for (Edge = 0; Edge < NumberOfKeys; Edge++) {
+        Key = Keys[Edge];
+
+        Hash.QuadPart = SeededHashEx(Key, &Graph->FirstSeed, HashMask);
+
+        Index = Block01IndexHash(Hash, Assigned, NumberOfBlocks, NumberOfKeys);
+
+        //
+        // Each lookup touches the key's block (a single cache line, as the
+        // table data is cache line aligned), plus the value.
+        //
+
+        CacheLines += 2;
+
+        //
+        // The index should always match the edge (i.e. the key's offset in
+        // the original key set), as that's what the assignment step targets.
+        //
+
+        ASSERT(Index == Edge);
+
+        if (OrderPreserving && Index != Edge) {
+            Result = PH_E_INDEX_NOT_ORDER_PRESERVING_DURING_GRAPH_VERIFICATION;
+            goto Error;
+        }
+
+        Bit = Index;
+
+        if (TestGraphBit(AssignedBitmap, Bit)) {
+            Collisions++;
+        }
+
+        //
+        // Set the bit, store this key in the underlying values array, and
+        // capture its fingerprint if applicable.
+        //
+
+        SetGraphBit(AssignedBitmap, Bit);
+        Values[Index] = Key;
+        PerfectHashTableStoreFingerprint(Table, Index, Key);
+    }
+
+    if (Collisions) {
+        Result = PH_E_COLLISIONS_ENCOUNTERED_DURING_GRAPH_VERIFICATION;
+        goto Error;
+    }
+
+    NumberOfAssignments = Rtl->RtlNumberOfSetBits(&Graph->AssignedBitmap);
+
+    if (NumberOfAssignments != NumberOfKeys) {
+        Result =
+           PH_E_NUM_ASSIGNMENTS_NOT_EQUAL_TO_NUM_KEYS_DURING_GRAPH_VERIFICATION;
+        goto Error;
+    }
+
+    Table->CacheLinesPerLookup = (DOUBLE)CacheLines / (DOUBLE)NumberOfKeys;
+
+    //
+    // We're done, finish up.
+    //
+
+    goto End;
+
+Error:
+
+    if (Result == S_OK) {
+        Result = E_UNEXPECTED;
+    }
+
+    //
+    // Intentional follow-on to End.
+    //
+
+End:
+
+    if (Graph->Values) {
+        Allocator->Vtbl->FreePointer(Allocator, &Graph->Values);
+    }
+
+    return Result;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
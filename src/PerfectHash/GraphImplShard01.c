@@ -0,0 +1,425 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    GraphImplShard01.c
+
+Abstract:
+
+    This module implements the graph solving and verification routines for
+    the Shard01 algorithm.  Each graph claims shards from the table until none
+    remain, solving each one with the standard version 3 graph routines
+    (AddKeys, IsAcyclic and Assign) against the shard's keys, and copying the
+    resulting assigned array and seeds into the table's shard state.
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Forward decls.
+//
+
+_Must_inspect_result_
+_Success_(return >= 0)
+_Requires_exclusive_lock_held_(Graph->Lock)
+HRESULT
+GraphSolveShard(
+    _In_ PGRAPH Graph,
+    _In_ ULONG NumberOfKeys,
+    _In_reads_(NumberOfKeys) PKEY Keys
+    );
+
+
+GRAPH_SOLVE_SHARDS GraphSolveShardsShard01;
+
+_Use_decl_annotations_
+HRESULT
+GraphSolveShardsShard01(
+    PGRAPH Graph
+    )
+/*++
+
+Routine Description:
+
+    Claims and solves shards until none remain, or solving is stopped.  The
+    graph that solves the final shard pushes itself onto the finished list
+    and submits the finished threadpool work item, mirroring the "first solved
+    graph wins" logic in GraphSolve().
+
+    N.B. This routine is called by GraphEnterSolvingLoop() in lieu of the
+         normal solving loop when the table is using the Shard01 algorithm.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph to be used for solving.
+
+Return Value:
+
+    PH_S_STOP_GRAPH_SOLVING - All shards were solved.
+
+    PH_S_GRAPH_SOLVING_STOPPED - Graph solving has been stopped, or there are
+        no more shards to claim.
+
+    PH_S_TABLE_RESIZE_IMMINENT - A shard exceeded the resize threshold.
+
+    Otherwise, an appropriate error code.
+
+--*/
+{
+    PRTL Rtl;
+    PKEY Keys;
+    ULONG Shard;
+    ULONG NumberOfShards;
+    HRESULT Result;
+    PASSIGNED Assigned;
+    PPERFECT_HASH_TABLE Table;
+    PPERFECT_HASH_CONTEXT Context;
+    PSHARD01_DIRECTORY_ENTRY Entry;
+
+    //
+    // Initialize aliases.
+    //
+
+    Rtl = Graph->Rtl;
+    Context = Graph->Context;
+    Table = Context->Table;
+    NumberOfShards = Table->NumberOfShards;
+
+    Result = PH_S_GRAPH_SOLVING_STOPPED;
+
+    while (Graph->Vtbl->ShouldWeContinueTryingToSolve(Graph)) {
+
+        //
+        // Claim the next shard.
+        //
+
+        Shard = (ULONG)InterlockedIncrement(&Table->NextShard) - 1;
+        if (Shard >= NumberOfShards) {
+            Result = PH_S_GRAPH_SOLVING_STOPPED;
+            break;
+        }
+
+        Entry = &Table->Shards[Shard];
+        Keys = (PKEY)Table->ShardedKeys + Entry->KeyOffset;
+
+        Graph->ShardIndex = Shard;
+        Graph->ShardAttempt = 0;
+        Graph->NumberOfKeys = Entry->NumberOfKeys;
+
+        //
+        // Any seed sets hashed thus far were hashed against the previous
+        // shard's keys; force a new batch to be generated.
+        //
+
+        if (IsMultiSeedGraph(Graph)) {
+            Graph->Flags.SeedSetsHashed = FALSE;
+            Graph->SeedSetIndex = Graph->NumberOfSeedSets;
+        }
+
+        if (Entry->NumberOfKeys == 0) {
+
+            //
+            // Empty shards don't need solving; their assigned values remain
+            // zero.  Load seeds anyway such that the directory entry is
+            // populated with valid values.
+            //
+
+            Result = Graph->Vtbl->LoadNewSeeds(Graph);
+            if (FAILED(Result)) {
+                PH_ERROR(GraphSolveShardsShard01_LoadNewSeeds, Result);
+                break;
+            }
+
+        } else {
+
+            Result = GraphSolveShard(Graph, Entry->NumberOfKeys, Keys);
+            if (Result != S_OK) {
+                break;
+            }
+
+            //
+            // Copy the solved assigned array into the shard's slot.
+            //
+
+            Assigned = Table->ShardAssigned + (
+                (SIZE_T)Shard * (SIZE_T)Graph->NumberOfVertices
+            );
+
+            CopyMemory(Assigned,
+                       Graph->Assigned,
+                       Graph->NumberOfVertices * sizeof(*Assigned));
+        }
+
+        CopyMemory(Entry->Seeds,
+                   &Graph->FirstSeed,
+                   Graph->NumberOfSeeds * sizeof(Graph->FirstSeed));
+
+        //
+        // If this was the last shard to be solved, we're the "winning" graph.
+        //
+
+        if (InterlockedDecrement(&Table->NumberOfShardsRemaining) == 0) {
+            Graph->SolutionNumber = InterlockedIncrement64(
+                &Context->FinishedCount
+            );
+            ASSERT(Graph->SolutionNumber == 1);
+            CONTEXT_END_TIMERS(Solve);
+            SetStopSolving(Context);
+            InsertHeadFinishedWork(Context, &Graph->ListEntry);
+            SubmitThreadpoolWork(Context->FinishedWork);
+            Result = PH_S_STOP_GRAPH_SOLVING;
+            break;
+        }
+    }
+
+    return Result;
+}
+
+
+_Use_decl_annotations_
+HRESULT
+GraphSolveShard(
+    PGRAPH Graph,
+    ULONG NumberOfKeys,
+    PKEY Keys
+    )
+/*++
+
+Routine Description:
+
+    Attempts to solve a single shard's graph, trying new seeds until either
+    the graph is solved, solving is stopped, or the shard exceeds the resize
+    threshold.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph to be used for solving.
+
+    NumberOfKeys - Supplies the number of keys in the shard.
+
+    Keys - Supplies the base address of the shard's keys.
+
+Return Value:
+
+    S_OK - The shard was solved; Graph->Assigned contains the solution.
+
+    Otherwise, the status code (success or failure) that should be returned
+    from the solving loop.
+
+--*/
+{
+    HRESULT Result;
+    PPERFECT_HASH_CONTEXT Context;
+
+    Context = Graph->Context;
+
+    while (TRUE) {
+
+        MAYBE_STOP_GRAPH_SOLVING(Graph);
+
+        Result = Graph->Vtbl->LoadNewSeeds(Graph);
+        if (FAILED(Result)) {
+            PH_ERROR(GraphLoadNewSeeds, Result);
+            return Result;
+        }
+
+        Result = Graph->Vtbl->Reset(Graph);
+        if (FAILED(Result)) {
+            PH_ERROR(GraphReset, Result);
+            return Result;
+        } else if (Result != PH_S_CONTINUE_GRAPH_SOLVING) {
+            return Result;
+        }
+
+        Result = Graph->Vtbl->AddKeys(Graph, NumberOfKeys, Keys);
+
+        if (FAILED(Result)) {
+
+            if (Result == PH_E_GRAPH_VERTEX_COLLISION_FAILURE) {
+                InterlockedIncrement64(&Context->VertexCollisionFailures);
+                InterlockedIncrement64(&Context->FailedAttempts);
+                continue;
+            }
+
+            PH_ERROR(GraphSolveShard_AddKeys, Result);
+            return PH_S_STOP_GRAPH_SOLVING;
+        }
+
+        MAYBE_STOP_GRAPH_SOLVING(Graph);
+
+        Result = Graph->Vtbl->IsAcyclic(Graph);
+        if (FAILED(Result)) {
+            InterlockedIncrement64(&Context->CyclicGraphFailures);
+            InterlockedIncrement64(&Context->FailedAttempts);
+            continue;
+        }
+
+        //
+        // The shard's graph is acyclic; perform the assignment step.  As with
+        // GraphSolve(), this should always succeed.
+        //
+
+        Result = Graph->Vtbl->Assign(Graph);
+        if (FAILED(Result)) {
+            PH_RAISE(Result);
+        }
+
+        return S_OK;
+    }
+}
+
+
+GRAPH_VERIFY GraphVerifyShard01;
+
+_Use_decl_annotations_
+HRESULT
+GraphVerifyShard01(
+    PGRAPH Graph
+    )
+/*++
+
+Routine Description:
+
+    Verify a solved Shard01 table is working correctly.  This walks through
+    the entire original key set, performs the same index calculation as the
+    Shard01 Index() routine (against the shard directory and assigned arrays
+    captured during solving), and ensures each key maps to a unique index
+    less than the number of keys.
+
+Arguments:
+
+    Graph - Supplies a pointer to the graph that solved the final shard.
+
+Return Value:
+
+    S_OK - All shards were solved successfully.
+
+    PH_S_GRAPH_VERIFICATION_SKIPPED - The verification step was skipped.
+
+    E_POINTER - Graph was NULL.
+
+    E_OUTOFMEMORY - Out of memory.
+
+    E_UNEXPECTED - Internal error.
+
+    PH_E_COLLISIONS_ENCOUNTERED_DURING_GRAPH_VERIFICATION - Collisions were
+        detected during graph validation.
+
+    PH_E_NUM_ASSIGNMENTS_NOT_EQUAL_TO_NUM_KEYS_DURING_GRAPH_VERIFICATION -
+        The number of value assignments did not equal the number of keys
+        during graph validation.
+
+--*/
+{
+    KEY Key;
+    PKEY Keys;
+    EDGE Edge;
+    ULONG Index;
+    ULONG NumberOfKeys;
+    ULONG NumberOfAssignments;
+    ULONG Collisions = 0;
+    PLONGLONG Bitmap;
+    HRESULT Result = S_OK;
+    PALLOCATOR Allocator;
+    PPERFECT_HASH_TABLE Table;
+
+    //
+    // Validate arguments.
+    //
+
+    if (!ARGUMENT_PRESENT(Graph)) {
+        return E_POINTER;
+    }
+
+    if (SkipGraphVerification(Graph)) {
+        return PH_S_GRAPH_VERIFICATION_SKIPPED;
+    }
+
+    //
+    // Initialize aliases.
+    //
+
+    Table = Graph->Context->Table;
+    Allocator = Graph->Allocator;
+    NumberOfKeys = Table->Keys->NumberOfElements.LowPart;
+    Keys = (PKEY)Table->Keys->KeyArrayBaseAddress;
+
+    //
+    // The graph's assigned bitmap is sized for a single shard; allocate one
+    // large enough to track every index.
+    //
+
+    Bitmap = (PLONGLONG)(
+        Allocator->Vtbl->Calloc(
+            Allocator,
+            ((SIZE_T)NumberOfKeys + 63) >> 6,
+            sizeof(*Bitmap)
+        )
+    );
+
+    if (!Bitmap) {
+        return E_OUTOFMEMORY;
+    }
+
+    //
+    // Enumerate all keys in the input set and verify they resolve to unique
+    // indices.
+    //
+
+    NumberOfAssignments = 0;
+
+    for (Edge = 0; Edge < NumberOfKeys; Edge++) {
+        Key = Keys[Edge];
+
+        Index = Shard01IndexKey(Table,
+                                Table->Shards,
+                                Table->ShardAssigned,
+                                Key);
+
+        if (Index >= NumberOfKeys ||
+            BitTestAndSet64(Bitmap, (LONGLONG)Index)) {
+            Collisions++;
+        } else {
+            NumberOfAssignments++;
+            PerfectHashTableStoreFingerprint(Table, Index, Key);
+        }
+    }
+
+    if (Collisions) {
+        Result = PH_E_COLLISIONS_ENCOUNTERED_DURING_GRAPH_VERIFICATION;
+        goto Error;
+    }
+
+    if (NumberOfAssignments != NumberOfKeys) {
+        Result =
+           PH_E_NUM_ASSIGNMENTS_NOT_EQUAL_TO_NUM_KEYS_DURING_GRAPH_VERIFICATION;
+        goto Error;
+    }
+
+    //
+    // We're done, finish up.
+    //
+
+    goto End;
+
+Error:
+
+    if (Result == S_OK) {
+        Result = E_UNEXPECTED;
+    }
+
+    //
+    // Intentional follow-on to End.
+    //
+
+End:
+
+    Allocator->Vtbl->FreePointer(Allocator, (PVOID *)&Bitmap);
+
+    return Result;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -0,0 +1,170 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    KeyDownsizing.h
+
+Abstract:
+
+    This module implements helper routines for downsizing 64-bit keys to
+    32-bit keys without _pext_u64().
+
+    Key downsizing extracts the bits of each key that are set in the downsize
+    bitmap (i.e. the bit positions that vary across the key set), and packs
+    them into the low bits of the result.  _pext_u64() does this in a single
+    instruction, however, it is microcoded on AMD parts prior to Zen 3 (where
+    it takes tens to hundreds of cycles, depending on the mask), and it isn't
+    available at all on non-x86 platforms.
+
+    The set bits of the downsize bitmap are made up of one or more runs of
+    contiguous bits.  Each run can be extracted with a single right shift and
+    mask, so the extraction can be performed equivalently by OR'ing together
+    one shift-and-mask per run.  Typical key sets have a handful of runs; a
+    single run collapses to one shift and one mask.
+
+    N.B. The compiled perfect hash tables emit the identical sequence of
+         shifts and masks for the table's downsize bitmap; see
+         PrepareCHeaderFileChm01() in Chm01FileWorkCHeaderFile.c.
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Define the key downsize run constraints.  A downsize bitmap has at most 32
+// bits set, and thus at most 32 runs.  Compiled tables use the shift-and-mask
+// sequence unconditionally for bitmaps with no more than the maximum number
+// of inline runs (where it's at least as fast as a native _pext_u64()), or if
+// the CPU the table was created on lacked a fast _pext_u64().  Otherwise, it
+// is only used on non-x86 platforms, or if CPH_AVOID_PEXT is defined.
+//
+
+#define KEY_DOWNSIZE_MAXIMUM_RUNS 32
+#define KEY_DOWNSIZE_MAXIMUM_INLINE_RUNS 4
+
+typedef struct _KEY_DOWNSIZE_RUN {
+
+    //
+    // Mask to apply to the key after it has been shifted right by Shift bits.
+    //
+
+    ULONGLONG Mask;
+
+    //
+    // Number of bits to shift the key right by.
+    //
+
+    ULONG Shift;
+
+    ULONG Padding;
+
+} KEY_DOWNSIZE_RUN;
+typedef KEY_DOWNSIZE_RUN *PKEY_DOWNSIZE_RUN;
+
+typedef struct _KEY_DOWNSIZE_RUNS {
+    ULONG NumberOfRuns;
+    ULONG Padding;
+    KEY_DOWNSIZE_RUN Runs[KEY_DOWNSIZE_MAXIMUM_RUNS];
+} KEY_DOWNSIZE_RUNS;
+typedef KEY_DOWNSIZE_RUNS *PKEY_DOWNSIZE_RUNS;
+
+FORCEINLINE
+VOID
+GetKeyDownsizeRuns(
+    _In_ PRTL Rtl,
+    _In_ ULONGLONG Bitmap,
+    _Out_ PKEY_DOWNSIZE_RUNS Runs
+    )
+/*++
+
+Routine Description:
+
+    Decomposes a downsize bitmap into its runs of contiguous set bits, and
+    computes the shift and mask that extracts each run into its position in
+    the downsized key.
+
+Arguments:
+
+    Rtl - Supplies a pointer to an Rtl instance.
+
+    Bitmap - Supplies the downsize bitmap.  At most 32 bits may be set.
+
+    Runs - Receives the runs.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ULONG Start;
+    ULONG Length;
+    ULONG Offset;
+    ULONGLONG Mask;
+    PKEY_DOWNSIZE_RUN Run;
+
+    ASSERT(Rtl->PopulationCount64(Bitmap) <= 32);
+
+    Offset = 0;
+    Runs->NumberOfRuns = 0;
+    Run = Runs->Runs;
+
+    while (Bitmap) {
+        Start = (ULONG)Rtl->TrailingZeros64(Bitmap);
+        Length = (ULONG)Rtl->TrailingZeros64(~(Bitmap >> Start));
+        Mask = (1ULL << Length) - 1;
+
+        Run->Shift = Start - Offset;
+        Run->Mask = Mask << Offset;
+        Run->Padding = 0;
+
+        Bitmap &= ~(Mask << Start);
+        Offset += Length;
+        Runs->NumberOfRuns++;
+        Run++;
+    }
+}
+
+FORCEINLINE
+ULONG
+DownsizeKey(
+    _In_ ULONGLONG Key,
+    _In_ PKEY_DOWNSIZE_RUNS Runs
+    )
+/*++
+
+Routine Description:
+
+    Downsizes a 64-bit key via the shift-and-mask sequence for a downsize
+    bitmap.  This is equivalent to _pext_u64(Key, Bitmap).
+
+Arguments:
+
+    Key - Supplies the key to downsize.
+
+    Runs - Supplies the runs obtained from GetKeyDownsizeRuns() for the
+        downsize bitmap.
+
+Return Value:
+
+    The downsized key.
+
+--*/
+{
+    ULONG Index;
+    ULONGLONG Result;
+    PKEY_DOWNSIZE_RUN Run;
+
+    Result = 0;
+    Run = Runs->Runs;
+
+    for (Index = 0; Index < Runs->NumberOfRuns; Index++, Run++) {
+        Result |= (Key >> Run->Shift) & Run->Mask;
+    }
+
+    return (ULONG)Result;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
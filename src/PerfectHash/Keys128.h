@@ -0,0 +1,107 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    Keys128.h
+
+Abstract:
+
+    This module implements helper routines for 128-bit keys (i.e. keys loaded
+    from a keys file with a key size of 16 bytes, such as UUIDs or GUIDs).
+
+    A 128-bit keys file is an array of 16-byte keys, each stored as two
+    little-endian ULONGLONGs: the low 64 bits followed by the high 64 bits.
+    The keys must be sorted (by high, then low) and unique.
+
+    Each key is reduced to a unique 32-bit key when the keys are loaded; see
+    ReducedKeys.h for details.  A 128-bit key is reduced identically to a
+    16-byte string key: the low and high halves are the two lanes.
+
+    N.B. This is a capped reduced-key mode, not native 128-bit support: the
+         table is created from, and its library routines (e.g. Index()) take,
+         the reduced 32-bit keys, and key sets larger than
+         REDUCED_KEY_MAXIMUM_NUMBER_OF_KEYS are rejected, as the odds of no
+         seed yielding unique reduced keys become significant beyond it.
+
+    N.B. The compiled perfect hash tables use the identical reduction; see
+         CphHashKey128() in ../../include/CompiledPerfectHash.h.
+
+--*/
+
+#include "stdafx.h"
+
+FORCEINLINE
+ULONG
+HashKey128(
+    _In_ PKEY128 Key,
+    _In_ ULONG Seed
+    )
+/*++
+
+Routine Description:
+
+    Reduces a 128-bit key to a 32-bit key.
+
+Arguments:
+
+    Key - Supplies a pointer to the 128-bit key.
+
+    Seed - Supplies the reduced key seed.
+
+Return Value:
+
+    The 32-bit key.
+
+--*/
+{
+    ULONG Hash1;
+    ULONG Hash2;
+    ULONGLONG Multiplier;
+
+    Multiplier = GetReducedKeyLaneMultiplier(Seed);
+
+    Hash1 = (ULONG)_mm_crc32_u64(Seed, Key->Low * Multiplier);
+    Hash2 = (ULONG)_mm_crc32_u64(sizeof(*Key), Key->High * Multiplier);
+
+    return _mm_crc32_u32(Hash1, Hash2);
+}
+
+FORCEINLINE
+LONG
+CompareKey128(
+    _In_ PKEY128 Left,
+    _In_ PKEY128 Right
+    )
+/*++
+
+Routine Description:
+
+    Compares two 128-bit keys as unsigned 128-bit integers.
+
+Arguments:
+
+    Left - Supplies a pointer to the first key.
+
+    Right - Supplies a pointer to the second key.
+
+Return Value:
+
+    A negative value if Left is less than Right, 0 if they're equal, and a
+    positive value if Left is greater than Right.
+
+--*/
+{
+    if (Left->High != Right->High) {
+        return (Left->High < Right->High ? -1 : 1);
+    }
+
+    if (Left->Low != Right->Low) {
+        return (Left->Low < Right->Low ? -1 : 1);
+    }
+
+    return 0;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
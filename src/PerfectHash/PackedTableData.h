@@ -0,0 +1,288 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    PackedTableData.h
+
+Abstract:
+
+    This module implements helper routines for the packed table data layout
+    (i.e. --TableDataLayout=Packed).
+
+    Chm01 table data elements (assigned values) always lie between 0 and the
+    number of edges minus 1, and with And masking, the number of edges is a
+    power of two.  Thus, each element can be stored in exactly as many bits as
+    there are in the edge mask, rather than the smallest containing C type.
+    For example, a table with 2^17 edges stores 17-bit elements instead of
+    32-bit ULONGs, shrinking the table data by ~47%.
+
+    The packed table data is a little-endian bit stream: element N occupies
+    bits [N * Bits, (N + 1) * Bits), where bit 0 is the least significant bit
+    of the first byte.  The stream is rounded up to a multiple of ULONGLONGs,
+    and is followed by one additional ULONGLONG of padding.  An element is at
+    most 32 bits wide, so an element can always be extracted by a single
+    unaligned 64-bit load at the byte containing its first bit, followed by a
+    right shift of between 0 and 7 bits and a mask.  The padding guarantees the
+    load never extends beyond the end of the table data.
+
+    N.B. The compiled perfect hash tables use the identical layout (emitted as
+         an array of ULONGLONGs) and extraction logic; see CphUnpackTableData()
+         in ../../include/CompiledPerfectHash.h.
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Define the packed table data constraints.
+//
+
+#define PACKED_TABLE_DATA_MINIMUM_BITS_PER_ELEMENT 1
+#define PACKED_TABLE_DATA_MAXIMUM_BITS_PER_ELEMENT 32
+#define PACKED_TABLE_DATA_BITS_PER_WORD 64
+#define PACKED_TABLE_DATA_PADDING_IN_BYTES sizeof(ULONGLONG)
+
+FORCEINLINE
+BOOLEAN
+IsValidPackedTableDataBitsPerElement(
+    _In_ ULONG BitsPerElement
+    )
+{
+    return (
+        BitsPerElement >= PACKED_TABLE_DATA_MINIMUM_BITS_PER_ELEMENT &&
+        BitsPerElement <= PACKED_TABLE_DATA_MAXIMUM_BITS_PER_ELEMENT
+    );
+}
+
+FORCEINLINE
+ULONGLONG
+GetPackedTableDataSizeInBytes(
+    _In_ ULONGLONG NumberOfElements,
+    _In_ ULONG BitsPerElement
+    )
+/*++
+
+Routine Description:
+
+    Returns the number of bytes required to store the given number of elements
+    in a packed table data array, including trailing padding.  The result is
+    always a multiple of sizeof(ULONGLONG).
+
+Arguments:
+
+    NumberOfElements - Supplies the number of table data elements.
+
+    BitsPerElement - Supplies the number of bits per element.
+
+Return Value:
+
+    Packed table data size, in bytes.
+
+--*/
+{
+    ULONGLONG NumberOfBits;
+
+    NumberOfBits = NumberOfElements * BitsPerElement;
+
+    return (
+        (ALIGN_UP(NumberOfBits, PACKED_TABLE_DATA_BITS_PER_WORD) >> 3) +
+        PACKED_TABLE_DATA_PADDING_IN_BYTES
+    );
+}
+
+FORCEINLINE
+ULONGLONG
+GetTableDataSizeInBytes(
+    _In_ PTABLE_INFO_ON_DISK TableInfoOnDisk
+    )
+/*++
+
+Routine Description:
+
+    Returns the size of a table's table data, in bytes, accounting for the
+    packed table data layout.
+
+Arguments:
+
+    TableInfoOnDisk - Supplies a pointer to the table's on-disk info.
+
+Return Value:
+
+    Table data size, in bytes.
+
+--*/
+{
+    if (TableInfoOnDisk->Flags.PackedTableData) {
+        return GetPackedTableDataSizeInBytes(
+            TableInfoOnDisk->NumberOfTableElements.QuadPart,
+            TableInfoOnDisk->TableDataBitsPerElement
+        );
+    }
+
+    return (
+        TableInfoOnDisk->NumberOfTableElements.QuadPart *
+        TableInfoOnDisk->KeySizeInBytes
+    );
+}
+
+FORCEINLINE
+ULONG
+GetPackedTableDataElement(
+    _In_ PVOID TableData,
+    _In_ ULONGLONG Index,
+    _In_ ULONG BitsPerElement
+    )
+/*++
+
+Routine Description:
+
+    Extracts an element from packed table data.
+
+Arguments:
+
+    TableData - Supplies the base address of the packed table data.
+
+    Index - Supplies the index of the element to extract.
+
+    BitsPerElement - Supplies the number of bits per element.
+
+Return Value:
+
+    The element value.
+
+--*/
+{
+    ULONGLONG Bit;
+    ULONGLONG Word;
+    ULONGLONG Mask;
+
+    Bit = Index * BitsPerElement;
+    Mask = (1ULL << BitsPerElement) - 1;
+    Word = *((ULONGLONG UNALIGNED *)RtlOffsetToPointer(TableData, Bit >> 3));
+
+    return (ULONG)((Word >> (Bit & 7)) & Mask);
+}
+
+FORCEINLINE
+ULONGLONG
+GetPackedTableDataWord(
+    _In_reads_(NumberOfElements) PULONG Source,
+    _In_ ULONGLONG NumberOfElements,
+    _In_ ULONG BitsPerElement,
+    _In_ ULONGLONG WordIndex
+    )
+/*++
+
+Routine Description:
+
+    Returns the 64-bit word at a given index of the packed representation of
+    an array of table data elements.  This allows the packed table data to be
+    produced a word at a time (e.g. when emitting the compiled table's table
+    data source file) without an intermediate buffer.
+
+Arguments:
+
+    Source - Supplies the base address of the unpacked table data elements.
+        Each element must be representable in BitsPerElement bits.
+
+    NumberOfElements - Supplies the number of elements in Source.
+
+    BitsPerElement - Supplies the number of bits per element.
+
+    WordIndex - Supplies the index of the word to produce.  Words beyond the
+        last element (i.e. the padding) are 0.
+
+Return Value:
+
+    The packed word.
+
+--*/
+{
+    ULONGLONG Bit;
+    ULONGLONG Word;
+    ULONGLONG Value;
+    ULONGLONG Element;
+    ULONGLONG FirstBit;
+    ULONGLONG LastBit;
+
+    Word = 0;
+    FirstBit = WordIndex * PACKED_TABLE_DATA_BITS_PER_WORD;
+    LastBit = FirstBit + PACKED_TABLE_DATA_BITS_PER_WORD;
+
+    for (Element = FirstBit / BitsPerElement;
+         Element < NumberOfElements;
+         Element++) {
+
+        Bit = Element * BitsPerElement;
+        if (Bit >= LastBit) {
+            break;
+        }
+
+        Value = Source[Element];
+        ASSERT((Value >> BitsPerElement) == 0);
+
+        if (Bit >= FirstBit) {
+            Word |= Value << (Bit - FirstBit);
+        } else {
+            Word |= Value >> (FirstBit - Bit);
+        }
+    }
+
+    return Word;
+}
+
+FORCEINLINE
+VOID
+PackTableData(
+    _In_reads_(NumberOfElements) PULONG Source,
+    _In_ ULONGLONG NumberOfElements,
+    _In_ ULONG BitsPerElement,
+    _Out_writes_bytes_all_(SizeInBytes) PULONGLONG Dest,
+    _In_ ULONGLONG SizeInBytes
+    )
+/*++
+
+Routine Description:
+
+    Packs an array of table data elements into the packed table data layout.
+
+Arguments:
+
+    Source - Supplies the base address of the unpacked table data elements.
+
+    NumberOfElements - Supplies the number of elements in Source.
+
+    BitsPerElement - Supplies the number of bits per element.
+
+    Dest - Supplies the base address of the buffer that receives the packed
+        table data.
+
+    SizeInBytes - Supplies the size of Dest, in bytes.  This must be the value
+        returned by GetPackedTableDataSizeInBytes() for the number of elements
+        and bits per element.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ULONGLONG Index;
+    ULONGLONG NumberOfWords;
+
+    ASSERT(SizeInBytes ==
+           GetPackedTableDataSizeInBytes(NumberOfElements, BitsPerElement));
+
+    NumberOfWords = SizeInBytes >> 3;
+
+    for (Index = 0; Index < NumberOfWords; Index++) {
+        Dest[Index] = GetPackedTableDataWord(Source,
+                                             NumberOfElements,
+                                             BitsPerElement,
+                                             Index);
+    }
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
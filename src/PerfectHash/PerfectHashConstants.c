@@ -222,6 +222,24 @@ const PPERFECT_HASH_TABLE_SEEDED_HASH_EX SeededHashExRoutines[] = {
 };
 VERIFY_HASH_ARRAY_SIZE(SeededHashExRoutines);
 
+//
+// Define the array of multiply-high seeded hash "Ex" routines.
+//
+
+#define EXPAND_AS_SEEDED_HASH_EX_MULTIPLY_HIGH_ROUTINE( \
+    Name, NumberOfSeeds, SeedMasks                      \
+)                                                       \
+    PerfectHashTableSeededHashExMultiplyHigh##Name,
+
+const PPERFECT_HASH_TABLE_SEEDED_HASH_EX SeededHashExMultiplyHighRoutines[] = {
+    NULL,
+    PERFECT_HASH_HASH_FUNCTION_TABLE_ENTRY(
+        EXPAND_AS_SEEDED_HASH_EX_MULTIPLY_HIGH_ROUTINE
+    )
+    NULL
+};
+VERIFY_HASH_ARRAY_SIZE(SeededHashExMultiplyHighRoutines);
+
 //
 // Define the array of hash mask routines.
 //
@@ -230,6 +248,7 @@ const PPERFECT_HASH_TABLE_MASK_HASH MaskHashRoutines[] = {
     NULL,
     PerfectHashTableMaskHashModulus,
     PerfectHashTableMaskHashAnd,
+    PerfectHashTableMaskHashMultiplyHigh,
     NULL
 };
 VERIFY_MASK_ARRAY_SIZE(MaskHashRoutines);
@@ -242,6 +261,7 @@ const PPERFECT_HASH_TABLE_MASK_INDEX MaskIndexRoutines[] = {
     NULL,
     PerfectHashTableMaskIndexModulus,
     PerfectHashTableMaskIndexAnd,
+    PerfectHashTableMaskIndexMultiplyHigh,
     NULL
 };
 VERIFY_MASK_ARRAY_SIZE(MaskIndexRoutines);
@@ -253,10 +273,27 @@ VERIFY_MASK_ARRAY_SIZE(MaskIndexRoutines);
 const PPERFECT_HASH_TABLE_INDEX IndexRoutines[] = {
     NULL,
     PerfectHashTableIndexImplChm01,
+    PerfectHashTableIndexImplBdz01,
+    PerfectHashTableIndexImplShard01,
+    PerfectHashTableIndexImplBlock01,
     NULL
 };
 VERIFY_ALGORITHM_ARRAY_SIZE(IndexRoutines);
 
+//
+// Define the array of batch index routines.
+//
+
+const PPERFECT_HASH_TABLE_INDEX_BATCH IndexBatchRoutines[] = {
+    NULL,
+    PerfectHashTableIndexBatchImplChm01,
+    PerfectHashTableIndexBatchImplBdz01,
+    PerfectHashTableIndexBatchImplShard01,
+    PerfectHashTableIndexBatchImplBlock01,
+    NULL
+};
+VERIFY_ALGORITHM_ARRAY_SIZE(IndexBatchRoutines);
+
 //
 // Define the array of fast-index routines.
 //
@@ -335,10 +372,139 @@ const PERFECT_HASH_TABLE_INDEX_IMPL_STRING_TUPLE IndexImplStringTuples[] = {
         PerfectHashModulusMaskFunctionId,
         &CompiledPerfectHashTableChm01IndexJenkinsModulusCSourceRawCString,
     },
+
+    //
+    // Bdz01 implementations.  These are only provided for a handful of the
+    // faster hash functions; attempting to create a Bdz01 table with any other
+    // hash function will fail with PH_E_NO_INDEX_IMPL_C_STRING_FOUND.
+    //
+
+#define EXPAND_AS_BDZ01_AND_INDEX_IMPL_TUPLE(Name)                           \
+    {                                                                        \
+        PerfectHashBdz01AlgorithmId,                                         \
+        PerfectHashHash##Name##FunctionId,                                   \
+        PerfectHashAndMaskFunctionId,                                        \
+        &CompiledPerfectHashTableBdz01Index##Name##AndCSourceRawCString,     \
+    },
+
+    EXPAND_AS_BDZ01_AND_INDEX_IMPL_TUPLE(Crc32RotateX)
+    EXPAND_AS_BDZ01_AND_INDEX_IMPL_TUPLE(MultiplyShiftR)
+    EXPAND_AS_BDZ01_AND_INDEX_IMPL_TUPLE(RotateMultiplyXorRotate)
+    EXPAND_AS_BDZ01_AND_INDEX_IMPL_TUPLE(ShiftMultiplyXorShift)
+
+    //
+    // Shard01 implementations; as above, only a handful of hash functions
+    // are supported.
+    //
+
+#define EXPAND_AS_SHARD01_AND_INDEX_IMPL_TUPLE(Name)                         \
+    {                                                                        \
+        PerfectHashShard01AlgorithmId,                                       \
+        PerfectHashHash##Name##FunctionId,                                   \
+        PerfectHashAndMaskFunctionId,                                        \
+        &CompiledPerfectHashTableShard01Index##Name##AndCSourceRawCString,   \
+    },
+
+    EXPAND_AS_SHARD01_AND_INDEX_IMPL_TUPLE(Crc32RotateX)
+    EXPAND_AS_SHARD01_AND_INDEX_IMPL_TUPLE(MultiplyShiftR)
+    EXPAND_AS_SHARD01_AND_INDEX_IMPL_TUPLE(RotateMultiplyXorRotate)
+    EXPAND_AS_SHARD01_AND_INDEX_IMPL_TUPLE(ShiftMultiplyXorShift)
+
+    //
+    // Block01 implementations; as above, only a handful of hash functions
+    // are supported.
+    //
+
+#define EXPAND_AS_BLOCK01_AND_INDEX_IMPL_TUPLE(Name)                         \
+    {                                                                        \
+        PerfectHashBlock01AlgorithmId,                                       \
+        PerfectHashHash##Name##FunctionId,                                   \
+        PerfectHashAndMaskFunctionId,                                        \
+        &CompiledPerfectHashTableBlock01Index##Name##AndCSourceRawCString,   \
+    },
+
+    EXPAND_AS_BLOCK01_AND_INDEX_IMPL_TUPLE(Crc32RotateX)
+    EXPAND_AS_BLOCK01_AND_INDEX_IMPL_TUPLE(MultiplyShiftR)
+    EXPAND_AS_BLOCK01_AND_INDEX_IMPL_TUPLE(RotateMultiplyXorRotate)
+    EXPAND_AS_BLOCK01_AND_INDEX_IMPL_TUPLE(ShiftMultiplyXorShift)
+
+    //
+    // Chm01 multiply-high implementations; as above, only a handful of hash
+    // functions are supported.
+    //
+
+#define EXPAND_AS_CHM01_MULTIPLY_HIGH_INDEX_IMPL_TUPLE(Name)                 \
+    {                                                                        \
+        PerfectHashChm01AlgorithmId,                                         \
+        PerfectHashHash##Name##FunctionId,                                   \
+        PerfectHashMultiplyHighMaskFunctionId,                               \
+        &CompiledPerfectHashTableChm01Index##Name##MultiplyHigh##            \
+            CSourceRawCString,                                               \
+    },
+
+    EXPAND_AS_CHM01_MULTIPLY_HIGH_INDEX_IMPL_TUPLE(Crc32RotateX)
+    EXPAND_AS_CHM01_MULTIPLY_HIGH_INDEX_IMPL_TUPLE(MultiplyShiftR)
+    EXPAND_AS_CHM01_MULTIPLY_HIGH_INDEX_IMPL_TUPLE(RotateMultiplyXorRotate)
+    EXPAND_AS_CHM01_MULTIPLY_HIGH_INDEX_IMPL_TUPLE(ShiftMultiplyXorShift)
 };
 
 const BYTE NumberOfIndexImplStrings = ARRAYSIZE(IndexImplStringTuples);
 
+//
+// Define the array of raw C string Index() implementations for tables using
+// the interleaved table data layout.  As with the other variants, only a
+// handful of hash functions are supported.
+//
+
+#define EXPAND_AS_CHM01_INTERLEAVED_INDEX_IMPL_TUPLE(Name)                   \
+    {                                                                        \
+        PerfectHashChm01AlgorithmId,                                         \
+        PerfectHashHash##Name##FunctionId,                                   \
+        PerfectHashAndMaskFunctionId,                                        \
+        &CompiledPerfectHashTableChm01Index##Name##AndInterleaved##          \
+            CSourceRawCString,                                               \
+    },
+
+const PERFECT_HASH_TABLE_INDEX_IMPL_STRING_TUPLE
+    InterleavedIndexImplStringTuples[] = {
+
+    EXPAND_AS_CHM01_INTERLEAVED_INDEX_IMPL_TUPLE(Crc32RotateX)
+    EXPAND_AS_CHM01_INTERLEAVED_INDEX_IMPL_TUPLE(MultiplyShiftR)
+    EXPAND_AS_CHM01_INTERLEAVED_INDEX_IMPL_TUPLE(RotateMultiplyXorRotate)
+    EXPAND_AS_CHM01_INTERLEAVED_INDEX_IMPL_TUPLE(ShiftMultiplyXorShift)
+};
+
+const BYTE NumberOfInterleavedIndexImplStrings = (
+    ARRAYSIZE(InterleavedIndexImplStringTuples)
+);
+
+//
+// Define the array of raw C string Index() implementations for tables using
+// the packed table data layout.
+//
+
+#define EXPAND_AS_CHM01_PACKED_INDEX_IMPL_TUPLE(Name)                        \
+    {                                                                        \
+        PerfectHashChm01AlgorithmId,                                         \
+        PerfectHashHash##Name##FunctionId,                                   \
+        PerfectHashAndMaskFunctionId,                                        \
+        &CompiledPerfectHashTableChm01Index##Name##AndPacked##               \
+            CSourceRawCString,                                               \
+    },
+
+const PERFECT_HASH_TABLE_INDEX_IMPL_STRING_TUPLE
+    PackedIndexImplStringTuples[] = {
+
+    EXPAND_AS_CHM01_PACKED_INDEX_IMPL_TUPLE(Crc32RotateX)
+    EXPAND_AS_CHM01_PACKED_INDEX_IMPL_TUPLE(MultiplyShiftR)
+    EXPAND_AS_CHM01_PACKED_INDEX_IMPL_TUPLE(RotateMultiplyXorRotate)
+    EXPAND_AS_CHM01_PACKED_INDEX_IMPL_TUPLE(ShiftMultiplyXorShift)
+};
+
+const BYTE NumberOfPackedIndexImplStrings = (
+    ARRAYSIZE(PackedIndexImplStringTuples)
+);
+
 //
 // The next section defines the UNICODE_STRING representations and supporting
 // arrays of enum types.
@@ -1028,8 +1194,15 @@ const PERFECT_HASH_TABLE_VTBL PerfectHashTableInterface = {
     &PerfectHashTableGetFile,
     NULL,   // HashEx
     NULL,   // SeededHashEx
+    NULL,   // IndexBatch
+    &PerfectHashTableLookupBatch,
+    &PerfectHashTableInsertBatch,
+    &PerfectHashTableContains,
+    &PerfectHashTableTryLookup,
+    &PerfectHashTableTryIndexString,
+    &PerfectHashTableTryLookupString,
 };
-VERIFY_VTBL_SIZE(PERFECT_HASH_TABLE, 21);
+VERIFY_VTBL_SIZE(PERFECT_HASH_TABLE, 28);
 
 //
 // Rtl
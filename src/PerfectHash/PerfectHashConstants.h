@@ -69,6 +69,13 @@ extern const PLOAD_PERFECT_HASH_TABLE_IMPL LoaderRoutines[];
 
 extern const PPERFECT_HASH_TABLE_INDEX IndexRoutines[];
 
+//
+// Declare an array of batch index routines.  This is intended to be indexed by
+// the PERFECT_HASH_ALGORITHM_ID enumeration.
+//
+
+extern const PPERFECT_HASH_TABLE_INDEX_BATCH IndexBatchRoutines[];
+
 //
 // Declare an array of fast-index routines.  Unlike our other arrays that are
 // all indexed by enumeration IDs, this array captures <algorith, hash, mask,
@@ -90,6 +97,24 @@ extern const BYTE NumberOfFastIndexRoutines;
 extern const PERFECT_HASH_TABLE_INDEX_IMPL_STRING_TUPLE IndexImplStringTuples[];
 extern const BYTE NumberOfIndexImplStrings;
 
+//
+// As above, but for Index() routines of tables using the interleaved table
+// data layout.
+//
+
+extern const PERFECT_HASH_TABLE_INDEX_IMPL_STRING_TUPLE
+    InterleavedIndexImplStringTuples[];
+extern const BYTE NumberOfInterleavedIndexImplStrings;
+
+//
+// As above, but for Index() routines of tables using the packed table data
+// layout.
+//
+
+extern const PERFECT_HASH_TABLE_INDEX_IMPL_STRING_TUPLE
+    PackedIndexImplStringTuples[];
+extern const BYTE NumberOfPackedIndexImplStrings;
+
 //
 // Declare an array of hash routines.  This is intended to be indexed by
 // the PERFECT_HASH_HASH_FUNCTION_ID enumeration.
@@ -140,6 +165,33 @@ extern const PPERFECT_HASH_TABLE_SEEDED_HASH SeededHashRoutines[];
 extern const PPERFECT_HASH_TABLE_HASH_EX HashExRoutines[];
 extern const PPERFECT_HASH_TABLE_SEEDED_HASH_EX SeededHashExRoutines[];
 
+//
+// Declare the multiply-high seeded hash "Ex" routines, also indexed by the
+// PERFECT_HASH_TABLE_HASH_FUNCTION_ID enumeration.
+//
+
+extern const PPERFECT_HASH_TABLE_SEEDED_HASH_EX
+    SeededHashExMultiplyHighRoutines[];
+
+//
+// Helper inline routine for obtaining the seeded hash "Ex" routine for a given
+// hash and mask function.
+//
+
+FORCEINLINE
+PPERFECT_HASH_TABLE_SEEDED_HASH_EX
+GetSeededHashExRoutine(
+    _In_ PERFECT_HASH_HASH_FUNCTION_ID HashFunctionId,
+    _In_ PERFECT_HASH_MASK_FUNCTION_ID MaskFunctionId
+    )
+{
+    if (IsMultiplyHighMasking(MaskFunctionId)) {
+        return SeededHashExMultiplyHighRoutines[HashFunctionId];
+    }
+
+    return SeededHashExRoutines[HashFunctionId];
+}
+
 //
 // Declare an array of STRINGs representing C type names (e.g. 'unsigned short',
 // 'int', 'long long', etc); intended to be indexed by the TYPE enum.
@@ -154,6 +206,66 @@ extern const STRING CTypeNames[];
 
 extern const STRING NtTypeNames[];
 
+//
+// Helper inline routines for obtaining the raw C string Index() implementation
+// for a table using the interleaved or packed table data layouts.  These
+// return NULL if there is no implementation available for the table's
+// algorithm/hash/mask IDs.
+//
+
+FORCEINLINE
+PCSTRING
+FindIndexImplString(
+    _In_ PPERFECT_HASH_TABLE Table,
+    _In_reads_(NumberOfTuples)
+        PCPERFECT_HASH_TABLE_INDEX_IMPL_STRING_TUPLE Tuples,
+    _In_ BYTE NumberOfTuples
+    )
+{
+    BYTE Index;
+    BOOLEAN IsMatch;
+    PCPERFECT_HASH_TABLE_INDEX_IMPL_STRING_TUPLE StringTuple;
+
+    for (Index = 0; Index < NumberOfTuples; Index++) {
+
+        StringTuple = &Tuples[Index];
+
+        IsMatch = (
+            Table->AlgorithmId == StringTuple->AlgorithmId &&
+            Table->HashFunctionId == StringTuple->HashFunctionId &&
+            Table->MaskFunctionId == StringTuple->MaskFunctionId
+        );
+
+        if (IsMatch) {
+            return StringTuple->RawCString;
+        }
+    }
+
+    return NULL;
+}
+
+FORCEINLINE
+PCSTRING
+GetInterleavedIndexImplString(
+    _In_ PPERFECT_HASH_TABLE Table
+    )
+{
+    return FindIndexImplString(Table,
+                               InterleavedIndexImplStringTuples,
+                               NumberOfInterleavedIndexImplStrings);
+}
+
+FORCEINLINE
+PCSTRING
+GetPackedIndexImplString(
+    _In_ PPERFECT_HASH_TABLE Table
+    )
+{
+    return FindIndexImplString(Table,
+                               PackedIndexImplStringTuples,
+                               NumberOfPackedIndexImplStrings);
+}
+
 //
 // Helper inline routine for initializing the extended vtbl interface and any
 // other dynamic values.
@@ -192,7 +304,8 @@ CompletePerfectHashTableInitialization(
     Vtbl->MaskIndex = MaskIndexRoutines[MaskFunctionId];
     Vtbl->SeededHash = SeededHashRoutines[HashFunctionId];
     Vtbl->HashEx = HashExRoutines[HashFunctionId];
-    Vtbl->SeededHashEx = SeededHashExRoutines[HashFunctionId];
+    Vtbl->SeededHashEx = GetSeededHashExRoutine(HashFunctionId,
+                                                MaskFunctionId);
 
     //
     // Default the slow index to the normal index routine.
@@ -226,6 +339,14 @@ CompletePerfectHashTableInitialization(
 
     Vtbl->Index = (Vtbl->FastIndex ? Vtbl->FastIndex : Vtbl->SlowIndex);
 
+    //
+    // Initialize the batch index routine for the algorithm.  (The batch lookup
+    // and insert routines are algorithm-agnostic and are wired up statically
+    // in the interface.)
+    //
+
+    Vtbl->IndexBatch = IndexBatchRoutines[AlgorithmId];
+
     //
     // Walk the C impl string tuples and try find a match.
     //
@@ -247,6 +368,21 @@ CompletePerfectHashTableInitialization(
             break;
         }
     }
+
+    //
+    // Tables using the packed table data layout have their own index routines
+    // and C impl strings, irrespective of the hash function.  (The layout is
+    // only known once the table create parameters have been processed, so the
+    // table create routine calls us again at that point.)
+    //
+
+    if (IsPackedTableDataLayout(Table)) {
+        Vtbl->SlowIndex = PerfectHashTableIndexImplChm01Packed;
+        Vtbl->FastIndex = NULL;
+        Vtbl->Index = Vtbl->SlowIndex;
+        Vtbl->IndexBatch = PerfectHashTableIndexBatchImplChm01Packed;
+        Table->IndexImplString = GetPackedIndexImplString(Table);
+    }
 }
 
 //
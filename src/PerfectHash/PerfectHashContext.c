@@ -27,30 +27,6 @@ Abstract:
 // These are needed up-front in order to create and register the various
 // work and cleanup callbacks as part of context creation.
 //
-// (Annoyingly, winnt.h only defines PTP_WORK_CALLBACK, not the underlying
-//  raw function type TP_WORK_CALLBACK, so, do that now.  Ditto for the
-//  PTP_CLEANUP_GROUP_CANCEL_CALLBACK signature.)
-//
-
-typedef
-VOID
-(NTAPI TP_WORK_CALLBACK)(
-    _Inout_     PTP_CALLBACK_INSTANCE Instance,
-    _Inout_opt_ PVOID                 Context,
-    _Inout_     PTP_WORK              Work
-    );
-
-
-typedef
-VOID
-(NTAPI TP_CLEANUP_GROUP_CANCEL_CALLBACK)(
-    _Inout_opt_ PVOID ObjectContext,
-    _Inout_opt_ PVOID CleanupContext
-    );
-
-//
-// Forward definitions.
-//
 
 TP_WORK_CALLBACK MainWorkCallback;
 TP_WORK_CALLBACK FileWorkCallback;
@@ -779,6 +755,30 @@ Return Value:
         Context->MainThreadpool = NULL;
     }
 
+    if (Context->FileCleanupGroup) {
+
+        CloseThreadpoolCleanupGroupMembers(Context->FileCleanupGroup,
+                                           TRUE,
+                                           NULL);
+        Context->FileWork = NULL;
+        CloseThreadpoolCleanupGroup(Context->FileCleanupGroup);
+        Context->FileCleanupGroup = NULL;
+
+    } else {
+
+        //
+        // Invariant check: Context->FileWork should never be set if
+        // FileCleanupGroup is not set.
+        //
+
+        ASSERT(!Context->FileWork);
+    }
+
+    if (Context->FileThreadpool) {
+        CloseThreadpool(Context->FileThreadpool);
+        Context->FileThreadpool = NULL;
+    }
+
     //
     // The Finished and Error threadpools do not have a cleanup group associated
     // with them, so we can close their work items directly, if applicable.
@@ -950,6 +950,15 @@ typedef struct _Struct_size_bytes_(SizeOfStruct) _PERFECT_HASH_CONTEXT {
     volatile LONG GraphRegisterSolvedTsxFailed;
     ULONG Padding6;
 
+    //
+    // Pointer to the active parallel peeling job, if any.  A graph publishes
+    // its job here via an interlocked compare-exchange when it begins peeling
+    // in parallel (--ParallelPeeling); other solving threads join the job
+    // (see GraphHelpPeel3()) until it is cleared by the owning graph.
+    //
+
+    struct _GRAPH_PEEL_JOB *volatile PeelJob;
+
     //
     // Backing vtbl.
     //
@@ -480,6 +480,15 @@ Return Value:
     // if applicable.
     //
 
+    //
+    // No tables are created when compressing keys, so there are no .csv rows
+    // to write.
+    //
+
+    if (ContextBulkCreateFlags.CompressKeys) {
+        TableCreateFlags.DisableCsvOutputFile = TRUE;
+    }
+
     if (TableCreateFlags.DisableCsvOutputFile == FALSE) {
         Result = PrepareBulkCreateCsvFile(Context,
                                           NumberOfKeysFiles,
@@ -662,6 +671,27 @@ Return Value:
             goto ReleaseKeys;
         }
 
+        //
+        // If we've been asked to compress the keys, write the compressed keys
+        // file to the output directory instead of creating a table.
+        //
+
+        if (ContextBulkCreateFlags.CompressKeys) {
+
+            Result = PerfectHashKeysSaveCompressed(
+                Keys,
+                Context->BaseOutputDirectory
+            );
+
+            if (FAILED(Result)) {
+                PH_KEYS_ERROR(PerfectHashKeysSaveCompressed, Result);
+                Failures++;
+                Terminate = TRUE;
+            }
+
+            goto ReleaseKeys;
+        }
+
         //
         // Keys were loaded successfully.  Proceed with table creation.
         //
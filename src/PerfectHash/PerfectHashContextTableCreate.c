@@ -295,6 +295,15 @@ Return Value:
     // Prepare the .csv file if applicable.
     //
 
+    //
+    // No table is created when compressing keys, so there's no .csv row to
+    // write.
+    //
+
+    if (ContextTableCreateFlags.CompressKeys) {
+        TableCreateFlags.DisableCsvOutputFile = TRUE;
+    }
+
     if (TableCreateFlags.DisableCsvOutputFile == FALSE) {
         NumberOfRows = 1;
         Result = PrepareTableCreateCsvFile(Context, NumberOfRows);
@@ -381,6 +390,21 @@ Return Value:
         goto Error;
     }
 
+    //
+    // If we've been asked to compress the keys, write the compressed keys file
+    // to the output directory and finish up; no table is created.
+    //
+
+    if (ContextTableCreateFlags.CompressKeys) {
+        Result = PerfectHashKeysSaveCompressed(Keys,
+                                               Context->BaseOutputDirectory);
+        if (FAILED(Result)) {
+            PH_KEYS_ERROR(PerfectHashKeysSaveCompressed, Result);
+            goto Error;
+        }
+        goto End;
+    }
+
     //
     // Keys were loaded successfully.  If CUDA is available, register the base
     // address of the array.
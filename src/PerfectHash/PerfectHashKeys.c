@@ -175,18 +175,21 @@ Return Value:
         Allocator = Keys->Allocator;
 
         //
-        // Invariant check: if downsizing has occurred, the file's base address
-        // should not match Keys->KeyArrayBaseAddress.  If no downsizing has
-        // occurred, the addresses should match.
+        // Invariant check: if downsizing has occurred, or string or 128-bit
+        // keys were loaded, the original key array's base address should not
+        // match Keys->KeyArrayBaseAddress.  Otherwise, the addresses should
+        // match.  (The original key array is the file's base address unless
+        // the keys were sorted into a separate array.)
         //
 
-        if (KeysWereDownsized(Keys)) {
+        if (KeysWereDownsized(Keys) || KeysWereReduced(Keys)) {
 
             //
-            // Downsizing occurred; addresses should differ.
+            // Downsizing occurred or the keys were reduced; addresses should
+            // differ.
             //
 
-            if (Keys->File->BaseAddress == Keys->KeyArrayBaseAddress) {
+            if (GetOriginalKeyArray(Keys) == Keys->KeyArrayBaseAddress) {
                 Result = PH_E_INVARIANT_CHECK_FAILED;
                 PH_ERROR(KeysRelease_EqualBaseAddressesAfterDownsizing, Result);
                 PH_RAISE(Result);
@@ -202,10 +205,13 @@ Return Value:
         } else {
 
             //
-            // No downsizing occurred; addresses should be the same.
+            // No downsizing occurred; addresses should be the same.  (Unless
+            // string or 128-bit keys failed to load, in which case no key
+            // array will have been set.)
             //
 
-            if (Keys->File->BaseAddress != Keys->KeyArrayBaseAddress) {
+            if (Keys->KeyArrayBaseAddress != NULL &&
+                GetOriginalKeyArray(Keys) != Keys->KeyArrayBaseAddress) {
                 Result = PH_E_INVARIANT_CHECK_FAILED;
                 PH_ERROR(KeysRelease_UnequalBaseAddressesNoDownsizing, Result);
                 PH_RAISE(Result);
@@ -220,6 +226,40 @@ Return Value:
         }
     }
 
+    //
+    // Release the string key data and offsets, if applicable.
+    //
+
+    if (Keys->StringKeyData) {
+        Keys->Allocator->Vtbl->FreePointer(Keys->Allocator,
+                                           &Keys->StringKeyData);
+    }
+
+    if (Keys->StringKeyOffsets) {
+        Keys->Allocator->Vtbl->FreePointer(Keys->Allocator,
+                                           &Keys->StringKeyOffsets);
+    }
+
+    //
+    // Release the original key array, if applicable.
+    //
+
+    if (Keys->OriginalKeyArray) {
+        if (!VirtualFree(Keys->OriginalKeyArray, 0, MEM_RELEASE)) {
+            SYS_ERROR(VirtualFree);
+        }
+        Keys->OriginalKeyArray = NULL;
+    }
+
+    //
+    // Release the 128-bit key array, if applicable.
+    //
+
+    if (Keys->Key128Array) {
+        Keys->Allocator->Vtbl->FreePointer(Keys->Allocator,
+                                           &Keys->Key128Array);
+    }
+
     //
     // Invariant check: Keys->KeyArrayBaseAddress should be NULL here.
     //
@@ -550,7 +590,7 @@ TryExtractKeySizeFromFilename(
 Routine Description:
 
     Attempts to extract a key size, in bits, from the given path.  Key sizes
-    currently detected: 8, 16, 32 and 64.
+    currently detected: 8, 16, 32, 64 and 128.
 
     N.B. The key size is specified in bits in the file name as an aesthetic
          preference, however, internally, the key size is always represented
@@ -619,9 +659,23 @@ Return Value:
     ASSERT((ULONG_PTR)Wide > (ULONG_PTR)Path->FileName.Buffer);
 
     //
-    // Attempt to look for either 8, 16, 32 or 64 as the bit size.
+    // Attempt to look for either 8, 16, 32, 64 or 128 as the bit size.  The
+    // 128 check is performed first, as it would otherwise be detected as 8.
     //
 
+    if (Path->BaseName.Length >= (sizeof(WCHAR) * 3)) {
+
+        //
+        // There are at least three characters we can dereference; determine
+        // if they are 128.
+        //
+
+        if (*Wide == L'8' && *(Wide - 1) == L'2' && *(Wide - 2) == L'1') {
+            KeySizeInBytes = 16;
+            goto End;
+        }
+    }
+
     if (Path->BaseName.Length >= sizeof(WCHAR)) {
 
         //
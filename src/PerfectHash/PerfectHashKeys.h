@@ -62,6 +62,48 @@ typedef PERFECT_HASH_KEYS_STATE *PPERFECT_HASH_KEYS_STATE;
 #define KeysWereDownsized(Keys) \
     ((Keys)->Flags.DownsizingOccurred == TRUE)
 
+#define KeysWereProjected(Keys) \
+    ((Keys)->Flags.ProjectionOccurred == TRUE)
+
+#define KeysAreStrings(Keys) \
+    ((Keys)->Flags.StringKeys == TRUE)
+
+#define KeysAre128Bit(Keys) \
+    ((Keys)->Flags.Keys128 == TRUE)
+
+#define KeysWereReduced(Keys) \
+    (KeysAreStrings(Keys) || KeysAre128Bit(Keys))
+
+#define KeysWereSorted(Keys) \
+    ((Keys)->Flags.KeysSorted == TRUE)
+
+#define KeysWereCompressed(Keys) \
+    ((Keys)->Flags.KeysCompressed == TRUE)
+
+//
+// Returns the base address of the keys at their original key size.  This is
+// the file's base address, unless the keys were parsed from a text keys file,
+// decoded from a compressed keys file, or sorted into a separate array at load
+// time.
+//
+
+#define GetOriginalKeyArray(Keys)                 \
+    ((Keys)->OriginalKeyArray != NULL ?           \
+        (Keys)->OriginalKeyArray :                \
+        (Keys)->File->BaseAddress)
+
+//
+// Define the 128-bit key type.  The keys file is an array of these, sorted in
+// ascending order (i.e. by High, then by Low).  See Keys128.h.
+//
+
+typedef struct _KEY128 {
+    ULONGLONG Low;
+    ULONGLONG High;
+} KEY128;
+typedef KEY128 *PKEY128;
+C_ASSERT(sizeof(KEY128) == 16);
+
 //
 // Define the PERFECT_HASH_KEYS_STATS structure.
 //
@@ -132,6 +174,15 @@ typedef struct _Struct_size_bytes_(SizeOfStruct) _PERFECT_HASH_KEYS {
 
     ULONGLONG DownsizeBitmap;
 
+    //
+    // The multiplier used to project each 64-bit key to a 32-bit key, if key
+    // downsizing occurred via projection rather than via _pext_u64() (see
+    // ReducedKeys.h).  The projected key array is in the same order as the
+    // original keys, and thus is not sorted.
+    //
+
+    ULONGLONG ProjectionMultiplier;
+
     //
     // Number of keys in the mapping.
     //
@@ -152,6 +203,48 @@ typedef struct _Struct_size_bytes_(SizeOfStruct) _PERFECT_HASH_KEYS {
 
     PVOID KeyArrayBaseAddress;
 
+    //
+    // If the keys at their original key size don't live in the keys file's
+    // mapping, the array holding them.  This is the case if the keys were
+    // parsed from a text keys file (i.e. the TextKeys keys load flag was set;
+    // see TextKeys.h), or decoded from a compressed keys file (see
+    // CompressedKeys.h), or if they were sorted and deduplicated at load time
+    // (i.e. the SortKeys keys load flag was set) and the keys file wasn't
+    // loaded into a writable large page buffer that could be sorted in place.
+    // This array is allocated via TryLargePageVirtualAlloc().
+    //
+
+    PVOID OriginalKeyArray;
+
+    //
+    // If the keys were loaded from a string keys file or a 128-bit keys file,
+    // the seed used to reduce each key to its 32-bit key (see ReducedKeys.h).
+    // The key array holds the reduced keys in ascending order.
+    //
+
+    ULONG ReducedKeySeed;
+
+    //
+    // If the keys were loaded from a string keys file (see StringKeys.h), the
+    // string data of all keys, concatenated in key array order (i.e. ordered
+    // by reduced key).  The string for the key at offset N of the key array
+    // spans bytes [StringKeyOffsets[N], StringKeyOffsets[N + 1]) of
+    // StringKeyData; thus, there are NumberOfElements + 1 offsets.  Both
+    // arrays are heap-allocated.
+    //
+
+    ULONG StringKeyDataSizeInBytes;
+    PBYTE StringKeyData;
+    PULONG StringKeyOffsets;
+
+    //
+    // If the keys were loaded from a 128-bit keys file (see Keys128.h), the
+    // original keys in key array order (i.e. ordered by reduced key).  This
+    // array is heap-allocated.
+    //
+
+    PKEY128 Key128Array;
+
     //
     // The CUDA device address of the keys array, if applicable.
     //
@@ -229,6 +322,64 @@ HRESULT
 typedef PERFECT_HASH_KEYS_LOAD_STATS
       *PPERFECT_HASH_KEYS_LOAD_STATS;
 
+typedef
+_Must_inspect_result_
+HRESULT
+(NTAPI PERFECT_HASH_KEYS_LOAD_STRINGS)(
+    _In_ PPERFECT_HASH_KEYS Keys
+    );
+typedef PERFECT_HASH_KEYS_LOAD_STRINGS
+      *PPERFECT_HASH_KEYS_LOAD_STRINGS;
+
+typedef
+_Must_inspect_result_
+HRESULT
+(NTAPI PERFECT_HASH_KEYS_LOAD_128)(
+    _In_ PPERFECT_HASH_KEYS Keys
+    );
+typedef PERFECT_HASH_KEYS_LOAD_128 *PPERFECT_HASH_KEYS_LOAD_128;
+
+typedef
+_Must_inspect_result_
+HRESULT
+(NTAPI PERFECT_HASH_KEYS_TRY_PROJECT_64)(
+    _In_ PPERFECT_HASH_KEYS Keys
+    );
+typedef PERFECT_HASH_KEYS_TRY_PROJECT_64 *PPERFECT_HASH_KEYS_TRY_PROJECT_64;
+
+typedef
+_Must_inspect_result_
+HRESULT
+(NTAPI PERFECT_HASH_KEYS_SORT)(
+    _In_ PPERFECT_HASH_KEYS Keys
+    );
+typedef PERFECT_HASH_KEYS_SORT *PPERFECT_HASH_KEYS_SORT;
+
+typedef
+_Must_inspect_result_
+HRESULT
+(NTAPI PERFECT_HASH_KEYS_LOAD_TEXT)(
+    _In_ PPERFECT_HASH_KEYS Keys
+    );
+typedef PERFECT_HASH_KEYS_LOAD_TEXT *PPERFECT_HASH_KEYS_LOAD_TEXT;
+
+typedef
+_Must_inspect_result_
+HRESULT
+(NTAPI PERFECT_HASH_KEYS_LOAD_COMPRESSED)(
+    _In_ PPERFECT_HASH_KEYS Keys
+    );
+typedef PERFECT_HASH_KEYS_LOAD_COMPRESSED *PPERFECT_HASH_KEYS_LOAD_COMPRESSED;
+
+typedef
+_Must_inspect_result_
+HRESULT
+(NTAPI PERFECT_HASH_KEYS_SAVE_COMPRESSED)(
+    _In_ PPERFECT_HASH_KEYS Keys,
+    _In_ PPERFECT_HASH_DIRECTORY Directory
+    );
+typedef PERFECT_HASH_KEYS_SAVE_COMPRESSED *PPERFECT_HASH_KEYS_SAVE_COMPRESSED;
+
 typedef
 _Must_inspect_result_
 HRESULT
@@ -277,6 +428,13 @@ extern PERFECT_HASH_KEYS_INITIALIZE PerfectHashKeysInitialize;
 extern PERFECT_HASH_KEYS_RUNDOWN PerfectHashKeysRundown;
 extern PERFECT_HASH_KEYS_LOAD_STATS PerfectHashKeysLoadStats32;
 extern PERFECT_HASH_KEYS_LOAD_STATS PerfectHashKeysLoadStats64;
+extern PERFECT_HASH_KEYS_LOAD_STRINGS PerfectHashKeysLoadStrings;
+extern PERFECT_HASH_KEYS_LOAD_128 PerfectHashKeysLoad128;
+extern PERFECT_HASH_KEYS_TRY_PROJECT_64 PerfectHashKeysTryProject64;
+extern PERFECT_HASH_KEYS_SORT PerfectHashKeysSort;
+extern PERFECT_HASH_KEYS_LOAD_TEXT PerfectHashKeysLoadText;
+extern PERFECT_HASH_KEYS_LOAD_COMPRESSED PerfectHashKeysLoadCompressed;
+extern PERFECT_HASH_KEYS_SAVE_COMPRESSED PerfectHashKeysSaveCompressed;
 extern PERFECT_HASH_KEYS_LOAD_TABLE_SIZE PerfectHashKeysLoadTableSize;
 extern PERFECT_HASH_KEYS_LOAD PerfectHashKeysLoad;
 extern PERFECT_HASH_KEYS_GET_FLAGS PerfectHashKeysGetFlags;
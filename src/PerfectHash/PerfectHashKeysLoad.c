@@ -62,10 +62,38 @@ Return Value:
 
     PH_E_INVALID_KEYS_LOAD_FLAGS - The provided load flags were invalid.
 
-    PH_E_KEYS_NOT_SORTED - Keys were not sorted.
+    PH_E_KEYS_NOT_SORTED - Keys were not sorted (and the SortKeys flag was not
+        set).
 
     PH_E_DUPLICATE_KEYS_DETECTED - Duplicate keys were detected.
 
+    PH_E_INVALID_STRING_KEYS_FILE - The StringKeys flag was set, and the keys
+        file was not a valid string keys file.
+
+    PH_E_TOO_MANY_STRING_KEYS - The StringKeys flag was set, and the keys
+        file contained too many string keys.
+
+    PH_E_STRING_KEYS_HASH_COLLISIONS - The StringKeys flag was set, and the
+        string keys could not be reduced to unique ULONG keys.
+
+    PH_E_KEYS_FILE_SIZE_NOT_MULTIPLE_OF_KEY_SIZE - The key size was 16 bytes,
+        and the keys file size was not a multiple of 16 bytes.
+
+    PH_E_TOO_MANY_KEYS128 - The key size was 16 bytes, and the keys file
+        contained too many 128-bit keys.
+
+    PH_E_KEYS128_HASH_COLLISIONS - The key size was 16 bytes, and the 128-bit
+        keys could not be reduced to unique ULONG keys.
+
+    PH_E_INVALID_TEXT_KEYS_FILE - The TextKeys flag was set, and the keys file
+        was not a valid text keys file.
+
+    PH_E_TEXT_KEY_EXCEEDS_KEY_SIZE - The TextKeys flag was set, and a key in
+        the keys file was too large for the key size.
+
+    PH_E_INVALID_COMPRESSED_KEYS_FILE - The keys file was a compressed keys
+        file, and was malformed.
+
     PH_E_KEYS_LOCKED - The keys are locked.
 
     PH_E_KEYS_ALREADY_LOADED - A keys file has already been loaded.
@@ -78,6 +106,7 @@ Return Value:
 --*/
 {
     BOOLEAN Is32Bit;
+    BOOLEAN Is128Bit = FALSE;
     HRESULT Result = S_OK;
     PPERFECT_HASH_FILE File;
     PPERFECT_HASH_PATH Path = NULL;
@@ -192,18 +221,46 @@ Return Value:
     }
 
     //
-    // Validate the key size; we only support ULONG and ULONGLONG at the moment.
+    // String keys are always reduced to ULONG keys, regardless of the key size
+    // provided or inferred above.
+    //
+
+    if (KeysLoadFlags.StringKeys) {
+        KeySizeInBytes = sizeof(ULONG);
+    }
+
+    //
+    // Validate the key size; we support ULONG, ULONGLONG, and 128-bit keys.
+    // 128-bit keys are always reduced to ULONG keys.
     //
 
     if (KeySizeInBytes == sizeof(ULONG)) {
         Is32Bit = TRUE;
     } else if (KeySizeInBytes == sizeof(ULONGLONG)) {
         Is32Bit = FALSE;
+    } else if (KeySizeInBytes == sizeof(KEY128)) {
+        Is32Bit = TRUE;
+        Is128Bit = TRUE;
     } else {
         Result = PH_E_INVALID_KEY_SIZE;
         goto Error;
     }
 
+    //
+    // Text keys are parsed into ULONG or ULONGLONG keys, so they can't be
+    // combined with string keys or a 128-bit key size.
+    //
+
+    if (KeysLoadFlags.TextKeys) {
+        if (KeysLoadFlags.StringKeys) {
+            Result = PH_E_INVALID_KEYS_LOAD_FLAGS;
+            goto Error;
+        } else if (Is128Bit) {
+            Result = PH_E_INVALID_KEY_SIZE;
+            goto Error;
+        }
+    }
+
     //
     // Create a file instance.
     //
@@ -243,22 +300,112 @@ Return Value:
 
     Keys->Flags.KeysDataUsesLargePages = File->Flags.UsesLargePages;
 
+    //
+    // Capture the load flags; the routines below consult them.
+    //
+
+    Keys->LoadFlags.AsULong = KeysLoadFlags.AsULong;
+
     //
     // Update the key size and initialize the key array base address to point
     // at the memory-mapped base address of the file.  Initialize the number
-    // of elements (key count).
+    // of elements (key count).  String and 128-bit keys are the exception;
+    // their key array is heap-allocated by PerfectHashKeysLoadStrings() and
+    // PerfectHashKeysLoad128(), respectively.
     //
 
     Keys->OriginalKeySizeInBytes = Keys->KeySizeInBytes = KeySizeInBytes;
     Keys->OriginalKeySizeType = Keys->KeySizeType = (
         Is32Bit ? LongType : LongLongType
     );
-    Keys->KeyArrayBaseAddress = Keys->File->BaseAddress;
 
-    Keys->NumberOfElements.QuadPart = (
-        File->FileInfo.EndOfFile.QuadPart /
-        KeySizeInBytes
-    );
+    if (Is128Bit) {
+
+        //
+        // The original keys are 128-bit; the keys we hash are the reduced
+        // ULONG keys.
+        //
+
+        Keys->OriginalKeySizeType = XmmType;
+        Keys->KeySizeInBytes = sizeof(ULONG);
+
+        //
+        // Reduce the 128-bit keys to ULONG keys.  This will set the key array
+        // base address and number of elements.
+        //
+
+        Result = PerfectHashKeysLoad128(Keys);
+        if (FAILED(Result)) {
+            PH_ERROR(PerfectHashKeysLoad128, Result);
+            goto Error;
+        }
+
+    } else if (!KeysLoadFlags.StringKeys) {
+
+        if (KeysLoadFlags.TextKeys) {
+
+            //
+            // Parse the text keys.  This will set the key array base address
+            // and number of elements.
+            //
+
+            Result = PerfectHashKeysLoadText(Keys);
+            if (FAILED(Result)) {
+                PH_ERROR(PerfectHashKeysLoadText, Result);
+                goto Error;
+            }
+
+        } else if (IsCompressedKeysFile(File->BaseAddress,
+                                        File->FileInfo.EndOfFile.QuadPart)) {
+
+            //
+            // Decode the compressed keys.  This will set the key array base
+            // address and number of elements.
+            //
+
+            Result = PerfectHashKeysLoadCompressed(Keys);
+            if (FAILED(Result)) {
+                PH_ERROR(PerfectHashKeysLoadCompressed, Result);
+                goto Error;
+            }
+
+        } else {
+
+            Keys->KeyArrayBaseAddress = Keys->File->BaseAddress;
+
+            Keys->NumberOfElements.QuadPart = (
+                File->FileInfo.EndOfFile.QuadPart /
+                KeySizeInBytes
+            );
+        }
+
+        //
+        // If requested, sort the keys and remove duplicates.  This will update
+        // the key array base address and number of elements.  Compressed keys
+        // are always sorted and unique, so there's nothing to do for them.
+        //
+
+        if (KeysLoadFlags.SortKeys && !KeysWereCompressed(Keys)) {
+            Result = PerfectHashKeysSort(Keys);
+            if (FAILED(Result)) {
+                PH_ERROR(PerfectHashKeysSort, Result);
+                goto Error;
+            }
+        }
+
+    } else {
+
+        //
+        // Parse the string keys and reduce them to ULONG keys.  This will
+        // set the key array base address and number of elements.
+        //
+
+        Result = PerfectHashKeysLoadStrings(Keys);
+        if (FAILED(Result)) {
+            PH_ERROR(PerfectHashKeysLoadStrings, Result);
+            goto Error;
+        }
+    }
 
     //
     // Dispatch to the relevant LoadStats() routine.
@@ -323,6 +470,11 @@ Routine Description:
 
     Loads statistics about a set of 32-bit keys during initialization.
 
+    N.B. If the keys were projected from 64-bit keys, the key array is in the
+         original key order, and is thus not sorted.  The projection search
+         has already verified the keys are unique, so the sort check is
+         skipped, and the min/max values are tracked during enumeration.
+
 Arguments:
 
     Keys - Supplies a pointer to the PERFECT_HASH_KEYS structure for
@@ -362,6 +514,7 @@ Return Value:
     ULONG_PTR Trailing;
     ULONG_PTR NumberOfKeys;
     ULONG InvertedBitmap;
+    BOOLEAN Projected;
     RTL_BITMAP RtlBitmap;
     PERFECT_HASH_KEYS_STATS Stats;
     PPERFECT_HASH_KEYS_BITMAP KeysBitmap;
@@ -392,6 +545,7 @@ Return Value:
     Prev = (ULONG)-1;
     KeyArray = (PULONG)Keys->KeyArrayBaseAddress;
     NumberOfKeys = Keys->NumberOfElements.LowPart;
+    Projected = KeysWereProjected(Keys);
     KeysBitmap = &Stats.KeysBitmap;
 
     Stats.MinValue = (ULONG)-1;
@@ -410,7 +564,13 @@ Return Value:
     for (Index = 0; Index < NumberOfKeys; Index++) {
         Key = *Values++;
 
-        if (Index > 0) {
+        if (Projected) {
+            if (Key == 0) {
+                KeysBitmap->Flags.HasZero = TRUE;
+            }
+            Stats.MinValue = min(Stats.MinValue, Key);
+            Stats.MaxValue = max(Stats.MaxValue, Key);
+        } else if (Index > 0) {
             if (Prev > Key) {
                 return PH_E_KEYS_NOT_SORTED;
             } else if (Prev == Key) {
@@ -433,11 +593,14 @@ Return Value:
 
     //
     // We've verified the keys are sorted and unique, so we can obtain the
-    // min/max values from the start and end of the array.
+    // min/max values from the start and end of the array.  (Unless the keys
+    // were projected, in which case they were tracked above.)
     //
 
-    Stats.MinValue = KeyArray[0];
-    Stats.MaxValue = KeyArray[NumberOfKeys - 1];
+    if (!Projected) {
+        Stats.MinValue = KeyArray[0];
+        Stats.MaxValue = KeyArray[NumberOfKeys - 1];
+    }
 
     //
     // Set the linear flag if the array of keys represents a linear sequence of
@@ -579,6 +742,7 @@ Return Value:
     ULONGLONG InvertedBitmap;
     PALLOCATOR Allocator;
     PULONG DownsizedKeyArray = NULL;
+    KEY_DOWNSIZE_RUNS DownsizeRuns;
     RTL_BITMAP RtlBitmap;
     PERFECT_HASH_KEYS_STATS Stats;
     PPERFECT_HASH_KEYS_BITMAP KeysBitmap;
@@ -608,7 +772,7 @@ Return Value:
     ZeroStruct(Stats);
     Bitmap = 0;
     Prev = (ULONGLONG)-1;
-    KeyArray = (PULONGLONG)Keys->File->BaseAddress;
+    KeyArray = (PULONGLONG)Keys->KeyArrayBaseAddress;
     NumberOfKeys = Keys->NumberOfElements.QuadPart;
     KeysBitmap = &Stats.KeysBitmap;
 
@@ -736,18 +900,32 @@ Return Value:
 
         //
         // Loop through all of the keys again and downsize each one into its
-        // corresponding location in the newly-allocated array.
+        // corresponding location in the newly-allocated array.  If this CPU
+        // doesn't have a fast _pext_u64(), use the equivalent shift-and-mask
+        // sequence for the bitmap's runs instead (see KeyDownsizing.h).
         //
 
         Values = KeyArray;
 
-        for (Index = 0; Index < NumberOfKeys; Index++) {
-            Key = *Values++;
+        if (Rtl->CpuFeatures.Derived.FastPext != FALSE) {
 
-            DownsizedKey = _pext_u64(Key, Bitmap);
-            ASSERT(Rtl->LeadingZeros64(DownsizedKey) >= 32);
+            for (Index = 0; Index < NumberOfKeys; Index++) {
+                Key = *Values++;
 
-            DownsizedKeyArray[Index] = (ULONG)DownsizedKey;
+                DownsizedKey = _pext_u64(Key, Bitmap);
+                ASSERT(Rtl->LeadingZeros64(DownsizedKey) >= 32);
+
+                DownsizedKeyArray[Index] = (ULONG)DownsizedKey;
+            }
+
+        } else {
+
+            GetKeyDownsizeRuns(Rtl, Bitmap, &DownsizeRuns);
+
+            for (Index = 0; Index < NumberOfKeys; Index++) {
+                Key = *Values++;
+                DownsizedKeyArray[Index] = DownsizeKey(Key, &DownsizeRuns);
+            }
         }
 
         //
@@ -762,10 +940,10 @@ Return Value:
 
         //
         // Invariant check: our key array base address should always match the
-        // file's base address at this point.
+        // original key array's base address at this point.
         //
 
-        ASSERT(Keys->KeyArrayBaseAddress == Keys->File->BaseAddress);
+        ASSERT(Keys->KeyArrayBaseAddress == GetOriginalKeyArray(Keys));
 
         //
         // Update the array address to point at our new downsized array and
@@ -795,9 +973,44 @@ Return Value:
         goto End;
     }
 
+    //
+    // The keys can't be downsized via _pext_u64(); see if there's a 32-bit
+    // projection of them that is injective over the key set instead.
+    //
+
+    if (!DisableImplicitKeyDownsizing(Keys)) {
+
+        Result = PerfectHashKeysTryProject64(Keys);
+        if (FAILED(Result)) {
+            PH_ERROR(PerfectHashKeysTryProject64, Result);
+            goto Error;
+        }
+
+        if (Result == S_OK) {
+
+            //
+            // The keys were projected.  As above, run the 32-bit load stats
+            // routine, which takes precedence now that we've downsized our
+            // keys.
+            //
+
+            Result = PerfectHashKeysLoadStats32(Keys);
+            if (FAILED(Result)) {
+                PH_ERROR(PerfectHashKeysLoadStats32_Projected, Result);
+                goto Error;
+            }
+
+            goto End;
+        }
+
+        ASSERT(Result == PH_S_NO_KEY_PROJECTION_FOUND);
+        Result = S_OK;
+    }
+
     //
     // If we get to this point, no key downsizing has been performed.  That is,
-    // the bitmap of all key bit values has less than 32 zeros present in it.
+    // the bitmap of all key bit values has less than 32 zeros present in it,
+    // and no injective projection of the keys was found.
     // Continue with the normal stats finalization.
     //
 
@@ -0,0 +1,277 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    PerfectHashKeysLoad128.c
+
+Abstract:
+
+    This module implements the 128-bit keys load routine for the perfect hash
+    library's PERFECT_HASH_KEYS component.  It is called by the keys Load()
+    routine when the key size is 16 bytes, and is responsible for validating
+    the 128-bit keys, reducing each key to a unique 32-bit key, and capturing
+    the original keys in key array order such that they can be embedded in the
+    compiled perfect hash table.
+
+    See Keys128.h for a description of the file format, and ReducedKeys.h for
+    a description of the reduction.
+
+--*/
+
+#include "stdafx.h"
+
+PERFECT_HASH_KEYS_LOAD_128 PerfectHashKeysLoad128;
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashKeysLoad128(
+    PPERFECT_HASH_KEYS Keys
+    )
+/*++
+
+Routine Description:
+
+    Loads 128-bit keys from a keys file that has been mapped into memory.
+    Each key is reduced to a 32-bit key via HashKey128(); thus, 128-bit keys
+    are a capped reduced-key mode rather than native 128-bit support.  The
+    reduced keys are sorted, and if any two keys reduce to the same 32-bit
+    key, the next seed in the reduced key seed sequence is tried.  On success,
+    the key array is the sorted array of reduced keys, and the 128-bit key
+    array holds the original keys in the same order.
+
+Arguments:
+
+    Keys - Supplies a pointer to the PERFECT_HASH_KEYS structure for which the
+        128-bit keys are to be loaded.  Keys->File must have been loaded.
+
+Return Value:
+
+    S_OK - Success.
+
+    E_POINTER - Keys was NULL.
+
+    E_OUTOFMEMORY - Out of memory.
+
+    PH_E_TOO_MANY_KEYS - The keys file was too large.
+
+    PH_E_TOO_MANY_KEYS128 - The keys file contained more than
+        REDUCED_KEY_MAXIMUM_NUMBER_OF_KEYS keys.
+
+    PH_E_KEYS_FILE_SIZE_NOT_MULTIPLE_OF_KEY_SIZE - The keys file size was not
+        a multiple of 16 bytes.
+
+    PH_E_KEYS_NOT_SORTED - The 128-bit keys were not sorted.
+
+    PH_E_DUPLICATE_KEYS_DETECTED - Duplicate 128-bit keys were detected.
+
+    PH_E_KEYS128_HASH_COLLISIONS - No seed in the reduced key seed sequence
+        reduced every 128-bit key to a unique 32-bit key.
+
+--*/
+{
+    LONG Comparison;
+    ULONG Seed;
+    ULONG Key;
+    ULONG Index;
+    ULONG Attempt;
+    ULONG Ordinal;
+    ULONG NumberOfKeys;
+    BOOLEAN Collision;
+    PKEY128 Source;
+    HRESULT Result = S_OK;
+    PALLOCATOR Allocator;
+    PPERFECT_HASH_FILE File;
+    PULONG KeyArray = NULL;
+    PKEY128 Key128Array = NULL;
+    PULONGLONG Pairs = NULL;
+    PULONGLONG Temp = NULL;
+    ULARGE_INTEGER NumberOfElements;
+
+    //
+    // Validate arguments.
+    //
+
+    if (!ARGUMENT_PRESENT(Keys)) {
+        return E_POINTER;
+    }
+
+    File = Keys->File;
+    Allocator = Keys->Allocator;
+    Source = (PKEY128)File->BaseAddress;
+
+    //
+    // Validate the file size and derive the number of keys.  Key ordinals are
+    // 32-bit, so there can't be more than MAX_ULONG keys.
+    //
+
+    if ((File->FileInfo.EndOfFile.QuadPart % sizeof(KEY128)) != 0) {
+        return PH_E_KEYS_FILE_SIZE_NOT_MULTIPLE_OF_KEY_SIZE;
+    }
+
+    NumberOfElements.QuadPart = (
+        File->FileInfo.EndOfFile.QuadPart / sizeof(KEY128)
+    );
+
+    if (NumberOfElements.HighPart != 0) {
+        return PH_E_TOO_MANY_KEYS;
+    }
+
+    NumberOfKeys = NumberOfElements.LowPart;
+
+    //
+    // The reduction is only practical for a bounded number of keys (see
+    // ReducedKeys.h), so reject larger key sets up front.
+    //
+
+    if (NumberOfKeys > REDUCED_KEY_MAXIMUM_NUMBER_OF_KEYS) {
+        return PH_E_TOO_MANY_KEYS128;
+    }
+
+    //
+    // Verify the keys are sorted and unique.  This is the same requirement
+    // imposed on 32-bit and 64-bit keys files.
+    //
+
+    for (Index = 1; Index < NumberOfKeys; Index++) {
+        Comparison = CompareKey128(&Source[Index - 1], &Source[Index]);
+        if (Comparison > 0) {
+            return PH_E_KEYS_NOT_SORTED;
+        } else if (Comparison == 0) {
+            return PH_E_DUPLICATE_KEYS_DETECTED;
+        }
+    }
+
+    //
+    // Allocate the working arrays.
+    //
+
+    Pairs = Allocator->Vtbl->Calloc(Allocator, NumberOfKeys, sizeof(*Pairs));
+    if (!Pairs) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    Temp = Allocator->Vtbl->Calloc(Allocator, NumberOfKeys, sizeof(*Temp));
+    if (!Temp) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    //
+    // Reduce each key to a 32-bit key, sort the reduced keys, and check for
+    // any collisions.  The keys are unique, so any collision means we need
+    // to try the next seed.
+    //
+
+    Seed = 0;
+    Collision = TRUE;
+
+    for (Attempt = 0;
+         Collision && Attempt < REDUCED_KEY_MAXIMUM_SEED_ATTEMPTS;
+         Attempt++) {
+
+        Seed = GetReducedKeySeed(Attempt);
+        Collision = FALSE;
+
+        for (Index = 0; Index < NumberOfKeys; Index++) {
+            Key = HashKey128(&Source[Index], Seed);
+            Pairs[Index] = REDUCED_KEY_PAIR(Key, Index);
+        }
+
+        SortReducedKeyPairs(Pairs, Temp, NumberOfKeys);
+
+        for (Index = 1; Index < NumberOfKeys; Index++) {
+            if (REDUCED_KEY_PAIR_KEY(Pairs[Index - 1]) ==
+                REDUCED_KEY_PAIR_KEY(Pairs[Index])) {
+                Collision = TRUE;
+                break;
+            }
+        }
+    }
+
+    if (Collision) {
+        Result = PH_E_KEYS128_HASH_COLLISIONS;
+        goto Error;
+    }
+
+    //
+    // Allocate the final arrays.
+    //
+
+    KeyArray = Allocator->Vtbl->Calloc(Allocator,
+                                       NumberOfKeys,
+                                       sizeof(*KeyArray));
+    if (!KeyArray) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    Key128Array = Allocator->Vtbl->Calloc(Allocator,
+                                          NumberOfKeys,
+                                          sizeof(*Key128Array));
+    if (!Key128Array) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    //
+    // Write the reduced keys and original keys in sorted order.
+    //
+
+    for (Index = 0; Index < NumberOfKeys; Index++) {
+        Ordinal = REDUCED_KEY_PAIR_ORDINAL(Pairs[Index]);
+        KeyArray[Index] = REDUCED_KEY_PAIR_KEY(Pairs[Index]);
+        Key128Array[Index].Low = Source[Ordinal].Low;
+        Key128Array[Index].High = Source[Ordinal].High;
+    }
+
+    //
+    // Update the keys instance and clear the local pointers such that they
+    // aren't freed below.  The rundown routine takes care of them now.
+    //
+
+    Keys->KeyArrayBaseAddress = KeyArray;
+    Keys->NumberOfElements.QuadPart = NumberOfKeys;
+    Keys->ReducedKeySeed = Seed;
+    Keys->Key128Array = Key128Array;
+    Keys->Flags.Keys128 = TRUE;
+
+    KeyArray = NULL;
+    Key128Array = NULL;
+
+    goto End;
+
+Error:
+
+    if (Result == S_OK) {
+        Result = E_UNEXPECTED;
+    }
+
+    //
+    // Intentional follow-on to End.
+    //
+
+End:
+
+    if (Pairs) {
+        Allocator->Vtbl->FreePointer(Allocator, &Pairs);
+    }
+
+    if (Temp) {
+        Allocator->Vtbl->FreePointer(Allocator, &Temp);
+    }
+
+    if (KeyArray) {
+        Allocator->Vtbl->FreePointer(Allocator, &KeyArray);
+    }
+
+    if (Key128Array) {
+        Allocator->Vtbl->FreePointer(Allocator, &Key128Array);
+    }
+
+    return Result;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
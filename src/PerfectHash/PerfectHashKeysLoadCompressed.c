@@ -0,0 +1,734 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    PerfectHashKeysLoadCompressed.c
+
+Abstract:
+
+    This module implements the compressed keys load routine for the perfect
+    hash library's PERFECT_HASH_KEYS component, and the routine that writes
+    compressed keys files.
+
+    The load routine is called by the keys Load() routine when the keys file
+    starts with the compressed keys magic number.  It decodes the keys into
+    an array of ULONG or ULONGLONG keys, which is then treated identically to
+    the key array of an uncompressed keys file.  The blocks of the file are
+    split into a number of partitions, which are decoded in parallel.
+
+    See CompressedKeys.h for a description of the file format.
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Key sets smaller than the following number of keys per partition are not
+// worth the overhead of splitting over threadpool threads.  The number of
+// partitions is capped at the second constant.
+//
+
+#define COMPRESSED_KEYS_MINIMUM_KEYS_PER_PARTITION (1 << 20)
+#define COMPRESSED_KEYS_MAXIMUM_PARTITIONS 64
+
+//
+// Define the state shared by the partitions of a compressed keys load.
+//
+
+typedef struct _COMPRESSED_KEYS_LOAD {
+
+    //
+    // Compressed keys file header.
+    //
+
+    PCOMPRESSED_KEYS_HEADER Header;
+
+    //
+    // Key array the keys are decoded into.
+    //
+
+    PVOID KeyArray;
+
+    //
+    // Number of partitions, and the index of the next partition to be
+    // processed by a threadpool callback.
+    //
+
+    ULONG NumberOfPartitions;
+    volatile LONG NextPartition;
+
+    //
+    // Result of decoding each partition.
+    //
+
+    HRESULT Results[COMPRESSED_KEYS_MAXIMUM_PARTITIONS];
+
+} COMPRESSED_KEYS_LOAD;
+typedef COMPRESSED_KEYS_LOAD *PCOMPRESSED_KEYS_LOAD;
+
+TP_WORK_CALLBACK CompressedKeysWorkCallback;
+PERFECT_HASH_KEYS_LOAD_COMPRESSED PerfectHashKeysLoadCompressed;
+PERFECT_HASH_KEYS_SAVE_COMPRESSED PerfectHashKeysSaveCompressed;
+
+FORCEINLINE
+VOID
+DecodeCompressedKeysPartition(
+    _In_ PCOMPRESSED_KEYS_LOAD Load,
+    _In_ ULONG Index
+    )
+/*++
+
+Routine Description:
+
+    Decodes the blocks of a single partition of a compressed keys file into
+    the key array.
+
+Arguments:
+
+    Load - Supplies a pointer to the compressed keys load state.
+
+    Index - Supplies the index of the partition to decode.
+
+Return Value:
+
+    None.  The result is written to Load->Results[Index].
+
+--*/
+{
+    PBYTE Dest;
+    ULONG KeySizeInBytes;
+    ULONGLONG BlockIndex;
+    ULONGLONG FirstBlock;
+    ULONGLONG EndBlock;
+    ULONGLONG NumberOfBlocks;
+    ULONGLONG NumberOfBlockKeys;
+    PULONGLONG Words;
+    PCOMPRESSED_KEYS_BLOCK Blocks;
+    PCOMPRESSED_KEYS_HEADER Header;
+
+    ASSERT(Index < Load->NumberOfPartitions);
+
+    Header = Load->Header;
+    Blocks = GetCompressedKeysBlocks(Header);
+    Words = GetCompressedKeysWords(Header);
+    KeySizeInBytes = Header->KeySizeInBytes;
+    NumberOfBlocks = Header->NumberOfBlocks;
+
+    FirstBlock = (NumberOfBlocks * Index) / Load->NumberOfPartitions;
+    EndBlock = (NumberOfBlocks * (Index + 1)) / Load->NumberOfPartitions;
+
+    for (BlockIndex = FirstBlock; BlockIndex < EndBlock; BlockIndex++) {
+
+        NumberOfBlockKeys = GetCompressedKeysNumberOfBlockKeys(Header,
+                                                               BlockIndex);
+
+        Dest = (PBYTE)Load->KeyArray + (
+            BlockIndex * Header->KeysPerBlock * KeySizeInBytes
+        );
+
+        if (!DecodeCompressedKeysBlock(&Blocks[BlockIndex],
+                                       Words,
+                                       Header->NumberOfWords,
+                                       KeySizeInBytes,
+                                       NumberOfBlockKeys,
+                                       Dest)) {
+            Load->Results[Index] = PH_E_INVALID_COMPRESSED_KEYS_FILE;
+            return;
+        }
+    }
+
+    Load->Results[Index] = S_OK;
+}
+
+_Use_decl_annotations_
+VOID
+CompressedKeysWorkCallback(
+    PTP_CALLBACK_INSTANCE Instance,
+    PVOID Context,
+    PTP_WORK Work
+    )
+/*++
+
+Routine Description:
+
+    This is the threadpool work callback for the compressed keys load.  It is
+    submitted once per partition; each invocation claims the next undecoded
+    partition and decodes it.
+
+Arguments:
+
+    Instance - Supplies a pointer to the callback instance responsible for this
+        threadpool callback invocation.
+
+    Context - Supplies a pointer to the COMPRESSED_KEYS_LOAD structure.
+
+    Work - Supplies a pointer to the TP_WORK object for this routine.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ULONG Index;
+    PCOMPRESSED_KEYS_LOAD Load;
+
+    UNREFERENCED_PARAMETER(Instance);
+    UNREFERENCED_PARAMETER(Work);
+
+    Load = (PCOMPRESSED_KEYS_LOAD)Context;
+    Index = (ULONG)InterlockedIncrement(&Load->NextPartition) - 1;
+
+    DecodeCompressedKeysPartition(Load, Index);
+}
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashKeysLoadCompressed(
+    PPERFECT_HASH_KEYS Keys
+    )
+/*++
+
+Routine Description:
+
+    Loads keys from a compressed keys file that has been mapped into memory.
+    The keys are decoded into a new array of the key size.
+
+Arguments:
+
+    Keys - Supplies a pointer to the PERFECT_HASH_KEYS structure for which the
+        compressed keys are to be loaded.  Keys->File must have been loaded,
+        and must start with the compressed keys magic number.
+
+Return Value:
+
+    S_OK - Success.
+
+    E_POINTER - Keys was NULL.
+
+    E_OUTOFMEMORY - Out of memory.
+
+    PH_E_INVALID_KEY_SIZE - The key size did not match the key size of the
+        compressed keys file.
+
+    PH_E_INVALID_COMPRESSED_KEYS_FILE - The compressed keys file was
+        malformed.
+
+    PH_E_SYSTEM_CALL_FAILED - A system call failed.
+
+--*/
+{
+    PRTL Rtl;
+    ULONG Index;
+    ULONG KeySizeInBytes;
+    ULONG NumberOfProcessors;
+    ULONGLONG Offset;
+    ULONGLONG SizeInBytes;
+    ULONGLONG ExpectedSizeInBytes;
+    ULONGLONG NumberOfKeys;
+    ULONGLONG NumberOfBlocks;
+    ULONGLONG BlockIndex;
+    ULONGLONG Prev;
+    ULONGLONG Key;
+    BOOLEAN LargePages;
+    HRESULT Result = S_OK;
+    PTP_WORK Work = NULL;
+    PPERFECT_HASH_FILE File;
+    PCOMPRESSED_KEYS_HEADER Header;
+    PCOMPRESSED_KEYS_LOAD Load = NULL;
+    PVOID KeyArray = NULL;
+
+    //
+    // Validate arguments.
+    //
+
+    if (!ARGUMENT_PRESENT(Keys)) {
+        return E_POINTER;
+    }
+
+    Rtl = Keys->Rtl;
+    File = Keys->File;
+    SizeInBytes = (ULONGLONG)File->FileInfo.EndOfFile.QuadPart;
+    Header = (PCOMPRESSED_KEYS_HEADER)File->BaseAddress;
+
+    if (!IsCompressedKeysFile(Header, SizeInBytes)) {
+        return PH_E_INVALID_COMPRESSED_KEYS_FILE;
+    }
+
+    //
+    // Validate the header.  The block and word counts are checked against the
+    // file size before they're used to compute it, such that it can't
+    // overflow.
+    //
+
+    KeySizeInBytes = Header->KeySizeInBytes;
+    NumberOfKeys = Header->NumberOfKeys;
+    NumberOfBlocks = Header->NumberOfBlocks;
+
+    if (Header->SizeOfStruct != sizeof(*Header) ||
+        Header->Version != COMPRESSED_KEYS_VERSION ||
+        Header->KeysPerBlock == 0 ||
+        Header->KeysPerBlock > COMPRESSED_KEYS_MAXIMUM_KEYS_PER_BLOCK ||
+        NumberOfKeys == 0 ||
+        NumberOfBlocks > SizeInBytes / sizeof(COMPRESSED_KEYS_BLOCK) ||
+        Header->NumberOfWords > SizeInBytes / sizeof(ULONGLONG) ||
+        NumberOfBlocks != (
+            (NumberOfKeys + Header->KeysPerBlock - 1) / Header->KeysPerBlock
+        )) {
+        return PH_E_INVALID_COMPRESSED_KEYS_FILE;
+    }
+
+    if (KeySizeInBytes != sizeof(ULONG) &&
+        KeySizeInBytes != sizeof(ULONGLONG)) {
+        return PH_E_INVALID_COMPRESSED_KEYS_FILE;
+    }
+
+    if (KeySizeInBytes != Keys->OriginalKeySizeInBytes) {
+        return PH_E_INVALID_KEY_SIZE;
+    }
+
+    ExpectedSizeInBytes = (
+        sizeof(*Header) +
+        (NumberOfBlocks * sizeof(COMPRESSED_KEYS_BLOCK)) +
+        (Header->NumberOfWords * sizeof(ULONGLONG))
+    );
+
+    if (ExpectedSizeInBytes != SizeInBytes) {
+        return PH_E_INVALID_COMPRESSED_KEYS_FILE;
+    }
+
+    Load = Keys->Allocator->Vtbl->Calloc(Keys->Allocator, 1, sizeof(*Load));
+    if (!Load) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    Load->Header = Header;
+
+    //
+    // Allocate the key array, trying large pages if the caller requested them
+    // for keys data.
+    //
+
+    LargePages = (Keys->LoadFlags.TryLargePagesForKeysData != FALSE);
+
+    KeyArray = Rtl->Vtbl->TryLargePageVirtualAlloc(
+        Rtl,
+        NULL,
+        (SIZE_T)(NumberOfKeys * KeySizeInBytes),
+        MEM_RESERVE | MEM_COMMIT,
+        PAGE_READWRITE,
+        &LargePages
+    );
+
+    if (!KeyArray) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    Load->KeyArray = KeyArray;
+
+    //
+    // Determine the number of partitions, then decode them, in parallel if
+    // there's more than one.
+    //
+
+    NumberOfProcessors = GetMaximumProcessorCount(ALL_PROCESSOR_GROUPS);
+
+    Load->NumberOfPartitions = (ULONG)min(
+        min(NumberOfKeys / COMPRESSED_KEYS_MINIMUM_KEYS_PER_PARTITION,
+            (ULONGLONG)NumberOfProcessors),
+        min(NumberOfBlocks, COMPRESSED_KEYS_MAXIMUM_PARTITIONS)
+    );
+
+    if (Load->NumberOfPartitions <= 1) {
+
+        Load->NumberOfPartitions = 1;
+        DecodeCompressedKeysPartition(Load, 0);
+
+    } else {
+
+        Work = CreateThreadpoolWork(CompressedKeysWorkCallback, Load, NULL);
+        if (!Work) {
+            SYS_ERROR(CreateThreadpoolWork);
+            Result = PH_E_SYSTEM_CALL_FAILED;
+            goto Error;
+        }
+
+        for (Index = 0; Index < Load->NumberOfPartitions; Index++) {
+            SubmitThreadpoolWork(Work);
+        }
+
+        WaitForThreadpoolWorkCallbacks(Work, FALSE);
+    }
+
+    for (Index = 0; Index < Load->NumberOfPartitions; Index++) {
+        if (FAILED(Load->Results[Index])) {
+            Result = Load->Results[Index];
+            goto Error;
+        }
+    }
+
+    //
+    // Each block's keys are strictly increasing; verify the same holds across
+    // block boundaries.
+    //
+
+    for (BlockIndex = 1; BlockIndex < NumberOfBlocks; BlockIndex++) {
+
+        Offset = BlockIndex * Header->KeysPerBlock;
+
+        if (KeySizeInBytes == sizeof(ULONG)) {
+            Prev = ((PULONG)KeyArray)[Offset - 1];
+            Key = ((PULONG)KeyArray)[Offset];
+        } else {
+            Prev = ((PULONGLONG)KeyArray)[Offset - 1];
+            Key = ((PULONGLONG)KeyArray)[Offset];
+        }
+
+        if (Key <= Prev) {
+            Result = PH_E_INVALID_COMPRESSED_KEYS_FILE;
+            goto Error;
+        }
+    }
+
+    //
+    // Update the keys instance and clear the local pointer such that it isn't
+    // freed below.  The rundown routine takes care of it now.
+    //
+
+    Keys->KeyArrayBaseAddress = KeyArray;
+    Keys->OriginalKeyArray = KeyArray;
+    Keys->NumberOfElements.QuadPart = NumberOfKeys;
+    Keys->Flags.KeysDataUsesLargePages = LargePages;
+    Keys->Flags.KeysCompressed = TRUE;
+
+    KeyArray = NULL;
+
+    goto End;
+
+Error:
+
+    if (Result == S_OK) {
+        Result = E_UNEXPECTED;
+    }
+
+    //
+    // Intentional follow-on to End.
+    //
+
+End:
+
+    if (Work) {
+        CloseThreadpoolWork(Work);
+        Work = NULL;
+    }
+
+    if (Load) {
+        Keys->Allocator->Vtbl->FreePointer(Keys->Allocator, &Load);
+    }
+
+    if (KeyArray) {
+        if (!VirtualFree(KeyArray, 0, MEM_RELEASE)) {
+            SYS_ERROR(VirtualFree);
+        }
+        KeyArray = NULL;
+    }
+
+    return Result;
+}
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashKeysSaveCompressed(
+    PPERFECT_HASH_KEYS Keys,
+    PPERFECT_HASH_DIRECTORY Directory
+    )
+/*++
+
+Routine Description:
+
+    Writes a compressed copy of a loaded keys instance to a directory.  The
+    compressed keys file has the same file name as the keys file.
+
+Arguments:
+
+    Keys - Supplies a pointer to a loaded keys instance.  The keys must be
+        32-bit or 64-bit, sorted and unique.
+
+    Directory - Supplies a pointer to the directory to write the compressed
+        keys file to.
+
+Return Value:
+
+    S_OK - Success.
+
+    E_POINTER - Keys or Directory was NULL.
+
+    E_OUTOFMEMORY - Out of memory.
+
+    PH_E_KEYS_NOT_LOADED - The keys have not been loaded.
+
+    PH_E_KEYS_NOT_COMPRESSIBLE - The keys were string or 128-bit keys.
+
+    PH_E_KEYS_NOT_SORTED - The keys were not sorted.
+
+    PH_E_DUPLICATE_KEYS_DETECTED - Duplicate keys were detected.
+
+    PH_E_COMPRESSED_KEYS_PATH_IS_KEYS_PATH - The compressed keys file would
+        overwrite the keys file.
+
+--*/
+{
+    PRTL Rtl;
+    PBYTE KeyBytes;
+    PBYTE BlockKeys;
+    ULONG KeySizeInBytes;
+    ULONG KeysPerBlock;
+    ULONGLONG Key;
+    ULONGLONG Prev;
+    ULONGLONG Delta;
+    ULONGLONG MaximumDelta;
+    ULONGLONG KeyIndex;
+    ULONGLONG BlockIndex;
+    ULONGLONG NumberOfKeys;
+    ULONGLONG NumberOfBlocks;
+    ULONGLONG NumberOfWords;
+    ULONGLONG NumberOfBlockKeys;
+    PULONGLONG Words;
+    PULONGLONG Dest;
+    HRESULT Result = S_OK;
+    LARGE_INTEGER EndOfFile;
+    PPERFECT_HASH_PATH Path = NULL;
+    PPERFECT_HASH_FILE File = NULL;
+    PCOMPRESSED_KEYS_BLOCK Block;
+    PCOMPRESSED_KEYS_BLOCK Blocks = NULL;
+    PCOMPRESSED_KEYS_HEADER Header;
+
+    //
+    // Validate arguments.
+    //
+
+    if (!ARGUMENT_PRESENT(Keys)) {
+        return E_POINTER;
+    }
+
+    if (!ARGUMENT_PRESENT(Directory)) {
+        return E_POINTER;
+    }
+
+    if (!IsLoadedKeys(Keys)) {
+        return PH_E_KEYS_NOT_LOADED;
+    }
+
+    if (KeysWereReduced(Keys)) {
+        return PH_E_KEYS_NOT_COMPRESSIBLE;
+    }
+
+    Rtl = Keys->Rtl;
+    KeySizeInBytes = Keys->OriginalKeySizeInBytes;
+    KeyBytes = (PBYTE)GetOriginalKeyArray(Keys);
+    NumberOfKeys = Keys->NumberOfElements.QuadPart;
+    KeysPerBlock = COMPRESSED_KEYS_KEYS_PER_BLOCK;
+    NumberOfBlocks = (NumberOfKeys + KeysPerBlock - 1) / KeysPerBlock;
+
+    ASSERT(KeySizeInBytes == sizeof(ULONG) ||
+           KeySizeInBytes == sizeof(ULONGLONG));
+
+    Blocks = Keys->Allocator->Vtbl->Calloc(Keys->Allocator,
+                                           (SIZE_T)NumberOfBlocks,
+                                           sizeof(*Blocks));
+    if (!Blocks) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    //
+    // Determine the number of bits per delta and word offset of each block,
+    // verifying the keys are sorted and unique as we go.
+    //
+
+    Prev = 0;
+    NumberOfWords = 0;
+
+    for (BlockIndex = 0; BlockIndex < NumberOfBlocks; BlockIndex++) {
+
+        Block = &Blocks[BlockIndex];
+        KeyIndex = BlockIndex * KeysPerBlock;
+        NumberOfBlockKeys = min(KeysPerBlock, NumberOfKeys - KeyIndex);
+        MaximumDelta = 0;
+
+        for (; NumberOfBlockKeys > 0; NumberOfBlockKeys--, KeyIndex++) {
+
+            if (KeySizeInBytes == sizeof(ULONG)) {
+                Key = ((PULONG)KeyBytes)[KeyIndex];
+            } else {
+                Key = ((PULONGLONG)KeyBytes)[KeyIndex];
+            }
+
+            if (KeyIndex > 0) {
+                if (Key < Prev) {
+                    Result = PH_E_KEYS_NOT_SORTED;
+                    goto Error;
+                } else if (Key == Prev) {
+                    Result = PH_E_DUPLICATE_KEYS_DETECTED;
+                    goto Error;
+                }
+            }
+
+            if (KeyIndex == BlockIndex * KeysPerBlock) {
+                Block->FirstKey = Key;
+            } else {
+                Delta = Key - Prev - 1;
+                MaximumDelta = max(MaximumDelta, Delta);
+            }
+
+            Prev = Key;
+        }
+
+        Block->BitsPerDelta = GetCompressedKeysBitsPerDelta(MaximumDelta);
+        Block->WordOffset = NumberOfWords;
+
+        NumberOfWords += GetCompressedKeysBlockNumberOfWords(
+            min(KeysPerBlock, NumberOfKeys - (BlockIndex * KeysPerBlock)),
+            Block->BitsPerDelta
+        );
+    }
+
+    //
+    // Create the path of the compressed keys file, which is the keys file
+    // name in the given directory.  Refuse to overwrite the keys file.
+    //
+
+    Result = Keys->Vtbl->CreateInstance(Keys,
+                                        NULL,
+                                        &IID_PERFECT_HASH_PATH,
+                                        &Path);
+
+    if (FAILED(Result)) {
+        PH_ERROR(PerfectHashPathCreateInstance, Result);
+        goto Error;
+    }
+
+    Result = Path->Vtbl->Create(Path,
+                                Keys->File->Path,
+                                &Directory->Path->FullPath, // NewDirectory
+                                NULL,                       // DirectorySuffix
+                                NULL,                       // NewBaseName
+                                NULL,                       // BaseNameSuffix
+                                NULL,                       // NewExtension
+                                NULL,                       // NewStreamName
+                                NULL,                       // Parts
+                                NULL);                      // Reserved
+
+    if (FAILED(Result)) {
+        PH_ERROR(PerfectHashKeysSaveCompressed_PathCreate, Result);
+        goto Error;
+    }
+
+    if (Rtl->RtlEqualUnicodeString(&Path->FullPath,
+                                   &Keys->File->Path->FullPath,
+                                   TRUE)) {
+        Result = PH_E_COMPRESSED_KEYS_PATH_IS_KEYS_PATH;
+        goto Error;
+    }
+
+    //
+    // Create the file at its final size, then write the header, the block
+    // index, and the packed deltas of each block.
+    //
+
+    Result = Keys->Vtbl->CreateInstance(Keys,
+                                        NULL,
+                                        &IID_PERFECT_HASH_FILE,
+                                        &File);
+
+    if (FAILED(Result)) {
+        PH_ERROR(PerfectHashFileCreateInstance, Result);
+        goto Error;
+    }
+
+    EndOfFile.QuadPart = (LONGLONG)(
+        sizeof(*Header) +
+        (NumberOfBlocks * sizeof(*Blocks)) +
+        (NumberOfWords * sizeof(ULONGLONG))
+    );
+
+    Result = File->Vtbl->Create(File, Path, &EndOfFile, NULL, NULL);
+
+    if (FAILED(Result)) {
+        PH_ERROR(PerfectHashKeysSaveCompressed_FileCreate, Result);
+        goto Error;
+    }
+
+    Header = (PCOMPRESSED_KEYS_HEADER)File->BaseAddress;
+    Header->Magic = COMPRESSED_KEYS_MAGIC;
+    Header->SizeOfStruct = sizeof(*Header);
+    Header->Version = COMPRESSED_KEYS_VERSION;
+    Header->KeySizeInBytes = KeySizeInBytes;
+    Header->KeysPerBlock = KeysPerBlock;
+    Header->NumberOfKeys = NumberOfKeys;
+    Header->NumberOfBlocks = NumberOfBlocks;
+    Header->NumberOfWords = NumberOfWords;
+
+    CopyMemory(GetCompressedKeysBlocks(Header),
+               Blocks,
+               (SIZE_T)(NumberOfBlocks * sizeof(*Blocks)));
+
+    Words = GetCompressedKeysWords(Header);
+
+    for (BlockIndex = 0; BlockIndex < NumberOfBlocks; BlockIndex++) {
+
+        Block = &Blocks[BlockIndex];
+        KeyIndex = BlockIndex * KeysPerBlock;
+        NumberOfBlockKeys = min(KeysPerBlock, NumberOfKeys - KeyIndex);
+        BlockKeys = KeyBytes + (KeyIndex * KeySizeInBytes);
+
+        Dest = EncodeCompressedKeysBlock(BlockKeys,
+                                         KeySizeInBytes,
+                                         NumberOfBlockKeys,
+                                         Block->BitsPerDelta,
+                                         Words + Block->WordOffset);
+
+        ASSERT(Dest == Words + Block->WordOffset + (
+            GetCompressedKeysBlockNumberOfWords(NumberOfBlockKeys,
+                                                Block->BitsPerDelta)
+        ));
+    }
+
+    File->NumberOfBytesWritten.QuadPart = EndOfFile.QuadPart;
+
+    Result = File->Vtbl->Close(File, &EndOfFile);
+
+    if (FAILED(Result)) {
+        PH_ERROR(PerfectHashKeysSaveCompressed_FileClose, Result);
+        goto Error;
+    }
+
+    goto End;
+
+Error:
+
+    if (Result == S_OK) {
+        Result = E_UNEXPECTED;
+    }
+
+    //
+    // Intentional follow-on to End.
+    //
+
+End:
+
+    RELEASE(File);
+    RELEASE(Path);
+
+    if (Blocks) {
+        Keys->Allocator->Vtbl->FreePointer(Keys->Allocator, &Blocks);
+    }
+
+    return Result;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
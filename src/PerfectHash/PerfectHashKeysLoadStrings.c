@@ -0,0 +1,371 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    PerfectHashKeysLoadStrings.c
+
+Abstract:
+
+    This module implements the string keys load routine for the perfect hash
+    library's PERFECT_HASH_KEYS component.  It is called by the keys Load()
+    routine when the StringKeys keys load flag is set, and is responsible for
+    parsing the length-prefixed string keys file, reducing each string to a
+    unique 32-bit key, and capturing the string data in key array order such
+    that it can be embedded in the compiled perfect hash table.
+
+    See StringKeys.h for a description of the file format, and ReducedKeys.h
+    for a description of the reduction.
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Helper macro for obtaining the length of the string whose bytes start at
+// the given offset of the string keys file (the length prefix immediately
+// precedes the bytes).
+//
+
+#define STRING_KEY_LENGTH(Base, Offset)                                       \
+    ((ULONG)*((USHORT UNALIGNED *)RtlOffsetToPointer(                         \
+        (Base),                                                               \
+        (Offset) - STRING_KEY_LENGTH_PREFIX_SIZE_IN_BYTES                     \
+    )))
+
+PERFECT_HASH_KEYS_LOAD_STRINGS PerfectHashKeysLoadStrings;
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashKeysLoadStrings(
+    PPERFECT_HASH_KEYS Keys
+    )
+/*++
+
+Routine Description:
+
+    Loads string keys from a keys file that has been mapped into memory.  Each
+    string is reduced to a 32-bit key via HashStringKey().  The reduced keys
+    are sorted, and if any two strings reduce to the same key, the next seed
+    in the string key seed sequence is tried.  On success, the key array is
+    the sorted array of reduced keys, and the string data is captured in the
+    same order.
+
+Arguments:
+
+    Keys - Supplies a pointer to the PERFECT_HASH_KEYS structure for which the
+        string keys are to be loaded.  Keys->File must have been loaded.
+
+Return Value:
+
+    S_OK - Success.
+
+    E_POINTER - Keys was NULL.
+
+    E_OUTOFMEMORY - Out of memory.
+
+    PH_E_TOO_MANY_KEYS - The keys file was too large.
+
+    PH_E_INVALID_STRING_KEYS_FILE - The keys file was malformed or empty.
+
+    PH_E_TOO_MANY_STRING_KEYS - The keys file contained more than
+        REDUCED_KEY_MAXIMUM_NUMBER_OF_KEYS string keys.
+
+    PH_E_DUPLICATE_KEYS_DETECTED - Duplicate string keys were detected.
+
+    PH_E_STRING_KEYS_HASH_COLLISIONS - No seed in the string key seed sequence
+        reduced every string key to a unique 32-bit key.
+
+--*/
+{
+    PRTL Rtl;
+    PBYTE Base;
+    PBYTE Data;
+    ULONG Seed;
+    ULONG Key;
+    ULONG Index;
+    ULONG Offset;
+    ULONG Length;
+    ULONG Attempt;
+    ULONG Ordinal;
+    ULONG Previous;
+    ULONG DataSize;
+    ULONG EndOfFile;
+    ULONG NumberOfKeys;
+    BOOLEAN Collision;
+    HRESULT Result = S_OK;
+    PALLOCATOR Allocator;
+    PPERFECT_HASH_FILE File;
+    PULONG KeyArray = NULL;
+    PULONG Offsets = NULL;
+    PULONG SourceOffsets = NULL;
+    PULONGLONG Pairs = NULL;
+    PULONGLONG Temp = NULL;
+    PBYTE StringKeyData = NULL;
+
+    //
+    // Validate arguments.
+    //
+
+    if (!ARGUMENT_PRESENT(Keys)) {
+        return E_POINTER;
+    }
+
+    Rtl = Keys->Rtl;
+    File = Keys->File;
+    Allocator = Keys->Allocator;
+
+    //
+    // String key offsets are 32-bit, so the file can't exceed 4GB.
+    //
+
+    if (File->FileInfo.EndOfFile.HighPart != 0) {
+        return PH_E_TOO_MANY_KEYS;
+    }
+
+    Base = (PBYTE)File->BaseAddress;
+    EndOfFile = File->FileInfo.EndOfFile.LowPart;
+
+    //
+    // Walk the file once to validate each key's length prefix, count the
+    // keys, and total the size of the string data.
+    //
+
+    Offset = 0;
+    DataSize = 0;
+    NumberOfKeys = 0;
+
+    while (Offset < EndOfFile) {
+
+        if ((EndOfFile - Offset) < STRING_KEY_LENGTH_PREFIX_SIZE_IN_BYTES) {
+            return PH_E_INVALID_STRING_KEYS_FILE;
+        }
+
+        Offset += STRING_KEY_LENGTH_PREFIX_SIZE_IN_BYTES;
+        Length = STRING_KEY_LENGTH(Base, Offset);
+
+        if (Length > (EndOfFile - Offset)) {
+            return PH_E_INVALID_STRING_KEYS_FILE;
+        }
+
+        Offset += Length;
+        DataSize += Length;
+        NumberOfKeys++;
+    }
+
+    if (NumberOfKeys == 0) {
+        return PH_E_INVALID_STRING_KEYS_FILE;
+    }
+
+    //
+    // Reject key sets that are too large to be reliably reduced to unique
+    // 32-bit keys (see ReducedKeys.h).
+    //
+
+    if (NumberOfKeys > REDUCED_KEY_MAXIMUM_NUMBER_OF_KEYS) {
+        return PH_E_TOO_MANY_STRING_KEYS;
+    }
+
+    //
+    // Allocate the working arrays.
+    //
+
+    SourceOffsets = Allocator->Vtbl->Calloc(Allocator,
+                                            NumberOfKeys,
+                                            sizeof(*SourceOffsets));
+    if (!SourceOffsets) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    Pairs = Allocator->Vtbl->Calloc(Allocator, NumberOfKeys, sizeof(*Pairs));
+    if (!Pairs) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    Temp = Allocator->Vtbl->Calloc(Allocator, NumberOfKeys, sizeof(*Temp));
+    if (!Temp) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    //
+    // Walk the file again and capture the offset of each key's bytes.
+    //
+
+    Offset = 0;
+
+    for (Index = 0; Index < NumberOfKeys; Index++) {
+        Offset += STRING_KEY_LENGTH_PREFIX_SIZE_IN_BYTES;
+        SourceOffsets[Index] = Offset;
+        Offset += STRING_KEY_LENGTH(Base, Offset);
+    }
+
+    ASSERT(Offset == EndOfFile);
+
+    //
+    // Reduce each string to a 32-bit key, sort the keys, and check for any
+    // collisions.  If two colliding strings are identical, the file contains
+    // duplicate keys; otherwise, try the next seed.
+    //
+
+    Seed = 0;
+    Collision = TRUE;
+
+    for (Attempt = 0;
+         Collision && Attempt < REDUCED_KEY_MAXIMUM_SEED_ATTEMPTS;
+         Attempt++) {
+
+        Seed = GetReducedKeySeed(Attempt);
+        Collision = FALSE;
+
+        for (Index = 0; Index < NumberOfKeys; Index++) {
+            Offset = SourceOffsets[Index];
+            Length = STRING_KEY_LENGTH(Base, Offset);
+            Key = HashStringKey(Base + Offset, Length, Seed);
+            Pairs[Index] = REDUCED_KEY_PAIR(Key, Index);
+        }
+
+        SortReducedKeyPairs(Pairs, Temp, NumberOfKeys);
+
+        for (Index = 1; Index < NumberOfKeys; Index++) {
+
+            if (REDUCED_KEY_PAIR_KEY(Pairs[Index - 1]) !=
+                REDUCED_KEY_PAIR_KEY(Pairs[Index])) {
+                continue;
+            }
+
+            Ordinal = REDUCED_KEY_PAIR_ORDINAL(Pairs[Index - 1]);
+            Previous = SourceOffsets[Ordinal];
+            Ordinal = REDUCED_KEY_PAIR_ORDINAL(Pairs[Index]);
+            Offset = SourceOffsets[Ordinal];
+            Length = STRING_KEY_LENGTH(Base, Offset);
+
+            if (Length == STRING_KEY_LENGTH(Base, Previous) &&
+                Length == Rtl->RtlCompareMemory(Base + Previous,
+                                                Base + Offset,
+                                                Length)) {
+                Result = PH_E_DUPLICATE_KEYS_DETECTED;
+                goto Error;
+            }
+
+            Collision = TRUE;
+            break;
+        }
+    }
+
+    if (Collision) {
+        Result = PH_E_STRING_KEYS_HASH_COLLISIONS;
+        goto Error;
+    }
+
+    //
+    // Allocate the final arrays.  (The string data array is always at least
+    // one byte, such that a key set of empty strings still has an address.)
+    //
+
+    KeyArray = Allocator->Vtbl->Calloc(Allocator,
+                                       NumberOfKeys,
+                                       sizeof(*KeyArray));
+    if (!KeyArray) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    Offsets = Allocator->Vtbl->Calloc(Allocator,
+                                      (SIZE_T)NumberOfKeys + 1,
+                                      sizeof(*Offsets));
+    if (!Offsets) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    StringKeyData = Allocator->Vtbl->Calloc(Allocator,
+                                            max(DataSize, 1),
+                                            sizeof(*StringKeyData));
+    if (!StringKeyData) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    //
+    // Write the reduced keys and string data in sorted order.
+    //
+
+    Data = StringKeyData;
+
+    for (Index = 0; Index < NumberOfKeys; Index++) {
+        Ordinal = REDUCED_KEY_PAIR_ORDINAL(Pairs[Index]);
+        Offset = SourceOffsets[Ordinal];
+        Length = STRING_KEY_LENGTH(Base, Offset);
+
+        KeyArray[Index] = REDUCED_KEY_PAIR_KEY(Pairs[Index]);
+        Offsets[Index] = (ULONG)RtlPointerToOffset(StringKeyData, Data);
+        CopyMemory(Data, Base + Offset, Length);
+        Data += Length;
+    }
+
+    Offsets[NumberOfKeys] = (ULONG)RtlPointerToOffset(StringKeyData, Data);
+    ASSERT(Offsets[NumberOfKeys] == DataSize);
+
+    //
+    // Update the keys instance and clear the local pointers such that they
+    // aren't freed below.  The rundown routine takes care of them now.
+    //
+
+    Keys->KeyArrayBaseAddress = KeyArray;
+    Keys->NumberOfElements.QuadPart = NumberOfKeys;
+    Keys->ReducedKeySeed = Seed;
+    Keys->StringKeyDataSizeInBytes = DataSize;
+    Keys->StringKeyData = StringKeyData;
+    Keys->StringKeyOffsets = Offsets;
+    Keys->Flags.StringKeys = TRUE;
+
+    KeyArray = NULL;
+    Offsets = NULL;
+    StringKeyData = NULL;
+
+    goto End;
+
+Error:
+
+    if (Result == S_OK) {
+        Result = E_UNEXPECTED;
+    }
+
+    //
+    // Intentional follow-on to End.
+    //
+
+End:
+
+    if (SourceOffsets) {
+        Allocator->Vtbl->FreePointer(Allocator, &SourceOffsets);
+    }
+
+    if (Pairs) {
+        Allocator->Vtbl->FreePointer(Allocator, &Pairs);
+    }
+
+    if (Temp) {
+        Allocator->Vtbl->FreePointer(Allocator, &Temp);
+    }
+
+    if (KeyArray) {
+        Allocator->Vtbl->FreePointer(Allocator, &KeyArray);
+    }
+
+    if (Offsets) {
+        Allocator->Vtbl->FreePointer(Allocator, &Offsets);
+    }
+
+    if (StringKeyData) {
+        Allocator->Vtbl->FreePointer(Allocator, &StringKeyData);
+    }
+
+    return Result;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
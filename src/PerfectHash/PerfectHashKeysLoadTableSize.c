@@ -270,11 +270,12 @@ Return Value:
 
     //
     // Invariant check: if the number of table elements is greater than zero
-    // and non-modulus masking is active, verify it is a power of 2.
+    // and AND masking is active, verify it is a power of 2.
     //
 
     if (RequestedNumberOfTableElements->QuadPart > 0 &&
         !IsModulusMasking(MaskFunctionId) &&
+        !IsMultiplyHighMasking(MaskFunctionId) &&
         !IsPowerOfTwo(RequestedNumberOfTableElements->QuadPart)) {
 
         Result = PH_E_INVARIANT_CHECK_FAILED;
@@ -0,0 +1,671 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    PerfectHashKeysLoadText.c
+
+Abstract:
+
+    This module implements the text keys load routine for the perfect hash
+    library's PERFECT_HASH_KEYS component.  It is called by the keys Load()
+    routine when the TextKeys keys load flag is set, and is responsible for
+    parsing the memory-mapped text keys file into an array of ULONG or
+    ULONGLONG keys, which is then treated identically to the key array of a
+    binary keys file.
+
+    The file is split into a number of partitions at line boundaries, which
+    are processed in parallel in two phases: first, the line feeds in each
+    partition are counted, which bounds the number of keys in the partition,
+    and determines where its keys are written in the key array.  Then, each
+    partition's keys are parsed into the key array.  Finally, any gaps left
+    by lines that didn't contain keys (e.g. blank lines) are closed.
+
+    See TextKeys.h for a description of the file format.
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Files smaller than the following number of bytes per partition are not
+// worth the overhead of splitting over threadpool threads.  The number of
+// partitions is capped at the second constant.
+//
+
+#define TEXT_KEYS_MINIMUM_BYTES_PER_PARTITION (1 << 20)
+#define TEXT_KEYS_MAXIMUM_PARTITIONS 64
+
+//
+// Define the phases of the text keys load.
+//
+
+typedef enum _TEXT_KEYS_LOAD_PHASE {
+    TextKeysCountPhase = 0,
+    TextKeysParsePhase,
+} TEXT_KEYS_LOAD_PHASE;
+
+//
+// Define a partition of a text keys file.
+//
+
+typedef struct _TEXT_KEYS_PARTITION {
+
+    //
+    // Start and end of the partition.  The start is always the start of a
+    // line.
+    //
+
+    PCHAR Start;
+    PCHAR End;
+
+    //
+    // Maximum number of keys in the partition (i.e. the number of lines),
+    // and the index of the partition's first key in the key array.
+    //
+
+    ULONGLONG MaximumNumberOfKeys;
+    ULONGLONG Offset;
+
+    //
+    // Number of keys parsed.
+    //
+
+    ULONGLONG NumberOfKeys;
+
+    //
+    // Result of parsing the partition.
+    //
+
+    HRESULT Result;
+
+    //
+    // Pad out to an 8-byte boundary.
+    //
+
+    ULONG Padding;
+
+} TEXT_KEYS_PARTITION;
+typedef TEXT_KEYS_PARTITION *PTEXT_KEYS_PARTITION;
+
+//
+// Define the state shared by the partitions of a text keys load.
+//
+
+typedef struct _TEXT_KEYS_LOAD {
+
+    //
+    // Start and end of the text keys file.
+    //
+
+    PCHAR Base;
+    PCHAR End;
+
+    //
+    // Size of each key, in bytes.  Either 4 or 8.
+    //
+
+    ULONG KeySizeInBytes;
+
+    //
+    // Number of partitions, and the index of the next partition to be
+    // processed by a threadpool callback in the current phase.
+    //
+
+    ULONG NumberOfPartitions;
+    volatile LONG NextPartition;
+
+    //
+    // Current phase.
+    //
+
+    TEXT_KEYS_LOAD_PHASE Phase;
+
+    //
+    // Key array the keys are parsed into.
+    //
+
+    PVOID KeyArray;
+
+    //
+    // Threadpool work object used to process partitions in parallel, or NULL
+    // if the partitions are processed on the calling thread.
+    //
+
+    PTP_WORK Work;
+
+    //
+    // Partitions.
+    //
+
+    TEXT_KEYS_PARTITION Partitions[TEXT_KEYS_MAXIMUM_PARTITIONS];
+
+} TEXT_KEYS_LOAD;
+typedef TEXT_KEYS_LOAD *PTEXT_KEYS_LOAD;
+
+TP_WORK_CALLBACK TextKeysWorkCallback;
+PERFECT_HASH_KEYS_LOAD_TEXT PerfectHashKeysLoadText;
+
+FORCEINLINE
+HRESULT
+ParseTextKeysPartition(
+    _In_ PTEXT_KEYS_LOAD Load,
+    _In_ PTEXT_KEYS_PARTITION Partition
+    )
+/*++
+
+Routine Description:
+
+    Parses the keys in a partition of a text keys file into the key array.
+
+Arguments:
+
+    Load - Supplies a pointer to the text keys load state.
+
+    Partition - Supplies a pointer to the partition to parse.  The Offset and
+        MaximumNumberOfKeys fields must have been initialized.
+
+Return Value:
+
+    S_OK - Success.
+
+    PH_E_INVALID_TEXT_KEYS_FILE - A line was not valid.
+
+    PH_E_TEXT_KEY_EXCEEDS_KEY_SIZE - A key was too large for the key size.
+
+--*/
+{
+    CHAR Char;
+    PCHAR End;
+    PCHAR Cursor;
+    ULONG Length;
+    ULONGLONG Value;
+    ULONGLONG Maximum;
+    ULONGLONG Count;
+    BOOLEAN FirstLine;
+    PULONG KeyArray32;
+    PULONGLONG KeyArray64;
+
+    Count = 0;
+    Cursor = Partition->Start;
+    End = Partition->End;
+    FirstLine = (Cursor == Load->Base);
+
+    KeyArray32 = (PULONG)Load->KeyArray + Partition->Offset;
+    KeyArray64 = (PULONGLONG)Load->KeyArray + Partition->Offset;
+
+    if (Load->KeySizeInBytes == sizeof(ULONG)) {
+        Maximum = (ULONG)-1;
+    } else {
+        Maximum = (ULONGLONG)-1;
+    }
+
+    while (Cursor < End) {
+
+        Char = *Cursor;
+
+        if (IsTextKeyBlank(Char)) {
+            Cursor++;
+            continue;
+        }
+
+        if (Char == '\n') {
+            Cursor++;
+            FirstLine = FALSE;
+            continue;
+        }
+
+        if (IsTextKeyHexPrefix(Cursor, End)) {
+
+            Cursor += 2;
+            Length = ParseTextKeyHex(Cursor, End, &Value);
+
+            if (Length == 0) {
+                return PH_E_INVALID_TEXT_KEYS_FILE;
+            } else if (Length > TEXT_KEY_MAXIMUM_HEX_DIGITS) {
+                return PH_E_TEXT_KEY_EXCEEDS_KEY_SIZE;
+            }
+
+        } else if (IsTextKeyDecimalDigit(Char)) {
+
+            Length = GetTextKeyDecimalDigitsLength(Cursor, End);
+
+            if (Length > TEXT_KEY_MAXIMUM_DECIMAL_DIGITS ||
+                !ParseTextKeyDecimal(Load->Base, Cursor, Length, &Value)) {
+                return PH_E_TEXT_KEY_EXCEEDS_KEY_SIZE;
+            }
+
+        } else if (Char == '#' || FirstLine) {
+
+            //
+            // Skip comments, and the first line of the file if it doesn't
+            // begin with a key (e.g. a CSV header).
+            //
+
+            while (Cursor < End && *Cursor != '\n') {
+                Cursor++;
+            }
+            continue;
+
+        } else {
+
+            return PH_E_INVALID_TEXT_KEYS_FILE;
+        }
+
+        if (Value > Maximum) {
+            return PH_E_TEXT_KEY_EXCEEDS_KEY_SIZE;
+        }
+
+        Cursor += Length;
+        FirstLine = FALSE;
+
+        //
+        // The key must be followed by the end of the line, or a field
+        // separator, in which case the remainder of the line is ignored.
+        //
+
+        if (Cursor < End && *Cursor != '\n') {
+
+            Char = *Cursor;
+
+            if (!IsTextKeyFieldSeparator(Char) && Char != '\r') {
+                return PH_E_INVALID_TEXT_KEYS_FILE;
+            }
+
+            while (Cursor < End && *Cursor != '\n') {
+                Cursor++;
+            }
+        }
+
+        //
+        // Each line has at most one key, so the key count can't exceed the
+        // partition's line count.
+        //
+
+        ASSERT(Count < Partition->MaximumNumberOfKeys);
+
+        if (Load->KeySizeInBytes == sizeof(ULONG)) {
+            KeyArray32[Count++] = (ULONG)Value;
+        } else {
+            KeyArray64[Count++] = Value;
+        }
+    }
+
+    Partition->NumberOfKeys = Count;
+    return S_OK;
+}
+
+FORCEINLINE
+VOID
+ProcessTextKeysPartition(
+    _In_ PTEXT_KEYS_LOAD Load,
+    _In_ ULONG Index
+    )
+/*++
+
+Routine Description:
+
+    Runs the current phase of the text keys load over a single partition.
+
+Arguments:
+
+    Load - Supplies a pointer to the text keys load state.
+
+    Index - Supplies the index of the partition to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    PTEXT_KEYS_PARTITION Partition;
+
+    ASSERT(Index < Load->NumberOfPartitions);
+
+    Partition = &Load->Partitions[Index];
+
+    if (Load->Phase == TextKeysCountPhase) {
+        Partition->MaximumNumberOfKeys = (
+            CountTextKeyNewlines(Partition->Start, Partition->End) + 1
+        );
+    } else {
+        ASSERT(Load->Phase == TextKeysParsePhase);
+        Partition->Result = ParseTextKeysPartition(Load, Partition);
+    }
+}
+
+_Use_decl_annotations_
+VOID
+TextKeysWorkCallback(
+    PTP_CALLBACK_INSTANCE Instance,
+    PVOID Context,
+    PTP_WORK Work
+    )
+/*++
+
+Routine Description:
+
+    This is the threadpool work callback for the text keys load.  It is
+    submitted once per partition for each phase; each invocation claims the
+    next unprocessed partition and processes it.
+
+Arguments:
+
+    Instance - Supplies a pointer to the callback instance responsible for this
+        threadpool callback invocation.
+
+    Context - Supplies a pointer to the TEXT_KEYS_LOAD structure.
+
+    Work - Supplies a pointer to the TP_WORK object for this routine.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ULONG Index;
+    PTEXT_KEYS_LOAD Load;
+
+    UNREFERENCED_PARAMETER(Instance);
+    UNREFERENCED_PARAMETER(Work);
+
+    Load = (PTEXT_KEYS_LOAD)Context;
+    Index = (ULONG)InterlockedIncrement(&Load->NextPartition) - 1;
+
+    ProcessTextKeysPartition(Load, Index);
+}
+
+FORCEINLINE
+VOID
+RunTextKeysPhase(
+    _In_ PTEXT_KEYS_LOAD Load,
+    _In_ TEXT_KEYS_LOAD_PHASE Phase
+    )
+/*++
+
+Routine Description:
+
+    Runs a phase of the text keys load over all partitions, and waits for it
+    to complete.
+
+Arguments:
+
+    Load - Supplies a pointer to the text keys load state.
+
+    Phase - Supplies the phase to run.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ULONG Index;
+
+    Load->Phase = Phase;
+    Load->NextPartition = 0;
+
+    if (Load->Work == NULL) {
+        for (Index = 0; Index < Load->NumberOfPartitions; Index++) {
+            ProcessTextKeysPartition(Load, Index);
+        }
+        return;
+    }
+
+    for (Index = 0; Index < Load->NumberOfPartitions; Index++) {
+        SubmitThreadpoolWork(Load->Work);
+    }
+
+    WaitForThreadpoolWorkCallbacks(Load->Work, FALSE);
+}
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashKeysLoadText(
+    PPERFECT_HASH_KEYS Keys
+    )
+/*++
+
+Routine Description:
+
+    Loads keys from a text keys file that has been mapped into memory.  The
+    keys are parsed into a new array of the key size, in file order.
+
+Arguments:
+
+    Keys - Supplies a pointer to the PERFECT_HASH_KEYS structure for which the
+        text keys are to be loaded.  Keys->File must have been loaded, and the
+        key size must be 32-bit or 64-bit.
+
+Return Value:
+
+    S_OK - Success.
+
+    E_POINTER - Keys was NULL.
+
+    E_OUTOFMEMORY - Out of memory.
+
+    PH_E_INVALID_KEY_SIZE - The key size was not 32-bit or 64-bit.
+
+    PH_E_INVALID_TEXT_KEYS_FILE - The keys file was malformed or contained no
+        keys.
+
+    PH_E_TEXT_KEY_EXCEEDS_KEY_SIZE - A key was too large for the key size.
+
+    PH_E_SYSTEM_CALL_FAILED - A system call failed.
+
+--*/
+{
+    PRTL Rtl;
+    PCHAR Cursor;
+    PBYTE KeyBytes;
+    ULONG Index;
+    ULONG KeySizeInBytes;
+    ULONG NumberOfProcessors;
+    ULONGLONG SizeInBytes;
+    ULONGLONG NumberOfKeys;
+    ULONGLONG MaximumNumberOfKeys;
+    BOOLEAN LargePages;
+    HRESULT Result = S_OK;
+    PPERFECT_HASH_FILE File;
+    PTEXT_KEYS_LOAD Load = NULL;
+    PTEXT_KEYS_PARTITION Partition;
+    PVOID KeyArray = NULL;
+
+    //
+    // Validate arguments.
+    //
+
+    if (!ARGUMENT_PRESENT(Keys)) {
+        return E_POINTER;
+    }
+
+    KeySizeInBytes = Keys->OriginalKeySizeInBytes;
+
+    if (KeySizeInBytes != sizeof(ULONG) &&
+        KeySizeInBytes != sizeof(ULONGLONG)) {
+        return PH_E_INVALID_KEY_SIZE;
+    }
+
+    Rtl = Keys->Rtl;
+    File = Keys->File;
+    SizeInBytes = (ULONGLONG)File->FileInfo.EndOfFile.QuadPart;
+
+    Load = Keys->Allocator->Vtbl->Calloc(Keys->Allocator, 1, sizeof(*Load));
+    if (!Load) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    Load->Base = (PCHAR)File->BaseAddress;
+    Load->End = Load->Base + SizeInBytes;
+    Load->KeySizeInBytes = KeySizeInBytes;
+
+    //
+    // Determine the number of partitions, then split the file into that many
+    // partitions of roughly equal size, adjusting each partition's start to
+    // the start of the next line.
+    //
+
+    NumberOfProcessors = GetMaximumProcessorCount(ALL_PROCESSOR_GROUPS);
+
+    Load->NumberOfPartitions = (ULONG)min(
+        min(SizeInBytes / TEXT_KEYS_MINIMUM_BYTES_PER_PARTITION,
+            (ULONGLONG)NumberOfProcessors),
+        TEXT_KEYS_MAXIMUM_PARTITIONS
+    );
+
+    if (Load->NumberOfPartitions == 0) {
+        Load->NumberOfPartitions = 1;
+    }
+
+    Cursor = Load->Base;
+
+    for (Index = 0; Index < Load->NumberOfPartitions; Index++) {
+
+        Partition = &Load->Partitions[Index];
+        Partition->Start = Cursor;
+
+        if (Index == Load->NumberOfPartitions - 1) {
+            Cursor = Load->End;
+        } else {
+            Cursor = max(Cursor, Load->Base + (
+                (SizeInBytes * (Index + 1)) / Load->NumberOfPartitions
+            ));
+            while (Cursor < Load->End && *Cursor++ != '\n') {
+                NOTHING;
+            }
+        }
+
+        Partition->End = Cursor;
+    }
+
+    if (Load->NumberOfPartitions > 1) {
+        Load->Work = CreateThreadpoolWork(TextKeysWorkCallback, Load, NULL);
+        if (!Load->Work) {
+            SYS_ERROR(CreateThreadpoolWork);
+            Result = PH_E_SYSTEM_CALL_FAILED;
+            goto Error;
+        }
+    }
+
+    //
+    // Count the lines in each partition, and assign each partition its range
+    // of the key array.
+    //
+
+    RunTextKeysPhase(Load, TextKeysCountPhase);
+
+    MaximumNumberOfKeys = 0;
+
+    for (Index = 0; Index < Load->NumberOfPartitions; Index++) {
+        Partition = &Load->Partitions[Index];
+        Partition->Offset = MaximumNumberOfKeys;
+        MaximumNumberOfKeys += Partition->MaximumNumberOfKeys;
+    }
+
+    //
+    // Allocate the key array, trying large pages if the caller requested them
+    // for keys data.
+    //
+
+    LargePages = (Keys->LoadFlags.TryLargePagesForKeysData != FALSE);
+
+    KeyArray = Rtl->Vtbl->TryLargePageVirtualAlloc(
+        Rtl,
+        NULL,
+        (SIZE_T)(MaximumNumberOfKeys * KeySizeInBytes),
+        MEM_RESERVE | MEM_COMMIT,
+        PAGE_READWRITE,
+        &LargePages
+    );
+
+    if (!KeyArray) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    Load->KeyArray = KeyArray;
+
+    //
+    // Parse the keys, then move each partition's keys down such that they
+    // immediately follow the previous partition's.  Report the first failure
+    // in file order, if any.
+    //
+
+    RunTextKeysPhase(Load, TextKeysParsePhase);
+
+    NumberOfKeys = 0;
+    KeyBytes = (PBYTE)KeyArray;
+
+    for (Index = 0; Index < Load->NumberOfPartitions; Index++) {
+
+        Partition = &Load->Partitions[Index];
+
+        if (FAILED(Partition->Result)) {
+            Result = Partition->Result;
+            goto Error;
+        }
+
+        if (Partition->Offset != NumberOfKeys) {
+            MoveMemory(KeyBytes + (NumberOfKeys * KeySizeInBytes),
+                       KeyBytes + (Partition->Offset * KeySizeInBytes),
+                       (SIZE_T)(Partition->NumberOfKeys * KeySizeInBytes));
+        }
+
+        NumberOfKeys += Partition->NumberOfKeys;
+    }
+
+    if (NumberOfKeys == 0) {
+        Result = PH_E_INVALID_TEXT_KEYS_FILE;
+        goto Error;
+    }
+
+    //
+    // Update the keys instance and clear the local pointer such that it isn't
+    // freed below.  The rundown routine takes care of it now.
+    //
+
+    Keys->KeyArrayBaseAddress = KeyArray;
+    Keys->OriginalKeyArray = KeyArray;
+    Keys->NumberOfElements.QuadPart = NumberOfKeys;
+    Keys->Flags.KeysDataUsesLargePages = LargePages;
+
+    KeyArray = NULL;
+
+    goto End;
+
+Error:
+
+    if (Result == S_OK) {
+        Result = E_UNEXPECTED;
+    }
+
+    //
+    // Intentional follow-on to End.
+    //
+
+End:
+
+    if (Load) {
+        if (Load->Work) {
+            CloseThreadpoolWork(Load->Work);
+            Load->Work = NULL;
+        }
+        Keys->Allocator->Vtbl->FreePointer(Keys->Allocator, &Load);
+    }
+
+    if (KeyArray) {
+        if (!VirtualFree(KeyArray, 0, MEM_RELEASE)) {
+            SYS_ERROR(VirtualFree);
+        }
+        KeyArray = NULL;
+    }
+
+    return Result;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
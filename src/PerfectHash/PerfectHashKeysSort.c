@@ -0,0 +1,655 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    PerfectHashKeysSort.c
+
+Abstract:
+
+    This module implements the key sort routine for the perfect hash library's
+    PERFECT_HASH_KEYS component.  It is called by the keys Load() routine when
+    the SortKeys keys load flag is set, and is responsible for sorting the
+    32-bit or 64-bit keys of an unsorted keys file and removing any duplicate
+    keys, such that the resulting key array satisfies the sorted and unique
+    invariants verified by the load stats routines.
+
+    The keys are sorted via a least significant digit (LSD) radix sort with
+    8-bit digits.  Each pass is split into two phases, each of which is run
+    in parallel over a number of contiguous partitions of the keys: first,
+    a histogram of the pass's digit is constructed for each partition, then,
+    once the histograms have been converted into per-partition bucket offsets
+    (in partition order, such that the sort is stable), each partition's keys
+    are scattered into their buckets.  Passes for which every key has the same
+    digit are skipped; for typical key sets, this elides most of the passes
+    over the high bytes of 64-bit keys.
+
+    The first pass reads directly from the key array (e.g. the keys file's
+    mapping), so there is no separate copy of the keys prior to sorting.
+    Duplicates are removed from the sorted keys with a final compaction pass.
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Define the radix sort constants.
+//
+
+#define KEYS_SORT_RADIX_BITS 8
+#define KEYS_SORT_RADIX_SIZE (1 << KEYS_SORT_RADIX_BITS)
+#define KEYS_SORT_RADIX_MASK (KEYS_SORT_RADIX_SIZE - 1)
+
+//
+// Key sets smaller than the following number of keys per partition are not
+// worth the overhead of splitting over threadpool threads.  The number of
+// partitions is capped at the second constant, which bounds the size of the
+// histogram array.
+//
+
+#define KEYS_SORT_MINIMUM_KEYS_PER_PARTITION (1 << 16)
+#define KEYS_SORT_MAXIMUM_PARTITIONS 64
+
+//
+// Define the phases of a radix sort pass.
+//
+
+typedef enum _KEYS_SORT_PHASE {
+    KeysSortHistogramPhase = 0,
+    KeysSortScatterPhase,
+} KEYS_SORT_PHASE;
+
+//
+// Define the state shared by the partitions of a sort.
+//
+
+typedef struct _KEYS_SORT {
+
+    //
+    // Size of each key, in bytes.  Either 4 or 8.
+    //
+
+    ULONG KeySizeInBytes;
+
+    //
+    // Number of partitions the keys are split into, and the index of the next
+    // partition to be processed by a threadpool callback in the current
+    // phase.
+    //
+
+    ULONG NumberOfPartitions;
+    volatile LONG NextPartition;
+
+    //
+    // Shift that yields the current pass's digit from a key.
+    //
+
+    ULONG Shift;
+
+    //
+    // Current phase.
+    //
+
+    KEYS_SORT_PHASE Phase;
+
+    //
+    // Pad out to an 8-byte boundary.
+    //
+
+    ULONG Padding;
+
+    //
+    // Total number of keys, and number of keys in each partition (the last
+    // partition may have fewer).
+    //
+
+    ULONGLONG NumberOfKeys;
+    ULONGLONG KeysPerPartition;
+
+    //
+    // Source and destination key arrays for the current pass.
+    //
+
+    PVOID Source;
+    PVOID Dest;
+
+    //
+    // Histograms of the current pass's digit, KEYS_SORT_RADIX_SIZE counts per
+    // partition.  After the histogram phase, these are converted in place
+    // into the offset in Dest of each partition's first key in each bucket.
+    //
+
+    PULONGLONG Counts;
+
+    //
+    // Threadpool work object used to process partitions in parallel, or NULL
+    // if the partitions are processed on the calling thread.
+    //
+
+    PTP_WORK Work;
+
+} KEYS_SORT;
+typedef KEYS_SORT *PKEYS_SORT;
+
+TP_WORK_CALLBACK KeysSortWorkCallback;
+PERFECT_HASH_KEYS_SORT PerfectHashKeysSort;
+
+FORCEINLINE
+VOID
+ProcessKeysSortPartition(
+    _In_ PKEYS_SORT Sort,
+    _In_ ULONG Partition
+    )
+/*++
+
+Routine Description:
+
+    Runs the current phase of a radix sort pass over a single partition of the
+    keys.
+
+Arguments:
+
+    Sort - Supplies a pointer to the sort state.
+
+    Partition - Supplies the index of the partition to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ULONG Shift;
+    ULONGLONG Key;
+    ULONGLONG End;
+    ULONGLONG Index;
+    ULONGLONG Start;
+    PULONGLONG Counts;
+    PULONG Source32;
+    PULONG Dest32;
+    PULONGLONG Source64;
+    PULONGLONG Dest64;
+
+    ASSERT(Partition < Sort->NumberOfPartitions);
+
+    Shift = Sort->Shift;
+    Start = Partition * Sort->KeysPerPartition;
+    End = min(Start + Sort->KeysPerPartition, Sort->NumberOfKeys);
+    Counts = Sort->Counts + ((ULONGLONG)Partition * KEYS_SORT_RADIX_SIZE);
+
+    Source32 = (PULONG)Sort->Source;
+    Dest32 = (PULONG)Sort->Dest;
+    Source64 = (PULONGLONG)Sort->Source;
+    Dest64 = (PULONGLONG)Sort->Dest;
+
+    if (Sort->Phase == KeysSortHistogramPhase) {
+
+        ZeroInline(Counts, sizeof(*Counts) * KEYS_SORT_RADIX_SIZE);
+
+        if (Sort->KeySizeInBytes == sizeof(ULONG)) {
+            for (Index = Start; Index < End; Index++) {
+                Key = Source32[Index];
+                Counts[(Key >> Shift) & KEYS_SORT_RADIX_MASK]++;
+            }
+        } else {
+            for (Index = Start; Index < End; Index++) {
+                Key = Source64[Index];
+                Counts[(Key >> Shift) & KEYS_SORT_RADIX_MASK]++;
+            }
+        }
+
+    } else {
+
+        ASSERT(Sort->Phase == KeysSortScatterPhase);
+
+        if (Sort->KeySizeInBytes == sizeof(ULONG)) {
+            for (Index = Start; Index < End; Index++) {
+                Key = Source32[Index];
+                Dest32[Counts[(Key >> Shift) & KEYS_SORT_RADIX_MASK]++] = (
+                    (ULONG)Key
+                );
+            }
+        } else {
+            for (Index = Start; Index < End; Index++) {
+                Key = Source64[Index];
+                Dest64[Counts[(Key >> Shift) & KEYS_SORT_RADIX_MASK]++] = Key;
+            }
+        }
+    }
+}
+
+_Use_decl_annotations_
+VOID
+KeysSortWorkCallback(
+    PTP_CALLBACK_INSTANCE Instance,
+    PVOID Context,
+    PTP_WORK Work
+    )
+/*++
+
+Routine Description:
+
+    This is the threadpool work callback for the key sort.  It is submitted
+    once per partition for each phase; each invocation claims the next
+    unprocessed partition and processes it.
+
+Arguments:
+
+    Instance - Supplies a pointer to the callback instance responsible for this
+        threadpool callback invocation.
+
+    Context - Supplies a pointer to the KEYS_SORT structure.
+
+    Work - Supplies a pointer to the TP_WORK object for this routine.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ULONG Partition;
+    PKEYS_SORT Sort;
+
+    UNREFERENCED_PARAMETER(Instance);
+    UNREFERENCED_PARAMETER(Work);
+
+    Sort = (PKEYS_SORT)Context;
+    Partition = (ULONG)InterlockedIncrement(&Sort->NextPartition) - 1;
+
+    ProcessKeysSortPartition(Sort, Partition);
+}
+
+FORCEINLINE
+VOID
+RunKeysSortPhase(
+    _In_ PKEYS_SORT Sort,
+    _In_ KEYS_SORT_PHASE Phase
+    )
+/*++
+
+Routine Description:
+
+    Runs a phase of the current radix sort pass over all partitions, and waits
+    for it to complete.
+
+Arguments:
+
+    Sort - Supplies a pointer to the sort state.
+
+    Phase - Supplies the phase to run.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ULONG Partition;
+
+    Sort->Phase = Phase;
+    Sort->NextPartition = 0;
+
+    if (Sort->Work == NULL) {
+        for (Partition = 0; Partition < Sort->NumberOfPartitions; Partition++) {
+            ProcessKeysSortPartition(Sort, Partition);
+        }
+        return;
+    }
+
+    for (Partition = 0; Partition < Sort->NumberOfPartitions; Partition++) {
+        SubmitThreadpoolWork(Sort->Work);
+    }
+
+    WaitForThreadpoolWorkCallbacks(Sort->Work, FALSE);
+}
+
+FORCEINLINE
+BOOLEAN
+PrepareKeysSortScatter(
+    _In_ PKEYS_SORT Sort
+    )
+/*++
+
+Routine Description:
+
+    Converts the per-partition histograms of the current pass into bucket
+    offsets.  Buckets are laid out in digit order, and within each bucket,
+    each partition's keys follow those of the partitions preceding it.
+
+Arguments:
+
+    Sort - Supplies a pointer to the sort state.
+
+Return Value:
+
+    TRUE if the scatter phase needs to be run, FALSE if every key has the same
+    digit, and thus the pass can be skipped.
+
+--*/
+{
+    ULONG Bucket;
+    ULONG Partition;
+    ULONGLONG Count;
+    ULONGLONG Total;
+    ULONGLONG Offset;
+    PULONGLONG Counts;
+
+    Offset = 0;
+
+    for (Bucket = 0; Bucket < KEYS_SORT_RADIX_SIZE; Bucket++) {
+
+        Total = 0;
+        Counts = Sort->Counts + Bucket;
+
+        for (Partition = 0;
+             Partition < Sort->NumberOfPartitions;
+             Partition++, Counts += KEYS_SORT_RADIX_SIZE) {
+
+            Count = *Counts;
+            *Counts = Offset;
+            Offset += Count;
+            Total += Count;
+        }
+
+        if (Total == Sort->NumberOfKeys) {
+            return FALSE;
+        }
+    }
+
+    ASSERT(Offset == Sort->NumberOfKeys);
+
+    return TRUE;
+}
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashKeysSort(
+    PPERFECT_HASH_KEYS Keys
+    )
+/*++
+
+Routine Description:
+
+    Sorts the keys of a loaded keys file in ascending order and removes any
+    duplicate keys.  If the keys were parsed from a text keys file, or the
+    keys file was loaded into a large page buffer, the keys are writable and
+    are sorted in place.  Otherwise, the keys file is mapped read-only, and
+    the sorted keys are written to a new array, which becomes the key array.
+    The number of elements is updated to reflect the number of unique keys.
+
+Arguments:
+
+    Keys - Supplies a pointer to the PERFECT_HASH_KEYS structure for which the
+        keys are to be sorted.  The key array base address and number of
+        elements must have been initialized from the keys file, and the keys
+        must be 32-bit or 64-bit.
+
+Return Value:
+
+    S_OK - Success.
+
+    E_POINTER - Keys was NULL.
+
+    E_OUTOFMEMORY - Out of memory.
+
+    PH_E_INVALID_KEY_SIZE - The key size was not 32-bit or 64-bit.
+
+    PH_E_SYSTEM_CALL_FAILED - A system call failed.
+
+--*/
+{
+    PRTL Rtl;
+    PVOID Swap;
+    PVOID Sorted;
+    PVOID Temp = NULL;
+    ULONG Pass;
+    ULONG NumberOfPasses;
+    ULONG NumberOfProcessors;
+    ULONG KeySizeInBytes;
+    ULONGLONG Index;
+    ULONGLONG Unique;
+    ULONGLONG NumberOfKeys;
+    ULONGLONG SizeInBytes;
+    PULONG Keys32;
+    PULONGLONG Keys64;
+    BOOLEAN LargePages;
+    BOOLEAN SortInPlace;
+    KEYS_SORT Sort;
+    HRESULT Result = S_OK;
+    PALLOCATOR Allocator;
+    PPERFECT_HASH_FILE File;
+    PVOID SortedKeyArray = NULL;
+
+    //
+    // Validate arguments.
+    //
+
+    if (!ARGUMENT_PRESENT(Keys)) {
+        return E_POINTER;
+    }
+
+    KeySizeInBytes = Keys->OriginalKeySizeInBytes;
+
+    if (KeySizeInBytes != sizeof(ULONG) &&
+        KeySizeInBytes != sizeof(ULONGLONG)) {
+        return PH_E_INVALID_KEY_SIZE;
+    }
+
+    Rtl = Keys->Rtl;
+    File = Keys->File;
+    Allocator = Keys->Allocator;
+    NumberOfKeys = Keys->NumberOfElements.QuadPart;
+    SizeInBytes = NumberOfKeys * KeySizeInBytes;
+
+    ASSERT(Keys->KeyArrayBaseAddress == GetOriginalKeyArray(Keys));
+
+    if (NumberOfKeys == 0) {
+        return S_OK;
+    }
+
+    ZeroStruct(Sort);
+
+    //
+    // If the keys were parsed from a text keys file, or the keys file was
+    // loaded into a large page buffer, the keys are writable, and can be
+    // sorted in place.  Otherwise, allocate a new array for the sorted keys,
+    // trying large pages if the caller requested them for keys data.
+    //
+
+    SortInPlace = (
+        Keys->OriginalKeyArray != NULL ||
+        File->Flags.UsesLargePages != FALSE
+    );
+
+    if (SortInPlace) {
+
+        Sorted = Keys->KeyArrayBaseAddress;
+
+    } else {
+
+        LargePages = (Keys->LoadFlags.TryLargePagesForKeysData != FALSE);
+
+        SortedKeyArray = (
+            Rtl->Vtbl->TryLargePageVirtualAlloc(Rtl,
+                                                NULL,
+                                                (SIZE_T)SizeInBytes,
+                                                MEM_RESERVE | MEM_COMMIT,
+                                                PAGE_READWRITE,
+                                                &LargePages)
+        );
+
+        if (!SortedKeyArray) {
+            Result = E_OUTOFMEMORY;
+            goto Error;
+        }
+
+        Keys->Flags.KeysDataUsesLargePages = LargePages;
+        Sorted = SortedKeyArray;
+    }
+
+    Temp = Allocator->Vtbl->Calloc(Allocator,
+                                   (SIZE_T)NumberOfKeys,
+                                   KeySizeInBytes);
+    if (!Temp) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    //
+    // Determine the number of partitions.  If there's more than one, create a
+    // threadpool work object in the default threadpool to process them.
+    //
+
+    NumberOfProcessors = GetMaximumProcessorCount(ALL_PROCESSOR_GROUPS);
+
+    Sort.NumberOfPartitions = (ULONG)min(
+        min(NumberOfKeys / KEYS_SORT_MINIMUM_KEYS_PER_PARTITION,
+            (ULONGLONG)NumberOfProcessors),
+        KEYS_SORT_MAXIMUM_PARTITIONS
+    );
+
+    if (Sort.NumberOfPartitions == 0) {
+        Sort.NumberOfPartitions = 1;
+    }
+
+    Sort.KeySizeInBytes = KeySizeInBytes;
+    Sort.NumberOfKeys = NumberOfKeys;
+    Sort.KeysPerPartition = (
+        (NumberOfKeys + Sort.NumberOfPartitions - 1) / Sort.NumberOfPartitions
+    );
+
+    Sort.Counts = Allocator->Vtbl->Calloc(Allocator,
+                                          (SIZE_T)Sort.NumberOfPartitions *
+                                          KEYS_SORT_RADIX_SIZE,
+                                          sizeof(*Sort.Counts));
+    if (!Sort.Counts) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    if (Sort.NumberOfPartitions > 1) {
+        Sort.Work = CreateThreadpoolWork(KeysSortWorkCallback, &Sort, NULL);
+        if (!Sort.Work) {
+            SYS_ERROR(CreateThreadpoolWork);
+            Result = PH_E_SYSTEM_CALL_FAILED;
+            goto Error;
+        }
+    }
+
+    //
+    // Perform the radix sort passes.  The first pass that isn't skipped reads
+    // from the key array and writes to Temp; thereafter, passes alternate
+    // between Temp and Sorted.  (When sorting in place, the key array is
+    // Sorted, so it is only overwritten once it's been read in its entirety.)
+    //
+
+    Sort.Source = Keys->KeyArrayBaseAddress;
+    Sort.Dest = Temp;
+    NumberOfPasses = (KeySizeInBytes << 3) / KEYS_SORT_RADIX_BITS;
+
+    for (Pass = 0; Pass < NumberOfPasses; Pass++) {
+
+        Sort.Shift = Pass * KEYS_SORT_RADIX_BITS;
+
+        RunKeysSortPhase(&Sort, KeysSortHistogramPhase);
+
+        if (!PrepareKeysSortScatter(&Sort)) {
+            continue;
+        }
+
+        RunKeysSortPhase(&Sort, KeysSortScatterPhase);
+
+        //
+        // The pass's destination becomes the next pass's source.
+        //
+
+        Swap = Sort.Dest;
+        Sort.Dest = (Swap == Temp ? Sorted : Temp);
+        Sort.Source = Swap;
+    }
+
+    //
+    // If the sorted keys didn't end up in Sorted (i.e. an odd number of passes
+    // were performed, or none at all), copy them there.
+    //
+
+    if (Sort.Source != Sorted) {
+        CopyMemory(Sorted, Sort.Source, (SIZE_T)SizeInBytes);
+    }
+
+    //
+    // Remove duplicates.
+    //
+
+    Unique = 1;
+
+    if (KeySizeInBytes == sizeof(ULONG)) {
+        Keys32 = (PULONG)Sorted;
+        for (Index = 1; Index < NumberOfKeys; Index++) {
+            if (Keys32[Index] != Keys32[Unique - 1]) {
+                Keys32[Unique++] = Keys32[Index];
+            }
+        }
+    } else {
+        Keys64 = (PULONGLONG)Sorted;
+        for (Index = 1; Index < NumberOfKeys; Index++) {
+            if (Keys64[Index] != Keys64[Unique - 1]) {
+                Keys64[Unique++] = Keys64[Index];
+            }
+        }
+    }
+
+    //
+    // Update the keys instance and clear the local pointer such that it isn't
+    // freed below.  The rundown routine takes care of it now.
+    //
+
+    Keys->KeyArrayBaseAddress = Sorted;
+    if (SortedKeyArray) {
+        Keys->OriginalKeyArray = SortedKeyArray;
+    }
+    Keys->NumberOfElements.QuadPart = Unique;
+    Keys->Flags.KeysSorted = TRUE;
+
+    SortedKeyArray = NULL;
+
+    goto End;
+
+Error:
+
+    if (Result == S_OK) {
+        Result = E_UNEXPECTED;
+    }
+
+    //
+    // Intentional follow-on to End.
+    //
+
+End:
+
+    if (Sort.Work) {
+        CloseThreadpoolWork(Sort.Work);
+        Sort.Work = NULL;
+    }
+
+    if (Sort.Counts) {
+        Allocator->Vtbl->FreePointer(Allocator, &Sort.Counts);
+    }
+
+    if (Temp) {
+        Allocator->Vtbl->FreePointer(Allocator, &Temp);
+    }
+
+    if (SortedKeyArray) {
+        if (!VirtualFree(SortedKeyArray, 0, MEM_RELEASE)) {
+            SYS_ERROR(VirtualFree);
+        }
+        SortedKeyArray = NULL;
+    }
+
+    return Result;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -0,0 +1,214 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    PerfectHashKeysTryProject64.c
+
+Abstract:
+
+    This module implements the 64-bit key projection routine for the perfect
+    hash library's PERFECT_HASH_KEYS component.  It is called by the 64-bit
+    load stats routine when the keys vary in more than 32 bit positions, and
+    thus can't be downsized via _pext_u64().  It searches for a multiply-shift
+    projection of the keys to 32 bits that is injective over the key set; see
+    ReducedKeys.h for details.
+
+--*/
+
+#include "stdafx.h"
+
+PERFECT_HASH_KEYS_TRY_PROJECT_64 PerfectHashKeysTryProject64;
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashKeysTryProject64(
+    PPERFECT_HASH_KEYS Keys
+    )
+/*++
+
+Routine Description:
+
+    Attempts to find a multiply-shift projection of a set of 64-bit keys to
+    32-bit keys that is injective over the key set.  If one is found, a new
+    array of projected keys is allocated (in the same order as the original
+    keys), and the keys instance is updated to use it.
+
+Arguments:
+
+    Keys - Supplies a pointer to the PERFECT_HASH_KEYS structure for which the
+        projection is to be performed.  The keys must be 64-bit, unique, and
+        must not have been downsized.
+
+Return Value:
+
+    S_OK - The keys were projected.
+
+    PH_S_NO_KEY_PROJECTION_FOUND - No seed in the projection seed sequence
+        projected every key to a unique 32-bit key; the keys are unchanged.
+
+    E_POINTER - Keys was NULL.
+
+    E_OUTOFMEMORY - Out of memory.
+
+    PH_E_TOO_MANY_KEYS - Too many keys were present.
+
+--*/
+{
+    ULONG Key;
+    ULONG Index;
+    ULONG Attempt;
+    ULONG NumberOfKeys;
+    BOOLEAN Collision;
+    PULONGLONG KeyArray;
+    ULONGLONG Multiplier;
+    HRESULT Result = S_OK;
+    PALLOCATOR Allocator;
+    PULONG ProjectedKeyArray = NULL;
+    PULONGLONG Pairs = NULL;
+    PULONGLONG Temp = NULL;
+
+    //
+    // Validate arguments.
+    //
+
+    if (!ARGUMENT_PRESENT(Keys)) {
+        return E_POINTER;
+    }
+
+    if (Keys->NumberOfElements.HighPart) {
+        return PH_E_TOO_MANY_KEYS;
+    }
+
+    ASSERT(Keys->KeySizeInBytes == sizeof(ULONGLONG));
+    ASSERT(!KeysWereDownsized(Keys));
+
+    Allocator = Keys->Allocator;
+    KeyArray = (PULONGLONG)Keys->KeyArrayBaseAddress;
+    NumberOfKeys = Keys->NumberOfElements.LowPart;
+
+    if (NumberOfKeys > KEY_PROJECTION_MAXIMUM_NUMBER_OF_KEYS) {
+        return PH_S_NO_KEY_PROJECTION_FOUND;
+    }
+
+    //
+    // Allocate the working arrays.
+    //
+
+    Pairs = Allocator->Vtbl->Calloc(Allocator, NumberOfKeys, sizeof(*Pairs));
+    if (!Pairs) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    Temp = Allocator->Vtbl->Calloc(Allocator, NumberOfKeys, sizeof(*Temp));
+    if (!Temp) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    //
+    // Project each key, sort the projected keys, and check for collisions.
+    // The keys are unique, so any collision means we need to try the next
+    // multiplier.
+    //
+
+    Multiplier = 0;
+    Collision = TRUE;
+
+    for (Attempt = 0;
+         Collision && Attempt < KEY_PROJECTION_MAXIMUM_SEED_ATTEMPTS;
+         Attempt++) {
+
+        Multiplier = GetKeyProjectionMultiplier(Attempt);
+        Collision = FALSE;
+
+        for (Index = 0; Index < NumberOfKeys; Index++) {
+            Key = ProjectKey64(KeyArray[Index], Multiplier);
+            Pairs[Index] = REDUCED_KEY_PAIR(Key, Index);
+        }
+
+        SortReducedKeyPairs(Pairs, Temp, NumberOfKeys);
+
+        for (Index = 1; Index < NumberOfKeys; Index++) {
+            if (REDUCED_KEY_PAIR_KEY(Pairs[Index - 1]) ==
+                REDUCED_KEY_PAIR_KEY(Pairs[Index])) {
+                Collision = TRUE;
+                break;
+            }
+        }
+    }
+
+    if (Collision) {
+        Result = PH_S_NO_KEY_PROJECTION_FOUND;
+        goto End;
+    }
+
+    //
+    // Allocate the projected key array, and write the projected keys in the
+    // same order as the original keys.
+    //
+
+    ProjectedKeyArray = Allocator->Vtbl->Calloc(Allocator,
+                                                NumberOfKeys,
+                                                sizeof(*ProjectedKeyArray));
+    if (!ProjectedKeyArray) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    for (Index = 0; Index < NumberOfKeys; Index++) {
+        ProjectedKeyArray[Index] = ProjectKey64(KeyArray[Index], Multiplier);
+    }
+
+    //
+    // Keys have been projected successfully.  Update the key size, capture the
+    // multiplier we used, and set the "downsizing occurred" and "projection
+    // occurred" flags.
+    //
+
+    Keys->KeySizeInBytes = sizeof(ULONG);
+    Keys->KeySizeType = LongType;
+    Keys->ProjectionMultiplier = Multiplier;
+    Keys->Flags.DownsizingOccurred = TRUE;
+    Keys->Flags.ProjectionOccurred = TRUE;
+
+    //
+    // Update the array address to point at our new projected array and clear
+    // the local pointer.  The rundown routine takes care of it now.
+    //
+
+    Keys->KeyArrayBaseAddress = ProjectedKeyArray;
+    ProjectedKeyArray = NULL;
+
+    goto End;
+
+Error:
+
+    if (Result == S_OK) {
+        Result = E_UNEXPECTED;
+    }
+
+    //
+    // Intentional follow-on to End.
+    //
+
+End:
+
+    if (Pairs) {
+        Allocator->Vtbl->FreePointer(Allocator, &Pairs);
+    }
+
+    if (Temp) {
+        Allocator->Vtbl->FreePointer(Allocator, &Temp);
+    }
+
+    if (ProjectedKeyArray) {
+        Allocator->Vtbl->FreePointer(Allocator, &ProjectedKeyArray);
+    }
+
+    return Result;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
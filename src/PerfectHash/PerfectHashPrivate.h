@@ -80,11 +80,58 @@ typedef union _TABLE_INFO_ON_DISK_FLAGS {
 
     struct {
 
+        //
+        // When set, indicates the table was created with the Interleaved table
+        // data layout (i.e. values are indexed by vertex, and are co-located
+        // with the table data element of that vertex in the compiled table).
+        //
+
+        ULONG InterleavedTableData:1;
+
+        //
+        // When set, indicates the table was created with the OrderPreserving
+        // table create flag (i.e. the index of each key is its offset in the
+        // keys file).
+        //
+
+        ULONG OrderPreserving:1;
+
+        //
+        // When set, indicates the table was created with the Packed table data
+        // layout (i.e. the table data is a bit-packed array of elements, each
+        // TableDataBitsPerElement bits wide).
+        //
+
+        ULONG PackedTableData:1;
+
+        //
+        // When set, indicates the table was created from string keys (i.e. the
+        // keys were loaded with the --StringKeys keys load flag, and each key
+        // is the 32-bit reduction of a string).
+        //
+
+        ULONG StringKeys:1;
+
+        //
+        // When set, indicates the table was created from 128-bit keys, each of
+        // which was reduced to a 32-bit key.
+        //
+
+        ULONG Keys128:1;
+
+        //
+        // When set, indicates the table was created from 64-bit keys that were
+        // downsized to 32-bit keys via a multiply-shift projection (i.e. the
+        // KeyProjectionMultiplier field is valid).
+        //
+
+        ULONG KeysProjected:1;
+
         //
         // Unused bits.
         //
 
-        ULONG Unused:32;
+        ULONG Unused:26;
 
     };
 
@@ -227,7 +274,53 @@ typedef struct _Struct_size_bytes_(SizeOfStruct) _TABLE_INFO_ON_DISK {
         ULONG LastSeed;
     };
 
-    ULONG Padding2;
+    //
+    // Number of shards used by the Shard01 algorithm.  Zero for all other
+    // algorithms.
+    //
+
+    ULONG NumberOfShards;
+
+    //
+    // Size of each key fingerprint, in bytes, if the table was created with
+    // the --FingerprintSizeInBytes parameter, otherwise 0.  If non-zero, the
+    // fingerprints array (NumberOfTableElements * FingerprintSizeInBytes)
+    // immediately follows the table data in the table file.
+    //
+
+    ULONG FingerprintSizeInBytes;
+
+    //
+    // Number of bits per table data element if the table uses the packed
+    // table data layout, otherwise 0.  If non-zero, the table data in the
+    // table file is a bit-packed array; see PackedTableData.h.
+    //
+
+    ULONG TableDataBitsPerElement;
+
+    //
+    // Seed used to reduce each key to a 32-bit key if the table was created
+    // from string keys or 128-bit keys, otherwise 0 (see ReducedKeys.h), and
+    // the total size of the string key data, in bytes, if the table was
+    // created from string keys, otherwise 0.
+    //
+
+    ULONG ReducedKeySeed;
+    ULONG StringKeyDataSizeInBytes;
+
+    //
+    // Multiplier used to project each 64-bit key to a 32-bit key if the
+    // table's keys were projected, otherwise 0 (see ReducedKeys.h).
+    //
+
+    ULONGLONG KeyProjectionMultiplier;
+
+    //
+    // Average number of distinct cache lines touched by a lookup, as measured
+    // during graph verification.
+    //
+
+    DOUBLE CacheLinesPerLookup;
 
     //
     // Capture statistics about the perfect hash table solution that can be
@@ -366,6 +459,9 @@ typedef CREATE_PERFECT_HASH_TABLE_IMPL *PCREATE_PERFECT_HASH_TABLE_IMPL;
 //
 
 CREATE_PERFECT_HASH_TABLE_IMPL CreatePerfectHashTableImplChm01;
+CREATE_PERFECT_HASH_TABLE_IMPL CreatePerfectHashTableImplBdz01;
+CREATE_PERFECT_HASH_TABLE_IMPL CreatePerfectHashTableImplShard01;
+CREATE_PERFECT_HASH_TABLE_IMPL CreatePerfectHashTableImplBlock01;
 
 //
 // Likewise, each algorithm implements a loader routine that matches the
@@ -390,6 +486,9 @@ typedef LOAD_PERFECT_HASH_TABLE_IMPL *PLOAD_PERFECT_HASH_TABLE_IMPL;
 //
 
 LOAD_PERFECT_HASH_TABLE_IMPL LoadPerfectHashTableImplChm01;
+LOAD_PERFECT_HASH_TABLE_IMPL LoadPerfectHashTableImplBdz01;
+LOAD_PERFECT_HASH_TABLE_IMPL LoadPerfectHashTableImplShard01;
+LOAD_PERFECT_HASH_TABLE_IMPL LoadPerfectHashTableImplBlock01;
 
 //
 // For each algorithm, declare the index impl routine.  These are gathered in an
@@ -397,6 +496,29 @@ LOAD_PERFECT_HASH_TABLE_IMPL LoadPerfectHashTableImplChm01;
 //
 
 PERFECT_HASH_TABLE_INDEX PerfectHashTableIndexImplChm01;
+PERFECT_HASH_TABLE_INDEX PerfectHashTableIndexImplBdz01;
+PERFECT_HASH_TABLE_INDEX PerfectHashTableIndexImplShard01;
+PERFECT_HASH_TABLE_INDEX PerfectHashTableIndexImplBlock01;
+
+//
+// For each algorithm, declare the batch index impl routine.  These are
+// gathered in an array named IndexBatchRoutines[].
+//
+
+PERFECT_HASH_TABLE_INDEX_BATCH PerfectHashTableIndexBatchImplChm01;
+PERFECT_HASH_TABLE_INDEX_BATCH PerfectHashTableIndexBatchImplBdz01;
+PERFECT_HASH_TABLE_INDEX_BATCH PerfectHashTableIndexBatchImplShard01;
+PERFECT_HASH_TABLE_INDEX_BATCH PerfectHashTableIndexBatchImplBlock01;
+
+//
+// Declare the index and batch index impl routines for Chm01 tables using the
+// packed table data layout.  These supersede the routines above (and the fast
+// index routines below) for such tables; see
+// CompletePerfectHashTableInitialization().
+//
+
+PERFECT_HASH_TABLE_INDEX PerfectHashTableIndexImplChm01Packed;
+PERFECT_HASH_TABLE_INDEX_BATCH PerfectHashTableIndexBatchImplChm01Packed;
 
 //
 // For each algorithm, declare fast-index impl routines.  These differ from the
@@ -170,6 +170,15 @@ Return Value:
         Allocator->Vtbl->FreePointer(Allocator, &Table->Coverage);
     }
 
+    //
+    // Free the fingerprints array if it was allocated during creation.  (If
+    // the table was loaded, the fingerprints live in the table file.)
+    //
+
+    if (Table->Fingerprints && WereFingerprintsHeapAllocated(Table)) {
+        Allocator->Vtbl->FreePointer(Allocator, &Table->Fingerprints);
+    }
+
     //
     // Free the post-create in-memory allocation for the table info and table
     // data, if applicable.
@@ -213,6 +222,7 @@ Return Value:
     RELEASE(Table->OutputDirectory);
     RELEASE(Table->Context);
     RELEASE(Table->Keys);
+    RELEASE(Table->StringKeys);
     RELEASE(Table->Rtl);
     RELEASE(Table->Allocator);
 
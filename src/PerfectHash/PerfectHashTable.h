@@ -50,11 +50,17 @@ typedef union _PERFECT_HASH_TABLE_STATE {
 
         ULONG TableDataWasHeapAllocated:1;
 
+        //
+        // As above, but for the Fingerprints pointer.
+        //
+
+        ULONG FingerprintsWereHeapAllocated:1;
+
         //
         // Unused bits.
         //
 
-        ULONG Unused:29;
+        ULONG Unused:28;
     };
     LONG AsLong;
     ULONG AsULong;
@@ -68,6 +74,8 @@ typedef PERFECT_HASH_TABLE_STATE *PPERFECT_HASH_TABLE_STATE;
 #define NoFileIo(Table) ((Table)->TableCreateFlags.NoFileIo == TRUE)
 #define IsParanoid(Table) ((Table)->TableCreateFlags.Paranoid == TRUE)
 #define IsIndexOnly(Table) ((Table)->TableCreateFlags.IndexOnly != FALSE)
+#define IsOrderPreserving(Table) \
+    ((Table)->TableCreateFlags.OrderPreserving != FALSE)
 #define UseRwsSectionForTableValues(Table) \
     ((Table)->TableCreateFlags.UseRwsSectionForTableValues != FALSE)
 
@@ -80,6 +88,17 @@ typedef PERFECT_HASH_TABLE_STATE *PPERFECT_HASH_TABLE_STATE;
 #define WasTableDataHeapAllocated(Table) \
     ((Table)->State.TableDataWasHeapAllocated == TRUE)
 
+#define WereFingerprintsHeapAllocated(Table) \
+    ((Table)->State.FingerprintsWereHeapAllocated == TRUE)
+
+#define HasFingerprints(Table) ((Table)->FingerprintSizeInBytes != 0)
+
+#define IsInterleavedTableDataLayout(Table) \
+    ((Table)->TableDataLayoutId == TableDataLayoutInterleavedId)
+
+#define IsPackedTableDataLayout(Table) \
+    ((Table)->TableDataLayoutId == TableDataLayoutPackedId)
+
 #define IncludeNumberOfTableResizeEventsInOutputPath(Table) (                  \
     ((Table)->TableCreateFlags.IncludeNumberOfTableResizeEventsInOutputPath == \
      TRUE)                                                                     \
@@ -146,6 +165,36 @@ typedef struct _Struct_size_bytes_(SizeOfStruct) _PERFECT_HASH_TABLE {
 
     ULONG ValueSizeInBytes;
 
+    //
+    // Size of an individual key fingerprint, in bytes, if the table was created
+    // with the --FingerprintSizeInBytes parameter (either 1 or 2 bytes), or 0
+    // if the table has no fingerprints.
+    //
+
+    ULONG FingerprintSizeInBytes;
+
+    //
+    // Layout of the table data and values arrays, as specified by the
+    // --TableDataLayout parameter.  Defaults to TableDataLayoutSeparateId.
+    //
+
+    PERFECT_HASH_TABLE_DATA_LAYOUT_ID TableDataLayoutId;
+
+    //
+    // Number of bits used to store each table data element if the table uses
+    // the packed table data layout, otherwise 0.
+    //
+
+    ULONG TableDataBitsPerElement;
+
+    //
+    // Average number of distinct cache lines touched when looking up a key's
+    // value, as measured over all keys during graph verification.  Accounts
+    // for both table data elements and the value, per the table data layout.
+    //
+
+    DOUBLE CacheLinesPerLookup;
+
     //
     // Optional table creation parameters specified to Create().
     //
@@ -197,6 +246,20 @@ typedef struct _Struct_size_bytes_(SizeOfStruct) _PERFECT_HASH_TABLE {
         PVOID TableDataBaseAddress;
     };
 
+    //
+    // If the table has fingerprints, a pointer to the fingerprints array.  It
+    // has the same number of elements as the values array, and is indexed by
+    // the result of the Index() routine.  During creation, this is a heap
+    // allocation populated by the graph verification step.  During the load
+    // phase, it points into the table file, just past the table data.
+    //
+
+    union {
+        PVOID Fingerprints;
+        PBYTE Fingerprints8;
+        PUSHORT Fingerprints16;
+    };
+
     //
     // Capture the number of elements in the underlying perfect hash table.
     // This refers to the number of vertices for the CHM algorithm, or can
@@ -331,6 +394,16 @@ typedef struct _Struct_size_bytes_(SizeOfStruct) _PERFECT_HASH_TABLE {
 
     PPERFECT_HASH_KEYS Keys;
 
+    //
+    // If the table was created from string keys, or loaded with the string
+    // keys it was created from, a reference to those keys.  Unlike the Keys
+    // field above, this is retained for the lifetime of the table, such that
+    // the TryIndexString() and TryLookupString() routines can compare a string
+    // against the string stored at its index.  May be NULL.
+    //
+
+    PPERFECT_HASH_KEYS StringKeys;
+
     //
     // Pointer to the PERFECT_HASH_CONTEXT structure in use.
     //
@@ -356,6 +429,7 @@ typedef struct _Struct_size_bytes_(SizeOfStruct) _PERFECT_HASH_TABLE {
     PCSTRING KeysArrayTypeName;
     PCSTRING TableDataArrayTypeName;
     PCSTRING OriginalKeySizeTypeName;
+    PCSTRING FingerprintTypeName;
     union {
         PCSTRING ValueTypeName;
         PCSTRING TableValuesArrayTypeName;
@@ -430,6 +504,23 @@ typedef struct _Struct_size_bytes_(SizeOfStruct) _PERFECT_HASH_TABLE {
     ULONGLONG RngSubsequence;
     ULONGLONG RngOffset;
 
+    //
+    // Shard01 state.  NumberOfShards is valid for both created and loaded
+    // tables.  The remaining fields are only used during table creation: the
+    // keys are partitioned by shard into ShardedKeys, the shard directory is
+    // captured in Shards, and each shard's solved assigned array is copied
+    // into ShardAssigned (at offset Shard * HashSize).  See Shard01.h.
+    //
+
+    ULONG NumberOfShards;
+    ULONG MaximumNumberOfKeysPerShard;
+    volatile LONG NextShard;
+    volatile LONG NumberOfShardsRemaining;
+    PULONG ShardedKeys;
+    struct _SHARD01_DIRECTORY_ENTRY *Shards;
+    PULONG ShardAssigned;
+    SIZE_T ShardAssignedSizeInBytes;
+
     //
     // Backing vtbl.
     //
@@ -584,6 +675,157 @@ VOID
     );
 typedef PERFECT_HASH_TABLE_RUNDOWN *PPERFECT_HASH_TABLE_RUNDOWN;
 
+//
+// The batch routines (IndexBatch(), LookupBatch() and InsertBatch()) process
+// keys in groups of PERFECT_HASH_TABLE_BATCH_GROUP_SIZE: every key in a group
+// is hashed and its table data slots prefetched before any of the group's
+// slots are accessed.  The group size bounds the number of outstanding misses
+// per group; 16 comfortably exceeds the number of line fill buffers on current
+// cores without spilling the per-group state out of registers and L1.
+//
+
+#define PERFECT_HASH_TABLE_BATCH_GROUP_SIZE 16
+
+//
+// Key fingerprint support.
+//
+// A fingerprint is derived from an unseeded mix of the key (the "lowbias32"
+// integer hash), keeping the top 8 or 16 bits.  It is independent of the
+// table's seeded hash functions, and thus, of the index a key resolves to.
+//
+// N.B. The mixing constants and shifts are duplicated by CphFingerprintKey()
+//      in ../../include/CompiledPerfectHash.h, which is used by compiled
+//      tables; if you change them here, change them there too.
+//
+
+#define PERFECT_HASH_FINGERPRINT_MULTIPLIER1 0x7feb352d
+#define PERFECT_HASH_FINGERPRINT_MULTIPLIER2 0x846ca68b
+
+FORCEINLINE
+ULONG
+PerfectHashTableFingerprintKey(
+    _In_ ULONG Key,
+    _In_ ULONG FingerprintSizeInBytes
+    )
+/*++
+
+Routine Description:
+
+    Calculates the fingerprint of a key.
+
+Arguments:
+
+    Key - Supplies the key to fingerprint.
+
+    FingerprintSizeInBytes - Supplies the fingerprint size, in bytes (1 or 2).
+
+Return Value:
+
+    The fingerprint of the key.
+
+--*/
+{
+    ULONG Hash;
+
+    Hash = Key;
+    Hash ^= Hash >> 16;
+    Hash *= PERFECT_HASH_FINGERPRINT_MULTIPLIER1;
+    Hash ^= Hash >> 15;
+    Hash *= PERFECT_HASH_FINGERPRINT_MULTIPLIER2;
+    Hash ^= Hash >> 16;
+
+    return Hash >> (32 - (FingerprintSizeInBytes << 3));
+}
+
+FORCEINLINE
+VOID
+PerfectHashTableStoreFingerprint(
+    _In_ PPERFECT_HASH_TABLE Table,
+    _In_ ULONG Index,
+    _In_ ULONG Key
+    )
+/*++
+
+Routine Description:
+
+    Stores the fingerprint of a key at the given index of the table's
+    fingerprints array, if the table has one.  This is called by the graph
+    verification routines for each key as its index is resolved.
+
+Arguments:
+
+    Table - Supplies a pointer to the table.
+
+    Index - Supplies the index of the key.
+
+    Key - Supplies the key.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ULONG Fingerprint;
+
+    if (!Table->Fingerprints) {
+        return;
+    }
+
+    Fingerprint = PerfectHashTableFingerprintKey(Key,
+                                                 Table->FingerprintSizeInBytes);
+
+    if (Table->FingerprintSizeInBytes == sizeof(BYTE)) {
+        Table->Fingerprints8[Index] = (BYTE)Fingerprint;
+    } else {
+        Table->Fingerprints16[Index] = (USHORT)Fingerprint;
+    }
+}
+
+FORCEINLINE
+BOOLEAN
+PerfectHashTableFingerprintMatches(
+    _In_ PPERFECT_HASH_TABLE Table,
+    _In_ ULONG Index,
+    _In_ ULONG Key
+    )
+/*++
+
+Routine Description:
+
+    Compares the fingerprint of a key against the fingerprint stored at the
+    given index.  The caller is responsible for ensuring the table has
+    fingerprints.
+
+Arguments:
+
+    Table - Supplies a pointer to the table.
+
+    Index - Supplies the index of the key.
+
+    Key - Supplies the key.
+
+Return Value:
+
+    TRUE if the fingerprints match, FALSE otherwise.
+
+--*/
+{
+    ULONG Fingerprint;
+    ULONG Stored;
+
+    Fingerprint = PerfectHashTableFingerprintKey(Key,
+                                                 Table->FingerprintSizeInBytes);
+
+    if (Table->FingerprintSizeInBytes == sizeof(BYTE)) {
+        Stored = Table->Fingerprints8[Index];
+    } else {
+        Stored = Table->Fingerprints16[Index];
+    }
+
+    return (Fingerprint == Stored);
+}
+
 //
 // Function decls.
 //
@@ -604,6 +846,12 @@ extern PERFECT_HASH_TABLE_INSERT PerfectHashTableInsert;
 extern PERFECT_HASH_TABLE_LOOKUP PerfectHashTableLookup;
 extern PERFECT_HASH_TABLE_DELETE PerfectHashTableDelete;
 extern PERFECT_HASH_TABLE_INDEX PerfectHashTableIndex;
+extern PERFECT_HASH_TABLE_LOOKUP_BATCH PerfectHashTableLookupBatch;
+extern PERFECT_HASH_TABLE_INSERT_BATCH PerfectHashTableInsertBatch;
+extern PERFECT_HASH_TABLE_CONTAINS PerfectHashTableContains;
+extern PERFECT_HASH_TABLE_TRY_LOOKUP PerfectHashTableTryLookup;
+extern PERFECT_HASH_TABLE_TRY_INDEX_STRING PerfectHashTableTryIndexString;
+extern PERFECT_HASH_TABLE_TRY_LOOKUP_STRING PerfectHashTableTryLookupString;
 extern PERFECT_HASH_TABLE_GET_ALGORITHM_NAME
     PerfectHashTableGetAlgorithmName;
 extern PERFECT_HASH_TABLE_GET_HASH_FUNCTION_NAME
@@ -656,8 +904,99 @@ PERFECT_HASH_HASH_FUNCTION_TABLE_ENTRY(EXPAND_AS_SEEDED_HASH_FUNC_DECL);
 PERFECT_HASH_TABLE_MASK_HASH PerfectHashTableMaskHashModulus;
 PERFECT_HASH_TABLE_MASK_HASH PerfectHashTableMaskHashAnd;
 
+PERFECT_HASH_TABLE_MASK_HASH PerfectHashTableMaskHashMultiplyHigh;
+
 PERFECT_HASH_TABLE_MASK_INDEX PerfectHashTableMaskIndexModulus;
 PERFECT_HASH_TABLE_MASK_INDEX PerfectHashTableMaskIndexAnd;
+PERFECT_HASH_TABLE_MASK_INDEX PerfectHashTableMaskIndexMultiplyHigh;
+
+//
+// Multiply-high masking support.
+//
+// The multiply-high range reduction uses the high bits of each hash value,
+// whereas most of our hash functions were designed with AND masking in mind,
+// and thus, concentrate their entropy in the low bits (e.g. MultiplyShiftR's
+// output is confined to the low bits entirely).  So, each hash value is first
+// multiplied by an odd constant, which is a bijection, and ensures the high
+// bits of the result depend upon all the input bits.  (The same trick is used
+// by Bdz01; see Bdz01.h.)
+//
+// As there's nothing to mask, the hash and index masks of a multiply-high
+// table are all ones; the number of vertices and edges are captured by the
+// hash and index modulus fields instead.
+//
+// N.B. The multiplier is duplicated in the compiled perfect hash table Index()
+//      implementations in ../CompiledPerfectHashTable/*MultiplyHigh.c; if you
+//      change it here, change it there too.
+//
+
+#define MULTIPLY_HIGH_MASK 0xffffffff
+#define MULTIPLY_HIGH_HASH_MULTIPLIER 0x9e3779b1
+
+FORCEINLINE
+ULONG
+MultiplyHighReduceHash(
+    _In_ ULONG Hash,
+    _In_ ULONG HashModulus
+    )
+/*++
+
+Routine Description:
+
+    Reduces a 32-bit hash value into the range [0, HashModulus).
+
+Arguments:
+
+    Hash - Supplies the unmasked hash value.
+
+    HashModulus - Supplies the number of vertices.
+
+Return Value:
+
+    The vertex, between 0 and HashModulus-1.
+
+--*/
+{
+    ULONG Mixed;
+
+    Mixed = Hash * MULTIPLY_HIGH_HASH_MULTIPLIER;
+
+    return (ULONG)(((ULONGLONG)Mixed * (ULONGLONG)HashModulus) >> 32);
+}
+
+FORCEINLINE
+ULONG
+MultiplyHighReduceIndex(
+    _In_ ULONGLONG Combined,
+    _In_ ULONG IndexModulus
+    )
+/*++
+
+Routine Description:
+
+    Reduces the sum of two assigned values into a final index.  The graph
+    assignment step keeps each assigned value below the number of edges, so
+    the sum is less than twice that, and a single conditional subtraction is
+    sufficient.
+
+Arguments:
+
+    Combined - Supplies the sum of the two assigned values.
+
+    IndexModulus - Supplies the number of edges.
+
+Return Value:
+
+    The index, between 0 and IndexModulus-1.
+
+--*/
+{
+    if (Combined >= IndexModulus) {
+        Combined -= IndexModulus;
+    }
+
+    return (ULONG)Combined;
+}
 
 //
 // "Ex" versions of hash and seeded hash routines.
@@ -673,4 +1012,120 @@ PERFECT_HASH_HASH_FUNCTION_TABLE_ENTRY(EXPAND_AS_HASH_EX_FUNC_DECL);
 
 PERFECT_HASH_HASH_FUNCTION_TABLE_ENTRY(EXPAND_AS_SEEDED_HASH_EX_FUNC_DECL);
 
+//
+// Multiply-high versions of the seeded hash "Ex" routines.  These are called
+// with the hash modulus (i.e. the number of vertices) in lieu of a mask, and
+// reduce each of the two hash values via MultiplyHighReduceHash().
+//
+
+#define EXPAND_AS_SEEDED_HASH_EX_MULTIPLY_HIGH_FUNC_DECL( \
+    Name, NumberOfSeeds, SeedMasks                        \
+)                                                         \
+    PERFECT_HASH_TABLE_SEEDED_HASH_EX                     \
+        PerfectHashTableSeededHashExMultiplyHigh##Name;
+
+PERFECT_HASH_HASH_FUNCTION_TABLE_ENTRY(
+    EXPAND_AS_SEEDED_HASH_EX_MULTIPLY_HIGH_FUNC_DECL
+);
+
+FORCEINLINE
+ULONG
+GetSeededHashExMask(
+    _In_ PPERFECT_HASH_TABLE Table
+    )
+/*++
+
+Routine Description:
+
+    Returns the value to supply as the Mask parameter of the table's seeded
+    hash "Ex" routine: the hash mask for AND masking, or the hash modulus for
+    multiply-high masking.
+
+Arguments:
+
+    Table - Supplies a pointer to the table.
+
+Return Value:
+
+    The mask value.
+
+--*/
+{
+    if (IsMultiplyHighMasking(Table->MaskFunctionId)) {
+        return Table->HashModulus;
+    }
+
+    return Table->HashMask;
+}
+
+//
+// Batch versions of the seeded hash "Ex" routines (see
+// PerfectHashTableHashExBatch.c).  These hash an array of keys into an array
+// of vertex pairs, stopping at the first key whose vertices collide.
+//
+
+typedef
+_Must_inspect_result_
+_Success_(return >= 0)
+HRESULT
+(STDAPICALLTYPE PERFECT_HASH_TABLE_SEEDED_HASH_EX_BATCH)(
+    _In_reads_(NumberOfKeys) PULONG Keys,
+    _In_ ULONG NumberOfKeys,
+    _In_ PULONG Seeds,
+    _In_ ULONG Mask,
+    _Out_writes_(NumberOfKeys) PULONGLONG VertexPairs,
+    _Out_ PULONG CollisionIndex
+    );
+typedef PERFECT_HASH_TABLE_SEEDED_HASH_EX_BATCH
+      *PPERFECT_HASH_TABLE_SEEDED_HASH_EX_BATCH;
+
+typedef
+_Must_inspect_result_
+PPERFECT_HASH_TABLE_SEEDED_HASH_EX_BATCH
+(NTAPI GET_SEEDED_HASH_EX_BATCH_ROUTINE)(
+    _In_ PRTL Rtl,
+    _In_ PERFECT_HASH_HASH_FUNCTION_ID HashFunctionId
+    );
+typedef GET_SEEDED_HASH_EX_BATCH_ROUTINE *PGET_SEEDED_HASH_EX_BATCH_ROUTINE;
+extern GET_SEEDED_HASH_EX_BATCH_ROUTINE GetSeededHashExBatchRoutine;
+
+//
+// Multi-seed versions of the batch routines.  These make a single pass over
+// the keys, hashing each key against multiple seed sets at once (the SIMD
+// lanes are spread across seed sets rather than keys), and write a separate
+// vertex pairs array for each seed set.  Seed sets are laid out contiguously,
+// MAX_NUMBER_OF_SEEDS ULONGs apart; vertex pairs arrays are VertexPairsStride
+// elements apart.  A collision in one seed set does not stop the others; the
+// index of the first colliding key is captured per seed set instead (or the
+// number of keys if there was no collision).
+//
+
+typedef
+_Must_inspect_result_
+_Success_(return >= 0)
+HRESULT
+(STDAPICALLTYPE PERFECT_HASH_TABLE_SEEDED_HASH_EX_MULTI_SEED)(
+    _In_reads_(NumberOfKeys) PULONG Keys,
+    _In_ ULONG NumberOfKeys,
+    _In_ PULONG SeedSets,
+    _In_ ULONG Mask,
+    _Out_ PULONGLONG VertexPairs,
+    _In_ ULONG VertexPairsStride,
+    _Out_ PULONG CollisionIndexes
+    );
+typedef PERFECT_HASH_TABLE_SEEDED_HASH_EX_MULTI_SEED
+      *PPERFECT_HASH_TABLE_SEEDED_HASH_EX_MULTI_SEED;
+
+typedef
+_Must_inspect_result_
+PPERFECT_HASH_TABLE_SEEDED_HASH_EX_MULTI_SEED
+(NTAPI GET_SEEDED_HASH_EX_MULTI_SEED_ROUTINE)(
+    _In_ PRTL Rtl,
+    _In_ PERFECT_HASH_HASH_FUNCTION_ID HashFunctionId,
+    _Out_ PULONG NumberOfSeedSets
+    );
+typedef GET_SEEDED_HASH_EX_MULTI_SEED_ROUTINE
+      *PGET_SEEDED_HASH_EX_MULTI_SEED_ROUTINE;
+extern GET_SEEDED_HASH_EX_MULTI_SEED_ROUTINE GetSeededHashExMultiSeedRoutine;
+
 // vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
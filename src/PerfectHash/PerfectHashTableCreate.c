@@ -438,7 +438,7 @@ Return Value:
 
         //
         // Invariant checks: the number of table elements should be greater than
-        // zero, and, if non-modulus masking is active, should be a power of 2.
+        // zero, and, if AND masking is active, should be a power of 2.
         //
 
         if (RequestedNumberOfTableElements->QuadPart == 0) {
@@ -448,6 +448,7 @@ Return Value:
         }
 
         if (!IsModulusMasking(MaskFunctionId) &&
+            !IsMultiplyHighMasking(MaskFunctionId) &&
             !IsPowerOfTwo(RequestedNumberOfTableElements->QuadPart)) {
             Result = PH_E_INVARIANT_CHECK_FAILED;
             PH_ERROR(PerfectHashTableCreate_NumTableElemsNotPow2, Result);
@@ -486,6 +487,17 @@ Return Value:
         }
     }
 
+    //
+    // If the table was created from string keys, retain a reference to them
+    // for the TryIndexString() and TryLookupString() routines (Table->Keys is
+    // released below).
+    //
+
+    if (KeysAreStrings(Keys)) {
+        Keys->Vtbl->AddRef(Keys);
+        Table->StringKeys = Keys;
+    }
+
     Table->Flags.Created = TRUE;
     Table->Flags.Loaded = FALSE;
     Table->State.Valid = TRUE;
@@ -698,6 +710,33 @@ Return Value:
                 }
                 break;
 
+            case TableCreateParameterFingerprintSizeInBytesId:
+                if (Param->AsULong != 1 && Param->AsULong != 2) {
+                    Result = PH_E_INVALID_FINGERPRINT_SIZE_IN_BYTES_PARAMETER;
+                    goto Error;
+                }
+
+                //
+                // Fingerprints are captured by the graph verification step,
+                // so it can't be skipped.
+                //
+
+                if (Table->TableCreateFlags.SkipGraphVerification != FALSE) {
+                    Result = PH_E_FINGERPRINTS_REQUIRE_GRAPH_VERIFICATION;
+                    goto Error;
+                }
+                Table->FingerprintSizeInBytes = Param->AsULong;
+                break;
+
+            case TableCreateParameterTableDataLayoutId:
+                if (!IsValidPerfectHashTableDataLayoutId(
+                        Param->AsTableDataLayoutId)) {
+                    Result = PH_E_INVALID_TABLE_DATA_LAYOUT;
+                    goto Error;
+                }
+                Table->TableDataLayoutId = Param->AsTableDataLayoutId;
+                break;
+
             case TableCreateParameterSeed3Byte1MaskCountsId:
                 ASSERT(TableCreateParams->Flags.HasSeedMaskCounts != FALSE);
                 Context->Seed3Byte1MaskCounts = &Param->AsSeedMaskCounts;
@@ -934,6 +973,92 @@ Return Value:
     }
     Table->GraphImpl = GraphImpl;
 
+    //
+    // Validate the table data layout.  The interleaved layout relies on the
+    // version 3 graph assignment routine indexing values by vertex rather than
+    // by edge, and is only implemented for Chm01 with And masking.  As values
+    // are what get interleaved, it's meaningless for index-only tables.  It
+    // also requires a different Index() implementation in the compiled table.
+    //
+
+    if (Table->TableDataLayoutId == TableDataLayoutNullId) {
+        Table->TableDataLayoutId = TableDataLayoutSeparateId;
+    }
+
+    if (IsInterleavedTableDataLayout(Table)) {
+
+        if (Table->AlgorithmId != PerfectHashChm01AlgorithmId ||
+            Table->MaskFunctionId != PerfectHashAndMaskFunctionId ||
+            GraphImpl != 3 ||
+            IsIndexOnly(Table)) {
+            Result = PH_E_TABLE_DATA_LAYOUT_NOT_SUPPORTED;
+            goto Error;
+        }
+
+        Table->IndexImplString = GetInterleavedIndexImplString(Table);
+        if (!Table->IndexImplString) {
+            Result = PH_E_NO_INDEX_IMPL_C_STRING_FOUND;
+            goto Error;
+        }
+    }
+
+    //
+    // The packed table data layout relies on And masking for the number of
+    // bits per element to be known (the edge mask bits), and requires both
+    // different runtime index routines and a different Index() implementation
+    // in the compiled table.  The former were skipped when the table's vtbl
+    // was initialized above (as the layout wasn't known at the time), so
+    // complete the initialization again now.
+    //
+
+    if (IsPackedTableDataLayout(Table)) {
+
+        if (Table->AlgorithmId != PerfectHashChm01AlgorithmId ||
+            Table->MaskFunctionId != PerfectHashAndMaskFunctionId) {
+            Result = PH_E_PACKED_TABLE_DATA_LAYOUT_NOT_SUPPORTED;
+            goto Error;
+        }
+
+        CompletePerfectHashTableInitialization(Table);
+        if (!Table->IndexImplString) {
+            Result = PH_E_NO_INDEX_IMPL_C_STRING_FOUND;
+            goto Error;
+        }
+    }
+
+    //
+    // String keys are always order preserving: the compiled table verifies a
+    // string by comparing it against the string at the resulting index, which
+    // requires the index of each key to be its offset in the key array.
+    //
+
+    if (KeysAreStrings(Table->Keys)) {
+        Table->TableCreateFlags.OrderPreserving = TRUE;
+    }
+
+    //
+    // Validate order preservation.  Shard01 reshards keys prior to solving,
+    // and the interleaved layout indexes values by vertex, so neither yield
+    // an index equal to the key's offset in the keys file.  Likewise, if the
+    // keys were sorted and deduplicated as part of loading (e.g. a text keys
+    // file loaded with SortKeys), the key array no longer matches the keys
+    // file.  (String, 128-bit and compressed keys ignore the SortKeys flag.)
+    //
+
+    if (IsOrderPreserving(Table)) {
+        if (IsShard01(Table) || IsInterleavedTableDataLayout(Table)) {
+            Result = PH_E_ORDER_PRESERVING_NOT_SUPPORTED;
+            goto Error;
+        }
+
+        if (Table->Keys->LoadFlags.SortKeys != FALSE &&
+            !KeysWereReduced(Table->Keys) &&
+            !KeysWereCompressed(Table->Keys)) {
+            Result = PH_E_ORDER_PRESERVING_NOT_SUPPORTED;
+            goto Error;
+        }
+    }
+
     //
     // Use our default global NT-style C type names array for now.
     //
@@ -2307,4 +2307,39 @@ PerfectHashTableHashEx##Name(                                     \
 
 PERFECT_HASH_HASH_FUNCTION_TABLE_ENTRY(EXPAND_AS_HASH_EX_ROUTINE);
 
+//
+// Multiply-high versions of the seeded hash "Ex" routines.  The underlying
+// routine is called with an all-ones mask, such that the full 32-bit hash
+// values are available for the range reduction.
+//
+
+#define EXPAND_AS_SEEDED_HASH_EX_MULTIPLY_HIGH_ROUTINE(                  \
+    Name, NumberOfSeeds, SeedMasks                                       \
+)                                                                        \
+_Use_decl_annotations_                                                   \
+ULONGLONG                                                                \
+PerfectHashTableSeededHashExMultiplyHigh##Name(                          \
+    ULONG Key,                                                           \
+    PULONG Seeds,                                                        \
+    ULONG HashModulus                                                    \
+    )                                                                    \
+{                                                                        \
+    ULARGE_INTEGER Hash;                                                 \
+                                                                         \
+    Hash.QuadPart = PerfectHashTableSeededHashEx##Name(                  \
+        Key,                                                             \
+        Seeds,                                                           \
+        MULTIPLY_HIGH_MASK                                               \
+    );                                                                   \
+                                                                         \
+    Hash.LowPart = MultiplyHighReduceHash(Hash.LowPart, HashModulus);    \
+    Hash.HighPart = MultiplyHighReduceHash(Hash.HighPart, HashModulus);  \
+                                                                         \
+    return Hash.QuadPart;                                                \
+}
+
+PERFECT_HASH_HASH_FUNCTION_TABLE_ENTRY(
+    EXPAND_AS_SEEDED_HASH_EX_MULTIPLY_HIGH_ROUTINE
+);
+
 // vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -0,0 +1,854 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    PerfectHashTableHashExBatch.c
+
+Abstract:
+
+    This module implements batch versions of the seeded hash "Ex" routines,
+    which hash an entire array of keys into an array of vertex pairs in a
+    single call.  They are used by GraphHashKeys() in lieu of calling the
+    SeededHashEx() routine once per key via a function pointer.
+
+    AVX2 (8 keys per iteration) and AVX-512 (16 keys per iteration) versions
+    are provided for the multiply/shift/rotate/xor family of hash functions;
+    the CRC32-based hash functions get a 4-way interleaved scalar version, as
+    there's no vector equivalent of the crc32 instruction.  The appropriate
+    routine is selected at runtime based on the CPU features available; see
+    GetSeededHashExBatchRoutine().
+
+    Each batch routine is semantically identical to calling the corresponding
+    SeededHashEx() routine for each key: the same vertex pairs are produced,
+    and the first key whose masked vertices are identical is reported as a
+    vertex collision.
+
+    Multi-seed variants of the vectorized routines are also provided, which
+    hash each key against multiple seed sets in a single pass over the keys;
+    see GetSeededHashExMultiSeedRoutine().
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Define the 8-lane (AVX2) vector primitives used by the hash "guts" below.
+// Shift and rotate amounts are uniform across all lanes (they're derived from
+// seed bytes), so the non-immediate, count-in-XMM register forms are used.
+//
+
+#define YMM_BROADCAST(Value) _mm256_set1_epi32((INT)(Value))
+#define YMM_MUL(A, B) _mm256_mullo_epi32(A, B)
+#define YMM_XOR(A, B) _mm256_xor_si256(A, B)
+#define YMM_AND(A, B) _mm256_and_si256(A, B)
+#define YMM_SHR(A, N) _mm256_srl_epi32(A, _mm_cvtsi32_si128((INT)(N)))
+#define YMM_SHL(A, N) _mm256_sll_epi32(A, _mm_cvtsi32_si128((INT)(N)))
+#define YMM_ROR(A, N) YMM_OR(YMM_SHR(A, N), YMM_SHL(A, 32 - (N)))
+#define YMM_ROL(A, N) YMM_OR(YMM_SHL(A, N), YMM_SHR(A, 32 - (N)))
+#define YMM_OR(A, B) _mm256_or_si256(A, B)
+
+//
+// Define the 16-lane (AVX-512) equivalents.
+//
+
+#define ZMM_BROADCAST(Value) _mm512_set1_epi32((INT)(Value))
+#define ZMM_MUL(A, B) _mm512_mullo_epi32(A, B)
+#define ZMM_XOR(A, B) _mm512_xor_si512(A, B)
+#define ZMM_AND(A, B) _mm512_and_si512(A, B)
+#define ZMM_SHR(A, N) _mm512_srl_epi32(A, _mm_cvtsi32_si128((INT)(N)))
+#define ZMM_SHL(A, N) _mm512_sll_epi32(A, _mm_cvtsi32_si128((INT)(N)))
+#define ZMM_ROR(A, N) _mm512_rorv_epi32(A, ZMM_BROADCAST(N))
+#define ZMM_ROL(A, N) _mm512_rolv_epi32(A, ZMM_BROADCAST(N))
+
+//
+// Define the hash "guts" for each supported hash function in terms of the
+// vector primitives above.  These mirror the scalar implementations in
+// PerfectHashTableHashEx.c exactly; V is the vector prefix (YMM or ZMM), K
+// is the vector of keys, and V1/V2 receive the unmasked vertices.
+//
+
+#define HASH_GUTS_MultiplyShiftR(V, K, V1, V2)     \
+    V1 = V##_MUL(K, V##_BROADCAST(Seed1));         \
+    V1 = V##_SHR(V1, Seed3.Byte1);                 \
+    V2 = V##_MUL(K, V##_BROADCAST(Seed2));         \
+    V2 = V##_SHR(V2, Seed3.Byte2)
+
+#define HASH_GUTS_MultiplyShiftLR(V, K, V1, V2)    \
+    V1 = V##_MUL(K, V##_BROADCAST(Seed1));         \
+    V1 = V##_SHL(V1, Seed3.Byte1);                 \
+    V2 = V##_MUL(K, V##_BROADCAST(Seed2));         \
+    V2 = V##_SHR(V2, Seed3.Byte2)
+
+#define HASH_GUTS_MultiplyRotateR(V, K, V1, V2)    \
+    V1 = V##_MUL(K, V##_BROADCAST(Seed1));         \
+    V1 = V##_ROR(V1, Seed3.Byte1);                 \
+    V2 = V##_MUL(K, V##_BROADCAST(Seed2));         \
+    V2 = V##_ROR(V2, Seed3.Byte2)
+
+#define HASH_GUTS_MultiplyRotateLR(V, K, V1, V2)   \
+    V1 = V##_MUL(K, V##_BROADCAST(Seed1));         \
+    V1 = V##_ROL(V1, Seed3.Byte1);                 \
+    V2 = V##_MUL(K, V##_BROADCAST(Seed2));         \
+    V2 = V##_ROR(V2, Seed3.Byte2)
+
+#define HASH_GUTS_RotateMultiplyXorRotate(V, K, V1, V2) \
+    V1 = V##_ROR(K, Seed3.Byte1);                       \
+    V1 = V##_MUL(V1, V##_BROADCAST(Seed1));             \
+    V1 = V##_XOR(V1, V##_ROR(V1, Seed3.Byte2));         \
+    V2 = V##_ROR(K, Seed3.Byte3);                       \
+    V2 = V##_MUL(V2, V##_BROADCAST(Seed2));             \
+    V2 = V##_XOR(V2, V##_ROR(V2, Seed3.Byte4))
+
+#define HASH_GUTS_ShiftMultiplyXorShift(V, K, V1, V2)   \
+    V1 = V##_SHR(K, Seed3.Byte1);                       \
+    V1 = V##_MUL(V1, V##_BROADCAST(Seed1));             \
+    V1 = V##_XOR(V1, V##_SHR(V1, Seed3.Byte2));         \
+    V2 = V##_SHR(K, Seed3.Byte3);                       \
+    V2 = V##_MUL(V2, V##_BROADCAST(Seed2));             \
+    V2 = V##_XOR(V2, V##_SHR(V2, Seed3.Byte4))
+
+#define HASH_GUTS_MultiplyXor(V, K, V1, V2)        \
+    V1 = V##_MUL(K, V##_BROADCAST(Seed1));         \
+    V1 = V##_XOR(V1, V##_BROADCAST(Seed2));        \
+    V2 = V##_MUL(K, V##_BROADCAST(Seed3.AsULong)); \
+    V2 = V##_XOR(V2, V##_BROADCAST(Seed4))
+
+//
+// Define an X-macro for the hash functions that have vectorized batch
+// implementations.
+//
+
+#define SEEDED_HASH_EX_BATCH_VECTOR_TABLE(ENTRY) \
+    ENTRY(MultiplyShiftR)                        \
+    ENTRY(MultiplyShiftLR)                       \
+    ENTRY(MultiplyRotateR)                       \
+    ENTRY(MultiplyRotateLR)                      \
+    ENTRY(RotateMultiplyXorRotate)               \
+    ENTRY(ShiftMultiplyXorShift)                 \
+    ENTRY(MultiplyXor)
+
+#define EXPAND_AS_VECTOR_BATCH_FUNC_DECL(Name)                               \
+    PERFECT_HASH_TABLE_SEEDED_HASH_EX_BATCH                                  \
+        PerfectHashTableSeededHashExBatch##Name##_AVX2;                      \
+    PERFECT_HASH_TABLE_SEEDED_HASH_EX_BATCH                                  \
+        PerfectHashTableSeededHashExBatch##Name##_AVX512;
+
+SEEDED_HASH_EX_BATCH_VECTOR_TABLE(EXPAND_AS_VECTOR_BATCH_FUNC_DECL);
+
+//
+// Seeds are loaded uniformly by all batch routines, regardless of how many
+// seeds the underlying hash function actually uses.  This is safe as the
+// seeds array always points at the graph's (or table's) full set of seeds.
+//
+
+#define LOAD_SEEDS()              \
+    Seed1 = Seeds[0];             \
+    Seed2 = Seeds[1];             \
+    Seed3.AsULong = Seeds[2];     \
+    Seed4 = Seeds[3]
+
+//
+// Helper for the scalar tail of each batch routine (i.e. the keys left over
+// after the last full vector), as well as for reporting a collision.
+//
+
+#define HASH_TAIL(Name)                                                     \
+    for (NOTHING; Index < NumberOfKeys; Index++) {                          \
+        Hash.QuadPart = PerfectHashTableSeededHashEx##Name(Keys[Index],     \
+                                                           Seeds,           \
+                                                           Mask);           \
+        if (Hash.LowPart == Hash.HighPart) {                                \
+            *CollisionIndex = Index;                                        \
+            return PH_E_GRAPH_VERTEX_COLLISION_FAILURE;                     \
+        }                                                                   \
+        VertexPairs[Index] = Hash.QuadPart;                                 \
+    }                                                                       \
+    return S_OK
+
+//
+// AVX2 implementations.
+//
+// N.B. _mm256_unpack{lo,hi}_epi32 interleave within each 128-bit lane, so
+//      vertices for keys 0-1 and 4-5 end up in Low, and keys 2-3 and 6-7 in
+//      High.  The two _mm256_permute2x128_si256 calls restore key order.
+//
+
+#define DEFINE_SEEDED_HASH_EX_BATCH_AVX2(Name)                               \
+_Use_decl_annotations_                                                       \
+HRESULT                                                                      \
+PerfectHashTableSeededHashExBatch##Name##_AVX2(                              \
+    PULONG Keys,                                                             \
+    ULONG NumberOfKeys,                                                      \
+    PULONG Seeds,                                                            \
+    ULONG Mask,                                                              \
+    PULONGLONG VertexPairs,                                                  \
+    PULONG CollisionIndex                                                    \
+    )                                                                        \
+{                                                                            \
+    ULONG Seed1;                                                             \
+    ULONG Seed2;                                                             \
+    ULONG_BYTES Seed3;                                                       \
+    ULONG Seed4;                                                             \
+    ULONG Index;                                                             \
+    ULONG Bits;                                                              \
+    ULONG Lane;                                                              \
+    ULONG VectorKeys;                                                        \
+    YMMWORD KeysYmm;                                                         \
+    YMMWORD Vertex1;                                                         \
+    YMMWORD Vertex2;                                                         \
+    YMMWORD Low;                                                             \
+    YMMWORD High;                                                            \
+    YMMWORD MaskYmm;                                                         \
+    ULARGE_INTEGER Hash;                                                     \
+                                                                             \
+    LOAD_SEEDS();                                                            \
+                                                                             \
+    MaskYmm = YMM_BROADCAST(Mask);                                           \
+    VectorKeys = NumberOfKeys & ~7UL;                                        \
+                                                                             \
+    for (Index = 0; Index < VectorKeys; Index += 8) {                        \
+        KeysYmm = _mm256_loadu_si256((PYMMWORD)&Keys[Index]);                \
+                                                                             \
+        HASH_GUTS_##Name(YMM, KeysYmm, Vertex1, Vertex2);                    \
+                                                                             \
+        Vertex1 = YMM_AND(Vertex1, MaskYmm);                                 \
+        Vertex2 = YMM_AND(Vertex2, MaskYmm);                                 \
+                                                                             \
+        Bits = (ULONG)_mm256_movemask_ps(                                    \
+            _mm256_castsi256_ps(_mm256_cmpeq_epi32(Vertex1, Vertex2))        \
+        );                                                                   \
+                                                                             \
+        if (Bits != 0) {                                                     \
+            _BitScanForward(&Lane, Bits);                                    \
+            *CollisionIndex = Index + Lane;                                  \
+            return PH_E_GRAPH_VERTEX_COLLISION_FAILURE;                      \
+        }                                                                    \
+                                                                             \
+        Low = _mm256_unpacklo_epi32(Vertex1, Vertex2);                       \
+        High = _mm256_unpackhi_epi32(Vertex1, Vertex2);                      \
+                                                                             \
+        _mm256_storeu_si256((PYMMWORD)&VertexPairs[Index],                   \
+                            _mm256_permute2x128_si256(Low, High, 0x20));     \
+        _mm256_storeu_si256((PYMMWORD)&VertexPairs[Index + 4],               \
+                            _mm256_permute2x128_si256(Low, High, 0x31));     \
+    }                                                                        \
+                                                                             \
+    HASH_TAIL(Name);                                                         \
+}
+
+//
+// AVX-512 implementations.  These follow the same approach as the AVX2
+// versions, except 16 keys are processed per iteration, the collision check
+// yields a mask register directly, and a two-source 64-bit permute is used to
+// restore key order after the 128-bit-lane-local unpacks.
+//
+
+#define DEFINE_SEEDED_HASH_EX_BATCH_AVX512(Name)                             \
+_Use_decl_annotations_                                                       \
+HRESULT                                                                      \
+PerfectHashTableSeededHashExBatch##Name##_AVX512(                            \
+    PULONG Keys,                                                             \
+    ULONG NumberOfKeys,                                                      \
+    PULONG Seeds,                                                            \
+    ULONG Mask,                                                              \
+    PULONGLONG VertexPairs,                                                  \
+    PULONG CollisionIndex                                                    \
+    )                                                                        \
+{                                                                            \
+    ULONG Seed1;                                                             \
+    ULONG Seed2;                                                             \
+    ULONG_BYTES Seed3;                                                       \
+    ULONG Seed4;                                                             \
+    ULONG Index;                                                             \
+    ULONG Bits;                                                              \
+    ULONG Lane;                                                              \
+    ULONG VectorKeys;                                                        \
+    ZMMWORD KeysZmm;                                                         \
+    ZMMWORD Vertex1;                                                         \
+    ZMMWORD Vertex2;                                                         \
+    ZMMWORD Low;                                                             \
+    ZMMWORD High;                                                            \
+    ZMMWORD MaskZmm;                                                         \
+    ZMMWORD FirstPermute;                                                    \
+    ZMMWORD SecondPermute;                                                   \
+    ULARGE_INTEGER Hash;                                                     \
+                                                                             \
+    LOAD_SEEDS();                                                            \
+                                                                             \
+    MaskZmm = ZMM_BROADCAST(Mask);                                           \
+    FirstPermute = _mm512_set_epi64(11, 10, 3, 2, 9, 8, 1, 0);               \
+    SecondPermute = _mm512_set_epi64(15, 14, 7, 6, 13, 12, 5, 4);            \
+    VectorKeys = NumberOfKeys & ~15UL;                                       \
+                                                                             \
+    for (Index = 0; Index < VectorKeys; Index += 16) {                       \
+        KeysZmm = _mm512_loadu_si512((PZMMWORD)&Keys[Index]);                \
+                                                                             \
+        HASH_GUTS_##Name(ZMM, KeysZmm, Vertex1, Vertex2);                    \
+                                                                             \
+        Vertex1 = ZMM_AND(Vertex1, MaskZmm);                                 \
+        Vertex2 = ZMM_AND(Vertex2, MaskZmm);                                 \
+                                                                             \
+        Bits = (ULONG)_mm512_cmpeq_epi32_mask(Vertex1, Vertex2);             \
+                                                                             \
+        if (Bits != 0) {                                                     \
+            _BitScanForward(&Lane, Bits);                                    \
+            *CollisionIndex = Index + Lane;                                  \
+            return PH_E_GRAPH_VERTEX_COLLISION_FAILURE;                      \
+        }                                                                    \
+                                                                             \
+        Low = _mm512_unpacklo_epi32(Vertex1, Vertex2);                       \
+        High = _mm512_unpackhi_epi32(Vertex1, Vertex2);                      \
+                                                                             \
+        _mm512_storeu_si512(                                                 \
+            (PZMMWORD)&VertexPairs[Index],                                   \
+            _mm512_permutex2var_epi64(Low, FirstPermute, High)               \
+        );                                                                   \
+        _mm512_storeu_si512(                                                 \
+            (PZMMWORD)&VertexPairs[Index + 8],                               \
+            _mm512_permutex2var_epi64(Low, SecondPermute, High)              \
+        );                                                                   \
+    }                                                                        \
+                                                                             \
+    HASH_TAIL(Name);                                                         \
+}
+
+SEEDED_HASH_EX_BATCH_VECTOR_TABLE(DEFINE_SEEDED_HASH_EX_BATCH_AVX2);
+SEEDED_HASH_EX_BATCH_VECTOR_TABLE(DEFINE_SEEDED_HASH_EX_BATCH_AVX512);
+
+//
+// Interleaved scalar implementations for the CRC32-based hash functions.
+// The crc32 instruction has a latency of three cycles but a throughput of
+// one per cycle, so hashing four keys at a time (eight independent crc32
+// instructions) keeps the pipeline full, in addition to avoiding the per-key
+// indirect call overhead.
+//
+
+#define HASH_GUTS_Crc32Rotate15(Key, Vertex1, Vertex2) \
+    Vertex1 = _mm_crc32_u32(Seed1, Key);               \
+    Vertex2 = _mm_crc32_u32(Seed2, _rotl(Key, 15))
+
+#define HASH_GUTS_Crc32RotateX(Key, Vertex1, Vertex2)  \
+    Vertex1 = _mm_crc32_u32(Seed1, Key);               \
+    Vertex2 = _mm_crc32_u32(Seed2, _rotl(Key, Seed3.Byte1))
+
+#define SEEDED_HASH_EX_BATCH_INTERLEAVED_TABLE(ENTRY) \
+    ENTRY(Crc32Rotate15)                              \
+    ENTRY(Crc32RotateX)
+
+#define EXPAND_AS_INTERLEAVED_BATCH_FUNC_DECL(Name)                          \
+    PERFECT_HASH_TABLE_SEEDED_HASH_EX_BATCH                                  \
+        PerfectHashTableSeededHashExBatch##Name##_Interleaved;
+
+SEEDED_HASH_EX_BATCH_INTERLEAVED_TABLE(EXPAND_AS_INTERLEAVED_BATCH_FUNC_DECL);
+
+#define HASH_ONE_INTERLEAVED(Name, N)                                        \
+    HASH_GUTS_##Name(Keys[Index + N], Vertex1[N], Vertex2[N]);               \
+    Vertex1[N] &= Mask;                                                      \
+    Vertex2[N] &= Mask
+
+#define STORE_ONE_INTERLEAVED(N)                                             \
+    if (Vertex1[N] == Vertex2[N]) {                                          \
+        *CollisionIndex = Index + N;                                         \
+        return PH_E_GRAPH_VERTEX_COLLISION_FAILURE;                          \
+    }                                                                        \
+    Hash.LowPart = Vertex1[N];                                               \
+    Hash.HighPart = Vertex2[N];                                              \
+    VertexPairs[Index + N] = Hash.QuadPart
+
+#define DEFINE_SEEDED_HASH_EX_BATCH_INTERLEAVED(Name)                        \
+_Use_decl_annotations_                                                       \
+HRESULT                                                                      \
+PerfectHashTableSeededHashExBatch##Name##_Interleaved(                       \
+    PULONG Keys,                                                             \
+    ULONG NumberOfKeys,                                                      \
+    PULONG Seeds,                                                            \
+    ULONG Mask,                                                              \
+    PULONGLONG VertexPairs,                                                  \
+    PULONG CollisionIndex                                                    \
+    )                                                                        \
+{                                                                            \
+    ULONG Seed1;                                                             \
+    ULONG Seed2;                                                             \
+    ULONG_BYTES Seed3;                                                       \
+    ULONG Seed4;                                                             \
+    ULONG Index;                                                             \
+    ULONG VectorKeys;                                                        \
+    ULONG Vertex1[4];                                                        \
+    ULONG Vertex2[4];                                                        \
+    ULARGE_INTEGER Hash;                                                     \
+                                                                             \
+    LOAD_SEEDS();                                                            \
+    UNREFERENCED_PARAMETER(Seed3);                                           \
+    UNREFERENCED_PARAMETER(Seed4);                                           \
+                                                                             \
+    VectorKeys = NumberOfKeys & ~3UL;                                        \
+                                                                             \
+    for (Index = 0; Index < VectorKeys; Index += 4) {                        \
+        HASH_ONE_INTERLEAVED(Name, 0);                                       \
+        HASH_ONE_INTERLEAVED(Name, 1);                                       \
+        HASH_ONE_INTERLEAVED(Name, 2);                                       \
+        HASH_ONE_INTERLEAVED(Name, 3);                                       \
+                                                                             \
+        STORE_ONE_INTERLEAVED(0);                                            \
+        STORE_ONE_INTERLEAVED(1);                                            \
+        STORE_ONE_INTERLEAVED(2);                                            \
+        STORE_ONE_INTERLEAVED(3);                                            \
+    }                                                                        \
+                                                                             \
+    HASH_TAIL(Name);                                                         \
+}
+
+SEEDED_HASH_EX_BATCH_INTERLEAVED_TABLE(DEFINE_SEEDED_HASH_EX_BATCH_INTERLEAVED);
+
+//
+// Multi-seed implementations.
+//
+// Rather than spreading keys across the vector lanes, these routines
+// broadcast a single key to all lanes and spread seed sets across them
+// instead: each pair of adjacent 32-bit lanes holds Vertex1 and Vertex2 for
+// one seed set, so the 64-bit lanes of the result are the vertex pairs for
+// each seed set.  A single pass over the keys therefore yields vertex pairs
+// for 4 (AVX2) or 8 (AVX-512) seed sets.
+//
+// As each lane now has its own seeds, all per-lane parameters (multipliers,
+// shift and rotate counts, xor values) live in vectors, and the variable
+// per-lane shift instructions are used.  The hash functions are expressed in
+// a common form per lane; e.g. MultiplyShiftLR shifts vertex 1 left by Byte1
+// and right by 0, and vertex 2 left by 0 and right by Byte2.
+//
+
+#define MULTI_SEED_SETS_AVX2 4
+#define MULTI_SEED_SETS_AVX512 8
+
+#define YMM_SUB(A, B) _mm256_sub_epi32(A, B)
+#define YMM_SRLV(A, N) _mm256_srlv_epi32(A, N)
+#define YMM_SLLV(A, N) _mm256_sllv_epi32(A, N)
+#define YMM_RORV(A, N) \
+    YMM_OR(YMM_SRLV(A, N), YMM_SLLV(A, YMM_SUB(YMM_BROADCAST(32), N)))
+
+#define ZMM_SRLV(A, N) _mm512_srlv_epi32(A, N)
+#define ZMM_SLLV(A, N) _mm512_sllv_epi32(A, N)
+#define ZMM_RORV(A, N) _mm512_rorv_epi32(A, N)
+
+//
+// Per-seed-set lane parameters.  S is the seed set, B is its third seed as
+// a ULONG_BYTES, and L is the lane for vertex 1 (L + 1 is vertex 2).
+//
+
+#define MULTI_SEED_LANES_MultiplyShiftR(S, B, L)                \
+    Mul[L] = S[0]; Shift1[L] = B.Byte1;                         \
+    Mul[L + 1] = S[1]; Shift1[L + 1] = B.Byte2
+
+#define MULTI_SEED_LANES_MultiplyShiftLR(S, B, L)               \
+    Mul[L] = S[0]; Shift1[L] = B.Byte1; Shift2[L] = 0;          \
+    Mul[L + 1] = S[1]; Shift1[L + 1] = 0; Shift2[L + 1] = B.Byte2
+
+#define MULTI_SEED_LANES_MultiplyRotateR(S, B, L)               \
+    MULTI_SEED_LANES_MultiplyShiftR(S, B, L)
+
+#define MULTI_SEED_LANES_MultiplyRotateLR(S, B, L)              \
+    Mul[L] = S[0]; Shift1[L] = (32 - B.Byte1) & 31;             \
+    Mul[L + 1] = S[1]; Shift1[L + 1] = B.Byte2
+
+#define MULTI_SEED_LANES_RotateMultiplyXorRotate(S, B, L)       \
+    Mul[L] = S[0]; Shift1[L] = B.Byte1; Shift2[L] = B.Byte2;    \
+    Mul[L + 1] = S[1]; Shift1[L + 1] = B.Byte3; Shift2[L + 1] = B.Byte4
+
+#define MULTI_SEED_LANES_ShiftMultiplyXorShift(S, B, L)         \
+    MULTI_SEED_LANES_RotateMultiplyXorRotate(S, B, L)
+
+#define MULTI_SEED_LANES_MultiplyXor(S, B, L)                   \
+    Mul[L] = S[0]; Xor[L] = S[1];                               \
+    Mul[L + 1] = B.AsULong; Xor[L + 1] = S[3]
+
+//
+// Per-lane hash guts.  V is the vector prefix, K is the broadcast key, and H
+// receives the unmasked vertices for all seed sets.
+//
+
+#define MULTI_SEED_GUTS_MultiplyShiftR(V, K, H)                 \
+    H = V##_SRLV(V##_MUL(K, MulV), Shift1V)
+
+#define MULTI_SEED_GUTS_MultiplyShiftLR(V, K, H)                \
+    H = V##_SRLV(V##_SLLV(V##_MUL(K, MulV), Shift1V), Shift2V)
+
+#define MULTI_SEED_GUTS_MultiplyRotateR(V, K, H)                \
+    H = V##_RORV(V##_MUL(K, MulV), Shift1V)
+
+#define MULTI_SEED_GUTS_MultiplyRotateLR(V, K, H)               \
+    MULTI_SEED_GUTS_MultiplyRotateR(V, K, H)
+
+#define MULTI_SEED_GUTS_RotateMultiplyXorRotate(V, K, H)        \
+    H = V##_MUL(V##_RORV(K, Shift1V), MulV);                    \
+    H = V##_XOR(H, V##_RORV(H, Shift2V))
+
+#define MULTI_SEED_GUTS_ShiftMultiplyXorShift(V, K, H)          \
+    H = V##_MUL(V##_SRLV(K, Shift1V), MulV);                    \
+    H = V##_XOR(H, V##_SRLV(H, Shift2V))
+
+#define MULTI_SEED_GUTS_MultiplyXor(V, K, H)                    \
+    H = V##_XOR(V##_MUL(K, MulV), XorV)
+
+#define EXPAND_AS_MULTI_SEED_FUNC_DECL(Name)                                 \
+    PERFECT_HASH_TABLE_SEEDED_HASH_EX_MULTI_SEED                             \
+        PerfectHashTableSeededHashExMultiSeed##Name##_AVX2;                  \
+    PERFECT_HASH_TABLE_SEEDED_HASH_EX_MULTI_SEED                             \
+        PerfectHashTableSeededHashExMultiSeed##Name##_AVX512;
+
+SEEDED_HASH_EX_BATCH_VECTOR_TABLE(EXPAND_AS_MULTI_SEED_FUNC_DECL);
+
+//
+// Common prologue: fill out the lane parameter arrays from each seed set,
+// then mark every seed set as collision-free.
+//
+
+#define LOAD_MULTI_SEED_LANES(Name, NumberOfSeedSets)                        \
+    ZeroArrayInline(Mul);                                                    \
+    ZeroArrayInline(Shift1);                                                 \
+    ZeroArrayInline(Shift2);                                                 \
+    ZeroArrayInline(Xor);                                                    \
+    for (Set = 0; Set < NumberOfSeedSets; Set++) {                           \
+        Seeds = &SeedSets[Set * MAX_NUMBER_OF_SEEDS];                        \
+        Seed3.AsULong = Seeds[2];                                            \
+        Lane = Set << 1;                                                     \
+        MULTI_SEED_LANES_##Name(Seeds, Seed3, Lane);                         \
+        CollisionIndexes[Set] = NumberOfKeys;                                \
+    }                                                                        \
+    Collided = 0
+
+//
+// Record the first colliding key for any seed sets that haven't already
+// collided.  Bits has a bit set for each vertex 1 lane whose vertex 2 lane
+// holds the same value.
+//
+
+#define RECORD_MULTI_SEED_COLLISIONS(Bits, KeyIndex)                         \
+    Bits &= ~Collided;                                                       \
+    Collided |= Bits;                                                        \
+    while (Bits != 0) {                                                      \
+        _BitScanForward(&Lane, Bits);                                        \
+        CollisionIndexes[Lane >> 1] = KeyIndex;                              \
+        Bits &= Bits - 1;                                                    \
+    }
+
+//
+// Hash a single key into all seed sets.  The 0xB1 shuffle swaps each pair
+// of adjacent 32-bit lanes, so comparing against it detects Vertex1 ==
+// Vertex2 for every seed set at once.
+//
+
+#define HASH_ONE_MULTI_SEED_AVX2(Name, KeyIndex, H)                          \
+    MULTI_SEED_GUTS_##Name(YMM, YMM_BROADCAST(Keys[KeyIndex]), H);           \
+    H = YMM_AND(H, MaskYmm);                                                 \
+    Bits = (ULONG)_mm256_movemask_ps(                                        \
+        _mm256_castsi256_ps(                                                 \
+            _mm256_cmpeq_epi32(H, _mm256_shuffle_epi32(H, 0xB1))             \
+        )                                                                    \
+    ) & 0x55;                                                                \
+    if (Bits != 0) {                                                         \
+        RECORD_MULTI_SEED_COLLISIONS(Bits, KeyIndex);                        \
+    }
+
+//
+// AVX2 implementations.  Four keys are hashed per iteration, then the 4x4
+// matrix of vertex pairs (keys by seed sets) is transposed so that each seed
+// set's vertex pairs array receives a full 256-bit store.
+//
+
+#define DEFINE_SEEDED_HASH_EX_MULTI_SEED_AVX2(Name)                          \
+_Use_decl_annotations_                                                       \
+HRESULT                                                                      \
+PerfectHashTableSeededHashExMultiSeed##Name##_AVX2(                          \
+    PULONG Keys,                                                             \
+    ULONG NumberOfKeys,                                                      \
+    PULONG SeedSets,                                                         \
+    ULONG Mask,                                                              \
+    PULONGLONG VertexPairs,                                                  \
+    ULONG VertexPairsStride,                                                 \
+    PULONG CollisionIndexes                                                  \
+    )                                                                        \
+{                                                                            \
+    ULONG Set;                                                               \
+    ULONG Lane;                                                              \
+    ULONG Bits;                                                              \
+    ULONG Index;                                                             \
+    ULONG Collided;                                                          \
+    ULONG VectorKeys;                                                        \
+    PULONG Seeds;                                                            \
+    ULONG_BYTES Seed3;                                                       \
+    ULONG Mul[8];                                                            \
+    ULONG Shift1[8];                                                         \
+    ULONG Shift2[8];                                                         \
+    ULONG Xor[8];                                                            \
+    ULONGLONG Pairs[MULTI_SEED_SETS_AVX2];                                   \
+    PULONGLONG Set0;                                                         \
+    PULONGLONG Set1;                                                         \
+    PULONGLONG Set2;                                                         \
+    PULONGLONG Set3;                                                         \
+    YMMWORD MulV;                                                            \
+    YMMWORD Shift1V;                                                         \
+    YMMWORD Shift2V;                                                         \
+    YMMWORD XorV;                                                            \
+    YMMWORD MaskYmm;                                                         \
+    YMMWORD H0;                                                              \
+    YMMWORD H1;                                                              \
+    YMMWORD H2;                                                              \
+    YMMWORD H3;                                                              \
+    YMMWORD T0;                                                              \
+    YMMWORD T1;                                                              \
+    YMMWORD T2;                                                              \
+    YMMWORD T3;                                                              \
+                                                                             \
+    LOAD_MULTI_SEED_LANES(Name, MULTI_SEED_SETS_AVX2);                       \
+                                                                             \
+    MulV = _mm256_loadu_si256((PYMMWORD)Mul);                                \
+    Shift1V = _mm256_loadu_si256((PYMMWORD)Shift1);                          \
+    Shift2V = _mm256_loadu_si256((PYMMWORD)Shift2);                          \
+    XorV = _mm256_loadu_si256((PYMMWORD)Xor);                                \
+    UNREFERENCED_PARAMETER(Shift1V);                                         \
+    UNREFERENCED_PARAMETER(Shift2V);                                         \
+    UNREFERENCED_PARAMETER(XorV);                                            \
+                                                                             \
+    MaskYmm = YMM_BROADCAST(Mask);                                           \
+    VectorKeys = NumberOfKeys & ~3UL;                                        \
+                                                                             \
+    Set0 = VertexPairs;                                                      \
+    Set1 = Set0 + VertexPairsStride;                                         \
+    Set2 = Set1 + VertexPairsStride;                                         \
+    Set3 = Set2 + VertexPairsStride;                                         \
+                                                                             \
+    for (Index = 0; Index < VectorKeys; Index += 4) {                        \
+        HASH_ONE_MULTI_SEED_AVX2(Name, Index, H0);                           \
+        HASH_ONE_MULTI_SEED_AVX2(Name, Index + 1, H1);                       \
+        HASH_ONE_MULTI_SEED_AVX2(Name, Index + 2, H2);                       \
+        HASH_ONE_MULTI_SEED_AVX2(Name, Index + 3, H3);                       \
+                                                                             \
+        T0 = _mm256_unpacklo_epi64(H0, H1);                                  \
+        T1 = _mm256_unpackhi_epi64(H0, H1);                                  \
+        T2 = _mm256_unpacklo_epi64(H2, H3);                                  \
+        T3 = _mm256_unpackhi_epi64(H2, H3);                                  \
+                                                                             \
+        _mm256_storeu_si256((PYMMWORD)&Set0[Index],                          \
+                            _mm256_permute2x128_si256(T0, T2, 0x20));        \
+        _mm256_storeu_si256((PYMMWORD)&Set1[Index],                          \
+                            _mm256_permute2x128_si256(T1, T3, 0x20));        \
+        _mm256_storeu_si256((PYMMWORD)&Set2[Index],                          \
+                            _mm256_permute2x128_si256(T0, T2, 0x31));        \
+        _mm256_storeu_si256((PYMMWORD)&Set3[Index],                          \
+                            _mm256_permute2x128_si256(T1, T3, 0x31));        \
+    }                                                                        \
+                                                                             \
+    for (NOTHING; Index < NumberOfKeys; Index++) {                           \
+        HASH_ONE_MULTI_SEED_AVX2(Name, Index, H0);                           \
+        _mm256_storeu_si256((PYMMWORD)Pairs, H0);                            \
+        Set0[Index] = Pairs[0];                                              \
+        Set1[Index] = Pairs[1];                                              \
+        Set2[Index] = Pairs[2];                                              \
+        Set3[Index] = Pairs[3];                                              \
+    }                                                                        \
+                                                                             \
+    return S_OK;                                                             \
+}
+
+//
+// AVX-512 implementations.  Each key's vertex pairs for all eight seed sets
+// are written with a single scatter, indexed by the per-set array offsets.
+//
+
+#define DEFINE_SEEDED_HASH_EX_MULTI_SEED_AVX512(Name)                        \
+_Use_decl_annotations_                                                       \
+HRESULT                                                                      \
+PerfectHashTableSeededHashExMultiSeed##Name##_AVX512(                        \
+    PULONG Keys,                                                             \
+    ULONG NumberOfKeys,                                                      \
+    PULONG SeedSets,                                                         \
+    ULONG Mask,                                                              \
+    PULONGLONG VertexPairs,                                                  \
+    ULONG VertexPairsStride,                                                 \
+    PULONG CollisionIndexes                                                  \
+    )                                                                        \
+{                                                                            \
+    ULONG Set;                                                               \
+    ULONG Lane;                                                              \
+    ULONG Bits;                                                              \
+    ULONG Index;                                                             \
+    ULONG Collided;                                                          \
+    PULONG Seeds;                                                            \
+    ULONG_BYTES Seed3;                                                       \
+    ULONG Mul[16];                                                           \
+    ULONG Shift1[16];                                                        \
+    ULONG Shift2[16];                                                        \
+    ULONG Xor[16];                                                           \
+    LONGLONG Stride;                                                         \
+    ZMMWORD MulV;                                                            \
+    ZMMWORD Shift1V;                                                         \
+    ZMMWORD Shift2V;                                                         \
+    ZMMWORD XorV;                                                            \
+    ZMMWORD MaskZmm;                                                         \
+    ZMMWORD Offsets;                                                         \
+    ZMMWORD H;                                                               \
+                                                                             \
+    LOAD_MULTI_SEED_LANES(Name, MULTI_SEED_SETS_AVX512);                     \
+                                                                             \
+    MulV = _mm512_loadu_si512((PZMMWORD)Mul);                                \
+    Shift1V = _mm512_loadu_si512((PZMMWORD)Shift1);                          \
+    Shift2V = _mm512_loadu_si512((PZMMWORD)Shift2);                          \
+    XorV = _mm512_loadu_si512((PZMMWORD)Xor);                                \
+    UNREFERENCED_PARAMETER(Shift1V);                                         \
+    UNREFERENCED_PARAMETER(Shift2V);                                         \
+    UNREFERENCED_PARAMETER(XorV);                                            \
+                                                                             \
+    MaskZmm = ZMM_BROADCAST(Mask);                                           \
+    Stride = (LONGLONG)VertexPairsStride;                                    \
+    Offsets = _mm512_set_epi64(Stride * 7, Stride * 6, Stride * 5,           \
+                               Stride * 4, Stride * 3, Stride * 2,           \
+                               Stride, 0);                                   \
+                                                                             \
+    for (Index = 0; Index < NumberOfKeys; Index++) {                         \
+        MULTI_SEED_GUTS_##Name(ZMM, ZMM_BROADCAST(Keys[Index]), H);          \
+        H = ZMM_AND(H, MaskZmm);                                             \
+                                                                             \
+        Bits = (ULONG)_mm512_cmpeq_epi32_mask(                               \
+            H,                                                               \
+            _mm512_shuffle_epi32(H, (_MM_PERM_ENUM)0xB1)                     \
+        ) & 0x5555;                                                          \
+                                                                             \
+        if (Bits != 0) {                                                     \
+            RECORD_MULTI_SEED_COLLISIONS(Bits, Index);                       \
+        }                                                                    \
+                                                                             \
+        _mm512_i64scatter_epi64(&VertexPairs[Index], Offsets, H, 8);         \
+    }                                                                        \
+                                                                             \
+    return S_OK;                                                             \
+}
+
+SEEDED_HASH_EX_BATCH_VECTOR_TABLE(DEFINE_SEEDED_HASH_EX_MULTI_SEED_AVX2);
+SEEDED_HASH_EX_BATCH_VECTOR_TABLE(DEFINE_SEEDED_HASH_EX_MULTI_SEED_AVX512);
+
+//
+// Runtime selection.
+//
+
+_Use_decl_annotations_
+PPERFECT_HASH_TABLE_SEEDED_HASH_EX_BATCH
+GetSeededHashExBatchRoutine(
+    PRTL Rtl,
+    PERFECT_HASH_HASH_FUNCTION_ID HashFunctionId
+    )
+/*++
+
+Routine Description:
+
+    Returns the best batch seeded hash routine for the given hash function,
+    based on the CPU features available.
+
+Arguments:
+
+    Rtl - Supplies a pointer to an initialized RTL structure, used to obtain
+        the CPU features.
+
+    HashFunctionId - Supplies the hash function ID.
+
+Return Value:
+
+    A pointer to the batch routine, or NULL if the hash function has no batch
+    implementation (or the CPU lacks AVX2), in which case callers should fall
+    back to calling the SeededHashEx() routine for each key.
+
+--*/
+{
+    BOOLEAN HasAvx2;
+    BOOLEAN HasAvx512;
+
+    HasAvx2 = (Rtl->CpuFeatures.AVX2 != FALSE);
+    HasAvx512 = (Rtl->CpuFeatures.AVX512F != FALSE);
+
+    switch (HashFunctionId) {
+
+#define EXPAND_AS_VECTOR_CASE(Name)                                      \
+        case PerfectHashHash##Name##FunctionId:                          \
+            if (HasAvx512) {                                             \
+                return PerfectHashTableSeededHashExBatch##Name##_AVX512; \
+            } else if (HasAvx2) {                                        \
+                return PerfectHashTableSeededHashExBatch##Name##_AVX2;   \
+            }                                                            \
+            return NULL;
+
+        SEEDED_HASH_EX_BATCH_VECTOR_TABLE(EXPAND_AS_VECTOR_CASE)
+
+#define EXPAND_AS_INTERLEAVED_CASE(Name)                                   \
+        case PerfectHashHash##Name##FunctionId:                            \
+            return PerfectHashTableSeededHashExBatch##Name##_Interleaved;
+
+        SEEDED_HASH_EX_BATCH_INTERLEAVED_TABLE(EXPAND_AS_INTERLEAVED_CASE)
+
+        default:
+            return NULL;
+    }
+}
+
+
+_Use_decl_annotations_
+PPERFECT_HASH_TABLE_SEEDED_HASH_EX_MULTI_SEED
+GetSeededHashExMultiSeedRoutine(
+    PRTL Rtl,
+    PERFECT_HASH_HASH_FUNCTION_ID HashFunctionId,
+    PULONG NumberOfSeedSets
+    )
+/*++
+
+Routine Description:
+
+    Returns the best multi-seed hash routine for the given hash function,
+    based on the CPU features available.
+
+Arguments:
+
+    Rtl - Supplies a pointer to an initialized RTL structure, used to obtain
+        the CPU features.
+
+    HashFunctionId - Supplies the hash function ID.
+
+    NumberOfSeedSets - Receives the number of seed sets hashed by each call
+        to the returned routine (4 for AVX2, 8 for AVX-512), or 0 if no
+        routine is available.
+
+Return Value:
+
+    A pointer to the multi-seed routine, or NULL if the hash function has no
+    multi-seed implementation (or the CPU lacks AVX2).
+
+--*/
+{
+    BOOLEAN HasAvx2;
+    BOOLEAN HasAvx512;
+
+    HasAvx2 = (Rtl->CpuFeatures.AVX2 != FALSE);
+    HasAvx512 = (Rtl->CpuFeatures.AVX512F != FALSE);
+
+    *NumberOfSeedSets = 0;
+
+    switch (HashFunctionId) {
+
+#define EXPAND_AS_MULTI_SEED_CASE(Name)                                      \
+        case PerfectHashHash##Name##FunctionId:                              \
+            if (HasAvx512) {                                                 \
+                *NumberOfSeedSets = MULTI_SEED_SETS_AVX512;                  \
+                return PerfectHashTableSeededHashExMultiSeed##Name##_AVX512; \
+            } else if (HasAvx2) {                                            \
+                *NumberOfSeedSets = MULTI_SEED_SETS_AVX2;                    \
+                return PerfectHashTableSeededHashExMultiSeed##Name##_AVX2;   \
+            }                                                                \
+            return NULL;
+
+        SEEDED_HASH_EX_BATCH_VECTOR_TABLE(EXPAND_AS_MULTI_SEED_CASE)
+
+        default:
+            return NULL;
+    }
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
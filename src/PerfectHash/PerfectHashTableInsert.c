@@ -8,8 +8,8 @@ Module Name:
 
 Abstract:
 
-    This module implements the Insert() routine for the PerfectHashTable
-    component.
+    This module implements the Insert() and InsertBatch() routines for the
+    PerfectHashTable component.
 
 --*/
 
@@ -104,4 +104,111 @@ Return Value:
 }
 
 
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableInsertBatch(
+    PPERFECT_HASH_TABLE Table,
+    ULONG NumberOfKeys,
+    PULONG Keys,
+    PULONG Values,
+    PULONG PreviousValues
+    )
+/*++
+
+Routine Description:
+
+    Inserts an array of key/value pairs into a perfect hash table.  Keys are
+    processed in groups of PERFECT_HASH_TABLE_BATCH_GROUP_SIZE: the group's
+    indices are obtained via IndexBatch() (which overlaps the table data
+    misses of the group), then the values slot of each key is prefetched
+    prior to any of them being written.
+
+    Keys are inserted in array order; if a key appears more than once, the
+    last value wins, and each previous value reflects the insertions that
+    came before it.
+
+    N.B. If a key did not appear in the original set the hash table was created
+         from, the behavior of this routine is undefined for that key.  (See
+         the N.B. in Insert().)
+
+Arguments:
+
+    Table - Supplies a pointer to the table to insert the key/values into.
+
+    NumberOfKeys - Supplies the number of keys in the Keys and Values arrays.
+
+    Keys - Supplies the base address of an array of keys to insert.
+
+    Values - Supplies the base address of an array of values to insert.
+
+    PreviousValues - Optionally supplies the base address of an array that
+        will receive the previous value of each key prior to its insertion.
+
+Return Value:
+
+    S_OK in all normal operating conditions.  E_FAIL may be returned in some
+    cases when passed keys not in the original input set.  Such keys are not
+    inserted, and their previous value, if requested, will be set to 0.
+
+--*/
+{
+    ULONG Base;
+    ULONG Count;
+    ULONG Index;
+    ULONG Offset;
+    HRESULT Result;
+    PULONG TableValues;
+    PULONG PreviousValue;
+    ULONG Indices[PERFECT_HASH_TABLE_BATCH_GROUP_SIZE];
+
+    TableValues = Table->Values;
+    Result = S_OK;
+
+    for (Base = 0; Base < NumberOfKeys; Base += Count) {
+
+        Count = min(PERFECT_HASH_TABLE_BATCH_GROUP_SIZE, NumberOfKeys - Base);
+
+        if (FAILED(Table->Vtbl->IndexBatch(Table,
+                                           Count,
+                                           &Keys[Base],
+                                           Indices))) {
+
+            //
+            // One or more keys in the group failed; fall back to the scalar
+            // routine for the group, which handles the failing keys.
+            //
+
+            for (Offset = 0; Offset < Count; Offset++) {
+                PreviousValue = (
+                    ARGUMENT_PRESENT(PreviousValues) ?
+                    &PreviousValues[Base + Offset] :
+                    NULL
+                );
+                if (FAILED(Table->Vtbl->Insert(Table,
+                                               Keys[Base + Offset],
+                                               Values[Base + Offset],
+                                               PreviousValue))) {
+                    Result = E_FAIL;
+                }
+            }
+            continue;
+        }
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            PrefetchForWrite(&TableValues[Indices[Offset]]);
+        }
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            Index = Indices[Offset];
+            if (ARGUMENT_PRESENT(PreviousValues)) {
+                PreviousValues[Base + Offset] = TableValues[Index];
+            }
+            TableValues[Index] = Values[Base + Offset];
+        }
+    }
+
+    return Result;
+}
+
+
 // vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -43,7 +43,10 @@ Arguments:
         the fully-qualified, NULL-terminated path of the file to be used to
         load the table.
 
-    Keys - Optionally supplies a pointer to the keys for the hash table.
+    Keys - Optionally supplies a pointer to the keys for the hash table.  If
+        the table was created from string keys, and the string keys it was
+        created from are provided, a reference to them is retained such that
+        the TryIndexString() and TryLookupString() routines can be used.
 
 Return Value:
 
@@ -98,6 +101,10 @@ Return Value:
     PH_E_NUM_KEYS_EXCEEDS_NUM_TABLE_ELEMENTS - The number of keys indicated in
         the header exceeds the number of table elements indicated by the header.
 
+    PH_E_STRING_KEYS_MISMATCH_BETWEEN_HEADER_AND_KEYS - The table was created
+        from string keys, and Keys does not contain the same string keys (as
+        determined by the reduced key seed and the size of the string data).
+
     PH_E_EXPECTED_EOF_ACTUAL_EOF_MISMATCH - The expected end-of-file, which
         is calculated by dividing the file size by number of table elements,
         did not match the actual on-disk file size.
@@ -317,6 +324,17 @@ Return Value:
             goto Error;
         }
 
+        if (TableInfoOnDisk->Flags.StringKeys != FALSE) {
+
+            if (!KeysAreStrings(Keys) ||
+                Keys->ReducedKeySeed != TableInfoOnDisk->ReducedKeySeed ||
+                Keys->StringKeyDataSizeInBytes !=
+                TableInfoOnDisk->StringKeyDataSizeInBytes) {
+
+                Result = PH_E_STRING_KEYS_MISMATCH_BETWEEN_HEADER_AND_KEYS;
+                goto Error;
+            }
+        }
     }
 
     //
@@ -382,6 +400,46 @@ Return Value:
         goto Error;
     }
 
+    //
+    // Validate the fingerprint size; it's 0 if the table has no fingerprints.
+    //
+
+    if (TableInfoOnDisk->FingerprintSizeInBytes > sizeof(USHORT)) {
+        Result = PH_E_INVARIANT_CHECK_FAILED;
+        PH_ERROR(PerfectHashTableLoad_FingerprintSizeInBytes, Result);
+        goto Error;
+    }
+
+    Table->FingerprintSizeInBytes = TableInfoOnDisk->FingerprintSizeInBytes;
+    Table->CacheLinesPerLookup = TableInfoOnDisk->CacheLinesPerLookup;
+
+    //
+    // Validate the packed table data layout parameters, if applicable.
+    //
+
+    if (TableInfoOnDisk->Flags.PackedTableData != FALSE) {
+        if (TableInfoOnDisk->Flags.InterleavedTableData != FALSE ||
+            !IsValidPackedTableDataBitsPerElement(
+                TableInfoOnDisk->TableDataBitsPerElement)) {
+            Result = PH_E_INVARIANT_CHECK_FAILED;
+            PH_ERROR(PerfectHashTableLoad_TableDataBitsPerElement, Result);
+            goto Error;
+        }
+        Table->TableDataBitsPerElement = (
+            TableInfoOnDisk->TableDataBitsPerElement
+        );
+    }
+
+    if (TableInfoOnDisk->Flags.InterleavedTableData != FALSE) {
+        Table->TableDataLayoutId = TableDataLayoutInterleavedId;
+    } else if (TableInfoOnDisk->Flags.PackedTableData != FALSE) {
+        Table->TableDataLayoutId = TableDataLayoutPackedId;
+    } else {
+        Table->TableDataLayoutId = TableDataLayoutSeparateId;
+    }
+    Table->TableCreateFlags.OrderPreserving = (
+        TableInfoOnDisk->Flags.OrderPreserving != FALSE
+    );
     Table->TableInfoOnDisk = TableInfoOnDisk;
 
     //
@@ -421,14 +479,17 @@ Return Value:
     Table->TableFile = File;
 
     //
-    // We can determine the expected file size by multipling the number of
-    // table elements by the key size; both of which are available in the
-    // :Info header.
+    // We can determine the expected file size from the table data size (the
+    // number of table elements multiplied by the key size, or the packed size
+    // if applicable), plus the fingerprints size, if any; all of which are
+    // available in the :Info header.
     //
 
     ExpectedEndOfFile.QuadPart = (
-        NumberOfTableElements *
-        TableInfoOnDisk->KeySizeInBytes
+        GetTableDataSizeInBytes(TableInfoOnDisk) + (
+            NumberOfTableElements *
+            (ULONGLONG)TableInfoOnDisk->FingerprintSizeInBytes
+        )
     );
 
     //
@@ -508,6 +569,27 @@ Return Value:
     Table->Flags.Loaded = TRUE;
     Table->TableDataBaseAddress = Table->TableFile->BaseAddress;
 
+    //
+    // If the table has fingerprints, they follow the table data.
+    //
+
+    if (HasFingerprints(Table)) {
+        Table->Fingerprints = RtlOffsetToPointer(
+            Table->TableDataBaseAddress,
+            GetTableDataSizeInBytes(TableInfoOnDisk)
+        );
+    }
+
+    //
+    // If the table was created from string keys, and they were provided (and
+    // validated above), retain a reference to them.
+    //
+
+    if (ARGUMENT_PRESENT(Keys) && KeysAreStrings(Keys)) {
+        Keys->Vtbl->AddRef(Keys);
+        Table->StringKeys = Keys;
+    }
+
     goto End;
 
 Error:
@@ -8,8 +8,9 @@ Module Name:
 
 Abstract:
 
-    This module implements the Lookup() routine for the PerfectHashTable
-    component.
+    This module implements the Lookup(), LookupBatch(), Contains(),
+    TryLookup(), TryIndexString() and TryLookupString() routines for the
+    PerfectHashTable component.
 
 --*/
 
@@ -78,4 +79,380 @@ Return Value:
 }
 
 
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableLookupBatch(
+    PPERFECT_HASH_TABLE Table,
+    ULONG NumberOfKeys,
+    PULONG Keys,
+    PULONG Values
+    )
+/*++
+
+Routine Description:
+
+    Looks up an array of keys in a perfect hash table and returns the values
+    set by the Insert() routine.  Keys are processed in groups of
+    PERFECT_HASH_TABLE_BATCH_GROUP_SIZE: the group's indices are obtained via
+    IndexBatch() (which overlaps the table data misses of the group), then the
+    values slot of each key is prefetched prior to any of them being read.
+
+    N.B. If a key did not appear in the original set the hash table was created
+         from, the behavior of this routine is undefined for that key.
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the key lookups are to
+        be performed.
+
+    NumberOfKeys - Supplies the number of keys in the Keys array.
+
+    Keys - Supplies the base address of an array of keys to look up.
+
+    Values - Receives the value for each key.
+
+Return Value:
+
+    S_OK in all normal operating conditions.  E_FAIL may be returned in some
+    cases when passed keys not in the original input set.  The value for such
+    keys will be set to 0.
+
+--*/
+{
+    ULONG Base;
+    ULONG Count;
+    ULONG Offset;
+    HRESULT Result;
+    PULONG TableValues;
+    ULONG Indices[PERFECT_HASH_TABLE_BATCH_GROUP_SIZE];
+
+    TableValues = Table->Values;
+    Result = S_OK;
+
+    for (Base = 0; Base < NumberOfKeys; Base += Count) {
+
+        Count = min(PERFECT_HASH_TABLE_BATCH_GROUP_SIZE, NumberOfKeys - Base);
+
+        if (FAILED(Table->Vtbl->IndexBatch(Table,
+                                           Count,
+                                           &Keys[Base],
+                                           Indices))) {
+
+            //
+            // One or more keys in the group failed; fall back to the scalar
+            // routine for the group, which handles the failing keys.
+            //
+
+            for (Offset = 0; Offset < Count; Offset++) {
+                if (FAILED(Table->Vtbl->Lookup(Table,
+                                               Keys[Base + Offset],
+                                               &Values[Base + Offset]))) {
+                    Result = E_FAIL;
+                }
+            }
+            continue;
+        }
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            PreFetchCacheLine(PF_TEMPORAL_LEVEL_1,
+                              &TableValues[Indices[Offset]]);
+        }
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            Values[Base + Offset] = TableValues[Indices[Offset]];
+        }
+    }
+
+    return Result;
+}
+
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableContains(
+    PPERFECT_HASH_TABLE Table,
+    ULONG Key
+    )
+/*++
+
+Routine Description:
+
+    Determines whether or not a key appeared in the original set the hash table
+    was created from, by comparing the key's fingerprint against the one
+    stored at the key's index.  Keys that did not appear in the original set
+    may be reported as present if their fingerprint happens to match; the
+    probability of this is 1/256 for 1-byte fingerprints, and 1/65536 for
+    2-byte fingerprints.  Keys that did appear in the original set are always
+    reported as present.
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the key membership test
+        is to be performed.
+
+    Key - Supplies the key to test.
+
+Return Value:
+
+    S_OK - The key is (probably) present in the table.
+
+    S_FALSE - The key is not present in the table.
+
+    PH_E_TABLE_HAS_NO_FINGERPRINTS - The table was not created with
+        fingerprints.
+
+    E_FAIL - The index for the key could not be obtained.
+
+--*/
+{
+    ULONG Index;
+    HRESULT Result;
+
+    if (!HasFingerprints(Table)) {
+        return PH_E_TABLE_HAS_NO_FINGERPRINTS;
+    }
+
+    Result = Table->Vtbl->Index(Table, Key, &Index);
+
+    if (FAILED(Result)) {
+        return E_FAIL;
+    }
+
+    if (!PerfectHashTableFingerprintMatches(Table, Index, Key)) {
+        return S_FALSE;
+    }
+
+    return S_OK;
+}
+
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableTryLookup(
+    PPERFECT_HASH_TABLE Table,
+    ULONG Key,
+    PULONG Value
+    )
+/*++
+
+Routine Description:
+
+    Looks up given key in a perfect hash table and returns the value set by
+    the Insert() routine, if the key's fingerprint matches the one stored at
+    its index.  Unlike Lookup(), a key that did not appear in the original set
+    the hash table was created from will (with high probability) be reported
+    as a miss, rather than returning the value of some other key.  See the
+    Contains() routine for more information.
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the key lookup is to be
+        performed.
+
+    Key - Supplies the key to look up.
+
+    Value - Receives the value for the given key, or 0 if the key is not
+        present in the table.
+
+Return Value:
+
+    S_OK - The key is (probably) present in the table, and Value has been set
+        to the value for the key.
+
+    S_FALSE - The key is not present in the table.  Value will be set to 0.
+
+    PH_E_TABLE_HAS_NO_FINGERPRINTS - The table was not created with
+        fingerprints.  Value will be set to 0.
+
+    E_FAIL - The index for the key could not be obtained.  Value will be set
+        to 0.
+
+--*/
+{
+    ULONG Index;
+    HRESULT Result;
+
+    *Value = 0;
+
+    if (!HasFingerprints(Table)) {
+        return PH_E_TABLE_HAS_NO_FINGERPRINTS;
+    }
+
+    Result = Table->Vtbl->Index(Table, Key, &Index);
+
+    if (FAILED(Result)) {
+        return E_FAIL;
+    }
+
+    if (!PerfectHashTableFingerprintMatches(Table, Index, Key)) {
+        return S_FALSE;
+    }
+
+    *Value = Table->Values[Index];
+
+    return S_OK;
+}
+
+
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableTryIndexString(
+    PPERFECT_HASH_TABLE Table,
+    PBYTE String,
+    ULONG Length,
+    PULONG Index
+    )
+/*++
+
+Routine Description:
+
+    Obtains the index of a string key in a table created from string keys.
+    The string is reduced to its 32-bit key with the table's seed, the index
+    for that key is obtained, and the string is then compared against the
+    string key stored at that index.  Thus, unlike Index(), a string that did
+    not appear in the original set is always reported as a miss.
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the index is to be
+        obtained.
+
+    String - Supplies the base address of the string key's bytes.
+
+    Length - Supplies the length of the string key, in bytes.
+
+    Index - Receives the index of the string key, which is its offset in the
+        table's key array (sorted by reduced key), or 0 if the string key is
+        not present in the table.
+
+Return Value:
+
+    S_OK - The string key is present in the table, and Index has been set.
+
+    S_FALSE - The string key is not present in the table.  Index will be set
+        to 0.
+
+    PH_E_TABLE_HAS_NO_STRING_KEYS - The table was not created from string keys,
+        or its string keys were not provided to Load().  Index will be set
+        to 0.
+
+    E_FAIL - The index for the reduced key could not be obtained.  Index will
+        be set to 0.
+
+--*/
+{
+    PRTL Rtl;
+    ULONG Key;
+    ULONG Offset;
+    ULONG KeyIndex;
+    HRESULT Result;
+    PPERFECT_HASH_KEYS StringKeys;
+
+    *Index = 0;
+
+    StringKeys = Table->StringKeys;
+
+    if (!StringKeys) {
+        return PH_E_TABLE_HAS_NO_STRING_KEYS;
+    }
+
+    Key = HashStringKey(String, Length, StringKeys->ReducedKeySeed);
+
+    Result = Table->Vtbl->Index(Table, Key, &KeyIndex);
+
+    if (FAILED(Result)) {
+        return E_FAIL;
+    }
+
+    //
+    // A string that wasn't in the original set can hash to any index in the
+    // table, not just those backed by a key, so check the bounds first.
+    //
+
+    if (KeyIndex >= StringKeys->NumberOfElements.LowPart) {
+        return S_FALSE;
+    }
+
+    Offset = StringKeys->StringKeyOffsets[KeyIndex];
+
+    if (Length != StringKeys->StringKeyOffsets[KeyIndex + 1] - Offset) {
+        return S_FALSE;
+    }
+
+    Rtl = Table->Rtl;
+
+    if (Length != Rtl->RtlCompareMemory(String,
+                                        StringKeys->StringKeyData + Offset,
+                                        Length)) {
+        return S_FALSE;
+    }
+
+    *Index = KeyIndex;
+
+    return S_OK;
+}
+
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableTryLookupString(
+    PPERFECT_HASH_TABLE Table,
+    PBYTE String,
+    ULONG Length,
+    PULONG Value
+    )
+/*++
+
+Routine Description:
+
+    Looks up a string key in a table created from string keys, and returns
+    the value set by the Insert() routine for its index.  See the
+    TryIndexString() routine for more information.
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the lookup is to be
+        performed.
+
+    String - Supplies the base address of the string key's bytes.
+
+    Length - Supplies the length of the string key, in bytes.
+
+    Value - Receives the value for the string key, or 0 if the string key is
+        not present in the table.
+
+Return Value:
+
+    S_OK - The string key is present in the table, and Value has been set.
+
+    S_FALSE - The string key is not present in the table.  Value will be set
+        to 0.
+
+    PH_E_TABLE_HAS_NO_STRING_KEYS - The table was not created from string keys,
+        or its string keys were not provided to Load().  Value will be set
+        to 0.
+
+    E_FAIL - The index for the reduced key could not be obtained.  Value will
+        be set to 0.
+
+--*/
+{
+    ULONG Index;
+    HRESULT Result;
+
+    *Value = 0;
+
+    Result = Table->Vtbl->TryIndexString(Table, String, Length, &Index);
+
+    if (Result != S_OK) {
+        return Result;
+    }
+
+    *Value = Table->Values[Index];
+
+    return S_OK;
+}
+
+
 // vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -241,4 +241,68 @@ Return Value:
     return S_OK;
 }
 
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableMaskHashMultiplyHigh(
+    PPERFECT_HASH_TABLE Table,
+    ULONG Input,
+    PULONG Masked
+    )
+/*++
+
+Routine Description:
+
+    Returns the input value range-reduced into the number of vertices via a
+    multiply-high.  See MultiplyHighReduceHash().
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the mask will be derived.
+
+    Input - Supplies the input value to mask.
+
+    Masked - Receives the masked value.
+
+Return Value:
+
+    S_OK.
+
+--*/
+{
+    *Masked = MultiplyHighReduceHash(Input, Table->HashModulus);
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableMaskIndexMultiplyHigh(
+    PPERFECT_HASH_TABLE Table,
+    ULONGLONG Input,
+    PULONG Masked
+    )
+/*++
+
+Routine Description:
+
+    Returns the input value reduced into the number of edges.  See
+    MultiplyHighReduceIndex().
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the mask will be derived.
+
+    Input - Supplies the input value to mask.
+
+    Masked - Receives the masked value.
+
+Return Value:
+
+    S_OK.
+
+--*/
+{
+    *Masked = MultiplyHighReduceIndex(Input, Table->IndexModulus);
+    return S_OK;
+}
+
 // vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
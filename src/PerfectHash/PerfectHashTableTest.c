@@ -94,10 +94,18 @@ Return Value:
     ULONG NumberOfKeys;
     ULONG ValueIndex;
     ULONG NumberOfBitsSet;
+    ULONG Base;
+    ULONG Count;
+    ULONG Offset;
+    ULONG BatchIndices[PERFECT_HASH_TABLE_BATCH_GROUP_SIZE];
+    ULONG BatchValues[PERFECT_HASH_TABLE_BATCH_GROUP_SIZE];
+    ULONG BatchPrevious[PERFECT_HASH_TABLE_BATCH_GROUP_SIZE];
     KEY Key;
     KEY FirstKey;
     PKEY Source;
     PKEY SourceKeys;
+    PBYTE String;
+    PPERFECT_HASH_KEYS StringKeys;
     HRESULT Result = S_OK;
     PALLOCATOR Allocator;
     RTL_BITMAP Indices;
@@ -343,6 +351,121 @@ Return Value:
 
     }
 
+    //
+    // Exercise the batch routines.  For each group of keys, verify the batch
+    // indices match the scalar indices, then insert the rotated keys via the
+    // batch insert routine, verify they're returned by the batch lookup
+    // routine, and finally, delete them.
+    //
+
+    for (Base = 0; Base < NumberOfKeys; Base += Count) {
+
+        Count = min(PERFECT_HASH_TABLE_BATCH_GROUP_SIZE, NumberOfKeys - Base);
+        Source = &SourceKeys[Base];
+
+        Result = Table->Vtbl->IndexBatch(Table, Count, Source, BatchIndices);
+        ASSERT(!FAILED(Result));
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            Result = Table->Vtbl->Index(Table, Source[Offset], &ValueIndex);
+            ASSERT(!FAILED(Result));
+            ASSERT(BatchIndices[Offset] == ValueIndex);
+            BatchValues[Offset] = _rotl(Source[Offset], 15);
+        }
+
+        Result = Table->Vtbl->InsertBatch(Table,
+                                          Count,
+                                          Source,
+                                          BatchValues,
+                                          BatchPrevious);
+        ASSERT(!FAILED(Result));
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            ASSERT(BatchPrevious[Offset] == 0);
+            BatchValues[Offset] = 0;
+        }
+
+        Result = Table->Vtbl->LookupBatch(Table, Count, Source, BatchValues);
+        ASSERT(!FAILED(Result));
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            ASSERT(BatchValues[Offset] == _rotl(Source[Offset], 15));
+            Result = Table->Vtbl->Delete(Table, Source[Offset], &Previous);
+            ASSERT(!FAILED(Result));
+        }
+    }
+
+    //
+    // Exercise the membership routines.  If the table has fingerprints, every
+    // key in the original set must be reported as present, and TryLookup()
+    // must return the value we insert.  Otherwise, both routines must report
+    // that the table has no fingerprints.
+    //
+
+    for (Index = 0, Source = SourceKeys; Index < NumberOfKeys; Index++) {
+
+        Key = *Source++;
+
+        if (!HasFingerprints(Table)) {
+            Result = Table->Vtbl->Contains(Table, Key);
+            ASSERT(Result == PH_E_TABLE_HAS_NO_FINGERPRINTS);
+            Result = Table->Vtbl->TryLookup(Table, Key, &Value);
+            ASSERT(Result == PH_E_TABLE_HAS_NO_FINGERPRINTS);
+            break;
+        }
+
+        Result = Table->Vtbl->Contains(Table, Key);
+        ASSERT(Result == S_OK);
+
+        Rotated = _rotl(Key, 15);
+        Result = Table->Vtbl->Insert(Table, Key, Rotated, &Previous);
+        ASSERT(!FAILED(Result));
+
+        Result = Table->Vtbl->TryLookup(Table, Key, &Value);
+        ASSERT(Result == S_OK);
+        ASSERT(Value == Rotated);
+
+        Result = Table->Vtbl->Delete(Table, Key, &Previous);
+        ASSERT(!FAILED(Result));
+    }
+
+    //
+    // Exercise the string key routines.  If the table retained its string
+    // keys, every string must resolve to its own index, and a truncated copy
+    // of a string must not resolve to that index (it may legitimately be some
+    // other key in the set).  Otherwise, the routine must report that the
+    // table has no string keys.
+    //
+
+    StringKeys = Table->StringKeys;
+
+    if (!StringKeys) {
+        Result = Table->Vtbl->TryIndexString(Table, NULL, 0, &Value);
+        ASSERT(Result == PH_E_TABLE_HAS_NO_STRING_KEYS);
+    } else {
+
+        for (Index = 0; Index < NumberOfKeys; Index++) {
+
+            Offset = StringKeys->StringKeyOffsets[Index];
+            Count = StringKeys->StringKeyOffsets[Index + 1] - Offset;
+            String = StringKeys->StringKeyData + Offset;
+
+            Result = Table->Vtbl->TryIndexString(Table, String, Count, &Value);
+            ASSERT(Result == S_OK);
+            ASSERT(Value == Index);
+
+            if (Count == 0) {
+                continue;
+            }
+
+            Result = Table->Vtbl->TryIndexString(Table,
+                                                 String,
+                                                 Count - 1,
+                                                 &Value);
+            ASSERT(Result == S_FALSE || (Result == S_OK && Value != Index));
+        }
+    }
+
     //
     // All of the tests completed, so capture some rudimentary benchmarks.
     //
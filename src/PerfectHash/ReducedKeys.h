@@ -0,0 +1,211 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    ReducedKeys.h
+
+Abstract:
+
+    This module implements helper routines shared by the key types that are
+    reduced to unique 32-bit keys when loaded: string keys (see StringKeys.h)
+    and 128-bit keys (see Keys128.h).  The graph is then solved over the
+    reduced keys with the table's normal seeded hash routines.
+
+    The reduction is a CRC32-C over the key's 8-byte lanes (two independent
+    lanes at a time, to hide the latency of the instruction), where each lane
+    is first multiplied by an odd, seed-derived constant.  The multiplication
+    matters: CRC32 is linear, so without it, two equal-length keys that
+    collide would collide for every seed.  With it, a different seed yields a
+    different set of collisions, so if any two keys reduce to the same 32-bit
+    key, the next seed in the sequence is tried.
+
+    Collisions are detected by sorting (reduced key, ordinal) pairs with an
+    LSD radix sort, and comparing adjacent reduced keys.  The sorted pairs are
+    also used to order the key array (and the original keys) by reduced key.
+
+    N.B. The reduced keys are effectively random 32-bit values, so the odds of
+         a collision-free seed fall with the square of the number of keys: a
+         seed succeeds ~60% of the time for 64K keys, but only ~1% of the time
+         for 200K keys.  Key sets larger than REDUCED_KEY_MAXIMUM_NUMBER_OF_KEYS
+         are therefore rejected when they are loaded, rather than after every
+         seed has been tried.
+
+    The same machinery is used to project 64-bit keys that can't be downsized
+    via _pext_u64() (i.e. keys that vary in more than 32 bit positions) to
+    32-bit keys.  The projection is a multiply-shift: the upper 32 bits of the
+    64-bit product of the key and an odd, seed-derived multiplier.  Unlike the
+    reduction, the projection is only an optimization: if no seed yields an
+    injective projection, the table simply uses the 64-bit keys.
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Define the reduced key seed sequence.  The seed for attempt N is the initial
+// seed plus N times the increment (the 32-bit golden ratio).
+//
+
+#define REDUCED_KEY_INITIAL_SEED 0x2d358dcc
+#define REDUCED_KEY_SEED_INCREMENT 0x9e3779b9
+#define REDUCED_KEY_MAXIMUM_SEED_ATTEMPTS 64
+
+//
+// Define the maximum number of keys that can be reduced.  At this many keys, a
+// seed is collision-free ~13% of the time, so the odds of all of the seed
+// attempts failing are ~1 in 10,000.  Beyond it, the odds rise quickly (to
+// ~50% for 200K keys).
+//
+
+#define REDUCED_KEY_MAXIMUM_NUMBER_OF_KEYS (1 << 17)
+
+//
+// The seed is expanded into the odd 64-bit lane multiplier via the 64-bit
+// golden ratio.
+//
+
+#define REDUCED_KEY_LANE_MULTIPLIER 0x9e3779b97f4a7c15ULL
+
+//
+// Each key is sorted as a ULONGLONG pair: the reduced 32-bit key in the high
+// 32 bits, and the key's ordinal in the keys file in the low 32 bits.  Only
+// the high 32 bits are sorted, one byte per pass.
+//
+
+#define REDUCED_KEY_PAIR_SORT_RADIX_BITS 8
+#define REDUCED_KEY_PAIR_SORT_RADIX (1 << REDUCED_KEY_PAIR_SORT_RADIX_BITS)
+#define REDUCED_KEY_PAIR_SORT_MASK (REDUCED_KEY_PAIR_SORT_RADIX - 1)
+#define REDUCED_KEY_PAIR_SORT_FIRST_SHIFT 32
+#define REDUCED_KEY_PAIR_SORT_LAST_SHIFT 56
+
+#define REDUCED_KEY_PAIR(Key, Ordinal) \
+    (((ULONGLONG)(Key) << 32) | (ULONGLONG)(Ordinal))
+
+#define REDUCED_KEY_PAIR_KEY(Pair) ((ULONG)((Pair) >> 32))
+#define REDUCED_KEY_PAIR_ORDINAL(Pair) ((ULONG)(Pair))
+
+FORCEINLINE
+ULONG
+GetReducedKeySeed(
+    _In_ ULONG Attempt
+    )
+{
+    return REDUCED_KEY_INITIAL_SEED + (Attempt * REDUCED_KEY_SEED_INCREMENT);
+}
+
+FORCEINLINE
+ULONGLONG
+GetReducedKeyLaneMultiplier(
+    _In_ ULONG Seed
+    )
+{
+    return ((ULONGLONG)Seed * REDUCED_KEY_LANE_MULTIPLIER) | 1;
+}
+
+//
+// Define the key projection constraints.  The odds of finding an injective
+// projection are negligible beyond 128K keys, so the search isn't attempted.
+//
+
+#define KEY_PROJECTION_MAXIMUM_SEED_ATTEMPTS 16
+#define KEY_PROJECTION_MAXIMUM_NUMBER_OF_KEYS (1 << 17)
+#define KEY_PROJECTION_SHIFT 32
+
+FORCEINLINE
+ULONGLONG
+GetKeyProjectionMultiplier(
+    _In_ ULONG Attempt
+    )
+{
+    return GetReducedKeyLaneMultiplier(GetReducedKeySeed(Attempt));
+}
+
+FORCEINLINE
+ULONG
+ProjectKey64(
+    _In_ ULONGLONG Key,
+    _In_ ULONGLONG Multiplier
+    )
+{
+    return (ULONG)((Key * Multiplier) >> KEY_PROJECTION_SHIFT);
+}
+
+FORCEINLINE
+VOID
+SortReducedKeyPairs(
+    _Inout_updates_(NumberOfPairs) PULONGLONG Pairs,
+    _Out_writes_(NumberOfPairs) PULONGLONG Temp,
+    _In_ ULONG NumberOfPairs
+    )
+/*++
+
+Routine Description:
+
+    Sorts an array of reduced key pairs by their reduced key via an LSD radix
+    sort of the upper 32 bits.  There are an even number of passes, so the
+    sorted pairs end up back in the Pairs array.
+
+Arguments:
+
+    Pairs - Supplies the array of pairs to sort.
+
+    Temp - Supplies a scratch array of the same size as Pairs.
+
+    NumberOfPairs - Supplies the number of elements in both arrays.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ULONG Shift;
+    ULONG Index;
+    ULONG Bucket;
+    ULONG Total;
+    ULONG Count;
+    PULONGLONG Source;
+    PULONGLONG Dest;
+    PULONGLONG Swap;
+    ULONG Counts[REDUCED_KEY_PAIR_SORT_RADIX];
+
+    Source = Pairs;
+    Dest = Temp;
+
+    for (Shift = REDUCED_KEY_PAIR_SORT_FIRST_SHIFT;
+         Shift <= REDUCED_KEY_PAIR_SORT_LAST_SHIFT;
+         Shift += REDUCED_KEY_PAIR_SORT_RADIX_BITS) {
+
+        ZeroArrayInline(Counts);
+
+        for (Index = 0; Index < NumberOfPairs; Index++) {
+            Bucket = (ULONG)(Source[Index] >> Shift);
+            Counts[Bucket & REDUCED_KEY_PAIR_SORT_MASK]++;
+        }
+
+        for (Bucket = 0, Total = 0;
+             Bucket < REDUCED_KEY_PAIR_SORT_RADIX;
+             Bucket++) {
+
+            Count = Counts[Bucket];
+            Counts[Bucket] = Total;
+            Total += Count;
+        }
+
+        for (Index = 0; Index < NumberOfPairs; Index++) {
+            Bucket = (ULONG)(Source[Index] >> Shift);
+            Bucket &= REDUCED_KEY_PAIR_SORT_MASK;
+            Dest[Counts[Bucket]++] = Source[Index];
+        }
+
+        Swap = Source;
+        Source = Dest;
+        Dest = Swap;
+    }
+
+    ASSERT(Source == Pairs);
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -476,6 +476,7 @@ Return Value:
     LONG ExtendedId;
     LONG HighestId;
     LONG HighestExtendedId;
+    ULONG Family = 0;
     PSTRING Brand;
 
     Features = &Rtl->CpuFeatures;
@@ -509,6 +510,21 @@ Return Value:
 
         Features->F1Ecx.AsLong = CpuInfo.Ecx;
         Features->F1Edx.AsLong = CpuInfo.Edx;
+
+        //
+        // Capture the family; the extended family is only added if the base
+        // family is 0xf.
+        //
+
+        Family = ((ULONG)CpuInfo.Eax >> CPU_FAMILY_BASE_SHIFT);
+        Family &= CPU_FAMILY_BASE_MASK;
+        if (Family == CPU_FAMILY_USES_EXTENDED) {
+            Family += (
+                ((ULONG)CpuInfo.Eax >> CPU_FAMILY_EXTENDED_SHIFT) &
+                CPU_FAMILY_EXTENDED_MASK
+            );
+        }
+        Features->Derived.Family = Family;
     }
 
     if (HighestId >= 7) {
@@ -563,6 +579,17 @@ Return Value:
         Features->AMD.THREEDNOWEXT = BooleanFlagOn(F81Edx, 1 << 30);
     }
 
+    //
+    // AMD parts prior to Zen 3 implement _pext_u64() in microcode, taking
+    // tens to hundreds of cycles depending on the mask.
+    //
+
+    Features->Derived.FastPext = (
+        Features->BMI2 != FALSE &&
+        !(Features->Vendor.IsAMD &&
+          Features->Derived.Family < CPU_FAMILY_AMD_ZEN3)
+    );
+
     //
     // Capture the CPU brand string if available.
     //
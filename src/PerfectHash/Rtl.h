@@ -870,6 +870,18 @@ typedef union _RTL_CPU_FEATURES_F81_EDX {
 C_ASSERT(sizeof(RTL_CPU_FEATURES_F81_EDX) == sizeof(ULONG));
 typedef RTL_CPU_FEATURES_F81_EDX *PRTL_CPU_FEATURES_F81_EDX;
 
+//
+// Define helper constants for extracting the CPU family from the EAX value of
+// CPUID function 1.
+//
+
+#define CPU_FAMILY_BASE_SHIFT 8
+#define CPU_FAMILY_BASE_MASK 0xf
+#define CPU_FAMILY_EXTENDED_SHIFT 20
+#define CPU_FAMILY_EXTENDED_MASK 0xff
+#define CPU_FAMILY_USES_EXTENDED 0xf
+#define CPU_FAMILY_AMD_ZEN3 0x19
+
 //
 // Define the union of all CPU feature flags we support for x86/x64.
 //
@@ -925,7 +937,17 @@ typedef struct _RTL_CPU_FEATURES {
         ULONG RDTSCP:1;
     } Intel;
 
-    ULONG Padding;
+    //
+    // Features we derive from the vendor, family and feature bits above.
+    // FastPext is set if BMI2 is present and _pext_u64() isn't microcoded;
+    // i.e. the CPU isn't an AMD part prior to Zen 3 (family 0x19).
+    //
+
+    struct _Struct_size_bytes_(sizeof(ULONG)) {
+        ULONG Family:8;
+        ULONG FastPext:1;
+        ULONG Unused:23;
+    } Derived;
 
     union {
 
@@ -1005,6 +1027,31 @@ typedef struct _RTL_CPU_FEATURES {
 typedef RTL_CPU_FEATURES *PRTL_CPU_FEATURES;
 #endif // defined(_M_AMD64) || defined(_M_X64) || defined(_M_IX86)
 
+////////////////////////////////////////////////////////////////////////////////
+// Threadpool
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// (Annoyingly, winnt.h only defines PTP_WORK_CALLBACK, not the underlying
+//  raw function type TP_WORK_CALLBACK, so, do that now.  Ditto for the
+//  PTP_CLEANUP_GROUP_CANCEL_CALLBACK signature.)
+//
+
+typedef
+VOID
+(NTAPI TP_WORK_CALLBACK)(
+    _Inout_     PTP_CALLBACK_INSTANCE Instance,
+    _Inout_opt_ PVOID                 Context,
+    _Inout_     PTP_WORK              Work
+    );
+
+typedef
+VOID
+(NTAPI TP_CLEANUP_GROUP_CANCEL_CALLBACK)(
+    _Inout_opt_ PVOID ObjectContext,
+    _Inout_opt_ PVOID CleanupContext
+    );
+
 ////////////////////////////////////////////////////////////////////////////////
 // Memory/String
 ////////////////////////////////////////////////////////////////////////////////
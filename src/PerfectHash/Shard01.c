@@ -0,0 +1,497 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    Shard01.c
+
+Abstract:
+
+    This module implements the Shard01 perfect hash table algorithm, which
+    partitions the keys into shards and solves each shard as an independent
+    CHM graph.  See Shard01.h for an overview.
+
+    The solving machinery (graph allocation, threadpool dispatch, table resize
+    events, file work) is shared with the CHM algorithm; see
+    CreatePerfectHashTableImplChm01().  The Shard01-specific logic lives in
+    this module (key partitioning and table data layout), the graph sizing
+    (PrepareGraphInfoChm01()), the shard solving loop (GraphImplShard01.c)
+    and the Index() routine (Shard01Index.c).
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Forward decls.
+//
+
+VOID
+FreeShardsShard01(
+    _In_ PPERFECT_HASH_TABLE Table
+    );
+
+
+_Use_decl_annotations_
+HRESULT
+CreatePerfectHashTableImplShard01(
+    PPERFECT_HASH_TABLE Table
+    )
+/*++
+
+Routine Description:
+
+    Attempts to create a sharded perfect hash table.  The keys are partitioned
+    into shards (sorted by shard into a temporary array), then the CHM
+    creation pipeline is invoked to solve each shard's graph.
+
+Arguments:
+
+    Table - Supplies a pointer to a partially-initialized PERFECT_HASH_TABLE
+        structure.
+
+Return Value:
+
+    S_OK - Table created successfully.
+
+    E_OUTOFMEMORY - Out of memory.
+
+    PH_E_TOO_MANY_KEYS - Too many keys.
+
+    PH_E_INVALID_GRAPH_IMPL - The graph implementation requested is not
+        supported by the Shard01 algorithm (only version 3 is supported).
+
+    PH_E_NOT_IMPLEMENTED - Modulus masking, a mode other than "first solved
+        graph wins", keys wider than 32 bits, or a hash function requiring
+        more than SHARD01_MAX_NUMBER_OF_SEEDS seeds was requested.  None of
+        these are supported by the Shard01 algorithm.
+
+    Otherwise, any of the return codes documented by
+    CreatePerfectHashTableImplChm01().
+
+--*/
+{
+    PRTL Rtl;
+    PKEY Key;
+    PKEY Keys;
+    PKEY EndKey;
+    ULONG Shard;
+    ULONG Offset;
+    ULONG NumberOfKeys;
+    ULONG NumberOfShards;
+    HRESULT Result;
+    SIZE_T SizeInBytes;
+    BOOLEAN LargePages;
+    PSHARD01_DIRECTORY_ENTRY Entry;
+    PSHARD01_DIRECTORY_ENTRY Shards;
+    PPERFECT_HASH_CONTEXT Context;
+    PRTL_TRY_LARGE_PAGE_VIRTUAL_ALLOC TryLargePageVirtualAlloc;
+
+    if (!ARGUMENT_PRESENT(Table)) {
+        return E_POINTER;
+    }
+
+    Rtl = Table->Rtl;
+    Context = Table->Context;
+
+    //
+    // Each shard is solved with the version 3 graph routines.
+    //
+
+    if (Table->GraphImpl != 3) {
+        return PH_E_INVALID_GRAPH_IMPL;
+    }
+
+    //
+    // All shards share the same power-of-2 dimensions, so modulus and
+    // multiply-high masking aren't supported.  The notion of a "best" graph
+    // doesn't apply to a table composed of thousands of independently-solved
+    // graphs, so only "first solved graph wins" mode is supported.
+    //
+
+    if (IsModulusMasking(Table->MaskFunctionId) ||
+        IsMultiplyHighMasking(Table->MaskFunctionId)) {
+        return PH_E_NOT_IMPLEMENTED;
+    }
+
+    if (!FirstSolvedGraphWins(Context)) {
+        return PH_E_NOT_IMPLEMENTED;
+    }
+
+    if (Table->Keys->KeySizeInBytes != sizeof(ULONG)) {
+        return PH_E_NOT_IMPLEMENTED;
+    }
+
+    if (HashRoutineNumberOfSeeds[Table->HashFunctionId] >
+        SHARD01_MAX_NUMBER_OF_SEEDS) {
+        return PH_E_NOT_IMPLEMENTED;
+    }
+
+    if (Table->Keys->NumberOfElements.HighPart) {
+        return PH_E_TOO_MANY_KEYS;
+    }
+
+    NumberOfKeys = Table->Keys->NumberOfElements.LowPart;
+    NumberOfShards = Shard01GetNumberOfShards(NumberOfKeys);
+    Keys = (PKEY)Table->Keys->KeyArrayBaseAddress;
+
+    //
+    // Allocate the shard directory and the sharded keys array.
+    //
+
+    TryLargePageVirtualAlloc = Rtl->Vtbl->TryLargePageVirtualAlloc;
+
+    LargePages = FALSE;
+    SizeInBytes = (SIZE_T)NumberOfShards * sizeof(*Shards);
+    Shards = TryLargePageVirtualAlloc(Rtl,
+                                      NULL,
+                                      SizeInBytes,
+                                      MEM_RESERVE | MEM_COMMIT,
+                                      PAGE_READWRITE,
+                                      &LargePages);
+
+    if (!Shards) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    Table->Shards = Shards;
+    Table->NumberOfShards = NumberOfShards;
+
+    LargePages = FALSE;
+    SizeInBytes = (SIZE_T)NumberOfKeys * sizeof(KEY);
+    Table->ShardedKeys = TryLargePageVirtualAlloc(Rtl,
+                                                  NULL,
+                                                  SizeInBytes,
+                                                  MEM_RESERVE | MEM_COMMIT,
+                                                  PAGE_READWRITE,
+                                                  &LargePages);
+
+    if (!Table->ShardedKeys) {
+        Result = E_OUTOFMEMORY;
+        goto Error;
+    }
+
+    //
+    // Partition the keys by shard via a counting sort.  First, count the
+    // number of keys in each shard.
+    //
+
+    EndKey = Keys + NumberOfKeys;
+
+    for (Key = Keys; Key < EndKey; Key++) {
+        Shard = Shard01GetShard(*Key, NumberOfShards);
+        Shards[Shard].NumberOfKeys++;
+    }
+
+    //
+    // Convert the counts into key offsets, tracking the largest shard as we
+    // go.  The number of keys is reset to zero such that it can be used as
+    // the scatter cursor below (it will end up back at its original value).
+    //
+
+    Offset = 0;
+    Table->MaximumNumberOfKeysPerShard = 0;
+
+    for (Shard = 0; Shard < NumberOfShards; Shard++) {
+        Entry = &Shards[Shard];
+        Entry->KeyOffset = Offset;
+        Offset += Entry->NumberOfKeys;
+        if (Entry->NumberOfKeys > Table->MaximumNumberOfKeysPerShard) {
+            Table->MaximumNumberOfKeysPerShard = Entry->NumberOfKeys;
+        }
+        Entry->NumberOfKeys = 0;
+    }
+
+    ASSERT(Offset == NumberOfKeys);
+
+    //
+    // Scatter the keys into their shards.
+    //
+
+    for (Key = Keys; Key < EndKey; Key++) {
+        Entry = &Shards[Shard01GetShard(*Key, NumberOfShards)];
+        Table->ShardedKeys[Entry->KeyOffset + Entry->NumberOfKeys++] = *Key;
+    }
+
+    //
+    // Invoke the CHM creation pipeline.  It will call PrepareShardsShard01()
+    // once the graph dimensions are known (and again after each table resize
+    // event), and dispatch to GraphSolveShardsShard01() for solving.
+    //
+
+    Result = CreatePerfectHashTableImplChm01(Table);
+    goto End;
+
+Error:
+
+    if (Result == S_OK) {
+        Result = E_UNEXPECTED;
+    }
+
+    //
+    // Intentional follow-on to End.
+    //
+
+End:
+
+    //
+    // The directory and assigned arrays have been copied into the table data
+    // at this point (if creation succeeded), so the creation-only buffers can
+    // be released.
+    //
+
+    FreeShardsShard01(Table);
+
+    return Result;
+}
+
+
+_Use_decl_annotations_
+VOID
+FreeShardsShard01(
+    PPERFECT_HASH_TABLE Table
+    )
+/*++
+
+Routine Description:
+
+    Frees the creation-only Shard01 buffers hanging off the table.
+
+Arguments:
+
+    Table - Supplies a pointer to the table.
+
+Return Value:
+
+    None.
+
+--*/
+{
+
+#define FREE_SHARD_BUFFER(Name)                           \
+    if (Table->##Name != NULL) {                          \
+        if (!VirtualFree(Table->##Name, 0, MEM_RELEASE)) { \
+            SYS_ERROR(VirtualFree);                       \
+        }                                                 \
+        Table->##Name = NULL;                             \
+    }
+
+    FREE_SHARD_BUFFER(Shards);
+    FREE_SHARD_BUFFER(ShardedKeys);
+    FREE_SHARD_BUFFER(ShardAssigned);
+
+    Table->ShardAssignedSizeInBytes = 0;
+}
+
+
+PREPARE_SHARDS PrepareShardsShard01;
+
+_Use_decl_annotations_
+HRESULT
+PrepareShardsShard01(
+    PPERFECT_HASH_TABLE Table,
+    ULONG NumberOfVertices
+    )
+/*++
+
+Routine Description:
+
+    Prepares the Shard01 solving state for a given graph size.  This is called
+    by PrepareGraphInfoChm01() prior to each round of solving (i.e. initially,
+    and after each table resize event).  The concatenated assigned array is
+    (re)allocated to accommodate NumberOfVertices per shard, and the shard
+    claim counters are reset.
+
+Arguments:
+
+    Table - Supplies a pointer to the table.
+
+    NumberOfVertices - Supplies the number of vertices in each shard's graph.
+
+Return Value:
+
+    S_OK - Success.
+
+    E_OUTOFMEMORY - Out of memory.
+
+--*/
+{
+    PRTL Rtl;
+    SIZE_T SizeInBytes;
+    BOOLEAN LargePages;
+    PRTL_TRY_LARGE_PAGE_VIRTUAL_ALLOC TryLargePageVirtualAlloc;
+
+    Rtl = Table->Rtl;
+
+    SizeInBytes = (
+        (SIZE_T)Table->NumberOfShards *
+        (SIZE_T)NumberOfVertices *
+        sizeof(ULONG)
+    );
+
+    if (Table->ShardAssigned != NULL &&
+        Table->ShardAssignedSizeInBytes != SizeInBytes) {
+
+        if (!VirtualFree(Table->ShardAssigned, 0, MEM_RELEASE)) {
+            SYS_ERROR(VirtualFree);
+        }
+
+        Table->ShardAssigned = NULL;
+        Table->ShardAssignedSizeInBytes = 0;
+    }
+
+    if (Table->ShardAssigned == NULL) {
+
+        LargePages = (
+            Table->TableCreateFlags.TryLargePagesForTableData == TRUE
+        );
+
+        TryLargePageVirtualAlloc = Rtl->Vtbl->TryLargePageVirtualAlloc;
+        Table->ShardAssigned = TryLargePageVirtualAlloc(
+            Rtl,
+            NULL,
+            SizeInBytes,
+            MEM_RESERVE | MEM_COMMIT,
+            PAGE_READWRITE,
+            &LargePages
+        );
+
+        if (!Table->ShardAssigned) {
+            return E_OUTOFMEMORY;
+        }
+
+        Table->ShardAssignedSizeInBytes = SizeInBytes;
+
+    } else {
+
+        //
+        // Shards with no keys are never solved, and rely on their assigned
+        // values being zero; clear anything left over from prior attempts.
+        //
+
+        ZeroMemory(Table->ShardAssigned, SizeInBytes);
+    }
+
+    Table->NextShard = 0;
+    Table->NumberOfShardsRemaining = (LONG)Table->NumberOfShards;
+
+    return S_OK;
+}
+
+
+COPY_SHARD_TABLE_DATA CopyShardTableDataShard01;
+
+_Use_decl_annotations_
+VOID
+CopyShardTableDataShard01(
+    PPERFECT_HASH_TABLE Table,
+    PVOID Destination,
+    ULONGLONG SizeInBytes
+    )
+/*++
+
+Routine Description:
+
+    Copies the shard directory and concatenated assigned arrays into a table
+    data buffer.  See Shard01.h for the layout.
+
+Arguments:
+
+    Table - Supplies a pointer to the table.
+
+    Destination - Supplies the base address of the table data buffer.
+
+    SizeInBytes - Supplies the size of the table data buffer, in bytes.  This
+        must match the size of the directory plus the assigned arrays.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    PRTL Rtl;
+    PBYTE Dest;
+    SIZE_T DirectorySizeInBytes;
+
+    Rtl = Table->Rtl;
+
+    DirectorySizeInBytes = (
+        (SIZE_T)Table->NumberOfShards * sizeof(SHARD01_DIRECTORY_ENTRY)
+    );
+
+    if (SizeInBytes !=
+        (ULONGLONG)(DirectorySizeInBytes + Table->ShardAssignedSizeInBytes)) {
+        PH_RAISE(PH_E_INVARIANT_CHECK_FAILED);
+    }
+
+    Dest = (PBYTE)Destination;
+    CopyMemory(Dest, Table->Shards, DirectorySizeInBytes);
+
+    Dest += DirectorySizeInBytes;
+    CopyMemory(Dest, Table->ShardAssigned, Table->ShardAssignedSizeInBytes);
+}
+
+
+_Use_decl_annotations_
+HRESULT
+LoadPerfectHashTableImplShard01(
+    PPERFECT_HASH_TABLE Table
+    )
+/*++
+
+Routine Description:
+
+    Loads a previously created Shard01 perfect hash table.
+
+Arguments:
+
+    Table - Supplies a pointer to a partially-initialized PERFECT_HASH_TABLE
+        structure.
+
+Return Value:
+
+    S_OK - Table was loaded successfully.
+
+    PH_E_INVARIANT_CHECK_FAILED - The on-disk table info is inconsistent with
+        a Shard01 table.
+
+--*/
+{
+    PTABLE_INFO_ON_DISK OnDisk;
+
+    OnDisk = Table->TableInfoOnDisk;
+
+    //
+    // Verify the number of table elements accounts for the shard directory
+    // and each shard's assigned array.
+    //
+
+    if (OnDisk->NumberOfShards == 0 || OnDisk->HashSize == 0) {
+        return PH_E_INVARIANT_CHECK_FAILED;
+    }
+
+    if (OnDisk->NumberOfTableElements.QuadPart !=
+        Shard01GetNumberOfTableElements(OnDisk->NumberOfShards,
+                                        OnDisk->HashSize)) {
+        return PH_E_INVARIANT_CHECK_FAILED;
+    }
+
+    Table->NumberOfShards = OnDisk->NumberOfShards;
+    Table->HashSize = OnDisk->HashSize;
+    Table->IndexSize = OnDisk->IndexSize;
+    Table->HashShift = OnDisk->HashShift;
+    Table->IndexShift = OnDisk->IndexShift;
+    Table->HashMask = OnDisk->HashMask;
+    Table->IndexMask = OnDisk->IndexMask;
+    Table->HashFold = OnDisk->HashFold;
+    Table->IndexFold = OnDisk->IndexFold;
+    Table->HashModulus = OnDisk->HashModulus;
+    Table->IndexModulus = OnDisk->IndexModulus;
+
+    return S_OK;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -0,0 +1,292 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    Shard01.h
+
+Abstract:
+
+    This is the header file for the Shard01.c module, which implements a
+    sharded (two-level) perfect hash table algorithm aimed at very large key
+    sets (i.e. hundreds of millions of keys).
+
+    Keys are first partitioned into shards via a hash that is independent of
+    the table's seeded hash function (the murmur3 32-bit finalizer, followed
+    by a multiply-high range reduction).  Each shard holds a few thousand keys
+    on average, and is solved as an independent, small CHM graph; shards are
+    claimed by the threadpool's graph solving callbacks until none remain.
+    Small graphs fit comfortably in cache, which makes solving considerably
+    faster than a single graph spanning the entire key set.
+
+    The resulting table data is laid out as a shard directory followed by the
+    concatenation of each shard's assigned array:
+
+        [SHARD01_DIRECTORY_ENTRY Shards[NumberOfShards]]
+        [ULONG Assigned[NumberOfShards][HashSize]]
+
+    Each directory entry captures the shard's seeds and the offset of its
+    first key within the shard-sorted key order.  Index() is minimal: a key's
+    index is its shard's key offset plus its index within the shard, which
+    will always lie between 0 and NumberOfKeys-1.
+
+    All shards share the same graph dimensions (sized to fit the largest
+    shard), and thus, the same hash and index masks.  A table resize event
+    doubles the number of vertices of every shard.
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Helper macro for determining if a table is using the Shard01 algorithm.
+//
+
+#define IsShard01(Table) ((Table)->AlgorithmId == PerfectHashShard01AlgorithmId)
+
+//
+// Define the target number of keys per shard.  The number of shards is
+// derived by dividing the number of keys by this value (rounding up).  The
+// default yields shards whose graphs (assigned array and vertices) occupy a
+// few hundred KB; i.e. small enough to stay resident in L2.
+//
+
+#define SHARD01_TARGET_NUMBER_OF_KEYS_PER_SHARD 7168
+
+//
+// Define the murmur3 32-bit finalizer constants used to derive the shard
+// for a given key.
+//
+// N.B. These values are duplicated in the compiled perfect hash table Index()
+//      implementations in ../CompiledPerfectHashTable/*Shard01*.c; if you
+//      change them here, change them there too.
+//
+
+#define SHARD01_FMIX32_MULTIPLIER1 0x85ebca6b
+#define SHARD01_FMIX32_MULTIPLIER2 0xc2b2ae35
+
+//
+// Define the shard directory entry.  The seeds array is large enough to
+// accommodate all of the hash functions supported by Shard01 (see the
+// compiled Index() implementations), and pads the structure out to 32 bytes
+// such that two entries fit in a cache line.
+//
+
+#define SHARD01_MAX_NUMBER_OF_SEEDS 6
+
+typedef struct _SHARD01_DIRECTORY_ENTRY {
+
+    //
+    // Index of the shard's first key within the shard-sorted key order.  This
+    // is added to the shard-relative index to obtain the final index.
+    //
+
+    ULONG KeyOffset;
+
+    //
+    // Number of keys in the shard.
+    //
+
+    ULONG NumberOfKeys;
+
+    //
+    // Seeds used by the shard's solved graph.
+    //
+
+    ULONG Seeds[SHARD01_MAX_NUMBER_OF_SEEDS];
+
+} SHARD01_DIRECTORY_ENTRY;
+C_ASSERT(sizeof(SHARD01_DIRECTORY_ENTRY) == 32);
+typedef SHARD01_DIRECTORY_ENTRY *PSHARD01_DIRECTORY_ENTRY;
+
+#define SHARD01_DIRECTORY_ENTRY_SIZE_IN_ULONGS \
+    (sizeof(SHARD01_DIRECTORY_ENTRY) / sizeof(ULONG))
+
+FORCEINLINE
+ULONG
+Shard01GetShard(
+    _In_ ULONG Key,
+    _In_ ULONG NumberOfShards
+    )
+/*++
+
+Routine Description:
+
+    Returns the shard for a given key.  The key is mixed with the murmur3
+    32-bit finalizer, then range-reduced into [0, NumberOfShards) via a
+    multiply-high.
+
+Arguments:
+
+    Key - Supplies the key.
+
+    NumberOfShards - Supplies the number of shards.
+
+Return Value:
+
+    The shard, between 0 and NumberOfShards-1.
+
+--*/
+{
+    ULONG Hash;
+
+    Hash = Key;
+    Hash ^= Hash >> 16;
+    Hash *= SHARD01_FMIX32_MULTIPLIER1;
+    Hash ^= Hash >> 13;
+    Hash *= SHARD01_FMIX32_MULTIPLIER2;
+    Hash ^= Hash >> 16;
+
+    return (ULONG)(((ULONGLONG)Hash * (ULONGLONG)NumberOfShards) >> 32);
+}
+
+FORCEINLINE
+ULONG
+Shard01GetNumberOfShards(
+    _In_ ULONG NumberOfKeys
+    )
+{
+    return (
+        (NumberOfKeys + (SHARD01_TARGET_NUMBER_OF_KEYS_PER_SHARD - 1)) /
+        SHARD01_TARGET_NUMBER_OF_KEYS_PER_SHARD
+    );
+}
+
+FORCEINLINE
+ULONGLONG
+Shard01GetNumberOfTableElements(
+    _In_ ULONG NumberOfShards,
+    _In_ ULONG HashSize
+    )
+/*++
+
+Routine Description:
+
+    Returns the number of ULONG table data elements for a Shard01 table; i.e.
+    the size of the shard directory plus the concatenated assigned arrays.
+    This value is stored in TableInfoOnDisk->NumberOfTableElements, which
+    ensures the generic table data sizing logic (NumberOfTableElements *
+    KeySizeInBytes) remains correct.
+
+Arguments:
+
+    NumberOfShards - Supplies the number of shards.
+
+    HashSize - Supplies the number of vertices per shard.
+
+Return Value:
+
+    The number of table elements.
+
+--*/
+{
+    return (
+        (ULONGLONG)NumberOfShards *
+        ((ULONGLONG)HashSize + SHARD01_DIRECTORY_ENTRY_SIZE_IN_ULONGS)
+    );
+}
+
+FORCEINLINE
+ULONG
+Shard01IndexKey(
+    _In_ PPERFECT_HASH_TABLE Table,
+    _In_ PSHARD01_DIRECTORY_ENTRY Shards,
+    _In_ PULONG Assigned,
+    _In_ ULONG Key
+    )
+/*++
+
+Routine Description:
+
+    Looks up a key's index given a shard directory and the concatenated
+    per-shard assigned arrays.  This is shared by the Index() routine (which
+    operates on the table data) and graph verification (which operates on
+    the creation-time directory and assigned arrays).
+
+Arguments:
+
+    Table - Supplies a pointer to the table.
+
+    Shards - Supplies the base address of the shard directory.
+
+    Assigned - Supplies the base address of the concatenated assigned arrays.
+
+    Key - Supplies the key to look up.
+
+Return Value:
+
+    The key's index.
+
+--*/
+{
+    ULONG Shard;
+    ULONG Vertex1;
+    ULONG Vertex2;
+    PULONG ShardAssigned;
+    ULARGE_INTEGER Hash;
+    PSHARD01_DIRECTORY_ENTRY Entry;
+
+    Shard = Shard01GetShard(Key, Table->NumberOfShards);
+    Entry = &Shards[Shard];
+
+    Hash.QuadPart = Table->Vtbl->SeededHashEx(Key,
+                                              Entry->Seeds,
+                                              Table->HashMask);
+
+    ShardAssigned = Assigned + ((ULONGLONG)Shard << Table->HashShift);
+
+    Vertex1 = ShardAssigned[Hash.LowPart];
+    Vertex2 = ShardAssigned[Hash.HighPart];
+
+    return Entry->KeyOffset + ((Vertex1 + Vertex2) & Table->IndexMask);
+}
+
+//
+// Shard01 routines used by the Chm01 creation pipeline (Shard01.c).
+//
+
+typedef
+_Must_inspect_result_
+_Success_(return >= 0)
+HRESULT
+(NTAPI PREPARE_SHARDS)(
+    _In_ PPERFECT_HASH_TABLE Table,
+    _In_ ULONG NumberOfVertices
+    );
+typedef PREPARE_SHARDS *PPREPARE_SHARDS;
+
+typedef
+VOID
+(NTAPI COPY_SHARD_TABLE_DATA)(
+    _In_ PPERFECT_HASH_TABLE Table,
+    _Out_writes_bytes_all_(SizeInBytes) PVOID Destination,
+    _In_ ULONGLONG SizeInBytes
+    );
+typedef COPY_SHARD_TABLE_DATA *PCOPY_SHARD_TABLE_DATA;
+
+#ifndef __INTELLISENSE__
+extern PREPARE_SHARDS PrepareShardsShard01;
+extern COPY_SHARD_TABLE_DATA CopyShardTableDataShard01;
+#endif
+
+//
+// Declare the Shard01 graph implementation routines (GraphImplShard01.c).
+//
+
+typedef
+_Must_inspect_result_
+_Success_(return >= 0)
+_Requires_exclusive_lock_held_(Graph->Lock)
+HRESULT
+(STDAPICALLTYPE GRAPH_SOLVE_SHARDS)(
+    _In_ PGRAPH Graph
+    );
+typedef GRAPH_SOLVE_SHARDS *PGRAPH_SOLVE_SHARDS;
+
+#ifndef __INTELLISENSE__
+extern GRAPH_SOLVE_SHARDS GraphSolveShardsShard01;
+extern GRAPH_VERIFY GraphVerifyShard01;
+#endif
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -0,0 +1,187 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    Shard01Index.c
+
+Abstract:
+
+    This module implements the Index() and IndexBatch() routines for the Shard01
+    algorithm.
+
+--*/
+
+#include "stdafx.h"
+
+PERFECT_HASH_TABLE_INDEX PerfectHashTableIndexImplShard01;
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableIndexImplShard01(
+    PPERFECT_HASH_TABLE Table,
+    ULONG Key,
+    PULONG Index
+    )
+/*++
+
+Routine Description:
+
+    Looks up given key in a perfect hash table and returns its index.
+
+    N.B. If Key did not appear in the original set the hash table was created
+         from, the behavior of this routine is undefined.  (In practice, the
+         key will hash to some other key's index.)
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the key lookup is to be
+        performed.
+
+    Key - Supplies the key to look up.
+
+    Index - Receives the index associated with this key.  The index will be
+        between 0 and the number of keys minus 1, and can be safely used to
+        offset directly into an appropriately sized array (e.g.
+        Table->Values[]).
+
+Return Value:
+
+    S_OK.
+
+--*/
+{
+    PULONG Assigned;
+    PSHARD01_DIRECTORY_ENTRY Shards;
+
+    //
+    // The table data starts with the shard directory, followed by each
+    // shard's assigned array.
+    //
+
+    Shards = (PSHARD01_DIRECTORY_ENTRY)Table->TableData;
+    Assigned = (PULONG)(Shards + Table->NumberOfShards);
+
+    *Index = Shard01IndexKey(Table, Shards, Assigned, Key);
+
+    return S_OK;
+}
+
+PERFECT_HASH_TABLE_INDEX_BATCH PerfectHashTableIndexBatchImplShard01;
+
+_Use_decl_annotations_
+HRESULT
+PerfectHashTableIndexBatchImplShard01(
+    PPERFECT_HASH_TABLE Table,
+    ULONG NumberOfKeys,
+    PULONG Keys,
+    PULONG Indices
+    )
+/*++
+
+Routine Description:
+
+    Looks up an array of keys in a perfect hash table and returns their
+    indices.  Keys are processed in groups of
+    PERFECT_HASH_TABLE_BATCH_GROUP_SIZE, in three passes: the shard of each
+    key is derived and its directory entry prefetched; each key is hashed with
+    its shard's seeds and both of its assigned slots prefetched; then the
+    group's indices are resolved.
+
+    N.B. If a key did not appear in the original set the hash table was created
+         from, the behavior of this routine is undefined for that key.
+
+Arguments:
+
+    Table - Supplies a pointer to the table for which the key lookups are to
+        be performed.
+
+    NumberOfKeys - Supplies the number of keys in the Keys array.
+
+    Keys - Supplies the base address of an array of keys to look up.
+
+    Indices - Receives the index associated with each key.
+
+Return Value:
+
+    S_OK.
+
+--*/
+{
+    ULONG Base;
+    ULONG Count;
+    ULONG Offset;
+    PULONG Assigned;
+    PULONG ShardAssigned;
+    ULARGE_INTEGER Hash;
+    PSHARD01_DIRECTORY_ENTRY Entry;
+    PSHARD01_DIRECTORY_ENTRY Shards;
+    ULONG ShardIds[PERFECT_HASH_TABLE_BATCH_GROUP_SIZE];
+    ULARGE_INTEGER VertexPairs[PERFECT_HASH_TABLE_BATCH_GROUP_SIZE];
+
+    //
+    // The table data starts with the shard directory, followed by each
+    // shard's assigned array.
+    //
+
+    Shards = (PSHARD01_DIRECTORY_ENTRY)Table->TableData;
+    Assigned = (PULONG)(Shards + Table->NumberOfShards);
+
+    for (Base = 0; Base < NumberOfKeys; Base += Count) {
+
+        Count = min(PERFECT_HASH_TABLE_BATCH_GROUP_SIZE, NumberOfKeys - Base);
+
+        //
+        // Derive the shard of each key and prefetch its directory entry.
+        //
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            ShardIds[Offset] = Shard01GetShard(Keys[Base + Offset],
+                                               Table->NumberOfShards);
+            PreFetchCacheLine(PF_TEMPORAL_LEVEL_1, &Shards[ShardIds[Offset]]);
+        }
+
+        //
+        // Hash each key with its shard's seeds, and prefetch both of the
+        // assigned slots.  The vertices are converted into offsets relative
+        // to the base of the concatenated assigned arrays.
+        //
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            Entry = &Shards[ShardIds[Offset]];
+            Hash.QuadPart = Table->Vtbl->SeededHashEx(Keys[Base + Offset],
+                                                      Entry->Seeds,
+                                                      Table->HashMask);
+            ShardAssigned = Assigned + (
+                (ULONGLONG)ShardIds[Offset] << Table->HashShift
+            );
+            PreFetchCacheLine(PF_TEMPORAL_LEVEL_1,
+                              &ShardAssigned[Hash.LowPart]);
+            PreFetchCacheLine(PF_TEMPORAL_LEVEL_1,
+                              &ShardAssigned[Hash.HighPart]);
+            VertexPairs[Offset].QuadPart = Hash.QuadPart;
+        }
+
+        //
+        // Resolve the indices of the group.
+        //
+
+        for (Offset = 0; Offset < Count; Offset++) {
+            Entry = &Shards[ShardIds[Offset]];
+            Hash.QuadPart = VertexPairs[Offset].QuadPart;
+            ShardAssigned = Assigned + (
+                (ULONGLONG)ShardIds[Offset] << Table->HashShift
+            );
+
+            Indices[Base + Offset] = Entry->KeyOffset + (
+                (ShardAssigned[Hash.LowPart] + ShardAssigned[Hash.HighPart]) &
+                Table->IndexMask
+            );
+        }
+    }
+
+    return S_OK;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -0,0 +1,103 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    StringKeys.h
+
+Abstract:
+
+    This module implements helper routines for string keys (i.e. keys loaded
+    with the --StringKeys keys load flag).
+
+    A string keys file is a sequence of length-prefixed byte strings: each key
+    is a little-endian USHORT length, followed immediately by that many bytes
+    of key data.  There is no padding or terminator between keys, and the keys
+    do not need to be sorted.  Empty strings are permitted.
+
+    Each string is reduced to a unique 32-bit key when the keys are loaded;
+    see ReducedKeys.h for details.  The string's final partial lane, if any,
+    is zero-extended.
+
+    N.B. The compiled perfect hash tables use the identical reduction; see
+         CphHashStringKey() in ../../include/CompiledPerfectHash.h.
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Define the string key constraints.
+//
+
+#define STRING_KEY_LENGTH_PREFIX_SIZE_IN_BYTES sizeof(USHORT)
+#define STRING_KEY_MAXIMUM_LENGTH 0xffff
+
+FORCEINLINE
+ULONG
+HashStringKey(
+    _In_reads_bytes_(Length) PBYTE Bytes,
+    _In_ ULONG Length,
+    _In_ ULONG Seed
+    )
+/*++
+
+Routine Description:
+
+    Reduces a string key to a 32-bit key.
+
+Arguments:
+
+    Bytes - Supplies the base address of the string key's bytes.
+
+    Length - Supplies the length of the string key, in bytes.
+
+    Seed - Supplies the string key seed.
+
+Return Value:
+
+    The 32-bit key.
+
+--*/
+{
+    ULONG Hash1;
+    ULONG Hash2;
+    ULONG Index;
+    ULONG Remaining;
+    ULONGLONG Lane;
+    ULONGLONG Multiplier;
+
+    Hash1 = Seed;
+    Hash2 = Length;
+    Remaining = Length;
+    Multiplier = GetReducedKeyLaneMultiplier(Seed);
+
+    while (Remaining >= (sizeof(ULONGLONG) << 1)) {
+        Lane = *((ULONGLONG UNALIGNED *)Bytes);
+        Hash1 = (ULONG)_mm_crc32_u64(Hash1, Lane * Multiplier);
+        Lane = *((ULONGLONG UNALIGNED *)(Bytes + sizeof(ULONGLONG)));
+        Hash2 = (ULONG)_mm_crc32_u64(Hash2, Lane * Multiplier);
+        Bytes += (sizeof(ULONGLONG) << 1);
+        Remaining -= (sizeof(ULONGLONG) << 1);
+    }
+
+    if (Remaining >= sizeof(ULONGLONG)) {
+        Lane = *((ULONGLONG UNALIGNED *)Bytes);
+        Hash1 = (ULONG)_mm_crc32_u64(Hash1, Lane * Multiplier);
+        Bytes += sizeof(ULONGLONG);
+        Remaining -= sizeof(ULONGLONG);
+    }
+
+    if (Remaining > 0) {
+        Lane = 0;
+        for (Index = 0; Index < Remaining; Index++) {
+            Lane |= ((ULONGLONG)Bytes[Index] << (Index << 3));
+        }
+        Hash2 = (ULONG)_mm_crc32_u64(Hash2, Lane * Multiplier);
+    }
+
+    return _mm_crc32_u32(Hash1, Hash2);
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
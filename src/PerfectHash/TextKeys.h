@@ -0,0 +1,426 @@
+/*++
+
+Copyright (c) 2018-2021 Trent Nelson <trent@trent.me>
+
+Module Name:
+
+    TextKeys.h
+
+Abstract:
+
+    This module implements helper routines for text keys (i.e. keys loaded
+    with the --TextKeys keys load flag).
+
+    A text keys file has one key per line.  Lines end with a line feed, which
+    may be preceded by a carriage return.  Each key is either a decimal
+    integer, or a hexadecimal integer prefixed with 0x or 0X, and may be
+    preceded by spaces or tabs.  If a key is followed by a comma, space or
+    tab, the remainder of the line is ignored; thus, the first column of a
+    CSV file can be used directly.  Blank lines and lines whose first
+    non-blank character is # are skipped.  If the first line of the file does
+    not begin with a key (e.g. it's a CSV header), it is skipped, too.  Keys
+    must fit within the key size (i.e. 32-bit or 64-bit).
+
+    Decimal keys of up to 16 digits are parsed with SSE4.1: the digits are
+    loaded right-aligned into an XMM register, and combined pairwise via
+    multiply-add instructions (digits into 2-digit values, then 4-digit
+    values, then 8-digit values), rather than one digit at a time.  The
+    length of each run of digits is likewise determined 16 bytes at a time.
+
+--*/
+
+#include "stdafx.h"
+
+//
+// Define the text key constraints.
+//
+
+#define TEXT_KEY_SIMD_WIDTH sizeof(XMMWORD)
+#define TEXT_KEY_MAXIMUM_SIMD_DECIMAL_DIGITS 16
+#define TEXT_KEY_MAXIMUM_DECIMAL_DIGITS 20
+#define TEXT_KEY_MAXIMUM_HEX_DIGITS 16
+#define TEXT_KEY_SIMD_HALF_DIGITS_SCALE 100000000ULL
+#define TEXT_KEY_DECIMAL_DIGITS_SCALE 10000000000000000ULL
+
+//
+// The newline counting routine accumulates per-byte counts, which can't
+// exceed 255 before they're summed.
+//
+
+#define TEXT_KEY_MAXIMUM_NEWLINE_COUNT_ITERATIONS 255
+
+#define IsTextKeyDecimalDigit(Char) ((Char) >= '0' && (Char) <= '9')
+
+#define IsTextKeyBlank(Char) ((Char) == ' ' || (Char) == '\t' || (Char) == '\r')
+
+#define IsTextKeyHexPrefix(Cursor, End)                  \
+    ((End) - (Cursor) > 2 &&                             \
+     (Cursor)[0] == '0' &&                               \
+     ((Cursor)[1] == 'x' || (Cursor)[1] == 'X'))
+
+#define IsTextKeyFieldSeparator(Char) \
+    ((Char) == ',' || (Char) == ' ' || (Char) == '\t')
+
+FORCEINLINE
+ULONGLONG
+CountTextKeyNewlines(
+    _In_reads_(End - Start) PCHAR Start,
+    _In_ PCHAR End
+    )
+/*++
+
+Routine Description:
+
+    Counts the line feeds in a range of a text keys file.  The range is
+    processed 16 bytes at a time: each block's comparison result (0 or -1 per
+    byte) is subtracted from a vector of per-byte counts, which is summed via
+    _mm_sad_epu8() before any count can overflow.
+
+Arguments:
+
+    Start - Supplies the first byte of the range.
+
+    End - Supplies the byte following the last byte of the range.
+
+Return Value:
+
+    The number of line feeds.
+
+--*/
+{
+    ULONG Iterations;
+    ULONGLONG Count;
+    XMMWORD Zero;
+    XMMWORD Chars;
+    XMMWORD Counts;
+    XMMWORD Newline;
+    XMMWORD Sums;
+
+    Count = 0;
+    Zero = _mm_setzero_si128();
+    Newline = _mm_set1_epi8('\n');
+
+    while ((ULONG_PTR)(End - Start) >= TEXT_KEY_SIMD_WIDTH) {
+
+        Counts = Zero;
+
+        for (Iterations = 0;
+             Iterations < TEXT_KEY_MAXIMUM_NEWLINE_COUNT_ITERATIONS &&
+             (ULONG_PTR)(End - Start) >= TEXT_KEY_SIMD_WIDTH;
+             Iterations++, Start += TEXT_KEY_SIMD_WIDTH) {
+
+            Chars = _mm_loadu_si128((PXMMWORD)Start);
+            Counts = _mm_sub_epi8(Counts, _mm_cmpeq_epi8(Chars, Newline));
+        }
+
+        Sums = _mm_sad_epu8(Counts, Zero);
+        Count += (ULONGLONG)_mm_cvtsi128_si64(Sums);
+        Count += (ULONGLONG)_mm_extract_epi64(Sums, 1);
+    }
+
+    while (Start < End) {
+        Count += (*Start++ == '\n');
+    }
+
+    return Count;
+}
+
+FORCEINLINE
+ULONG
+GetTextKeyDecimalDigitsLength(
+    _In_ PCHAR Cursor,
+    _In_ PCHAR End
+    )
+/*++
+
+Routine Description:
+
+    Returns the number of consecutive decimal digits at the given position of
+    a text keys file.
+
+Arguments:
+
+    Cursor - Supplies the position of the first digit.
+
+    End - Supplies the end of the text keys file.
+
+Return Value:
+
+    The number of digits, which is capped at one more than
+    TEXT_KEY_MAXIMUM_DECIMAL_DIGITS (i.e. enough to detect that a key has too
+    many digits).
+
+--*/
+{
+    ULONG Mask;
+    ULONG Length;
+    ULONG NonDigit;
+    XMMWORD Chars;
+    XMMWORD Digits;
+
+    Length = 0;
+
+    while ((ULONG_PTR)(End - Cursor) >= TEXT_KEY_SIMD_WIDTH &&
+           Length <= TEXT_KEY_MAXIMUM_DECIMAL_DIGITS) {
+
+        Chars = _mm_loadu_si128((PXMMWORD)Cursor);
+        Digits = _mm_and_si128(_mm_cmpgt_epi8(Chars, _mm_set1_epi8('0' - 1)),
+                               _mm_cmplt_epi8(Chars, _mm_set1_epi8('9' + 1)));
+        Mask = (ULONG)_mm_movemask_epi8(Digits);
+
+        if (Mask != 0xffff) {
+            _BitScanForward(&NonDigit, ~Mask);
+            return Length + NonDigit;
+        }
+
+        Length += TEXT_KEY_SIMD_WIDTH;
+        Cursor += TEXT_KEY_SIMD_WIDTH;
+    }
+
+    while (Cursor < End &&
+           IsTextKeyDecimalDigit(*Cursor) &&
+           Length <= TEXT_KEY_MAXIMUM_DECIMAL_DIGITS) {
+        Cursor++;
+        Length++;
+    }
+
+    return Length;
+}
+
+FORCEINLINE
+ULONGLONG
+ParseTextKeyDecimalDigitsSimd(
+    _In_ PCHAR Digits,
+    _In_ ULONG Length
+    )
+/*++
+
+Routine Description:
+
+    Parses up to 16 decimal digits with SSE4.1.  The 16 bytes ending with the
+    last digit are loaded, such that the digits are right-aligned; the bytes
+    preceding the digits are masked off, which leaves them as leading zeros.
+
+Arguments:
+
+    Digits - Supplies the position of the first digit.  The 16 bytes ending
+        at Digits + Length must be readable.
+
+    Length - Supplies the number of digits, between 1 and 16.
+
+Return Value:
+
+    The value of the digits.
+
+--*/
+{
+    LONG High;
+    LONG Low;
+    XMMWORD Chars;
+    XMMWORD Valid;
+    XMMWORD Values;
+
+    ASSERT(Length >= 1 && Length <= TEXT_KEY_MAXIMUM_SIMD_DECIMAL_DIGITS);
+
+    Digits += Length;
+    Chars = _mm_loadu_si128((PXMMWORD)(Digits - TEXT_KEY_SIMD_WIDTH));
+
+    Valid = _mm_cmpgt_epi8(
+        _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+        _mm_set1_epi8((CHAR)(TEXT_KEY_SIMD_WIDTH - 1 - Length))
+    );
+
+    Values = _mm_and_si128(_mm_sub_epi8(Chars, _mm_set1_epi8('0')), Valid);
+
+    //
+    // Combine adjacent digits into 2-digit 16-bit values, then 4-digit 32-bit
+    // values, which are narrowed back to 16-bit, then 8-digit 32-bit values.
+    //
+
+    Values = _mm_maddubs_epi16(
+        Values,
+        _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1)
+    );
+
+    Values = _mm_madd_epi16(
+        Values,
+        _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1)
+    );
+
+    Values = _mm_packus_epi32(Values, Values);
+
+    Values = _mm_madd_epi16(
+        Values,
+        _mm_setr_epi16(10000, 1, 10000, 1, 0, 0, 0, 0)
+    );
+
+    High = _mm_cvtsi128_si32(Values);
+    Low = _mm_extract_epi32(Values, 1);
+
+    return ((ULONGLONG)High * TEXT_KEY_SIMD_HALF_DIGITS_SCALE) + (ULONGLONG)Low;
+}
+
+FORCEINLINE
+ULONGLONG
+ParseTextKeyDecimalDigitsScalar(
+    _In_ PCHAR Digits,
+    _In_ ULONG Length
+    )
+/*++
+
+Routine Description:
+
+    Parses up to 19 decimal digits one at a time.
+
+Arguments:
+
+    Digits - Supplies the position of the first digit.
+
+    Length - Supplies the number of digits, between 1 and 19.
+
+Return Value:
+
+    The value of the digits.
+
+--*/
+{
+    ULONG Index;
+    ULONGLONG Value;
+
+    Value = 0;
+
+    for (Index = 0; Index < Length; Index++) {
+        Value = (Value * 10) + (ULONGLONG)(Digits[Index] - '0');
+    }
+
+    return Value;
+}
+
+FORCEINLINE
+BOOLEAN
+ParseTextKeyDecimal(
+    _In_ PCHAR Base,
+    _In_ PCHAR Digits,
+    _In_ ULONG Length,
+    _Out_ PULONGLONG Value
+    )
+/*++
+
+Routine Description:
+
+    Parses a decimal key.  The last 16 digits are parsed via SIMD if there
+    are at least 16 bytes between the start of the file and the end of the
+    digits; any digits preceding them are parsed one at a time.
+
+Arguments:
+
+    Base - Supplies the start of the text keys file.
+
+    Digits - Supplies the position of the first digit.
+
+    Length - Supplies the number of digits, between 1 and 20.
+
+    Value - Receives the value of the key.
+
+Return Value:
+
+    TRUE if the key was parsed, FALSE if it overflowed 64 bits.
+
+--*/
+{
+    ULONG HighLength;
+    ULONGLONG High;
+    ULONGLONG Low;
+
+    ASSERT(Length >= 1 && Length <= TEXT_KEY_MAXIMUM_DECIMAL_DIGITS);
+
+    HighLength = 0;
+
+    if (Length > TEXT_KEY_MAXIMUM_SIMD_DECIMAL_DIGITS) {
+        HighLength = Length - TEXT_KEY_MAXIMUM_SIMD_DECIMAL_DIGITS;
+        Length = TEXT_KEY_MAXIMUM_SIMD_DECIMAL_DIGITS;
+    }
+
+    if ((ULONG_PTR)(Digits + HighLength + Length - Base) >=
+        TEXT_KEY_SIMD_WIDTH) {
+        Low = ParseTextKeyDecimalDigitsSimd(Digits + HighLength, Length);
+    } else {
+        Low = ParseTextKeyDecimalDigitsScalar(Digits + HighLength, Length);
+    }
+
+    if (HighLength == 0) {
+        *Value = Low;
+        return TRUE;
+    }
+
+    High = ParseTextKeyDecimalDigitsScalar(Digits, HighLength);
+
+    if (High > ((ULONGLONG)-1 - Low) / TEXT_KEY_DECIMAL_DIGITS_SCALE) {
+        return FALSE;
+    }
+
+    *Value = (High * TEXT_KEY_DECIMAL_DIGITS_SCALE) + Low;
+    return TRUE;
+}
+
+FORCEINLINE
+ULONG
+ParseTextKeyHex(
+    _In_ PCHAR Cursor,
+    _In_ PCHAR End,
+    _Out_ PULONGLONG Value
+    )
+/*++
+
+Routine Description:
+
+    Parses the hexadecimal digits of a key (i.e. following the 0x prefix).
+
+Arguments:
+
+    Cursor - Supplies the position of the first digit.
+
+    End - Supplies the end of the text keys file.
+
+    Value - Receives the value of the key.
+
+Return Value:
+
+    The number of digits parsed.  If this exceeds TEXT_KEY_MAXIMUM_HEX_DIGITS,
+    the key overflowed 64 bits, and Value is undefined.
+
+--*/
+{
+    CHAR Char;
+    ULONG Length;
+    ULONGLONG Nibble;
+    ULONGLONG Result;
+
+    Result = 0;
+
+    for (Length = 0; Cursor < End; Length++, Cursor++) {
+
+        Char = *Cursor;
+
+        if (IsTextKeyDecimalDigit(Char)) {
+            Nibble = (ULONGLONG)(Char - '0');
+        } else if (Char >= 'a' && Char <= 'f') {
+            Nibble = (ULONGLONG)(Char - 'a' + 10);
+        } else if (Char >= 'A' && Char <= 'F') {
+            Nibble = (ULONGLONG)(Char - 'A' + 10);
+        } else {
+            break;
+        }
+
+        if (Length == TEXT_KEY_MAXIMUM_HEX_DIGITS) {
+            return Length + 1;
+        }
+
+        Result = (Result << 4) | Nibble;
+    }
+
+    *Value = Result;
+    return Length;
+}
+
+// vim:set ts=8 sw=4 sts=4 tw=80 expandtab                                     :
@@ -140,6 +140,16 @@ Abstract:
 #include "PerfectHashErrorHandling.h"
 #include "GraphImpl.h"
 #include "Chm01.h"
+#include "Bdz01.h"
+#include "Shard01.h"
+#include "Block01.h"
+#include "PackedTableData.h"
+#include "KeyDownsizing.h"
+#include "ReducedKeys.h"
+#include "StringKeys.h"
+#include "Keys128.h"
+#include "TextKeys.h"
+#include "CompressedKeys.h"
 #include "Chm01FileWork.h"
 #include "ExtractArg.h"
 #include "VCProjectFileChunks.h"